@@ -0,0 +1,529 @@
+/**
+ * @file bench/btana_bench.cxx
+ * @brief `btana_bench` — microbenchmarks of the per-hit / per-frame hot
+ *        paths, results as JSON.
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_BENCH=ON && cmake --build build --target btana_bench
+ * Run with (from the repository root, for the conf/ files):
+ *   build/bin/btana_bench                       (all, JSON to btana_bench.json)
+ *   build/bin/btana_bench --filter circle_fit -o fit.json
+ *   build/bin/btana_bench --min-time 1.0        (longer, steadier samples)
+ *
+ * Benchmarks (name prefix → code under test):
+ *
+ *   global_index.*   GlobalIndex::from_components / try_from_tdc_ordinal,
+ *                    field unpack, channel_ordinal
+ *   calibration.*    AlcorFinedata::get_phase before and after
+ *                    freeze_calibration, get_time_ns
+ *   mapping.*        Mapping::assign_position
+ *   streaming.*      compute_streaming_score_pure and
+ *                    run_streaming_ransac_compute on canned frames
+ *   circle_fit.*     fit_circle (free and fixed centre), Taubin fit_algebraic
+ *   coverage.*       azimuthal_coverage_fraction, map and grid-index overloads
+ *   tracking_altai.* TrackingAltai text parse and binary-cache load
+ *
+ * Every input is built in memory (or in the temp directory) from a fixed
+ * seed, with channel positions from the mapping configuration, so two runs
+ * of the same build time the same work.  Each benchmark repeats its body
+ * until one sample lasts `min_time / samples`, then reports the median of
+ * the samples; "items" are hits, frames, fits or lines, as named.
+ *
+ * JSON layout:
+ *   { "version", "compiler", "build_type", "min_time_s", "samples",
+ *     "benchmarks": [ { "name", "unit", "iterations", "items_per_iteration",
+ *                       "ns_per_iteration", "ns_per_item", "items_per_second",
+ *                       "ns_per_iteration_min" } ] }
+ */
+
+#include "alcor_finedata.h"
+#include "mapping.h"
+#include "tracking_altai.h"
+#include "triggers/events.h"
+#include "triggers/streaming/ransac.h"
+#include "triggers/streaming/score.h"
+#include "utility/circle_fit.h"
+#include "utility/config_reader.h"
+#include "utility/global_index.h"
+#include "utility/radiator_efficiency.h"
+#include "version.h"
+
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+/// Keep @p value observable so the optimiser cannot drop the computation.
+template <class T>
+inline void keep(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult
+{
+    std::string name;
+    std::string unit; ///< What one item is.
+    uint64_t iterations = 0;
+    double items_per_iteration = 0.;
+    double ns_per_iteration = 0.; ///< Median over the samples.
+    double ns_per_iteration_min = 0.;
+};
+
+class Bench
+{
+public:
+    Bench(std::string filter, double min_time_s, int samples)
+        : filter(std::move(filter)), min_time_s(min_time_s), samples(std::max(1, samples)) {}
+
+    bool selected(const std::string &name) const { return filter.empty() || name.find(filter) != std::string::npos; }
+
+    /// Time @p body (one iteration = @p items items of @p unit).
+    template <class F>
+    void run(const std::string &name, const std::string &unit, double items, F &&body)
+    {
+        if (!selected(name))
+            return;
+        using clock = std::chrono::steady_clock;
+        auto time_n = [&](uint64_t n)
+        {
+            const auto t0 = clock::now();
+            for (uint64_t i = 0; i < n; ++i)
+                body();
+            return std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+        };
+
+        //  Calibrate the repeat count on a warm body.
+        time_n(1);
+        const double target_ns = 1e9 * min_time_s / samples;
+        uint64_t n = 1;
+        for (double elapsed = time_n(n); elapsed < target_ns && n < (uint64_t{1} << 40); elapsed = time_n(n))
+            n = elapsed > 0. ? std::max(n * 2, static_cast<uint64_t>(n * 1.2 * target_ns / elapsed)) : n * 2;
+
+        std::vector<double> per_iteration;
+        for (int s = 0; s < samples; ++s)
+            per_iteration.push_back(time_n(n) / static_cast<double>(n));
+        std::sort(per_iteration.begin(), per_iteration.end());
+
+        BenchResult result{name, unit, n * samples, items, per_iteration[per_iteration.size() / 2], per_iteration.front()};
+        std::printf("  %-40s %12.1f ns/iter %10.2f ns/%-6s %12.3g %s/s\n", name.c_str(), result.ns_per_iteration,
+                    result.ns_per_iteration / items, unit.c_str(), 1e9 * items / result.ns_per_iteration, unit.c_str());
+        std::fflush(stdout);
+        results.push_back(std::move(result));
+    }
+
+    bool write_json(const std::string &path) const
+    {
+        std::ofstream out(path);
+        if (!out)
+            return false;
+        out << "{\n"
+            << "  \"version\": \"" << BTANA_VERSION << "\",\n"
+            << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+#ifdef NDEBUG
+            << "  \"build_type\": \"release\",\n"
+#else
+            << "  \"build_type\": \"debug\",\n"
+#endif
+            << "  \"min_time_s\": " << min_time_s << ",\n"
+            << "  \"samples\": " << samples << ",\n"
+            << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            char line[512];
+            std::snprintf(line, sizeof(line),
+                          "%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %llu, "
+                          "\"items_per_iteration\": %.0f, \"ns_per_iteration\": %.3f, \"ns_per_item\": %.4f, "
+                          "\"items_per_second\": %.6g, \"ns_per_iteration_min\": %.3f}",
+                          i ? "," : "", r.name.c_str(), r.unit.c_str(), static_cast<unsigned long long>(r.iterations),
+                          r.items_per_iteration, r.ns_per_iteration, r.ns_per_iteration / r.items_per_iteration,
+                          1e9 * r.items_per_iteration / r.ns_per_iteration, r.ns_per_iteration_min);
+            out << line;
+        }
+        out << "\n  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+
+    std::size_t size() const { return results.size(); }
+
+private:
+    std::string filter;
+    double min_time_s;
+    int samples;
+    std::vector<BenchResult> results;
+};
+
+/// One readout channel of the canned detector.
+struct BenchChannel
+{
+    AlcorDataStruct word;
+    AlcorFinedataStruct hit; ///< Position assigned.
+    int ordinal;
+};
+
+/// Every channel of devices 192–199 that the mapping places (x > −990 mm).
+std::vector<BenchChannel> mapped_channels(Mapping &mapping)
+{
+    std::vector<BenchChannel> channels;
+    for (int device = ::gidx::kFirstDevice; device < ::gidx::kTimingDeviceLo; ++device)
+        for (int fifo = 0; fifo < 32; ++fifo)
+            for (int column = 2 * (fifo % 4); column < 2 * (fifo % 4) + 2; ++column)
+                for (int pixel = 0; pixel < 4; ++pixel)
+                {
+                    AlcorDataStruct word{};
+                    word.device = device;
+                    word.fifo = fifo;
+                    word.type = alcor_hit;
+                    word.column = column;
+                    word.pixel = pixel;
+                    AlcorFinedataStruct hit(word);
+                    mapping.assign_position(hit);
+                    if (hit.hit_x > -990.f)
+                        channels.push_back({word, hit, ::GlobalIndex(hit.GlobalIndex).channel_ordinal()});
+                }
+    return channels;
+}
+
+/// A frame of hits: one ring at coarse ~500 on top of uniform noise.
+struct CannedFrame
+{
+    std::vector<AlcorFinedataStruct> hits;
+    std::vector<TriggerEvent> seeds; ///< The ring's streaming trigger.
+};
+
+std::vector<CannedFrame> canned_frames(const std::vector<BenchChannel> &channels, int n_frames,
+                                       int photons, int noise_hits, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> gauss(0.f, 1.f);
+    std::uniform_int_distribution<std::size_t> any_channel(0, channels.size() - 1);
+    std::uniform_int_distribution<int> any_fine(30, 130), any_tdc(0, 3), any_coarse(0, 1023);
+
+    auto make_hit = [&](const BenchChannel &channel, int coarse)
+    {
+        AlcorDataStruct word = channel.word;
+        word.tdc = any_tdc(rng);
+        word.coarse = coarse;
+        word.fine = any_fine(rng);
+        AlcorFinedataStruct hit(word);
+        hit.hit_x = channel.hit.hit_x;
+        hit.hit_y = channel.hit.hit_y;
+        return hit;
+    };
+
+    std::vector<CannedFrame> frames(n_frames);
+    for (auto &frame : frames)
+    {
+        const float cx = -26.f + 5.f * gauss(rng), cy = -26.f + 5.f * gauss(rng), radius = 70.f;
+        for (int k = 0; k < photons; ++k)
+        {
+            const float phi = 2.f * static_cast<float>(M_PI) * unit(rng);
+            const float x = cx + (radius + 1.5f * gauss(rng)) * std::cos(phi);
+            const float y = cy + (radius + 1.5f * gauss(rng)) * std::sin(phi);
+            const auto nearest = std::min_element(channels.begin(), channels.end(), [&](const auto &a, const auto &b)
+                                                  { return std::hypot(a.hit.hit_x - x, a.hit.hit_y - y) <
+                                                           std::hypot(b.hit.hit_x - x, b.hit.hit_y - y); });
+            if (std::hypot(nearest->hit.hit_x - x, nearest->hit.hit_y - y) < 2.f)
+                frame.hits.push_back(make_hit(*nearest, 500 + static_cast<int>(std::lround(0.5f * gauss(rng)))));
+        }
+        for (int k = 0; k < noise_hits; ++k)
+            frame.hits.push_back(make_hit(channels[any_channel(rng)], any_coarse(rng)));
+        frame.seeds.emplace_back(static_cast<uint8_t>(_TRIGGER_STREAMING_RING_FOUND_), static_cast<uint16_t>(photons),
+                                 static_cast<float>(BTANA_ALCOR_CC_TO_NS * 500));
+    }
+    return frames;
+}
+
+/// Ring arcs for the fit and coverage benchmarks.
+std::vector<std::vector<std::array<float, 2>>> canned_rings(int n_rings, int points, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> gauss(0.f, 1.f);
+    std::vector<std::vector<std::array<float, 2>>> rings(n_rings);
+    for (auto &ring : rings)
+    {
+        const float cx = -26.f + 5.f * gauss(rng), cy = -26.f + 5.f * gauss(rng);
+        const float radius = 70.f + 3.f * gauss(rng);
+        for (int k = 0; k < points; ++k)
+        {
+            const float phi = 2.f * static_cast<float>(M_PI) * unit(rng);
+            const float r = radius + 1.5f * gauss(rng);
+            ring.push_back({cx + r * std::cos(phi), cy + r * std::sin(phi)});
+        }
+    }
+    return rings;
+}
+
+/// ALTAI-format track file: one or two tracks per event, every tenth event trackless.
+std::string canned_tracks(int n_events, std::mt19937 &rng, std::size_t &n_lines)
+{
+    std::normal_distribution<float> gauss(0.f, 1.f);
+    const auto path = (std::filesystem::temp_directory_path() / "btana_bench_tracks.txt").string();
+    std::ofstream out(path);
+    out << "event x y z dx dy dz chi2 ndof chi2ndof timestamp\n";
+    n_lines = 0;
+    for (int event = 0; event < n_events; ++event, ++n_lines)
+    {
+        if (event % 10 == 9)
+        {
+            out << event << " *\n";
+            continue;
+        }
+        for (int track = 0; track < 1 + (event % 7 == 0); ++track)
+            out << event << ' ' << 10.f * gauss(rng) << ' ' << 10.f * gauss(rng) << " 0 "
+                << 1e-3f * gauss(rng) << ' ' << 1e-3f * gauss(rng) << " 1 " << 4.f + gauss(rng)
+                << " 4 " << 1.f + 0.25f * gauss(rng) << ' ' << 1000.0 + 0.5 * event << '\n';
+    }
+    std::filesystem::remove(TrackingAltai::cache_path(path));
+    return path;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    CLI::App app{"btana_bench — microbenchmarks of the framework hot paths"};
+
+    std::string output_file = "btana_bench.json";
+    std::string filter;
+    std::string mapping_config_file = "conf/mapping_conf.toml";
+    std::string streaming_config_file = "conf/streaming.toml";
+    double min_time_s = 0.5;
+    int samples = 5;
+    unsigned int seed = 12345;
+
+    app.add_option("-o,--output", output_file, "JSON output file");
+    app.add_option("--filter", filter, "Run only the benchmarks whose name contains this string");
+    app.add_option("--min-time", min_time_s, "Seconds of timed work per benchmark");
+    app.add_option("--samples", samples, "Timed samples per benchmark (the median is reported)");
+    app.add_option("--seed", seed, "Seed of the canned inputs");
+    app.add_option("--Mapping-conf", mapping_config_file, "Mapping configuration (channel positions)");
+    app.add_option("--streaming-conf", streaming_config_file, "Streaming trigger / RANSAC configuration");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (!std::filesystem::exists(mapping_config_file))
+    {
+        std::cerr << "btana_bench: mapping configuration " << mapping_config_file
+                  << " not found (run from the repository root or pass --Mapping-conf)\n";
+        return 2;
+    }
+
+    //  ── canned inputs ──────────────────────────────────────────────────
+    std::mt19937 rng(seed);
+    Mapping mapping(mapping_config_file);
+    const auto channels = mapped_channels(mapping);
+    if (channels.empty())
+    {
+        std::cerr << "btana_bench: no mapped channel in " << mapping_config_file << "\n";
+        return 2;
+    }
+    const auto frames = canned_frames(channels, 64, 24, 60, rng);
+    std::size_t frame_hits = 0;
+    for (const auto &frame : frames)
+        frame_hits += frame.hits.size();
+    std::vector<AlcorFinedataStruct> hits;
+    for (const auto &frame : frames)
+        hits.insert(hits.end(), frame.hits.begin(), frame.hits.end());
+
+    //  Linear calibration on every TDC of every channel.
+    for (const auto &channel : channels)
+        for (int tdc = 0; tdc < 4; ++tdc)
+        {
+            const auto gi = ::GlobalIndex(channel.hit.GlobalIndex).global_channel().raw() | static_cast<uint32_t>(tdc);
+            AlcorFinedata::set_param0(gi, 30.f + tdc);
+            AlcorFinedata::set_param1(gi, 130.f - tdc);
+            AlcorFinedata::set_param2(gi, 0.f);
+        }
+
+    //  Score weights from a flat noise model: 60 noise hits per 1024-cc frame.
+    const auto trigger_cfg = streaming_trigger_conf_reader(streaming_config_file);
+    const auto ransac_cfg = streaming_ransac_conf_reader(streaming_config_file);
+    const float frame_length_ns = static_cast<float>(BTANA_ALCOR_CC_TO_NS * 1024);
+    const float hits_per_window = 60.f / channels.size() * trigger_cfg.time_window_ns / frame_length_ns;
+    StreamingTriggerWeights weights;
+    double inverse_sum = 0.;
+    for (const auto &channel : channels)
+    {
+        weights.weight_by_channel[channel.ordinal] = 1.f / hits_per_window;
+        inverse_sum += 1. / hits_per_window;
+    }
+    weights.n_channels_modelled = static_cast<int>(weights.weight_by_channel.size());
+    weights.expected_score_per_window = static_cast<float>(weights.n_channels_modelled);
+    weights.sigma_score_per_window = static_cast<float>(std::sqrt(inverse_sum));
+    weights.expected_dark_hits_per_window = hits_per_window * weights.n_channels_modelled;
+
+    const auto rings = canned_rings(64, 20, rng);
+    std::map<int, std::array<float, 2>> channel_xy;
+    for (const auto &channel : channels)
+        channel_xy[channel.ordinal] = {channel.hit.hit_x, channel.hit.hit_y};
+    const util::radiator_efficiency::ChannelGridIndex grid_index(channel_xy);
+
+    std::vector<std::array<int, 5>> components;
+    std::vector<uint32_t> raws;
+    for (const auto &hit : hits)
+    {
+        const ::GlobalIndex gi(hit.GlobalIndex);
+        components.push_back({gi.device(), gi.fifo(), gi.chip(), gi.channel(), gi.tdc()});
+        raws.push_back(gi.raw());
+    }
+    const double n_hits = static_cast<double>(hits.size());
+
+    std::printf("btana_bench %s: %zu mapped channels, %zu frames, %zu hits\n", BTANA_VERSION, channels.size(),
+                frames.size(), hits.size());
+    Bench bench(filter, min_time_s, samples);
+
+    //  ── GlobalIndex ────────────────────────────────────────────────────
+    bench.run("global_index.from_components", "hit", n_hits, [&]
+              {
+                  for (const auto &c : components)
+                      keep(::GlobalIndex::from_components(c[0], c[1], c[2], c[3], c[4]).raw());
+              });
+    bench.run("global_index.unpack", "hit", n_hits, [&]
+              {
+                  for (const uint32_t raw : raws)
+                  {
+                      const ::GlobalIndex gi(raw);
+                      keep(gi.device() + gi.fifo() + gi.chip() + gi.channel() + gi.tdc());
+                  }
+              });
+    bench.run("global_index.channel_ordinal", "hit", n_hits, [&]
+              {
+                  for (const uint32_t raw : raws)
+                      keep(::GlobalIndex(raw).channel_ordinal());
+              });
+    bench.run("global_index.try_from_tdc_ordinal", "hit", n_hits, [&]
+              {
+                  for (const uint32_t raw : raws)
+                      keep(::GlobalIndex::try_from_tdc_ordinal(::GlobalIndex(raw).tdc_ordinal())->raw());
+              });
+
+    //  ── calibration ────────────────────────────────────────────────────
+    std::vector<AlcorFinedata> finedata(hits.begin(), hits.end());
+    bench.run("calibration.get_phase_unfrozen", "hit", n_hits, [&]
+              {
+                  for (const auto &hit : finedata)
+                      keep(hit.get_phase());
+              });
+    //  Production freezes the table before the workers start; irreversible.
+    AlcorFinedata::freeze_calibration();
+    bench.run("calibration.get_phase", "hit", n_hits, [&]
+              {
+                  for (const auto &hit : finedata)
+                      keep(hit.get_phase());
+              });
+    bench.run("calibration.get_time_ns", "hit", n_hits, [&]
+              {
+                  for (const auto &hit : finedata)
+                      keep(hit.get_time_ns());
+              });
+
+    //  ── mapping ────────────────────────────────────────────────────────
+    std::vector<AlcorFinedataStruct> unplaced = hits;
+    bench.run("mapping.assign_position", "hit", n_hits, [&]
+              {
+                  for (auto &hit : unplaced)
+                      mapping.assign_position(hit);
+                  keep(unplaced.back().hit_x);
+              });
+
+    //  ── streaming trigger ──────────────────────────────────────────────
+    const std::vector<std::tuple<int, float, float>> no_carry;
+    bench.run("streaming.score_kernel", "hit", static_cast<double>(frame_hits), [&]
+              {
+                  for (const auto &frame : frames)
+                      keep(compute_streaming_score_pure(frame.hits, trigger_cfg.time_window_ns, weights,
+                                                        trigger_cfg.n_sigma_threshold, no_carry, frame_length_ns)
+                               .fired);
+              });
+    const StreamingRansacQA no_qa{};
+    const std::vector<int> no_mask;
+    bench.run("streaming.ransac_compute", "frame", static_cast<double>(frames.size()), [&]
+              {
+                  for (const auto &frame : frames)
+                      keep(run_streaming_ransac_compute(frame.hits, frame.seeds, no_mask, 0, trigger_cfg.time_window_ns,
+                                                        ransac_cfg, no_qa, weights.weight_by_channel)
+                               .has_ring1);
+              });
+
+    //  ── circle fits ────────────────────────────────────────────────────
+    bench.run("circle_fit.fit_circle_free", "fit", static_cast<double>(rings.size()), [&]
+              {
+                  for (const auto &ring : rings)
+                      keep(fit_circle(ring, {-26.f, -26.f, 70.f}, false)[2][0]);
+              });
+    bench.run("circle_fit.fit_circle_fixed", "fit", static_cast<double>(rings.size()), [&]
+              {
+                  for (const auto &ring : rings)
+                      keep(fit_circle(ring, {-26.f, -26.f, 70.f}, true)[2][0]);
+              });
+    bench.run("circle_fit.taubin", "fit", static_cast<double>(rings.size()), [&]
+              {
+                  for (const auto &ring : rings)
+                      keep(util::circle_fit::fit_algebraic(ring, util::circle_fit::CircleMethod::taubin).radius);
+              });
+
+    //  ── coverage ───────────────────────────────────────────────────────
+    std::vector<util::circle_fit::AlgebraicCircle> ring_fits;
+    for (const auto &ring : rings)
+        ring_fits.push_back(util::circle_fit::fit_algebraic(ring));
+    bench.run("coverage.azimuthal_map", "ring", static_cast<double>(ring_fits.size()), [&]
+              {
+                  for (const auto &fit : ring_fits)
+                      keep(util::radiator_efficiency::azimuthal_coverage_fraction(
+                          channel_xy, static_cast<float>(fit.x0), static_cast<float>(fit.y0),
+                          static_cast<float>(fit.radius), 6.f));
+              });
+    bench.run("coverage.azimuthal_grid", "ring", static_cast<double>(ring_fits.size()), [&]
+              {
+                  for (const auto &fit : ring_fits)
+                      keep(util::radiator_efficiency::azimuthal_coverage_fraction(
+                          grid_index, static_cast<float>(fit.x0), static_cast<float>(fit.y0),
+                          static_cast<float>(fit.radius), 6.f));
+              });
+
+    //  ── ALTAI tracks ───────────────────────────────────────────────────
+    if (bench.selected("tracking_altai."))
+    {
+        std::size_t n_lines = 0;
+        const auto tracks_path = canned_tracks(20000, rng, n_lines);
+        bench.run("tracking_altai.parse_text", "line", static_cast<double>(n_lines), [&]
+                  {
+                      TrackingAltai tracking;
+                      tracking.load_tracking_file(tracks_path, /*use_cache=*/false);
+                      keep(tracking.get_number_of_tracks());
+                  });
+        TrackingAltai{tracks_path}; // writes the cache
+        bench.run("tracking_altai.load_cache", "line", static_cast<double>(n_lines), [&]
+                  {
+                      TrackingAltai tracking;
+                      tracking.load_tracking_file(tracks_path, /*use_cache=*/true);
+                      keep(tracking.get_number_of_tracks());
+                  });
+        std::filesystem::remove(TrackingAltai::cache_path(tracks_path));
+        std::filesystem::remove(tracks_path);
+    }
+
+    if (!bench.write_json(output_file))
+    {
+        std::cerr << "btana_bench: cannot write " << output_file << "\n";
+        return 1;
+    }
+    std::printf("btana_bench: %zu benchmarks → %s\n", bench.size(), output_file.c_str());
+    return 0;
+}
@@ -97,6 +97,12 @@ public:
     /// Path of the underlying ROOT file.
     std::string get_filename() const noexcept { return filename; }
 
+    /// RDO id parsed from "rdo-NNN" / "kc705-NNN" in the path; -1 if not found.
+    int get_device_id() const noexcept { return device_id; }
+
+    /// FIFO id parsed from "fifo_NN" in the filename; -1 if not found.
+    int get_fifo_id() const noexcept { return fifo_id; }
+
     /// Read-only view of the entry last loaded by read_next().
     const AlcorData &current() const noexcept { return data; }
 
@@ -12,6 +12,8 @@
 #include <vector>
 #include <cstdint>
 #include <algorithm>
+#include <optional>
+#include <span>
 #include "alcor_finedata.h"
 #include "triggers.h"
 #include "utility/config_reader.h"
@@ -48,11 +50,38 @@ struct AlcorLightdataStruct
     float ring2_cy = 0.f;
     float ring2_radius = 0.f;
 
+    /**
+     * @brief Trigger-presence mask of @ref trigger_hits (see @ref TriggerMask).
+     *
+     * Sealed by the framer once the frame's triggers are final and kept in
+     * step by every later trigger edit (@ref AlcorSpilldata::add_trigger_to_frame,
+     * the retrigger and overlay rewrites).  Files written before the member
+     * existed read it back as 0 — use @ref get_trigger_mask, which falls back
+     * to a scan for those.
+     */
+    TriggerMask trigger_mask = 0;
+
+    /// @brief Recompute @ref trigger_mask from @ref trigger_hits.
+    void seal_trigger_mask() { trigger_mask = trigger_mask_of(trigger_hits); }
+
+    /// @brief Sealed mask, or one computed on the fly for an unsealed frame.
+    TriggerMask get_trigger_mask() const
+    {
+        return trigger_mask || trigger_hits.empty() ? trigger_mask : trigger_mask_of(trigger_hits);
+    }
+
+    /// @brief Whether the frame carries trigger @p index (see @ref frame_has_trigger).
+    bool has_trigger(uint8_t index) const
+    {
+        return frame_has_trigger(get_trigger_mask(), trigger_hits, index);
+    }
+
     /**
      * @brief Clear all vectors and release memory.
      *
      * Empties all Hit vectors and calls @c shrink_to_fit() on each to return
-     * heap storage to the allocator.  Also resets the per-frame ring scalars.
+     * heap storage to the allocator.  Also resets the per-frame ring scalars
+     * and the trigger mask.
      */
     void clear();
 };
@@ -138,7 +167,11 @@ public:
     void set_cherenkov_hits(std::vector<AlcorFinedataStruct> v) { lightdata.cherenkov_hits = v; }
 
     /// @brief Replace the trigger Hit vector.
-    void set_trigger(std::vector<TriggerEvent> v) { lightdata.trigger_hits = v; }
+    void set_trigger(std::vector<TriggerEvent> v)
+    {
+        lightdata.trigger_hits = v;
+        lightdata.seal_trigger_mask();
+    }
 
     ///@}
 
@@ -158,7 +191,11 @@ public:
     void set_cherenkov_hits_link(std::vector<AlcorFinedataStruct> &v) { lightdata.cherenkov_hits = v; }
 
     /// @brief Replace the trigger Hit vector (assigned from reference).
-    void set_trigger_link(std::vector<TriggerEvent> &v) { lightdata.trigger_hits = v; }
+    void set_trigger_link(std::vector<TriggerEvent> &v)
+    {
+        lightdata.trigger_hits = v;
+        lightdata.seal_trigger_mask();
+    }
 
     ///@}
 
@@ -174,3 +211,41 @@ public:
 
     ///@}
 };
+
+/**
+ * @brief Non-owning, read-only view of an @ref AlcorLightdataStruct.
+ *
+ * Same read interface as @ref AlcorLightdata, but the Hit collections come
+ * back as `std::span`s over the viewed struct's vectors — constructing or
+ * passing a view copies nothing.  Used by the recodata per-frame compute
+ * and drain, which only read the frame.  The viewed struct must outlive
+ * the view and must not be resized while it is in use.
+ */
+class AlcorLightdataView
+{
+public:
+    /// @brief View an existing lightdata struct (implicit: frames convert at the call site).
+    AlcorLightdataView(const AlcorLightdataStruct &data_struct) : lightdata(&data_struct) {}
+
+    /// @brief Underlying struct — per-frame ring scalars and any field not wrapped below.
+    const AlcorLightdataStruct &get_lightdata_link() const { return *lightdata; }
+
+    std::span<const AlcorFinedataStruct> get_timing_hits() const { return lightdata->timing_hits; }
+    std::span<const AlcorFinedataStruct> get_tracking_hits() const { return lightdata->tracking_hits; }
+    std::span<const AlcorFinedataStruct> get_cherenkov_hits() const { return lightdata->cherenkov_hits; }
+    std::span<const TriggerEvent> get_triggers() const { return lightdata->trigger_hits; }
+
+    /// @brief As @ref AlcorLightdata::get_trigger_time.
+    std::optional<float> get_trigger_time(uint8_t trigger_index) const
+    {
+        if (!lightdata->has_trigger(trigger_index))
+            return std::nullopt;
+        for (const auto &t : lightdata->trigger_hits)
+            if (t.index == trigger_index)
+                return t.fine_time;
+        return std::nullopt;
+    }
+
+private:
+    const AlcorLightdataStruct *lightdata;
+};
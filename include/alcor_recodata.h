@@ -68,11 +68,18 @@ private:
     std::vector<AlcorFinedataStruct> recodata;                  ///< Owned Hit collection.
     std::vector<AlcorFinedataStruct> *recodata_ptr = &recodata; ///< Branch-address pointer slot — points at the owned vector for the wrapper's lifetime.
 
+    uint32_t frame_id = kNoFrame; ///< Framer frame of the entry; @ref kNoFrame for the start-of-spill marker and for trees without a `frame` branch.
+
+    TriggerMask trigger_mask = 0; ///< Trigger-presence mask of @ref triggers (see @ref TriggerMask); 0 for trees without a `trigger_mask` branch.
+
 public:
     // ================================================================
     //  Constructors
     // ================================================================
 
+    /// @brief @ref get_frame_id of an entry that does not map onto a framer frame.
+    static constexpr uint32_t kNoFrame = UINT32_MAX;
+
     /// @brief Default constructor — creates an empty container.
     AlcorRecodata() = default;
 
@@ -124,6 +131,39 @@ public:
     /// @brief Return a mutable reference to the full trigger vector.
     inline std::vector<TriggerEvent> &get_triggers_link() { return triggers; }
 
+    /**
+     * @brief Framer frame index of the entry within its spill.
+     *
+     * The frame's start is `frame_id × frame_size` clock cycles after the
+     * spill start; trigger and hit coarse times count from there.
+     * @ref kNoFrame for the start-of-spill marker and for recodata written
+     * before the `frame` branch existed.
+     */
+    inline uint32_t get_frame_id() const { return frame_id; }
+
+    /// @brief Set the framer frame index of the entry.
+    inline void set_frame_id(uint32_t v) { frame_id = v; }
+
+    /// @brief Address of the frame index, for branch binding.
+    inline uint32_t *get_frame_id_ptr() { return &frame_id; }
+
+    /**
+     * @brief Trigger-presence mask of the entry (see @ref TriggerMask).
+     *
+     * The stored mask when the entry carries one; computed from the trigger
+     * vector for recodata written before the `trigger_mask` branch existed.
+     */
+    inline TriggerMask get_trigger_mask() const
+    {
+        return trigger_mask || triggers.empty() ? trigger_mask : trigger_mask_of(triggers);
+    }
+
+    /// @brief Set the trigger-presence mask (entries whose triggers were swapped in whole).
+    inline void set_trigger_mask(TriggerMask v) { trigger_mask = v; }
+
+    /// @brief Address of the trigger mask, for branch binding.
+    inline TriggerMask *get_trigger_mask_ptr() { return &trigger_mask; }
+
     ///@}
 
     // ================================================================
@@ -315,10 +355,14 @@ public:
     inline void add_hit_mask_bit(int i, uint32_t v) { recodata[i].HitMask |= encode_bit(v); }
 
     /// @brief Append a trigger from its constituent fields.
-    inline void add_trigger(uint8_t index, uint16_t coarse, float fine_time = 0.) { triggers.emplace_back(index, coarse, fine_time); }
+    inline void add_trigger(uint8_t index, uint16_t coarse, float fine_time = 0.) { add_trigger(TriggerEvent(index, coarse, fine_time)); }
 
-    /// @brief Append a pre-built @ref TriggerEvent.
-    inline void add_trigger(TriggerEvent Hit) { triggers.push_back(Hit); }
+    /// @brief Append a pre-built @ref TriggerEvent and set its mask bit.
+    inline void add_trigger(TriggerEvent Hit)
+    {
+        trigger_mask = get_trigger_mask() | trigger_mask_bit(Hit.index);
+        triggers.push_back(Hit);
+    }
 
     /// @brief Append a Hit from an @ref AlcorFinedataStruct.
     inline int add_hit(const AlcorFinedataStruct &Hit)
@@ -354,42 +398,42 @@ public:
      */
     ///@{
 
-    /// @brief True if a trigger with index @p v exists for this event.
-    inline bool check_trigger(uint8_t v) { return get_trigger_by_index(v).has_value(); }
+    /// @brief True if a trigger with index @p v exists for this event (one mask test; see @ref frame_has_trigger).
+    inline bool check_trigger(uint8_t v) const { return frame_has_trigger(get_trigger_mask(), triggers, v); }
 
     /// @brief True if the start-of-spill trigger is present.
-    inline bool is_start_of_spill() { return check_trigger(TriggerStartOfSpill); }
+    inline bool is_start_of_spill() const { return check_trigger(TriggerStartOfSpill); }
 
     /// @brief True if the first-frames trigger is present.
-    inline bool is_first_frames() { return check_trigger(TriggerFirstFrames); }
+    inline bool is_first_frames() const { return check_trigger(TriggerFirstFrames); }
 
     /// @brief True if a timing trigger is present.
-    inline bool is_timing_available() { return check_trigger(TriggerTiming); }
+    inline bool is_timing_available() const { return check_trigger(TriggerTiming); }
 
     /// @brief True if embedded tracking data are attached to this event.
-    inline bool is_embedded_tracking_available() { return check_trigger(TriggerTracking); }
+    inline bool is_embedded_tracking_available() const { return check_trigger(TriggerTracking); }
 
     /// @brief True if at least one ring has been reconstructed.
-    inline bool is_ring_found() { return check_trigger(TriggerRingFound); }
+    inline bool is_ring_found() const { return check_trigger(TriggerRingFound); }
 
     /// @brief True if any bit of @p v is set in the mask of Hit @p i.
-    inline bool check_hit_mask(int i, uint32_t v) { return (get_hit_mask(i) & v) != 0; }
+    inline bool check_hit_mask(int i, uint32_t v) const { return (get_hit_mask(i) & v) != 0; }
 
     /// @brief True if Hit @p i is flagged as an afterpulse (delegates to @ref AlcorFinedata).
-    inline bool is_afterpulse(int i) { return get_finedata(i).is_afterpulse(); }
+    inline bool is_afterpulse(int i) const { return get_finedata(i).is_afterpulse(); }
 
     /// @brief True if ToT Hit @p i is a secondary orphan — primary present, stop/2nd-threshold missing (delegates).
-    inline bool is_secondary_orphan(int i) { return get_finedata(i).is_secondary_orphan(); }
+    inline bool is_secondary_orphan(int i) const { return get_finedata(i).is_secondary_orphan(); }
 
     /// @brief True if ToT Hit @p i is a leading orphan — secondary present, primary missing (delegates).
-    inline bool is_leading_orphan(int i) { return get_finedata(i).is_leading_orphan(); }
+    inline bool is_leading_orphan(int i) const { return get_finedata(i).is_leading_orphan(); }
 
     /// @brief True if Hit @p i is flagged as optical cross-talk (delegates to @ref AlcorFinedata).
-    inline bool is_cross_talk(int i) { return get_finedata(i).is_cross_talk(); }
+    inline bool is_cross_talk(int i) const { return get_finedata(i).is_cross_talk(); }
 
     /// @brief True if Hit @p i has been associated with a reconstructed ring.
     /// Body in alcor_recodata.cxx — uses HitMask enum constants from alcor_data.h.
-    bool is_ring_tagged(int i);
+    bool is_ring_tagged(int i) const;
 
     ///@}
 
@@ -399,7 +443,7 @@ public:
     ///@{
 
     /**
-     * @brief Clear all hits and triggers, resetting the container to an empty state.
+     * @brief Clear all hits, triggers and the trigger mask, resetting the container to an empty state.
      * Does not reset the RANSAC LUT or accumulator configuration.
      */
     void clear();
@@ -411,7 +455,7 @@ public:
     bool link_to_tree(TTree *input_tree);
 
     /**
-     * @brief Create branches in @p output_tree for hits and triggers.
+     * @brief Create branches in @p output_tree for hits, triggers, the frame index and the trigger mask.
      * @param output_tree  Destination tree.
      */
     void write_to_tree(TTree *output_tree);
@@ -242,9 +242,10 @@ public:
      * Maps each @ref TrackingAltaiStruct in @p vec to an internal
      * @ref AlcorRecotrackdataStruct, preserving insertion order.
      *
-     * @param vec Per-track ALTAI output for the current event.
+     * @param vec Per-track ALTAI output for the current event (a view
+     *            from @ref TrackingAltai::get_event_tracks).
      */
-    void import_event(std::vector<TrackingAltaiStruct> vec);
+    void import_event(std::span<const TrackingAltaiStruct> vec);
 
     /// @}
 
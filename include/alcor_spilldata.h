@@ -209,8 +209,13 @@ public:
     /// @brief Returns @c true if the given frame contains at least one trigger Hit.
     bool has_trigger(uint32_t index_of_frame) { return !spilldata.frame_and_lightdata[index_of_frame].trigger_hits.empty(); }
 
-    /// @brief Appends a trigger event to the Hit list of the specified frame.
-    void add_trigger_to_frame(uint32_t index_of_frame, TriggerEvent trg) { spilldata.frame_and_lightdata[index_of_frame].trigger_hits.push_back(trg); }
+    /// @brief Appends a trigger event to the Hit list of the specified frame and sets its mask bit.
+    void add_trigger_to_frame(uint32_t index_of_frame, TriggerEvent trg)
+    {
+        auto &frame = spilldata.frame_and_lightdata[index_of_frame];
+        frame.trigger_mask = frame.get_trigger_mask() | trigger_mask_bit(trg.index);
+        frame.trigger_hits.push_back(trg);
+    }
 
     /// @brief Marks a frame to be excluded from the next TTree fill.
     void do_not_write_frame(uint32_t index_of_frame) { frame_reference_for_deletion[index_of_frame] = true; }
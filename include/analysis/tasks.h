@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file analysis/tasks.h
+ * @brief The example macros ported as @ref btana::analysis::AnalysisTask.
+ *
+ * One factory per task; @ref btana::analysis::make_train_task maps the
+ * registry names onto them.  Each task keeps its macro's selection,
+ * histograms and `standard_results.toml` keys; canvases are not drawn — the
+ * histograms land in the task's directory of `analysis_train.root`.
+ *
+ * | name                        | macro                                       | input         |
+ * |-----------------------------|---------------------------------------------|---------------|
+ * | `afterpulse`                | `afterpulse_treatment.cpp`                  | recodata      |
+ * | `cross_talk`                | `cross_talk_treatment.cpp`                  | recodata      |
+ * | `dark_count_rate`           | `dark_count_rate.cpp`                       | recodata      |
+ * | `ring_resolution`           | `ring_spatial_resolution.cpp`               | recodata      |
+ * | `ring_resolution_tracked`   | `ring_spatial_resolution_with_tracking.cpp` | recotrackdata |
+ * | `photon_number`             | `photon_number.cpp`                         | recodata      |
+ */
+
+#include "analysis/train.h"
+
+#include <memory>
+
+namespace btana::analysis
+{
+
+std::unique_ptr<AnalysisTask> make_afterpulse_task(const TrainContext &ctx);
+std::unique_ptr<AnalysisTask> make_cross_talk_task(const TrainContext &ctx);
+std::unique_ptr<AnalysisTask> make_dark_count_rate_task(const TrainContext &ctx);
+/// @param tracked  The tracking variant: single-track frames with |φ_track| ≤ 1 seed the ring, `.tracked` result keys.
+std::unique_ptr<AnalysisTask> make_ring_resolution_task(const TrainContext &ctx, bool tracked);
+std::unique_ptr<AnalysisTask> make_photon_number_task(const TrainContext &ctx);
+
+} // namespace btana::analysis
@@ -0,0 +1,160 @@
+#pragma once
+
+/**
+ * @file analysis/train.h
+ * @brief Single-pass "analysis train": many per-frame analyses, one read.
+ *
+ * The standard post-run analyses (afterpulse, cross-talk, DCR, ring
+ * resolution, photon number) each used to open recodata.root and loop
+ * over every frame themselves.  Here each becomes an @ref AnalysisTask and
+ * @ref run_train reads the tree once, handing every entry to every
+ * registered task.
+ *
+ * ### Task life cycle
+ *
+ *   1. The runner clones each task once per worker slot (@ref AnalysisTask::clone)
+ *      and calls @ref AnalysisTask::init on every clone, all on the calling
+ *      thread — histogram booking never races.
+ *   2. The entries are cut into ranges that start at a start-of-spill marker
+ *      (the first range starts at entry 0).  One slot per `util::TaskPool`
+ *      thread opens its own TFile and pulls ranges off a shared cursor;
+ *      within a range its clones see the entries in order through
+ *      @ref AnalysisTask::process, then @ref AnalysisTask::end_chunk.  A clone
+ *      therefore always sees a spill's marker before the spill's frames, but
+ *      successive ranges of one clone need not be adjacent.
+ *   3. The clones are folded into the original task with
+ *      @ref AnalysisTask::merge, in slot order, on the calling thread.
+ *   4. @ref AnalysisTask::finalize runs on the merged task: fits, results to
+ *      `standard_results.toml`, histograms into the task's directory of the
+ *      train output file.
+ *
+ * A task that needs a second look at a subset of the frames (e.g. a fit
+ * seeded by a run-wide mean) keeps what that look needs — the selected hits —
+ * from `process` and finishes the job in `finalize`, instead of re-reading.
+ *
+ * The spill ranges come from a prescan of the `trigger_mask` branch (the
+ * `triggers` branch for files written before it existed).
+ */
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "utility/config_reader.h"
+
+class AlcorRecodata;
+class AlcorRecotrackdata;
+class TDirectory;
+
+namespace btana::analysis
+{
+
+/// Tree the train reads.
+enum class TrainInput
+{
+    Recodata,      ///< `<run>/recodata.root`, tree `recodata`
+    Recotrackdata, ///< `<run>/recotrackdata.root`, tree `recotrackdata` (recodata + tracks)
+};
+
+/**
+ * @brief Run-level inputs shared by every task (read-only once the train starts).
+ */
+struct TrainContext
+{
+    std::string data_repository;
+    std::string run_name;
+    ReadoutConfigList readout_config;
+    /// The readout config's `cherenkov` role (SiPM model via `sensor_for`), or @c nullptr.
+    const ReadoutConfigStruct *cherenkov = nullptr;
+    QaConfigStruct qa_config;
+
+    /// @return `<data_repository>/standard_results.toml`.
+    std::string results_path() const { return data_repository + "/standard_results.toml"; }
+};
+
+/**
+ * @brief One tree entry as a task sees it.
+ *
+ * Valid for the duration of the @ref AnalysisTask::process call only; a task
+ * that needs hits later copies them.
+ */
+struct TrainFrame
+{
+    int64_t entry;                   ///< Tree entry number.
+    const AlcorRecodata &data;       ///< Hits, triggers, frame index.
+    const AlcorRecotrackdata *track; ///< Same entry with its ALTAI tracks; @c nullptr on recodata input.
+};
+
+/**
+ * @brief Per-frame analysis run by the train.
+ *
+ * Implementations hold their configuration (set at construction), their
+ * per-clone accumulators (histograms, counters, cached hits) and nothing
+ * shared: clones run concurrently.
+ */
+class AnalysisTask
+{
+public:
+    virtual ~AnalysisTask() = default;
+
+    /// @brief Registry name, also the task's directory in the output file.
+    virtual std::string name() const = 0;
+
+    /// @brief True if the task reads tracks — the train then reads recotrackdata.
+    virtual bool needs_tracks() const { return false; }
+
+    /// @brief Fresh task with the same configuration and empty accumulators (not yet initialised).
+    virtual std::unique_ptr<AnalysisTask> clone() const = 0;
+
+    /// @brief Book accumulators.  Called once per instance, before any other call but @ref clone.
+    virtual void init() = 0;
+
+    /// @brief Consume one entry.
+    virtual void process(const TrainFrame &frame) = 0;
+
+    /// @brief Close a contiguous entry range (flush per-spill state).
+    virtual void end_chunk() {}
+
+    /// @brief Fold @p other (a clone of this task, past its last @ref end_chunk) into this one.
+    virtual void merge(AnalysisTask &other) = 0;
+
+    /**
+     * @brief Produce the task's results from the merged accumulators.
+     * @param ctx  Run context (results file, run name).
+     * @param out  The task's directory in the train output file.
+     */
+    virtual void finalize(const TrainContext &ctx, TDirectory *out) = 0;
+};
+
+/// @return Names accepted by @ref make_train_task, in the default run order.
+std::vector<std::string> train_task_names();
+
+/**
+ * @brief Build a registered task by name.
+ * @return The task, or @c nullptr for an unknown name.
+ */
+std::unique_ptr<AnalysisTask> make_train_task(const std::string &name, const TrainContext &ctx);
+
+/// Options of one @ref run_train call.
+struct TrainOptions
+{
+    /// Input tree; unset picks recotrackdata iff a task needs tracks.
+    std::optional<TrainInput> input;
+    int64_t max_frames = -1;  ///< Cap on entries read; -1 reads all.
+    std::string output_file;  ///< Empty → `<repo>/<run>/analysis_train.root`.
+};
+
+/**
+ * @brief Run @p tasks over one run in a single pass.
+ *
+ * Finalises every task and writes the output file.
+ * @return 0 on success, non-zero if the input cannot be read or a task
+ *         needs tracks the chosen input does not carry.
+ */
+int run_train(const TrainContext &ctx,
+              std::vector<std::unique_ptr<AnalysisTask>> &tasks,
+              const TrainOptions &options = {});
+
+} // namespace btana::analysis
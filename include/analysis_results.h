@@ -18,6 +18,22 @@
  * `error` is omitted on disk for dimensionless diagnostics (e.g.
  * `chi2_ndf`, `gs_frac`) where an uncertainty isn't meaningful.
  *
+ * ### Journal
+ * Updates through a ResultsBackend::Journal handle are appended to a
+ * sibling `<file>.journal` instead of rewriting the TOML: a 16-byte
+ * header (magic `BTRESJNL`, u64 generation) followed by records
+ *
+ *     u32 payload_bytes | u64 FNV-1a(payload) | payload
+ *     payload = u8 kind(1) | u16 n | run | u16 n | sensor | u16 n | quantity
+ *             | f64 value | f64 error
+ *
+ * in little-endian byte order.  The journal replays on top of the TOML
+ * (last record wins); a torn or corrupt tail ends the replay and is cut
+ * off by the next append.  Once it outgrows the compaction threshold it
+ * is folded back into the TOML, which therefore stays the canonical,
+ * hand-readable copy.  Every reader — this class and the dashboard's
+ * `rundb.results_load` — sees TOML + journal.
+ *
  * ### Quantity naming convention
  * Quantities follow the pattern `<scope>.<name>`, where scope encodes the
  * histogram from which the value was derived:
@@ -36,9 +52,14 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "TGraphErrors.h" // for make_graph() return type
@@ -74,6 +95,22 @@ struct ResultKey
     {
         return std::tie(run, sensor, quantity) < std::tie(o.run, o.sensor, o.quantity);
     }
+
+    /** @brief Component-wise equality, for the hash index. */
+    bool operator==(const ResultKey &o) const = default;
+};
+
+/** @brief Hash of a ResultKey, for the AnalysisResults index. */
+struct ResultKeyHash
+{
+    std::size_t operator()(const ResultKey &k) const noexcept
+    {
+        const std::hash<std::string> h;
+        std::size_t seed = h(k.run);
+        seed ^= h(k.sensor) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        seed ^= h(k.quantity) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        return seed;
+    }
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -104,6 +141,37 @@ struct ResultEntry
  */
 using ResultMap = std::map<ResultKey, ResultEntry>;
 
+/**
+ * @brief Every run's entry for one (quantity, sensor), sorted by run.
+ *
+ * Structure-of-arrays view of one cross-run trend, as served by
+ * AnalysisResults::column().  @c runs is sorted and unique; @c values
+ * and @c errors are parallel to it.
+ */
+struct ResultColumn
+{
+    std::vector<std::string> runs;
+    std::vector<double> values;
+    std::vector<double> errors;
+
+    /** @brief Binary search for @p run; @c std::nullopt if absent. */
+    std::optional<ResultEntry> find(const std::string &run) const;
+};
+
+/**
+ * @brief How AnalysisResults::update() persists a batch.
+ *
+ *  - @c Toml    — merge and rewrite the whole TOML (folding in any
+ *                 journal), as before the journal existed.
+ *  - @c Journal — append the batch to `<file>.journal`; the TOML is
+ *                 rewritten only when the journal is compacted.
+ */
+enum class ResultsBackend
+{
+    Toml,
+    Journal
+};
+
 // ─────────────────────────────────────────────────────────────────────────────
 //  AnalysisResults
 // ─────────────────────────────────────────────────────────────────────────────
@@ -132,6 +200,17 @@ using ResultMap = std::map<ResultKey, ResultEntry>;
  * auto m  = ar.load();
  * auto *g = make_graph(m, RunList, vbias_vals, "1350", "ex_gap.n_gamma");
  * @endcode
+ *
+ * Writers that run concurrently use ResultsBackend::Journal, which
+ * appends instead of rewriting.  The handle keeps a hash index of
+ * TOML + journal, refreshed by scanning only the journal tail added
+ * since the last call, so find(), query_run() and make_graph() on the
+ * handle are index lookups.  Cross-run trends come from a column store
+ * — (quantity, sensor) → runs sorted with their values — built in one
+ * pass over the index on the first trend query and dropped whenever the
+ * index changes; make_graph() and make_graphs() merge the caller's run
+ * list against it, O(points) per graph.  A handle is not thread-safe; use one per
+ * thread (processes coordinate through the `<file>.lock` flock).
  */
 class AnalysisResults
 {
@@ -152,7 +231,9 @@ public:
      *              @c *.audit.toml is emitted alongside on every
      *              @c update() that carries a non-empty @c source tag.
      */
-    explicit AnalysisResults(const std::string &path) : fPath(path) {}
+    explicit AnalysisResults(const std::string &path,
+                             ResultsBackend backend = ResultsBackend::Toml)
+        : fPath(path), fBackend(backend) {}
 
     // ── I/O ──────────────────────────────────────────────────────────────────
 
@@ -161,8 +242,9 @@ public:
      *
      * Parses the TOML file and walks the
      * `results."<run>"."<sensor>"."<quantity>"` table tree into a
-     * ResultMap.  Returns an empty map if the file does not exist,
-     * fails to parse, or carries no top-level `[results]` table.
+     * ResultMap, then replays the journal on top.  Returns an empty map
+     * if neither file exists, the TOML fails to parse, or it carries no
+     * top-level `[results]` table and there is no journal.
      *
      * @return  ResultMap containing every stored (key, entry) pair.
      */
@@ -171,9 +253,12 @@ public:
     /**
      * @brief Upsert a batch of entries into the persistent store.
      *
-     * Loads the current file contents, merges @p entries (overwriting any
-     * existing entries with the same key), then rewrites the entire file.
-     * Entries not present in @p entries are preserved unchanged.
+     * Toml backend: loads the current contents, merges @p entries
+     * (overwriting any existing entries with the same key), then rewrites
+     * the entire file.  Journal backend: appends @p entries to the
+     * journal in one write, compacting when it outgrows the threshold.
+     * Either way, entries not present in @p entries are preserved
+     * unchanged.
      *
      * @param entries  Map of keys and values to insert or update.
      * @param source   Optional provenance tag.  When non-empty, one
@@ -204,14 +289,106 @@ public:
         update(ResultMap{{key, {value, error}}}, source);
     }
 
+    /**
+     * @brief Fold the journal into the canonical TOML and reset it.
+     *
+     * Runs automatically from a Journal-backend update() once the
+     * journal exceeds the compaction threshold; call it directly to
+     * force one (e.g. at the end of a campaign).  No-op without a
+     * journal.
+     */
+    void compact() const;
+
+    /**
+     * @brief Index lookup of one entry.
+     * @return  The stored entry, or @c std::nullopt if the key is absent.
+     */
+    std::optional<ResultEntry> find(const ResultKey &key) const;
+
+    /**
+     * @brief The (quantity, sensor) column: every run carrying it.
+     * @return  Copy of the column; empty if no run has the quantity.
+     */
+    ResultColumn column(const std::string &sensor, const std::string &quantity) const;
+
+    /**
+     * @brief Journal size (bytes) above which update() compacts.
+     * Default 1 MiB, i.e. ~10⁴ records.
+     */
+    void set_compaction_threshold(std::uintmax_t bytes) { fCompactBytes = bytes; }
+
     /**
      * @brief Return the filesystem path this handle points to.
      * @return  Path string passed to the constructor.
      */
     const std::string &path() const { return fPath; }
 
+    /** @brief Path of the journal kept next to path(). */
+    std::string journal_path() const { return fPath + ".journal"; }
+
 private:
+    friend std::map<std::string, ResultEntry>
+    query_run(const AnalysisResults &ar, const std::string &run, const std::string &sensor);
+    friend std::vector<TGraphErrors *>
+    make_graphs(const AnalysisResults &ar, const std::vector<std::string> &runs,
+                const std::vector<double> &x_vals, const std::string &sensor,
+                const std::vector<std::string> &quantities, const std::string &x_err_qty);
+
     std::string fPath; ///< Path to the backing TOML file
+    ResultsBackend fBackend;
+    std::uintmax_t fCompactBytes = std::uintmax_t{1} << 20;
+
+    //  ── Index of TOML + journal (see refresh_index_locked) ───────────
+    //  Mutable: built lazily by the const readers.
+    mutable std::unordered_map<ResultKey, ResultEntry, ResultKeyHash> fIndex;
+    //  "<run>\x1f<sensor>" → quantities, in first-seen order.
+    mutable std::unordered_map<std::string, std::vector<std::string>> fQuantities;
+    mutable bool fIndexBuilt = false;
+    mutable int64_t fTomlMtime = 0;          ///< TOML stamp at the last rebuild
+    mutable std::uintmax_t fTomlSize = 0;
+    mutable uint64_t fJournalGeneration = 0; ///< header generation indexed
+    mutable std::uintmax_t fJournalOffset = 0; ///< journal bytes folded in
+    mutable std::uintmax_t fJournalSize = 0;   ///< on-disk size at last scan
+
+    //  ── Column store (see columns_locked) ─────────────────────────────
+    //  "<quantity>\x1f<sensor>" → column; valid while fColumnsBuilt.
+    mutable std::unordered_map<std::string, ResultColumn> fColumns;
+    mutable bool fColumnsBuilt = false;
+
+    /** @brief Parse the TOML file alone into a ResultMap. */
+    ResultMap read_toml() const;
+
+    /**
+     * @brief Bring the index up to date with TOML + journal.
+     *
+     * Rebuilds from scratch when the TOML changed or the journal was
+     * compacted (new generation) since the last call; otherwise scans
+     * only the journal bytes appended since.  Caller holds the lock.
+     */
+    void refresh_index_locked() const;
+
+    /** @brief Insert-or-overwrite one key in the index. */
+    void index_put(const ResultKey &key, const ResultEntry &entry) const;
+
+    /**
+     * @brief The column store, (re)built from the index if an update or
+     *        refresh touched it since.  Caller holds the lock and has
+     *        refreshed the index.
+     */
+    const std::unordered_map<std::string, ResultColumn> &columns_locked() const;
+
+    /**
+     * @brief Rewrite the TOML from the index and reset the journal to
+     *        an empty next generation.  Caller holds the lock.
+     * @return @c false if the TOML could not be replaced (journal kept).
+     */
+    bool compact_locked() const;
+
+    /**
+     * @brief Append @p entries to the journal (one write), cutting off
+     *        a torn tail first.  Caller holds the lock.
+     */
+    bool append_journal_locked(const ResultMap &entries) const;
 
     /**
      * @brief Overwrite the TOML file at @p target_path with the contents
@@ -230,6 +407,13 @@ private:
      * @param target_path  Destination file path (see above).
      */
     void write(const ResultMap &data, const std::string &target_path) const;
+
+    /**
+     * @brief Write @p data to a per-process tmp file and rename it over
+     *        @ref fPath.
+     * @return @c false on failure (fPath unchanged).
+     */
+    bool replace_toml(const ResultMap &data) const;
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -253,6 +437,15 @@ query_run(const ResultMap &m,
           const std::string &run,
           const std::string &sensor);
 
+/**
+ * @brief query_run() against a handle's index: one hash lookup for the
+ *        (run, sensor) quantity list, one per quantity.
+ */
+std::map<std::string, ResultEntry>
+query_run(const AnalysisResults &ar,
+          const std::string &run,
+          const std::string &sensor);
+
 /**
  * @brief Build a TGraphErrors from a ResultMap for a scan over multiple runs.
  *
@@ -281,4 +474,33 @@ make_graph(const ResultMap &m,
            const std::vector<double> &x_vals,
            const std::string &sensor,
            const std::string &quantity,
-           const std::string &x_err_qty = "");
\ No newline at end of file
+           const std::string &x_err_qty = "");
+
+/**
+ * @brief make_graph() against a handle's column store — no full load()
+ *        of the store, O(points) per graph.
+ */
+TGraphErrors *
+make_graph(const AnalysisResults &ar,
+           const std::vector<std::string> &runs,
+           const std::vector<double> &x_vals,
+           const std::string &sensor,
+           const std::string &quantity,
+           const std::string &x_err_qty = "");
+
+/**
+ * @brief One make_graph() per entry of @p quantities, in one pass.
+ *
+ * The run list is sorted once and each graph is one linear merge against
+ * its column, all under a single refresh of the handle.
+ *
+ * @return  Heap-allocated graphs parallel to @p quantities (caller takes
+ *          ownership); never null.
+ */
+std::vector<TGraphErrors *>
+make_graphs(const AnalysisResults &ar,
+            const std::vector<std::string> &runs,
+            const std::vector<double> &x_vals,
+            const std::string &sensor,
+            const std::vector<std::string> &quantities,
+            const std::string &x_err_qty = "");
\ No newline at end of file
@@ -339,7 +339,7 @@ public:
     /**
      * @brief Per-worker-thread scratch space (frame map + QA histograms).
      *
-     * Each `std::async` worker in @ref next_spill owns one of these.  Two
+     * Each pool-task slot in @ref next_spill owns one of these.  Two
      * dominant per-Hit contention points are addressed by isolating them per
      * worker:
      *
@@ -10,6 +10,9 @@
  * to associate Cherenkov hits with the impact point on the radiator plane.
  */
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 #include <map>
@@ -36,9 +39,16 @@ struct TrackingAltaiStruct
 /**
  * @brief Container and loader for ALTAI telescope tracking data.
  *
- * Stores one map from event ID to the list of reconstructed tracks for that
- * event.  Data are loaded from a plain-text ALTAI output file via
- * @ref load_tracking_file.
+ * Tracks are stored flat (CSR): every track of the run in one contiguous
+ * array, grouped by event, plus the sorted event IDs and per-event
+ * offsets into it.  An event listed with no tracks (`*` line) has an
+ * empty range.  Lookups are O(1) for the usual dense 0…N−1 event IDs and
+ * a binary search otherwise.
+ *
+ * Data are loaded from a plain-text ALTAI output file via
+ * @ref load_tracking_file, which memory-maps the file and parses it with
+ * `std::from_chars`, then keeps a binary image of the CSR arrays next to
+ * it (`<file>.bin`) that later loads read instead of the text.
  */
 class TrackingAltai
 {
@@ -64,20 +74,27 @@ public:
     ///@{
 
     /**
-     * @brief Return a copy of the full event → track-list map.
+     * @brief Build a copy of the full event → track-list map.
      * @return Map from event ID to vector of @ref TrackingAltaiStruct.
      */
-    std::map<uint32_t, std::vector<TrackingAltaiStruct>> get_data_map() const { return data_map; }
+    std::map<uint32_t, std::vector<TrackingAltaiStruct>> get_data_map() const;
+
+    /// @brief Return the total number of events (tracks or `*`) loaded.
+    uint32_t get_number_of_events() const { return static_cast<uint32_t>(event_ids.size()); }
 
-    /// @brief Return the total number of events (keys) in the map.
-    uint32_t get_number_of_events() const { return static_cast<uint32_t>(data_map.size()); }
+    /// @brief Return the total number of tracks over all events.
+    std::size_t get_number_of_tracks() const { return tracks.size(); }
+
+    /// @brief Every loaded event ID (tracks or `*`), ascending.
+    std::span<const uint32_t> get_event_ids() const { return event_ids; }
 
     /**
      * @brief Return all tracks for a given event.
      * @param event_id  Event to query.
-     * @return Vector of @ref TrackingAltaiStruct; empty if the event is absent.
+     * @return View into the flat track array; empty if the event is
+     *         absent.  Invalidated by the setters and by a reload.
      */
-    std::vector<TrackingAltaiStruct> get_event_tracks(uint32_t event_id) const;
+    std::span<const TrackingAltaiStruct> get_event_tracks(uint32_t event_id) const;
 
     /**
      * @brief Return the number of tracks reconstructed for @p event_id.
@@ -92,34 +109,34 @@ public:
     ///@{
 
     /// @brief Extrapolated X at the reference plane [mm] for track @p idx of event @p event_id.
-    float get_zero_plane_x(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).zero_plane_x; }
+    float get_zero_plane_x(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).zero_plane_x; }
 
     /// @brief Extrapolated Y at the reference plane [mm] for track @p idx of event @p event_id.
-    float get_zero_plane_y(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).zero_plane_y; }
+    float get_zero_plane_y(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).zero_plane_y; }
 
     /// @brief Extrapolated Z at the reference plane [mm] for track @p idx of event @p event_id (always 0).
-    float get_zero_plane_z(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).zero_plane_z; }
+    float get_zero_plane_z(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).zero_plane_z; }
 
     /// @brief Angular coefficient dx/dz for track @p idx of event @p event_id.
-    float get_angcoeff_dx(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).angcoeff_dx; }
+    float get_angcoeff_dx(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).angcoeff_dx; }
 
     /// @brief Angular coefficient dy/dz for track @p idx of event @p event_id.
-    float get_angcoeff_dy(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).angcoeff_dy; }
+    float get_angcoeff_dy(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).angcoeff_dy; }
 
     /// @brief Angular coefficient dz/dz for track @p idx of event @p event_id (always 1).
-    float get_angcoeff_dz(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).angcoeff_dz; }
+    float get_angcoeff_dz(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).angcoeff_dz; }
 
     /// @brief χ² for track @p idx of event @p event_id.
-    float get_chi2(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).chi2; }
+    float get_chi2(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).chi2; }
 
     /// @brief χ²/NDF for track @p idx of event @p event_id.
-    float get_chi2ndof(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).chi2ndof; }
+    float get_chi2ndof(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).chi2ndof; }
 
     /// @brief Degrees of freedom for track @p idx of event @p event_id.
-    int get_ndof(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).ndof; }
+    int get_ndof(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).ndof; }
 
     /// @brief Timestamp for track @p idx of event @p event_id.
-    double get_timestamp(uint32_t event_id, std::size_t idx) const { return data_map.at(event_id).at(idx).timestamp; }
+    double get_timestamp(uint32_t event_id, std::size_t idx) const { return track_at(event_id, idx).timestamp; }
 
     ///@}
 
@@ -131,14 +148,14 @@ public:
      * @param event_id  Target event.
      * @param track     Track to append.
      */
-    void add_event_track(uint32_t event_id, const TrackingAltaiStruct &track) { data_map[event_id].push_back(track); }
+    void add_event_track(uint32_t event_id, const TrackingAltaiStruct &track) { splice_event(event_id, {&track, 1}, /*append=*/true); }
 
     /**
      * @brief Replace all tracks for @p event_id with @p tracks.
      * @param event_id  Target event.
      * @param tracks    New track list.
      */
-    void set_event_tracks(uint32_t event_id, const std::vector<TrackingAltaiStruct> &tracks) { data_map[event_id] = tracks; }
+    void set_event_tracks(uint32_t event_id, const std::vector<TrackingAltaiStruct> &tracks) { splice_event(event_id, tracks, /*append=*/false); }
 
     ///@}
 
@@ -157,13 +174,36 @@ public:
     ///@{
 
     /**
-     * @brief Parse an ALTAI plain-text output file and populate the internal map.
+     * @brief Load an ALTAI plain-text output file, replacing the current content.
+     *
+     * Reads the binary cache `<input_file>.bin` when it matches the text
+     * file (size + modification time + struct layout); otherwise parses
+     * the text and rewrites the cache.  A cache that cannot be written is
+     * not an error.
+     *
      * @param input_file  Path to the ALTAI tracking output file.
+     * @param use_cache   @c false: always parse the text, never touch the cache.
      */
-    void load_tracking_file(const std::string &input_file);
+    void load_tracking_file(const std::string &input_file, bool use_cache = true);
+
+    /// @brief Path of the binary cache kept next to @p input_file.
+    static std::string cache_path(const std::string &input_file) { return input_file + ".bin"; }
 
     ///@}
 
 private:
-    std::map<uint32_t, std::vector<TrackingAltaiStruct>> data_map; ///< Event ID → list of reconstructed tracks.
+    /// Index of @p event_id in @ref event_ids, or `npos`.
+    std::size_t find_event(uint32_t event_id) const;
+    /// `.at()`-style access (throws `std::out_of_range`) for the field getters.
+    const TrackingAltaiStruct &track_at(uint32_t event_id, std::size_t idx) const;
+    /// Replace (or append to) the track range of @p event_id, creating the event if needed.
+    void splice_event(uint32_t event_id, std::span<const TrackingAltaiStruct> new_tracks, bool append);
+    /// Parse the text format into the CSR arrays; false if the file cannot be read.
+    bool parse_text(const std::string &input_file);
+    bool load_cache(const std::string &path, uint64_t source_size, int64_t source_mtime);
+    bool store_cache(const std::string &path, uint64_t source_size, int64_t source_mtime) const;
+
+    std::vector<uint32_t> event_ids;           ///< Sorted, unique event IDs.
+    std::vector<uint32_t> event_offsets{0};    ///< Event i owns tracks[event_offsets[i], event_offsets[i+1]).
+    std::vector<TrackingAltaiStruct> tracks;   ///< Every track, grouped by event in @ref event_ids order.
 };
@@ -16,7 +16,9 @@
  * - [`triggers.h`](../triggers.h) — umbrella header re-exporting all three.
  */
 
+#include <array>
 #include <cstdint>
+#include <iterator>
 
 // ============================================================
 //  Trigger enum & compile-time metadata
@@ -127,3 +129,99 @@ struct TriggerEvent
     TriggerEvent(uint8_t idx, uint16_t crs, float fine)
         : index(idx), coarse(crs), fine_time(fine), is_secondary(false) {}
 };
+
+// ============================================================
+//  Per-frame trigger-presence mask
+// ============================================================
+
+/**
+ * @brief 64-bit summary of which trigger values a frame carries.
+ *
+ * Computed once when a frame is sealed (framer, recodata archive) and
+ * persisted next to the trigger vector, so trigger-gated loops can skip a
+ * frame with one AND instead of scanning its @ref TriggerEvent list.
+ *
+ * The bit layout is fixed — it does not depend on the run's trigger config,
+ * so a mask written by one run reads the same in any other:
+ *   - bits 0–54   config indices 0–54 (bit = index);
+ *   - bit  55     shared by config indices 55–99 and unmapped values
+ *                 (@ref kTriggerMaskShared);
+ *   - bits 56–63  the built-in triggers, in @ref all_default_triggers order.
+ *
+ * Every bit but the shared one is exact.  A mask of 0 on a frame with a
+ * non-empty trigger vector means "not sealed" (files written before the
+ * mask existed); readers then fall back to @ref trigger_mask_of.
+ */
+using TriggerMask = uint64_t;
+
+/// Number of config indices that own a dedicated mask bit.
+constexpr int kTriggerMaskExactConfig = 55;
+/// Bit shared by config indices >= @ref kTriggerMaskExactConfig and unmapped values.
+constexpr int kTriggerMaskShared = kTriggerMaskExactConfig;
+/// First bit of the built-in trigger block.
+constexpr int kTriggerMaskDefaults = kTriggerMaskShared + 1;
+
+static_assert(kTriggerMaskDefaults + n_default_triggers == 64,
+              "trigger mask layout must fill exactly 64 bits");
+
+/// @cond INTERNAL
+/// Trigger value -> mask bit, for all 256 values.
+constexpr std::array<TriggerMask, 256> trigger_mask_table = []
+{
+    std::array<TriggerMask, 256> table{};
+    for (int v = 0; v < 256; ++v)
+        table[v] = v < kTriggerMaskExactConfig ? TriggerMask{1} << v
+                                               : TriggerMask{1} << kTriggerMaskShared;
+    for (int i = 0; i < n_default_triggers; ++i)
+        table[all_default_triggers[i]] = TriggerMask{1} << (kTriggerMaskDefaults + i);
+    return table;
+}();
+/// @endcond
+
+/**
+ * @brief Mask bit of a trigger value.
+ * @param index  Trigger value (config index or @ref TriggerNumber).
+ */
+constexpr TriggerMask trigger_mask_bit(uint8_t index) { return trigger_mask_table[index]; }
+
+/// @return True if @p index owns its mask bit, i.e. a set bit proves its presence.
+constexpr bool trigger_mask_is_exact(uint8_t index)
+{
+    return trigger_mask_bit(index) != (TriggerMask{1} << kTriggerMaskShared);
+}
+
+/**
+ * @brief OR of the mask bits of every trigger in @p triggers.
+ * @tparam Triggers  Any range of @ref TriggerEvent (vector, span).
+ */
+template <typename Triggers>
+constexpr TriggerMask trigger_mask_of(const Triggers &triggers)
+{
+    TriggerMask mask = 0;
+    for (const auto &t : triggers)
+        mask |= trigger_mask_bit(t.index);
+    return mask;
+}
+
+/**
+ * @brief Whether a frame carries trigger @p index.
+ *
+ * One AND for every exactly-mapped value; only a set shared bit falls back
+ * to scanning @p triggers.
+ *
+ * @param mask      Sealed mask of the frame.
+ * @param triggers  The frame's trigger list.
+ * @param index     Trigger value to look for.
+ */
+template <typename Triggers>
+constexpr bool frame_has_trigger(TriggerMask mask, const Triggers &triggers, uint8_t index)
+{
+    if (!(mask & trigger_mask_bit(index)))
+        return false;
+    if (trigger_mask_is_exact(index))
+        return true;
+    for (const auto &t : triggers)
+        if (t.index == index)
+            return true;
+    return false;
+}
@@ -103,6 +103,50 @@ struct TriggerRegistry
     /// @return Total number of triggers in the registry (config + defaults).
     int size() const { return static_cast<int>(triggers.size()); }
 
+    /**
+     * @brief Mask bit of a trigger value (see @ref TriggerMask).
+     *
+     * Run-independent: identical to @ref trigger_mask_bit, provided here so
+     * callers holding a registry need not reach for the free function.
+     */
+    TriggerMask mask_of(uint8_t trigger_value) const { return trigger_mask_bit(trigger_value); }
+
+    /**
+     * @brief Mask selecting any of the registry triggers named in @p names.
+     *
+     * Build once outside the frame loop, then gate each frame with
+     * `frame_mask & selection`.  Unknown names contribute no bit.
+     *
+     * @param names  Registry names (config or built-in, e.g. `"TIMING"`).
+     */
+    TriggerMask mask_of(const std::vector<std::string> &names) const
+    {
+        TriggerMask mask = 0;
+        for (const auto &name : names)
+            for (const auto &[value, entry_name] : triggers)
+                if (entry_name == name)
+                {
+                    mask |= trigger_mask_bit(value);
+                    break;
+                }
+        return mask;
+    }
+
+    /**
+     * @brief Names of the registry triggers whose bit is set in @p mask.
+     *
+     * In registry order.  Config indices >= @ref kTriggerMaskExactConfig
+     * share one bit, so all of them are reported when it is set.
+     */
+    std::vector<std::string> names_in(TriggerMask mask) const
+    {
+        std::vector<std::string> names;
+        for (const auto &[value, name] : triggers)
+            if (mask & trigger_mask_bit(value))
+                names.push_back(name);
+        return names;
+    }
+
     /**
      * @brief Labels both axes of a 2D ROOT histogram with trigger names.
      *
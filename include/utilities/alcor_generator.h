@@ -0,0 +1,131 @@
+#pragma once
+
+/**
+ * @file utilities/alcor_generator.h
+ * @brief Synthetic ALCOR raw-data generator (`alcor_generator` CLI).
+ *
+ * Writes a run directory the framer reads like a decoded beam-test run:
+ *
+ *   <output_repository>/<run_name>/rdo-<device>/decoded/alcdaq.fifo_<NN>.root
+ *   <output_repository>/<run_name>/kc705-<trigger_device>/decoded/alcdaq.fifo_<trigger_fifo>.root
+ *
+ * Each file holds one `alcor` tree in the exact @ref AlcorDataStruct layout
+ * (written through @ref AlcorData::write_to_tree) plus the `gRollover`
+ * graph, one point per spill.  Per stream and spill the words are a
+ * start-of-spill marker, the time-ordered hits and an end-of-spill marker;
+ * the rollover counter restarts at every spill, as in the DAQ.
+ *
+ * Hit model, per spill of @ref GeneratorConfig::spill_rollovers rollovers:
+ *
+ *   - dark counts: Poisson in time on every channel at `dcr_hz`;
+ *   - rings: events at `ring.rate_hz` after the first `beam_delay_frames`
+ *     frames (the framer's start-of-spill noise window stays beam-free);
+ *     Poisson(`photon_yield`) photons per event at radius
+ *     N(`radius_mm`, `radius_sigma_mm`) around (`cx_mm`, `cy_mm`), each
+ *     landing on the channel whose pixel contains it (lost in the gaps
+ *     otherwise), and one trigger word on the trigger stream
+ *     `trigger_delay` cc later;
+ *   - optical cross-talk: each primary avalanche (dark count or photon)
+ *     fires one physical neighbour (centres within `ct_radius_mm`) with
+ *     probability `cross_talk_probability`, within a clock cycle;
+ *   - afterpulses: every avalanche is followed on its own channel with
+ *     probability `afterpulse_probability`, exponentially delayed by
+ *     `afterpulse_tau_cc` (one generation: no afterpulses of afterpulses).
+ *
+ * Channel positions come from the mapping configuration; unmapped
+ * channels only see dark counts.  In ToT mode every avalanche is a
+ * leading edge on an even TDC and a trailing edge on the next odd TDC,
+ * N(`tot_mean_cc`, `tot_sigma_cc`) later; in LET mode the channel's
+ * TDCs are used in turn.
+ *
+ * `rollover_lag_probability` makes a stream start a spill one rollover
+ * late — its hits carry rollover − 1 and its `gRollover` point is one
+ * short, which `ParallelStreamingFramer::resolve_rollover_offsets`
+ * corrects against the majority.
+ *
+ * The output is a pure function of the configuration and `seed`: every
+ * spill, and every channel's dark counts within it, draw from their own
+ * generator seeded from `seed`, so e.g. adding a device does not change
+ * the hits of the others.  The distributions are the standard library's,
+ * so bit-identical output is guaranteed for one standard library only.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace btana::utilities
+{
+
+/// Ring source of @ref GeneratorConfig.
+struct GeneratorRing
+{
+    double rate_hz = 5e3;         ///< Ring events per second of beam.
+    float cx_mm = -26.f;          ///< Ring centre x in the detector plane.
+    float cy_mm = -26.f;          ///< Ring centre y in the detector plane.
+    float radius_mm = 70.f;       ///< Mean ring radius.
+    float radius_sigma_mm = 2.f;  ///< Gaussian spread of the photon radius.
+    double photon_yield = 12.;    ///< Mean detected photons per ring (Poisson).
+    double time_sigma_cc = 0.15;  ///< Photon arrival-time jitter around the event time.
+};
+
+/// Everything @ref generate_alcor_run draws from; defaults give a small
+/// but complete run (8 devices × 32 FIFOs, 2 spills of ~51 ms).
+struct GeneratorConfig
+{
+    std::string output_repository;
+    std::string run_name = "synthetic";
+    std::string mapping_config_file = "conf/mapping_conf.toml";
+    uint64_t seed = 1;
+
+    //  Readout layout
+    std::vector<int> devices = {192, 193, 194, 195, 196, 197, 198, 199};
+    int fifos_per_device = 32; ///< FIFOs 0 … n − 1 of every device (≤ 32).
+    int trigger_device = 200;  ///< kc705 board carrying the trigger words; < 0 = none.
+    int trigger_fifo = 32;
+    int trigger_delay = 117; ///< cc between the ring and its trigger word.
+
+    //  Spill structure
+    int n_spills = 2;
+    int spill_rollovers = 500;       ///< Spill length (1 rollover = 32768 cc ≈ 102 µs).
+    int beam_delay_frames = 5000;    ///< Beam-free frames at the start of each spill.
+    int frame_size = 1024;           ///< cc per frame, for beam_delay_frames.
+    double rollover_lag_probability = 0.; ///< Per stream and spill.
+
+    //  Sensor response
+    double dcr_hz = 5e3; ///< Dark-count rate per channel.
+    double afterpulse_probability = 0.05;
+    double afterpulse_tau_cc = 16.;
+    double cross_talk_probability = 0.03;
+    float ct_radius_mm = 3.2f;
+    float pixel_size_mm = 3.f; ///< Sensitive square per channel, centred on its mapped position.
+
+    GeneratorRing ring;
+
+    //  Digitisation
+    bool tot_mode = false;
+    double tot_mean_cc = 16.;
+    double tot_sigma_cc = 3.;
+    int fine_lo = 30; ///< Fine bins are drawn uniformly in [fine_lo, fine_hi].
+    int fine_hi = 130;
+};
+
+/// Totals of one @ref generate_alcor_run call.
+struct GeneratorSummary
+{
+    uint64_t streams = 0;
+    uint64_t words = 0; ///< Tree entries written, spill markers included.
+    uint64_t dark_counts = 0;
+    uint64_t photons = 0; ///< Photons that landed on a channel.
+    uint64_t cross_talk = 0;
+    uint64_t afterpulses = 0;
+    uint64_t rings = 0;
+    uint64_t lagging_spills = 0; ///< (stream, spill) pairs shifted by one rollover.
+};
+
+/// Write the run described by @p cfg; existing files are overwritten.
+/// @return `0` on success, non-zero (with a message on stderr) if the
+///         configuration is invalid or an output file cannot be created.
+int generate_alcor_run(const GeneratorConfig &cfg, GeneratorSummary *summary = nullptr);
+
+} // namespace btana::utilities
@@ -22,10 +22,31 @@
  * Print volume is bounded by `n_entries`; pass `-1` for "all".  Output
  * goes to `std::cout`; nothing is written to disk and the framework
  * library state (calibration table, registries) is left untouched.
+ *
+ * `--stats` (@ref stats_file) instead scans the whole tree and prints
+ * a health summary — per-spill and per-channel hit counts, trigger
+ * census, mask-bit frequencies, ring multiplicities, time ranges.  The
+ * tree is cut into cluster-aligned entry ranges that the
+ * `util::TaskPool` threads read concurrently, each through its own
+ * TFile with only the branches the summary needs enabled.
+ *
+ * `--spill` / `--frame` / `--trigger` (@ref dump_selected) print only
+ * the frames that match, reading just the entries that hold them.  The
+ * lookup goes through a @ref DumpIndex: one row per frame (entry, spill,
+ * frame ID, trigger set) plus each spill's entry range.  The index is
+ * built on first use with the same parallel scan as `--stats`, reading
+ * only the frame ID and trigger branches, and cached next to the file as
+ * `<file>.btidx`; a cache whose recorded size / mtime no longer match the
+ * file is rebuilt.
  */
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace btana::utilities
 {
@@ -70,6 +91,133 @@ int dump_recotrackdata(const std::string &file_path, long n_entries = 5);
 /// (no tree, just TDirectories of TParameter / TNamed / histograms).
 int dump_pulser_calib_qa(const std::string &file_path);
 
+/// One spill in a @ref DumpStats.  recodata / recotrackdata spills are
+/// delimited by the start-of-spill marker entry, lightdata has one per entry.
+struct DumpSpillStats
+{
+    static constexpr uint32_t kNoFrame = UINT32_MAX;
+
+    uint64_t frames = 0;
+    uint64_t hits = 0;
+    uint64_t triggers = 0;
+    uint32_t first_frame = kNoFrame; ///< Lowest frame ID seen
+    uint32_t last_frame = 0;         ///< Highest frame ID seen
+
+    DumpSpillStats &operator+=(const DumpSpillStats &o);
+};
+
+/// Whole-file summary behind `btana-dump --stats`.  Hit counters cover
+/// every hit category (lightdata: timing + tracking + Cherenkov); the
+/// synthetic hits of a recodata start-of-spill marker are not counted.
+struct DumpStats
+{
+    DumpFormat format = DumpFormat::Unknown;
+    uint64_t entries = 0;
+    uint64_t frames = 0;
+    uint64_t hits = 0;
+    /// lightdata only: timing, tracking, Cherenkov.
+    std::array<uint64_t, 3> category_hits{};
+    std::vector<DumpSpillStats> spills;
+    /// GlobalIndex::global_channel_raw() → hits (TDCs merged).
+    std::unordered_map<uint32_t, uint64_t> channel_hits;
+    /// TriggerEvent::index → firings; the secondary ones again separately.
+    std::array<uint64_t, 256> trigger_counts{};
+    std::array<uint64_t, 256> secondary_trigger_counts{};
+    /// Hits with HitMask bit b set.
+    std::array<uint64_t, 32> mask_bits{};
+    /// Frames with 0 / 1 / 2 streaming rings (lightdata: ring scalars;
+    /// recodata: ring-tagged hits) and RANSAC-tagged rings.
+    std::array<uint64_t, 3> ring_multiplicity{};
+    std::array<uint64_t, 3> ransac_ring_multiplicity{};
+    uint64_t ring_tagged_hits = 0;
+    uint32_t frame_min = DumpSpillStats::kNoFrame, frame_max = 0;
+    uint32_t rollover_min = UINT32_MAX, rollover_max = 0;
+    uint64_t bytes_read = 0; ///< From disk, over every reader
+    /// lightdata only: the `lightdata_triggers.root` friend applied to
+    /// every spill, empty if none.
+    std::string trigger_overlay;
+};
+
+/// Scan every entry of @p file_path (format auto-detected) into a
+/// @ref DumpStats on the shared task pool.  @p ok is cleared if the file
+/// cannot be opened or carries no lightdata / recodata / recotrackdata tree.
+DumpStats collect_stats(const std::string &file_path, bool &ok);
+
+/// Print @p stats in the `btana-dump` text layout.
+void print_stats(const DumpStats &stats);
+
+/// `btana-dump --stats`: @ref collect_stats + @ref print_stats, with the
+/// scan time and read bandwidth.
+/// @return `0` on success; `2` if the format is unknown or has no tree.
+int stats_file(const std::string &file_path);
+
+/// One frame of a @ref DumpIndex.
+struct DumpIndexRow
+{
+    int64_t entry = 0;     ///< Tree entry holding the frame
+    uint32_t position = 0; ///< lightdata: index in the spill's frame list; 0 otherwise
+    uint32_t spill = 0;    ///< Index into DumpIndex::spills
+    uint32_t frame_id = DumpSpillStats::kNoFrame;
+    uint64_t triggers = 0; ///< The frame's TriggerMask (fixed layout, `trigger_mask_bit`)
+};
+
+/// Entry range of one spill, and the rows of its frames.
+struct DumpIndexSpill
+{
+    int64_t first_entry = 0, last_entry = 0; ///< [first, last)
+    uint64_t first_row = 0, last_row = 0;    ///< [first, last)
+};
+
+/// Random-access index of a lightdata / recodata / recotrackdata file.
+/// Rows are in entry order; spills are delimited as in @ref DumpStats
+/// (start-of-spill markers carry no row).
+struct DumpIndex
+{
+    /// A trigger behind the shared mask bit, which alone cannot tell
+    /// which of those indices fired.
+    struct SharedTrigger
+    {
+        uint64_t row = 0;  ///< Index into DumpIndex::rows
+        uint8_t index = 0; ///< TriggerEvent::index
+    };
+
+    DumpFormat format = DumpFormat::Unknown;
+    int64_t n_entries = 0;
+    std::vector<DumpIndexSpill> spills;
+    std::vector<DumpIndexRow> rows;
+    std::vector<SharedTrigger> shared_triggers; ///< In row order
+};
+
+/// Scan @p file_path into a @ref DumpIndex on the shared task pool.
+/// @return `std::nullopt` if the file has no indexable tree.
+std::optional<DumpIndex> build_index(const std::string &file_path);
+
+/// `<file_path>.btidx`, the on-disk cache of @ref build_index.
+std::string index_path(const std::string &file_path);
+
+/// The cached index of @p file_path if it is still current, otherwise
+/// a fresh @ref build_index, written back to the cache (best effort).
+std::optional<DumpIndex> load_or_build_index(const std::string &file_path);
+
+/// Frame selection for @ref dump_selected.  Unset criteria match all.
+struct DumpSelection
+{
+    std::optional<uint32_t> spill;
+    std::optional<uint32_t> frame_id;
+    /// Trigger indices; a frame matches if any of them fired in it.
+    std::vector<uint8_t> triggers;
+};
+
+/// Parse a `--trigger` value: a built-in name (`RANSAC_RING_FOUND`) or
+/// a numeric index.  @return `false` if @p text is neither.
+bool parse_trigger(const std::string &text, uint8_t &index);
+
+/// Print the first @p n_frames frames of @p file_path matching @p sel
+/// (`-1` = all), in entry order, seeking straight to their entries.
+/// @return `0` on success; `1` if the file cannot be read; `2` if the
+///         format has no per-frame tree.
+int dump_selected(const std::string &file_path, const DumpSelection &sel, long n_frames = 5);
+
 /// Auto-detect dispatcher.  Wraps the three format-specific functions
 /// above and prints a one-line header identifying which it picked.
 /// @return `0` on success; `2` if format is unknown; format dispatcher's
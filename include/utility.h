@@ -17,6 +17,7 @@
  * | TOML loader with cutoff sentinel  | [utility/toml_utils.h](utility/toml_utils.h)   |
  * | Run database / run-list / readout | [utility/config_reader.h](utility/config_reader.h) |
  * | Circle fitting                    | [utility/circle_fit.h](utility/circle_fit.h)   |
+ * | Cross-talk neighbour-pair search  | [utility/cross_talk_pairs.h](utility/cross_talk_pairs.h) |
  * | Ring signal model & 2-D ring fit  | [utility/ring_model.h](utility/ring_model.h)   |
  * | ROOT open-or-build file helper    | [utility/root_io.h](utility/root_io.h)         |
  * | ROOT canvas-drawing helpers       | [utility/root_draw.h](utility/root_draw.h)     |
@@ -31,6 +32,7 @@
 #include "utility/global_index.h"
 #include "utility/toml_utils.h"
 #include "utility/circle_fit.h"
+#include "utility/cross_talk_pairs.h"
 #include "utility/ring_model.h"
 #include "utility/root_io.h"
 #include "utility/root_draw.h"
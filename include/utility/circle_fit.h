@@ -2,11 +2,26 @@
 
 /**
  * @file utility/circle_fit.h
- * @brief Least-squares circle fit minimising radial residuals.
+ * @brief Closed-form circle fits (Kåsa / Taubin / Pratt) on accumulated
+ *        moment sums, Gauss-Newton geometric refinement with analytic
+ *        errors, and O(n) leave-one-out.
  *
- * Wraps `ROOT::Fit::Fitter` with a chi² that penalises the radial distance
- * of each point from the candidate ring.  Optional `fix_XY` fixes the centre
- * and varies only the radius; `exclude_points` skips specific input indices.
+ * All three algebraic fits are functions of the same ten moment sums
+ * (@ref util::circle_fit::CircleMoments), so a fit is one pass over the
+ * points plus an O(1) solve.  Removing a point is a rank-one downdate of
+ * those sums — @ref util::circle_fit::leave_one_out turns the n refits of a
+ * leave-one-out scan into one accumulation plus n O(1) solves.
+ *
+ * The algebraic solvers follow N. Chernov, "Circular and Linear Regression"
+ * (CRC 2010): Kåsa is the linear least-squares solve (biased toward small
+ * radii on partial arcs), Taubin and Pratt are the gradient-/constraint-
+ * weighted variants (unbiased to leading order) solved by Newton on their
+ * characteristic polynomial.  @ref util::circle_fit::refine_geometric then
+ * minimises the true radial residual Σ(dᵢ − R)² — the quantity the old
+ * Minuit `fit_circle` minimised — and returns the covariance
+ * s²·(JᵀJ)⁻¹ with s² = χ²/(n − n_par).
+ *
+ * @ref fit_circle keeps its historical signature for the macros.
  */
 
 #include <algorithm>
@@ -14,76 +29,423 @@
 #include <cmath>
 #include <limits>
 #include <vector>
-#include <Math/Functor.h>
-#include <Fit/Fitter.h>
 
 /// Result type: { {x0,σx0}, {y0,σy0}, {R,σR} }.
 using CircleFitResults = std::array<std::array<float, 2>, 3>;
 
+namespace util::circle_fit
+{
+
+/// Algebraic circle-fit flavour.
+enum class CircleMethod
+{
+    kasa,
+    taubin,
+    pratt,
+};
+
+/// Closed-form fit output.  `ok == false` for degenerate (collinear /
+/// < 3 points) inputs; the geometry is then unspecified.
+struct AlgebraicCircle
+{
+    bool ok = false;
+    double x0 = 0.0, y0 = 0.0, radius = 0.0;
+};
+
+/// Geometric (radial-residual) fit output with analytic uncertainties.
+struct GeometricCircle
+{
+    bool ok = false;
+    double x0 = 0.0, y0 = 0.0, radius = 0.0;
+    double sigma_x0 = 0.0, sigma_y0 = 0.0, sigma_radius = 0.0;
+    double rms_residual = 0.0; ///< sqrt(Σ(dᵢ − R)² / n)
+    int n_iterations = 0;
+};
+
+/**
+ * @brief Raw moment sums of a point set about a fixed reference.
+ *
+ * Coordinates are shifted by (`ref_x`, `ref_y`) before accumulation — pick
+ * a point near the centroid so the fourth-order sum Σz² stays well
+ * conditioned.  `add` / `remove` are exact inverses, so a leave-one-out
+ * subset is `full` with one `remove`.
+ */
+struct CircleMoments
+{
+    double ref_x = 0.0, ref_y = 0.0;
+    double n = 0.0;
+    double sx = 0.0, sy = 0.0;
+    double sxx = 0.0, sxy = 0.0, syy = 0.0;
+    double sz = 0.0, sxz = 0.0, syz = 0.0, szz = 0.0; ///< z = x² + y²
+
+    CircleMoments() = default;
+    CircleMoments(double rx, double ry) : ref_x(rx), ref_y(ry) {}
+
+    void add(double x, double y) { accumulate(x, y, +1.0); }
+    void remove(double x, double y) { accumulate(x, y, -1.0); }
+
+private:
+    void accumulate(double x, double y, double w)
+    {
+        x -= ref_x;
+        y -= ref_y;
+        const double z = x * x + y * y;
+        n += w;
+        sx += w * x;
+        sy += w * y;
+        sxx += w * x * x;
+        sxy += w * x * y;
+        syy += w * y * y;
+        sz += w * z;
+        sxz += w * x * z;
+        syz += w * y * z;
+        szz += w * z * z;
+    }
+};
+
+/// Accumulate @p points into a moment set referenced at their centroid.
+inline CircleMoments accumulate_moments(const std::vector<std::array<float, 2>> &points)
+{
+    double mx = 0.0, my = 0.0;
+    for (const auto &p : points)
+    {
+        mx += p[0];
+        my += p[1];
+    }
+    if (!points.empty())
+    {
+        mx /= static_cast<double>(points.size());
+        my /= static_cast<double>(points.size());
+    }
+    CircleMoments m(mx, my);
+    for (const auto &p : points)
+        m.add(p[0], p[1]);
+    return m;
+}
+
+/**
+ * @brief Solve the algebraic circle fit from accumulated moments.
+ *
+ * Converts the raw sums into centroid-centred means (Mxx … Mzz in
+ * Chernov's notation) and runs the requested solver.  O(1).
+ */
+inline AlgebraicCircle solve_moments(const CircleMoments &m,
+                                     CircleMethod method = CircleMethod::taubin)
+{
+    AlgebraicCircle out;
+    if (m.n < 2.5)
+        return out;
+    const double inv_n = 1.0 / m.n;
+    const double a = m.sx * inv_n; // centroid, reference frame
+    const double b = m.sy * inv_n;
+    const double c = a * a + b * b;
+    const double exx = m.sxx * inv_n, exy = m.sxy * inv_n, eyy = m.syy * inv_n;
+    const double ez = m.sz * inv_n, exz = m.sxz * inv_n, eyz = m.syz * inv_n;
+    const double ezz = m.szz * inv_n;
+
+    //  Centred moments: X = x − a, Y = y − b, Z = X² + Y².
+    const double Mxx = exx - a * a;
+    const double Myy = eyy - b * b;
+    const double Mxy = exy - a * b;
+    const double Mz = Mxx + Myy;
+    const double Mxz = exz - 2.0 * a * exx - 2.0 * b * exy + c * a - a * Mz;
+    const double Myz = eyz - 2.0 * a * exy - 2.0 * b * eyy + c * b - b * Mz;
+    const double Mzz = ezz + 4.0 * a * a * exx + 4.0 * b * b * eyy + 8.0 * a * b * exy -
+                       4.0 * a * exz - 4.0 * b * eyz + 2.0 * c * ez - 3.0 * c * c;
+    const double Cov_xy = Mxx * Myy - Mxy * Mxy;
+
+    //  Newton root of the characteristic polynomial; x = 0 is Kåsa.
+    double x = 0.0;
+    if (method == CircleMethod::taubin)
+    {
+        const double Var_z = Mzz - Mz * Mz;
+        const double A3 = 4.0 * Mz;
+        const double A2 = -3.0 * Mz * Mz - Mzz;
+        const double A1 = Var_z * Mz + 4.0 * Cov_xy * Mz - Mxz * Mxz - Myz * Myz;
+        const double A0 = Mxz * (Mxz * Myy - Myz * Mxy) + Myz * (Myz * Mxx - Mxz * Mxy) -
+                          Var_z * Cov_xy;
+        double y = A0;
+        for (int iter = 0; iter < 99; ++iter)
+        {
+            const double Dy = A1 + x * (2.0 * A2 + 3.0 * A3 * x);
+            const double xnew = x - y / Dy;
+            if (xnew == x || !std::isfinite(xnew))
+                break;
+            const double ynew = A0 + xnew * (A1 + xnew * (A2 + xnew * A3));
+            if (std::fabs(ynew) >= std::fabs(y))
+                break;
+            x = xnew;
+            y = ynew;
+        }
+    }
+    else if (method == CircleMethod::pratt)
+    {
+        const double Mxz2 = Mxz * Mxz, Myz2 = Myz * Myz;
+        const double A2 = 4.0 * Cov_xy - 3.0 * Mz * Mz - Mzz;
+        const double A1 = Mzz * Mz + 4.0 * Cov_xy * Mz - Mxz2 - Myz2 - Mz * Mz * Mz;
+        const double A0 = Mxz2 * Myy + Myz2 * Mxx - Mzz * Cov_xy - 2.0 * Mxz * Myz * Mxy +
+                          Mz * Mz * Cov_xy;
+        double y = A0;
+        for (int iter = 0; iter < 99; ++iter)
+        {
+            const double Dy = A1 + x * (2.0 * A2 + 16.0 * x * x);
+            const double xnew = x - y / Dy;
+            if (xnew == x || !std::isfinite(xnew))
+                break;
+            const double ynew = A0 + xnew * (A1 + xnew * (A2 + 4.0 * xnew * xnew));
+            if (std::fabs(ynew) >= std::fabs(y))
+                break;
+            x = xnew;
+            y = ynew;
+        }
+    }
+
+    const double det = x * x - x * Mz + Cov_xy;
+    //  Relative guard: (near-)collinear input drives det → 0 (R → ∞).
+    if (!(std::fabs(det) > 1e-12 * Mz * Mz) || !std::isfinite(det))
+        return out;
+    const double xc = (Mxz * (Myy - x) - Myz * Mxy) / det / 2.0;
+    const double yc = (Myz * (Mxx - x) - Mxz * Mxy) / det / 2.0;
+    const double r2 = xc * xc + yc * yc + Mz + (method == CircleMethod::pratt ? 2.0 * x : 0.0);
+    if (!(r2 > 0.0) || !std::isfinite(r2))
+        return out;
+    out.x0 = xc + a + m.ref_x;
+    out.y0 = yc + b + m.ref_y;
+    out.radius = std::sqrt(r2);
+    out.ok = std::isfinite(out.x0) && std::isfinite(out.y0);
+    return out;
+}
+
+/// One-shot algebraic fit of @p points.
+inline AlgebraicCircle fit_algebraic(const std::vector<std::array<float, 2>> &points,
+                                     CircleMethod method = CircleMethod::taubin)
+{
+    return solve_moments(accumulate_moments(points), method);
+}
+
+/**
+ * @brief Leave-one-out algebraic fits, O(n) total.
+ *
+ * Entry i is the fit of @p points without point i, obtained by one
+ * rank-one downdate of the full moment sums — numerically identical (to
+ * rounding) to refitting the n − 1 points from scratch.
+ */
+inline std::vector<AlgebraicCircle> leave_one_out(const std::vector<std::array<float, 2>> &points,
+                                                  CircleMethod method = CircleMethod::taubin)
+{
+    std::vector<AlgebraicCircle> out(points.size());
+    const CircleMoments full = accumulate_moments(points);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        CircleMoments loo = full;
+        loo.remove(points[i][0], points[i][1]);
+        out[i] = solve_moments(loo, method);
+    }
+    return out;
+}
+
+/**
+ * @brief Gauss-Newton minimisation of Σ(dᵢ − R)² from a seed.
+ *
+ * @param points     Input points {x, y}.
+ * @param seed       Starting circle (typically an algebraic fit).
+ * @param fix_center Keep (x0, y0) at the seed and solve R only — closed
+ *                   form: R = mean dᵢ.
+ * @param include    Optional per-point mask (non-zero = use); empty = all.
+ *
+ * Uncertainties are s²·(JᵀJ)⁻¹ at the minimum, s² = χ²/(n − n_par), so
+ * they scale with the observed residual spread rather than assuming unit
+ * point errors.
+ */
+inline GeometricCircle refine_geometric(const std::vector<std::array<float, 2>> &points,
+                                        const AlgebraicCircle &seed,
+                                        bool fix_center = false,
+                                        const std::vector<char> &include = {},
+                                        int max_iterations = 20)
+{
+    GeometricCircle out;
+    out.x0 = seed.x0;
+    out.y0 = seed.y0;
+    out.radius = seed.radius;
+    const auto used = [&](std::size_t i)
+    { return include.empty() || include[i]; };
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < points.size(); ++i)
+        n += used(i) ? 1 : 0;
+    const int n_par = fix_center ? 1 : 3;
+    if (static_cast<int>(n) < n_par || !std::isfinite(seed.x0) || !std::isfinite(seed.y0))
+        return out;
+
+    //  χ² and the normal-equation pieces at the current parameters.
+    double chi2 = 0.0;
+    double JtJ[3][3];
+    double Jtr[3];
+    const auto linearise = [&]()
+    {
+        chi2 = 0.0;
+        for (auto &row : JtJ)
+            row[0] = row[1] = row[2] = 0.0;
+        Jtr[0] = Jtr[1] = Jtr[2] = 0.0;
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            if (!used(i))
+                continue;
+            const double dx = points[i][0] - out.x0;
+            const double dy = points[i][1] - out.y0;
+            const double d = std::hypot(dx, dy);
+            const double r = d - out.radius;
+            chi2 += r * r;
+            //  ∂r/∂(x0, y0, R); a point on the centre has no direction.
+            const double J[3] = {d > 0.0 ? -dx / d : 0.0, d > 0.0 ? -dy / d : 0.0, -1.0};
+            for (int p = 0; p < 3; ++p)
+            {
+                Jtr[p] += J[p] * r;
+                for (int q = 0; q < 3; ++q)
+                    JtJ[p][q] += J[p] * J[q];
+            }
+        }
+    };
+
+    if (fix_center)
+    {
+        double dsum = 0.0;
+        for (std::size_t i = 0; i < points.size(); ++i)
+            if (used(i))
+                dsum += std::hypot(points[i][0] - out.x0, points[i][1] - out.y0);
+        out.radius = dsum / static_cast<double>(n);
+        linearise();
+        out.n_iterations = 0;
+        const double s2 = n > 1 ? chi2 / static_cast<double>(n - 1) : 0.0;
+        out.sigma_radius = std::sqrt(s2 / static_cast<double>(n));
+        out.rms_residual = std::sqrt(chi2 / static_cast<double>(n));
+        out.ok = true;
+        return out;
+    }
+
+    //  3×3 inverse by cofactors; false when (near-)singular.
+    double inv[3][3];
+    const auto invert = [&]()
+    {
+        const double(&A)[3][3] = JtJ;
+        inv[0][0] = A[1][1] * A[2][2] - A[1][2] * A[2][1];
+        inv[0][1] = A[0][2] * A[2][1] - A[0][1] * A[2][2];
+        inv[0][2] = A[0][1] * A[1][2] - A[0][2] * A[1][1];
+        inv[1][0] = A[1][2] * A[2][0] - A[1][0] * A[2][2];
+        inv[1][1] = A[0][0] * A[2][2] - A[0][2] * A[2][0];
+        inv[1][2] = A[0][2] * A[1][0] - A[0][0] * A[1][2];
+        inv[2][0] = A[1][0] * A[2][1] - A[1][1] * A[2][0];
+        inv[2][1] = A[0][1] * A[2][0] - A[0][0] * A[2][1];
+        inv[2][2] = A[0][0] * A[1][1] - A[0][1] * A[1][0];
+        const double det = A[0][0] * inv[0][0] + A[0][1] * inv[1][0] + A[0][2] * inv[2][0];
+        if (!(std::fabs(det) > 1e-12 * (A[0][0] * A[1][1] * A[2][2] + 1e-300)))
+            return false;
+        for (auto &row : inv)
+            for (auto &v : row)
+                v /= det;
+        return true;
+    };
+
+    linearise();
+    for (int iter = 0; iter < max_iterations; ++iter)
+    {
+        if (!invert())
+            return out;
+        double step[3];
+        for (int p = 0; p < 3; ++p)
+            step[p] = -(inv[p][0] * Jtr[0] + inv[p][1] * Jtr[1] + inv[p][2] * Jtr[2]);
+        const double prev_chi2 = chi2;
+        const double x0 = out.x0, y0 = out.y0, R = out.radius;
+        out.x0 += step[0];
+        out.y0 += step[1];
+        out.radius += step[2];
+        linearise();
+        out.n_iterations = iter + 1;
+        if (!std::isfinite(chi2) || chi2 > prev_chi2)
+        {
+            //  Overshoot — keep the previous point (GN is already at its
+            //  basin floor to rounding when this happens from a Taubin seed).
+            out.x0 = x0;
+            out.y0 = y0;
+            out.radius = R;
+            linearise();
+            break;
+        }
+        const double scale = std::max(1.0, std::fabs(out.radius));
+        if (std::fabs(step[0]) + std::fabs(step[1]) + std::fabs(step[2]) < 1e-9 * scale)
+            break;
+    }
+    if (!invert() || !(out.radius > 0.0))
+        return out;
+    const double s2 = n > 3 ? chi2 / static_cast<double>(n - 3) : 0.0;
+    out.sigma_x0 = std::sqrt(std::max(0.0, s2 * inv[0][0]));
+    out.sigma_y0 = std::sqrt(std::max(0.0, s2 * inv[1][1]));
+    out.sigma_radius = std::sqrt(std::max(0.0, s2 * inv[2][2]));
+    out.rms_residual = std::sqrt(chi2 / static_cast<double>(n));
+    out.ok = true;
+    return out;
+}
+
+} // namespace util::circle_fit
+
 /**
  * @brief Fit a circle to a set of 2-D points.
  *
- * Minimises the sum of squared radial residuals using ROOT's @c Fitter.
+ * Minimises the sum of squared radial residuals.  With `fix_XY` the centre
+ * stays at @p initial_values and R is the closed-form mean distance; with a
+ * free centre the Taubin algebraic fit seeds a Gauss-Newton refinement
+ * (@p initial_values is the fallback seed when the points are degenerate).
  *
  * @param points           Input points {x, y} [mm].
  * @param initial_values   Initial guess {x0, y0, R}.
  * @param fix_XY           If @c true, fix the centre and fit only R (default: true).
  * @param exclude_points   Indices of points to exclude from the fit (default: empty).
- * @return                 Fit result with central values and uncertainties.
+ * @return                 Fit result with central values and uncertainties;
+ *                         every entry is NaN when the fit fails (test e.g.
+ *                         `std::isnan(result[2][0])`).
  *
- * @note Error handling, default initial values, and uncertainty propagation
- *       in this routine are pending a focused review — track via the
- *       `fit_circle` GitHub issue (label: `design`) before relying on this
- *       function for new physics analyses.
+ * @note Uncertainties are residual-scaled (s²·(JᵀJ)⁻¹, see
+ *       @ref util::circle_fit::refine_geometric); the former Minuit errors
+ *       assumed unit point errors.  For many leave-one-out refits prefer
+ *       @ref util::circle_fit::leave_one_out over looping this function.
  */
-inline CircleFitResults fit_circle(std::vector<std::array<float, 2>> points,
+inline CircleFitResults fit_circle(const std::vector<std::array<float, 2>> &points,
                                    std::array<float, 3> initial_values,
                                    bool fix_XY = true,
-                                   std::vector<int> exclude_points = {})
+                                   const std::vector<int> &exclude_points = {})
 {
-    // Value-initialised so the result is zeroed even if we hit the
-    // failure path below — the caller can also test result[2][0] for
-    // NaN to distinguish "fit failed" from "fit succeeded with R = 0".
+    namespace cf = util::circle_fit;
     CircleFitResults result{};
 
-    //  Chi2 minimisation for points in a circle
-    auto chi2_function = [&](const double *parameters)
+    std::vector<char> include;
+    if (!exclude_points.empty())
     {
-        double chi2 = 0;
-        for (size_t iPnt = 0; iPnt < points.size(); ++iPnt)
-        {
-            if (std::find(exclude_points.begin(), exclude_points.end(), iPnt) != exclude_points.end())
-                continue;
-            double delta_x = points[iPnt][0] - parameters[0];
-            double delta_y = points[iPnt][1] - parameters[1];
-            double delta_r = parameters[2] - std::sqrt(delta_x * delta_x + delta_y * delta_y);
-            chi2 += delta_r * delta_r;
-        }
-        return chi2;
-    };
+        include.assign(points.size(), 1);
+        for (const int i : exclude_points)
+            if (i >= 0 && static_cast<std::size_t>(i) < points.size())
+                include[i] = 0;
+    }
 
-    // wrap chi2 function in a function object for the fit
-    ROOT::Math::Functor fit_function(chi2_function, 3);
-    ROOT::Fit::Fitter fitter;
-
-    //  Set initial values and variables names
-    double internal_initial_values[3] = {initial_values[0], initial_values[1], initial_values[2]};
-    fitter.SetFCN(fit_function, internal_initial_values);
-    fitter.Config().ParSettings(0).SetName("x0");
-    fitter.Config().ParSettings(1).SetName("y0");
-    fitter.Config().ParSettings(2).SetName("R");
-    fitter.Config().ParSettings(2).SetLowerLimit(0);
-    if (fix_XY)
+    cf::AlgebraicCircle seed{true, initial_values[0], initial_values[1], initial_values[2]};
+    if (!fix_XY)
     {
-        fitter.Config().ParSettings(0).Fix();
-        fitter.Config().ParSettings(1).Fix();
+        cf::CircleMoments m;
+        if (include.empty())
+            m = cf::accumulate_moments(points);
+        else
+        {
+            m = cf::CircleMoments(initial_values[0], initial_values[1]);
+            for (std::size_t i = 0; i < points.size(); ++i)
+                if (include[i])
+                    m.add(points[i][0], points[i][1]);
+        }
+        const auto algebraic = cf::solve_moments(m, cf::CircleMethod::taubin);
+        if (algebraic.ok)
+            seed = algebraic;
     }
 
-    //  Fitting
-    if (!fitter.FitFCN())
+    const auto fit = cf::refine_geometric(points, seed, fix_XY, include);
+    if (!fit.ok)
     {
-        // Fit failed — return a NaN-tagged sentinel so the caller cannot
-        // silently propagate garbage values.  Test e.g. std::isnan(result[2][0]).
         const float nan = std::numeric_limits<float>::quiet_NaN();
         for (auto &row : result)
         {
@@ -92,20 +454,8 @@ inline CircleFitResults fit_circle(std::vector<std::array<float, 2>> points,
         }
         return result;
     }
-    const ROOT::Fit::FitResult &fit_result = fitter.Result();
-
-    auto iTer = -1;
-    for (auto current_parameter : fit_result.Parameters())
-    {
-        iTer++;
-        result[iTer][0] = current_parameter;
-        result[iTer][1] = fit_result.Errors()[iTer];
-    }
-
-    //  Calculate chi2
-    double test[3] = {result[0][0], result[1][0], result[2][0]};
-    auto myChi2 = chi2_function(test);
-    (void)myChi2;
-
+    result[0] = {static_cast<float>(fit.x0), static_cast<float>(fit.sigma_x0)};
+    result[1] = {static_cast<float>(fit.y0), static_cast<float>(fit.sigma_y0)};
+    result[2] = {static_cast<float>(fit.radius), static_cast<float>(fit.sigma_radius)};
     return result;
 }
@@ -506,6 +506,54 @@ struct CalibConfigStruct
     /// slip detection to be reliable.  Default 0.30 (30%).
     double slip_max_snap_fraction = 0.30;
 
+    /// @brief Streaming accumulation.  When @c true, each channel's pair
+    /// contributions to the normal equations (and the pair diagnostic
+    /// histograms) are accumulated as the FIFOs are read instead of
+    /// buffering every hit per (channel, spill) until the fit, so memory
+    /// no longer grows with the run length.  The anchor FIFO is read
+    /// first so the pulser period is known before any channel hit.
+    /// The slip correction then works on a rolling window of
+    /// @ref slip_window_hits hits per channel instead of the whole
+    /// (spill, TDC).  The channel-anchor Δ diagnostic (anchor_fifo < 0)
+    /// needs the full hit lists and is skipped.  Default @c false.
+    bool streaming_accumulation = false;
+
+    /// @brief Rolling-window length (hits per channel, all TDCs) of the
+    /// streaming slip correction.  A hit's phase is compared with the
+    /// median of its TDC's hits in the window — about a quarter of the
+    /// window with round-robin TDCs.  Only used with
+    /// @ref streaming_accumulation.  @c 0 disables slip correction in
+    /// that mode.  Default 64.
+    int slip_window_hits = 64;
+
+    /// @brief Incremental calibration.  When @c true, the previous
+    /// published calibration (@ref incremental_from) is loaded as a
+    /// per-channel prior.  A channel is refitted only when the prior's
+    /// χ² on a subsample of the new pairs (@ref incremental_check_pairs)
+    /// exceeds @ref incremental_chi2_ratio × its published σ², or when
+    /// it has a TDC above threshold that the prior lacks; otherwise its
+    /// prior entries are carried over.  Channels absent from the new
+    /// data are carried over too, so the output is a merged calibration
+    /// with per-entry provenance.  The FIFOs are still read in full; only
+    /// the fits of the kept channels are saved.  Default @c false.
+    bool incremental = false;
+
+    /// @brief Prior calibration for @ref incremental.  Empty (default)
+    /// = this run's own existing calibration file (the resolved default
+    /// path), which is then overwritten with the merged result.
+    std::string incremental_from;
+
+    /// @brief Pairs per channel in the incremental χ² check, sampled
+    /// evenly over the run.  Default 512.
+    int incremental_check_pairs = 512;
+
+    /// @brief Refit threshold of the incremental check: subsample
+    /// χ²/pair over the prior's published σ² (σ floored at 0.05 cc).
+    /// Default 1.5 — χ²/pair over 512 pairs scatters by ~6 %, so this
+    /// leaves a wide margin against false refits while catching a
+    /// ~0.1 cc TDC offset shift.
+    double incremental_chi2_ratio = 1.5;
+
     //  Regime-1 (whole-TDC permanent slip) knobs intentionally
     //  REMOVED.  Permanent slip is naturally absorbed by
     //  the fit's per-TDC intercept b — publishing the fitted b
@@ -956,6 +1004,13 @@ struct RecodataConfigStruct
     /// with the hit-assignment cut.
     float delta_r_for_coverage_mm = 3.f;
 
+    /// @brief Quantum [mm] of the per-ring coverage memo
+    /// (`util::radiator_efficiency::CoverageCache`): rings whose
+    /// `(cx, cy, R)` round to the same cell share one coverage value,
+    /// evaluated at the cell point.  Keep well below the per-ring centre
+    /// resolution.  0 = exact per-ring evaluation (no memo).
+    float coverage_cache_quantum_mm = 0.f;
+
     /// @brief Minimum hits per ring for the re-fit to be attempted.
     /// Below this we skip the ring (and emit no N_photons / radial
     /// fill).  Matches the upstream `min_hits` floor in the RANSAC
@@ -1020,11 +1075,24 @@ struct RecodataConfigStruct
     /// `index_to_hit_xy`.  Cross-check against detector geometry.
     float min_channel_r_for_coverage_mm = 0.f;
 
+    /// @brief Directory of the on-disk coverage-map cache
+    /// (`util::radiator_efficiency::CoverageMapStore`).  Empty =
+    /// `<data_repository>/.coverage_cache`; `"off"` disables it.
+    std::string coverage_map_cache_dir;
+
+    /// @brief Size cap [MB] of the coverage-map cache directory; least
+    /// recently used entries are evicted beyond it.  0 = no cap.
+    int coverage_map_cache_max_mb = 256;
+
+    /// @brief Entries of the coverage-map cache unused for this many
+    /// days are evicted.  0 = no age limit.
+    int coverage_map_cache_max_age_days = 90;
+
     // ── Fast-feedback QA tuning ─────────────────────────────────────
     /// @brief Skip the leave-one-out residual loop in
-    /// `compute_ring_fit_pure` when @c true.  Saves ~N extra
-    /// `fit_circle` calls per ring per event — the biggest single
-    /// speedup lever for QA mode.
+    /// `compute_ring_fit_pure` when @c true.  The loop is O(N) per ring
+    /// (moment downdates, `util::circle_fit::leave_one_out`), so the
+    /// saving is now modest; the knob mainly trims the per-hit hist fills.
     ///
     /// **Consequence:** the per-hit `h_residual_vs_n_*` TH2Fs stay
     /// empty, so the σ_photon LOO fit (`fit_sigma_vs_n`) skips
@@ -1055,7 +1123,8 @@ struct RecodataConfigStruct
  *  - The 8 coverage-map geometry keys (`n_phi_bins_coverage`,
  *    `n_r_bins_coverage`, `r_min_coverage_mm`, `r_max_coverage_mm`,
  *    `channel_half_width_mm`, `nominal_centre_x_mm`,
- *    `nominal_centre_y_mm`, `min_channel_r_for_coverage_mm`) are read
+ *    `nominal_centre_y_mm`, `min_channel_r_for_coverage_mm`) and the
+ *    `map_cache_dir` of the coverage-map cache are read
  *    from a @c [coverage] table in @p mapping_file — they're detector
  *    geometry, same domain as the rest of `mapping_conf.toml`.
  *
@@ -0,0 +1,283 @@
+#pragma once
+
+/**
+ * @file include/utility/cross_talk_pairs.h
+ * @brief Cross-talk pair search over one frame's hits: neighbour channels
+ *        from a precomputed adjacency table, Δt windows on time-sorted hits.
+ *
+ * The cross-talk measurements (lightdata CT QA, `cross_talk_treatment.cpp`,
+ * the `cross_talk` train task) look, for every primary hit, for hits on
+ * neighbouring channels within a Δt window.  Testing every hit pair is
+ * O(N²) per frame, and the macro's window (−5 cc … one full frame, for the
+ * DCR sideband) leaves the time cut nothing to prune.
+ *
+ * @ref PairFinder instead sorts the frame's hits once — by time, and by
+ * (channel, time) — and:
+ *
+ *   - @ref PairFinder::for_each_neighbour walks the primary's entries in
+ *     the @ref ChannelAdjacency table and binary-searches each neighbour
+ *     channel's time-ordered hits for the window: O(k · log n) per primary
+ *     for k neighbour channels, independent of the frame occupancy;
+ *   - @ref PairFinder::for_each_in_window slides a Δt window over the
+ *     time-sorted hits regardless of channel (the `(Δchannel, Δt)`
+ *     diagnostics): O(log N + hits in window).
+ *
+ * Neighbour relations (see @ref Relation):
+ *
+ *   - physical — both channels mapped (x > −990 mm) and their centres
+ *     within the physical-CT radius (`[qa] ct_phys_radius_mm`);
+ *   - electrical — same device and FIFO (shared readout chain);
+ *   - the channel itself is listed too, flagged @ref RelationSameChannel
+ *     plus whichever of the two above apply (the macro counts a second hit
+ *     on the primary's channel, the lightdata QA skips it).
+ *
+ * Causality (physical CT needs Δt ≥ 0) and the signal / sideband windows
+ * stay with the callers.
+ *
+ * The adjacency table is filled on first sight of each channel (O(channels
+ * known) once per channel) and kept across frames, so keep one
+ * @ref PairFinder per reader thread for the whole run.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace util::cross_talk
+{
+
+/// Neighbour-relation bits of a (channel, channel) pair.
+enum Relation : uint8_t
+{
+    RelationPhysical = 1u << 0,    ///< Both mapped, centres within the physical radius.
+    RelationElectrical = 1u << 1,  ///< Same device and FIFO.
+    RelationSameChannel = 1u << 2, ///< The channel itself.
+};
+
+/// Identity and position of one readout channel.
+struct Channel
+{
+    uint32_t ordinal; ///< Dense channel ordinal (`GlobalIndex::channel_ordinal`).
+    int device;
+    int fifo;
+    float x; ///< [mm]; ≤ −990 if unmapped.
+    float y; ///< [mm]
+};
+
+/**
+ * @brief Channel → neighbour channels with their @ref Relation bits.
+ *
+ * Symmetric: registering a channel appends it to the lists of every known
+ * channel it neighbours.
+ */
+class ChannelAdjacency
+{
+public:
+    struct Neighbour
+    {
+        uint32_t ordinal;
+        uint8_t relation; ///< @ref Relation bits
+    };
+
+    explicit ChannelAdjacency(float phys_radius_mm) : phys_radius_mm(phys_radius_mm) {}
+
+    /// Register @p channel; no-op if its ordinal is already known.
+    void add(const Channel &channel);
+
+    bool contains(uint32_t ordinal) const { return ordinal < slot.size() && slot[ordinal] >= 0; }
+    std::size_t size() const { return lists.size(); }
+
+    /// Neighbours of a registered channel, itself included.
+    const std::vector<Neighbour> &neighbours(uint32_t ordinal) const { return lists[slot[ordinal]]; }
+
+    /// @return The @ref Relation bits of (@p a, @p b); 0 if not neighbours or unknown.
+    uint8_t relation(uint32_t a, uint32_t b) const;
+
+private:
+    float phys_radius_mm;
+    std::vector<int32_t> slot; ///< ordinal → index into channels / lists, −1 if unknown
+    std::vector<Channel> channels;
+    std::vector<std::vector<Neighbour>> lists;
+};
+
+/**
+ * @brief Per-frame pair search: @ref clear, @ref add every hit, @ref prepare,
+ *        then query per primary hit.
+ *
+ * Hits are identified by their insertion index.  Visitors are called as
+ * `visit(j, dt)` / `visit(j, dt, relation)` with `dt = t_j − t_i` in the
+ * caller's time unit, for every `j ≠ i` with `dt_lo ≤ dt < dt_hi`; visit
+ * order is unspecified.
+ */
+class PairFinder
+{
+public:
+    explicit PairFinder(float phys_radius_mm) : table(phys_radius_mm) {}
+
+    /// Start a new frame; the adjacency table and buffer capacity are kept.
+    void clear() { hits.clear(); }
+
+    /// Append a hit at time @p t on @p channel.
+    void add(double t, const Channel &channel)
+    {
+        if (!table.contains(channel.ordinal))
+            table.add(channel);
+        hits.push_back({t, channel.ordinal});
+    }
+
+    /// Sort the frame's hits; call once after the last @ref add.
+    void prepare();
+
+    std::size_t size() const { return hits.size(); }
+    double time(std::size_t i) const { return hits[i].t; }
+    uint32_t channel(std::size_t i) const { return hits[i].ordinal; }
+    const ChannelAdjacency &adjacency() const { return table; }
+
+    /// Every hit in the Δt window of hit @p i, on any channel.
+    template <typename Visitor>
+    void for_each_in_window(std::size_t i, double dt_lo, double dt_hi, Visitor &&visit) const
+    {
+        const double t_i = hits[i].t;
+        auto it = std::lower_bound(by_time.begin(), by_time.end(), dt_lo,
+                                   [this, t_i](uint32_t k, double dt)
+                                   { return hits[k].t - t_i < dt; });
+        for (; it != by_time.end(); ++it)
+        {
+            const double dt = hits[*it].t - t_i;
+            if (dt >= dt_hi)
+                break;
+            if (*it != i)
+                visit(static_cast<std::size_t>(*it), dt);
+        }
+    }
+
+    /// Every hit in the Δt window of hit @p i on a neighbouring channel (its own included).
+    template <typename Visitor>
+    void for_each_neighbour(std::size_t i, double dt_lo, double dt_hi, Visitor &&visit) const
+    {
+        const double t_i = hits[i].t;
+        for (const auto &neighbour : table.neighbours(hits[i].ordinal))
+        {
+            if (neighbour.ordinal >= stamp.size() || stamp[neighbour.ordinal] != frame_stamp)
+                continue;
+            const auto first = by_channel.begin() + range_begin[neighbour.ordinal];
+            const auto last = by_channel.begin() + range_end[neighbour.ordinal];
+            auto it = std::lower_bound(first, last, dt_lo,
+                                       [this, t_i](uint32_t k, double dt)
+                                       { return hits[k].t - t_i < dt; });
+            for (; it != last; ++it)
+            {
+                const double dt = hits[*it].t - t_i;
+                if (dt >= dt_hi)
+                    break;
+                if (*it != i)
+                    visit(static_cast<std::size_t>(*it), dt, neighbour.relation);
+            }
+        }
+    }
+
+private:
+    struct Hit
+    {
+        double t;
+        uint32_t ordinal;
+    };
+
+    ChannelAdjacency table;
+    std::vector<Hit> hits;
+    std::vector<uint32_t> by_time;    ///< hit indices in time order
+    std::vector<uint32_t> by_channel; ///< hit indices in (channel, time) order
+    //  Per ordinal: [begin, end) of its hits in by_channel, valid while
+    //  stamp[ordinal] == frame_stamp (no per-frame reset of the tables).
+    std::vector<uint32_t> range_begin, range_end, stamp;
+    uint32_t frame_stamp = 0;
+};
+
+inline void ChannelAdjacency::add(const Channel &channel)
+{
+    if (contains(channel.ordinal))
+        return;
+    if (channel.ordinal >= slot.size())
+        slot.resize(channel.ordinal + 1, -1);
+
+    const bool mapped = channel.x > -990.f;
+    std::vector<Neighbour> own;
+    own.push_back({channel.ordinal, static_cast<uint8_t>(RelationSameChannel | RelationElectrical |
+                                                         (mapped ? RelationPhysical : 0))});
+    for (std::size_t k = 0; k < channels.size(); ++k)
+    {
+        const Channel &other = channels[k];
+        uint8_t relation = 0;
+        if (other.device == channel.device && other.fifo == channel.fifo)
+            relation |= RelationElectrical;
+        if (mapped && other.x > -990.f &&
+            std::hypot(other.x - channel.x, other.y - channel.y) <= phys_radius_mm)
+            relation |= RelationPhysical;
+        if (relation == 0)
+            continue;
+        own.push_back({other.ordinal, relation});
+        lists[k].push_back({channel.ordinal, relation});
+    }
+
+    slot[channel.ordinal] = static_cast<int32_t>(channels.size());
+    channels.push_back(channel);
+    lists.push_back(std::move(own));
+}
+
+inline uint8_t ChannelAdjacency::relation(uint32_t a, uint32_t b) const
+{
+    if (!contains(a))
+        return 0;
+    for (const auto &neighbour : neighbours(a))
+        if (neighbour.ordinal == b)
+            return neighbour.relation;
+    return 0;
+}
+
+inline void PairFinder::prepare()
+{
+    const uint32_t n = static_cast<uint32_t>(hits.size());
+
+    //  Ties broken on the index so the visit order is reproducible.
+    by_time.resize(n);
+    std::iota(by_time.begin(), by_time.end(), 0u);
+    std::sort(by_time.begin(), by_time.end(), [this](uint32_t a, uint32_t b)
+              { return hits[a].t != hits[b].t ? hits[a].t < hits[b].t : a < b; });
+
+    by_channel.resize(n);
+    std::iota(by_channel.begin(), by_channel.end(), 0u);
+    std::sort(by_channel.begin(), by_channel.end(), [this](uint32_t a, uint32_t b)
+              {
+                  if (hits[a].ordinal != hits[b].ordinal)
+                      return hits[a].ordinal < hits[b].ordinal;
+                  return hits[a].t != hits[b].t ? hits[a].t < hits[b].t : a < b; });
+
+    //  New stamp invalidates every range of the previous frame; on wrap-around
+    //  the stale stamps are cleared once.
+    if (++frame_stamp == 0)
+    {
+        std::fill(stamp.begin(), stamp.end(), 0u);
+        frame_stamp = 1;
+    }
+    for (uint32_t k = 0; k < n; ++k)
+    {
+        const uint32_t ordinal = hits[by_channel[k]].ordinal;
+        if (ordinal >= stamp.size())
+        {
+            stamp.resize(ordinal + 1, 0u);
+            range_begin.resize(ordinal + 1);
+            range_end.resize(ordinal + 1);
+        }
+        if (stamp[ordinal] != frame_stamp)
+        {
+            stamp[ordinal] = frame_stamp;
+            range_begin[ordinal] = k;
+        }
+        range_end[ordinal] = k + 1;
+    }
+}
+
+} // namespace util::cross_talk
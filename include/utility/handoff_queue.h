@@ -0,0 +1,183 @@
+#pragma once
+
+/**
+ * @file handoff_queue.h
+ * @brief Bounded producer → consumer queue and a background consumer
+ *        thread built on it.
+ *
+ * Used by the end-to-end writer cascade (`writers/cascade.h`) to hand
+ * spills / frames from one stage to the next without a ROOT round trip,
+ * and by the writers to run their `TTree::Fill` on a dedicated archiving
+ * thread while the main thread computes the next spill.
+ *
+ * Both are header-only templates; neither touches ROOT.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace util
+{
+
+/**
+ * @brief Bounded blocking FIFO with an end-of-stream flag.
+ *
+ * @ref push blocks while @p capacity items are queued, @ref pop while the
+ * queue is empty.  @ref close ends the stream from either side: the
+ * consumer drains what is left, the producer's later pushes are dropped
+ * (return false) instead of blocking — so a consumer that stops early
+ * never deadlocks its producer.
+ */
+template <class T>
+class HandoffQueue
+{
+public:
+    explicit HandoffQueue(std::size_t capacity = 1)
+        : capacity_(capacity > 0 ? capacity : 1) {}
+
+    HandoffQueue(const HandoffQueue &) = delete;
+    HandoffQueue &operator=(const HandoffQueue &) = delete;
+
+    /// Enqueue @p item.  False (item dropped) once the queue is closed.
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]
+                       { return closed_ || items_.size() < capacity_; });
+        if (closed_)
+            return false;
+        items_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /// Dequeue into @p item.  False once the queue is closed and drained.
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]
+                        { return closed_ || !items_.empty(); });
+        if (items_.empty())
+            return false;
+        item = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /// End the stream.  Idempotent; wakes every blocked push / pop.
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    bool closed() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+private:
+    const std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+/**
+ * @brief One dedicated thread running @p consume on every pushed item,
+ *        in push order.
+ *
+ * The writers use it as their archiving thread: the main thread moves a
+ * finished spill / frame batch in, the consumer swaps it under the tree's
+ * branch buffers and calls `TTree::Fill`.  The tree must not be touched
+ * by any other thread until @ref finish returns.
+ *
+ * A consumer exception stops the thread and closes the queue (later
+ * pushes are dropped); it is rethrown by @ref finish.
+ */
+template <class T>
+class BackgroundConsumer
+{
+public:
+    using Consume = std::function<void(T &item)>;
+
+    /**
+     * @param consume  Runs on the consumer thread, once per item.
+     * @param depth    Items queued ahead of the consumer before
+     *                 @ref push blocks (≥ 1).
+     */
+    explicit BackgroundConsumer(Consume consume, std::size_t depth = 2)
+        : consume_(std::move(consume)), queue_(depth)
+    {
+        thread_ = std::thread([this]
+                              { run(); });
+    }
+
+    /// Drains and joins; a pending consumer exception is swallowed —
+    /// call @ref finish to see it.
+    ~BackgroundConsumer()
+    {
+        queue_.close();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    BackgroundConsumer(const BackgroundConsumer &) = delete;
+    BackgroundConsumer &operator=(const BackgroundConsumer &) = delete;
+
+    /// Hand @p item to the consumer; blocks while `depth` items are queued.
+    void push(T item) { queue_.push(std::move(item)); }
+
+    /// Consume every pushed item, join the thread, rethrow a consumer error.
+    void finish()
+    {
+        queue_.close();
+        if (thread_.joinable())
+            thread_.join();
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+private:
+    void run()
+    {
+        T item;
+        while (queue_.pop(item))
+        {
+            try
+            {
+                consume_(item);
+            }
+            catch (...)
+            {
+                //  Read by finish() only after join — no lock needed.
+                error_ = std::current_exception();
+                queue_.close();
+                return;
+            }
+        }
+    }
+
+    Consume consume_;
+    HandoffQueue<T> queue_;
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+} // namespace util
@@ -16,7 +16,9 @@
  *      `2π` arc that intersects active channels — `azimuthal_coverage_fraction`.
  *
  * The first two are run-level (geometry-only, computed once at writer
- * init from the same `index_to_hit_xy` map both writers already build).
+ * init from the same `index_to_hit_xy` map both writers already build);
+ * @ref CoverageMapStore caches the per-channel footprints behind the
+ * two maps on disk across runs.
  * The third is per-ring and uses the per-event RANSAC/fit centre so the
  * resulting `N_photons = N_hits / f_coverage` is exact per event.
  *
@@ -35,8 +37,14 @@
  * — that's deferred to a finer-analysis follow-up.
  */
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 class TAxis;
@@ -100,6 +108,11 @@ namespace util::radiator_efficiency
      *                              this parameter: for each channel,
      *                              `weight = Σ over spills active in
      *                              of (n_physics_spill / n_physics_total)`.
+     * @param n_threads             Parallel slots (tasks on the shared
+     *                              `util::TaskPool`) for the per-channel
+     *                              footprint rasterisation.  The bin increments are
+     *                              applied serially in channel order, so
+     *                              the map is bit-identical for any value.
      * @return New `TH2F` (owned by the caller — typically pushed into a
      *         `RootHist` wrapper for output).  Title axes:
      *         `";#phi (rad);R (mm)"`.
@@ -114,7 +127,8 @@ TH2F *build_coverage_map(
     float centre_x = 0.f,
     float centre_y = 0.f,
     float min_channel_r_mm = 0.f,
-    const std::map<int, float> *channel_weights = nullptr);
+    const std::map<int, float> *channel_weights = nullptr,
+    int n_threads = 1);
 
 /**
      * @brief Collapse a `(φ, R)` coverage map to a 1D `eff(R)` curve.
@@ -151,6 +165,7 @@ TH1F *radial_efficiency(
  * Σ weight of channels covering that bin — a per-bin coverage/readiness
  * fraction (≈ activity fraction when one channel maps to a bin).  Title
  * axes: `";c_{x} (mm);c_{y} (mm)"`.  Caller owns the returned `TH2F`.
+ * `n_threads` as in @ref build_coverage_map.
  */
 TH2F *build_coverage_map_xy(
     const std::map<int, std::array<float, 2>> &channel_xy,
@@ -161,7 +176,82 @@ TH2F *build_coverage_map_xy(
     float y_min_mm,
     float y_max_mm,
     float channel_half_width_mm = 1.5f,
-    const std::map<int, float> *channel_weights = nullptr);
+    const std::map<int, float> *channel_weights = nullptr,
+    int n_threads = 1);
+
+/**
+ * @brief Content-addressed on-disk cache of the coverage-map footprints.
+ *
+ * Wraps @ref build_coverage_map and @ref build_coverage_map_xy with the
+ * same signatures.  The expensive part of both is the per-channel pixel
+ * rasterisation, which depends only on the geometry; the per-run
+ * activity weights are a cheap serial sum over it.  So the store caches
+ * the footprints of every mapped channel, keyed on a 64-bit FNV-1a hash
+ * of the resolved channel positions (i.e. the mapping_conf geometry),
+ * the binning, pixel half-width and nominal centre — never the weights —
+ * and stored as `<cache_dir>/coverage_<kind>_<hash>.bin`.  Every run of
+ * the same geometry hits the cache; the weights are applied on top in
+ * channel order, so the map is bit-identical to an uncached build.
+ *
+ * Files are written to a temporary name and renamed into place, so
+ * several writers can share one cache directory.  Hits refresh an
+ * entry's modification time; after each store, entries unused for
+ * `max_age_days` are removed, then the least recently used ones until
+ * the directory holds at most `max_bytes` (0 = no limit for either).
+ * Any I/O failure falls back to computing the map; an empty
+ * `cache_dir` disables the cache.
+ */
+class CoverageMapStore
+{
+public:
+    explicit CoverageMapStore(std::string cache_dir, int n_threads = 1,
+                              std::uintmax_t max_bytes = 0, int max_age_days = 0);
+
+    bool enabled() const noexcept { return !cache_dir_.empty(); }
+    const std::string &cache_dir() const noexcept { return cache_dir_; }
+
+    TH2F *build_coverage_map(
+        const std::map<int, std::array<float, 2>> &channel_xy,
+        int n_phi_bins,
+        float r_min_mm,
+        float r_max_mm,
+        int n_r_bins,
+        float channel_half_width_mm = 1.5f,
+        float centre_x = 0.f,
+        float centre_y = 0.f,
+        float min_channel_r_mm = 0.f,
+        const std::map<int, float> *channel_weights = nullptr);
+
+    TH2F *build_coverage_map_xy(
+        const std::map<int, std::array<float, 2>> &channel_xy,
+        int n_x_bins,
+        float x_min_mm,
+        float x_max_mm,
+        int n_y_bins,
+        float y_min_mm,
+        float y_max_mm,
+        float channel_half_width_mm = 1.5f,
+        const std::map<int, float> *channel_weights = nullptr);
+
+    std::size_t n_loaded() const noexcept { return n_loaded_; }
+    std::size_t n_stored() const noexcept { return n_stored_; }
+    std::size_t n_evicted() const noexcept { return n_evicted_; }
+
+private:
+    using Footprints = std::vector<std::vector<int>>;
+
+    std::string path_for(const char *kind, uint64_t key) const;
+    void cached_footprints(const char *kind, uint64_t key, uint64_t n_cells,
+                           std::size_t n_channels, Footprints &bins,
+                           const std::function<Footprints()> &compute);
+    void prune();
+
+    std::string cache_dir_;
+    int n_threads_;
+    std::uintmax_t max_bytes_;
+    int max_age_days_;
+    std::size_t n_loaded_ = 0, n_stored_ = 0, n_evicted_ = 0;
+};
 
 /**
      * @brief Per-ring azimuthal coverage fraction `f ∈ [0, 1]`.
@@ -177,8 +267,9 @@ TH2F *build_coverage_map_xy(
      * Implementation: iterates the channel map, accumulates the
      * azimuthal segments where each channel covers the arc, merges
      * overlapping segments, returns `total_covered_phi / (2π)`.  Cost
-     * `O(N_channels × log N_channels)` per ring per event; negligible
-     * at typical scales (~1 µs per ring at 2000 channels).
+     * `O(N_channels × log N_channels)` per ring — the per-event path
+     * uses the @ref ChannelGridIndex overload (and @ref CoverageCache)
+     * instead, which only visits channels near the annulus.
      *
      * @param channel_xy  Channel-position map.
      * @param cx          Ring centre X [mm] (per-event, e.g. fit-refined).
@@ -202,4 +293,113 @@ float azimuthal_coverage_fraction(
     float delta_r_mm,
     float channel_half_width_mm = 1.5f);
 
+/**
+ * @brief Uniform-grid spatial index over the channel positions.
+ *
+ * Built once from the same `channel_xy` map; channels are bucketed into
+ * square cells of side `cell_mm` (CSR layout).  A ring query visits only
+ * the cells whose distance range to the ring centre overlaps the annulus
+ * `[R − δ, R + δ]` — O(cells on the ring) instead of O(N_channels), for
+ * any centre (far off-axis arcs included, which a polar index about a
+ * fixed nominal centre would not serve).
+ */
+class ChannelGridIndex
+{
+public:
+    ChannelGridIndex() = default;
+    /// @param cell_mm  Cell side [mm]; ~2 pixel pitches keeps the
+    ///                 per-cell occupancy at a handful of channels.
+    explicit ChannelGridIndex(const std::map<int, std::array<float, 2>> &channel_xy,
+                              float cell_mm = 6.f);
+
+    bool empty() const noexcept { return points_.empty(); }
+    std::size_t size() const noexcept { return points_.size(); }
+
+    /// Call @p f(const std::array<float,2>&) for every channel that may lie
+    /// at a distance in `[r_lo, r_hi]` from `(cx, cy)` (a superset — the
+    /// caller applies the exact cut).
+    template <class F>
+    void for_each_in_annulus(float cx, float cy, float r_lo, float r_hi, F &&f) const
+    {
+        if (points_.empty())
+            return;
+        const float r_lo2 = r_lo > 0.f ? r_lo * r_lo : 0.f;
+        const float r_hi2 = r_hi * r_hi;
+        const int ix_lo = std::max(0, static_cast<int>(std::floor((cx - r_hi - x0_) / cell_mm_)));
+        const int ix_hi = std::min(nx_ - 1, static_cast<int>(std::floor((cx + r_hi - x0_) / cell_mm_)));
+        const int iy_lo = std::max(0, static_cast<int>(std::floor((cy - r_hi - y0_) / cell_mm_)));
+        const int iy_hi = std::min(ny_ - 1, static_cast<int>(std::floor((cy + r_hi - y0_) / cell_mm_)));
+        for (int iy = iy_lo; iy <= iy_hi; ++iy)
+        {
+            const float y_a = y0_ + iy * cell_mm_ - cy, y_b = y_a + cell_mm_;
+            const float dy_min = (y_a > 0.f) ? y_a : (y_b < 0.f ? -y_b : 0.f);
+            const float dy_max = std::max(std::fabs(y_a), std::fabs(y_b));
+            for (int ix = ix_lo; ix <= ix_hi; ++ix)
+            {
+                const float x_a = x0_ + ix * cell_mm_ - cx, x_b = x_a + cell_mm_;
+                const float dx_min = (x_a > 0.f) ? x_a : (x_b < 0.f ? -x_b : 0.f);
+                const float dx_max = std::max(std::fabs(x_a), std::fabs(x_b));
+                //  Cell distance range vs annulus (small slack for rounding).
+                if (dx_min * dx_min + dy_min * dy_min > r_hi2 * 1.0001f + 1e-3f ||
+                    dx_max * dx_max + dy_max * dy_max < r_lo2 * 0.9999f - 1e-3f)
+                    continue;
+                const std::size_t c = static_cast<std::size_t>(iy) * nx_ + ix;
+                for (uint32_t k = cell_begin_[c]; k < cell_begin_[c + 1]; ++k)
+                    f(points_[k]);
+            }
+        }
+    }
+
+private:
+    float cell_mm_ = 6.f;
+    float x0_ = 0.f, y0_ = 0.f;
+    int nx_ = 0, ny_ = 0;
+    std::vector<uint32_t> cell_begin_;
+    std::vector<std::array<float, 2>> points_;
+};
+
+/**
+ * @brief Indexed overload of @ref azimuthal_coverage_fraction — same
+ *        result, visits only the channels near the annulus.
+ */
+float azimuthal_coverage_fraction(
+    const ChannelGridIndex &index,
+    float cx,
+    float cy,
+    float R,
+    float delta_r_mm,
+    float channel_half_width_mm = 1.5f);
+
+/**
+ * @brief Memo of @ref azimuthal_coverage_fraction on a quantised
+ *        `(cx, cy, R)` key.
+ *
+ * Fitted ring centres cluster tightly around the beam spot, so most rings
+ * of a run land in a few hundred cells of a sub-mm grid.  The value is
+ * evaluated AT the quantised point, so it is a pure function of the key —
+ * results do not depend on call order or on which worker owns the cache.
+ * `quantum_mm <= 0` disables memoisation (exact per-ring evaluation).
+ *
+ * Not thread-safe: keep one instance per worker.
+ */
+class CoverageCache
+{
+public:
+    CoverageCache(const ChannelGridIndex &index, float delta_r_mm,
+                  float channel_half_width_mm, float quantum_mm)
+        : index_(index), delta_r_mm_(delta_r_mm),
+          channel_half_width_mm_(channel_half_width_mm), quantum_mm_(quantum_mm) {}
+
+    float operator()(float cx, float cy, float R);
+
+    std::size_t n_hits() const noexcept { return n_hits_; }
+    std::size_t n_misses() const noexcept { return n_misses_; }
+
+private:
+    const ChannelGridIndex &index_;
+    float delta_r_mm_, channel_half_width_mm_, quantum_mm_;
+    std::unordered_map<uint64_t, float> cache_;
+    std::size_t n_hits_ = 0, n_misses_ = 0;
+};
+
 } // namespace util::radiator_efficiency
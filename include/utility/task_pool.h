@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+ * @file task_pool.h
+ * @brief Process-wide work-stealing task pool shared by the writers.
+ *
+ * Every parallel stage of the pipeline (framer stream decode, lightdata
+ * PASS A, recodata frame compute / ring batches / drain shards, coverage
+ * rasterisation) submits into ONE pool instead of spawning its own
+ * `std::async` threads per spill.  The pool size is set once per process
+ * from the writers' `--threads` option (@ref TaskPool::configure), so
+ * overlapping stages share the same workers instead of over-subscribing
+ * the node.
+ *
+ * Scheduling: one deque per worker plus a shared injection queue for
+ * submissions from non-pool threads.  A worker pops its own deque LIFO,
+ * then the injection queue, then steals FIFO from the other workers.
+ *
+ * Completion is tracked per @ref TaskGroup.  `TaskGroup::wait` runs
+ * pending tasks on the calling thread while it waits, so a task may open
+ * its own group and wait on it (nested parallelism) without deadlocking
+ * the pool, and a pool of size 1 (no workers) degenerates to a serial
+ * run on the caller.
+ *
+ * Usage — the "one slot per worker, atomic item counter" shape the call
+ * sites already had:
+ *
+ * @code
+ *   util::TaskGroup group;
+ *   const std::size_t n_slots = std::min(util::TaskPool::instance().concurrency(), n_items);
+ *   for (std::size_t t = 0; t < n_slots; ++t)
+ *       group.run([&, t] { ... per-slot state t, items via next.fetch_add(1) ... });
+ *   group.wait(); // rethrows the first task exception
+ * @endcode
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+
+class TaskGroup;
+
+class TaskPool
+{
+public:
+    /**
+     * @brief Set the process-wide parallelism (calling thread included).
+     *
+     * @param n_threads  Total threads; ≤ 0 = `hardware_concurrency()`.
+     *                   A pool of N runs N−1 workers — the thread that
+     *                   waits on a group is the N-th.
+     *
+     * Call from the executable after option parsing, before any stage
+     * runs.  Resizing a live pool is allowed only while it is idle.
+     */
+    static void configure(int n_threads);
+
+    /// The process-wide pool (created on first use with the default size).
+    static TaskPool &instance();
+
+    /// Threads available to a group: workers + the waiting caller.
+    std::size_t concurrency() const noexcept { return n_workers_ + 1; }
+
+    ~TaskPool();
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+private:
+    friend class TaskGroup;
+
+    struct Task
+    {
+        std::function<void()> fn;
+        TaskGroup *group = nullptr;
+    };
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    explicit TaskPool(std::size_t n_threads);
+
+    void start(std::size_t n_threads);
+    void stop();
+    void submit(Task task);
+    /// Pop and run one task; false when every queue is empty.
+    bool run_one();
+    void worker_loop(std::size_t index);
+    /// Wake one sleeper (new task) or all of them (group completion).
+    void notify(bool all);
+
+    std::size_t n_workers_ = 0;
+    std::vector<std::thread> workers_;
+    /// One deque per worker, then the injection queue (last).
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::atomic<std::size_t> n_queued_{0};
+    bool stopping_ = false;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+};
+
+/**
+ * @brief A set of tasks whose completion is awaited together.
+ *
+ * Not copyable; the group must outlive its tasks, which the destructor
+ * guarantees by waiting (exceptions are swallowed there — call @ref wait
+ * to see them).
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskPool &pool = TaskPool::instance()) : pool_(pool) {}
+    ~TaskGroup();
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    void run(std::function<void()> fn);
+
+    /**
+     * @brief Block until every task of the group has finished, running
+     *        queued tasks meanwhile.  Rethrows the first task exception.
+     */
+    void wait();
+
+private:
+    friend class TaskPool;
+
+    void finish(std::exception_ptr error);
+    void wait_quietly();
+
+    TaskPool &pool_;
+    std::atomic<std::size_t> remaining_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+} // namespace util
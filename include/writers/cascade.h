@@ -0,0 +1,131 @@
+#pragma once
+
+/**
+ * @file cascade.h
+ * @brief In-memory hand-off between the lightdata → recodata →
+ *        recotrackdata writers for the end-to-end mode.
+ *
+ * Without it every stage serialises its full output to ROOT and the next
+ * stage reads it back.  In end-to-end mode (`--end-to-end` on the recodata
+ * / recotrackdata executables) the stages hand their output over in
+ * memory; each stage still writes its ROOT file, from its archiving
+ * thread (@ref util::BackgroundConsumer), for the record.
+ *
+ * The two hops are different shapes:
+ *
+ *   - **lightdata → recodata** is a whole-run hand-off (@ref
+ *     LightdataSpills).  Recodata cannot start before lightdata ends: its
+ *     fine-time calibration comes from the run-wide `h_fine_calib` and its
+ *     offset prescan reads every spill before the main pass.  The spills
+ *     are kept in memory instead of being read back from `lightdata.root`;
+ *     recodata's main pass releases each one as it takes it.  The hand-off
+ *     is capped (@ref LightdataSpills::budget_bytes): a run that does not
+ *     fit is dropped from memory and recodata reads the file as usual.
+ *   - **recodata → recotrackdata** streams (@ref RecodataFrameQueue):
+ *     recotrack consumes spill batches on its own thread while recodata is
+ *     still reconstructing the next spills.
+ *
+ * The small per-run objects (`h_fine_calib`, the trigger QA hists) are
+ * still read from the stage's file once it is closed; only the trees
+ * skip the round trip.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "alcor_finedata.h"  // AlcorFinedataStruct
+#include "alcor_spilldata.h" // AlcorSpilldataStruct
+#include "triggers/events.h" // TriggerEvent
+#include "utility/handoff_queue.h"
+
+namespace btana::cascade
+{
+
+/// Default cap on the memory held by @ref LightdataSpills (4 GiB).
+constexpr std::size_t kLightdataSpillsBudgetBytes = std::size_t{4} << 30;
+
+/// Heap bytes held by one spill's flat lists (capacity-based estimate).
+inline std::size_t held_bytes(const AlcorSpilldataStruct &spill)
+{
+    std::size_t bytes = spill.dead_mask_list.capacity() * sizeof(DataMaskStruct) +
+                        spill.participants_mask_list.capacity() * sizeof(DataMaskStruct) +
+                        spill.frame_reference.capacity() * sizeof(uint32_t) +
+                        spill.lightdata_list_in_frame.capacity() * sizeof(AlcorLightdataStruct);
+    for (const auto &frame : spill.lightdata_list_in_frame)
+        bytes += frame.trigger_hits.capacity() * sizeof(TriggerEvent) +
+                 (frame.timing_hits.capacity() + frame.tracking_hits.capacity() +
+                  frame.cherenkov_hits.capacity()) *
+                     sizeof(AlcorFinedataStruct);
+    return bytes;
+}
+
+/**
+ * @brief Every spill lightdata wrote, in tree-entry order.
+ *
+ * Each entry holds only the flat lists (`dead_mask_list`,
+ * `participants_mask_list`, `frame_reference`, `lightdata_list_in_frame`)
+ * — exactly what one `lightdata` tree entry reads back into.
+ *
+ * Bounded by @ref budget_bytes: the spill that would cross it releases
+ * everything held so far and sets @ref over_budget, after which @ref keep
+ * drops every spill.  The hand-off is all-or-nothing so the consumer
+ * either runs fully from memory or fully from the file.
+ */
+struct LightdataSpills
+{
+    std::vector<AlcorSpilldataStruct> spills;
+    std::size_t budget_bytes = kLightdataSpillsBudgetBytes;
+    std::size_t n_held_bytes = 0;
+    bool over_budget = false;
+
+    /// Take @p spill into the hand-off unless the budget is exhausted.
+    void keep(AlcorSpilldataStruct &&spill)
+    {
+        if (over_budget)
+            return;
+        const std::size_t bytes = held_bytes(spill);
+        if (n_held_bytes + bytes > budget_bytes)
+        {
+            over_budget = true;
+            std::vector<AlcorSpilldataStruct>().swap(spills);
+            n_held_bytes = 0;
+            return;
+        }
+        n_held_bytes += bytes;
+        spills.push_back(std::move(spill));
+    }
+};
+
+/// One recodata tree entry (the `triggers`, `recodata`, `frame` and `trigger_mask` branches).
+struct RecodataFrame
+{
+    std::vector<TriggerEvent> triggers;
+    std::vector<AlcorFinedataStruct> hits;
+    uint32_t frame_id = 0;
+    TriggerMask trigger_mask = 0; ///< Sealed when the entry is archived.
+};
+
+/// The recodata entries of one spill, start-of-spill marker first.
+using RecodataSpillFrames = std::vector<RecodataFrame>;
+
+/**
+ * @brief recodata → recotrackdata stream, one item per spill.
+ *
+ * A class rather than an alias so the writer headers can forward-declare
+ * it.
+ *
+ * Recodata pushes after the spill is archived; the cascade driver closes
+ * the queue when recodata returns.  Recotrack may close it early (frame
+ * cap reached) — recodata then keeps archiving and drops the hand-off.
+ */
+class RecodataFrameQueue : public util::HandoffQueue<RecodataSpillFrames>
+{
+public:
+    using HandoffQueue::HandoffQueue;
+};
+
+/// Spill batches buffered between recodata and recotrack.
+constexpr std::size_t kRecodataQueueDepth = 4;
+
+} // namespace btana::cascade
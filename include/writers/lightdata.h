@@ -12,6 +12,11 @@
 
 #include <string>
 
+namespace btana::cascade
+{
+struct LightdataSpills;
+}
+
 /**
  * @brief Build a lightdata ROOT file from raw ALCOR data for a given run.
  *
@@ -75,6 +80,14 @@
  *        unassigned (`Mapping::assign_position` runs inside the skipped
  *        loop) — consumers must map positions themselves.  Default
  *        @c false = full pipeline.
+ * @param spills_out  End-to-end cascade hand-off (`writers/cascade.h`).
+ *        When non-null, every spill written to the lightdata tree is also
+ *        moved into @p spills_out (tree-entry order) after the archiving
+ *        thread has filled it, so `recodata_writer` can run on it without
+ *        reading the tree back, up to its memory budget (see
+ *        `LightdataSpills::keep`).  Left empty when the writer returns
+ *        early (output exists, no rebuild) or the run exceeds the
+ *        budget.  Default nullptr.
  */
 void lightdata_writer(
     const std::string &data_repository,
@@ -91,4 +104,40 @@ void lightdata_writer(
     float streaming_n_sigma_threshold_override = 0.f,
     int op_mode = 1,
     bool leading_edge_only = false,
-    bool skip_stream_qa = false);
+    bool skip_stream_qa = false,
+    btana::cascade::LightdataSpills *spills_out = nullptr);
+
+/**
+ * @brief Re-run only the software-trigger stages over an existing lightdata.
+ *
+ * Reads @p data_repository/@p run_name/lightdata.root (no cascade — raw
+ * data is never touched), strips the previous streaming / RANSAC outputs,
+ * re-runs `compute_streaming_score_pure` + `run_streaming_ransac_compute`
+ * with the current `[streaming_trigger]` / `[streaming_ransac]` settings
+ * and writes the result as the friend tree `lightdata_triggers.root`
+ * (schema and the reader-side overlay in
+ * `include/writers/lightdata/trigger_overlay.h`).  `recodata_writer`,
+ * `btana-dump` and `ransac_tune` apply the overlay automatically when the
+ * file exists.
+ *
+ * The per-spill weight bundle (cumulative DCR + in-beam sideband) is
+ * rebuilt from the frames on disk exactly at the noise → data boundary, as
+ * in @ref lightdata_writer.  Frames the original pass dropped cannot be
+ * recovered; see the limitation note in `trigger_overlay.h`.
+ *
+ * @param fine_calibration_config_file  Fine-time calibration; empty picks
+ *        the run-local `fine_calib.toml` the lightdata pass wrote.
+ *
+ * Remaining parameters as in @ref lightdata_writer.
+ */
+void lightdata_retrigger_writer(
+    const std::string &data_repository,
+    const std::string &run_name,
+    int max_spill = 1000,
+    bool force_rebuild = false,
+    int requested_n_threads = -1,
+    std::string mapping_config_file = "conf/mapping_conf.toml",
+    std::string fine_calibration_config_file = "",
+    std::string framer_conf_file = "conf/framer_conf.toml",
+    std::string streaming_conf_file = "conf/streaming.toml",
+    float streaming_n_sigma_threshold_override = 0.f);
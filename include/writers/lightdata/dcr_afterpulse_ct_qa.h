@@ -19,8 +19,9 @@
  *   - Gate the call on the first-frames trigger being present in the
  *     frame (the function itself does NOT gate — keeps the function
  *     pure compute-on-input).
- *   - Hoist `ct_hits` and `sorted_by_time` outside the per-frame loop
- *     (capacity stabilisation across frames).
+ *   - Hoist `ct_pairs` outside the per-frame loop (its channel
+ *     adjacency table is built once per run; capacity stabilisation
+ *     across frames).
  *   - Pass `active_sensors_count` zeroed for every active channel
  *     (the function fills counts; caller does not need to reset).
  *   - Pre-build `active_sensors` once per spill.
@@ -31,9 +32,9 @@
 #include <unordered_map>
 #include <vector>
 
-#include "alcor_finedata.h"          // AlcorFinedataStruct
-#include "utility/config_reader.h"   // QaConfigStruct
-#include "writers/lightdata/types.h" // CtHit
+#include "alcor_finedata.h"            // AlcorFinedataStruct
+#include "utility/config_reader.h"     // QaConfigStruct
+#include "utility/cross_talk_pairs.h"  // util::cross_talk::PairFinder
 
 class TH1F;
 class TH2F;
@@ -96,8 +97,7 @@ struct DcrAfterpulseCtHists
  * @param cherenkov_hits          Per-frame Cherenkov hit vector (read).
  * @param active_sensors          Set of channel_ordinals active this spill (read).
  * @param active_sensors_count    Per-channel hit-counter (cleared + filled here).
- * @param ct_hits                 Hoisted scratch buffer for per-Hit CT records.
- * @param sorted_by_time          Hoisted scratch buffer for the time-sorted index.
+ * @param ct_pairs                Hoisted cross-talk pair finder (CT neighbour search).
  * @param qa_cfg                  QA timing-window config (read).
  * @param hists                   Pointer-bundle of output histograms.
  */
@@ -105,8 +105,7 @@ void fill_dcr_afterpulse_ct_qa(
     const std::vector<AlcorFinedataStruct> &cherenkov_hits,
     const std::set<uint32_t> &active_sensors,
     std::unordered_map<uint32_t, uint16_t> &active_sensors_count,
-    std::vector<CtHit> &ct_hits,
-    std::vector<std::size_t> &sorted_by_time,
+    util::cross_talk::PairFinder &ct_pairs,
     const QaConfigStruct &qa_cfg,
     const DcrAfterpulseCtHists &hists);
 
@@ -0,0 +1,160 @@
+#pragma once
+
+/**
+ * @file trigger_overlay.h
+ * @brief Friend-tree "delta" of the software-trigger stages, and the
+ *        reader-side overlay that applies it on top of `lightdata.root`.
+ *
+ * The streaming score + RANSAC outputs live inside `lightdata.root`: the
+ * ring tags are bits of each Cherenkov hit's `HitMask`, the derived
+ * `_TRIGGER_STREAMING_RING_FOUND_` / `_TRIGGER_RANSAC_RING_FOUND_` events
+ * sit in the frame's trigger list, and the RANSAC ring geometry in the
+ * `ring{1,2}_*` fields.  Retuning a `[streaming_trigger]` or
+ * `[streaming_ransac]` knob therefore used to mean a full raw re-decode.
+ *
+ * `lightdata_retrigger_writer` (see `writers/lightdata.h`) instead re-runs
+ * only `compute_streaming_score_pure` + `run_streaming_ransac_compute` over
+ * an existing `lightdata.root` and writes the result to
+ * `<run>/lightdata_triggers.root` — one tree entry per lightdata frame,
+ * indexed on `(spill, frame)`:
+ *
+ * | branch          | type                      | content                                   |
+ * |-----------------|---------------------------|-------------------------------------------|
+ * | `spill`         | `Int_t`                   | lightdata tree entry                      |
+ * | `frame`         | `UInt_t`                  | frame id (`frame_reference`)              |
+ * | `keep`          | `Bool_t`                  | frame still carries ≥ 1 trigger           |
+ * | `triggers`      | `std::vector<TriggerEvent>` | full replacement trigger list           |
+ * | `trigger_bits`  | `std::vector<UChar_t>`    | per-Cherenkov-hit trigger-stage mask bits |
+ * | `ring{1,2}_{cx,cy,radius}` | `Float_t`      | RANSAC seed geometry                      |
+ *
+ * Only the bits in @ref kTriggerStageMaskBits are carried; every other
+ * `HitMask` bit (afterpulse, cross-talk, ToT, lane health) stays as the
+ * raw decode wrote it.
+ *
+ * Readers never touch the tree directly: @ref LightdataTriggerOverlay is
+ * applied to each spill right after `TTree::GetEntry`, rewriting the flat
+ * `frame_reference` / `lightdata_list_in_frame` vectors in place so the
+ * rest of the consumer is unchanged.  Every lightdata reader picks the
+ * file up automatically when present (@ref trigger_overlay_path):
+ * `recodata_writer`, `btana-dump` (print, `--stats`, entry index) and
+ * `ransac_tune`.  Only `lightdata_retrigger_writer` reads the raw-pass
+ * trigger stage underneath, since it is the one rebuilding the overlay.
+ *
+ * **Limitation.**  Frames the original lightdata pass dropped (no trigger
+ * at all) are not on disk, so a looser threshold can only re-tag frames
+ * that were kept — and the streaming carry-in across such a gap is empty.
+ * A `--skip-stream-qa` lightdata keeps every framer-triggered frame and is
+ * the natural base for wide trigger-tuning campaigns.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "alcor_data.h"         // HitMask, encode_bits
+#include "triggers/events.h"    // TriggerEvent
+#include "utility/root_io.h"    // TFilePtr
+
+class TTree;
+struct AlcorLightdataStruct;
+
+namespace btana::lightdata
+{
+
+/// Default friend-file basename, written next to `lightdata.root`.
+inline constexpr const char *kTriggerOverlayFileName = "lightdata_triggers.root";
+
+/// Name of the per-frame tree inside @ref kTriggerOverlayFileName.
+inline constexpr const char *kTriggerOverlayTreeName = "trigger_overlay";
+
+/// The friend file of @p lightdata_path: @ref kTriggerOverlayFileName in
+/// the same directory.
+std::string trigger_overlay_path(const std::string &lightdata_path);
+
+/// `HitMask` bits owned by the software-trigger stages — the only bits the
+/// overlay rewrites.  All live in byte 0, so they fit the `UChar_t` branch.
+inline const uint32_t kTriggerStageMaskBits =
+    encode_bits({HitmaskStreamingRingTrigger,
+                 HitmaskRansacRingTagFirst,
+                 HitmaskRansacRingTagSecond});
+
+/**
+ * @brief One friend-tree entry: the trigger-stage outputs of one frame.
+ *
+ * Plain data; the overlay reader binds its branches to an instance of this
+ * struct and the writer fills one per lightdata frame.
+ */
+struct TriggerOverlayRecord
+{
+    int spill = -1;                    ///< lightdata tree entry.
+    uint32_t frame = 0;                ///< Frame id.
+    bool keep = false;                 ///< Frame still carries a trigger.
+    std::vector<TriggerEvent> triggers; ///< Replacement trigger list.
+    std::vector<uint8_t> trigger_bits; ///< Per-hit bits ⊂ @ref kTriggerStageMaskBits.
+    float ring1_cx = 0.f, ring1_cy = 0.f, ring1_radius = 0.f;
+    float ring2_cx = 0.f, ring2_cy = 0.f, ring2_radius = 0.f;
+
+    void clear()
+    {
+        spill = -1;
+        frame = 0;
+        keep = false;
+        triggers.clear();
+        trigger_bits.clear();
+        ring1_cx = ring1_cy = ring1_radius = 0.f;
+        ring2_cx = ring2_cy = ring2_radius = 0.f;
+    }
+};
+
+/**
+ * @brief Reader-side overlay of a `lightdata_triggers.root` friend file.
+ *
+ * Non-copyable, non-movable: the tree's branch addresses bind into
+ * `record_` (same contract as the other ROOT-bound wrappers).
+ *
+ * Usage, right after each `lightdata_tree->GetEntry(i_spill)`:
+ *
+ *     overlay.apply(i_spill, spilldata->get_frame_reference_list_link(),
+ *                   spilldata->get_frame_list_link());
+ */
+class LightdataTriggerOverlay
+{
+public:
+    /// Open @p path; @ref is_open is false when the file or tree is absent
+    /// (a missing file is silent, an unusable one logs a warning).
+    explicit LightdataTriggerOverlay(const std::string &path);
+    ~LightdataTriggerOverlay();
+
+    LightdataTriggerOverlay(const LightdataTriggerOverlay &) = delete;
+    LightdataTriggerOverlay &operator=(const LightdataTriggerOverlay &) = delete;
+    LightdataTriggerOverlay(LightdataTriggerOverlay &&) = delete;
+    LightdataTriggerOverlay &operator=(LightdataTriggerOverlay &&) = delete;
+
+    /// True when a valid overlay tree is bound.
+    bool is_open() const noexcept { return tree_ != nullptr; }
+
+    /**
+     * @brief Overlay spill @p spill in place.
+     *
+     * For every frame with a friend entry: replaces its trigger list,
+     * rewrites the trigger-stage `HitMask` bits of its Cherenkov hits and
+     * the ring seed geometry, and erases the frame from both parallel
+     * vectors when the re-run left it without any trigger.  Frames without
+     * a friend entry (or whose hit count no longer matches) are left
+     * untouched.
+     *
+     * @return Number of frames dropped from the spill.
+     */
+    std::size_t apply(int spill,
+                      std::vector<uint32_t> &frame_reference,
+                      std::vector<AlcorLightdataStruct> &frames);
+
+private:
+    TFilePtr file_;
+    TTree *tree_ = nullptr; ///< Owned by file_.
+    TriggerOverlayRecord record_;
+    std::vector<TriggerEvent> *triggers_ptr_ = &record_.triggers;
+    std::vector<uint8_t> *trigger_bits_ptr_ = &record_.trigger_bits;
+};
+
+} // namespace btana::lightdata
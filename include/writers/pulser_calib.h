@@ -53,9 +53,32 @@
  * re-solved.  Whole-TDC permanent slip (regime 1) needs no special
  * pass — the fit's natural θ_t absorbs it.
  *
+ * **Streaming accumulation** (`streaming_accumulation`, CLI
+ * `--streaming`): instead of buffering every hit per (channel, spill),
+ * each channel's normal equations and pair diagnostics are accumulated
+ * as the FIFOs are read, so memory no longer grows with the run.  The
+ * anchor FIFO is read first to settle the pulser period.  Each hit
+ * waits in a rolling window of `slip_window_hits` hits for its slip
+ * decision (median phase of its TDC in the window) before its pair
+ * enters the system.  The chi² comes in closed form from the sums.
+ *
+ * **Incremental update** (`incremental`, CLI `--incremental`): the
+ * previous published calibration is loaded as per-channel priors.  Each
+ * channel's prior is tested on a subsample of its new pairs
+ * (`incremental_check_pairs`); only channels whose χ²/pair exceeds
+ * `incremental_chi2_ratio` × their published σ², or that gained a TDC
+ * the prior lacks, are refitted — with the prior slopes seeding the
+ * slope guard and the streaming slip phase.  The rest, and prior
+ * channels absent from the new data, are carried over.  Every entry of
+ * the merged file records its `provenance` and `origin` run.  The check
+ * needs the new pairs of every channel, so the FIFOs are still read in
+ * full: an update saves the fits of the kept channels, not the I/O.
+ *
  * **Parallel**: each channel's fit touches only its local stack, no
- * shared state.  `pulser_calib_writer` dispatches channels via
- * `std::async` in chunks bounded by `hardware_concurrency()`.
+ * shared state.  `pulser_calib_writer` runs one worker slot per
+ * `util::TaskPool` thread (`--threads`); each slot pulls channels off a
+ * shared cursor until none are left.  The 9×9 Cholesky solve is fully
+ * unrolled at compile time.
  *
  * **Fine-band filter at ingest**: hits with `fine` outside
  * `[cfg.fine_min_valid, cfg.fine_max_valid]` (default [20, 160]) are
@@ -74,6 +97,11 @@
  *    `get_phase = fine·a − minus_b` recovers `c − (f·a + b)`)
  *  - `sigma   = sqrt(chi²/N)` (per-pair residual sigma, cc)
  *
+ * plus two provenance fields, ignored by the calibration reader:
+ *  - `provenance = "fit" | "carried"` (refitted from this run's data,
+ *    or kept from the prior by an incremental update)
+ *  - `origin  = <run>` (the run whose data produced the entry)
+ *
  * Out-of-band fitted slopes (outside `[cfg.slope_min, cfg.slope_max]`)
  * are replaced by `cfg.default_slope_cc_per_bin` at publish time;
  * intercepts outside `[cfg.b_min, cfg.b_max]` are clamped to the
@@ -128,6 +156,17 @@ namespace btana
  *                                   calling this binary, so the
  *                                   on-the-wire override is always
  *                                   in cc — matches the TOML field.
+ * @param streaming_accumulation     If @c true, force
+ *                                   ``cfg.streaming_accumulation`` on for
+ *                                   this launch (bounded-memory ingest).
+ *                                   @c false keeps the TOML value.
+ * @param incremental                If @c true, force ``cfg.incremental``
+ *                                   on: refit only channels whose new data
+ *                                   diverges from the previous calibration
+ *                                   and merge.  @c false keeps the TOML value.
+ * @param incremental_from           CLI override for ``cfg.incremental_from``
+ *                                   (prior calibration path).  Empty keeps
+ *                                   the TOML value.
  */
 void pulser_calib_writer(
     const std::string &data_repository,
@@ -139,6 +178,9 @@ void pulser_calib_writer(
     int anchor_chip_override = -1,
     int anchor_eo_channel_override = -1,
     int anchor_fifo_override = -1,
-    double pulser_period_cc_override = -1.0);
+    double pulser_period_cc_override = -1.0,
+    bool streaming_accumulation = false,
+    bool incremental = false,
+    const std::string &incremental_from = "");
 
 } // namespace btana
@@ -0,0 +1,391 @@
+#pragma once
+
+/**
+ * @file writers/pulser_calib/channel_fit.h
+ * @brief Per-channel closed-form fit of the pulser calibration, in its
+ *        two ingest modes.
+ *
+ * `fit_channel` takes every hit of a channel at once (buffered mode) and
+ * `StreamingChannel` folds hits in as the FIFOs are read
+ * (`cfg.streaming_accumulation`).  Both build the same 9-parameter
+ * normal equations from the same pieces, so for the same hits they
+ * publish the same per-TDC `(a, b)` up to the slip decisions, which the
+ * streaming mode takes on a rolling window.  The model, the constraints
+ * and the slip correction are described in `writers/pulser_calib.h`.
+ *
+ * Plain data, no ROOT: the writer turns the results into histograms and
+ * `fine_calib.toml`.
+ */
+
+#include "utility/config_reader.h" // CalibConfigStruct
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace btana::pulser_calib
+{
+
+// ---------------------------------------------------------------------------
+//  Channel addressing.  A physical channel is (device, chip, eo_channel).
+//  Per channel, the 4 TDCs are distinguished by `tdc ∈ {0,1,2,3}`.
+// ---------------------------------------------------------------------------
+
+struct ChannelKey
+{
+    int device;
+    int chip;
+    int eo_channel;
+
+    bool operator<(const ChannelKey &o) const noexcept
+    {
+        return std::tie(device, chip, eo_channel) <
+               std::tie(o.device, o.chip, o.eo_channel);
+    }
+    bool operator==(const ChannelKey &o) const noexcept
+    {
+        return device == o.device && chip == o.chip && eo_channel == o.eo_channel;
+    }
+};
+
+struct ChannelHit
+{
+    int64_t abs_coarse_cc; ///< get_coarse_global_time(), int64 to be safe
+    uint8_t fine;          ///< raw fine bin
+    uint8_t tdc;           ///< 0..3
+};
+
+//  Per-channel data is bucketed by spill: `get_coarse_global_time()`
+//  is monotonic within a spill (rollover counter increments cleanly)
+//  but jumps unpredictably across spills (different starting rollover
+//  reference per stream / spill).  Per-spill fits + cross-spill
+//  aggregation handle this without needing cross-spill rollover
+//  resolution.
+struct SpillBucket
+{
+    std::vector<ChannelHit> hits;
+};
+struct ChannelBucket
+{
+    //  Sparse — only spills where the channel saw at least one hit.
+    std::vector<SpillBucket> per_spill;
+};
+
+//  ── c_h − c_p diagnostic histogram bins ────────────────────────
+//  Per-channel arrays of counts populated by fit_channel before the
+//  safety filter is applied.  Summed across channels at writer time
+//  into ROOT TH1Fs.  Done with raw fixed-size arrays (instead of
+//  TH1F per channel) so the per-channel work is allocation-free and
+//  the parallel fit loop has no ROOT-object-construction contention.
+//
+//  ZOOM hist: ±1000 cc around T_nominal, 1 cc bins → shows the
+//      tightness of the 1T peak.  Bin index 0 corresponds to
+//      T_nominal − 1000.
+//  WIDE hist: [0, 5T_nominal], T_nominal/64 ≈ 5000 cc bins → shows
+//      multi-T leakage (2T, 3T peaks).
+constexpr int CDIFF_ZOOM_BINS = 2001; // [T-1000, T+1000], 1 cc/bin
+constexpr int CDIFF_WIDE_BINS = 320;  // [0, 5T], T/64 cc/bin
+
+struct ChannelResult
+{
+    ChannelKey key;
+    double T_cc = 0.0;          ///< fitted pulser period (or fixed value)
+    double chi2_per_pair = 0.0; ///< final chi²/N for QA
+    long total_hits = 0;
+    long n_pairs_used = 0;
+    long n_pairs_seen = 0;  ///< pairs visited BEFORE the safety filter
+    bool ok = false;        ///< solver succeeded AND ≥1 TDC met threshold
+    bool converged = false; ///< Cholesky succeeded (matrix SPD)
+    bool carried = false;   ///< incremental: prior entries kept, no refit
+    struct PerTdcOut
+    {
+        bool fitted = false;
+        double a = 0.0;       ///< slope cc/bin
+        double b = 0.0;       ///< offset cc (b[0] fixed to gauge value)
+        double sigma_a = 0.0; ///< placeholder (not yet propagated)
+        double sigma_b = 0.0;
+        long n_hits = 0;         ///< total hits on this TDC across all spills
+        long n_slipped_hits = 0; ///< hits re-snapped by the slip-correction pass
+    };
+    PerTdcOut tdc[4]{};
+    //  Diagnostic histograms — see comment above.
+    std::array<long, CDIFF_ZOOM_BINS> cdiff_zoom{};
+    std::array<long, CDIFF_WIDE_BINS> cdiff_wide{};
+};
+
+//  Previous published calibration of one channel (incremental mode,
+//  `cfg.incremental`), as read back from fine_calib.toml.  The values
+//  are the published ones, i.e. after the publish-time clamps.
+struct ChannelPrior
+{
+    bool present[4] = {};
+    double a[4] = {};     ///< slope cc/bin
+    double b[4] = {};     ///< offset cc (= −minus_b)
+    double sigma = 0.0;   ///< published per-pair residual sigma, cc
+    std::string origin;   ///< run whose data produced the fit
+};
+
+//  ── Fit building blocks shared by both ingest modes ─────────────
+//  `fit_channel` (buffered: all hits of a channel in RAM, two passes)
+//  and `StreamingChannel` (hits folded in as they are read) assemble
+//  the same system from the same pieces below.
+//
+//  Parameters (unknowns) of the per-channel fit, in fixed order:
+//      index 0..3   per-TDC offsets    θ_t   (cc)
+//      index 4..7   per-TDC slopes     a_t   (cc per fine bin)
+//      index 8      pulser period      T     (cc)
+//  Total of 9 unknowns — fixed by the architecture.
+constexpr int NUM_FIT_PARAMS = 9;
+constexpr int OFFSET_PARAM_BASE = 0; // θ_t lives at index t
+constexpr int SLOPE_PARAM_BASE = 4;  // a_t lives at index t + 4
+constexpr int PERIOD_PARAM_IDX = 8;
+//  At most 5 unknowns per pair row contribute (2 offsets + 2
+//  slopes + 1 period).  We accumulate Aᵀ·A and Aᵀ·y as a sparse
+//  rank-1 update per pair — O(25) flops per pair, no inner-loop
+//  allocation.
+constexpr int MAX_NONZEROS_PER_PAIR_ROW = 5;
+
+//  Nominal pulser period used by the consecutive-pair safety filter.
+//  TOML knob > 0 ⇒ operator pins the period (e.g. 320000 cc for a
+//  1 kHz pulser at 320 MHz).  Otherwise the period is a free 9th fit
+//  parameter and the filter is centred on the 1 kHz default.
+inline bool fit_period_from_data(const CalibConfigStruct &cfg)
+{
+    return !(cfg.pulser_period_cc > 0.0);
+}
+inline double nominal_period_cc(const CalibConfigStruct &cfg)
+{
+    return cfg.pulser_period_cc > 0.0 ? cfg.pulser_period_cc : 320000.0;
+}
+
+//  Aᵀ·A, Aᵀ·y and Σ y² over the pairs that passed the safety filter.
+struct NormalEquations
+{
+    double matrix[NUM_FIT_PARAMS * NUM_FIT_PARAMS] = {};
+    double rhs[NUM_FIT_PARAMS] = {};
+    double target_sum_squared = 0.0; ///< Σ y², for chi² recovery
+    long n_pairs = 0;
+
+    //  One pair row (prev_hit → curr_hit) with target `pair_target_cc`.
+    void add_pair(const ChannelHit &prev_hit, const ChannelHit &curr_hit,
+                  double pair_target_cc, bool fit_period)
+    {
+        //  Only TDCs 0..3 have columns; the ingest never produces
+        //  anything else, but a bad index would write out of bounds.
+        if (prev_hit.tdc > 3 || curr_hit.tdc > 3)
+            return;
+        //  Build the sparse A-row for this pair.  The model
+        //  says:  pair_coarse_diff_cc =
+        //         T + (θ_curr − θ_prev)
+        //           + (fine_curr · a_curr − fine_prev · a_prev)
+        //  Each contribution is one nonzero column entry.
+        int sparse_col_indices[MAX_NONZEROS_PER_PAIR_ROW];
+        double sparse_col_values[MAX_NONZEROS_PER_PAIR_ROW];
+        int num_nonzeros = 0;
+
+        //  Offsets: contribute only when the two hits are on
+        //  different TDCs (otherwise θ_curr − θ_prev = 0).
+        if (curr_hit.tdc != prev_hit.tdc)
+        {
+            sparse_col_indices[num_nonzeros] =
+                OFFSET_PARAM_BASE + curr_hit.tdc;
+            sparse_col_values[num_nonzeros] = +1.0;
+            ++num_nonzeros;
+            sparse_col_indices[num_nonzeros] =
+                OFFSET_PARAM_BASE + prev_hit.tdc;
+            sparse_col_values[num_nonzeros] = -1.0;
+            ++num_nonzeros;
+        }
+        //  Slopes: always two entries (+f_curr, -f_prev).
+        //  For same-TDC pairs they both fall on the same
+        //  slope column and the rank-1 update collapses them
+        //  automatically.
+        sparse_col_indices[num_nonzeros] =
+            SLOPE_PARAM_BASE + curr_hit.tdc;
+        sparse_col_values[num_nonzeros] =
+            +static_cast<double>(curr_hit.fine);
+        ++num_nonzeros;
+        sparse_col_indices[num_nonzeros] =
+            SLOPE_PARAM_BASE + prev_hit.tdc;
+        sparse_col_values[num_nonzeros] =
+            -static_cast<double>(prev_hit.fine);
+        ++num_nonzeros;
+        //  Period: only when T is a free parameter.  Row
+        //  entry −1 because the model has +T on the RHS that
+        //  we move to the LHS.
+        if (fit_period)
+        {
+            sparse_col_indices[num_nonzeros] = PERIOD_PARAM_IDX;
+            sparse_col_values[num_nonzeros] = -1.0;
+            ++num_nonzeros;
+        }
+
+        //  Rank-1 update of Aᵀ·A and Aᵀ·y.
+        for (int outer = 0; outer < num_nonzeros; ++outer)
+        {
+            rhs[sparse_col_indices[outer]] +=
+                sparse_col_values[outer] * pair_target_cc;
+            for (int inner = 0; inner < num_nonzeros; ++inner)
+                matrix[sparse_col_indices[outer] * NUM_FIT_PARAMS +
+                       sparse_col_indices[inner]] +=
+                    sparse_col_values[outer] *
+                    sparse_col_values[inner];
+        }
+        target_sum_squared += pair_target_cc * pair_target_cc;
+        ++n_pairs;
+    }
+};
+
+//  Diagnostic c_h − c_p histograms — filled BEFORE the safety filter
+//  so they show what's being rejected too.
+inline void fill_cdiff_hists(ChannelResult &result, double pair_coarse_diff_cc,
+                             double nominal_period)
+{
+    ++result.n_pairs_seen;
+    const double cdiff_relative_to_zoom_lo =
+        pair_coarse_diff_cc - (nominal_period - 1000.0);
+    const int zoom_bin = static_cast<int>(
+        std::floor(cdiff_relative_to_zoom_lo));
+    if (zoom_bin >= 0 && zoom_bin < CDIFF_ZOOM_BINS)
+        ++result.cdiff_zoom[zoom_bin];
+    const double wide_bin_width_cc = nominal_period / 64.0;
+    const int wide_bin = static_cast<int>(
+        std::floor(pair_coarse_diff_cc / wide_bin_width_cc));
+    if (wide_bin >= 0 && wide_bin < CDIFF_WIDE_BINS)
+        ++result.cdiff_wide[wide_bin];
+}
+
+//  Regime-2 slip decision over one population of within-pulse phases
+//  — one (spill, TDC) in `fit_channel`, one TDC's share of the
+//  rolling window in `StreamingChannel`.  Writes each phase's integer
+//  slip into `slips` (0 = leave the hit alone).  Returns false, with
+//  every slip 0, when the population is too small for a median or
+//  the safety cap trips.
+//
+//    1. The median phase is the TDC's "true" phase.
+//    2. Per hit, the deviation from the median rounds to an integer
+//       cc → the slip in coarse counter units.
+//    3. Snap only if the rounded slip is non-zero and the deviation
+//       sits within `slip_confidence_cc` of that integer.  Looser
+//       confidence ⇒ over-snaps under the natural ~0.5 cc scatter
+//       from sub-optimal slope fits.
+//    4. Safety cap (`slip_max_snap_fraction`): if more than this
+//       fraction of the population would snap, the distribution is
+//       too noisy / wide to trust — snap nothing.
+bool decide_slips(const std::vector<double> &phases,
+                  std::vector<double> &sorted_scratch,
+                  const CalibConfigStruct &cfg,
+                  std::vector<int> &slips);
+
+//  Buffered fit of one channel: every hit of every spill in `bucket`,
+//  in read order.  Two passes when the slip correction snaps anything.
+//  `prior` seeds the guarded slopes in incremental mode.
+ChannelResult fit_channel(const ChannelKey &channel_key, ChannelBucket bucket,
+                          const CalibConfigStruct &cfg,
+                          const ChannelPrior *prior = nullptr);
+
+// ---------------------------------------------------------------------------
+//  Streaming accumulation (`cfg.streaming_accumulation`).
+//
+//  The buffered path above keeps every hit of a channel until its fit;
+//  on a long pulser run that is hundreds of millions of ChannelHits in
+//  RAM.  StreamingChannel folds each hit into the channel's normal
+//  equations as the FIFO is read, so the memory per channel is fixed
+//  and independent of the run length:
+//
+//    - Step 1 bookkeeping (hit counts, fine span) and the c_h − c_p
+//      diagnostic histograms are updated per raw pair on arrival.
+//    - Slip correction cannot wait for a first-pass fit.  Each hit is
+//      held in a rolling window of `slip_window_hits` hits; when it
+//      leaves the window its phase is compared with the median of its
+//      TDC's hits in the window (same `decide_slips` rule), it is
+//      snapped if needed, and only then does its pair with the
+//      previous committed hit enter the normal equations.
+//    - chi² follows in closed form from the accumulated sums,
+//      ‖y − A·x‖² = Σy² − 2·xᵀ·Aᵀy + xᵀ·AᵀA·x, since there are no
+//      hits left for a second pair walk.
+//
+//  The phase uses the default slope (the prior's, in incremental mode)
+//  instead of a fitted one: pulser
+//  hits of one TDC cover only a few fine bins, so the slope error
+//  moves the phase by ≪ slip_confidence_cc, and θ_t is common to all
+//  hits of a TDC and cancels against the median.  Phases are taken
+//  relative to the oldest hit in the window, so an error in the period
+//  accumulates only across the window, not across the spill.
+// ---------------------------------------------------------------------------
+struct StreamingChannel
+{
+    ChannelResult acc; ///< counters + cdiff histograms, filled on arrival
+    NormalEquations system;
+    int fine_min_per_tdc[4] = {256, 256, 256, 256};
+    int fine_max_per_tdc[4] = {-1, -1, -1, -1};
+    int spill_idx = -1; ///< spill of the hits in flight
+    bool has_last_raw = false;
+    ChannelHit last_raw{}; ///< previous hit as read (diagnostics)
+    bool has_last_committed = false;
+    ChannelHit last_committed{}; ///< previous hit after slip correction
+    std::deque<ChannelHit> window; ///< hits awaiting their slip decision
+    const ChannelPrior *prior = nullptr; ///< incremental mode: seeds the phase slope
+    //  Incremental mode: evenly spread sample of the committed pairs for
+    //  the prior χ² check.  Every `check_stride`-th pair is kept; when
+    //  the sample reaches twice `incremental_check_pairs` every other
+    //  entry is dropped and the stride doubles, so it stays bounded and
+    //  spread over the whole run.
+    std::vector<std::pair<ChannelHit, ChannelHit>> check_pairs;
+    long check_stride = 1;
+    long n_committed_pairs = 0;
+    //  Running period for the phase when T is a free parameter: mean
+    //  Δc of the raw pairs that pass the safety filter.
+    double accepted_diff_sum_cc = 0.0;
+    long accepted_diff_count = 0;
+    //  Scratch for the slip decision, reused hit after hit.
+    std::vector<std::size_t> tdc_positions;
+    std::vector<double> tdc_phases;
+    std::vector<double> sorted_phases;
+    std::vector<int> tdc_slips;
+
+    static std::size_t window_size(const CalibConfigStruct &cfg)
+    {
+        //  A non-positive cap disables slip correction (same switch as
+        //  the buffered path) — then there is nothing to wait for.
+        if (cfg.slip_max_snap_fraction <= 0.0 || cfg.slip_window_hits <= 0)
+            return 0;
+        return static_cast<std::size_t>(cfg.slip_window_hits);
+    }
+
+    double phase_period(const CalibConfigStruct &cfg) const
+    {
+        constexpr long MIN_PAIRS_FOR_RUNNING_PERIOD = 100;
+        if (fit_period_from_data(cfg) &&
+            accepted_diff_count >= MIN_PAIRS_FOR_RUNNING_PERIOD)
+            return accepted_diff_sum_cc / static_cast<double>(accepted_diff_count);
+        return nominal_period_cc(cfg);
+    }
+
+    //  Slip decision for every window hit on `tdc`.  Fills
+    //  `tdc_positions` (window indices) and `tdc_slips` in step.
+    void decide_tdc(int tdc, const CalibConfigStruct &cfg);
+
+    //  Fold one hit, after its slip decision, into the normal equations
+    //  as the second hit of a pair with the previous committed hit.
+    void commit(ChannelHit hit, int slip_cc, const CalibConfigStruct &cfg);
+
+    //  Decide and commit everything still in the window (end of spill
+    //  or of the run).  The decisions all see the full remaining
+    //  window, as the buffered pass sees the full (spill, TDC).
+    void flush(const CalibConfigStruct &cfg);
+
+    //  One hit of spill `spill`, in read order.
+    void add(const ChannelHit &hit, int spill, const CalibConfigStruct &cfg);
+
+    //  Flush, solve and publish.  Consumes the accumulated counters.
+    ChannelResult solve(const ChannelKey &channel_key, const CalibConfigStruct &cfg);
+};
+
+} // namespace btana::pulser_calib
@@ -11,6 +11,11 @@
 
 #include <string>
 
+namespace btana::cascade
+{
+class RecodataFrameQueue;
+}
+
 /// @brief Minimum separation between two valid same-type triggers (clock cycles, ~25 ns).
 #define BTANA_TRIGGER_MIN_SEPARATION 16
 
@@ -67,4 +72,18 @@ void recodata_writer(
      *   "ellipse" — force the elliptical radius ρ (--force-ellipse).
      * Drives the per-trigger N_γ radial remap + the hitmap overlay.
      */
-    std::string ring_shape_mode = "auto");
+    std::string ring_shape_mode = "auto",
+    /**
+     * End-to-end mode (`writers/cascade.h`): when the lightdata cascade
+     * runs, keep its spills in memory and reconstruct from them instead
+     * of reading the freshly written `lightdata.root` tree back.  No
+     * effect when lightdata.root is reused.
+     */
+    bool end_to_end = false,
+    /**
+     * Downstream hand-off: when non-null, every spill's recodata entries
+     * are pushed here after they are archived (see
+     * `btana::cascade::RecodataFrameQueue`).  The caller owns the queue
+     * and closes it once this function returns.
+     */
+    btana::cascade::RecodataFrameQueue *frames_out = nullptr);
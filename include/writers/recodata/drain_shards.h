@@ -0,0 +1,134 @@
+#pragma once
+
+/**
+ * @file drain_shards.h
+ * @brief Histogram half of the recodata drain, split into per-worker
+ *        shards so it can run in parallel.
+ *
+ * The drain of a `FrameResult` has two independent halves:
+ *
+ *   - the **tree append** (`recodata.add_*`, `TTree::Fill`, per-spill
+ *     counters) — must stay serial and in frame order, it stays in
+ *     `recodata_writer.cxx`;
+ *   - the **histogram fills** — order-insensitive up to floating-point
+ *     summation order, handled here.
+ *
+ * @ref DrainHistShards owns one detached clone of every drain histogram
+ * per shard.  Frames are split into a FIXED number of contiguous chunks
+ * per spill and chunk k is always filled into shard k, so the content of
+ * every shard — and of the final @ref DrainHistShards::merge, which adds
+ * the shards in index order — does not depend on the thread count or on
+ * scheduling.
+ */
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "writers/recodata/types.h" // FrameResult, RingFillHists
+
+class TH1;
+struct TriggerRegistry;
+
+namespace btana::recodata
+{
+
+/**
+ * @brief Every histogram the drain fills, as non-owning pointers.
+ *
+ * The first-ring bundle is held twice: the headline slots are the same
+ * in @ref first_dual and @ref first_solo, only the split slots differ
+ * (`_dual` / `_solo` twins, chosen per frame by
+ * `FrameResult::frame_has_second_ring`).
+ */
+struct DrainHists
+{
+    TH2F *h_frames_per_spill = nullptr;
+    TH2F *h_edge_trigger_position = nullptr;
+    TH2F *h_trigger_qa = nullptr;
+    TH2F *h_trigger_cherenkov_hitmap = nullptr;
+    TH2F *h_ring_tagged_hitmap = nullptr;
+    /// Per-trigger Δt hists, keyed by raw trigger value.  Created lazily
+    /// by the writer; must hold every key a filled frame references.
+    std::map<int, TH1F *> h_trigger_time_diff;
+
+    RingFillHists first_dual;
+    RingFillHists first_solo;
+    RingFillHists second;
+};
+
+/**
+ * @brief Histogram half of the drain for one frame.
+ *
+ * Every fill the serial drain used to do for @p res (frame counters,
+ * trigger QA, Δt, hitmaps, per-ring bundles) goes into @p h.  Mutates
+ * only the histograms of @p h; callers filling disjoint shards may run
+ * concurrently.
+ */
+void fill_frame_hists(const FrameResult &res, int i_spill,
+                      const TriggerRegistry &registry,
+                      bool eff_weight_per_ring, const DrainHists &h);
+
+/**
+ * @brief Fixed set of per-shard histogram clones plus the deterministic
+ *        reduction into the writer's output histograms.
+ */
+class DrainHistShards
+{
+public:
+    /// Shard count used by the writer.  Independent of the thread count
+    /// so the merged output is too.
+    static constexpr std::size_t kDefaultShards = 16;
+
+    /**
+     * @param main      Output histograms.  Must outlive the shards; the
+     *                  pointers are only read here and in @ref merge.
+     * @param n_shards  Number of shards (≥ 1).
+     */
+    DrainHistShards(const DrainHists &main, std::size_t n_shards = kDefaultShards);
+    ~DrainHistShards();
+
+    DrainHistShards(const DrainHistShards &) = delete;
+    DrainHistShards &operator=(const DrainHistShards &) = delete;
+
+    std::size_t size() const noexcept { return shards_.size(); }
+
+    /// Fill targets of shard @p k.  Only one thread may fill a shard at a time.
+    const DrainHists &shard(std::size_t k) const { return shards_[k]; }
+
+    /**
+     * @brief Clone every main Δt hist the shards do not have yet.
+     *
+     * Call serially (main thread) after the writer has created new
+     * `h_trigger_time_diff` entries and before the next parallel fill.
+     */
+    void sync_time_diff(const DrainHists &main);
+
+    /**
+     * @brief Add every shard into the main histograms, shard 0 first, and
+     *        reset the shards.  Call once after the spill loop, before
+     *        any output hist is read.
+     */
+    void merge();
+
+    /**
+     * @brief Chunk @p k of @p n_frames frames: `[begin, end)`.  The split
+     *        depends only on @p n_frames and @ref size.
+     */
+    std::pair<std::size_t, std::size_t> chunk(std::size_t k, std::size_t n_frames) const;
+
+private:
+    /// Shard-@p k clone of @p main (created for every shard on first use).
+    TH1 *clone_for(std::size_t k, TH1 *main);
+
+    std::vector<DrainHists> shards_;
+    /// Main hist → its clone in every shard, in shard order.
+    std::unordered_map<TH1 *, std::vector<std::unique_ptr<TH1>>> clones_;
+    /// Main hists in first-registration order, so @ref merge is reproducible.
+    std::vector<TH1 *> order_;
+};
+
+} // namespace btana::recodata
@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * @file fine_offsets.h
+ * @brief Bounded-memory per-channel fine-time offset estimator for the
+ *        recodata writer's calibration prescan.
+ *
+ * The prescan looks at every Cherenkov hit of a frame carrying the
+ * streaming ring-found trigger and records `Δt = t_hit − t_trigger`.
+ * The committed per-channel offset is the mean Δt over the samples
+ * inside `|Δt| < outlier_cut_ns`, provided the channel saw at least
+ * `min_samples` samples in total AND inside the cut.  Only three numbers
+ * per channel are kept (total count, in-cut count, in-cut sum), so the
+ * memory no longer grows with the number of hits in the run.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace btana::recodata
+{
+
+class FineOffsetEstimator
+{
+public:
+    static constexpr float kDefaultOutlierCutNs = 30.f;
+    static constexpr int kDefaultMinSamples = 20;
+
+    explicit FineOffsetEstimator(float outlier_cut_ns = kDefaultOutlierCutNs,
+                                 int min_samples = kDefaultMinSamples)
+        : outlier_cut_ns_(outlier_cut_ns), min_samples_(min_samples) {}
+
+    /// Record one hit-to-trigger time difference [ns] for @p global_index.
+    void add(uint32_t global_index, float dt_ns)
+    {
+        auto &acc = channels_[global_index];
+        ++acc.n_total;
+        if (dt_ns < -outlier_cut_ns_ || dt_ns > outlier_cut_ns_)
+            return;
+        ++acc.n_in_cut;
+        acc.sum_in_cut += dt_ns;
+    }
+
+    /// Mean in-cut Δt [ns] for @p global_index; false when the channel is
+    /// below the sample thresholds.
+    bool offset_ns(uint32_t global_index, float &offset) const;
+
+    /**
+     * @brief Push every channel that clears the thresholds into
+     *        `AlcorFinedata::set_param2` (offset converted to clock
+     *        cycles, sign flipped so it is subtracted from the hit time).
+     * @return Number of channels committed.
+     */
+    std::size_t commit() const;
+
+    std::size_t n_channels() const noexcept { return channels_.size(); }
+
+private:
+    struct Accumulator
+    {
+        int64_t n_total = 0;
+        int64_t n_in_cut = 0;
+        double sum_in_cut = 0.;
+    };
+
+    float outlier_cut_ns_;
+    int min_samples_;
+    std::unordered_map<uint32_t, Accumulator> channels_;
+};
+
+} // namespace btana::recodata
@@ -6,22 +6,17 @@
  *        parallel-dispatch path.
  *
  * `process_frame_pure` is the function dispatched to
- * `std::async(std::launch::async, ...)` from the recodata writer's
+ * the shared `util::TaskPool` (one task per worker slot) from the recodata writer's
  * per-spill loop.  Lifting it to a free function (from its previous
  * in-function `[&]`-captured lambda form) makes the parallel contract
- * **visible in the signature**: it reads `AlcorLightdata` (modulo
- * ROOT's non-const `link_to_tree`-style accessors) and a single
+ * **visible in the signature**: it reads an `AlcorLightdataView` and a single
  * `const FrameProcessContext &` that bundles the captured-once state
  * (configs + registry + ring-fit geometry).  Nothing the function
  * touches mutates shared state — the returned `FrameResult` is the
- * sole output, drained serially in frame order on the main thread.
- *
- * The drain side (`drain_frame_result`) remains an in-function lambda
- * in `recodata_writer.cxx`: extracting it would require a ~25-field
- * context struct (output tree, recodata wrapper, per-spill bookkeeping
- * vectors, ~10 trigger-side hists, all the per-ring `RingFillHists`
- * bundles); for a ~100-line sequential `hist->Fill()` list the
- * context-struct overhead exceeds the readability gain.
+ * sole output.  The writer appends it to the output tree in frame order
+ * on the main thread (as soon as the next-in-order frame is ready) and
+ * fills the histograms afterwards through per-shard clones — see
+ * `writers/recodata/drain_shards.h`.
  */
 
 #include "alcor_data.h"                    // TriggerNumber, HitMask
@@ -29,8 +24,12 @@
 #include "writers/recodata/ring_compute.h" // RingComputeContext
 #include "writers/recodata/types.h"        // FrameResult
 
+#include <cstddef>
+#include <vector>
+
 struct TriggerRegistry;
-class AlcorLightdata;
+struct AlcorLightdataStruct;
+class AlcorLightdataView;
 
 namespace btana::recodata
 {
@@ -52,6 +51,11 @@ struct FrameProcessContext
     /// Default 25 ns matches `BTANA_EDGE_REJECTION_NS`; override only
     /// when an analysis explicitly needs a different cut.
     float edge_rejection_ns = 25.f;
+
+    /// When true, `process_frame_pure` only flags ring candidates
+    /// (`FrameResult::ring_fit_pending`) and leaves the fits to
+    /// @ref fit_rings_batched.
+    bool defer_ring_fits = false;
 };
 
 /**
@@ -64,16 +68,36 @@ struct FrameProcessContext
  * serial drain.
  *
  * Mutates nothing in @p ctx; safe to call concurrently from
- * `std::async` worker threads.
+ * task-pool worker threads.
  *
- * @param lightdata Per-frame lightdata view.  ROOT-bound accessors
- *                  are non-const in the schema, but the function does
- *                  not modify the underlying data — only reads.
+ * @param lightdata Non-owning view of the frame (`AlcorLightdataView`,
+ *                  implicit from the spill's `AlcorLightdataStruct`) —
+ *                  no per-frame copy of the hit vectors.
  * @param ctx       Captured-once state (configs + registry + ring fit
  *                  geometry).  See @ref FrameProcessContext.
  * @return          Per-frame compute payload, drained serially.
  */
-FrameResult process_frame_pure(AlcorLightdata &lightdata,
+FrameResult process_frame_pure(AlcorLightdataView lightdata,
                                const FrameProcessContext &ctx);
 
+/**
+ * @brief Fit every pending ring of a spill in a few large batches.
+ *
+ * Gathers the tagged ring hits of every frame with
+ * `FrameResult::ring_fit_pending` into @p n_batches contiguous
+ * @ref RingFitBatch buffers (one per worker), fits them concurrently and
+ * writes `first` / `second` / `frame_has_second_ring` back into
+ * @p results.  Each ring's result is independent of the batching, so the
+ * output matches the per-frame path for any @p n_batches.
+ *
+ * @param frames   The spill's lightdata frames (parallel to @p results).
+ * @param results  Per-frame compute payloads from `process_frame_pure`.
+ * @param ctx      Same context the per-frame pass used.
+ * @param n_batches Number of batches / worker threads (≥ 1).
+ */
+void fit_rings_batched(const std::vector<AlcorLightdataStruct> &frames,
+                       std::vector<FrameResult> &results,
+                       const FrameProcessContext &ctx,
+                       std::size_t n_batches);
+
 } // namespace btana::recodata
@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * @file ring_batch.h
+ * @brief Structure-of-arrays ring-fit engine shared by the single-ring
+ *        helpers and the per-spill batched path of the recodata writer.
+ *
+ * A batch holds the candidate hits of many rings back to back in flat
+ * float arrays (pixel-centre x/y + the smeared x/y siblings), with one
+ * offset per ring.  @ref RingFitBatch::fit then runs in two sweeps:
+ *
+ *  1. **Moments** — for every ring, the ten Taubin moment sums
+ *     (`util::circle_fit::CircleMoments`) over its contiguous hit range.
+ *     The inner loop is split into @ref RingFitBatch::kLanes independent
+ *     partial sums so the compiler can keep them in vector registers
+ *     without `-ffast-math` reassociation; the lane order is fixed, so the
+ *     result does not depend on how rings were grouped into batches.
+ *  2. **Per-ring finish** — O(1) Taubin solve from the moments, the
+ *     seed / long-arc decision (refinement only where the arc constrains
+ *     it), radial residuals, azimuthal coverage, and the leave-one-out
+ *     residuals as rank-one downdates of the same moments.
+ *
+ * `compute_ring_fit_tagged` / `compute_ring_fit_timewindow` are batches
+ * of one; @ref fit_rings_batched in `frame_pipeline.h` feeds a whole
+ * spill through a handful of batches.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "writers/recodata/types.h" // RingFitResult
+
+namespace btana::recodata
+{
+
+struct RingComputeContext;
+
+/**
+ * @brief Flat hit buffers for a set of ring candidates.
+ *
+ * Reusable: @ref clear keeps the capacity, so one batch per worker
+ * amortises the allocations across a spill.
+ */
+class RingFitBatch
+{
+public:
+    /// Partial-sum lanes in the moment sweep (one AVX2 double register).
+    static constexpr std::size_t kLanes = 4;
+
+    /// Drop every ring, keeping the buffer capacity.
+    void clear();
+
+    /**
+     * @brief Open a new ring; subsequent @ref add_hit calls belong to it.
+     *
+     * @param seed_cx,seed_cy,seed_R  Finder seed; `seed_R <= 0` selects the
+     *        seedless path (free Taubin + arc-span guard).
+     * @return Ring slot index, the position of its result in @ref fit.
+     */
+    std::size_t begin_ring(float seed_cx = 0.f, float seed_cy = 0.f, float seed_R = 0.f);
+
+    /// Append one hit (pixel-centre + smeared position) to the open ring.
+    void add_hit(float x, float y, float x_smeared, float y_smeared)
+    {
+        x_.push_back(x);
+        y_.push_back(y);
+        xs_.push_back(x_smeared);
+        ys_.push_back(y_smeared);
+    }
+
+    std::size_t n_rings() const noexcept { return seed_R_.size(); }
+    std::size_t n_hits() const noexcept { return x_.size(); }
+
+    /**
+     * @brief Fit every ring in the batch.
+     *
+     * @param do_loo  Compute the per-hit leave-one-out residuals.
+     * @param ctx     Geometry + config bundle.
+     * @return One @ref RingFitResult per ring, in @ref begin_ring order.
+     */
+    std::vector<RingFitResult> fit(bool do_loo, const RingComputeContext &ctx) const;
+
+private:
+    //  SoA hit storage; ring r owns [begin_[r], begin_[r + 1]).
+    std::vector<float> x_, y_, xs_, ys_;
+    std::vector<uint32_t> begin_;
+    std::vector<float> seed_cx_, seed_cy_, seed_R_;
+
+    std::size_t ring_end(std::size_t r) const
+    {
+        return r + 1 < begin_.size() ? begin_[r + 1] : x_.size();
+    }
+};
+
+} // namespace btana::recodata
@@ -25,9 +25,11 @@
 
 #include "alcor_data.h"             // HitMask
 #include "writers/recodata/types.h" // RingFitResult, RingFillHists
+#include "writers/recodata/ring_batch.h" // RingFitBatch
 #include "utility/config_reader.h"  // RecodataConfigStruct
+#include "utility/radiator_efficiency.h" // ChannelGridIndex
 
-class AlcorLightdata;
+class AlcorLightdataView;
 
 namespace btana::recodata
 {
@@ -51,6 +53,11 @@ struct RingComputeContext
     /// Recodata-side config (per-ring photon counting + coverage
     /// thresholds, plus the QA-mode `skip_loo_residuals` knob).
     const RecodataConfigStruct &cfg;
+
+    /// Optional grid index over @ref index_to_hit_xy.  When set, the
+    /// per-ring coverage visits only channels near the ring annulus and
+    /// is memoised per batch on `cfg.coverage_cache_quantum_mm`.
+    const util::radiator_efficiency::ChannelGridIndex *coverage_index = nullptr;
 };
 
 /**
@@ -72,15 +79,16 @@ struct RingComputeContext
  * @param t_ref_ns  Hardware-trigger reference time [ns].
  * @param dt_min_ns Lower edge of the acceptance window [ns] (rel. to ref).
  * @param dt_max_ns Upper edge of the acceptance window [ns] (rel. to ref).
- * @param do_loo    When true, run the per-hit leave-one-out fit loop
- *                  (~N extra fit_circle calls).  Gated by the QA path's
+ * @param do_loo    When true, compute the per-hit leave-one-out residuals
+ *                  (one moment accumulation + N O(1) downdated solves, see
+ *                  `util::circle_fit::leave_one_out`).  Gated by the QA path's
  *                  `skip_loo_residuals` knob upstream.
  * @param ctx       Geometry + config bundle.
  */
 RingFitResult compute_ring_fit_timewindow(float t_ref_ns,
                                           float dt_min_ns,
                                           float dt_max_ns,
-                                          AlcorLightdata &lightdata,
+                                          AlcorLightdataView lightdata,
                                           bool do_loo,
                                           const RingComputeContext &ctx);
 
@@ -100,10 +108,30 @@ RingFitResult compute_ring_fit_timewindow(float t_ref_ns,
  * @param ctx       Geometry + config bundle.
  */
 RingFitResult compute_ring_fit_tagged(HitMask ring_tag,
-                                      AlcorLightdata &lightdata,
+                                      AlcorLightdataView lightdata,
                                       bool do_loo,
                                       const RingComputeContext &ctx);
 
+/**
+ * @brief Append the time-window hit selection of @p lightdata to @p batch
+ *        as one seedless ring (same cut as @ref compute_ring_fit_timewindow).
+ */
+void collect_ring_hits_timewindow(float t_ref_ns,
+                                  float dt_min_ns,
+                                  float dt_max_ns,
+                                  AlcorLightdataView lightdata,
+                                  RingFitBatch &batch);
+
+/**
+ * @brief Append the @p ring_tag hits of @p lightdata to @p batch as one ring,
+ *        seeded from the frame's RANSAC geometry (same selection as
+ *        @ref compute_ring_fit_tagged).  An empty ring is still opened so
+ *        result slots stay aligned with the caller's bookkeeping.
+ */
+void collect_ring_hits_tagged(HitMask ring_tag,
+                              AlcorLightdataView lightdata,
+                              RingFitBatch &batch);
+
 /**
  * @brief Drain helper: replay the histogram fills implied by a
  *        precomputed @ref RingFitResult into the @p h target bundle.
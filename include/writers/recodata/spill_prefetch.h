@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file spill_prefetch.h
+ * @brief Background spill reader for the recodata writer.
+ *
+ * A single reader thread runs the caller's loader (`TTree::GetEntry`,
+ * trigger overlay, dead-lane decode) for spill N+1 … N+depth while the
+ * main thread computes and drains spill N.  The input tree is touched by
+ * the reader thread only, so no locking around ROOT I/O is needed beyond
+ * `ROOT::EnableThreadSafety()`.
+ *
+ * Buffers are recycled: @ref SpillPrefetcher::next swaps the loaded spill
+ * into the caller's @ref PrefetchedSpill and hands the caller's previous
+ * buffers back to the reader, so the steady state allocates nothing.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "alcor_lightdata.h" // AlcorLightdataStruct
+
+namespace btana::recodata
+{
+
+/// One spill as the recodata loop consumes it.
+struct PrefetchedSpill
+{
+    int i_spill = -1;
+    std::vector<AlcorLightdataStruct> frames;
+    std::vector<uint32_t> frame_reference;
+    /// `AlcorSpilldata::get_not_dead_participants()` of the spill.
+    std::map<uint32_t, std::vector<uint8_t>> lanes_participating;
+};
+
+class SpillPrefetcher
+{
+public:
+    /// Fill @p slot with spill @p i_spill.  Runs on the reader thread;
+    /// @p slot holds recycled buffers from an earlier spill.
+    using Loader = std::function<void(int i_spill, PrefetchedSpill &slot)>;
+
+    /**
+     * @param n_spills  Spills [0, n_spills) are loaded in order.
+     * @param loader    See @ref Loader.
+     * @param depth     Spills read ahead of the consumer (≥ 1).
+     */
+    SpillPrefetcher(int n_spills, Loader loader, std::size_t depth = 1);
+    ~SpillPrefetcher();
+
+    SpillPrefetcher(const SpillPrefetcher &) = delete;
+    SpillPrefetcher &operator=(const SpillPrefetcher &) = delete;
+
+    /**
+     * @brief Block until the next spill is loaded and swap it into @p spill.
+     * @return false once every spill has been handed out.  A loader
+     *         exception is rethrown here.
+     */
+    bool next(PrefetchedSpill &spill);
+
+private:
+    void run();
+
+    const int n_spills_;
+    Loader loader_;
+    std::vector<PrefetchedSpill> slots_;
+    std::size_t head_ = 0;  ///< Next slot the consumer takes.
+    std::size_t n_ready_ = 0;
+    int n_loaded_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread reader_;
+};
+
+} // namespace btana::recodata
@@ -17,9 +17,12 @@
  *   per-frame compute (parallel)
  *       │  produces FrameResult { RingFitResult first, second, ... }
  *       ▼
- *   per-frame drain     (serial, in frame order)
+ *   tree append         (main thread, in frame order, overlapped
+ *       │                    with compute)
+ *   histogram drain     (parallel, fixed per-shard frame chunks)
  *       │  reads FrameResult + writes via RingFillHists into the
- *       │  per-ring output histogram bundle
+ *       │  shard's per-ring histogram bundle; shards merged after
+ *       │  the spill loop
  *       ▼
  *   finalize-QA         (single-threaded post-loop)
  */
@@ -86,8 +89,8 @@ struct RingFitResult
 };
 
 // ─────────────────────────────────────────────────────────────────────
-//  Per-frame compute output — drained in frame order on a single
-//  thread
+//  Per-frame compute output — appended to the tree in frame order,
+//  histogram fills replayed by the sharded drain
 // ─────────────────────────────────────────────────────────────────────
 struct FrameResult
 {
@@ -107,6 +110,7 @@ struct FrameResult
     std::vector<std::pair<uint8_t, float>> time_diff_fills;
 
     std::map<uint8_t, TriggerEvent> accepted_triggers;
+    TriggerMask accepted_mask = 0; ///< trigger_mask_of(accepted_triggers), kept as they are accepted
     bool frame_is_physics = false; ///< increments n_physics_per_spill
     bool frame_has_second_ring = false;
 
@@ -117,6 +121,11 @@ struct FrameResult
     //  ring-hit map (decoupled from the ring finder; see process_frame_pure).
     std::vector<std::array<float, 2>> occupancy_xy;
 
+    //  Set instead of `first` / `second` when the frame carries RANSAC-
+    //  tagged hits but `FrameProcessContext::defer_ring_fits` is on — the
+    //  spill-level `fit_rings_batched` fills the two slots afterwards.
+    bool ring_fit_pending = false;
+
     RingFitResult first;
     RingFitResult second;
 };
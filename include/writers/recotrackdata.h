@@ -5,7 +5,8 @@
  * @brief Entry point for building track-matched reconstructed-data ROOT files.
  *
  * Provides @ref recotrackdata_writer, which joins an existing recodata TTree
- * with ALTAI telescope tracks and writes a recotrackdata TTree.
+ * with ALTAI telescope tracks and writes a recotrackdata TTree.  Frames are
+ * paired with ALTAI events by timestamp, spill by spill.
  */
 
 #include <string>
@@ -35,6 +36,23 @@
  * @param force_rebuild          If @c true, overwrite any existing recotrackdata file.
  * @param force_upstream         If @c true, also rebuild every upstream
  *                               writer (recodata, then lightdata).
+ * @param end_to_end             If @c true, rebuild recodata (and, when
+ *                               needed or forced, lightdata) in this
+ *                               process and hand frames over in memory
+ *                               instead of reading recodata.root back.
+ *                               Both upstream files are still written.
+ *                               See `writers/cascade.h`.
+ * @param altai_tick_ns          ns per ALTAI timestamp unit.  Required for
+ *                               timestamp matching (the unit is not
+ *                               recorded in the track files); −1 = unknown,
+ *                               falls back to counter matching.
+ * @param match_tolerance_ns     Largest frame ↔ ALTAI time residual accepted
+ *                               as a match; −1 keeps the matcher default.
+ *                               See `writers/recotrackdata/track_matching.h`.
+ * @param framer_conf            Framer conf for the frame length when
+ *                               recodata.root carries no `Config/frame_size`,
+ *                               and for the in-process recodata of
+ *                               @p end_to_end / cascade rebuilds.
  */
 void recotrackdata_writer(
     std::string data_repository,
@@ -43,4 +61,8 @@ void recotrackdata_writer(
     std::string track_run_name,
     int max_frames = 10000000,
     bool force_rebuild = false,
-    bool force_upstream = false);
+    bool force_upstream = false,
+    bool end_to_end = false,
+    double altai_tick_ns = -1.,
+    double match_tolerance_ns = -1.,
+    std::string framer_conf = "conf/framer_conf.toml");
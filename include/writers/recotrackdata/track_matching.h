@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file track_matching.h
+ * @brief Timestamp alignment of recodata tracking-trigger frames with
+ *        ALTAI telescope events, one spill at a time.
+ *
+ * The DAQ and the telescope run on separate clocks.  Inside a spill the
+ * two differ by an offset that is unknown up front and drifts slowly, so
+ * a frame is paired with an ALTAI event when their times agree within
+ * `tolerance_ns` after the running offset is applied.  A dropped trigger
+ * on either side leaves one entry unmatched; the pairing of the rest is
+ * unaffected.  The old running counter (n-th trigger-0 frame ↔ ALTAI
+ * event n) had no way to recover from a drop.
+ *
+ * Per spill (@ref match_spill):
+ *   1. **Anchor.**  Each pairing of one of the first `anchor_window`
+ *      frames with one of the first `anchor_window` ALTAI events is a
+ *      candidate offset.  The candidate that pairs the most entries wins.
+ *   2. **Merge.**  Both sides are walked in time order.  A pair within
+ *      tolerance is matched and a `drift_gain` fraction of its residual
+ *      is folded into the offset.  Otherwise the earlier entry is left
+ *      unmatched.
+ *
+ * ALTAI events carry no spill marker.  @ref split_altai_spills cuts the
+ * event list wherever consecutive timestamps are more than `spill_gap_ns`
+ * apart.  @ref pair_altai_spill pairs the n-th cut with the n-th recodata
+ * spill, but only after checking that their durations and entry counts
+ * agree; a missed or extra gap is re-aligned instead of shifting every
+ * later spill.
+ *
+ * Everything here is plain data, with no ROOT.  Spills are independent,
+ * so the writer runs one @ref match_spill per spill on the task pool.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+class TrackingAltai;
+
+namespace btana::recotrackdata
+{
+
+/// Knobs of the timestamp matcher.  The defaults suit the SPS test beam.
+struct TrackMatchConfig
+{
+    /// ns per unit of `TrackingAltaiStruct::timestamp`.  No default: the
+    /// telescope's timestamp unit is not documented with the track files,
+    /// so timestamp matching needs it stated (`--altai-tick-ns`).
+    /// 0 = unknown.
+    double altai_tick_ns = 0.;
+    double tolerance_ns = 500.;    ///< Largest |residual| of an accepted pair.
+    double drift_gain = 0.2;       ///< Fraction of each residual folded into the offset.
+    double spill_gap_ns = 1.e9;    ///< ALTAI timestamp gap that starts a new spill.
+    std::size_t anchor_window = 8; ///< Entries per side tried as the offset anchor.
+
+    double spill_duration_tolerance = 0.1; ///< Largest relative duration difference of paired spills.
+    double spill_count_ratio = 0.5;        ///< Smallest fewer/more entry-count ratio of paired spills.
+    int max_spill_shift = 2;               ///< Largest re-alignment tried when a pairing disagrees.
+};
+
+/// ALTAI events of one spill, in time order.
+struct AltaiSpill
+{
+    std::vector<uint32_t> event_ids;
+    std::vector<double> times_ns; ///< Parallel to @c event_ids.
+};
+
+/**
+ * @brief Cut the tracked ALTAI events of @p tracking into spills.
+ *
+ * Events without tracks (`*` lines) carry no timestamp and are skipped.
+ */
+std::vector<AltaiSpill> split_altai_spills(const TrackingAltai &tracking,
+                                           const TrackMatchConfig &cfg);
+
+/**
+ * @brief Pick the ALTAI spill for recodata spill @p i_spill.
+ *
+ * The candidate is `altai_spills[i_spill + shift]`.  It is accepted when
+ * the spill durations agree within `spill_duration_tolerance` (plus twice
+ * `tolerance_ns`) and the entry counts within `spill_count_ratio`.
+ * Otherwise shifts of up to `max_spill_shift` either way are tried,
+ * nearest first.  The first consistent one is written back to @p shift and
+ * kept for the later spills.  A spill with fewer than two frames has no
+ * duration to compare and takes the current shift unchecked.
+ *
+ * @param frame_ns  Spill-relative frame times [ns], any order.
+ * @param shift     Running re-alignment, carried between calls (start at 0).
+ * @return Index into @p altai_spills, or -1 when no consistent candidate
+ *         exists (the spill is left unmatched).
+ */
+int pair_altai_spill(std::span<const double> frame_ns,
+                     int i_spill,
+                     std::span<const AltaiSpill> altai_spills,
+                     int &shift,
+                     const TrackMatchConfig &cfg);
+
+/// Outcome of @ref match_spill.
+struct SpillMatch
+{
+    static constexpr uint32_t kUnmatched = std::numeric_limits<uint32_t>::max();
+
+    /// Per frame (input order): matched ALTAI event ID, or @ref kUnmatched.
+    std::vector<uint32_t> event_ids;
+    /// `t_altai − (t_frame + offset)` [ns] of each matched pair, in time order.
+    std::vector<float> residuals_ns;
+    double offset_ns = 0.; ///< Offset after the last match.
+    double drift_ns = 0.;  ///< Offset after the last match minus the anchor offset.
+    std::size_t n_matched = 0;
+    std::size_t n_frames_unmatched = 0;
+    std::size_t n_events_unmatched = 0;
+};
+
+/**
+ * @brief Pair the tracking-trigger frames of one spill with its ALTAI events.
+ * @param frame_ns  Spill-relative time of each frame's tracking trigger
+ *                  [ns], in any order.
+ * @param altai     The spill's ALTAI events.
+ */
+SpillMatch match_spill(std::span<const double> frame_ns,
+                       const AltaiSpill &altai,
+                       const TrackMatchConfig &cfg);
+
+} // namespace btana::recotrackdata
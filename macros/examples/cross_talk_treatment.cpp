@@ -2,6 +2,7 @@
 #include "utility/root_io.h"
 #include "utility/root_hist.h"
 #include "utility/config_reader.h"
+#include "utility/cross_talk_pairs.h"
 #include <mist/logger/logger.h>
 
 /**
@@ -101,6 +102,8 @@ void cross_talk_treatment(std::string data_repository, std::string run_name,
                                  ";#Delta channel (j #minus i);#Delta_{t} (cc)",
                                  65, -32.5, 32.5,
                                  26, -5.5, 20.5);
+    //  Upper Δt edge of h_dchannel_dt [ns]; later pairs would only land in its overflow.
+    const float dchannel_dt_hi = 20.5f * BTANA_ALCOR_CC_TO_NS;
 
     //  Per-channel corrected CT probability (filled once per primary Hit)
     RootHist<TProfile> h_phys_ct_corr("h_phys_ct_corrected_per_channel",
@@ -109,7 +112,12 @@ void cross_talk_treatment(std::string data_repository, std::string run_name,
                                       ";global channel;Corrected electrical CT probability (%)", 2048, 0, 2048);
 
     //  ── Loop ─────────────────────────────────────────────────────────────────
+    //  Neighbour pairs come from the pair finder: per primary, only the hits
+    //  on its physical / electrical neighbour channels are visited, instead
+    //  of every hit of the frame.  Afterpulse hits never enter it.
     long long n_primary = 0;
+    util::cross_talk::PairFinder ct_pairs(phys_radius_mm);
+    std::vector<int> hit_of_pair; //  pair-finder index → recodata hit index
 
     for (int i_frame = 0; i_frame < all_frames; ++i_frame)
     {
@@ -121,71 +129,64 @@ void cross_talk_treatment(std::string data_repository, std::string run_name,
         if (!trigger)
             continue;
 
-        const int nhits = (int)recodata->get_recodata().size();
-
-        for (int i = 0; i < nhits; ++i)
+        ct_pairs.clear();
+        hit_of_pair.clear();
+        for (int i = 0; i < (int)recodata->get_recodata().size(); ++i)
         {
             if (recodata->is_afterpulse(i))
                 continue;
+            // Phase 5: the explicit dense channel-ordinal accessor replaces the
+            // lazy `legacy_raw / 4` strip-TDC pattern.  Bit-exact with the
+            // legacy value for the current detector.
+            ct_pairs.add(recodata->get_hit_t(i),
+                         {static_cast<uint32_t>(recodata->get_global_channel_index(i)),
+                          recodata->get_device(i), recodata->get_fifo(i),
+                          recodata->get_hit_x(i), recodata->get_hit_y(i)});
+            hit_of_pair.push_back(i);
+        }
+        ct_pairs.prepare();
 
-            const float ti = recodata->get_hit_t(i);
+        for (std::size_t ip = 0; ip < ct_pairs.size(); ++ip)
+        {
+            const int i = hit_of_pair[ip];
             const float xi = recodata->get_hit_x(i);
-            const float yi = recodata->get_hit_y(i);
-            const int dev_i = recodata->get_device(i);
-            const int fifo_i = recodata->get_fifo(i);
-            // Phase 5: replace the lazy `legacy_raw / 4` strip-TDC pattern
-            // with the explicit dense channel-ordinal accessor.  Bit-exact
-            // with the legacy value for the current detector.
-            const int chan_i = recodata->get_global_channel_index(i);
+            const int chan_i = ct_pairs.channel(ip);
             ++n_primary;
 
             //  Per-primary-Hit counts in signal and sideband windows
             int n_phys_near = 0, n_phys_far = 0;
             int n_elec_near = 0, n_elec_far = 0;
 
-            for (int j = 0; j < nhits; ++j)
-            {
-                if (j == i)
-                    continue;
-                if (recodata->is_afterpulse(j))
-                    continue;
-
-                const float dt = recodata->get_hit_t(j) - ti;
-                if (dt < elec_dt_lo || dt >= dt_max)
-                    continue;
-
-                const float xj = recodata->get_hit_x(j);
-                const float yj = recodata->get_hit_y(j);
-
-                //  Physical CT: causal only (dt >= 0)
-                const bool is_phys = dt >= 0.f &&
-                                     xi > -990.f && xj > -990.f &&
-                                     std::hypot(xj - xi, yj - yi) <= phys_radius_mm;
-                const bool is_elec = recodata->get_device(j) == dev_i &&
-                                     recodata->get_fifo(j) == fifo_i;
-
-                if (is_phys)
-                    h_phys_dt->Fill(dt);
-                if (is_elec)
-                    h_elec_dt->Fill(dt);
-                const int dchan = recodata->get_global_channel_index(j) -
-                                  recodata->get_global_channel_index(i);
-                h_dchannel_dt->Fill(dchan, dt / BTANA_ALCOR_CC_TO_NS);
-
-                //  Accumulate per-Hit signal and sideband counts
-                if (dt >= phys_ct_lo_ns && dt < phys_ct_hi_ns)
+            ct_pairs.for_each_neighbour(
+                ip, elec_dt_lo, dt_max,
+                [&](std::size_t, double dt, uint8_t relation)
+                {
+                    //  Physical CT: causal only (dt >= 0)
+                    const bool is_phys = dt >= 0. && (relation & util::cross_talk::RelationPhysical);
+                    const bool is_elec = relation & util::cross_talk::RelationElectrical;
+
                     if (is_phys)
-                        ++n_phys_near;
-                if (dt >= elec_ct_lo_ns && dt < elec_ct_hi_ns)
+                        h_phys_dt->Fill(dt);
                     if (is_elec)
+                        h_elec_dt->Fill(dt);
+
+                    //  Accumulate per-Hit signal and sideband counts
+                    if (is_phys && dt >= phys_ct_lo_ns && dt < phys_ct_hi_ns)
+                        ++n_phys_near;
+                    if (is_elec && dt >= elec_ct_lo_ns && dt < elec_ct_hi_ns)
                         ++n_elec_near;
-                if (dt >= sideband_lo_ns && dt < phys_sideband_hi_ns)
-                    if (is_phys)
+                    if (is_phys && dt >= sideband_lo_ns && dt < phys_sideband_hi_ns)
                         ++n_phys_far;
-                if (dt >= sideband_lo_ns && dt < elec_sideband_hi_ns)
-                    if (is_elec)
+                    if (is_elec && dt >= sideband_lo_ns && dt < elec_sideband_hi_ns)
                         ++n_elec_far;
-            }
+                });
+
+            //  (Δchannel, Δt) for every pair inside the histogram's Δt range,
+            //  any channel: a sliding window over the time-sorted hits.
+            ct_pairs.for_each_in_window(
+                ip, elec_dt_lo, dchannel_dt_hi,
+                [&](std::size_t jp, double dt)
+                { h_dchannel_dt->Fill((int)ct_pairs.channel(jp) - chan_i, dt / BTANA_ALCOR_CC_TO_NS); });
 
             //  Smeared hitmaps: weight = n_ct_neighbours × 100 per primary Hit.
             //  Statistical content matches the previous N×100 unit-Fill loop
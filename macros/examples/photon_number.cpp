@@ -245,7 +245,7 @@ void photon_number(std::string data_repository, std::string run_name,
         if ((int)pts.size() > 4)
         {
             float r0 = r_sum / pts.size();
-            auto res = fit_circle(pts, {0.f, 0.f, r0}, false, {{}});
+            auto res = fit_circle(pts, {0.f, 0.f, r0}, false);
             h_fit_x->Fill(res[0][0]);
             h_fit_y->Fill(res[1][0]);
             h_fit_r->Fill(res[2][0]);
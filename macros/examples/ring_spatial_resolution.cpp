@@ -144,7 +144,7 @@ void ring_spatial_resolution(std::string data_repository, std::string run_name,
                 //  Fitting the points
                 //  fit_result = {{center_x_value,center_x_error}, {center_y_value,center_y_error}, {radius_value,radius_error}}
                 //                fit_circle(points to fit,  starting values for the fit,  let X-Y free,  do not exclude any points)
-                auto fit_result = fit_circle(selected_points, {0., 0., avg_radius / selected_points.size()}, false, {{}});
+                auto fit_result = fit_circle(selected_points, {0., 0., avg_radius / selected_points.size()}, false);
 
                 //  Save results for later QA
                 h_first_round_X->Fill(fit_result[0][0]);
@@ -196,7 +196,7 @@ void ring_spatial_resolution(std::string data_repository, std::string run_name,
         //  Work on second round of selected points
 
         //  Fitting the points
-        auto fit_result = fit_circle(selected_points, {(float)found_ring_center_x, (float)found_ring_center_y, (float)found_ring_radius}, true, {{}});
+        auto fit_result = fit_circle(selected_points, {(float)found_ring_center_x, (float)found_ring_center_y, (float)found_ring_radius}, true);
 
         //  R vs Ngamma for resolution estimation
         h_second_round_R_Ngamma->Fill(fit_result[2][0], selected_points.size());
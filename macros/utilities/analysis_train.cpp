@@ -0,0 +1,99 @@
+/**
+ * @file macros/utilities/analysis_train.cpp
+ * @brief `analysis_train` — thin CLI front-end around
+ *        @ref btana::analysis::run_train.
+ *
+ * Usage:
+ *   analysis_train <data_repository> <run_name>
+ *   analysis_train <data_repository> <run_name> --tasks afterpulse,cross_talk
+ *   analysis_train <data_repository> <run_name> --input recotrackdata
+ *   analysis_train <data_repository> <run_name> --max-frames 100000 --threads 8
+ *
+ * Reads `<repo>/<run>/recodata.root` (or `recotrackdata.root`) once and
+ * runs every selected task on it; results go to
+ * `<repo>/standard_results.toml`, histograms to
+ * `<repo>/<run>/analysis_train.root` (one directory per task).
+ *
+ * The default task list is every registered task except
+ * `ring_resolution_tracked`, which needs recotrackdata and is added when
+ * `--input recotrackdata` is given.
+ */
+
+#include "analysis/train.h"
+#include "utility/config_reader.h"
+#include "utility/task_pool.h"
+
+#include <CLI/CLI.hpp>
+#include <TROOT.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    CLI::App app{"analysis_train — run the standard post-run analyses in one pass over a run"};
+
+    std::string data_repository;
+    std::string run_name;
+    std::vector<std::string> task_names;
+    std::string input;
+    long max_frames = -1;
+    std::string readout_config_file = "conf/readout_config.toml";
+    std::string framer_config_file = "conf/framer_conf.toml";
+    std::string output_file;
+    //  Size of the process-wide task pool (train slots).  -1 = all cores.
+    int n_threads = -1;
+
+    app.add_option("data_repository", data_repository, "Data repository holding the run directories")
+        ->required()
+        ->check(CLI::ExistingDirectory);
+    app.add_option("run_name", run_name, "Run directory name")->required();
+    app.add_option("--tasks", task_names, "Tasks to run (comma-separated); default: all for the input")
+        ->delimiter(',');
+    app.add_option("--input", input, "Input tree; default recotrackdata if a chosen task needs tracks")
+        ->check(CLI::IsMember({"recodata", "recotrackdata"}));
+    app.add_option("--max-frames", max_frames, "Cap on entries read; -1 = all");
+    app.add_option("--readout-conf", readout_config_file, "Readout configuration (SiPM model per device)");
+    app.add_option("--framer-conf", framer_config_file, "Framer configuration (its [qa] table)");
+    app.add_option("-o,--output", output_file, "Histogram output file; default <repo>/<run>/analysis_train.root");
+    app.add_option("--threads", n_threads, "Size of the shared task pool; -1 = all cores");
+
+    CLI11_PARSE(app, argc, argv);
+    util::TaskPool::configure(n_threads);
+    gROOT->SetBatch(kTRUE);
+
+    if (task_names.empty())
+        for (const auto &name : btana::analysis::train_task_names())
+            if (name != "ring_resolution_tracked" || input == "recotrackdata")
+                task_names.push_back(name);
+
+    btana::analysis::TrainContext ctx;
+    ctx.data_repository = data_repository;
+    ctx.run_name = run_name;
+    ctx.readout_config = ReadoutConfigList(readout_config_reader(readout_config_file));
+    ctx.cherenkov = ctx.readout_config.find_by_name("cherenkov");
+    ctx.qa_config = qa_conf_reader(framer_config_file);
+
+    std::vector<std::unique_ptr<btana::analysis::AnalysisTask>> tasks;
+    for (const auto &name : task_names)
+    {
+        auto task = btana::analysis::make_train_task(name, ctx);
+        if (!task)
+        {
+            std::cerr << "analysis_train: unknown task '" << name << "'\n";
+            return 2;
+        }
+        tasks.push_back(std::move(task));
+    }
+
+    btana::analysis::TrainOptions options;
+    if (input == "recodata")
+        options.input = btana::analysis::TrainInput::Recodata;
+    else if (input == "recotrackdata")
+        options.input = btana::analysis::TrainInput::Recotrackdata;
+    options.max_frames = max_frames;
+    options.output_file = output_file;
+    return btana::analysis::run_train(ctx, tasks, options);
+}
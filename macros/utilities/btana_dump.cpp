@@ -7,6 +7,14 @@
  *   btana-dump <file.root>            (prints first 5 entries)
  *   btana-dump <file.root> -n 20      (prints first 20 entries)
  *   btana-dump <file.root> -n -1      (prints every entry)
+ *   btana-dump <file.root> --stats    (whole-file summary, all cores)
+ *   btana-dump <file.root> --stats --threads 8
+ *   btana-dump <file.root> --spill 40 --frame 123456
+ *   btana-dump <file.root> --trigger RANSAC_RING_FOUND -n 10
+ *
+ * The selectors (`--spill`, `--frame`, `--trigger`, combined with AND)
+ * print the first `-n` matching frames via the cached entry index
+ * `<file.root>.btidx`, built on first use.
  *
  * The format (lightdata / recodata / recotrackdata) is auto-detected
  * from the tree names present in the file; no flag selects between
@@ -15,11 +23,13 @@
  */
 
 #include "utilities/btana_dump.h"
+#include "utility/task_pool.h"
 
 #include <CLI/CLI.hpp>
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 int main(int argc, char **argv)
 {
@@ -27,14 +37,54 @@ int main(int argc, char **argv)
 
     std::string file_path;
     long n_entries = 5;
+    bool stats = false;
+    //  Size of the process-wide task pool (--stats readers).  -1 = all cores.
+    int n_threads = -1;
+    //  Selectors; -1 = unset.
+    long spill = -1;
+    long frame_id = -1;
+    std::vector<std::string> triggers;
 
     app.add_option("file", file_path, "Path to a beam-test ROOT file")
         ->required()
         ->check(CLI::ExistingFile);
     app.add_option("-n,--entries", n_entries,
-                   "Number of entries to print (use -1 for every entry; default 5)");
+                   "Number of entries (with a selector: frames) to print; -1 = all, default 5");
+    app.add_flag("--stats", stats,
+                 "Scan every entry and print per-spill / per-channel hit counts, "
+                 "trigger census, mask bits, ring multiplicities and time ranges");
+    app.add_option("--threads", n_threads,
+                   "Size of the shared task pool for --stats; -1 = all cores");
+    app.add_option("--spill", spill, "Print only frames of this spill (0-based, file order)");
+    app.add_option("--frame", frame_id, "Print only frames with this framer frame ID");
+    app.add_option("--trigger", triggers,
+                   "Print only frames in which this trigger fired: a built-in name "
+                   "(e.g. RANSAC_RING_FOUND) or an index; repeat for any-of");
 
     CLI11_PARSE(app, argc, argv);
+    util::TaskPool::configure(n_threads);
+
+    if (stats)
+        return btana::utilities::stats_file(file_path);
 
+    if (spill >= 0 || frame_id >= 0 || !triggers.empty())
+    {
+        btana::utilities::DumpSelection sel;
+        if (spill >= 0)
+            sel.spill = static_cast<uint32_t>(spill);
+        if (frame_id >= 0)
+            sel.frame_id = static_cast<uint32_t>(frame_id);
+        for (const auto &name : triggers)
+        {
+            uint8_t index = 0;
+            if (!btana::utilities::parse_trigger(name, index))
+            {
+                std::cerr << "btana-dump: unknown trigger '" << name << "'\n";
+                return 2;
+            }
+            sel.triggers.push_back(index);
+        }
+        return btana::utilities::dump_selected(file_path, sel, n_entries);
+    }
     return btana::utilities::dump_file(file_path, n_entries);
 }
@@ -2,6 +2,7 @@
 #include <mist/logger/logger.h>
 #include "utility/config_reader.h"
 #include "utility/conf_path.h"
+#include "utility/task_pool.h"
 #include "utility.h"
 #include <stdio.h>
 #include <chrono>
@@ -27,6 +28,7 @@ int main(int argc, char **argv)
     bool force_rebuild = false;
     bool qa_mode = false;
     bool skip_stream_qa = false;
+    bool retrigger = false;
     int n_requested_threads = -1;
     //  Config-file paths are resolved AFTER CLI parsing: if the user
     //  did not pass an explicit --xxx-conf, the path falls through to
@@ -69,7 +71,8 @@ int main(int argc, char **argv)
     app.add_option("run_name", run_name)->required();
     app.add_option("--run-list", RunList, "Name of run list (required if run_name is a .toml runlist)");
     app.add_option("--max-spill", max_spill);
-    app.add_option("--threads", n_requested_threads);
+    app.add_option("--threads", n_requested_threads,
+                   "Size of the shared task pool (framer + PASS A); -1 = all cores");
     auto *p_trigger = app.add_option("--trigger-conf", trigger_config_file);
     auto *p_readout = app.add_option("--readout-conf", readout_config_file);
     auto *p_mapping = app.add_option("--Mapping-conf", mapping_config_file);
@@ -111,6 +114,13 @@ int main(int argc, char **argv)
                  "RANSAC / timing / DCR / trigger QA is produced; hit positions "
                  "are unassigned.  Pair with --force-rebuild to rebuild an "
                  "existing file.");
+    //  Trigger-tuning path: re-run only the streaming score + RANSAC over an
+    //  existing lightdata.root and write the lightdata_triggers.root friend
+    //  tree (include/writers/lightdata/trigger_overlay.h).  No raw decode.
+    app.add_flag("--retrigger", retrigger,
+                 "Re-run only the software-trigger stages on an existing "
+                 "lightdata.root and write lightdata_triggers.root (picked up "
+                 "by recodata_writer).  Pair with --force-rebuild to overwrite.");
     //  Fast-feedback QA mode.  Looks for tuned overrides under conf/QA/
     //  (currently: conf/QA/streaming.toml with raised RANSAC thresholds,
     //  which biases N_γ upward but keeps σ_photon ~invariant; see the
@@ -120,6 +130,7 @@ int main(int argc, char **argv)
     try
     {
         CLI11_PARSE(app, argc, argv);
+        util::TaskPool::configure(n_requested_threads);
 
         //  Resolve unset --xxx-conf options after parse.  Anything the
         //  user left at default falls through to conf_path(), which
@@ -246,7 +257,10 @@ int main(int argc, char **argv)
                 auto start = std::chrono::high_resolution_clock::now();
                 mist::logger::info(TString::Format("(lightdata_writer) Starting writing lightdata for run '%s'", current_run_name.c_str()).Data());
                 const float per_run_override = resolve_override_for_run(current_run_name);
-                lightdata_writer(data_repository, current_run_name, max_spill, force_rebuild, n_requested_threads, trigger_config_file, readout_config_file, mapping_config_file, fine_calibration_config_file, framer_config_file, streaming_config_file, per_run_override, resolve_op_mode_for_run(current_run_name), leading_only_cli, skip_stream_qa);
+                if (retrigger)
+                    lightdata_retrigger_writer(data_repository, current_run_name, max_spill, force_rebuild, n_requested_threads, mapping_config_file, fine_calibration_config_file, framer_config_file, streaming_config_file, per_run_override);
+                else
+                    lightdata_writer(data_repository, current_run_name, max_spill, force_rebuild, n_requested_threads, trigger_config_file, readout_config_file, mapping_config_file, fine_calibration_config_file, framer_config_file, streaming_config_file, per_run_override, resolve_op_mode_for_run(current_run_name), leading_only_cli, skip_stream_qa);
                 auto end = std::chrono::high_resolution_clock::now();
                 std::chrono::duration<double> elapsed = end - start;
                 mist::logger::info(TString::Format("(lightdata_writer) Total time taken: %f seconds", elapsed.count()).Data());
@@ -259,7 +273,10 @@ int main(int argc, char **argv)
         {
             auto start = std::chrono::high_resolution_clock::now();
             const float per_run_override = resolve_override_for_run(run_name);
-            lightdata_writer(data_repository, run_name, max_spill, force_rebuild, n_requested_threads, trigger_config_file, readout_config_file, mapping_config_file, fine_calibration_config_file, framer_config_file, streaming_config_file, per_run_override, resolve_op_mode_for_run(run_name), leading_only_cli, skip_stream_qa);
+            if (retrigger)
+                lightdata_retrigger_writer(data_repository, run_name, max_spill, force_rebuild, n_requested_threads, mapping_config_file, fine_calibration_config_file, framer_config_file, streaming_config_file, per_run_override);
+            else
+                lightdata_writer(data_repository, run_name, max_spill, force_rebuild, n_requested_threads, trigger_config_file, readout_config_file, mapping_config_file, fine_calibration_config_file, framer_config_file, streaming_config_file, per_run_override, resolve_op_mode_for_run(run_name), leading_only_cli, skip_stream_qa);
             auto end = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double> elapsed = end - start;
             mist::logger::info(TString::Format("(lightdata_writer) Total time taken: %f seconds", elapsed.count()).Data());
@@ -9,6 +9,8 @@
  *     [--max-spill N]
  *     [--anchor-device D] [--anchor-chip C] [--anchor-eo-channel E]
  *     [--pulser-frequency-hz F]
+ *     [--streaming]
+ *     [--incremental [--incremental-from PATH]]
  *
  * Anchor overrides: each ``--anchor-*`` flag, when set ≥ 0, overrides
  * the corresponding field in ``calibration_conf.toml`` for this launch
@@ -34,6 +36,7 @@
  */
 
 #include "utility/conf_path.h"
+#include "utility/task_pool.h"
 #include "writers/pulser_calib.h"
 
 #include <CLI/CLI.hpp>
@@ -71,6 +74,14 @@ int main(int argc, char **argv)
     //  320 MHz ALCOR clock.  Mirrors what the operator types on the
     //  generator (e.g. ``1000`` for 1 kHz).
     double pulser_frequency_hz_override = -1.0;
+    //  Bounded-memory ingest; false keeps the TOML value.
+    bool streaming = false;
+    //  Refit only channels that drifted from the previous calibration;
+    //  --incremental-from implies --incremental.
+    bool incremental = false;
+    std::string incremental_from;
+    //  Size of the process-wide task pool (per-channel fits).  -1 = all cores.
+    int n_threads = -1;
 
     app.add_option("data_repository", data_repository, "Top-level data directory")->required();
     app.add_option("run_name", run_name, "Run sub-directory under data_repository")->required();
@@ -99,8 +110,20 @@ int main(int argc, char **argv)
                    "frequency in Hz (e.g. 1000 for 1 kHz).  Converted "
                    "internally to pulser_period_cc using the 320 MHz clock "
                    "(cc = 320e6 / Hz).  -1 keeps the TOML value.");
+    app.add_flag("--streaming", streaming,
+                 "Accumulate the per-channel fit while reading (bounded "
+                 "memory) instead of buffering every hit");
+    app.add_flag("--incremental", incremental,
+                 "Start from the previous calibration and refit only the "
+                 "channels whose new data diverges from it");
+    app.add_option("--incremental-from", incremental_from,
+                   "Prior calibration for --incremental (default: this "
+                   "run's existing fine_calib.toml)");
+    app.add_option("--threads", n_threads,
+                   "Size of the shared task pool; -1 = all cores");
 
     CLI11_PARSE(app, argc, argv);
+    util::TaskPool::configure(n_threads);
 
     //  Unset --calib-conf falls through to the conventional path; route
     //  through util::conf_path so a user with conf/calib/ overrides
@@ -133,6 +156,9 @@ int main(int argc, char **argv)
                                anchor_chip_override,
                                anchor_eo_channel_override,
                                anchor_fifo_override,
-                               pulser_period_cc_override);
+                               pulser_period_cc_override,
+                               streaming,
+                               incremental || !incremental_from.empty(),
+                               incremental_from);
     return 0;
 }
@@ -11,6 +11,10 @@
  * centre/radius distributions, and writes a small ROOT file with the centre-XY
  * and R hists for rendering.  Iterate on the parameters in seconds.
  *
+ * A `lightdata_triggers.root` next to the input (from `lightdata_writer
+ * --retrigger`) is applied to every spill, so the seeds are the re-tuned
+ * streaming triggers a subsequent `recodata_writer` would see.
+ *
  * Occupancy weights (1/DCR proxy) are derived here from the per-channel hit
  * rate across the processed subset — high-rate (noisy) channels are down-
  * weighted, mirroring the score stage's `weight_by_channel = 1/m_c`.
@@ -44,6 +48,7 @@
 #include "alcor_spilldata.h"
 #include "triggers/events.h"
 #include "utility/global_index.h"
+#include "writers/lightdata/trigger_overlay.h"
 
 namespace
 {
@@ -130,6 +135,10 @@ int main(int argc, char **argv)
     AlcorSpilldata spilldata;
     spilldata.link_to_tree(tree);
     const long n_spills = tree->GetEntries();
+    const std::string overlay_path = btana::lightdata::trigger_overlay_path(file_path);
+    btana::lightdata::LightdataTriggerOverlay overlay(overlay_path);
+    if (overlay.is_open())
+        std::printf("applying trigger overlay %s\n", overlay_path.c_str());
 
     //  ── Collect per-frame candidate hit sets + per-channel occupancy ──────────
     std::vector<FrameHits> frames;
@@ -145,6 +154,8 @@ int main(int argc, char **argv)
     {
         tree->GetEntry(is);
         spilldata.get_entry();
+        overlay.apply(static_cast<int>(is), spilldata.get_frame_reference_list_link(),
+                      spilldata.get_frame_list_link());
         for (auto &fs : spilldata.get_frame_list_link())
         {
             if (reached_cap)
@@ -2,6 +2,7 @@
 #include <mist/logger/logger.h>
 #include "utility/config_reader.h"
 #include "utility/conf_path.h"
+#include "utility/task_pool.h"
 #include "utility.h"
 #include <stdio.h>
 #include <CLI/CLI.hpp>
@@ -33,24 +34,21 @@ int main(int argc, char **argv)
     int max_spill = 1000;
     bool force_rebuild = false;
     bool force_upstream = false;
+    bool end_to_end = false;
     bool qa_mode = false;
     bool force_ring = false;
     bool force_ellipse = false;
-    //  Sweep audit: accept --threads as a no-op so the
-    //  uniform qa_pipeline.py invocation
-    //  (`writer ... --threads N`) doesn't reject this stage.  Recodata
-    //  doesn't yet plumb thread parallelism through, but the CLI
-    //  needs to swallow the flag.  Same parking pattern in recotrack.
-    int n_threads_unused = 0;
+    //  Size of the process-wide task pool (frame compute, ring batches,
+    //  drain shards, coverage rasterisation — and the lightdata cascade
+    //  under --force-upstream).  -1 = all cores.
+    int n_threads = -1;
 
     app.add_option("data_repository", data_repository)->required();
     app.add_option("run_name", run_name)->required();
     app.add_option("--run-list", RunList, "Name of run list (required if run_name is a .toml runlist)");
     app.add_option("--max-spill", max_spill);
-    app.add_option("--threads", n_threads_unused,
-                   "[ACCEPTED, IGNORED] reserved for future per-stage "
-                   "thread plumbing — the qa_pipeline.py orchestrator "
-                   "passes this uniformly to all stages.");
+    app.add_option("--threads", n_threads,
+                   "Size of the shared task pool; -1 = all cores");
     auto *p_mapping = app.add_option("--Mapping-conf", mapping_conf);
     auto *p_trigger = app.add_option("--trigger-conf", trigger_config_file);
     auto *p_framer = app.add_option("--framer-conf", framer_config_file);
@@ -65,6 +63,10 @@ int main(int argc, char **argv)
     //                        (lightdata, in this case).
     app.add_flag("--force-rebuild", force_rebuild);
     app.add_flag("--force-upstream", force_upstream);
+    //  Keep the cascaded lightdata pass's spills in memory instead of
+    //  reading lightdata.root back (the file is still written).
+    app.add_flag("--end-to-end", end_to_end,
+                 "Hand the lightdata cascade's spills over in memory");
     //  Fast-feedback QA mode.  Reads tuned conf/QA/*.toml overrides
     //  when present (e.g. raised RANSAC thresholds → biases N_γ up
     //  but keeps σ_photon ~invariant).  See conf/QA/streaming.toml.
@@ -83,6 +85,7 @@ int main(int argc, char **argv)
     try
     {
         CLI11_PARSE(app, argc, argv);
+        util::TaskPool::configure(n_threads);
 
         const std::string ring_shape_mode = force_ring      ? "circle"
                                             : force_ellipse ? "ellipse"
@@ -138,7 +141,7 @@ int main(int argc, char **argv)
             {
                 auto start = std::chrono::high_resolution_clock::now();
                 mist::logger::info(TString::Format("(recodata_writer) Starting writing recodata for run '%s'", current_run_name.c_str()).Data());
-                recodata_writer(data_repository, current_run_name, max_spill, force_rebuild, force_upstream, mapping_conf, trigger_config_file, framer_config_file, streaming_config_file, ring_shape_mode);
+                recodata_writer(data_repository, current_run_name, max_spill, force_rebuild, force_upstream, mapping_conf, trigger_config_file, framer_config_file, streaming_config_file, ring_shape_mode, end_to_end);
                 auto end = std::chrono::high_resolution_clock::now();
                 std::chrono::duration<double> elapsed = end - start;
                 mist::logger::info(TString::Format("(recodata_writer) Total time taken: %f seconds", elapsed.count()).Data());
@@ -150,7 +153,7 @@ int main(int argc, char **argv)
         else
         {
             auto start = std::chrono::high_resolution_clock::now();
-            recodata_writer(data_repository, run_name, max_spill, force_rebuild, force_upstream, mapping_conf, trigger_config_file, framer_config_file, streaming_config_file, ring_shape_mode);
+            recodata_writer(data_repository, run_name, max_spill, force_rebuild, force_upstream, mapping_conf, trigger_config_file, framer_config_file, streaming_config_file, ring_shape_mode, end_to_end);
             auto end = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double> elapsed = end - start;
             mist::logger::info(TString::Format("(recodata_writer) Total time taken: %f seconds", elapsed.count()).Data());
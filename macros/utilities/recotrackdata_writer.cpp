@@ -1,5 +1,7 @@
 #include "writers/recotrackdata.h"
 #include <mist/logger/logger.h>
+#include "utility/conf_path.h"
+#include "utility/task_pool.h"
 #include <stdio.h>
 #include <CLI/CLI.hpp>
 #include <TROOT.h>
@@ -21,23 +23,25 @@ int main(int argc, char **argv)
     int max_spill = 1000;
     bool force_rebuild = false;
     bool force_upstream = false;
+    bool end_to_end = false;
     bool qa_mode = false;
-    //  Sweep audit: accept --threads as a no-op so the
-    //  uniform qa_pipeline.py invocation doesn't reject this stage.
-    //  recotrack doesn't yet plumb thread parallelism through; the
-    //  CLI just needs to swallow the flag.  Same parking pattern in
-    //  recodata.  See lightdata_writer for the live --threads path.
-    int n_threads_unused = 0;
+    std::string framer_config_file;
+    //  Sentinel -1 keeps the track matcher's defaults.  The ALTAI tick has
+    //  none: without it the writer falls back to counter matching.
+    double altai_tick_ns = -1.;
+    double match_tolerance_ns = -1.;
+    //  Size of the process-wide task pool: per-spill track matching,
+    //  plus the recodata / lightdata cascade under --force-upstream.
+    //  -1 = all cores.
+    int n_threads = -1;
 
     app.add_option("data_repository", data_repository)->required();
     app.add_option("run_name", run_name)->required();
     app.add_option("track_data_repository", track_data_repository);
     app.add_option("track_run_name", track_run_name);
     app.add_option("--max-spill", max_spill);
-    app.add_option("--threads", n_threads_unused,
-                   "[ACCEPTED, IGNORED] reserved for future per-stage "
-                   "thread plumbing — the qa_pipeline.py orchestrator "
-                   "passes this uniformly to all stages.");
+    app.add_option("--threads", n_threads,
+                   "Size of the shared task pool; -1 = all cores");
     //  Uniform force-flag contract across all writers (see
     //  include/writers/*.h docstrings):
     //    --force-rebuild   → overwrite THIS writer's output (recotrackdata.root).
@@ -45,6 +49,11 @@ int main(int argc, char **argv)
     //                        (recodata, which itself cascades into lightdata).
     app.add_flag("--force-rebuild", force_rebuild);
     app.add_flag("--force-upstream", force_upstream);
+    //  One process for the whole chain: recodata (and lightdata, when
+    //  missing or with --force-upstream) run in-process and hand their
+    //  output over in memory; their ROOT files are still written.
+    app.add_flag("--end-to-end", end_to_end,
+                 "Run the upstream writers in-process with in-memory hand-off");
     //  --QA accepted for CLI uniformity.  recotrackdata itself reads no
     //  config files; the flag only affects behaviour through the
     //  --force-upstream cascade into recodata_writer (which then loads
@@ -54,11 +63,25 @@ int main(int argc, char **argv)
     //  here yet; pass-through plumbing for --QA will land alongside a
     //  qa_mode signature parameter when first needed.
     app.add_flag("--QA", qa_mode);
+    //  Frame length fallback for recodata.root files without
+    //  Config/frame_size, and the framer conf of the in-process recodata.
+    auto *p_framer = app.add_option("--framer-conf", framer_config_file);
+    app.add_option("--altai-tick-ns", altai_tick_ns,
+                   "ns per ALTAI timestamp unit (required for timestamp matching)");
+    app.add_option("--match-tolerance-ns", match_tolerance_ns,
+                   "Largest frame-to-ALTAI time residual accepted as a match; -1 = matcher default");
 
     CLI11_PARSE(app, argc, argv);
+    util::TaskPool::configure(n_threads);
+    //  Same resolution as recodata_writer: mode sub-folder, then the
+    //  run's campaign set (util::conf_path / campaign_of).
+    const std::string mode = qa_mode ? std::string{"QA"} : std::string{};
+    if (p_framer->count() == 0)
+        framer_config_file = util::conf_path("framer_conf.toml", mode, util::campaign_of(run_name));
 
     auto start = std::chrono::high_resolution_clock::now();
-    recotrackdata_writer(data_repository, run_name, track_data_repository, track_run_name, max_spill, force_rebuild, force_upstream);
+    recotrackdata_writer(data_repository, run_name, track_data_repository, track_run_name, max_spill, force_rebuild, force_upstream, end_to_end,
+                         altai_tick_ns, match_tolerance_ns, framer_config_file);
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end - start;
     //mist::logger::info(Form("Total time taken: %d seconds", elapsed.count()));
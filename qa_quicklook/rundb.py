@@ -14,6 +14,7 @@ from __future__ import annotations
 
 import os
 import re
+import struct
 import sys
 from dataclasses import dataclass, field
 from pathlib import Path
@@ -602,6 +603,102 @@ class ResultEntry:
     error: float = 0.0
 
 
+#  ``<file>.journal`` next to the results TOML — layout documented in
+#  include/analysis_results.h.  Header: magic + u64 generation; records:
+#  u32 payload_bytes | u64 FNV-1a(payload) | payload, little-endian.
+_RESULTS_JOURNAL_MAGIC = b"BTRESJNL"
+_RESULTS_JOURNAL_HEADER = struct.Struct("<8sQ")
+_RESULTS_RECORD_HEADER = struct.Struct("<IQ")
+_RESULTS_RECORD_UPSERT = 1
+_RESULTS_MAX_PAYLOAD = 1 << 20
+
+
+def _fnv1a64(data: bytes) -> int:
+    h = 14695981039346656037
+    for b in data:
+        h = ((h ^ b) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def _decode_results_record(payload: bytes) -> Optional[tuple]:
+    """``(run, sensor, quantity, value, error)`` or None if malformed."""
+    if not payload or payload[0] != _RESULTS_RECORD_UPSERT:
+        return None
+    at = 1
+    fields = []
+    for _ in range(3):
+        if at + 2 > len(payload):
+            return None
+        (n,) = struct.unpack_from("<H", payload, at)
+        at += 2
+        if at + n > len(payload):
+            return None
+        fields.append(payload[at:at + n].decode("utf-8", "replace"))
+        at += n
+    if at + 16 != len(payload):
+        return None
+    value, error = struct.unpack_from("<dd", payload, at)
+    return (*fields, value, error)
+
+
+def _results_journal_records(data: bytes):
+    """Yield the intact journal records in order.
+
+    Stops at the first truncated / corrupt record, exactly like the C++
+    replay: a torn tail from a crashed writer is simply not there yet.
+    """
+    if len(data) < _RESULTS_JOURNAL_HEADER.size:
+        return
+    magic, _generation = _RESULTS_JOURNAL_HEADER.unpack_from(data, 0)
+    if magic != _RESULTS_JOURNAL_MAGIC:
+        return
+    at = _RESULTS_JOURNAL_HEADER.size
+    while at + _RESULTS_RECORD_HEADER.size <= len(data):
+        n, checksum = _RESULTS_RECORD_HEADER.unpack_from(data, at)
+        start = at + _RESULTS_RECORD_HEADER.size
+        payload = data[start:start + n]
+        if n > _RESULTS_MAX_PAYLOAD or len(payload) != n or _fnv1a64(payload) != checksum:
+            return
+        record = _decode_results_record(payload)
+        if record is None:
+            return
+        yield record
+        at = start + n
+
+
+def _read_results_snapshot(path: Path) -> tuple[Optional[dict], bytes]:
+    """TOML document (None if missing / unparseable) + raw journal bytes.
+
+    Both are read under a shared ``flock`` on the writers' ``<file>.lock``
+    when it exists, so a compaction (TOML replaced, journal reset) can't
+    land between the two reads.  Best effort: no lock file, or no
+    ``fcntl`` on this platform, reads unlocked.
+    """
+    lock_fh = None
+    try:
+        import fcntl
+        lock_fh = open(str(path) + ".lock", "rb")
+        fcntl.flock(lock_fh, fcntl.LOCK_SH)
+    except (ImportError, OSError):
+        pass
+    try:
+        doc = None
+        if path.is_file():
+            try:
+                with path.open("rb") as fh:
+                    doc = _tomllib.load(fh)
+            except (OSError, _tomllib.TOMLDecodeError):
+                doc = None
+        try:
+            journal = Path(str(path) + ".journal").read_bytes()
+        except OSError:
+            journal = b""
+        return doc, journal
+    finally:
+        if lock_fh is not None:
+            lock_fh.close()
+
+
 def results_load(path: Path) -> dict:
     """Read the dashboard-side TOML mirror of ``AnalysisResults``.
 
@@ -618,40 +715,41 @@ def results_load(path: Path) -> dict:
 
         [results."<run>"."<sensor>"]
         "<quantity>" = { value = X, error = Y }   # error optional
+
+    Entries the writers appended to ``<path>.journal`` since the last
+    compaction are replayed on top (last record wins), so the dashboard
+    sees the same store as ``AnalysisResults::load``.
     """
-    if not path.is_file():
-        return {}
-    try:
-        with path.open("rb") as fh:
-            doc = _tomllib.load(fh)
-    except (OSError, _tomllib.TOMLDecodeError):
-        return {}
-    results = doc.get("results")
-    if not isinstance(results, dict):
-        return {}
+    doc, journal = _read_results_snapshot(path)
     out: dict[str, dict[str, dict[str, ResultEntry]]] = {}
-    for run, sensors in results.items():
-        if not isinstance(sensors, dict):
-            continue
-        run_out: dict[str, dict[str, ResultEntry]] = {}
-        for sensor, quantities in sensors.items():
-            if not isinstance(quantities, dict):
+    results = doc.get("results") if doc is not None else None
+    if isinstance(results, dict):
+        for run, sensors in results.items():
+            if not isinstance(sensors, dict):
                 continue
-            qmap: dict[str, ResultEntry] = {}
-            for q, leaf in quantities.items():
-                if not isinstance(leaf, dict):
-                    continue
-                try:
-                    qmap[str(q)] = ResultEntry(
-                        value=float(leaf.get("value", 0.0)),
-                        error=float(leaf.get("error", 0.0)),
-                    )
-                except (TypeError, ValueError):
+            run_out: dict[str, dict[str, ResultEntry]] = {}
+            for sensor, quantities in sensors.items():
+                if not isinstance(quantities, dict):
                     continue
-            if qmap:
-                run_out[str(sensor)] = qmap
-        if run_out:
-            out[str(run)] = run_out
+                qmap: dict[str, ResultEntry] = {}
+                for q, leaf in quantities.items():
+                    if not isinstance(leaf, dict):
+                        continue
+                    try:
+                        qmap[str(q)] = ResultEntry(
+                            value=float(leaf.get("value", 0.0)),
+                            error=float(leaf.get("error", 0.0)),
+                        )
+                    except (TypeError, ValueError):
+                        continue
+                if qmap:
+                    run_out[str(sensor)] = qmap
+            if run_out:
+                out[str(run)] = run_out
+    for run, sensor, quantity, value, error in _results_journal_records(journal):
+        out.setdefault(run, {}).setdefault(sensor, {})[quantity] = ResultEntry(
+            value=value, error=error,
+        )
     return out
 
 
@@ -12,10 +12,13 @@ void AlcorLightdataStruct::clear()
     cherenkov_hits.shrink_to_fit();
     ring1_cx = ring1_cy = ring1_radius = 0.f;
     ring2_cx = ring2_cy = ring2_radius = 0.f;
+    trigger_mask = 0;
 }
 
 std::optional<float> AlcorLightdata::get_trigger_time(uint8_t trigger_index)
 {
+    if (!lightdata.has_trigger(trigger_index))
+        return std::nullopt;
     auto it = std::find_if(
         lightdata.trigger_hits.begin(),
         lightdata.trigger_hits.end(),
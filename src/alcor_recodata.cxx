@@ -8,6 +8,8 @@
 
 std::optional<TriggerEvent> AlcorRecodata::get_trigger_by_index(uint8_t index) const
 {
+    if (!check_trigger(index))
+        return std::nullopt;
     // Use the const-ref accessor — get_triggers() returns by reference now
     // (no per-call deep copy of the trigger vector).
     const auto &current_trigger = get_triggers();
@@ -29,6 +31,8 @@ void AlcorRecodata::clear()
     triggers.clear();
     recodata.shrink_to_fit();
     triggers.shrink_to_fit();
+    frame_id = kNoFrame;
+    trigger_mask = 0;
 }
 
 bool AlcorRecodata::link_to_tree(TTree *input_tree)
@@ -51,6 +55,13 @@ bool AlcorRecodata::link_to_tree(TTree *input_tree)
     }
     input_tree->SetBranchAddress("recodata", &recodata_ptr);
     input_tree->SetBranchAddress("triggers", &triggers_ptr);
+    //  Optional: recodata written before the frame index was stored keeps
+    //  frame_id at kNoFrame.
+    if (input_tree->GetBranch("frame"))
+        input_tree->SetBranchAddress("frame", &frame_id);
+    //  Optional likewise: without it the mask is computed from the triggers.
+    if (input_tree->GetBranch("trigger_mask"))
+        input_tree->SetBranchAddress("trigger_mask", &trigger_mask);
     return true;
 }
 
@@ -60,6 +71,8 @@ void AlcorRecodata::write_to_tree(TTree *output_tree)
         return;
     output_tree->Branch("recodata", &recodata);
     output_tree->Branch("triggers", &triggers);
+    output_tree->Branch("frame", &frame_id);
+    output_tree->Branch("trigger_mask", &trigger_mask);
 }
 
 // =============================================================================
@@ -114,7 +127,7 @@ void AlcorRecodata::find_rings(float distance_length_cut, float distance_time_cu
 //  sweep; that sweep was driven by a misdiagnosed autoload problem.
 //  Per project convention the body belongs in the header.  Not reverting
 //  blindly; do not generalise.
-bool AlcorRecodata::is_ring_tagged(int i)
+bool AlcorRecodata::is_ring_tagged(int i) const
 {
     return check_hit_mask(i, encode_bits({HitmaskRingTagFirst, HitmaskRingTagSecond}));
 }
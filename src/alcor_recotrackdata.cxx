@@ -49,14 +49,17 @@ void AlcorRecotrackdata::write_to_tree(TTree *output_tree)
     output_tree->Branch("recotrackdata", &recotrackdata);
     output_tree->Branch("recodata", get_recodata_ptr());
     output_tree->Branch("triggers", get_triggers_ptr());
+    //  Own frame index (not aliased): the writer sets it per entry.
+    output_tree->Branch("frame", get_frame_id_ptr());
+    output_tree->Branch("trigger_mask", get_trigger_mask_ptr());
 }
 
 // --- import from tracking ------------------------------------------------
 
-void AlcorRecotrackdata::import_event(std::vector<TrackingAltaiStruct> vec)
+void AlcorRecotrackdata::import_event(std::span<const TrackingAltaiStruct> vec)
 {
     int i_trk = -1;
-    for (auto &v : vec)
+    for (const auto &v : vec)
     {
         i_trk++;
         set_det_plane_x(i_trk, v.zero_plane_x);
@@ -197,6 +197,7 @@ void AlcorSpilldata::prepare_tree_fill()
 
 void merge_lightdata(AlcorLightdataStruct &lhs, AlcorLightdataStruct &&rhs)
 {
+    lhs.trigger_mask = lhs.get_trigger_mask() | rhs.get_trigger_mask();
     lhs.trigger_hits.insert(lhs.trigger_hits.end(),
                             std::make_move_iterator(rhs.trigger_hits.begin()),
                             std::make_move_iterator(rhs.trigger_hits.end()));
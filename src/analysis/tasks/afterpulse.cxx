@@ -0,0 +1,124 @@
+/**
+ * @file analysis/tasks/afterpulse.cxx
+ * @brief `afterpulse` train task — port of `macros/examples/afterpulse_treatment.cpp`.
+ *
+ * Trigger-0 frames: hit time w.r.t. the trigger, split afterpulse /
+ * clean, and the afterpulse probability N_AP / N per SiPM model (readout
+ * config `cherenkov` role) and overall → `afterpulse.probability`.
+ */
+
+#include "analysis/tasks.h"
+
+#include "alcor_recodata.h"
+#include "analysis_results.h"
+#include "utility/root_hist.h"
+
+#include <TDirectory.h>
+#include <TH1.h>
+
+#include "mist/logger/logger.h"
+
+#include <cmath>
+#include <map>
+
+namespace btana::analysis
+{
+
+namespace
+{
+
+class AfterpulseTask final : public AnalysisTask
+{
+    const ReadoutConfigStruct *cherenkov;
+
+    RootHist<TH1F> h_t_distribution, h_t_AP_distribution, h_t_noAP_distribution;
+    std::map<std::string, long> total_hits_by_sensor, afterpulse_hits_by_sensor;
+    long total_hits_all = 0;
+    long afterpulse_hits_all = 0;
+
+public:
+    explicit AfterpulseTask(const ReadoutConfigStruct *cherenkov) : cherenkov(cherenkov) {}
+
+    std::string name() const override { return "afterpulse"; }
+    std::unique_ptr<AnalysisTask> clone() const override { return std::make_unique<AfterpulseTask>(cherenkov); }
+
+    void init() override
+    {
+        h_t_distribution.reset(new TH1F("h_t_distribution", ";t_{Hit} - t_{timing} (ns)", 200, -312.5, 312.5));
+        h_t_AP_distribution.reset(new TH1F("h_t_AP_distribution", ";t_{Hit} - t_{timing} (ns)", 200, -312.5, 312.5));
+        h_t_noAP_distribution.reset(new TH1F("h_t_noAP_distribution", ";t_{Hit} - t_{timing} (ns)", 200, -312.5, 312.5));
+    }
+
+    void process(const TrainFrame &frame) override
+    {
+        const AlcorRecodata &recodata = frame.data;
+        if (recodata.is_start_of_spill())
+            return;
+        const auto trigger = recodata.get_trigger_by_index(0);
+        if (!trigger)
+            return;
+        for (int i = 0; i < static_cast<int>(recodata.get_recodata().size()); ++i)
+        {
+            const std::string sensor = cherenkov ? cherenkov->sensor_for(recodata.get_device(i)) : "";
+            const bool is_afterpulse = recodata.is_afterpulse(i);
+            ++total_hits_all;
+            afterpulse_hits_all += is_afterpulse;
+            if (!sensor.empty())
+            {
+                ++total_hits_by_sensor[sensor];
+                afterpulse_hits_by_sensor[sensor] += is_afterpulse;
+            }
+            const float dt = recodata.get_hit_t(i) - trigger->fine_time;
+            h_t_distribution->Fill(dt);
+            (is_afterpulse ? h_t_AP_distribution : h_t_noAP_distribution)->Fill(dt);
+        }
+    }
+
+    void merge(AnalysisTask &other) override
+    {
+        auto &o = static_cast<AfterpulseTask &>(other);
+        h_t_distribution->Add(o.h_t_distribution.get());
+        h_t_AP_distribution->Add(o.h_t_AP_distribution.get());
+        h_t_noAP_distribution->Add(o.h_t_noAP_distribution.get());
+        for (const auto &[sensor, n] : o.total_hits_by_sensor)
+            total_hits_by_sensor[sensor] += n;
+        for (const auto &[sensor, n] : o.afterpulse_hits_by_sensor)
+            afterpulse_hits_by_sensor[sensor] += n;
+        total_hits_all += o.total_hits_all;
+        afterpulse_hits_all += o.afterpulse_hits_all;
+    }
+
+    void finalize(const TrainContext &ctx, TDirectory *out) override
+    {
+        //  Binomial uncertainty sqrt(p(1-p)/N); N == 0 reports 0 ± 0.
+        auto probability = [](long afterpulse_hits, long total_hits) -> ResultEntry
+        {
+            if (total_hits <= 0)
+                return {0., 0.};
+            const double p = static_cast<double>(afterpulse_hits) / total_hits;
+            return {p, std::sqrt(std::max(0., p * (1. - p) / total_hits))};
+        };
+
+        ResultMap entries;
+        entries[{ctx.run_name, "all", "afterpulse.probability"}] = probability(afterpulse_hits_all, total_hits_all);
+        for (const auto &[sensor, total_hits] : total_hits_by_sensor)
+            entries[{ctx.run_name, sensor, "afterpulse.probability"}] = probability(afterpulse_hits_by_sensor[sensor], total_hits);
+        AnalysisResults(ctx.results_path()).update(entries);
+        mist::logger::info("[afterpulse] afterpulse probability written to standard_results.toml for run " + ctx.run_name);
+
+        out->WriteTObject(h_t_distribution.get());
+        out->WriteTObject(h_t_AP_distribution.get());
+        out->WriteTObject(h_t_noAP_distribution.get());
+    }
+};
+
+} // namespace
+
+std::unique_ptr<AnalysisTask> make_afterpulse_task(const TrainContext &ctx)
+{
+    if (!ctx.cherenkov)
+        mist::logger::warning("[afterpulse] no 'cherenkov' role in the readout config — per-sensor afterpulse split disabled");
+    return std::make_unique<AfterpulseTask>(ctx.cherenkov);
+}
+
+} // namespace btana::analysis
@@ -0,0 +1,231 @@
+/**
+ * @file analysis/tasks/cross_talk.cxx
+ * @brief `cross_talk` train task — port of `macros/examples/cross_talk_treatment.cpp`.
+ *
+ * Δt = t_j − t_i of the non-afterpulse hit pairs in trigger-0 frames, for
+ * physical (within `ct_phys_radius_mm`, causal) and electrical (same
+ * device and FIFO) neighbours, from `util::cross_talk::PairFinder`.  The CT probability is the signal-window
+ * count minus the equal-width sideband count, per primary hit; windows
+ * come from the `[qa]` table of framer_conf.toml.
+ */
+
+#include "analysis/tasks.h"
+
+#include "alcor_finedata.h"
+#include "alcor_recodata.h"
+#include "analysis_results.h"
+#include "utility/cross_talk_pairs.h"
+#include "utility/root_hist.h"
+
+#include <TDirectory.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TProfile.h>
+#include <TString.h>
+
+#include "mist/logger/logger.h"
+
+#include <cmath>
+#include <vector>
+
+namespace btana::analysis
+{
+
+namespace
+{
+
+//  Δt histograms: one bin per cc, covering a full frame.
+constexpr int kDtBins = 1024;
+constexpr float kDtMax = kDtBins * BTANA_ALCOR_CC_TO_NS; //  3200 ns
+constexpr float kElecDtLo = -5 * BTANA_ALCOR_CC_TO_NS;  //  headroom around -2 cc
+//  Upper Δt edge of h_dchannel_dt [ns]; later pairs would only land in its overflow.
+constexpr float kDchannelDtHi = 20.5f * BTANA_ALCOR_CC_TO_NS;
+
+class CrossTalkTask final : public AnalysisTask
+{
+    QaConfigStruct qa;
+    //  Windows [ns], from the [qa] edges (cc).
+    float phys_ct_lo_ns, phys_ct_hi_ns, elec_ct_lo_ns, elec_ct_hi_ns;
+    float sideband_lo_ns, phys_sideband_hi_ns, elec_sideband_hi_ns;
+    float phys_radius_mm;
+
+    RootHist<TH1F> h_phys_dt, h_elec_dt;
+    RootHist<TH2F> h_phys_ct_hitmap, h_elec_ct_hitmap, h_dchannel_dt;
+    RootHist<TProfile> h_phys_ct_corr, h_elec_ct_corr;
+    long long n_primary = 0;
+
+    util::cross_talk::PairFinder ct_pairs;
+    std::vector<int> hit_of_pair; ///< pair-finder index → recodata hit index
+
+public:
+    explicit CrossTalkTask(const QaConfigStruct &qa)
+        : qa(qa),
+          phys_ct_lo_ns(qa.ct_phys_signal_lo * BTANA_ALCOR_CC_TO_NS),
+          phys_ct_hi_ns(qa.ct_phys_signal_hi * BTANA_ALCOR_CC_TO_NS),
+          elec_ct_lo_ns(qa.ct_elec_signal_lo * BTANA_ALCOR_CC_TO_NS),
+          elec_ct_hi_ns(qa.ct_elec_signal_hi * BTANA_ALCOR_CC_TO_NS),
+          sideband_lo_ns(qa.ct_sideband_offset * BTANA_ALCOR_CC_TO_NS),
+          phys_sideband_hi_ns(sideband_lo_ns + phys_ct_hi_ns - phys_ct_lo_ns),
+          elec_sideband_hi_ns(sideband_lo_ns + elec_ct_hi_ns - elec_ct_lo_ns),
+          phys_radius_mm(qa.ct_phys_radius_mm),
+          ct_pairs(qa.ct_phys_radius_mm)
+    {
+    }
+
+    std::string name() const override { return "cross_talk"; }
+    std::unique_ptr<AnalysisTask> clone() const override { return std::make_unique<CrossTalkTask>(qa); }
+
+    void init() override
+    {
+        h_phys_dt.reset(new TH1F("h_phys_dt", ";#Delta_{t} = t_{j} - t_{i} (ns);physical neighbour pairs / primary Hit",
+                                 kDtBins, 0, kDtMax));
+        h_elec_dt.reset(new TH1F("h_elec_dt", ";#Delta_{t} = t_{j} - t_{i} (ns);electrical neighbour pairs / primary Hit",
+                                 kDtBins + 5, kElecDtLo, kDtMax));
+        h_phys_ct_hitmap.reset(new TH2F("h_phys_ct_hitmap", ";x (mm);y (mm)", 396, -99, 99, 396, -99, 99));
+        h_elec_ct_hitmap.reset(new TH2F("h_elec_ct_hitmap", ";x (mm);y (mm)", 396, -99, 99, 396, -99, 99));
+        h_dchannel_dt.reset(new TH2F("h_dchannel_dt", ";#Delta channel (j #minus i);#Delta_{t} (cc)",
+                                     65, -32.5, 32.5, 26, -5.5, 20.5));
+        h_phys_ct_corr.reset(new TProfile("h_phys_ct_corrected_per_channel",
+                                          ";global channel;Corrected physical CT probability (%)", 2048, 0, 2048));
+        h_elec_ct_corr.reset(new TProfile("h_elec_ct_corrected_per_channel",
+                                          ";global channel;Corrected electrical CT probability (%)", 2048, 0, 2048));
+    }
+
+    void process(const TrainFrame &frame) override
+    {
+        const AlcorRecodata &recodata = frame.data;
+        if (recodata.is_start_of_spill() || !recodata.get_trigger_by_index(0))
+            return;
+
+        //  Afterpulse hits never enter the pair search.
+        ct_pairs.clear();
+        hit_of_pair.clear();
+        for (int i = 0; i < static_cast<int>(recodata.get_recodata().size()); ++i)
+        {
+            if (recodata.is_afterpulse(i))
+                continue;
+            ct_pairs.add(recodata.get_hit_t(i),
+                         {static_cast<uint32_t>(recodata.get_global_channel_index(i)),
+                          recodata.get_device(i), recodata.get_fifo(i),
+                          recodata.get_hit_x(i), recodata.get_hit_y(i)});
+            hit_of_pair.push_back(i);
+        }
+        ct_pairs.prepare();
+
+        for (std::size_t ip = 0; ip < ct_pairs.size(); ++ip)
+        {
+            const int i = hit_of_pair[ip];
+            const float xi = recodata.get_hit_x(i);
+            const int chan_i = static_cast<int>(ct_pairs.channel(ip));
+            ++n_primary;
+
+            int n_phys_near = 0, n_phys_far = 0;
+            int n_elec_near = 0, n_elec_far = 0;
+            ct_pairs.for_each_neighbour(
+                ip, kElecDtLo, kDtMax,
+                [&](std::size_t, double dt, uint8_t relation)
+                {
+                    //  Physical CT: causal only.
+                    const bool is_phys = dt >= 0. && (relation & util::cross_talk::RelationPhysical);
+                    const bool is_elec = relation & util::cross_talk::RelationElectrical;
+                    if (is_phys)
+                        h_phys_dt->Fill(dt);
+                    if (is_elec)
+                        h_elec_dt->Fill(dt);
+                    if (is_phys && dt >= phys_ct_lo_ns && dt < phys_ct_hi_ns)
+                        ++n_phys_near;
+                    if (is_elec && dt >= elec_ct_lo_ns && dt < elec_ct_hi_ns)
+                        ++n_elec_near;
+                    if (is_phys && dt >= sideband_lo_ns && dt < phys_sideband_hi_ns)
+                        ++n_phys_far;
+                    if (is_elec && dt >= sideband_lo_ns && dt < elec_sideband_hi_ns)
+                        ++n_elec_far;
+                });
+            ct_pairs.for_each_in_window(
+                ip, kElecDtLo, kDchannelDtHi,
+                [&](std::size_t jp, double dt)
+                { h_dchannel_dt->Fill(static_cast<int>(ct_pairs.channel(jp)) - chan_i, dt / BTANA_ALCOR_CC_TO_NS); });
+
+            //  Smeared hitmaps weighted by the CT-neighbour count (×100).
+            if (xi > -990.f)
+            {
+                if (n_phys_near > 0)
+                    h_phys_ct_hitmap->Fill(recodata.get_hit_x_rnd(i), recodata.get_hit_y_rnd(i), 100.0 * n_phys_near);
+                if (n_elec_near > 0)
+                    h_elec_ct_hitmap->Fill(recodata.get_hit_x_rnd(i), recodata.get_hit_y_rnd(i), 100.0 * n_elec_near);
+            }
+            h_phys_ct_corr->Fill(chan_i, (n_phys_near - n_phys_far) > 0 ? 100. : 0.);
+            h_elec_ct_corr->Fill(chan_i, (n_elec_near - n_elec_far) > 0 ? 100. : 0.);
+        }
+    }
+
+    void merge(AnalysisTask &other) override
+    {
+        auto &o = static_cast<CrossTalkTask &>(other);
+        h_phys_dt->Add(o.h_phys_dt.get());
+        h_elec_dt->Add(o.h_elec_dt.get());
+        h_phys_ct_hitmap->Add(o.h_phys_ct_hitmap.get());
+        h_elec_ct_hitmap->Add(o.h_elec_ct_hitmap.get());
+        h_dchannel_dt->Add(o.h_dchannel_dt.get());
+        h_phys_ct_corr->Add(o.h_phys_ct_corr.get());
+        h_elec_ct_corr->Add(o.h_elec_ct_corr.get());
+        n_primary += o.n_primary;
+    }
+
+    void finalize(const TrainContext &ctx, TDirectory *out) override
+    {
+        auto integral_ns = [](TH1F *h, float lo, float hi)
+        { return h->Integral(h->GetXaxis()->FindBin(lo), h->GetXaxis()->FindBin(hi) - 1); };
+
+        const double phys_n_sig = integral_ns(h_phys_dt.get(), phys_ct_lo_ns, phys_ct_hi_ns);
+        const double phys_n_sb = integral_ns(h_phys_dt.get(), sideband_lo_ns, phys_sideband_hi_ns);
+        const double elec_n_sig = integral_ns(h_elec_dt.get(), elec_ct_lo_ns, elec_ct_hi_ns);
+        const double elec_n_sb = integral_ns(h_elec_dt.get(), sideband_lo_ns, elec_sideband_hi_ns);
+
+        //  Equal-width windows per type → sideband scale factor 1.  Poisson
+        //  errors: σ(N_sig − N_sb) = √(N_sig + N_sb) over the exact primary count.
+        const double n = static_cast<double>(n_primary);
+        auto per_primary = [n](double v) { return n > 0 ? v / n : 0.; };
+
+        ResultMap entries{
+            {{ctx.run_name, "all", "cross_talk.phys.fraction"}, {per_primary(phys_n_sig - phys_n_sb), per_primary(std::sqrt(phys_n_sig + phys_n_sb))}},
+            {{ctx.run_name, "all", "cross_talk.phys.fraction_raw"}, {per_primary(phys_n_sig), per_primary(std::sqrt(phys_n_sig))}},
+            {{ctx.run_name, "all", "cross_talk.phys.dcr_accidental"}, {per_primary(phys_n_sb), 0.}},
+            {{ctx.run_name, "all", "cross_talk.elec.fraction"}, {per_primary(elec_n_sig - elec_n_sb), per_primary(std::sqrt(elec_n_sig + elec_n_sb))}},
+            {{ctx.run_name, "all", "cross_talk.elec.fraction_raw"}, {per_primary(elec_n_sig), per_primary(std::sqrt(elec_n_sig))}},
+            {{ctx.run_name, "all", "cross_talk.elec.dcr_accidental"}, {per_primary(elec_n_sb), 0.}},
+        };
+        mist::logger::info(TString::Format("[cross_talk] %lld primary hits; physical CT %.3f%% (raw %.3f%%), "
+                                           "electrical CT %.3f%% (raw %.3f%%)",
+                                           n_primary, per_primary(phys_n_sig - phys_n_sb) * 100.,
+                                           per_primary(phys_n_sig) * 100.,
+                                           per_primary(elec_n_sig - elec_n_sb) * 100.,
+                                           per_primary(elec_n_sig) * 100.)
+                               .Data());
+        AnalysisResults(ctx.results_path()).update(entries);
+        mist::logger::info("[cross_talk] CT results written to standard_results.toml for run " + ctx.run_name);
+
+        //  Δt distributions as pairs per primary hit.
+        if (n_primary > 0)
+        {
+            h_phys_dt->Scale(1. / n);
+            h_elec_dt->Scale(1. / n);
+        }
+        out->WriteTObject(h_phys_dt.get());
+        out->WriteTObject(h_elec_dt.get());
+        out->WriteTObject(h_phys_ct_hitmap.get());
+        out->WriteTObject(h_elec_ct_hitmap.get());
+        out->WriteTObject(h_dchannel_dt.get());
+        out->WriteTObject(h_phys_ct_corr.get());
+        out->WriteTObject(h_elec_ct_corr.get());
+    }
+};
+
+} // namespace
+
+std::unique_ptr<AnalysisTask> make_cross_talk_task(const TrainContext &ctx)
+{
+    return std::make_unique<CrossTalkTask>(ctx.qa_config);
+}
+
+} // namespace btana::analysis
@@ -0,0 +1,199 @@
+/**
+ * @file analysis/tasks/dark_count_rate.cxx
+ * @brief `dark_count_rate` train task — port of `macros/examples/dark_count_rate.cpp`.
+ *
+ * First-frames (trigger 100) frames: per-channel hit counts over the
+ * spill's participant list (the start-of-spill marker's hits) give the
+ * per-channel DCR profile; the log-binned per-model distributions are
+ * fitted with one (1350) or two (1375) Gaussians → `dcr.*`.
+ *
+ * The participant list is per-spill state; the train's ranges are
+ * spill-aligned, so every clone sees a spill's marker before its frames.
+ */
+
+#include "analysis/tasks.h"
+
+#include "alcor_recodata.h"
+#include "analysis_results.h"
+#include "parallel_streaming_framer.h"
+#include "utility/root_hist.h"
+
+#include <TDirectory.h>
+#include <TF1.h>
+#include <TH1.h>
+#include <TProfile.h>
+
+#include "mist/logger/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace btana::analysis
+{
+
+namespace
+{
+
+//  Frame length [ms], the DCR time base.
+constexpr double kFrameLengthMs = BTANA_FRAME_LENGTH_NS * 1.e-6;
+
+//  Log-binned TH1F: DCR spans ~3 decades, uniform bins would starve the low end.
+TH1F *make_log_bins(const std::string &name, const std::string &title, int n_bins, double x_min, double x_max)
+{
+    std::vector<double> bins(n_bins + 1);
+    const double log_min = std::log10(x_min);
+    const double step = (std::log10(x_max) - log_min) / n_bins;
+    for (int i = 0; i <= n_bins; ++i)
+        bins[i] = std::pow(10., log_min + i * step);
+    return new TH1F(name.c_str(), title.c_str(), n_bins, bins.data());
+}
+
+class DarkCountRateTask final : public AnalysisTask
+{
+    const ReadoutConfigStruct *cherenkov;
+
+    RootHist<TH1F> h_dcr;
+    RootHist<TProfile> h_dcr_per_channel;
+    std::map<int, std::string> ordinal_to_sensor; ///< channel ordinal → SiPM model
+    long used_frames = 0;
+
+    //  Current spill's participants; cleared at each range end.
+    std::vector<int> active_channels;
+    std::unordered_map<int, uint16_t> active_count;
+
+public:
+    explicit DarkCountRateTask(const ReadoutConfigStruct *cherenkov) : cherenkov(cherenkov) {}
+
+    std::string name() const override { return "dark_count_rate"; }
+    std::unique_ptr<AnalysisTask> clone() const override { return std::make_unique<DarkCountRateTask>(cherenkov); }
+
+    void init() override
+    {
+        h_dcr.reset(new TH1F("h_dcr", "Dark Count Rate;DCR [kHz];Entries", 40, 0, 20));
+        h_dcr_per_channel.reset(new TProfile("h_dcr_per_channel", ";channel;DCR [kHz];", 2048, 0, 2048));
+    }
+
+    void process(const TrainFrame &frame) override
+    {
+        const AlcorRecodata &recodata = frame.data;
+        const int n_hits = static_cast<int>(recodata.get_recodata().size());
+        if (recodata.is_start_of_spill())
+        {
+            active_channels.clear();
+            for (int i = 0; i < n_hits; ++i)
+                active_channels.push_back(recodata.get_global_channel_index(i));
+            std::sort(active_channels.begin(), active_channels.end());
+            active_channels.erase(std::unique(active_channels.begin(), active_channels.end()), active_channels.end());
+            return;
+        }
+        if (!recodata.is_first_frames())
+            return;
+
+        ++used_frames;
+        active_count.clear();
+        for (const auto channel : active_channels)
+            active_count[channel] = 0;
+        for (int i = 0; i < n_hits; ++i)
+        {
+            const int ordinal = recodata.get_global_channel_index(i);
+            ++active_count[ordinal];
+            if (cherenkov && !ordinal_to_sensor.count(ordinal))
+                ordinal_to_sensor[ordinal] = cherenkov->sensor_for(recodata.get_device(i));
+        }
+        for (const auto &[channel, count] : active_count)
+            h_dcr_per_channel->Fill(channel, count);
+        h_dcr->Fill(n_hits / (kFrameLengthMs * active_channels.size()));
+    }
+
+    void end_chunk() override { active_channels.clear(); }
+
+    void merge(AnalysisTask &other) override
+    {
+        auto &o = static_cast<DarkCountRateTask &>(other);
+        h_dcr->Add(o.h_dcr.get());
+        h_dcr_per_channel->Add(o.h_dcr_per_channel.get());
+        ordinal_to_sensor.merge(o.ordinal_to_sensor);
+        used_frames += o.used_frames;
+    }
+
+    void finalize(const TrainContext &ctx, TDirectory *out) override
+    {
+        h_dcr_per_channel->Scale(1. / kFrameLengthMs);
+        if (used_frames > 0)
+            h_dcr->Scale(1. / used_frames);
+
+        RootHist<TH1F> h_average_dcr("h_average_dcr", "1350;DCR [kHz];Entries", 50, 0, 10);
+        RootHist<TH1F> h_average_dcr_2("h_average_dcr_2", "1375;DCR [kHz];Entries", 50, 0, 10);
+        RootHist<TH1F> h_dcr_log_1350(make_log_bins("h_dcr_log_1350_" + ctx.run_name, ctx.run_name + "; DCR (kHz)", 100, 0.1, 100));
+        RootHist<TH1F> h_dcr_log_1375(make_log_bins("h_dcr_log_1375_" + ctx.run_name, ctx.run_name + "; DCR (kHz)", 100, 0.1, 100));
+
+        //  Same channel cut as the macro (and lightdata_writer's extract_DCR).
+        const double dcr_threshold = 100.0; // kHz
+        for (int x_bin = 1; x_bin <= h_dcr_per_channel->GetNbinsX(); ++x_bin)
+        {
+            const double dcr = h_dcr_per_channel->GetBinContent(x_bin);
+            if (dcr < 0.001 || dcr <= dcr_threshold)
+                continue;
+            const auto it = ordinal_to_sensor.find(static_cast<int>(h_dcr_per_channel->GetBinCenter(x_bin)));
+            const std::string sensor = it != ordinal_to_sensor.end() ? it->second : "";
+            if (sensor == "1350")
+            {
+                h_average_dcr->Fill(dcr);
+                h_dcr_log_1350->Fill(dcr);
+            }
+            else if (sensor == "1375")
+            {
+                h_average_dcr_2->Fill(dcr);
+                h_dcr_log_1375->Fill(dcr);
+            }
+        }
+
+        //  1350: one population; 1375: two SiPM batches → double Gaussian.
+        TF1 f_gaus_1350(("f_gaus_1350_" + ctx.run_name).c_str(), "[0]*TMath::Gaus(x,[1],[2],true)", 0.1, 100);
+        TF1 f_gaus_1375(("f_gaus_1375_" + ctx.run_name).c_str(),
+                        "[0]*TMath::Gaus(x,[1],[2],true)+[3]*TMath::Gaus(x,[4],[5],true)", 0.1, 100);
+        f_gaus_1350.SetParameters(h_dcr_log_1350->GetMaximum(), h_dcr_log_1350->GetMean(), h_dcr_log_1350->GetRMS());
+        f_gaus_1375.SetParameters(h_dcr_log_1375->GetMaximum(),
+                                  h_dcr_log_1375->GetMean() - h_dcr_log_1375->GetRMS() / 2.,
+                                  h_dcr_log_1375->GetRMS() / 4.,
+                                  h_dcr_log_1375->GetMaximum(),
+                                  h_dcr_log_1375->GetMean() + h_dcr_log_1375->GetRMS() / 2.,
+                                  h_dcr_log_1375->GetRMS() / 4.);
+        h_dcr_log_1350->Fit(&f_gaus_1350, "QR");
+        h_dcr_log_1375->Fit(&f_gaus_1375, "QR");
+
+        //  1375 peaks ordered by mean, so peak_lo < peak_hi always.
+        const bool peak1_lower = f_gaus_1375.GetParameter(1) < f_gaus_1375.GetParameter(4);
+        const int lo = peak1_lower ? 1 : 4, hi = peak1_lower ? 4 : 1;
+        AnalysisResults(ctx.results_path()).update({
+            {{ctx.run_name, "1350", "dcr.mean"}, {f_gaus_1350.GetParameter(1), f_gaus_1350.GetParameter(2)}},
+            {{ctx.run_name, "1350", "dcr.sigma"}, {f_gaus_1350.GetParameter(2), 0.}},
+            {{ctx.run_name, "1375", "dcr.peak_lo.mean"}, {f_gaus_1375.GetParameter(lo), f_gaus_1375.GetParameter(lo + 1)}},
+            {{ctx.run_name, "1375", "dcr.peak_lo.sigma"}, {f_gaus_1375.GetParameter(lo + 1), 0.}},
+            {{ctx.run_name, "1375", "dcr.peak_hi.mean"}, {f_gaus_1375.GetParameter(hi), f_gaus_1375.GetParameter(hi + 1)}},
+            {{ctx.run_name, "1375", "dcr.peak_hi.sigma"}, {f_gaus_1375.GetParameter(hi + 1), 0.}},
+        });
+        mist::logger::info("[dark_count_rate] DCR fit results written to standard_results.toml for run " + ctx.run_name);
+
+        out->WriteTObject(h_dcr.get());
+        out->WriteTObject(h_dcr_per_channel.get());
+        out->WriteTObject(h_average_dcr.get());
+        out->WriteTObject(h_average_dcr_2.get());
+        out->WriteTObject(h_dcr_log_1350.get());
+        out->WriteTObject(h_dcr_log_1375.get());
+    }
+};
+
+} // namespace
+
+std::unique_ptr<AnalysisTask> make_dark_count_rate_task(const TrainContext &ctx)
+{
+    if (!ctx.cherenkov)
+        mist::logger::warning("[dark_count_rate] no 'cherenkov' role in the readout config — per-sensor DCR split disabled");
+    return std::make_unique<DarkCountRateTask>(ctx.cherenkov);
+}
+
+} // namespace btana::analysis
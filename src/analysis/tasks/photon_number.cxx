@@ -0,0 +1,569 @@
+/**
+ * @file analysis/tasks/photon_number.cxx
+ * @brief `photon_number` train task — port of `macros/examples/photon_number.cpp`.
+ *
+ * Streaming-ring (trigger 104) frames give the ring (circle fits → peak
+ * centre / radius G) and the signal radial distribution around G; first-
+ * frames (trigger 100) frames give the DCR distribution subtracted from
+ * it.  Both are corrected by the acceptance seen from the spills' active
+ * channels (coverage weighted by each spill's share of 104 frames), then
+ * fitted (Gaussian + broad Gaussian + pol2) for N_γ → `<scope>.n_gamma`
+ * and friends, full ring / in the φ gaps / outside them / per SiPM model.
+ *
+ * The macro reads the run three times (spill census, circle fits,
+ * distributions).  Here one pass fits the circles, counts each spill's
+ * frames and keeps the in-time non-afterpulse hits of the 104 / 100
+ * frames; a channel's coverage weight is the sum of the 104 counts of
+ * the spills it was active in.  Everything that needs G or the run
+ * totals — hit distributions, coverage maps, corrections, fits — runs in
+ * finalize.  As in the macro, only frames after the run's first
+ * start-of-spill marker enter the distributions; the circle fits take
+ * every 104 frame.
+ */
+
+#include "analysis/tasks.h"
+
+#include "alcor_recodata.h"
+#include "analysis_results.h"
+#include "utility/circle_fit.h"
+#include "utility/root_hist.h"
+
+#include <TDirectory.h>
+#include <TF1.h>
+#include <TFitResult.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TMath.h>
+#include <TString.h>
+
+#include "mist/logger/logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace btana::analysis
+{
+
+namespace
+{
+
+constexpr int kCoverageGranularity = 10;
+constexpr std::array<float, 2> kTimeCutNs = {-40.f, 40.f};
+const std::vector<std::array<float, 2>> kPhiGapRanges = {{-2.6f, -1.9f}, {2.4f, 2.95f}, {-1.65f, -1.1f}};
+
+//  Radial histogram binning and fit range.
+constexpr int kRBins = 40;
+constexpr float kRLo = 25.f;
+constexpr float kRHi = 125.f;
+constexpr float kFitLo = 30.f; // avoids low-R structure
+constexpr float kFitHi = 80.f; // truncates the high-R tail
+
+//  SiPM model of a hit / channel, from the readout config's cherenkov role.
+enum Sensor : uint8_t
+{
+    SensorOther,
+    Sensor1350,
+    Sensor1375,
+};
+
+Sensor sensor_of(const ReadoutConfigStruct *cherenkov, int device)
+{
+    if (!cherenkov)
+        return SensorOther;
+    const std::string sensor = cherenkov->sensor_for(device);
+    return sensor == "1350" ? Sensor1350 : sensor == "1375" ? Sensor1375
+                                                            : SensorOther;
+}
+
+//  An in-time non-afterpulse hit of a 104 or 100 frame; the randomised
+//  position feeds the QA maps only.
+struct PhotonHit
+{
+    float x, y;
+    float x_rnd, y_rnd;
+    Sensor sensor;
+};
+
+//  A channel seen in a start-of-spill participant list.
+struct CoverageChannel
+{
+    float x, y;
+    Sensor sensor;
+    long weight = 0; ///< Σ 104 frames over the spills the channel was active in
+};
+
+bool in_phi_gap(float phi)
+{
+    return std::any_of(kPhiGapRanges.begin(), kPhiGapRanges.end(), [phi](const auto &range)
+                       { return phi > range[0] && phi < range[1]; });
+}
+
+//  Mean coverage per R bin of @p ref_axis over the φ ranges (inside them,
+//  or outside with @p inclusive false) of the fine (φ, R) map @p h_rphi.
+TH1F *radial_efficiency(TH2F *h_rphi, const TAxis *ref_axis,
+                        const std::vector<std::array<float, 2>> &ranges, bool inclusive = true)
+{
+    const int n_out = ref_axis->GetNbins();
+    auto *h = new TH1F(TString::Format("h_eff_%s_%d", h_rphi->GetName(), inclusive ? 1 : 0).Data(),
+                       h_rphi->GetName(), n_out, ref_axis->GetXmin(), ref_axis->GetXmax());
+
+    std::vector<std::array<float, 2>> active_ranges = ranges;
+    if (!inclusive)
+    {
+        active_ranges.clear();
+        float prev = -TMath::Pi();
+        for (const auto &r : ranges)
+        {
+            active_ranges.push_back({prev, r[0]});
+            prev = r[1];
+        }
+        active_ranges.push_back({prev, static_cast<float>(TMath::Pi())});
+    }
+
+    const int n_phi = h_rphi->GetNbinsX();
+    std::vector<char> phi_selected(n_phi + 1, 0);
+    int n_phi_selected = 0;
+    for (int iphi = 1; iphi <= n_phi; ++iphi)
+    {
+        const float phi = h_rphi->GetXaxis()->GetBinCenter(iphi);
+        for (const auto &r : active_ranges)
+            if (phi > r[0] && phi < r[1])
+            {
+                phi_selected[iphi] = 1;
+                ++n_phi_selected;
+                break;
+            }
+    }
+    if (n_phi_selected == 0)
+        return h;
+
+    std::vector<int> fine_count(n_out + 2, 0);
+    for (int ir = 1; ir <= h_rphi->GetNbinsY(); ++ir)
+    {
+        const int iout = h->GetXaxis()->FindBin(h_rphi->GetYaxis()->GetBinCenter(ir));
+        if (iout < 1 || iout > n_out)
+            continue;
+        double sum = 0.;
+        for (int iphi = 1; iphi <= n_phi; ++iphi)
+            if (phi_selected[iphi])
+                sum += h_rphi->GetBinContent(iphi, ir);
+        h->AddBinContent(iout, sum);
+        ++fine_count[iout];
+    }
+    for (int iout = 1; iout <= n_out; ++iout)
+        if (fine_count[iout] > 0)
+            h->SetBinContent(iout, h->GetBinContent(iout) / fine_count[iout]);
+    h->Scale(1. / n_phi_selected);
+    return h;
+}
+
+//  2π over the φ span selected by @p ranges (inside / outside).
+float phi_extrapolation_scale(const std::vector<std::array<float, 2>> &ranges, bool inclusive = true)
+{
+    float gap_phi = 0.f;
+    for (const auto &r : ranges)
+        gap_phi += r[1] - r[0];
+    const float selected_phi = inclusive ? gap_phi : (2.f * static_cast<float>(TMath::Pi()) - gap_phi);
+    return 2.f * static_cast<float>(TMath::Pi()) / selected_phi;
+}
+
+//  Result of one radial fit.
+struct RadialFit
+{
+    double n_gamma, n_gamma_err, mu, sigma, gs_frac, chi2_ndf;
+};
+
+//  Gaussian + broad Gaussian (right shoulder) + pol2 background over
+//  [kFitLo, kFitHi]; amplitudes forced positive.  Parameters: gaus_amp,
+//  mu, sigma, gs_amp, gs_sig, pol2_c0..2.
+double full_model(double *x, double *p)
+{
+    const double xx = x[0];
+    const double gaus = std::fabs(p[0]) * std::exp(-0.5 * std::pow((xx - p[1]) / p[2], 2));
+    const double gs = std::fabs(p[3]) * std::exp(-0.5 * std::pow((xx - p[1]) / p[4], 2));
+    return gaus + gs + p[5] + p[6] * xx + p[7] * xx * xx;
+}
+
+//  Sideband pol2, then three passes (background fixed without / with the
+//  broad Gaussian, then everything free); N_γ is the signal integral.
+RadialFit fit_r_dist(TH1F *h, float mu0)
+{
+    const float sig_seed = std::clamp(static_cast<float>(h->GetRMS()) * 0.5f, 0.5f, 5.0f);
+
+    TF1 f_bkg(TString::Format("f_bkg_%s", h->GetName()).Data(), "pol2", kFitLo, kFitHi);
+    {
+        RootHist<TH1F> h_sb(static_cast<TH1F *>(h->Clone(TString::Format("h_sb_%s", h->GetName()).Data())));
+        const float mask = 3.5f * sig_seed;
+        for (int i = 1; i <= h_sb->GetNbinsX(); ++i)
+        {
+            const double xc = h_sb->GetBinCenter(i);
+            if (xc < kFitLo || std::fabs(xc - mu0) < mask)
+            {
+                h_sb->SetBinContent(i, 0.);
+                h_sb->SetBinError(i, 1e10);
+            }
+        }
+        f_bkg.SetParameters(h->GetBinContent(h->FindBin(kFitLo + 1.)), 0., 0.);
+        h_sb->Fit(&f_bkg, "RQ0");
+    }
+
+    TF1 f_model(TString::Format("f_model_%s", h->GetName()).Data(), full_model, kFitLo, kFitHi, 8);
+    const char *par_names[8] = {"gaus_amp", "mu", "sigma", "gs_amp", "gs_sig", "pol2_c0", "pol2_c1", "pol2_c2"};
+    for (int i = 0; i < 8; ++i)
+        f_model.SetParName(i, par_names[i]);
+    f_model.SetParLimits(0, 1e-6, 50.);
+    f_model.SetParLimits(2, 0.3, 3.0);
+    f_model.SetParLimits(3, 0.0, 1e9);
+    f_model.SetParLimits(4, 4.0, 10.0);
+    const double seeds[8] = {h->GetMaximum(), mu0, sig_seed, 0.0, 8.0,
+                             f_bkg.GetParameter(0), f_bkg.GetParameter(1), f_bkg.GetParameter(2)};
+    f_model.SetParameters(seeds);
+    f_model.FixParameter(3, 0.);
+    for (int i = 5; i < 8; ++i)
+        f_model.FixParameter(i, seeds[i]);
+    h->Fit(&f_model, "RQ");
+    f_model.ReleaseParameter(3);
+    h->Fit(&f_model, "RQ");
+    for (int i = 5; i < 8; ++i)
+        f_model.ReleaseParameter(i);
+    TFitResultPtr res = h->Fit(&f_model, "RSQE");
+
+    //  Signal only: background zeroed.
+    TF1 f_sig(TString::Format("f_sig_%s", h->GetName()).Data(), full_model, kFitLo, kFitHi, 8);
+    for (int i = 0; i < 8; ++i)
+        f_sig.SetParameter(i, i >= 5 ? 0. : f_model.GetParameter(i));
+    constexpr int kNGL = 500;
+    double gl_x[kNGL], gl_w[kNGL];
+    TF1::CalcGaussLegendreSamplingPoints(kNGL, gl_x, gl_w, 1e-10);
+
+    RadialFit fit;
+    fit.n_gamma = f_sig.IntegralFast(kNGL, gl_x, gl_w, kFitLo, kFitHi);
+    fit.n_gamma_err = f_model.GetParameter(0) > 0 ? fit.n_gamma * f_model.GetParError(0) / f_model.GetParameter(0) : 0.;
+    fit.mu = f_model.GetParameter(1);
+    fit.sigma = f_model.GetParameter(2);
+    fit.gs_frac = f_model.GetParameter(3) / (f_model.GetParameter(0) + 1e-9);
+    fit.chi2_ndf = (res.Get() && res->Ndf() > 0) ? res->Chi2() / res->Ndf() : -1.;
+    mist::logger::info(TString::Format("[%s]  N_gamma = %g +/- %g  mu = %g mm  sigma = %g mm  gs_frac = %g  chi2/ndf = %g",
+                                       h->GetName(), fit.n_gamma, fit.n_gamma_err, fit.mu, fit.sigma,
+                                       fit.gs_frac, fit.chi2_ndf)
+                           .Data());
+    return fit;
+}
+
+class PhotonNumberTask final : public AnalysisTask
+{
+    const ReadoutConfigStruct *cherenkov;
+
+    RootHist<TH1F> h_fit_x, h_fit_y, h_fit_r, h_dt;
+    std::vector<PhotonHit> signal_hits, dcr_hits;
+    long n_signal_frames = 0, n_dcr_frames = 0;
+    std::unordered_map<int, CoverageChannel> channels; ///< by GlobalIndex
+
+    //  Current spill: participants and 104 count, flushed into `channels`
+    //  at the next marker or range end.
+    bool in_spill = false;
+    std::vector<int> spill_channels;
+    long spill_signal_frames = 0;
+
+    void flush_spill()
+    {
+        if (in_spill)
+            for (const auto global_index : spill_channels)
+                channels[global_index].weight += spill_signal_frames;
+        in_spill = false;
+        spill_channels.clear();
+        spill_signal_frames = 0;
+    }
+
+    //  In-time non-afterpulse hits of @p recodata w.r.t. @p trigger_time.
+    void keep_hits(const AlcorRecodata &recodata, float trigger_time, std::vector<PhotonHit> &out)
+    {
+        for (int i = 0; i < static_cast<int>(recodata.get_recodata().size()); ++i)
+        {
+            if (recodata.is_afterpulse(i))
+                continue;
+            const float dt = recodata.get_hit_t(i) - trigger_time;
+            if (dt < kTimeCutNs[0] || dt > kTimeCutNs[1])
+                continue;
+            out.push_back({recodata.get_hit_x(i), recodata.get_hit_y(i),
+                           recodata.get_hit_x_rnd(i), recodata.get_hit_y_rnd(i),
+                           sensor_of(cherenkov, recodata.get_device(i))});
+        }
+    }
+
+public:
+    explicit PhotonNumberTask(const ReadoutConfigStruct *cherenkov) : cherenkov(cherenkov) {}
+
+    std::string name() const override { return "photon_number"; }
+    std::unique_ptr<AnalysisTask> clone() const override { return std::make_unique<PhotonNumberTask>(cherenkov); }
+
+    void init() override
+    {
+        h_fit_x.reset(new TH1F("h_fit_x", ";circle center x (mm)", 240, -30, 30));
+        h_fit_y.reset(new TH1F("h_fit_y", ";circle center y (mm)", 240, -30, 30));
+        h_fit_r.reset(new TH1F("h_fit_r", ";circle radius (mm)", 400, 30, 130));
+        h_dt.reset(new TH1F("h_dt", ";t_{Hit}-t_{trig} (ns)", 200, -312.5, 312.5));
+    }
+
+    void process(const TrainFrame &frame) override
+    {
+        const AlcorRecodata &recodata = frame.data;
+        const int n_hits = static_cast<int>(recodata.get_recodata().size());
+        if (recodata.is_start_of_spill())
+        {
+            flush_spill();
+            in_spill = true;
+            for (int i = 0; i < n_hits; ++i)
+            {
+                const int global_index = recodata.get_global_index(i);
+                spill_channels.push_back(global_index);
+                if (!channels.count(global_index))
+                    channels[global_index] = {recodata.get_hit_x(i), recodata.get_hit_y(i),
+                                              sensor_of(cherenkov, recodata.get_device(i))};
+            }
+            return;
+        }
+
+        if (const auto trigger = recodata.get_trigger_by_index(_TRIGGER_STREAMING_RING_FOUND_))
+        {
+            //  Circle fit on the in-time hits, seeded at the origin.
+            std::vector<std::array<float, 2>> points;
+            float radius_sum = 0.f;
+            for (int i = 0; i < n_hits; ++i)
+            {
+                if (recodata.is_afterpulse(i))
+                    continue;
+                const float dt = recodata.get_hit_t(i) - trigger->fine_time;
+                h_dt->Fill(dt);
+                if (dt < kTimeCutNs[0] || dt > kTimeCutNs[1])
+                    continue;
+                points.push_back({recodata.get_hit_x(i), recodata.get_hit_y(i)});
+                radius_sum += recodata.get_hit_r(i);
+            }
+            if (points.size() > 4)
+            {
+                const auto fit = fit_circle(points, {0.f, 0.f, radius_sum / points.size()}, false);
+                h_fit_x->Fill(fit[0][0]);
+                h_fit_y->Fill(fit[1][0]);
+                h_fit_r->Fill(fit[2][0]);
+            }
+            if (in_spill)
+            {
+                ++spill_signal_frames;
+                ++n_signal_frames;
+                keep_hits(recodata, trigger->fine_time, signal_hits);
+            }
+            return;
+        }
+
+        if (!in_spill)
+            return;
+        if (const auto trigger = recodata.get_trigger_by_index(TriggerFirstFrames))
+        {
+            ++n_dcr_frames;
+            keep_hits(recodata, trigger->fine_time, dcr_hits);
+        }
+    }
+
+    void end_chunk() override { flush_spill(); }
+
+    void merge(AnalysisTask &other) override
+    {
+        auto &o = static_cast<PhotonNumberTask &>(other);
+        h_fit_x->Add(o.h_fit_x.get());
+        h_fit_y->Add(o.h_fit_y.get());
+        h_fit_r->Add(o.h_fit_r.get());
+        h_dt->Add(o.h_dt.get());
+        signal_hits.insert(signal_hits.end(), o.signal_hits.begin(), o.signal_hits.end());
+        dcr_hits.insert(dcr_hits.end(), o.dcr_hits.begin(), o.dcr_hits.end());
+        o.signal_hits = {};
+        o.dcr_hits = {};
+        n_signal_frames += o.n_signal_frames;
+        n_dcr_frames += o.n_dcr_frames;
+        for (const auto &[global_index, channel] : o.channels)
+        {
+            auto [it, inserted] = channels.try_emplace(global_index, channel);
+            if (!inserted)
+                it->second.weight += channel.weight;
+        }
+    }
+
+    void finalize(const TrainContext &ctx, TDirectory *out) override
+    {
+        mist::logger::info(TString::Format("[photon_number] %ld physics triggers, %ld DCR frames",
+                                           n_signal_frames, n_dcr_frames)
+                               .Data());
+
+        //  Ring reference G: peaks of the circle-fit distributions.
+        const std::array<float, 2> center = {static_cast<float>(h_fit_x->GetBinCenter(h_fit_x->GetMaximumBin())),
+                                             static_cast<float>(h_fit_y->GetBinCenter(h_fit_y->GetMaximumBin()))};
+        const float ring_radius = h_fit_r->GetBinCenter(h_fit_r->GetMaximumBin());
+
+        //  ── Hit distributions around G ───────────────────────────────────
+        RootHist<TH2F> h_xy_hits("h_xy_hits", ";x (mm);y (mm)", 396, -99, 99, 396, -99, 99);
+        RootHist<TH2F> h_rphi_hits("h_rphi_hits", ";#phi (rad);R (mm)", 400, -TMath::Pi(), TMath::Pi(), 75, 25, 125);
+        //  [signal, dcr] × [full, in_gap, ex_gap, ex_gap_1350, ex_gap_1375]
+        const char *kScopes[5] = {"h_r_full", "h_r_in_gap", "h_r_ex_gap", "h_r_ex_gap_1350", "h_r_ex_gap_1375"};
+        std::array<std::array<RootHist<TH1F>, 5>, 2> h_r;
+        for (int s = 0; s < 5; ++s)
+        {
+            h_r[0][s].reset(new TH1F(kScopes[s], ";R (mm)", kRBins, kRLo, kRHi));
+            h_r[1][s].reset(new TH1F((std::string(kScopes[s]) + "_dcr").c_str(), ";R (mm)", kRBins, kRLo, kRHi));
+        }
+        auto fill_r = [&](const std::vector<PhotonHit> &hits, std::array<RootHist<TH1F>, 5> &h, bool maps)
+        {
+            for (const auto &hit : hits)
+            {
+                const float r = std::hypot(hit.x - center[0], hit.y - center[1]);
+                const float phi = std::atan2(hit.y - center[1], hit.x - center[0]);
+                if (maps)
+                {
+                    h_xy_hits->Fill(hit.x_rnd, hit.y_rnd);
+                    h_rphi_hits->Fill(std::atan2(hit.y_rnd - center[1], hit.x_rnd - center[0]),
+                                      std::hypot(hit.x_rnd - center[0], hit.y_rnd - center[1]));
+                }
+                h[0]->Fill(r);
+                const bool gap = in_phi_gap(phi);
+                h[gap ? 1 : 2]->Fill(r);
+                if (!gap && hit.sensor != SensorOther)
+                    h[hit.sensor == Sensor1350 ? 3 : 4]->Fill(r);
+            }
+        };
+        fill_r(signal_hits, h_r[0], true);
+        fill_r(dcr_hits, h_r[1], false);
+
+        //  ── Coverage of the active channels (3 mm pixels) ────────────────
+        constexpr int kRFineBins = 100 * kCoverageGranularity;
+        RootHist<TH2F> h_xy_cov("h_xy_cov", ";x (mm);y (mm)",
+                                396 * kCoverageGranularity, -99, 99, 396 * kCoverageGranularity, -99, 99);
+        std::array<RootHist<TH2F>, 3> h_rphi_cov; // all, 1350, 1375
+        const char *kCovNames[3] = {"h_rphi_cov", "h_rphi_cov_1350", "h_rphi_cov_1375"};
+        for (int k = 0; k < 3; ++k)
+            h_rphi_cov[k].reset(new TH2F(kCovNames[k], ";#phi (rad);R (mm)",
+                                         400 * kCoverageGranularity, -TMath::Pi(), TMath::Pi(), kRFineBins, kRLo, kRHi));
+        const float total_signal = std::max<long>(1, n_signal_frames);
+        std::vector<std::array<int, 2>> bins_rphi;
+        for (const auto &[global_index, channel] : channels)
+        {
+            if (channel.weight == 0)
+                continue;
+            const float w = channel.weight / total_signal;
+            const float cx = channel.x, cy = channel.y;
+            const int bxlo = h_xy_cov->GetXaxis()->FindBin(cx - 1.5f), bxhi = h_xy_cov->GetXaxis()->FindBin(cx + 1.5f);
+            const int bylo = h_xy_cov->GetYaxis()->FindBin(cy - 1.5f), byhi = h_xy_cov->GetYaxis()->FindBin(cy + 1.5f);
+            for (int bx = bxlo; bx <= bxhi; ++bx)
+                for (int by = bylo; by <= byhi; ++by)
+                    h_xy_cov->AddBinContent(h_xy_cov->GetBin(bx, by), w);
+
+            //  (φ, R) bins whose centre falls inside the pixel, about the origin.
+            const float cr = std::hypot(cx, cy), cphi = std::atan2(cy, cx);
+            const float dphi = 1.5f * std::sqrt(2.f) / cr, dr = 1.5f * std::sqrt(2.f);
+            TH2F *h_all = h_rphi_cov[0].get();
+            const int brlo = h_all->GetYaxis()->FindBin(cr - dr), brhi = h_all->GetYaxis()->FindBin(cr + dr);
+            const int bplo = h_all->GetXaxis()->FindBin(cphi - dphi), bphi = h_all->GetXaxis()->FindBin(cphi + dphi);
+            bins_rphi.clear();
+            for (int bp = bplo; bp <= bphi; ++bp)
+            {
+                const float phi_c = h_all->GetXaxis()->GetBinCenter(bp);
+                for (int br = brlo; br <= brhi; ++br)
+                {
+                    const float r_c = h_all->GetYaxis()->GetBinCenter(br);
+                    if (std::fabs(r_c * std::cos(phi_c) - cx) > 1.5f || std::fabs(r_c * std::sin(phi_c) - cy) > 1.5f)
+                        continue;
+                    if (std::find(bins_rphi.begin(), bins_rphi.end(), std::array<int, 2>{bp, br}) != bins_rphi.end())
+                        continue;
+                    bins_rphi.push_back({bp, br});
+                }
+            }
+            TH2F *h_sensor = channel.sensor == Sensor1350   ? h_rphi_cov[1].get()
+                             : channel.sensor == Sensor1375 ? h_rphi_cov[2].get()
+                                                            : nullptr;
+            for (const auto &b : bins_rphi)
+            {
+                h_all->AddBinContent(h_all->GetBin(b[0], b[1]), w);
+                if (h_sensor)
+                    h_sensor->AddBinContent(h_sensor->GetBin(b[0], b[1]), w);
+            }
+        }
+
+        //  ── Acceptance correction, DCR subtraction ───────────────────────
+        const TAxis *r_axis = h_r[0][0]->GetXaxis();
+        const float scale_in = phi_extrapolation_scale(kPhiGapRanges, true);
+        const float scale_ex = phi_extrapolation_scale(kPhiGapRanges, false);
+        const std::array<RootHist<TH1F>, 5> eff = {
+            RootHist<TH1F>(radial_efficiency(h_rphi_cov[0].get(), r_axis, {{-static_cast<float>(TMath::Pi()), static_cast<float>(TMath::Pi())}})),
+            RootHist<TH1F>(radial_efficiency(h_rphi_cov[0].get(), r_axis, kPhiGapRanges, true)),
+            RootHist<TH1F>(radial_efficiency(h_rphi_cov[0].get(), r_axis, kPhiGapRanges, false)),
+            RootHist<TH1F>(radial_efficiency(h_rphi_cov[1].get(), r_axis, kPhiGapRanges, false)),
+            RootHist<TH1F>(radial_efficiency(h_rphi_cov[2].get(), r_axis, kPhiGapRanges, false)),
+        };
+        const std::array<float, 5> phi_scale = {1.f, scale_in, scale_ex, scale_ex, scale_ex};
+        const std::array<long, 2> n_frames = {n_signal_frames, n_dcr_frames};
+        for (int k = 0; k < 2; ++k)
+            for (int s = 0; s < 5; ++s)
+            {
+                TH1F *h = h_r[k][s].get();
+                h->Scale(1. / std::max<long>(1, n_frames[k]));
+                h->Divide(eff[s].get());
+                h->Scale(1., "width");
+                h->Scale(phi_scale[s]);
+            }
+        for (int s = 0; s < 5; ++s)
+            h_r[0][s]->Add(h_r[1][s].get(), -1.);
+
+        //  ── Fits → standard_results.toml ─────────────────────────────────
+        const std::array<std::pair<const char *, const char *>, 5> kResultScope = {{
+            {"all", "full"}, {"all", "in_gap"}, {"all", "ex_gap"}, {"1350", "ex_gap"}, {"1375", "ex_gap"}}};
+        ResultMap entries;
+        for (int s = 0; s < 5; ++s)
+        {
+            const RadialFit fit = fit_r_dist(h_r[0][s].get(), ring_radius);
+            const auto &[sensor, scope] = kResultScope[s];
+            const std::string prefix = std::string(scope) + ".";
+            entries[{ctx.run_name, sensor, prefix + "n_gamma"}] = {fit.n_gamma, fit.n_gamma_err};
+            entries[{ctx.run_name, sensor, prefix + "mu"}] = {fit.mu, 0.};
+            entries[{ctx.run_name, sensor, prefix + "sigma"}] = {fit.sigma, 0.};
+            entries[{ctx.run_name, sensor, prefix + "gs_frac"}] = {fit.gs_frac, 0.};
+            entries[{ctx.run_name, sensor, prefix + "chi2_ndf"}] = {fit.chi2_ndf, 0.};
+        }
+        AnalysisResults(ctx.results_path()).update(entries);
+        mist::logger::info("[photon_number] Persisted " + std::to_string(entries.size()) + " results for run " + ctx.run_name);
+
+        if (n_signal_frames > 0)
+        {
+            h_dt->Scale(1. / n_signal_frames);
+            h_xy_hits->Scale(1. / n_signal_frames);
+            h_rphi_hits->Scale(1. / n_signal_frames);
+        }
+        out->WriteTObject(h_fit_x.get());
+        out->WriteTObject(h_fit_y.get());
+        out->WriteTObject(h_fit_r.get());
+        out->WriteTObject(h_dt.get());
+        out->WriteTObject(h_xy_hits.get());
+        out->WriteTObject(h_rphi_hits.get());
+        for (auto &row : h_r)
+            for (auto &h : row)
+                out->WriteTObject(h.get());
+        out->WriteTObject(h_xy_cov.get());
+        for (auto &h : h_rphi_cov)
+            out->WriteTObject(h.get());
+        RootHist<TH1F> h_ratio(static_cast<TH1F *>(h_r[0][4]->Clone("h_sensor_ratio")));
+        h_ratio->Divide(h_r[0][3].get());
+        h_ratio->SetTitle(";R (mm);yield ratio 1375/1350");
+        out->WriteTObject(h_ratio.get());
+    }
+};
+
+} // namespace
+
+std::unique_ptr<AnalysisTask> make_photon_number_task(const TrainContext &ctx)
+{
+    if (!ctx.cherenkov)
+        mist::logger::warning("[photon_number] no 'cherenkov' role in the readout config — per-sensor split disabled");
+    return std::make_unique<PhotonNumberTask>(ctx.cherenkov);
+}
+
+} // namespace btana::analysis
@@ -0,0 +1,269 @@
+/**
+ * @file analysis/tasks/ring_spatial_resolution.cxx
+ * @brief `ring_resolution` / `ring_resolution_tracked` train tasks — ports of
+ *        `macros/examples/ring_spatial_resolution.cpp` and
+ *        `macros/examples/ring_spatial_resolution_with_tracking.cpp`.
+ *
+ * First round (per frame): trigger-0 frames, non-afterpulse ring-tagged hits
+ * in the time window, free circle fit → ring centre / radius histograms.
+ * Second round (in finalize, seeded by the first-round means): the same
+ * frames' in-time hits within 3σ of the mean radius, fixed-centre fit,
+ * R vs N_γ and leave-one-out residuals → resolution function and SPSR.
+ *
+ * The macros re-read the trigger-0 frames for the second round; here
+ * `process` keeps their in-time non-afterpulse hits instead.  The tracked
+ * variant seeds the first round only with single-track frames whose
+ * |φ_track| ≤ 1, like its macro; the second round runs on every
+ * trigger-0 frame in both variants.
+ */
+
+#include "analysis/tasks.h"
+
+#include "alcor_recodata.h"
+#include "alcor_recotrackdata.h"
+#include "analysis_results.h"
+#include "utility/circle_fit.h"
+#include "utility/root_hist.h"
+
+#include <TDirectory.h>
+#include <TF1.h>
+#include <TGraphErrors.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TString.h>
+
+#include "mist/logger/logger.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace btana::analysis
+{
+
+namespace
+{
+
+//  Hit time w.r.t. the trigger [ns].
+constexpr std::array<float, 2> kTimeCutNs = {-45.f, 20.f};
+
+//  An in-time non-afterpulse hit kept for the second round; the pixel-
+//  randomised position feeds the QA map only.
+struct RingHit
+{
+    float x, y;
+    float x_rnd, y_rnd;
+};
+
+class RingResolutionTask final : public AnalysisTask
+{
+    bool tracked;
+
+    RootHist<TH1F> h_t_distribution;
+    RootHist<TH1F> h_first_round_X, h_first_round_Y, h_first_round_R;
+    RootHist<TH1F> h_tracking_theta, h_tracking_phi;
+    //  Second-round input: hits of frame k are hits[frame_begin[k], frame_begin[k + 1]).
+    std::vector<RingHit> hits;
+    std::vector<std::size_t> frame_begin;
+
+public:
+    explicit RingResolutionTask(bool tracked) : tracked(tracked) {}
+
+    std::string name() const override { return tracked ? "ring_resolution_tracked" : "ring_resolution"; }
+    bool needs_tracks() const override { return tracked; }
+    std::unique_ptr<AnalysisTask> clone() const override { return std::make_unique<RingResolutionTask>(tracked); }
+
+    void init() override
+    {
+        h_t_distribution.reset(new TH1F("h_t_distribution", ";t_{Hit} - t_{timing} (ns)", 200, -312.5, 312.5));
+        h_first_round_X.reset(new TH1F("h_first_round_X", ";circle center x coordinate (mm)", 120, -30, 30));
+        h_first_round_Y.reset(new TH1F("h_first_round_Y", ";circle center y coordinate (mm)", 120, -30, 30));
+        h_first_round_R.reset(new TH1F("h_first_round_R", ";circle radius (mm)", 200, 30, 130));
+        if (tracked)
+        {
+            h_tracking_theta.reset(new TH1F("h_tracking_theta", ";tracking #theta", 1000, 0, 0.1));
+            h_tracking_phi.reset(new TH1F("h_tracking_phi", ";tracking #phi", 1000, -3.1415, +3.1415));
+        }
+        frame_begin.assign(1, 0);
+    }
+
+    void process(const TrainFrame &frame) override
+    {
+        const AlcorRecodata &recodata = frame.data;
+        if (recodata.is_start_of_spill())
+            return;
+        const auto trigger = recodata.get_trigger_by_index(0);
+        if (!trigger)
+            return;
+
+        const int n_hits = static_cast<int>(recodata.get_recodata().size());
+        for (int i = 0; i < n_hits; ++i)
+        {
+            if (recodata.is_afterpulse(i))
+                continue;
+            const float dt = recodata.get_hit_t(i) - trigger->fine_time;
+            if (dt >= kTimeCutNs[0] && dt <= kTimeCutNs[1])
+                hits.push_back({recodata.get_hit_x(i), recodata.get_hit_y(i), recodata.get_hit_x_rnd(i), recodata.get_hit_y_rnd(i)});
+        }
+        frame_begin.push_back(hits.size());
+
+        if (tracked)
+        {
+            if (frame.track->n_recotrackdata() != 1)
+                return;
+            h_tracking_theta->Fill(frame.track->get_traj_angcoeff_theta(0));
+            h_tracking_phi->Fill(frame.track->get_traj_angcoeff_phi(0));
+            if (std::fabs(frame.track->get_traj_angcoeff_phi(0)) > 1)
+                return;
+        }
+
+        //  First round: ring-tagged (DBSCAN in R, t) in-time hits, free fit.
+        std::vector<std::array<float, 2>> points;
+        float radius_sum = 0.f;
+        for (int i = 0; i < n_hits; ++i)
+        {
+            if (recodata.is_afterpulse(i))
+                continue;
+            const float dt = recodata.get_hit_t(i) - trigger->fine_time;
+            h_t_distribution->Fill(dt);
+            if (dt < kTimeCutNs[0] || dt > kTimeCutNs[1] || !recodata.is_ring_tagged(i))
+                continue;
+            points.push_back({recodata.get_hit_x(i), recodata.get_hit_y(i)});
+            radius_sum += recodata.get_hit_r(i);
+        }
+        if (points.size() > 4)
+        {
+            const auto fit = fit_circle(points, {0.f, 0.f, radius_sum / points.size()}, false);
+            h_first_round_X->Fill(fit[0][0]);
+            h_first_round_Y->Fill(fit[1][0]);
+            h_first_round_R->Fill(fit[2][0]);
+        }
+    }
+
+    void merge(AnalysisTask &other) override
+    {
+        auto &o = static_cast<RingResolutionTask &>(other);
+        h_t_distribution->Add(o.h_t_distribution.get());
+        h_first_round_X->Add(o.h_first_round_X.get());
+        h_first_round_Y->Add(o.h_first_round_Y.get());
+        h_first_round_R->Add(o.h_first_round_R.get());
+        if (tracked)
+        {
+            h_tracking_theta->Add(o.h_tracking_theta.get());
+            h_tracking_phi->Add(o.h_tracking_phi.get());
+        }
+        const std::size_t offset = hits.size();
+        hits.insert(hits.end(), o.hits.begin(), o.hits.end());
+        for (std::size_t k = 1; k < o.frame_begin.size(); ++k)
+            frame_begin.push_back(offset + o.frame_begin[k]);
+        o.hits = {};
+        o.frame_begin = {};
+    }
+
+    void finalize(const TrainContext &ctx, TDirectory *out) override
+    {
+        const float center_x = h_first_round_X->GetMean();
+        const float center_y = h_first_round_Y->GetMean();
+        const float radius = h_first_round_R->GetMean();
+        const float radius_stddev = h_first_round_R->GetRMS();
+
+        //  ── Second round ─────────────────────────────────────────────────
+        RootHist<TH2F> h_second_round_xy_map("h_second_round_xy_map", ";x (mm);y (mm)", 396, -99, 99, 396, -99, 99);
+        RootHist<TH2F> h_second_round_R_Ngamma("h_second_round_R_Ngamma", ";circle radius (mm);N_{#gamma}", 200, 30, 130, 97, 3, 100);
+        RootHist<TH1F> h_second_round_R_excluded("h_second_round_R_excluded", ";circle radius - point radius (mm)", 120, -30, 30);
+        RootHist<TH1F> h_second_round_R_global("h_second_round_R_global", ";circle radius - point radius (mm)", 120, -30, 30);
+
+        std::vector<std::array<float, 2>> points;
+        for (std::size_t k = 0; k + 1 < frame_begin.size(); ++k)
+        {
+            points.clear();
+            for (std::size_t i = frame_begin[k]; i < frame_begin[k + 1]; ++i)
+            {
+                const RingHit &hit = hits[i];
+                if (std::fabs(std::hypot(hit.x - center_x, hit.y - center_y) - radius) > 3 * radius_stddev)
+                    continue;
+                points.push_back({hit.x, hit.y});
+                h_second_round_xy_map->Fill(hit.x_rnd, hit.y_rnd);
+            }
+            auto fit = fit_circle(points, {center_x, center_y, radius}, true);
+            h_second_round_R_Ngamma->Fill(fit[2][0], points.size());
+
+            //  Leave-one-out.
+            for (int excluded = 0; excluded < static_cast<int>(points.size()); ++excluded)
+            {
+                fit = fit_circle(points, {center_x, center_y, radius}, true, {excluded});
+                const float point_radius = std::hypot(points[excluded][0] - center_x, points[excluded][1] - center_y);
+                h_second_round_R_excluded->Fill(fit[2][0] - point_radius);
+                h_second_round_R_global->Fill(radius - point_radius);
+            }
+        }
+
+        //  ── Resolution vs N_γ ────────────────────────────────────────────
+        RootHist<TGraphErrors> g_resolution(new TGraphErrors());
+        g_resolution->SetName("g_resolution");
+        TF1 fit_gaus("fit_gaus", "gaus", 0, 150);
+        for (int y_bin = 1; y_bin <= h_second_round_R_Ngamma->GetNbinsY(); ++y_bin)
+        {
+            std::unique_ptr<TH1D> r_slice(h_second_round_R_Ngamma->ProjectionX(TString::Format("r_slice_%i", y_bin).Data(), y_bin, y_bin));
+            r_slice->SetDirectory(nullptr);
+            if (r_slice->GetEntries() < 100)
+                continue;
+            r_slice->Fit(&fit_gaus, "QNR");
+            if (fit_gaus.GetParError(2) / fit_gaus.GetParameter(2) > 0.075)
+                continue;
+            const int point = g_resolution->GetN();
+            g_resolution->SetPoint(point, h_second_round_R_Ngamma->GetYaxis()->GetBinCenter(y_bin), fit_gaus.GetParameter(2));
+            g_resolution->SetPointError(point, 0., fit_gaus.GetParError(2));
+        }
+
+        //  σ_R(N) = sqrt(SPSR² / N + const²)
+        TF1 f_resolution("f_resolution", "TMath::Sqrt([0] *[0] / x + [1] *[1])", 0, 100);
+        f_resolution.SetParameters(2.5, 0.5);
+        f_resolution.SetParName(0, "SPSR");
+        f_resolution.SetParName(1, "constant");
+        g_resolution->Fit(&f_resolution, "Q");
+
+        //  One ring over both SiPM models → "all" scope.
+        const ResultKey key_spsr{ctx.run_name, "all", tracked ? "ring.spatial_resolution.tracked" : "ring.spatial_resolution"};
+        const ResultKey key_const{ctx.run_name, "all", tracked ? "ring.spatial_resolution_const.tracked" : "ring.resolution_constant"};
+        const ResultKey key_radius{ctx.run_name, "all", tracked ? "ring.radius_mm.tracked" : "ring.radius_mm"};
+        ResultMap entries{
+            {key_spsr, {f_resolution.GetParameter(0), f_resolution.GetParError(0)}},
+            {key_const, {f_resolution.GetParameter(1), f_resolution.GetParError(1)}},
+            {key_radius, {radius, radius_stddev}},
+        };
+        if (!tracked)
+        {
+            //  Direct SPSR: width of the leave-one-out radius residuals.
+            TF1 spsr_direct_fit("spsr_direct_fit", "gaus", -30, 30);
+            h_second_round_R_excluded->Fit(&spsr_direct_fit, "QNR");
+            entries[{ctx.run_name, "all", "ring.spsr_sigma_mm"}] = {spsr_direct_fit.GetParameter(2), spsr_direct_fit.GetParError(2)};
+        }
+        AnalysisResults(ctx.results_path()).update(entries, tracked ? "recotrack" : "recodata");
+        mist::logger::info("[" + name() + "] resolution results written to standard_results.toml for run " + ctx.run_name);
+
+        out->WriteTObject(h_t_distribution.get());
+        out->WriteTObject(h_first_round_X.get());
+        out->WriteTObject(h_first_round_Y.get());
+        out->WriteTObject(h_first_round_R.get());
+        out->WriteTObject(h_second_round_xy_map.get());
+        out->WriteTObject(h_second_round_R_Ngamma.get());
+        out->WriteTObject(h_second_round_R_excluded.get());
+        out->WriteTObject(h_second_round_R_global.get());
+        out->WriteTObject(g_resolution.get());
+        if (tracked)
+        {
+            out->WriteTObject(h_tracking_theta.get());
+            out->WriteTObject(h_tracking_phi.get());
+        }
+    }
+};
+
+} // namespace
+
+std::unique_ptr<AnalysisTask> make_ring_resolution_task(const TrainContext &, bool tracked)
+{
+    return std::make_unique<RingResolutionTask>(tracked);
+}
+
+} // namespace btana::analysis
@@ -0,0 +1,256 @@
+/**
+ * @file analysis/train.cxx
+ * @brief Implementation of the single-pass analysis train declared in
+ *        `analysis/train.h`: task registry, spill-aligned range planning,
+ *        the parallel scan and the merge / finalise tail.
+ */
+
+#include "analysis/train.h"
+#include "analysis/tasks.h"
+
+#include "alcor_recodata.h"
+#include "alcor_recotrackdata.h"
+#include "triggers/events.h"
+#include "utility/task_pool.h"
+
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+#include "mist/logger/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace btana::analysis
+{
+
+// ─────────────────────────────────────────────────────────────────────
+//  Registry
+// ─────────────────────────────────────────────────────────────────────
+
+std::vector<std::string> train_task_names()
+{
+    return {"afterpulse", "cross_talk", "dark_count_rate",
+            "ring_resolution", "ring_resolution_tracked", "photon_number"};
+}
+
+std::unique_ptr<AnalysisTask> make_train_task(const std::string &name, const TrainContext &ctx)
+{
+    if (name == "afterpulse")
+        return make_afterpulse_task(ctx);
+    if (name == "cross_talk")
+        return make_cross_talk_task(ctx);
+    if (name == "dark_count_rate")
+        return make_dark_count_rate_task(ctx);
+    if (name == "ring_resolution")
+        return make_ring_resolution_task(ctx, false);
+    if (name == "ring_resolution_tracked")
+        return make_ring_resolution_task(ctx, true);
+    if (name == "photon_number")
+        return make_photon_number_task(ctx);
+    return nullptr;
+}
+
+namespace
+{
+
+//  TTree cache per slot; one cluster of a production file is a few MB.
+constexpr Long64_t kTrainCacheBytes = 64LL << 20;
+//  Entry ranges per worker slot, for load balance.
+constexpr std::size_t kTrainChunksPerSlot = 4;
+
+struct TrainChunk
+{
+    Long64_t first = 0, last = 0; ///< [first, last)
+};
+
+//  Entry of every start-of-spill marker below @p n_entries.  Reads the
+//  `trigger_mask` branch alone when the tree has it, else `triggers`.
+std::vector<Long64_t> find_spill_markers(TTree *t, Long64_t n_entries)
+{
+    AlcorRecodata recodata;
+    recodata.link_to_tree(t);
+    t->SetBranchStatus("*", false);
+    t->SetBranchStatus(t->GetBranch("trigger_mask") ? "trigger_mask" : "triggers*", true);
+    std::vector<Long64_t> markers;
+    for (Long64_t i = 0; i < n_entries; ++i)
+    {
+        t->GetEntry(i);
+        if (recodata.is_start_of_spill())
+            markers.push_back(i);
+    }
+    t->ResetBranchAddresses();
+    t->SetBranchStatus("*", true);
+    return markers;
+}
+
+//  Whole spills, grouped into ~n_chunks [first, last) ranges of similar
+//  size.  Every range but the first starts at a marker; the first starts
+//  at entry 0 (frames before the first marker, if any, ride along).
+std::vector<TrainChunk> plan_spill_chunks(const std::vector<Long64_t> &markers,
+                                          Long64_t n_entries, std::size_t n_chunks)
+{
+    const Long64_t target = std::max<Long64_t>(1, n_entries / static_cast<Long64_t>(std::max<std::size_t>(1, n_chunks)));
+    std::vector<TrainChunk> chunks;
+    Long64_t start = 0;
+    for (const auto marker : markers)
+        if (marker > start && marker - start >= target)
+        {
+            chunks.push_back({start, marker});
+            start = marker;
+        }
+    if (start < n_entries)
+        chunks.push_back({start, n_entries});
+    return chunks;
+}
+
+const char *tree_name_of(TrainInput input)
+{
+    return input == TrainInput::Recotrackdata ? "recotrackdata" : "recodata";
+}
+
+} // namespace
+
+int run_train(const TrainContext &ctx,
+              std::vector<std::unique_ptr<AnalysisTask>> &tasks,
+              const TrainOptions &options)
+{
+    if (tasks.empty())
+    {
+        mist::logger::error("[analysis_train] no tasks to run");
+        return 1;
+    }
+    const bool any_tracks = std::any_of(tasks.begin(), tasks.end(), [](const auto &task)
+                                        { return task->needs_tracks(); });
+    const TrainInput input = options.input.value_or(any_tracks ? TrainInput::Recotrackdata : TrainInput::Recodata);
+    if (any_tracks && input != TrainInput::Recotrackdata)
+    {
+        mist::logger::error("[analysis_train] a selected task needs tracks; run it on recotrackdata");
+        return 1;
+    }
+
+    const char *tree_name = tree_name_of(input);
+    const std::string input_file = ctx.data_repository + "/" + ctx.run_name + "/" + tree_name + ".root";
+    const std::string output_file = options.output_file.empty()
+                                        ? ctx.data_repository + "/" + ctx.run_name + "/analysis_train.root"
+                                        : options.output_file;
+
+    //  ── Plan ─────────────────────────────────────────────────────────────
+    std::vector<TrainChunk> chunks;
+    Long64_t n_entries = 0;
+    {
+        std::unique_ptr<TFile> f(TFile::Open(input_file.c_str(), "READ"));
+        auto *t = (f && !f->IsZombie()) ? f->Get<TTree>(tree_name) : nullptr;
+        if (!t)
+        {
+            mist::logger::error("[analysis_train] cannot read tree '" + std::string(tree_name) + "' from " + input_file);
+            return 1;
+        }
+        n_entries = t->GetEntries();
+        if (options.max_frames >= 0)
+            n_entries = std::min<Long64_t>(n_entries, options.max_frames);
+        const auto markers = find_spill_markers(t, n_entries);
+        chunks = plan_spill_chunks(markers, n_entries, util::TaskPool::instance().concurrency() * kTrainChunksPerSlot);
+        mist::logger::info("[analysis_train] " + std::to_string(n_entries) + " entries, " +
+                           std::to_string(markers.size()) + " spills, " +
+                           std::to_string(chunks.size()) + " ranges");
+    }
+
+    //  ── Clone + init, all on this thread ─────────────────────────────────
+    const std::size_t n_slots = std::min(util::TaskPool::instance().concurrency(), chunks.size());
+    std::vector<std::vector<std::unique_ptr<AnalysisTask>>> slot_tasks(n_slots);
+    for (auto &task : tasks)
+        task->init();
+    for (auto &slot : slot_tasks)
+        for (const auto &task : tasks)
+        {
+            slot.push_back(task->clone());
+            slot.back()->init();
+        }
+
+    //  ── Scan ─────────────────────────────────────────────────────────────
+    //  Each slot owns its TFile / TTree; ROOT's globals need the lock.
+    ROOT::EnableThreadSafety();
+    const auto t_start = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    {
+        util::TaskGroup group;
+        for (std::size_t slot = 0; slot < n_slots; ++slot)
+            group.run([&, slot]
+                      {
+                          std::unique_ptr<TFile> f(TFile::Open(input_file.c_str(), "READ"));
+                          auto *t = (f && !f->IsZombie()) ? f->Get<TTree>(tree_name) : nullptr;
+                          if (!t)
+                          {
+                              failed = true;
+                              return;
+                          }
+                          t->SetCacheSize(kTrainCacheBytes);
+                          //  recotrackdata is-a recodata: one GetEntry fills both views.
+                          std::unique_ptr<AlcorRecodata> data;
+                          const AlcorRecotrackdata *track = nullptr;
+                          if (input == TrainInput::Recotrackdata)
+                          {
+                              auto recotrackdata = std::make_unique<AlcorRecotrackdata>();
+                              recotrackdata->link_to_tree(t);
+                              track = recotrackdata.get();
+                              data = std::move(recotrackdata);
+                          }
+                          else
+                          {
+                              data = std::make_unique<AlcorRecodata>();
+                              data->link_to_tree(t);
+                          }
+                          auto &clones = slot_tasks[slot];
+                          for (std::size_t c; (c = next.fetch_add(1)) < chunks.size();)
+                          {
+                              t->SetCacheEntryRange(chunks[c].first, chunks[c].last);
+                              for (Long64_t i = chunks[c].first; i < chunks[c].last; ++i)
+                              {
+                                  t->GetEntry(i);
+                                  const TrainFrame frame{i, *data, track};
+                                  for (auto &task : clones)
+                                      task->process(frame);
+                              }
+                              for (auto &task : clones)
+                                  task->end_chunk();
+                          }
+                      });
+        group.wait();
+    }
+    if (failed)
+    {
+        mist::logger::error("[analysis_train] a reader could not open " + input_file);
+        return 1;
+    }
+    const double scan_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+    mist::logger::info("[analysis_train] scanned " + std::to_string(n_entries) + " entries for " +
+                       std::to_string(tasks.size()) + " tasks in " + std::to_string(scan_s) + " s");
+
+    //  ── Merge + finalise ─────────────────────────────────────────────────
+    for (auto &slot : slot_tasks)
+        for (std::size_t k = 0; k < tasks.size(); ++k)
+            tasks[k]->merge(*slot[k]);
+    slot_tasks.clear();
+
+    std::unique_ptr<TFile> out(TFile::Open(output_file.c_str(), "RECREATE"));
+    if (!out || out->IsZombie())
+    {
+        mist::logger::error("[analysis_train] cannot write " + output_file);
+        return 1;
+    }
+    for (auto &task : tasks)
+    {
+        TDirectory *dir = out->mkdir(task->name().c_str());
+        task->finalize(ctx, dir);
+    }
+    out->Close();
+    mist::logger::info("[analysis_train] histograms written to " + output_file);
+    return 0;
+}
+
+} // namespace btana::analysis
@@ -11,6 +11,17 @@
  * Same load → patch → rewrite cycle as the previous ROOT-backed
  * implementation; toml++ handles the serialisation both ways.
  *
+ * Journal: ResultsBackend::Journal handles append binary records to
+ * ``<file>.journal`` instead (layout in analysis_results.h).  Each
+ * handle keeps a hash index of TOML + journal; readers and writers
+ * bring it up to date under the ``<file>.lock`` flock (shared for
+ * readers, exclusive for writers) by scanning only the journal bytes
+ * added since their last call, or from scratch after the TOML or the
+ * journal generation changed.  Compaction writes the TOML from the
+ * index, then replaces the journal with an empty one of a fresh
+ * generation; a crash in between only leaves records that replay to
+ * what the TOML already holds.
+ *
  * The TTree backend was retired (see DISCUSSION.md
  * "AnalysisResults: TTree → TOML").  Any leftover .root files from
  * the dual-backend phase can be ignored — they're stale on first
@@ -23,6 +34,11 @@
 #include "analysis_results.h"
 #include <mist/logger/logger.h>
 
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <fcntl.h>
 #include <filesystem>
 #include <fstream>
@@ -30,16 +46,288 @@
 #include <sstream>
 #include <sys/file.h> // flock(2) — POSIX advisory file lock
 #include <system_error>
-#include <unistd.h> // close(2), getpid(2)
+#include <unistd.h> // close(2), getpid(2), ftruncate(2)
 
 #include "utility/audit.h"      // per-write provenance log
 #include "utility/toml_utils.h" // toml++
 
+namespace
+{
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Lock file
+// ─────────────────────────────────────────────────────────────────────────────
+
+//  flock(2) on the sidecar ``<fPath>.lock`` for the lifetime of the
+//  object.  We intentionally leave the lock file on disk after release —
+//  creating / unlinking races between processes are a known pitfall,
+//  and an empty lock file is harmless.  On failure the caller proceeds
+//  without the lock (logged), as before.
+//
+//  flock locks belong to the open file description, so a second
+//  FileLock in the same process blocks against the first: code that
+//  already holds one calls the *_locked helpers, never load()/find().
+class FileLock
+{
+public:
+    FileLock(const std::string &path, int operation)
+    {
+        fFd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fFd < 0)
+        {
+            mist::logger::error("[AnalysisResults] cannot open lock file " +
+                                path + " — proceeding without lock");
+            return;
+        }
+        if (::flock(fFd, operation) < 0)
+        {
+            mist::logger::error("[AnalysisResults] flock(" +
+                                std::string(operation == LOCK_EX ? "LOCK_EX" : "LOCK_SH") +
+                                ") failed on " + path + " — proceeding without lock "
+                                                        "(concurrent writes may interleave)");
+            ::close(fFd);
+            fFd = -1;
+        }
+    }
+    ~FileLock()
+    {
+        if (fFd >= 0)
+        {
+            ::flock(fFd, LOCK_UN);
+            ::close(fFd);
+        }
+    }
+    FileLock(const FileLock &) = delete;
+    FileLock &operator=(const FileLock &) = delete;
+
+private:
+    int fFd = -1;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Journal encoding
+// ─────────────────────────────────────────────────────────────────────────────
+
+//  Records are written in host byte order; every platform the analysis
+//  runs on is little-endian, which is what the layout (and the
+//  dashboard's reader) specifies.
+static_assert(std::endian::native == std::endian::little,
+              "results journal layout assumes a little-endian host");
+
+constexpr char kJournalMagic[8] = {'B', 'T', 'R', 'E', 'S', 'J', 'N', 'L'};
+constexpr std::size_t kJournalHeaderBytes = sizeof(kJournalMagic) + sizeof(uint64_t);
+constexpr std::size_t kRecordHeaderBytes = sizeof(uint32_t) + sizeof(uint64_t);
+constexpr uint8_t kRecordUpsert = 1;
+//  Far above any real record (three short strings + two doubles); a
+//  larger length field can only be corruption.
+constexpr uint32_t kMaxPayloadBytes = 1u << 20;
+
+//  64-bit FNV-1a, the checksum of each record's payload.
+uint64_t fnv1a(const char *data, std::size_t n)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+template <class T>
+void put(std::string &out, const T &v)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &v, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <class T>
+T get(const char *p)
+{
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+std::string journal_header(uint64_t generation)
+{
+    std::string out(kJournalMagic, sizeof(kJournalMagic));
+    put(out, generation);
+    return out;
+}
+
+//  Append one upsert record to @p out.  False (nothing appended) when a
+//  key component does not fit its u16 length field.
+bool encode_record(std::string &out, const ResultKey &key, const ResultEntry &entry)
+{
+    for (const std::string *field : {&key.run, &key.sensor, &key.quantity})
+        if (field->size() > UINT16_MAX)
+            return false;
+
+    std::string payload;
+    put(payload, kRecordUpsert);
+    for (const std::string *field : {&key.run, &key.sensor, &key.quantity})
+    {
+        put(payload, static_cast<uint16_t>(field->size()));
+        payload += *field;
+    }
+    put(payload, entry.value);
+    put(payload, entry.error);
+
+    put(out, static_cast<uint32_t>(payload.size()));
+    put(out, fnv1a(payload.data(), payload.size()));
+    out += payload;
+    return true;
+}
+
+//  Decode one payload; false on a malformed one (bad kind or lengths).
+bool decode_payload(const char *p, std::size_t n, ResultKey &key, ResultEntry &entry)
+{
+    if (n < 1 || static_cast<uint8_t>(p[0]) != kRecordUpsert)
+        return false;
+    std::size_t at = 1;
+    for (std::string *field : {&key.run, &key.sensor, &key.quantity})
+    {
+        if (at + sizeof(uint16_t) > n)
+            return false;
+        const auto len = get<uint16_t>(p + at);
+        at += sizeof(uint16_t);
+        if (at + len > n)
+            return false;
+        field->assign(p + at, len);
+        at += len;
+    }
+    if (at + 2 * sizeof(double) != n)
+        return false;
+    entry.value = get<double>(p + at);
+    entry.error = get<double>(p + at + sizeof(double));
+    return true;
+}
+
+//  Generation of the journal at @p path, or 0 when it is missing or its
+//  header is not ours.
+uint64_t read_journal_generation(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char header[kJournalHeaderBytes];
+    if (!in.read(header, sizeof(header)) ||
+        std::memcmp(header, kJournalMagic, sizeof(kJournalMagic)) != 0)
+        return 0;
+    return get<uint64_t>(header + sizeof(kJournalMagic));
+}
+
+//  One sequential pass over the journal from byte @p from (0 = start,
+//  header included), handing each intact record to @p apply.  Stops at
+//  the first truncated or corrupt record — everything after it is
+//  unreachable anyway, since the next append cuts the file there.
+//  Returns the end of the last intact record (0 if the header is bad).
+template <class Apply>
+std::uintmax_t scan_journal(const std::string &path, std::uintmax_t from, Apply &&apply)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return 0;
+    if (from < kJournalHeaderBytes)
+    {
+        char header[kJournalHeaderBytes];
+        if (!in.read(header, sizeof(header)) ||
+            std::memcmp(header, kJournalMagic, sizeof(kJournalMagic)) != 0)
+            return 0;
+        from = kJournalHeaderBytes;
+    }
+    in.seekg(static_cast<std::streamoff>(from));
+    const std::string tail{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+
+    std::size_t at = 0;
+    ResultKey key;
+    ResultEntry entry;
+    while (at + kRecordHeaderBytes <= tail.size())
+    {
+        const auto n = get<uint32_t>(tail.data() + at);
+        const auto checksum = get<uint64_t>(tail.data() + at + sizeof(uint32_t));
+        const char *payload = tail.data() + at + kRecordHeaderBytes;
+        if (n > kMaxPayloadBytes || at + kRecordHeaderBytes + n > tail.size() ||
+            fnv1a(payload, n) != checksum || !decode_payload(payload, n, key, entry))
+            break;
+        apply(key, entry);
+        at += kRecordHeaderBytes + n;
+    }
+    return from + at;
+}
+
+//  Journal generations only move forward; seeding from the clock keeps a
+//  deleted-and-recreated journal from reusing a generation some handle
+//  has already indexed.
+uint64_t next_generation(uint64_t previous)
+{
+    const auto now = static_cast<uint64_t>(
+        std::chrono::system_clock::now().time_since_epoch() / std::chrono::nanoseconds(1));
+    return std::max(previous + 1, now);
+}
+
+//  Write @p bytes at the current offset of @p fd, riding out short writes.
+bool write_all(int fd, const std::string &bytes)
+{
+    std::size_t done = 0;
+    while (done < bytes.size())
+    {
+        const ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        done += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+//  (mtime, size) of the TOML; both 0 when it does not exist.
+std::pair<int64_t, std::uintmax_t> file_stamp(const std::string &path)
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return {0, 0};
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    return {ec ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count()), size};
+}
+
+//  Hash key of a (run, sensor) or (quantity, sensor) pair; 0x1f (unit
+//  separator) never occurs in run, sensor or quantity names.
+std::string join_key(const std::string &first, const std::string &sensor)
+{
+    return first + '\x1f' + sensor;
+}
+
+} // namespace
+
 // ─────────────────────────────────────────────────────────────────────────────
 //  AnalysisResults::load
 // ─────────────────────────────────────────────────────────────────────────────
 
 ResultMap AnalysisResults::load() const
+{
+    FileLock lock(fPath + ".lock", LOCK_SH);
+    refresh_index_locked();
+    return ResultMap(fIndex.begin(), fIndex.end());
+}
+
+std::optional<ResultEntry> AnalysisResults::find(const ResultKey &key) const
+{
+    FileLock lock(fPath + ".lock", LOCK_SH);
+    refresh_index_locked();
+    const auto it = fIndex.find(key);
+    if (it == fIndex.end())
+        return std::nullopt;
+    return it->second;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  AnalysisResults::read_toml  (private)
+// ─────────────────────────────────────────────────────────────────────────────
+
+ResultMap AnalysisResults::read_toml() const
 {
     ResultMap out;
 
@@ -99,6 +387,121 @@ ResultMap AnalysisResults::load() const
     return out;
 }
 
+// ─────────────────────────────────────────────────────────────────────────────
+//  Index  (private)
+// ─────────────────────────────────────────────────────────────────────────────
+
+void AnalysisResults::index_put(const ResultKey &key, const ResultEntry &entry) const
+{
+    const auto [it, inserted] = fIndex.insert_or_assign(key, entry);
+    if (inserted)
+        fQuantities[join_key(key.run, key.sensor)].push_back(key.quantity);
+    fColumnsBuilt = false;
+}
+
+/**
+ * @details
+ * Cost per call when nothing changed: two stat(2)s and a 16-byte header
+ * read.  A rebuild re-parses the TOML and replays the whole journal in
+ * one sequential scan; otherwise only the bytes appended since the last
+ * call are decoded.  A torn tail is not re-read until the journal size
+ * changes.
+ */
+void AnalysisResults::refresh_index_locked() const
+{
+    const std::string jpath = journal_path();
+    const auto [toml_mtime, toml_size] = file_stamp(fPath);
+    const uint64_t generation = read_journal_generation(jpath);
+    std::error_code ec;
+    std::uintmax_t journal_size = std::filesystem::file_size(jpath, ec);
+    if (ec)
+        journal_size = 0;
+
+    const bool rebuild = !fIndexBuilt ||
+                         toml_mtime != fTomlMtime || toml_size != fTomlSize ||
+                         generation != fJournalGeneration ||
+                         journal_size < fJournalOffset;
+    if (rebuild)
+    {
+        fIndex.clear();
+        fQuantities.clear();
+        fColumnsBuilt = false;
+        for (const auto &[key, entry] : read_toml())
+            index_put(key, entry);
+        fTomlMtime = toml_mtime;
+        fTomlSize = toml_size;
+        fJournalGeneration = generation;
+        fJournalOffset = 0;
+        fJournalSize = 0;
+        fIndexBuilt = true;
+    }
+    if (generation != 0 && (rebuild || journal_size != fJournalSize))
+        fJournalOffset = scan_journal(jpath, fJournalOffset,
+                                      [this](const ResultKey &key, const ResultEntry &entry)
+                                      { index_put(key, entry); });
+    fJournalSize = journal_size;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Column store
+// ─────────────────────────────────────────────────────────────────────────────
+
+std::optional<ResultEntry> ResultColumn::find(const std::string &run) const
+{
+    const auto it = std::lower_bound(runs.begin(), runs.end(), run);
+    if (it == runs.end() || *it != run)
+        return std::nullopt;
+    const auto i = static_cast<std::size_t>(it - runs.begin());
+    return ResultEntry{values[i], errors[i]};
+}
+
+/**
+ * @details
+ * One pass over the index buckets every entry by (quantity, sensor), then
+ * each column is put in run order.  Any index_put() — an update() or new
+ * journal records picked up by a refresh — drops the whole store; it is
+ * rebuilt on the next trend query, so a burst of updates costs one
+ * rebuild, not one per update.
+ */
+const std::unordered_map<std::string, ResultColumn> &AnalysisResults::columns_locked() const
+{
+    if (fColumnsBuilt)
+        return fColumns;
+
+    std::unordered_map<std::string, std::vector<std::pair<const std::string *, const ResultEntry *>>> buckets;
+    for (const auto &[key, entry] : fIndex)
+        buckets[join_key(key.quantity, key.sensor)].emplace_back(&key.run, &entry);
+
+    fColumns.clear();
+    fColumns.reserve(buckets.size());
+    for (auto &[name, rows] : buckets)
+    {
+        std::sort(rows.begin(), rows.end(),
+                  [](const auto &a, const auto &b) { return *a.first < *b.first; });
+        ResultColumn &column = fColumns[name];
+        column.runs.reserve(rows.size());
+        column.values.reserve(rows.size());
+        column.errors.reserve(rows.size());
+        for (const auto &[run, entry] : rows)
+        {
+            column.runs.push_back(*run);
+            column.values.push_back(entry->value);
+            column.errors.push_back(entry->error);
+        }
+    }
+    fColumnsBuilt = true;
+    return fColumns;
+}
+
+ResultColumn AnalysisResults::column(const std::string &sensor, const std::string &quantity) const
+{
+    FileLock lock(fPath + ".lock", LOCK_SH);
+    refresh_index_locked();
+    const auto &columns = columns_locked();
+    const auto it = columns.find(join_key(quantity, sensor));
+    return it == columns.end() ? ResultColumn{} : it->second;
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 //  AnalysisResults::write  (private)
 // ─────────────────────────────────────────────────────────────────────────────
@@ -181,94 +584,26 @@ void AnalysisResults::write(const ResultMap &data,
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-//  AnalysisResults::update
+//  AnalysisResults::replace_toml  (private)
 // ─────────────────────────────────────────────────────────────────────────────
 
 /**
  * @details
- * The load → patch → rewrite cycle guarantees upsert semantics:
- *  1. Acquire an exclusive ``flock(2)`` on a sidecar ``<fPath>.lock``
- *     file so concurrent writers from different processes (e.g.
- *     ``lightdata_writer`` and ``recodata_writer`` finishing at the
- *     same wall-clock tick) serialise here instead of racing through
- *     load → merge → write and clobbering each other.
- *  2. Load current on-disk state into a local ResultMap.
- *  3. Overwrite or insert every entry from @p entries.
- *  4. Write the merged map to ``<fPath>.tmp.<pid>``.
- *  5. ``std::filesystem::rename`` tmp → final.  POSIX rename is atomic
- *     on the same filesystem (tmp + final are siblings, so this holds):
- *     readers either see the old file or the new file, never a half-
- *     written TOML.
- *  6. Release the flock.
- *
- * Sweep audit: re-applies the CLEAN_OFF C2.1 concept on
- * the post-migration TOML backend.  The race window is identical to
- * the previous ROOT-backed implementation; only the file format
- * changed.
- *
- * Entries present on disk but absent from @p entries are left untouched.
- *
- * Failure modes:
- *  - open / flock on the lock file fails → log error, proceed
- *    WITHOUT the lock (concurrent writes may interleave; single-writer
- *    case still atomic individually via step 5).
- *  - write to tmp fails → ofstream errors are logged inside write();
- *    the subsequent rename guard handles the missing-tmp case.
- *  - rename fails → tmp is best-effort removed; fPath unchanged.
+ * Writes to ``<fPath>.tmp.<pid>`` then ``std::filesystem::rename``s it
+ * over @ref fPath.  POSIX rename is atomic on the same filesystem (tmp
+ * + final are siblings, so this holds): readers either see the old
+ * file or the new file, never a half-written TOML.
  *
  * Stale tmp files (process killed between write() and rename()) are
  * tolerated rather than swept on every call — they're small and
  * harmless.
  */
-void AnalysisResults::update(const ResultMap &entries,
-                             const std::string &source) const
+bool AnalysisResults::replace_toml(const ResultMap &data) const
 {
     namespace fs = std::filesystem;
 
-    // ── Cross-process advisory lock on a sidecar pidfile ─────────────────────
-    //  Lifetime tied to this function via a local guard struct.  We
-    //  intentionally leave the lock file on disk after release —
-    //  creating / unlinking races between processes are a known pitfall,
-    //  and an empty lock file is harmless.
-    const std::string lock_path = fPath + ".lock";
-    int lock_fd = ::open(lock_path.c_str(), O_WRONLY | O_CREAT, 0644);
-    if (lock_fd >= 0)
-    {
-        if (::flock(lock_fd, LOCK_EX) < 0)
-        {
-            mist::logger::error("[AnalysisResults] flock(LOCK_EX) failed on " +
-                                lock_path + " — proceeding without lock "
-                                            "(concurrent writes may interleave)");
-            ::close(lock_fd);
-            lock_fd = -1;
-        }
-    }
-    else
-    {
-        mist::logger::error("[AnalysisResults] cannot open lock file " +
-                            lock_path + " — proceeding without lock");
-    }
-    struct LockGuard
-    {
-        int fd;
-        ~LockGuard()
-        {
-            if (fd >= 0)
-            {
-                ::flock(fd, LOCK_UN);
-                ::close(fd);
-            }
-        }
-    } guard{lock_fd};
-
-    // ── Load + merge ─────────────────────────────────────────────────────────
-    ResultMap current = load();
-    for (const auto &kv : entries)
-        current[kv.first] = kv.second;
-
-    // ── Write to tmp + atomic rename ─────────────────────────────────────────
     const std::string tmp_path = fPath + ".tmp." + std::to_string(::getpid());
-    write(current, tmp_path);
+    write(data, tmp_path);
 
     std::error_code ec;
     fs::rename(tmp_path, fPath, ec);
@@ -279,6 +614,185 @@ void AnalysisResults::update(const ResultMap &entries,
                             ec.message() + " — fPath unchanged");
         std::error_code ec_rm;
         fs::remove(tmp_path, ec_rm); // best-effort cleanup
+        return false;
+    }
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  AnalysisResults::compact
+// ─────────────────────────────────────────────────────────────────────────────
+
+/**
+ * @details
+ * Order matters for crash safety: the TOML is replaced first, so until
+ * the journal is reset its records merely duplicate what the TOML now
+ * holds.  The empty journal is itself staged and renamed into place, and
+ * carries a new generation so every other handle rebuilds its index
+ * instead of resuming at a stale offset.
+ */
+bool AnalysisResults::compact_locked() const
+{
+    namespace fs = std::filesystem;
+
+    if (!replace_toml(ResultMap(fIndex.begin(), fIndex.end())))
+        return false;
+    std::tie(fTomlMtime, fTomlSize) = file_stamp(fPath);
+
+    const std::string jpath = journal_path();
+    std::error_code ec;
+    if (!fs::exists(jpath, ec))
+        return true;
+
+    const uint64_t generation = next_generation(fJournalGeneration);
+    const std::string tmp_path = jpath + ".tmp." + std::to_string(::getpid());
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out << journal_header(generation);
+        if (!out)
+        {
+            mist::logger::error("[AnalysisResults] cannot write '" + tmp_path +
+                                "' — journal kept (it replays onto the compacted TOML)");
+            fs::remove(tmp_path, ec);
+            return true;
+        }
+    }
+    fs::rename(tmp_path, jpath, ec);
+    if (ec)
+    {
+        mist::logger::error("[AnalysisResults] rename('" + tmp_path + "' → '" + jpath +
+                            "') failed: " + ec.message() +
+                            " — journal kept (it replays onto the compacted TOML)");
+        std::error_code ec_rm;
+        fs::remove(tmp_path, ec_rm);
+        return true;
+    }
+    fJournalGeneration = generation;
+    fJournalOffset = fJournalSize = kJournalHeaderBytes;
+    mist::logger::info("[AnalysisResults] Compacted journal into " + fPath);
+    return true;
+}
+
+void AnalysisResults::compact() const
+{
+    FileLock lock(fPath + ".lock", LOCK_EX);
+    refresh_index_locked();
+    if (fJournalGeneration != 0 && fJournalSize > kJournalHeaderBytes)
+        compact_locked();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  AnalysisResults::append_journal_locked  (private)
+// ─────────────────────────────────────────────────────────────────────────────
+
+/**
+ * @details
+ * The whole batch goes out in one write(2) at the end of the last intact
+ * record: a torn tail left by a crashed writer is truncated first, and a
+ * missing or foreign header is replaced by a fresh one.  No fsync — same
+ * durability as the TOML rewrite it replaces.
+ */
+bool AnalysisResults::append_journal_locked(const ResultMap &entries) const
+{
+    const std::string jpath = journal_path();
+
+    std::string batch;
+    const bool fresh = fJournalGeneration == 0 || fJournalOffset < kJournalHeaderBytes;
+    const uint64_t generation = fresh ? next_generation(fJournalGeneration) : fJournalGeneration;
+    if (fresh)
+        batch = journal_header(generation);
+    for (const auto &[key, entry] : entries)
+        if (!encode_record(batch, key, entry))
+            mist::logger::error("[AnalysisResults] key component longer than 65535 bytes (" +
+                                key.run + ", " + key.sensor + ") — entry not journalled");
+
+    const int fd = ::open(jpath.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        mist::logger::error("[AnalysisResults] cannot open journal " + jpath);
+        return false;
+    }
+    const off_t end = fresh ? 0 : static_cast<off_t>(fJournalOffset);
+    if (!fresh && fJournalSize > fJournalOffset)
+        mist::logger::warning("[AnalysisResults] dropping " +
+                              std::to_string(fJournalSize - fJournalOffset) +
+                              " bytes of torn journal tail in " + jpath);
+    const bool ok = ::ftruncate(fd, end) == 0 &&
+                    ::lseek(fd, end, SEEK_SET) == end &&
+                    write_all(fd, batch);
+    ::close(fd);
+    if (!ok)
+    {
+        mist::logger::error("[AnalysisResults] append to journal " + jpath + " failed");
+        return false;
+    }
+    fJournalGeneration = generation;
+    fJournalOffset = fJournalSize = static_cast<std::uintmax_t>(end) + batch.size();
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  AnalysisResults::update
+// ─────────────────────────────────────────────────────────────────────────────
+
+/**
+ * @details
+ * Upsert semantics on either backend:
+ *  1. Acquire an exclusive ``flock(2)`` on a sidecar ``<fPath>.lock``
+ *     file so concurrent writers from different processes (e.g.
+ *     ``lightdata_writer`` and ``recodata_writer`` finishing at the
+ *     same wall-clock tick) serialise here instead of racing and
+ *     clobbering each other.
+ *  2. Bring the index up to date with TOML + journal, and overwrite or
+ *     insert every entry from @p entries.  The bulk of the refresh runs
+ *     under a shared lock before step 1; under the exclusive one it
+ *     costs the usual stat(2)s plus whatever was appended in between.
+ *  3. Toml backend: write the merged index via replace_toml() and reset
+ *     the journal, if any (compact_locked()).
+ *     Journal backend: append @p entries to the journal — the critical
+ *     section no longer grows with the store — and compact once the
+ *     journal exceeds the threshold.
+ *  4. Release the flock.
+ *
+ * Entries present on disk but absent from @p entries are left untouched.
+ *
+ * Failure modes:
+ *  - open / flock on the lock file fails → log error, proceed
+ *    WITHOUT the lock (concurrent writes may interleave; single-writer
+ *    case still atomic individually via the rename / single append).
+ *  - rename or append fails → logged; the on-disk store is unchanged
+ *    and the index is rebuilt from it on the next call.
+ */
+void AnalysisResults::update(const ResultMap &entries,
+                             const std::string &source) const
+{
+    //  Catch the index up under a shared lock first: on a fresh handle
+    //  that is a full TOML parse plus journal replay, which would
+    //  otherwise hold off every reader and writer.  flock cannot upgrade
+    //  atomically, so the refresh under LOCK_EX re-validates — it only
+    //  decodes what was appended in between, or rebuilds if another
+    //  writer compacted meanwhile.
+    {
+        FileLock shared(fPath + ".lock", LOCK_SH);
+        refresh_index_locked();
+    }
+    FileLock lock(fPath + ".lock", LOCK_EX);
+    refresh_index_locked();
+    for (const auto &[key, entry] : entries)
+        index_put(key, entry);
+
+    bool ok;
+    if (fBackend == ResultsBackend::Journal)
+    {
+        ok = append_journal_locked(entries);
+        if (ok && fJournalSize > fCompactBytes)
+            compact_locked();
+    }
+    else
+        ok = compact_locked();
+    if (!ok)
+    {
+        fIndexBuilt = false; // the index is ahead of the disk
         return;
     }
 
@@ -286,7 +800,7 @@ void AnalysisResults::update(const ResultMap &entries,
     //  source preserves the pre-audit no-op behaviour, so legacy
     //  call-sites that haven't been ported don't start writing
     //  partial-provenance entries (which would be misleading).
-    //  Logged AFTER the rename so the log reflects successfully-
+    //  Logged AFTER the commit so the log reflects successfully-
     //  committed updates only.
     if (!source.empty())
     {
@@ -310,8 +824,8 @@ void AnalysisResults::update(const ResultMap &entries,
 
 /**
  * @details
- * Iterates the full ResultMap once; complexity is O(N) in the total number of
- * stored entries.  For the expected database size this is negligible.
+ * Keys sort on (run, sensor, quantity), so the matching entries form one
+ * contiguous range starting at the empty quantity: O(log N + matches).
  */
 std::map<std::string, ResultEntry>
 query_run(const ResultMap &m,
@@ -319,9 +833,30 @@ query_run(const ResultMap &m,
           const std::string &sensor)
 {
     std::map<std::string, ResultEntry> out;
-    for (const auto &kv : m)
-        if (kv.first.run == run && kv.first.sensor == sensor)
-            out[kv.first.quantity] = kv.second;
+    for (auto it = m.lower_bound({run, sensor, ""});
+         it != m.end() && it->first.run == run && it->first.sensor == sensor; ++it)
+        out.emplace_hint(out.end(), it->first.quantity, it->second);
+    return out;
+}
+
+/**
+ * @details
+ * One hash lookup for the (run, sensor) quantity list, then one per
+ * quantity — independent of the store size.
+ */
+std::map<std::string, ResultEntry>
+query_run(const AnalysisResults &ar,
+          const std::string &run,
+          const std::string &sensor)
+{
+    FileLock lock(ar.fPath + ".lock", LOCK_SH);
+    ar.refresh_index_locked();
+    std::map<std::string, ResultEntry> out;
+    const auto it = ar.fQuantities.find(join_key(run, sensor));
+    if (it == ar.fQuantities.end())
+        return out;
+    for (const auto &quantity : it->second)
+        out[quantity] = ar.fIndex.at({run, sensor, quantity});
     return out;
 }
 
@@ -329,24 +864,18 @@ query_run(const ResultMap &m,
 //  make_graph
 // ─────────────────────────────────────────────────────────────────────────────
 
-/**
- * @details
- * Points are added in the order of @p runs, so the caller controls the x-axis
- * ordering.  Runs absent from @p m produce no point in the graph; the point
- * index therefore matches the index in @p runs only if every run is present.
- *
- * When @p x_err_qty is non-empty the function performs a second map lookup per
- * run and uses the **value** (not the error field) of that entry as the x error
- * bar.  This is the intended pattern for using, e.g., the sigma of a DCR
- * Gaussian fit as the x uncertainty on a N_gamma vs DCR plot.
- */
-TGraphErrors *
-make_graph(const ResultMap &m,
-           const std::vector<std::string> &runs,
-           const std::vector<double> &x_vals,
-           const std::string &sensor,
-           const std::string &quantity,
-           const std::string &x_err_qty)
+namespace
+{
+
+//  Shared body of the make_graph overloads; @p lookup(i, quantity) maps
+//  point i of @p runs to its const ResultEntry * (nullptr when absent).
+template <class Lookup>
+TGraphErrors *fill_graph(Lookup &&lookup,
+                         const std::vector<std::string> &runs,
+                         const std::vector<double> &x_vals,
+                         const std::string &sensor,
+                         const std::string &quantity,
+                         const std::string &x_err_qty)
 {
     auto *g = new TGraphErrors();
 
@@ -357,8 +886,8 @@ make_graph(const ResultMap &m,
         const std::string &run = runs[i];
 
         // ── Primary lookup ───────────────────────────────────────────────────
-        auto it = m.find({run, sensor, quantity});
-        if (it == m.end())
+        const ResultEntry *entry = lookup(i, quantity);
+        if (!entry)
         {
             mist::logger::error("[make_graph] WARNING: no entry for (" +
                                 run + ", " +
@@ -371,9 +900,8 @@ make_graph(const ResultMap &m,
         double x_err = 0.;
         if (has_x_err)
         {
-            auto it_xe = m.find({run, sensor, x_err_qty});
-            if (it_xe != m.end())
-                x_err = it_xe->second.value;
+            if (const ResultEntry *xe = lookup(i, x_err_qty))
+                x_err = xe->value;
             else
                 mist::logger::error("[make_graph] WARNING: x_err_qty '" +
                                     x_err_qty + "' not found for run " +
@@ -381,9 +909,124 @@ make_graph(const ResultMap &m,
         }
 
         const int n = g->GetN();
-        g->SetPoint(n, x_vals[i], it->second.value);
-        g->SetPointError(n, x_err, it->second.error);
+        g->SetPoint(n, x_vals[i], entry->value);
+        g->SetPointError(n, x_err, entry->error);
     }
 
     return g;
 }
+
+//  Indices of @p runs in run order, so each column (also in run order)
+//  is matched against the run list in one linear merge.
+std::vector<std::size_t> run_order(const std::vector<std::string> &runs)
+{
+    std::vector<std::size_t> order(runs.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&runs](std::size_t a, std::size_t b) { return runs[a] < runs[b]; });
+    return order;
+}
+
+//  Entry of @p column for each run of @p runs (nullopt when absent),
+//  in the caller's order: O(runs + column).
+std::vector<std::optional<ResultEntry>> match_column(const ResultColumn *column,
+                                                     const std::vector<std::string> &runs,
+                                                     const std::vector<std::size_t> &order)
+{
+    std::vector<std::optional<ResultEntry>> out(runs.size());
+    if (!column)
+        return out;
+    std::size_t row = 0;
+    for (const std::size_t i : order)
+    {
+        while (row < column->runs.size() && column->runs[row] < runs[i])
+            ++row;
+        if (row < column->runs.size() && column->runs[row] == runs[i])
+            out[i] = ResultEntry{column->values[row], column->errors[row]};
+    }
+    return out;
+}
+
+} // namespace
+
+/**
+ * @details
+ * Points are added in the order of @p runs, so the caller controls the x-axis
+ * ordering.  Runs absent from @p m produce no point in the graph; the point
+ * index therefore matches the index in @p runs only if every run is present.
+ *
+ * When @p x_err_qty is non-empty the function performs a second map lookup per
+ * run and uses the **value** (not the error field) of that entry as the x error
+ * bar.  This is the intended pattern for using, e.g., the sigma of a DCR
+ * Gaussian fit as the x uncertainty on a N_gamma vs DCR plot.
+ */
+TGraphErrors *
+make_graph(const ResultMap &m,
+           const std::vector<std::string> &runs,
+           const std::vector<double> &x_vals,
+           const std::string &sensor,
+           const std::string &quantity,
+           const std::string &x_err_qty)
+{
+    return fill_graph([&](std::size_t i, const std::string &q) -> const ResultEntry *
+                      {
+                          const auto it = m.find({runs[i], sensor, q});
+                          return it == m.end() ? nullptr : &it->second;
+                      },
+                      runs, x_vals, sensor, quantity, x_err_qty);
+}
+
+TGraphErrors *
+make_graph(const AnalysisResults &ar,
+           const std::vector<std::string> &runs,
+           const std::vector<double> &x_vals,
+           const std::string &sensor,
+           const std::string &quantity,
+           const std::string &x_err_qty)
+{
+    return make_graphs(ar, runs, x_vals, sensor, {quantity}, x_err_qty).front();
+}
+
+/**
+ * @details
+ * Same points as make_graph() on a ResultMap.  The x-error column is
+ * matched once and shared by every graph.
+ */
+std::vector<TGraphErrors *>
+make_graphs(const AnalysisResults &ar,
+            const std::vector<std::string> &runs,
+            const std::vector<double> &x_vals,
+            const std::string &sensor,
+            const std::vector<std::string> &quantities,
+            const std::string &x_err_qty)
+{
+    FileLock lock(ar.fPath + ".lock", LOCK_SH);
+    ar.refresh_index_locked();
+    const auto &columns = ar.columns_locked();
+    const auto column_of = [&](const std::string &quantity) -> const ResultColumn *
+    {
+        const auto it = columns.find(join_key(quantity, sensor));
+        return it == columns.end() ? nullptr : &it->second;
+    };
+
+    const auto order = run_order(runs);
+    std::vector<std::optional<ResultEntry>> x_err_entries;
+    if (!x_err_qty.empty())
+        x_err_entries = match_column(column_of(x_err_qty), runs, order);
+
+    std::vector<TGraphErrors *> graphs;
+    graphs.reserve(quantities.size());
+    for (const auto &quantity : quantities)
+    {
+        const auto entries = match_column(column_of(quantity), runs, order);
+        graphs.push_back(fill_graph(
+            [&](std::size_t i, const std::string &q) -> const ResultEntry *
+            {
+                const auto &matched = q == quantity ? entries[i] : x_err_entries[i];
+                return matched ? &*matched : nullptr;
+            },
+            runs, x_vals, sensor, quantity, x_err_qty));
+    }
+    return graphs;
+}
@@ -518,6 +518,18 @@ CalibConfigStruct calib_conf_reader(std::string config_file)
             cfg.slip_confidence_cc = *v;
         if (auto v = (*t)["slip_max_snap_fraction"].value<double>())
             cfg.slip_max_snap_fraction = *v;
+        if (auto v = (*t)["streaming_accumulation"].value<bool>())
+            cfg.streaming_accumulation = *v;
+        if (auto v = (*t)["slip_window_hits"].value<int64_t>())
+            cfg.slip_window_hits = static_cast<int>(*v);
+        if (auto v = (*t)["incremental"].value<bool>())
+            cfg.incremental = *v;
+        if (auto v = (*t)["incremental_from"].value<std::string>())
+            cfg.incremental_from = *v;
+        if (auto v = (*t)["incremental_check_pairs"].value<int64_t>())
+            cfg.incremental_check_pairs = static_cast<int>(*v);
+        if (auto v = (*t)["incremental_chi2_ratio"].value<double>())
+            cfg.incremental_chi2_ratio = *v;
         //  regime1_confidence_cc / regime1_slip_unit_cc keys are
         //  IGNORED if present in the TOML — the regime-1 pass was
         //  removed (see CalibConfigStruct).  Silently ignore for
@@ -593,6 +605,18 @@ CalibConfigStruct calib_conf_reader(std::string config_file)
                                    .Data());
         else
             mist::logger::info("(calib_conf_reader) slip     : correction DISABLED (slip_max_snap_fraction <= 0)");
+        if (cfg.streaming_accumulation)
+            mist::logger::info(TString::Format(
+                                   "(calib_conf_reader) ingest   : STREAMING accumulation, slip window %d hits/channel",
+                                   cfg.slip_window_hits)
+                                   .Data());
+        if (cfg.incremental)
+            mist::logger::info(TString::Format(
+                                   "(calib_conf_reader) update   : INCREMENTAL from '%s', refit when χ²/pair > %.1f·σ² on %d pairs",
+                                   cfg.incremental_from.empty() ? "<existing calibration>"
+                                                                : cfg.incremental_from.c_str(),
+                                   cfg.incremental_chi2_ratio, cfg.incremental_check_pairs)
+                                   .Data());
         mist::logger::info(TString::Format(
                                "(calib_conf_reader) io       : override='%s'   default='%s'   force_rebuild=%s",
                                cfg.override_path.c_str(), cfg.default_path.c_str(),
@@ -1150,6 +1174,8 @@ recodata_conf_reader(std::string streaming_file, std::string mapping_file)
         {
             if (auto v = (*h_table)["delta_r_for_coverage_mm"].value<double>())
                 cfg.delta_r_for_coverage_mm = static_cast<float>(*v);
+            if (auto v = (*h_table)["coverage_cache_quantum_mm"].value<double>())
+                cfg.coverage_cache_quantum_mm = static_cast<float>(*v);
             if (auto v = (*h_table)["min_hits_per_ring"].value<int64_t>())
                 cfg.min_hits_per_ring = static_cast<int>(*v);
             if (auto v = (*h_table)["arc_span_min_rad"].value<double>())
@@ -1250,6 +1276,12 @@ recodata_conf_reader(std::string streaming_file, std::string mapping_file)
                 cfg.nominal_centre_y_mm = static_cast<float>(*v);
             if (auto v = (*r_table)["min_channel_r_for_coverage_mm"].value<double>())
                 cfg.min_channel_r_for_coverage_mm = static_cast<float>(*v);
+            if (auto v = (*r_table)["map_cache_dir"].value<std::string>())
+                cfg.coverage_map_cache_dir = *v;
+            if (auto v = (*r_table)["map_cache_max_mb"].value<int64_t>())
+                cfg.coverage_map_cache_max_mb = static_cast<int>(*v);
+            if (auto v = (*r_table)["map_cache_max_age_days"].value<int64_t>())
+                cfg.coverage_map_cache_max_age_days = static_cast<int>(*v);
         }
         else
         {
@@ -1294,10 +1326,12 @@ recodata_conf_reader(std::string streaming_file, std::string mapping_file)
                                .Data());
         mist::logger::info(TString::Format(
                                "(recodata_conf_reader) nominal centre: (%.2f, %.2f) mm  "
-                               "delta_r_for_coverage=%.2f mm  min_hits_per_ring=%d  "
+                               "delta_r_for_coverage=%.2f mm  coverage_cache_quantum=%.3f mm  "
+                               "min_hits_per_ring=%d  "
                                "min_channel_r_for_coverage=%.2f mm  arc_span_min=%.2f rad",
                                cfg.nominal_centre_x_mm, cfg.nominal_centre_y_mm,
-                               cfg.delta_r_for_coverage_mm, cfg.min_hits_per_ring,
+                               cfg.delta_r_for_coverage_mm, cfg.coverage_cache_quantum_mm,
+                               cfg.min_hits_per_ring,
                                cfg.min_channel_r_for_coverage_mm, cfg.arc_span_min_rad)
                                .Data());
         if (cfg.skip_loo_residuals)
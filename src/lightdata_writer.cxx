@@ -1,10 +1,10 @@
 #include "parallel_streaming_framer.h"
 #include <mist/logger/logger.h>
 #include "writers/lightdata.h"
-#include "writers/lightdata/types.h"                 // CtHit
 #include "writers/lightdata/dcr_afterpulse_ct_qa.h"  // fill_dcr_afterpulse_ct_qa
 #include "writers/lightdata/finalize_streaming_qa.h" // finalize_streaming_qa
 #include "writers/anchor_dt_canvas.h"                // render_anchor_dt_canvas
+#include "writers/cascade.h"                         // LightdataSpills
 #include "triggers/streaming/score.h"
 #include "triggers/streaming/ransac.h"
 #include "mapping.h"
@@ -15,6 +15,8 @@
 #include "analysis_results.h"
 #include "utility/config_dump.h"
 #include "utility/qa_publish.h"
+#include "utility/task_pool.h"
+#include "utility/handoff_queue.h"
 #include "TCanvas.h"
 #include "TPad.h"
 #include "TLegend.h"
@@ -29,7 +31,6 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
-#include <future>
 #include <mutex>
 #include <numeric>
 #include <thread>
@@ -59,7 +60,8 @@ void lightdata_writer(
     float streaming_n_sigma_threshold_override,
     int op_mode,
     bool leading_edge_only,
-    bool skip_stream_qa)
+    bool skip_stream_qa,
+    btana::cascade::LightdataSpills *spills_out)
 {
     //  ROOT thread-safety: protects TROOT/TF1/Fit::Fitter global
     //  state under the framer's multithreaded stream reads (which
@@ -393,7 +395,22 @@ void lightdata_writer(
     // buffer machinery (writes flush when the basket buffer fills) rather
     // than fsync'ing on every spill (lethal on HDD/NFS).
     lightdata_tree->SetAutoFlush(-30000000);
-    spilldata.write_to_tree(lightdata_tree);
+    //  The tree is filled on an archiving thread from its own branch
+    //  buffers (`archive_spilldata`): the main loop moves each finished
+    //  spill's flat lists in and goes on framing the next spill while
+    //  the previous one is compressed and written.  Nothing else touches
+    //  lightdata_tree until `archiver.finish()` after the spill loop.
+    auto archive_spilldata = std::make_unique<AlcorSpilldata>();
+    archive_spilldata->write_to_tree(lightdata_tree);
+    util::BackgroundConsumer<AlcorSpilldataStruct> archiver(
+        [&](AlcorSpilldataStruct &spill)
+        {
+            std::swap(archive_spilldata->data(), spill);
+            lightdata_tree->Fill();
+            std::swap(archive_spilldata->data(), spill);
+            if (spills_out)
+                spills_out->keep(std::move(spill));
+        });
     //  ---
     //  QA Plots
     //  ---
@@ -1103,20 +1120,11 @@ void lightdata_writer(
         // the last trigger of one spill never contributes a delta with the next.
         std::unordered_map<int, uint64_t> trigger_last_global_cc;
 
-        //  Per-frame CT scratch buffers — hoisted out of the inner loop
-        //   Before this change each frame allocated a
-        //  fresh std::vector<CtHit> + std::vector<std::size_t>, even though
-        //  the capacities settle quickly after the first few frames.  Now we
-        //  reuse the same storage across frames within a spill and .clear()
-        //  at the top of each frame: typical capacity stabilises within a
-        //  spill, eliminating the realloc churn on the hot path.
-        //  `CtHit` is defined in `include/writers/lightdata/types.h` so
-        //  the per-frame QA helper (`fill_dcr_afterpulse_ct_qa`) can
-        //  use the same record type without dragging the writer's
-        //  internals into its signature.
-        using ::btana::lightdata::CtHit;
-        std::vector<CtHit> ct_hits;
-        std::vector<std::size_t> sorted_by_time;
+        //  Cross-talk pair finder for the per-frame QA — hoisted out of the
+        //  frame loop: its channel adjacency table (physical / electrical
+        //  neighbours) fills once per run, and its per-frame buffers keep
+        //  their capacity instead of reallocating every frame.
+        ::util::cross_talk::PairFinder ct_pairs(qa_cfg.ct_phys_radius_mm);
 
         //  Iterate in ascending frame_id order.  CRITICAL for the
         //  consecutive-Δt bookkeeping built up across this loop:
@@ -1382,8 +1390,9 @@ void lightdata_writer(
             const size_t n_threads = std::max<size_t>(
                 1, std::min<size_t>(
                        requested_n_threads > 0
-                           ? static_cast<size_t>(requested_n_threads)
-                           : std::thread::hardware_concurrency(),
+                           ? std::min<size_t>(requested_n_threads,
+                                              util::TaskPool::instance().concurrency())
+                           : util::TaskPool::instance().concurrency(),
                        n));
             auto run_one = [&](size_t i, const StreamingRansacQA &qa)
             {
@@ -1422,22 +1431,22 @@ void lightdata_writer(
             }
             else
             {
+                //  One shared-pool task per slot; each slot owns its QA
+                //  clones and pulls frames off the atomic counter.
                 std::atomic<size_t> next{lo};
                 std::mutex merge_mtx;
-                std::vector<std::future<void>> pool;
-                pool.reserve(n_threads);
+                util::TaskGroup group;
                 for (size_t t = 0; t < n_threads; ++t)
-                    pool.push_back(std::async(std::launch::async, [&]()
-                                              {
+                    group.run([&]()
+                              {
                         //  Per-worker QA clones; merged under the mutex at end.
                         RansacQAClones local_qa(hough_qa);
                         for (size_t i = next.fetch_add(1); i < hi;
                              i = next.fetch_add(1))
                             run_one(i, local_qa.qa);
                         std::lock_guard<std::mutex> lk(merge_mtx);
-                        local_qa.merge_into(); }));
-                for (auto &f : pool)
-                    f.get();
+                        local_qa.merge_into(); });
+                group.wait();
             }
         };
 
@@ -2200,7 +2209,7 @@ void lightdata_writer(
                     qa_hists.h_phys_ct_dchannel_dt = h_phys_ct_dchannel_dt.get();
                     ::btana::lightdata::fill_dcr_afterpulse_ct_qa(
                         cherenkov_hits, active_sensors, active_sensors_count,
-                        ct_hits, sorted_by_time, qa_cfg, qa_hists);
+                        ct_pairs, qa_cfg, qa_hists);
                 }
             }
         }; // end process_frame_body lambda
@@ -2248,9 +2257,18 @@ void lightdata_writer(
         //  The next iteration's restart() will reset the subtask clocks.
         progress_bars.update(ispill + 1, max_spill);
 
-        outfile->cd();
         spilldata.prepare_tree_fill();
-        lightdata_tree->Fill();
+        {
+            //  Hand the flat lists to the archiving thread; the working
+            //  maps stay with the framer.
+            auto &flat = spilldata.data();
+            AlcorSpilldataStruct spill;
+            spill.dead_mask_list = std::move(flat.dead_mask_list);
+            spill.participants_mask_list = std::move(flat.participants_mask_list);
+            spill.frame_reference = std::move(flat.frame_reference);
+            spill.lightdata_list_in_frame = std::move(flat.lightdata_list_in_frame);
+            archiver.push(std::move(spill));
+        }
         // Per-spill outfile->Flush() removed (§4.2): it fsync'd to disk on
         // every spill, which is brutal on HDDs and lethal on networked
         // storage.  The tree's SetAutoFlush(-30000000) above lets the
@@ -2262,6 +2280,8 @@ void lightdata_writer(
     progress_framer.finish(/*flush=*/false);
     progress_postprocessing.finish(/*flush=*/false);
     progress_bars.finish();
+    //  Every spill is in the tree (and in `spills_out`) past this point.
+    archiver.finish();
     mist::logger::info("(lightdata_writer) Finished spills loop, writing to file");
 
     //  --skip-stream-qa fast path: the per-frame QA loop was bypassed, so
@@ -4653,7 +4673,7 @@ void lightdata_writer(
                       static_cast<double>(participant_lane_spills)
                 : 0.0;
 
-        AnalysisResults ar(data_repository + "/standard_results.toml");
+        AnalysisResults ar(data_repository + "/standard_results.toml", ResultsBackend::Journal);
         ar.update(ResultMap{
                       //  n_selected_frames: trigger-matrix entries ≈ frames that
                       //  passed selection (NOT distinct physics events).  Kept as
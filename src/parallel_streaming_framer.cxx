@@ -9,7 +9,7 @@
 #include <string>
 #include <thread>
 #include <execution>
-#include <future>
+#include "utility/task_pool.h"
 #include <chrono>
 using namespace std;
 
@@ -792,13 +792,18 @@ bool ParallelStreamingFramer::next_spill()
     // identically to 4-core laptops.  Replaced with an explicit
     // `min(n_usable, kMaxWorkers)` so the cap is greppable and the intermediate
     // value scales with hardware up to the cap.
+    //
+    //  - the shared task pool (`util::TaskPool`, sized by `--threads`): the
+    //    slots below are pool tasks, so asking for more than the pool runs
+    //    only queues them.
     constexpr unsigned int kMaxWorkers = 16;
     const unsigned int n_hw = std::thread::hardware_concurrency();
     const unsigned int n_usable = (n_hw > 2) ? (n_hw - 2) : 0;
     const unsigned int n_streams = static_cast<unsigned int>(data_streams.size());
+    const unsigned int n_pool = static_cast<unsigned int>(util::TaskPool::instance().concurrency());
     const unsigned int n_threads = (n_threads_requested > 0)
-                                       ? std::min({static_cast<unsigned int>(n_threads_requested), kMaxWorkers, n_streams})
-                                       : std::min({std::max(1u, n_usable), kMaxWorkers, n_streams});
+                                       ? std::min({static_cast<unsigned int>(n_threads_requested), kMaxWorkers, n_streams, n_pool})
+                                       : std::min({std::max(1u, n_usable), kMaxWorkers, n_streams, n_pool});
 
     std::atomic<size_t> next_streamer_atomic(0);
     std::atomic<size_t> completed(0);
@@ -831,36 +836,30 @@ bool ParallelStreamingFramer::next_spill()
         worker_qas[i].h_afterpulse->Reset();
     }
 
-    // Per-spill std::async spawn cost was measured at < 0.01% of per-spill
-    // work on a realistic load; no worker
-    // pool needed.  Instrumentation removed.
-    std::vector<std::future<void>> thread_pool;
-    thread_pool.reserve(n_threads);
-
+    // One pool task per worker slot; each slot owns its WorkerQA and pulls
+    // streams off the shared atomic counter.
+    util::TaskGroup stream_group;
     for (size_t i = 0; i < n_threads; ++i)
     {
-        thread_pool.push_back(std::async(std::launch::async,
-                                         [this, &next_streamer_atomic, &completed, total, &worker_qas, i]()
-                                         {
-                                             while (true)
-                                             {
-                                                 size_t my_stream = next_streamer_atomic.fetch_add(1);
-                                                 if (my_stream >= total)
-                                                     return;
-
-                                                 // process() reads _frame_size and per-stream
-                                                 // rollover correction from members; only the
-                                                 // stream index and per-worker scratch are passed.
-                                                 process(my_stream, &worker_qas[i]);
-
-                                                 size_t done = ++completed;
-                                                 _update_bar(static_cast<int64_t>(done), static_cast<int64_t>(total));
-                                             }
-                                         }));
+        stream_group.run([this, &next_streamer_atomic, &completed, total, &worker_qas, i]()
+                         {
+                             while (true)
+                             {
+                                 size_t my_stream = next_streamer_atomic.fetch_add(1);
+                                 if (my_stream >= total)
+                                     return;
+
+                                 // process() reads _frame_size and per-stream
+                                 // rollover correction from members; only the
+                                 // stream index and per-worker scratch are passed.
+                                 process(my_stream, &worker_qas[i]);
+
+                                 size_t done = ++completed;
+                                 _update_bar(static_cast<int64_t>(done), static_cast<int64_t>(total));
+                             }
+                         });
     }
-
-    for (auto &f : thread_pool)
-        f.get();
+    stream_group.wait();
 
     // Merge per-worker frame maps into the master spilldata.frame_and_lightdata.
     // Workers wrote to their own maps without holding frame_mutexes_access —
@@ -921,6 +920,9 @@ bool ParallelStreamingFramer::next_spill()
         std::sort(ld.timing_hits.begin(), ld.timing_hits.end(), cmp_finedata);
         std::sort(ld.tracking_hits.begin(), ld.tracking_hits.end(), cmp_finedata);
         std::sort(ld.trigger_hits.begin(), ld.trigger_hits.end(), cmp_trigger);
+        //  The frame's trigger list is final here: seal its presence mask
+        //  so trigger-gated consumers can test it without the vector.
+        ld.seal_trigger_mask();
     }
 
     // Merge the per-worker QA clones into the master histograms, then free.
@@ -13,47 +13,192 @@
  * writers build it via `Mapping::get_position_from_global_index` and
  * skip channels that return `nullopt`).  Coverage values are channel
  * counts at each (φ, R) cell — a pure geometric quantity.
+ *
+ * The run-level maps are rasterised with a parallel per-channel
+ * footprint pass and a serial in-order apply; `CoverageMapStore` keeps
+ * the footprints on disk keyed by a hash of the geometry and binning.
  */
 
 #include "utility/radiator_efficiency.h"
+#include "utility/task_pool.h"
 
 #include <TAxis.h>
 #include <TH1.h>
 #include <TH2.h>
 #include <TMath.h>
 
+#include <mist/logger/logger.h>
+
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <thread>
 
 namespace util::radiator_efficiency
 {
 
 // ============================================================
-//  build_coverage_map
+//  Shared rasterisation
 // ============================================================
 
-TH2F *build_coverage_map(
+namespace
+{
+
+//  One channel that contributes to a map: its position.  The weight is
+//  kept in a parallel array so footprints (geometry only) can be reused
+//  across runs with different activity weights.
+struct ChannelPoint
+{
+    float x, y;
+};
+
+//  Positions of every channel in `channel_xy`, in map order.
+std::vector<ChannelPoint> channel_points(const std::map<int, std::array<float, 2>> &channel_xy)
+{
+    std::vector<ChannelPoint> out;
+    out.reserve(channel_xy.size());
+    for (const auto &[lut_key, position] : channel_xy)
+        out.push_back({position[0], position[1]});
+    return out;
+}
+
+//  Resolve the per-channel weight (spill-by-spill active-channel
+//  correction), aligned with `channel_points`.  If a `channel_weights`
+//  map is supplied:
+//    - channel key NOT in the map  → weight 0, skipped
+//      (effective mask of unmapped / always-dead channels)
+//    - channel key IN the map      → each bin gets the
+//      mapped weight instead of +1 (≤ 0 = dead, skipped)
+//  If no `channel_weights` is supplied, all channels contribute +1 per
+//  covered bin (legacy V1 = geometric upper bound).
+std::vector<float> channel_weight_list(
     const std::map<int, std::array<float, 2>> &channel_xy,
-    int n_phi_bins,
-    float r_min_mm,
-    float r_max_mm,
-    int n_r_bins,
-    float channel_half_width_mm,
-    float centre_x,
-    float centre_y,
-    float min_channel_r_mm,
     const std::map<int, float> *channel_weights)
 {
-    // Static counter avoids ROOT name clashes when this helper is
-    // called more than once in the same process — each map gets a
-    // unique name; callers free to Rename afterwards.
-    static int counter = 0;
-    TH2F *coverage_map = new TH2F(
+    std::vector<float> out;
+    out.reserve(channel_xy.size());
+    for (const auto &[lut_key, position] : channel_xy)
+    {
+        float channel_weight = 1.f;
+        if (channel_weights)
+        {
+            auto it_w = channel_weights->find(lut_key);
+            channel_weight = it_w == channel_weights->end() ? 0.f : it_w->second;
+        }
+        out.push_back(channel_weight > 0.f ? channel_weight : 0.f);
+    }
+    return out;
+}
+
+//  Global bin indices covered by each channel's pixel, in channel order.
+using Footprints = std::vector<std::vector<int>>;
+
+//  Footprints are computed per channel in parallel (`footprint_of`
+//  fills the global bin indices one channel covers; it must only use
+//  const axis queries).  With `weights`, channels of zero weight are
+//  left empty; without, every channel is rasterised (the cacheable,
+//  weight-independent set).
+template <class Footprint>
+Footprints compute_footprints(const std::vector<ChannelPoint> &channels,
+                              const std::vector<float> *weights,
+                              int n_threads, Footprint &&footprint_of)
+{
+    Footprints bins(channels.size());
+    auto one = [&](std::size_t i)
+    {
+        if (!weights || (*weights)[i] > 0.f)
+            footprint_of(channels[i], bins[i]);
+    };
+    const std::size_t n_workers = std::min<std::size_t>(
+        n_threads > 1 ? static_cast<std::size_t>(n_threads) : 1, channels.size());
+    if (n_workers <= 1)
+    {
+        for (std::size_t i = 0; i < channels.size(); ++i)
+            one(i);
+    }
+    else
+    {
+        std::atomic<std::size_t> next{0};
+        util::TaskGroup group;
+        for (std::size_t w = 0; w < n_workers; ++w)
+            group.run([&]
+                      {
+                for (std::size_t i = next++; i < channels.size(); i = next++)
+                    one(i); });
+        group.wait();
+    }
+    return bins;
+}
+
+//  Footprints are applied serially in channel order — the same sequence
+//  of float additions as a single-threaded fill, so the map depends
+//  neither on `n_threads` nor on whether the footprints came from the
+//  on-disk cache.
+void apply_footprints(TH2F *coverage_map, const Footprints &bins, const std::vector<float> &weights)
+{
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        if (weights[i] <= 0.f)
+            continue;
+        for (const int bin : bins[i])
+            coverage_map->AddBinContent(bin, static_cast<double>(weights[i]));
+    }
+    // Manual stats refresh since we used AddBinContent (which
+    // doesn't bump GetEntries on its own).
+    coverage_map->SetEntries(coverage_map->Integral());
+}
+
+// Static counters avoid ROOT name clashes when these helpers are
+// called more than once in the same process — each map gets a
+// unique name; callers free to Rename afterwards.
+TH2F *make_rphi_map(int n_phi_bins, float r_min_mm, float r_max_mm, int n_r_bins)
+{
+    static std::atomic<int> counter{0};
+    return new TH2F(
         (std::string("h_coverage_map_rphi_") + std::to_string(counter++)).c_str(),
         ";#phi (rad);R (mm)",
         n_phi_bins, -static_cast<float>(TMath::Pi()), static_cast<float>(TMath::Pi()),
         n_r_bins, r_min_mm, r_max_mm);
+}
+
+TH2F *make_xy_map(int n_x_bins, float x_min_mm, float x_max_mm,
+                  int n_y_bins, float y_min_mm, float y_max_mm)
+{
+    static std::atomic<int> counter{0};
+    return new TH2F(
+        (std::string("h_coverage_map_xy_") + std::to_string(counter++)).c_str(),
+        ";c_{x} (mm);c_{y} (mm)",
+        n_x_bins, x_min_mm, x_max_mm,
+        n_y_bins, y_min_mm, y_max_mm);
+}
 
+TH1F *make_eff_hist(const TAxis *radial_reference_axis)
+{
+    static std::atomic<int> counter{0};
+    return new TH1F(
+        (std::string("h_eff_R_") + std::to_string(counter++)).c_str(),
+        ";R (mm);#it{eff}(R)",
+        radial_reference_axis->GetNbins(),
+        radial_reference_axis->GetXmin(),
+        radial_reference_axis->GetXmax());
+}
+
+Footprints rphi_footprints(const TH2F *coverage_map,
+                           const std::vector<ChannelPoint> &channels,
+                           const std::vector<float> *weights,
+                           float channel_half_width_mm,
+                           float centre_x,
+                           float centre_y,
+                           float min_channel_r_mm,
+                           int n_threads)
+{
     // For each channel, rasterise its pixel footprint onto the (φ, R)
     // grid by iterating (φ, R) bins in the channel's bounding box
     // and incrementing each bin whose CENTRE, projected back to
@@ -76,39 +221,23 @@ TH2F *build_coverage_map(
     // dots in the coverage TH2F.  Cosmetic — does not affect
     // eff(R) once averaged over φ.  See for the
     // proper-area-integration upgrade path if/when it matters.
-    for (const auto &[lut_key, position] : channel_xy)
-    {
-        //  Per-channel weight (spill-by-spill active-channel
-        //  correction;).  If a `channel_weights`
-        //  map is supplied:
-        //    - channel key NOT in the map  → skip entirely
-        //      (effective mask of unmapped / always-dead channels)
-        //    - channel key IN the map      → each bin gets the
-        //      mapped weight instead of +1
-        //  If no `channel_weights` is supplied, all channels
-        //  contribute +1 per covered bin (legacy V1 = geometric
-        //  upper bound).
-        float channel_weight = 1.f;
-        if (channel_weights)
-        {
-            auto it_w = channel_weights->find(lut_key);
-            if (it_w == channel_weights->end())
-                continue; // unmapped channel — silently skip
-            channel_weight = it_w->second;
-            if (channel_weight <= 0.f)
-                continue; // dead channel — contributes nothing
-        }
-
-        const float channel_dx_mm = position[0] - centre_x;
-        const float channel_dy_mm = position[1] - centre_y;
+    const TAxis *phi_axis = coverage_map->GetXaxis();
+    const TAxis *r_axis = coverage_map->GetYaxis();
+    const int n_phi_bins = phi_axis->GetNbins();
+    const int n_r_bins = r_axis->GetNbins();
+    return compute_footprints(channels, weights, n_threads,
+                              [&](const ChannelPoint &channel, std::vector<int> &bins)
+                              {
+        const float channel_dx_mm = channel.x - centre_x;
+        const float channel_dy_mm = channel.y - centre_y;
         const float channel_r_mm = std::hypot(channel_dx_mm, channel_dy_mm);
         if (channel_r_mm <= 0.f)
-            continue;
+            return;
         //  Optional low-R cut to drop bogus-position channels that
         //  would otherwise produce a "low-R bump" in the coverage
         //  map.  Default min_channel_r_mm = 0 skips no channels.
         if (channel_r_mm < min_channel_r_mm)
-            continue;
+            return;
         const float channel_phi_rad = std::atan2(channel_dy_mm, channel_dx_mm);
 
         // Bounding box: multiply by √2 to bound the diagonal of
@@ -117,23 +246,21 @@ TH2F *build_coverage_map(
         const float delta_phi_rad = channel_half_width_mm * std::sqrt(2.f) /
                                     channel_r_mm;
 
-        const int bin_r_lo = coverage_map->GetYaxis()->FindBin(channel_r_mm - delta_r_mm);
-        const int bin_r_hi = coverage_map->GetYaxis()->FindBin(channel_r_mm + delta_r_mm);
-        const int bin_phi_lo = coverage_map->GetXaxis()->FindBin(channel_phi_rad - delta_phi_rad);
-        const int bin_phi_hi = coverage_map->GetXaxis()->FindBin(channel_phi_rad + delta_phi_rad);
+        const int bin_r_lo = r_axis->FindFixBin(channel_r_mm - delta_r_mm);
+        const int bin_r_hi = r_axis->FindFixBin(channel_r_mm + delta_r_mm);
+        const int bin_phi_lo = phi_axis->FindFixBin(channel_phi_rad - delta_phi_rad);
+        const int bin_phi_hi = phi_axis->FindFixBin(channel_phi_rad + delta_phi_rad);
 
         for (int bin_phi = bin_phi_lo; bin_phi <= bin_phi_hi; ++bin_phi)
         {
             if (bin_phi < 1 || bin_phi > n_phi_bins)
                 continue;
-            const float bin_phi_centre =
-                coverage_map->GetXaxis()->GetBinCenter(bin_phi);
+            const float bin_phi_centre = phi_axis->GetBinCenter(bin_phi);
             for (int bin_r = bin_r_lo; bin_r <= bin_r_hi; ++bin_r)
             {
                 if (bin_r < 1 || bin_r > n_r_bins)
                     continue;
-                const float bin_r_centre =
-                    coverage_map->GetYaxis()->GetBinCenter(bin_r);
+                const float bin_r_centre = r_axis->GetBinCenter(bin_r);
                 // Project the bin centre back to (x, y) and test
                 // the pixel-square containment.  Same convention
                 // as the offline macro.
@@ -142,87 +269,103 @@ TH2F *build_coverage_map(
                 if (std::fabs(bin_dx) > channel_half_width_mm ||
                     std::fabs(bin_dy) > channel_half_width_mm)
                     continue;
-                coverage_map->AddBinContent(
-                    coverage_map->GetBin(bin_phi, bin_r),
-                    static_cast<double>(channel_weight));
+                bins.push_back(coverage_map->GetBin(bin_phi, bin_r));
             }
-        }
-    }
-    // Manual stats refresh since we used AddBinContent (which
-    // doesn't bump GetEntries on its own).
-    coverage_map->SetEntries(coverage_map->Integral());
-    // Stats are now driven by ROOT's TH2F::Fill bookkeeping — no
-    // manual entry-count refresh needed.  Entries == n_channels ×
-    // kOversamplesPerSide² (modulo the `sr > 0` skip), which is
-    // the natural count given the oversampling.
-    return coverage_map;
+        } });
 }
 
-// ============================================================
-//  build_coverage_map_xy
-// ============================================================
-
-TH2F *build_coverage_map_xy(
-    const std::map<int, std::array<float, 2>> &channel_xy,
-    int n_x_bins,
-    float x_min_mm,
-    float x_max_mm,
-    int n_y_bins,
-    float y_min_mm,
-    float y_max_mm,
-    float channel_half_width_mm,
-    const std::map<int, float> *channel_weights)
+Footprints xy_footprints(const TH2F *coverage_map,
+                         const std::vector<ChannelPoint> &channels,
+                         const std::vector<float> *weights,
+                         float channel_half_width_mm,
+                         int n_threads)
 {
-    static int counter = 0;
-    TH2F *coverage_map = new TH2F(
-        (std::string("h_coverage_map_xy_") + std::to_string(counter++)).c_str(),
-        ";c_{x} (mm);c_{y} (mm)",
-        n_x_bins, x_min_mm, x_max_mm,
-        n_y_bins, y_min_mm, y_max_mm);
-
     //  Same weight + footprint convention as build_coverage_map, but
     //  cartesian — each channel's ±channel_half_width pixel square is
     //  rasterised by a plain bounding-box bin-centre containment test
     //  (no polar Jacobian).  Bin value = Σ weight of covering channels.
-    for (const auto &[lut_key, position] : channel_xy)
-    {
-        float channel_weight = 1.f;
-        if (channel_weights)
-        {
-            auto it_w = channel_weights->find(lut_key);
-            if (it_w == channel_weights->end())
-                continue; // unmapped → effectively masked
-            channel_weight = it_w->second;
-            if (channel_weight <= 0.f)
-                continue; // dead channel
-        }
-
-        const float cx = position[0];
-        const float cy = position[1];
-        const int bin_x_lo = coverage_map->GetXaxis()->FindBin(cx - channel_half_width_mm);
-        const int bin_x_hi = coverage_map->GetXaxis()->FindBin(cx + channel_half_width_mm);
-        const int bin_y_lo = coverage_map->GetYaxis()->FindBin(cy - channel_half_width_mm);
-        const int bin_y_hi = coverage_map->GetYaxis()->FindBin(cy + channel_half_width_mm);
+    const TAxis *x_axis = coverage_map->GetXaxis();
+    const TAxis *y_axis = coverage_map->GetYaxis();
+    const int n_x_bins = x_axis->GetNbins();
+    const int n_y_bins = y_axis->GetNbins();
+    return compute_footprints(channels, weights, n_threads,
+                              [&](const ChannelPoint &channel, std::vector<int> &bins)
+                              {
+        const float cx = channel.x;
+        const float cy = channel.y;
+        const int bin_x_lo = x_axis->FindFixBin(cx - channel_half_width_mm);
+        const int bin_x_hi = x_axis->FindFixBin(cx + channel_half_width_mm);
+        const int bin_y_lo = y_axis->FindFixBin(cy - channel_half_width_mm);
+        const int bin_y_hi = y_axis->FindFixBin(cy + channel_half_width_mm);
         for (int bx = bin_x_lo; bx <= bin_x_hi; ++bx)
         {
             if (bx < 1 || bx > n_x_bins)
                 continue;
-            const float bx_centre = coverage_map->GetXaxis()->GetBinCenter(bx);
+            const float bx_centre = x_axis->GetBinCenter(bx);
             for (int by = bin_y_lo; by <= bin_y_hi; ++by)
             {
                 if (by < 1 || by > n_y_bins)
                     continue;
-                const float by_centre = coverage_map->GetYaxis()->GetBinCenter(by);
+                const float by_centre = y_axis->GetBinCenter(by);
                 if (std::fabs(bx_centre - cx) > channel_half_width_mm ||
                     std::fabs(by_centre - cy) > channel_half_width_mm)
                     continue;
-                coverage_map->AddBinContent(
-                    coverage_map->GetBin(bx, by),
-                    static_cast<double>(channel_weight));
+                bins.push_back(coverage_map->GetBin(bx, by));
             }
-        }
-    }
-    coverage_map->SetEntries(coverage_map->Integral());
+        } });
+}
+
+} // namespace
+
+// ============================================================
+//  build_coverage_map
+// ============================================================
+
+TH2F *build_coverage_map(
+    const std::map<int, std::array<float, 2>> &channel_xy,
+    int n_phi_bins,
+    float r_min_mm,
+    float r_max_mm,
+    int n_r_bins,
+    float channel_half_width_mm,
+    float centre_x,
+    float centre_y,
+    float min_channel_r_mm,
+    const std::map<int, float> *channel_weights,
+    int n_threads)
+{
+    TH2F *coverage_map = make_rphi_map(n_phi_bins, r_min_mm, r_max_mm, n_r_bins);
+    const auto weights = channel_weight_list(channel_xy, channel_weights);
+    apply_footprints(coverage_map,
+                     rphi_footprints(coverage_map, channel_points(channel_xy), &weights,
+                                     channel_half_width_mm, centre_x, centre_y,
+                                     min_channel_r_mm, n_threads),
+                     weights);
+    return coverage_map;
+}
+
+// ============================================================
+//  build_coverage_map_xy
+// ============================================================
+
+TH2F *build_coverage_map_xy(
+    const std::map<int, std::array<float, 2>> &channel_xy,
+    int n_x_bins,
+    float x_min_mm,
+    float x_max_mm,
+    int n_y_bins,
+    float y_min_mm,
+    float y_max_mm,
+    float channel_half_width_mm,
+    const std::map<int, float> *channel_weights,
+    int n_threads)
+{
+    TH2F *coverage_map = make_xy_map(n_x_bins, x_min_mm, x_max_mm, n_y_bins, y_min_mm, y_max_mm);
+    const auto weights = channel_weight_list(channel_xy, channel_weights);
+    apply_footprints(coverage_map,
+                     xy_footprints(coverage_map, channel_points(channel_xy), &weights,
+                                   channel_half_width_mm, n_threads),
+                     weights);
     return coverage_map;
 }
 
@@ -237,13 +380,7 @@ TH1F *radial_efficiency(
     if (!coverage_map || !radial_reference_axis)
         return nullptr;
 
-    static int counter = 0;
-    TH1F *eff_R = new TH1F(
-        (std::string("h_eff_R_") + std::to_string(counter++)).c_str(),
-        ";R (mm);#it{eff}(R)",
-        radial_reference_axis->GetNbins(),
-        radial_reference_axis->GetXmin(),
-        radial_reference_axis->GetXmax());
+    TH1F *eff_R = make_eff_hist(radial_reference_axis);
 
     const int n_phi_bins = coverage_map->GetNbinsX();
     const int n_r_bins = coverage_map->GetNbinsY();
@@ -283,42 +420,38 @@ TH1F *radial_efficiency(
 //  azimuthal_coverage_fraction
 // ============================================================
 
-float azimuthal_coverage_fraction(
-    const std::map<int, std::array<float, 2>> &channel_xy,
-    float cx,
-    float cy,
-    float R,
-    float delta_r_mm,
-    float channel_half_width_mm)
+namespace
 {
-    if (R <= 0.f || delta_r_mm <= 0.f || channel_xy.empty())
-        return 0.f;
-
-    // Collect (φ_lo, φ_hi) segments per channel whose pixel lies
-    // within ±delta_r_mm of the ring arc.  Each channel's φ extent
-    // is ≈ pixel_pitch / r_ch (small for channels far from the
-    // centre).  We then sort and merge overlapping segments,
-    // accumulate the total covered φ, and divide by 2π.
-    //
-    // Segments straddling the ±π wrap are split into two: this
-    // keeps the merge logic on a single linear axis without
-    // modular gymnastics, at the cost of one extra entry per
-    // wrap-crossing channel — negligible.
-    constexpr float kTwoPi = 2.f * static_cast<float>(TMath::Pi());
-    constexpr float kPi = static_cast<float>(TMath::Pi());
 
+//  Segment accumulator shared by the full-scan and indexed overloads.
+//
+//  Collects (φ_lo, φ_hi) segments per channel whose pixel lies within
+//  ±delta_r_mm of the ring arc.  Each channel's φ extent is
+//  ≈ pixel_pitch / r_ch (small for channels far from the centre).
+//  `covered_fraction` then sorts and merges overlapping segments,
+//  accumulates the total covered φ, and divides by 2π.
+//
+//  Segments straddling the ±π wrap are split into two: this keeps the
+//  merge logic on a single linear axis without modular gymnastics, at
+//  the cost of one extra entry per wrap-crossing channel — negligible.
+//  The merged result only depends on the SET of segments, so visiting
+//  channels in a different order (the grid index) gives the same value.
+struct ArcSegments
+{
+    float cx, cy, R, delta_r_mm, channel_half_width_mm;
     std::vector<std::array<float, 2>> segments;
-    segments.reserve(channel_xy.size());
 
-    for (const auto &[lut_key, position] : channel_xy)
+    void visit(float x, float y)
     {
-        const float dx = position[0] - cx;
-        const float dy = position[1] - cy;
+        constexpr float kTwoPi = 2.f * static_cast<float>(TMath::Pi());
+        constexpr float kPi = static_cast<float>(TMath::Pi());
+        const float dx = x - cx;
+        const float dy = y - cy;
         const float r_ch = std::hypot(dx, dy);
         if (r_ch <= 0.f)
-            continue;
+            return;
         if (std::fabs(r_ch - R) > delta_r_mm)
-            continue;
+            return;
 
         const float phi_ch = std::atan2(dy, dx);
         // Half-extent in φ for this channel: pixel half-width converted to an
@@ -344,34 +477,453 @@ float azimuthal_coverage_fraction(
             segments.push_back({phi_lo, phi_hi});
         }
     }
-    if (segments.empty())
+
+    float covered_fraction()
+    {
+        constexpr float kTwoPi = 2.f * static_cast<float>(TMath::Pi());
+        if (segments.empty())
+            return 0.f;
+
+        // Sort by lo edge, merge overlapping / adjacent segments.
+        std::sort(segments.begin(), segments.end(),
+                  [](const std::array<float, 2> &a, const std::array<float, 2> &b)
+                  { return a[0] < b[0]; });
+
+        float covered_phi = 0.f;
+        float cur_lo = segments[0][0];
+        float cur_hi = segments[0][1];
+        for (std::size_t i = 1; i < segments.size(); ++i)
+        {
+            if (segments[i][0] <= cur_hi)
+            {
+                // Overlap (or adjacent) — extend current segment.
+                cur_hi = std::max(cur_hi, segments[i][1]);
+            }
+            else
+            {
+                covered_phi += (cur_hi - cur_lo);
+                cur_lo = segments[i][0];
+                cur_hi = segments[i][1];
+            }
+        }
+        covered_phi += (cur_hi - cur_lo);
+
+        return std::min(1.f, covered_phi / kTwoPi);
+    }
+};
+
+} // namespace
+
+float azimuthal_coverage_fraction(
+    const std::map<int, std::array<float, 2>> &channel_xy,
+    float cx,
+    float cy,
+    float R,
+    float delta_r_mm,
+    float channel_half_width_mm)
+{
+    if (R <= 0.f || delta_r_mm <= 0.f || channel_xy.empty())
+        return 0.f;
+
+    ArcSegments arc{cx, cy, R, delta_r_mm, channel_half_width_mm, {}};
+    arc.segments.reserve(channel_xy.size());
+    for (const auto &[lut_key, position] : channel_xy)
+        arc.visit(position[0], position[1]);
+    return arc.covered_fraction();
+}
+
+// ============================================================
+//  ChannelGridIndex
+// ============================================================
+
+ChannelGridIndex::ChannelGridIndex(const std::map<int, std::array<float, 2>> &channel_xy,
+                                   float cell_mm)
+    : cell_mm_(cell_mm > 0.f ? cell_mm : 6.f)
+{
+    if (channel_xy.empty())
+        return;
+    float x_lo = std::numeric_limits<float>::max(), y_lo = x_lo;
+    float x_hi = std::numeric_limits<float>::lowest(), y_hi = x_hi;
+    for (const auto &[key, p] : channel_xy)
+    {
+        x_lo = std::min(x_lo, p[0]);
+        x_hi = std::max(x_hi, p[0]);
+        y_lo = std::min(y_lo, p[1]);
+        y_hi = std::max(y_hi, p[1]);
+    }
+    x0_ = x_lo;
+    y0_ = y_lo;
+    nx_ = static_cast<int>((x_hi - x_lo) / cell_mm_) + 1;
+    ny_ = static_cast<int>((y_hi - y_lo) / cell_mm_) + 1;
+
+    //  Counting sort into CSR: cell_begin_[c] .. cell_begin_[c + 1].
+    std::vector<int> cell_of;
+    cell_of.reserve(channel_xy.size());
+    cell_begin_.assign(static_cast<std::size_t>(nx_) * ny_ + 1, 0);
+    for (const auto &[key, p] : channel_xy)
+    {
+        const int ix = std::min(nx_ - 1, static_cast<int>((p[0] - x0_) / cell_mm_));
+        const int iy = std::min(ny_ - 1, static_cast<int>((p[1] - y0_) / cell_mm_));
+        cell_of.push_back(iy * nx_ + ix);
+        ++cell_begin_[cell_of.back() + 1];
+    }
+    for (std::size_t c = 1; c < cell_begin_.size(); ++c)
+        cell_begin_[c] += cell_begin_[c - 1];
+    points_.resize(channel_xy.size());
+    std::vector<uint32_t> fill(cell_begin_.begin(), cell_begin_.end() - 1);
+    std::size_t k = 0;
+    for (const auto &[key, p] : channel_xy)
+        points_[fill[cell_of[k++]]++] = p;
+}
+
+float azimuthal_coverage_fraction(
+    const ChannelGridIndex &index,
+    float cx,
+    float cy,
+    float R,
+    float delta_r_mm,
+    float channel_half_width_mm)
+{
+    if (R <= 0.f || delta_r_mm <= 0.f || index.empty())
         return 0.f;
 
-    // Sort by lo edge, merge overlapping / adjacent segments.
-    std::sort(segments.begin(), segments.end(),
-              [](const std::array<float, 2> &a, const std::array<float, 2> &b)
-              { return a[0] < b[0]; });
+    ArcSegments arc{cx, cy, R, delta_r_mm, channel_half_width_mm, {}};
+    arc.segments.reserve(64);
+    index.for_each_in_annulus(cx, cy, R - delta_r_mm, R + delta_r_mm,
+                              [&](const std::array<float, 2> &p)
+                              { arc.visit(p[0], p[1]); });
+    return arc.covered_fraction();
+}
+
+// ============================================================
+//  CoverageCache
+// ============================================================
+
+float CoverageCache::operator()(float cx, float cy, float R)
+{
+    if (quantum_mm_ <= 0.f)
+    {
+        ++n_misses_;
+        return azimuthal_coverage_fraction(index_, cx, cy, R, delta_r_mm_,
+                                           channel_half_width_mm_);
+    }
+    //  21 bits per coordinate (±1 M quanta) — ample for mm-scale geometry
+    //  at sub-mm quanta.  Evaluated AT the quantised point, so the value
+    //  is a pure function of the key (order- and thread-independent).
+    const auto q = [&](float v)
+    { return static_cast<int64_t>(std::lround(v / quantum_mm_)); };
+    const int64_t qx = q(cx), qy = q(cy), qr = q(R);
+    constexpr int64_t kMask = (int64_t{1} << 21) - 1;
+    const uint64_t key = (static_cast<uint64_t>(qx & kMask) << 42) |
+                         (static_cast<uint64_t>(qy & kMask) << 21) |
+                         static_cast<uint64_t>(qr & kMask);
+    if (auto it = cache_.find(key); it != cache_.end())
+    {
+        ++n_hits_;
+        return it->second;
+    }
+    ++n_misses_;
+    const float f = azimuthal_coverage_fraction(
+        index_, static_cast<float>(qx) * quantum_mm_, static_cast<float>(qy) * quantum_mm_,
+        static_cast<float>(qr) * quantum_mm_, delta_r_mm_, channel_half_width_mm_);
+    cache_.emplace(key, f);
+    return f;
+}
+
+// ============================================================
+//  CoverageMapStore
+// ============================================================
+
+namespace
+{
+
+//  Bump when the rasterisation convention or the file layout changes —
+//  it is hashed into every key, so old entries simply stop matching
+//  (and age out of the directory).
+constexpr uint32_t kStoreFormatVersion = 2;
+constexpr char kStoreMagic[8] = {'B', 'T', 'C', 'O', 'V', 'F', 'P', 'T'};
+constexpr char kStorePrefix[] = "coverage_";
+
+//  64-bit FNV-1a over the raw bytes of each value.
+struct Fnv1a
+{
+    uint64_t value = 14695981039346656037ull;
 
-    float covered_phi = 0.f;
-    float cur_lo = segments[0][0];
-    float cur_hi = segments[0][1];
-    for (std::size_t i = 1; i < segments.size(); ++i)
+    void bytes(const void *data, std::size_t n)
     {
-        if (segments[i][0] <= cur_hi)
+        const auto *p = static_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < n; ++i)
         {
-            // Overlap (or adjacent) — extend current segment.
-            cur_hi = std::max(cur_hi, segments[i][1]);
+            value ^= p[i];
+            value *= 1099511628211ull;
         }
-        else
+    }
+    template <class T>
+    void add(const T &v) { bytes(&v, sizeof(T)); }
+};
+
+//  Geometry only: the cached footprints cover every mapped channel, so
+//  the per-run activity weights never enter the key.
+void hash_channels(Fnv1a &h, const std::vector<ChannelPoint> &channels)
+{
+    h.add(static_cast<uint64_t>(channels.size()));
+    for (const auto &c : channels)
+    {
+        h.add(c.x);
+        h.add(c.y);
+    }
+}
+
+//  Layout: magic[8] | key u64 | n_cells u64 | n_channels u64
+//          | u32 n_bins[n_channels] | i32 bins[Σ n_bins].
+constexpr std::uintmax_t kStoreHeaderBytes = sizeof(kStoreMagic) + 3 * sizeof(uint64_t);
+
+bool load_footprints(const std::string &path, uint64_t key, uint64_t n_cells,
+                     std::size_t n_channels, Footprints &bins)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const std::uintmax_t file_size = fs::file_size(path, ec);
+    if (ec || file_size < kStoreHeaderBytes + n_channels * sizeof(uint32_t))
+        return false;
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    char magic[sizeof(kStoreMagic)];
+    uint64_t file_key = 0, file_cells = 0, file_channels = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&file_key), sizeof(file_key));
+    in.read(reinterpret_cast<char *>(&file_cells), sizeof(file_cells));
+    in.read(reinterpret_cast<char *>(&file_channels), sizeof(file_channels));
+    if (!in || std::memcmp(magic, kStoreMagic, sizeof(magic)) != 0 || file_key != key ||
+        file_cells != n_cells || file_channels != n_channels)
+        return false;
+    std::vector<uint32_t> n_bins(n_channels);
+    in.read(reinterpret_cast<char *>(n_bins.data()),
+            static_cast<std::streamsize>(n_channels * sizeof(uint32_t)));
+    if (!in)
+        return false;
+    //  The counts must account for the rest of the file exactly before
+    //  anything is allocated from them.
+    std::uintmax_t n_total = 0;
+    for (const uint32_t n : n_bins)
+        n_total += n;
+    if (file_size != kStoreHeaderBytes + n_channels * sizeof(uint32_t) + n_total * sizeof(int32_t))
+        return false;
+    bins.assign(n_channels, {});
+    for (std::size_t i = 0; i < n_channels; ++i)
+    {
+        bins[i].resize(n_bins[i]);
+        in.read(reinterpret_cast<char *>(bins[i].data()),
+                static_cast<std::streamsize>(n_bins[i] * sizeof(int32_t)));
+        for (const int bin : bins[i])
+            if (bin < 0 || static_cast<uint64_t>(bin) >= n_cells)
+                return false;
+    }
+    return static_cast<bool>(in);
+}
+
+bool store_footprints(const std::string &path, uint64_t key, uint64_t n_cells, const Footprints &bins)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    //  Unique temporary + rename: concurrent writers of the same key
+    //  both produce identical content, and readers never see a partial file.
+    const std::string tmp = path + ".tmp." + std::to_string(std::random_device{}());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        const uint64_t n_channels = bins.size();
+        out.write(kStoreMagic, sizeof(kStoreMagic));
+        out.write(reinterpret_cast<const char *>(&key), sizeof(key));
+        out.write(reinterpret_cast<const char *>(&n_cells), sizeof(n_cells));
+        out.write(reinterpret_cast<const char *>(&n_channels), sizeof(n_channels));
+        for (const auto &channel_bins : bins)
+        {
+            const uint32_t n = static_cast<uint32_t>(channel_bins.size());
+            out.write(reinterpret_cast<const char *>(&n), sizeof(n));
+        }
+        for (const auto &channel_bins : bins)
+            out.write(reinterpret_cast<const char *>(channel_bins.data()),
+                      static_cast<std::streamsize>(channel_bins.size() * sizeof(int32_t)));
+        if (!out)
         {
-            covered_phi += (cur_hi - cur_lo);
-            cur_lo = segments[i][0];
-            cur_hi = segments[i][1];
+            out.close();
+            fs::remove(tmp, ec);
+            return false;
         }
     }
-    covered_phi += (cur_hi - cur_lo);
+    fs::rename(tmp, path, ec);
+    if (ec)
+    {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CoverageMapStore::CoverageMapStore(std::string cache_dir, int n_threads,
+                                   std::uintmax_t max_bytes, int max_age_days)
+    : cache_dir_(std::move(cache_dir)), n_threads_(n_threads),
+      max_bytes_(max_bytes), max_age_days_(max_age_days) {}
+
+std::string CoverageMapStore::path_for(const char *kind, uint64_t key) const
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s%s_%016llx.bin", kStorePrefix, kind,
+                  static_cast<unsigned long long>(key));
+    return (std::filesystem::path(cache_dir_) / name).string();
+}
+
+//  Entries are touched on every hit, so the modification time is the
+//  last use: anything unused for `max_age_days_` goes first, then the
+//  least recently used until the directory fits `max_bytes_`.  Orphaned
+//  `.tmp.*` files of a crashed writer share the prefix and age out too.
+void CoverageMapStore::prune()
+{
+    namespace fs = std::filesystem;
+    if (max_bytes_ == 0 && max_age_days_ <= 0)
+        return;
+    struct Entry
+    {
+        fs::path path;
+        std::uintmax_t size;
+        fs::file_time_type mtime;
+    };
+    std::vector<Entry> entries;
+    std::error_code ec;
+    for (fs::directory_iterator it(cache_dir_, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (!it->is_regular_file(ec) || it->path().filename().string().rfind(kStorePrefix, 0) != 0)
+            continue;
+        Entry e{it->path(), it->file_size(ec), it->last_write_time(ec)};
+        if (!ec)
+            entries.push_back(std::move(e));
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b)
+              { return a.mtime > b.mtime; });
+
+    const auto now = fs::file_time_type::clock::now();
+    const auto max_age = std::chrono::hours(24) * max_age_days_;
+    std::uintmax_t kept_bytes = 0;
+    for (const auto &e : entries)
+    {
+        const bool too_old = max_age_days_ > 0 && now - e.mtime > max_age;
+        const bool too_big = max_bytes_ > 0 && kept_bytes + e.size > max_bytes_;
+        if ((too_old || too_big) && fs::remove(e.path, ec))
+            ++n_evicted_;
+        else
+            kept_bytes += e.size;
+    }
+}
 
-    return std::min(1.f, covered_phi / kTwoPi);
+void CoverageMapStore::cached_footprints(const char *kind, uint64_t key, uint64_t n_cells,
+                                         std::size_t n_channels, Footprints &bins,
+                                         const std::function<Footprints()> &compute)
+{
+    const std::string path = path_for(kind, key);
+    if (load_footprints(path, key, n_cells, n_channels, bins))
+    {
+        ++n_loaded_;
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        return;
+    }
+    bins = compute();
+    if (store_footprints(path, key, n_cells, bins))
+    {
+        ++n_stored_;
+        prune();
+    }
+    else
+        mist::logger::warning("(CoverageMapStore) could not write " + path);
+}
+
+TH2F *CoverageMapStore::build_coverage_map(
+    const std::map<int, std::array<float, 2>> &channel_xy,
+    int n_phi_bins,
+    float r_min_mm,
+    float r_max_mm,
+    int n_r_bins,
+    float channel_half_width_mm,
+    float centre_x,
+    float centre_y,
+    float min_channel_r_mm,
+    const std::map<int, float> *channel_weights)
+{
+    if (!enabled())
+        return util::radiator_efficiency::build_coverage_map(
+            channel_xy, n_phi_bins, r_min_mm, r_max_mm, n_r_bins, channel_half_width_mm,
+            centre_x, centre_y, min_channel_r_mm, channel_weights, n_threads_);
+
+    const auto channels = channel_points(channel_xy);
+    TH2F *coverage_map = make_rphi_map(n_phi_bins, r_min_mm, r_max_mm, n_r_bins);
+
+    Fnv1a h;
+    h.add(kStoreFormatVersion);
+    h.bytes("rphi", 4);
+    h.add(n_phi_bins);
+    h.add(r_min_mm);
+    h.add(r_max_mm);
+    h.add(n_r_bins);
+    h.add(channel_half_width_mm);
+    h.add(centre_x);
+    h.add(centre_y);
+    h.add(min_channel_r_mm);
+    hash_channels(h, channels);
+
+    Footprints bins;
+    cached_footprints("rphi", h.value, static_cast<uint64_t>(coverage_map->GetNcells()),
+                      channels.size(), bins, [&]
+                      { return rphi_footprints(coverage_map, channels, nullptr, channel_half_width_mm,
+                                               centre_x, centre_y, min_channel_r_mm, n_threads_); });
+    apply_footprints(coverage_map, bins, channel_weight_list(channel_xy, channel_weights));
+    return coverage_map;
+}
+
+TH2F *CoverageMapStore::build_coverage_map_xy(
+    const std::map<int, std::array<float, 2>> &channel_xy,
+    int n_x_bins,
+    float x_min_mm,
+    float x_max_mm,
+    int n_y_bins,
+    float y_min_mm,
+    float y_max_mm,
+    float channel_half_width_mm,
+    const std::map<int, float> *channel_weights)
+{
+    if (!enabled())
+        return util::radiator_efficiency::build_coverage_map_xy(
+            channel_xy, n_x_bins, x_min_mm, x_max_mm, n_y_bins, y_min_mm, y_max_mm,
+            channel_half_width_mm, channel_weights, n_threads_);
+
+    const auto channels = channel_points(channel_xy);
+    TH2F *coverage_map = make_xy_map(n_x_bins, x_min_mm, x_max_mm, n_y_bins, y_min_mm, y_max_mm);
+
+    Fnv1a h;
+    h.add(kStoreFormatVersion);
+    h.bytes("xy", 2);
+    h.add(n_x_bins);
+    h.add(x_min_mm);
+    h.add(x_max_mm);
+    h.add(n_y_bins);
+    h.add(y_min_mm);
+    h.add(y_max_mm);
+    h.add(channel_half_width_mm);
+    hash_channels(h, channels);
+
+    Footprints bins;
+    cached_footprints("xy", h.value, static_cast<uint64_t>(coverage_map->GetNcells()),
+                      channels.size(), bins, [&]
+                      { return xy_footprints(coverage_map, channels, nullptr, channel_half_width_mm,
+                                             n_threads_); });
+    apply_footprints(coverage_map, bins, channel_weight_list(channel_xy, channel_weights));
+    return coverage_map;
 }
 
 } // namespace util::radiator_efficiency
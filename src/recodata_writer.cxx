@@ -25,11 +25,16 @@
 #include "alcor_spilldata.h"
 #include "writers/lightdata.h"
 #include "writers/recodata.h"
+#include "writers/cascade.h"                  // LightdataSpills, RecodataFrameQueue
+#include "writers/lightdata/trigger_overlay.h" // LightdataTriggerOverlay
 #include "writers/recodata/types.h"          // RingFitResult, FrameResult, RingFillHists, RadialFitResult, VsNFitResult
 #include "writers/recodata/radial_fit.h"     // fit_radial_distribution
 #include "writers/recodata/sigma_vs_n_fit.h" // fit_sigma_vs_n
 #include "writers/recodata/ring_compute.h"   // compute_ring_fit_timewindow, fill_ring_hists
 #include "writers/recodata/frame_pipeline.h" // process_frame_pure (parallel-dispatch entry point)
+#include "writers/recodata/fine_offsets.h"   // FineOffsetEstimator
+#include "writers/recodata/spill_prefetch.h" // SpillPrefetcher
+#include "writers/recodata/drain_shards.h"   // DrainHists, DrainHistShards, fill_frame_hists
 //  Live-QA pipeline: coverage map + eff(R) helpers
 //  + per-ring fit_circle re-run on mask-tagged hits → N_photons /
 //  radial(R) observables filled inline.
@@ -38,11 +43,12 @@
 #include "utility/config_dump.h"
 #include "utility/config_reader.h"
 #include "utility/qa_publish.h" // util::qa::pdf_path + crop_pdf_inplace
+#include "utility/task_pool.h"  // TaskPool, TaskGroup
+#include "utility/handoff_queue.h" // BackgroundConsumer
 #include <set>
 #include <filesystem>
 #include <memory>
 #include <atomic>
-#include <future>
 #include <thread>
 
 //  RingFitResult, FrameResult, RingFillHists were previously defined
@@ -371,7 +377,9 @@ void recodata_writer(
     std::string trigger_conf,
     std::string framer_conf,
     std::string streaming_conf,
-    std::string ring_shape_mode)
+    std::string ring_shape_mode,
+    bool end_to_end,
+    btana::cascade::RecodataFrameQueue *frames_out)
 {
     //  Ring-shape policy for the radial coordinate (auto / circle / ellipse) —
     //  see --force-ring / --force-ellipse.  Parsed once; consumed by the
@@ -405,6 +413,10 @@ void recodata_writer(
     //  TFilePtr is owning: closes + deletes on every exit path.
     std::string input_filename = data_repository + "/" + run_name + "/lightdata.root";
     TFilePtr input_file(TFile::Open(input_filename.c_str(), "READ"));
+    //  End-to-end mode: the cascaded lightdata pass hands its spills over
+    //  in memory; the file is still opened below for `h_fine_calib` and
+    //  the trigger QA hists, but the tree is never read.
+    ::btana::cascade::LightdataSpills upstream_spills;
     if (!input_file || input_file->IsZombie() || force_upstream)
     {
         mist::logger::warning("(recodata_writer) " + input_filename +
@@ -425,7 +437,12 @@ void recodata_writer(
                          /*mapping_config_file=*/mapping_conf,
                          /*fine_calibration_config_file=*/"",
                          framer_conf,
-                         streaming_conf);
+                         streaming_conf,
+                         /*streaming_n_sigma_threshold_override=*/0.f,
+                         /*op_mode=*/1,
+                         /*leading_edge_only=*/false,
+                         /*skip_stream_qa=*/false,
+                         end_to_end ? &upstream_spills : nullptr);
         input_file.reset(TFile::Open(input_filename.c_str(), "READ"));
         if (!input_file || input_file->IsZombie())
         {
@@ -455,6 +472,18 @@ void recodata_writer(
     auto spilldata = std::make_unique<AlcorSpilldata>();
     spilldata->link_to_tree(lightdata_tree);
 
+    //  Trigger-stage friend tree from `lightdata_retrigger_writer`, when
+    //  present: re-tuned streaming / RANSAC outputs overlaid on each spill
+    //  right after GetEntry (both passes below), so the rest of the writer
+    //  sees a lightdata as if the raw pass had run with the new settings.
+    btana::lightdata::LightdataTriggerOverlay trigger_overlay(
+        btana::lightdata::trigger_overlay_path(input_filename));
+    if (trigger_overlay.is_open())
+        mist::logger::info(TString::Format("(recodata_writer) Applying trigger overlay %s/%s/%s",
+                                           data_repository.c_str(), run_name.c_str(),
+                                           btana::lightdata::kTriggerOverlayFileName)
+                               .Data());
+
     //  Calibration file: TOML v3 only — ``fine_calib.toml`` in the
     //  run dir, produced by ``pulser_calib_writer``.  The legacy
     //  ``fine_calib.txt`` path has been retired (task #172);
@@ -521,8 +550,21 @@ void recodata_writer(
     TriggerRegistry registry(trigger_configs);
     const int n_triggers = registry.size();
 
-    //  Get number of spills, limited to maximum requested spills
-    auto n_spills = lightdata_tree->GetEntries();
+    //  Get number of spills, limited to maximum requested spills.  An empty
+    //  hand-off (lightdata skipped its rebuild, or the run exceeded the
+    //  hand-off's memory budget) falls back to the tree.
+    const bool spills_in_memory = !upstream_spills.spills.empty();
+    if (upstream_spills.over_budget)
+        mist::logger::warning(TString::Format("(recodata_writer) end-to-end: lightdata spills exceed the %zu MB "
+                                              "in-memory budget — reading %s back instead",
+                                              upstream_spills.budget_bytes >> 20, input_filename.c_str())
+                                  .Data());
+    if (spills_in_memory)
+        mist::logger::info(TString::Format("(recodata_writer) end-to-end: %zu lightdata spills handed over in memory",
+                                           upstream_spills.spills.size())
+                               .Data());
+    auto n_spills = spills_in_memory ? static_cast<Long64_t>(upstream_spills.spills.size())
+                                     : lightdata_tree->GetEntries();
     auto all_spills = std::min((int)n_spills, (int)max_spill);
 
     //  Prepare output file
@@ -540,8 +582,13 @@ void recodata_writer(
         return;
     }
     TTree *recodata_tree = new TTree("recodata", "Recodata tree");
+    //  The spill loop builds each entry in `recodata` and queues it
+    //  (`archive_frame`); the archiving thread swaps every queued entry
+    //  under the tree's own branch buffers (`archive_recodata`) and fills.
+    //  Nothing else touches recodata_tree until `archiver.finish()`.
     AlcorRecodata recodata;
-    recodata.write_to_tree(recodata_tree);
+    AlcorRecodata archive_recodata;
+    archive_recodata.write_to_tree(recodata_tree);
 
     //  Cache channel positions from Mapping
 
@@ -680,13 +727,19 @@ void recodata_writer(
     //  helpers (`compute_ring_fit_timewindow`, `fill_ring_hists`).
     //  Geometry + config knobs that don't change during the loop.  See
     //  `include/writers/recodata/ring_compute.h`.
-    const RingComputeContext ring_ctx{index_to_hit_xy, recodata_cfg};
+    //  The grid index over the active-channel positions is built once;
+    //  per-ring coverage then only visits channels near each annulus.
+    const util::radiator_efficiency::ChannelGridIndex coverage_index(index_to_hit_xy);
+    const RingComputeContext ring_ctx{index_to_hit_xy, recodata_cfg, &coverage_index};
 
     //  Captured-once state for the parallel per-frame compute pass
     //  (`process_frame_pure`).  Lives in `frame_pipeline.{h,cxx}`.
     //  All members `const &` — safe to share across worker threads.
+    //  Ring fits are deferred to the per-spill batched pass
+    //  (`fit_rings_batched`, see `writers/recodata/ring_batch.h`).
     const FrameProcessContext frame_proc_ctx{framer_cfg, registry, ring_ctx,
-                                             BTANA_EDGE_REJECTION_NS};
+                                             BTANA_EDGE_REJECTION_NS,
+                                             /*defer_ring_fits=*/true};
 
     //  Coverage map is now built at FINALIZE
     //  During the spill loop we
@@ -848,8 +901,9 @@ void recodata_writer(
 
     //  Per-hit radial residual vs N_hits (LEAVE-ONE-OUT fit).
     //
-    //  For each hit i in a ring, run `fit_circle` with `exclude_points
-    //  = {i}` to get the leave-i-out fit (cx_-i, cy_-i, R_-i).  Then
+    //  For each hit i in a ring, downdate the ring's moment sums by hit i
+    //  (`util::circle_fit::leave_one_out`) to get the leave-i-out Taubin
+    //  fit (cx_-i, cy_-i, R_-i).  Then
     //  the per-hit residual is
     //
     //      Δr_i = sqrt((x_i − cx_-i)² + (y_i − cy_-i)²) − R_-i
@@ -925,87 +979,229 @@ void recodata_writer(
     //  Both take `ring_ctx` (declared above) for the geometry + config
     //  bundle that used to be captured by reference.
 
-    //  Enable a 50 MB tree cache before the two GetEntry passes (§4.7 minimum
-    //  mitigation): the second full pass over the spill tree (calibration loop
-    //  at line 497, compute loop at line 569) re-reads every basket from disk
-    //  without it.  Proper single-pass restructure remains the open item.
+    //  50 MB tree cache for the reader thread: the calibration prescan and
+    //  the main pass each stream the spill tree once, front to back.  The
+    //  prescan only needs the hits, triggers and masks (plus the spill
+    //  headers the loader decodes), so it reads and caches just those; the
+    //  main pass re-enables everything.  Pre-split files (no per-member
+    //  sub-branches) fall back to the whole `lightdata` branch.
     lightdata_tree->SetCacheSize(50 * 1024 * 1024);
-    lightdata_tree->AddBranchToCache("*", true);
+    auto select_prescan_branches = [&]
+    {
+        lightdata_tree->SetBranchStatus("*", false);
+        std::vector<const char *> branches = {"dead_mask*", "participants_mask*", "frame*"};
+        if (lightdata_tree->GetBranch("lightdata.trigger_hits"))
+            branches.insert(branches.end(), {"lightdata.cherenkov_hits*", "lightdata.trigger_hits*",
+                                             "lightdata.trigger_mask*"});
+        else
+            branches.push_back("lightdata*");
+        for (const char *branch : branches)
+        {
+            lightdata_tree->SetBranchStatus(branch, true);
+            lightdata_tree->AddBranchToCache(branch, true);
+        }
+    };
+    auto select_all_branches = [&]
+    {
+        lightdata_tree->SetBranchStatus("*", true);
+        lightdata_tree->AddBranchToCache("*", true);
+    };
 
-    //  ── Loop over spills ─────────────────────────────────────────────────────
-    std::map<int, std::vector<float>> map_of_offsets;
-    for (int i_spill = 0; i_spill < all_spills; ++i_spill)
+    //  Spill loader shared by both passes, run on the prefetcher's reader
+    //  thread (the only thread that touches `lightdata_tree` from here
+    //  on): GetEntry, trigger overlay, dead-lane decode, then swap the
+    //  spill out of the branch buffers into the prefetch slot.  The slot's
+    //  recycled vectors go back under the branches, so steady-state reads
+    //  reuse their capacity.
+    //
+    //  End-to-end: the spills are already in memory.  The overlay is
+    //  applied to them once, here, and the loader (main pass only) moves
+    //  each spill out of the hand-off, releasing it as the run advances.
+    if (spills_in_memory)
+        for (int i_spill = 0; i_spill < all_spills; ++i_spill)
+        {
+            auto &stored = upstream_spills.spills[i_spill];
+            trigger_overlay.apply(i_spill, stored.frame_reference, stored.lightdata_list_in_frame);
+        }
+    auto load_spill = [&](int i_spill, ::btana::recodata::PrefetchedSpill &slot)
     {
-        lightdata_tree->GetEntry(i_spill);
-        spilldata->get_entry();
-        auto &frames_in_spill = spilldata->get_frame_list_link();
+        auto &frames = spilldata->get_frame_list_link();
         auto &frame_reference = spilldata->get_frame_reference_list_link();
+        if (spills_in_memory)
+        {
+            std::swap(spilldata->data(), upstream_spills.spills[i_spill]);
+            //  Move-assign an empty spill: frees the swapped-out buffers
+            //  (capacity and hash buckets included), not just their size.
+            upstream_spills.spills[i_spill] = AlcorSpilldataStruct();
+        }
+        else
+        {
+            lightdata_tree->GetEntry(i_spill);
+            spilldata->get_entry();
+            trigger_overlay.apply(i_spill, frame_reference, frames);
+        }
+        slot.i_spill = i_spill;
+        slot.lanes_participating = spilldata->get_not_dead_participants();
+        std::swap(slot.frames, frames);
+        std::swap(slot.frame_reference, frame_reference);
+    };
 
-        //  ── First loop for calibration ──────────────────────────────────────────
-        for (auto &current_lightdata_struct : frames_in_spill)
+    //  ── Calibration prescan ──────────────────────────────────────────────
+    //  Per-channel fine-time offset from every Cherenkov hit of frames
+    //  carrying the streaming ring-found trigger.  Streaming estimator
+    //  (count / in-cut sum per channel) instead of keeping every Δt of the
+    //  run; the spill read overlaps the hit loop through the prefetcher.
+    //  The main pass needs the offsets before its first spill, hence the
+    //  separate pass.
+    {
+        ::btana::recodata::FineOffsetEstimator fine_offsets;
+        auto scan_frames = [&](const std::vector<AlcorLightdataStruct> &frames)
         {
-            AlcorLightdata current_lightdata(current_lightdata_struct);
-            auto current_trigger_list = current_lightdata.get_triggers();
-            auto timing_trigger = std::find_if(current_trigger_list.begin(),
-                                               current_trigger_list.end(),
-                                               [](const TriggerEvent &e)
-                                               {
-                                                   return e.index == _TRIGGER_STREAMING_RING_FOUND_;
-                                               });
-            if (timing_trigger != current_trigger_list.end())
+            for (const auto &current_lightdata_struct : frames)
             {
-                for (const auto &current_cherenkov : current_lightdata.get_cherenkov_hits_link())
+                //  Mask test first: most frames carry no ring trigger.
+                if (!current_lightdata_struct.has_trigger(_TRIGGER_STREAMING_RING_FOUND_))
+                    continue;
+                const auto &current_trigger_list = current_lightdata_struct.trigger_hits;
+                auto timing_trigger = std::find_if(current_trigger_list.begin(),
+                                                   current_trigger_list.end(),
+                                                   [](const TriggerEvent &e)
+                                                   {
+                                                       return e.index == _TRIGGER_STREAMING_RING_FOUND_;
+                                                   });
+                //  The mask only says the frame holds the trigger: a stale
+                //  or hand-edited one may not, so the scan keeps its check.
+                if (timing_trigger == current_trigger_list.end())
+                    continue;
+                for (const auto &current_cherenkov : current_lightdata_struct.cherenkov_hits)
                 {
                     AlcorFinedata current_hit(current_cherenkov);
-                    auto index = current_hit.get_global_index();
-                    map_of_offsets[index].push_back(
-                        current_hit.get_time_ns() - timing_trigger->fine_time);
+                    fine_offsets.add(current_hit.get_global_index(),
+                                     current_hit.get_time_ns() - timing_trigger->fine_time);
                 }
             }
+        };
+        if (spills_in_memory)
+        {
+            //  Read in place — the main pass takes the spills afterwards.
+            for (int i_spill = 0; i_spill < all_spills; ++i_spill)
+                scan_frames(upstream_spills.spills[i_spill].lightdata_list_in_frame);
         }
-    }
-    //  Per-channel mean fine-time offset, averaged over per-spill
-    //  contributions that pass the |value| < 30 outlier filter.
-    //  Both `values_list` and `offset_participants` must independently
-    //  clear 20 samples before the offset is committed — the inner
-    //  check guards the division below from a 0 denominator (all
-    //  samples rejected as outliers) and a low-statistics tail.
-    constexpr float kFineOffsetOutlierCutNs = 30.f;
-    constexpr int kFineOffsetMinSamples = 20;
-    for (auto &[channel_index, values_list] : map_of_offsets)
-    {
-        if (static_cast<int>(values_list.size()) < kFineOffsetMinSamples)
-            continue;
-        float offset_sum = 0.f;
-        int offset_participants = 0;
-        for (const auto &value : values_list)
+        else
         {
-            if (std::fabs(value) > kFineOffsetOutlierCutNs)
-                continue;
-            offset_sum += value;
-            ++offset_participants;
+            select_prescan_branches();
+            {
+                ::btana::recodata::SpillPrefetcher prescan(all_spills, load_spill);
+                ::btana::recodata::PrefetchedSpill spill;
+                while (prescan.next(spill))
+                    scan_frames(spill.frames);
+            }
+            select_all_branches();
         }
-        if (offset_participants < kFineOffsetMinSamples)
-            continue;
-        const float offset_value = offset_sum / static_cast<float>(offset_participants);
-        AlcorFinedata::set_param2(channel_index, -offset_value / BTANA_ALCOR_CC_TO_NS);
+        const std::size_t n_committed = fine_offsets.commit();
+        mist::logger::info(TString::Format("(recodata_writer) fine-time offsets: %zu of %zu channels committed",
+                                           n_committed, fine_offsets.n_channels())
+                               .Data());
     }
-    for (int i_spill = 0; i_spill < all_spills; ++i_spill)
+
+    //  Drain histogram targets.  The first-ring bundle is built twice,
+    //  once per dual/solo split; `fill_frame_hists` picks one per frame.
+    ::btana::recodata::DrainHists drain_hists;
+    drain_hists.h_frames_per_spill = h_frames_per_spill.get();
+    drain_hists.h_edge_trigger_position = h_edge_trigger_position.get();
+    drain_hists.h_trigger_qa = h_trigger_qa.get();
+    drain_hists.h_trigger_cherenkov_hitmap = h_trigger_cherenkov_hitmap.get();
+    drain_hists.h_ring_tagged_hitmap = h_ring_tagged_hitmap.get();
     {
+        RingFillHists first_hists;
+        first_hists.h_nhits = h_nhits_first.get();
+        first_hists.h_nphotons = h_nphotons_first.get();
+        first_hists.h_fcov = h_f_coverage_first.get();
+        first_hists.h_radial = h_radial_first.get();
+        first_hists.h_R = h_R_first.get();
+        first_hists.h_sigma = h_sigma_first.get();
+        first_hists.h_R_vs_nhits = h_R_vs_nhits_first.get();
+        first_hists.h_centre_xy = h_centre_xy_first.get();
+        first_hists.h_residual_vs_n = h_residual_vs_n_first.get();
+        first_hists.h_radial_smeared = h_radial_first_smeared.get();
+        first_hists.h_residual_vs_n_smeared = h_residual_vs_n_first_smeared.get();
+
+        drain_hists.first_dual = first_hists;
+        drain_hists.first_dual.h_R_vs_nhits_split = h_R_vs_nhits_first_dual.get();
+        drain_hists.first_dual.h_residual_vs_n_split = h_residual_vs_n_first_dual.get();
+        drain_hists.first_dual.h_radial_split = h_radial_first_dual.get();
+        drain_hists.first_dual.h_R_split = h_R_first_dual.get();
+        drain_hists.first_dual.h_radial_split_smeared = h_radial_first_dual_smeared.get();
+        drain_hists.first_dual.h_residual_vs_n_split_smeared = h_residual_vs_n_first_dual_smeared.get();
+
+        drain_hists.first_solo = first_hists;
+        drain_hists.first_solo.h_R_vs_nhits_split = h_R_vs_nhits_first_solo.get();
+        drain_hists.first_solo.h_residual_vs_n_split = h_residual_vs_n_first_solo.get();
+        drain_hists.first_solo.h_radial_split = h_radial_first_solo.get();
+        drain_hists.first_solo.h_R_split = h_R_first_solo.get();
+        drain_hists.first_solo.h_radial_split_smeared = h_radial_first_solo_smeared.get();
+        drain_hists.first_solo.h_residual_vs_n_split_smeared = h_residual_vs_n_first_solo_smeared.get();
+    }
+    //  Second ring has no dual/solo split (always "dual" by definition).
+    drain_hists.second.h_nhits = h_nhits_second.get();
+    drain_hists.second.h_nphotons = h_nphotons_second.get();
+    drain_hists.second.h_fcov = h_f_coverage_second.get();
+    drain_hists.second.h_radial = h_radial_second.get();
+    drain_hists.second.h_R = h_R_second.get();
+    drain_hists.second.h_sigma = h_sigma_second.get();
+    drain_hists.second.h_R_vs_nhits = h_R_vs_nhits_second.get();
+    drain_hists.second.h_centre_xy = h_centre_xy_second.get();
+    drain_hists.second.h_residual_vs_n = h_residual_vs_n_second.get();
+    drain_hists.second.h_radial_smeared = h_radial_second_smeared.get();
+    drain_hists.second.h_residual_vs_n_smeared = h_residual_vs_n_second_smeared.get();
+    ::btana::recodata::DrainHistShards drain_shards(drain_hists);
+
+    //  Archiving thread: fills the tree from one spill's entries at a
+    //  time, then passes them downstream in end-to-end mode.  A closed
+    //  downstream queue (consumer done early) just drops the hand-off.
+    ::btana::cascade::RecodataSpillFrames pending_frames;
+    util::BackgroundConsumer<::btana::cascade::RecodataSpillFrames> archiver(
+        [&](::btana::cascade::RecodataSpillFrames &frames)
+        {
+            for (auto &frame : frames)
+            {
+                std::swap(archive_recodata.get_triggers_link(), frame.triggers);
+                std::swap(archive_recodata.get_recodata_link(), frame.hits);
+                archive_recodata.set_frame_id(frame.frame_id);
+                archive_recodata.set_trigger_mask(frame.trigger_mask);
+                recodata_tree->Fill();
+                std::swap(archive_recodata.get_triggers_link(), frame.triggers);
+                std::swap(archive_recodata.get_recodata_link(), frame.hits);
+            }
+            if (frames_out)
+                frames_out->push(std::move(frames));
+        });
+    //  Close the entry being built in `recodata` (replaces Fill + clear).
+    auto archive_frame = [&]()
+    {
+        auto &frame = pending_frames.emplace_back();
+        frame.trigger_mask = recodata.get_trigger_mask();
+        std::swap(frame.triggers, recodata.get_triggers_link());
+        std::swap(frame.hits, recodata.get_recodata_link());
+        frame.frame_id = recodata.get_frame_id();
+        recodata.clear();
+    };
+
+    ::btana::recodata::SpillPrefetcher spill_reader(all_spills, load_spill);
+    ::btana::recodata::PrefetchedSpill spill;
+    while (spill_reader.next(spill))
+    {
+        const int i_spill = spill.i_spill;
         //  Per-spill multi-bar reset (skip first iteration — the subtask is
         //  not yet active on the first pass through).
         if (i_spill > 0)
             progress_bars.restart(/*flush=*/false);
         progress_bars.update(i_spill, all_spills);
 
-        lightdata_tree->GetEntry(i_spill);
-        spilldata->get_entry();
-        auto &frames_in_spill = spilldata->get_frame_list_link();
-        auto &frame_reference = spilldata->get_frame_reference_list_link();
+        auto &frames_in_spill = spill.frames;
 
         //  Start-of-spill event: dead lane map
-        auto lanes_participating = spilldata->get_not_dead_participants();
-        for (auto [device, lanes] : lanes_participating)
+        for (const auto &[device, lanes] : spill.lanes_participating)
             if (device < ::gidx::kTimingDeviceLo)
                 for (auto current_lane : lanes)
                     for (auto i_channel = 0; i_channel < 8; ++i_channel)
@@ -1046,8 +1242,7 @@ void recodata_writer(
                             active_channels_per_spill[i_spill].insert(pos_key);
                     }
         recodata.add_trigger({TriggerStartOfSpill, static_cast<uint16_t>(framer_cfg.frame_size / 2)});
-        recodata_tree->Fill();
-        recodata.clear();
+        archive_frame();
 
         //  ── Loop over frames ──────────────────────────────────────────────────
         int n_accepted = 0, n_edge = 0, n_duplicate = 0;
@@ -1065,171 +1260,94 @@ void recodata_writer(
         //  ───────────────────────────────────────────────────────────────────
 
         //  ───────────────────────────────────────────────────────────────────
-        //  drain_frame_result (Stage 1B): serial consumer.  Plays back
-        //  every side effect (hist fills, recodata.add_*, tree Fill,
-        //  per-spill counter updates) given a precomputed FrameResult
-        //  and the original AlcorLightdata wrapper (for the hit-copy
-        //  loop).  Always called serially in frame order.
+        //  append_frame (Stage 1B): ordered tree append.  Plays back the
+        //  side effects that must stay serial and in frame order
+        //  (recodata.add_*, tree Fill, per-spill counters) given a
+        //  precomputed FrameResult and a view of the frame's lightdata
+        //  (for the hit-copy loop).  The histogram half of the old drain
+        //  runs later, sharded (`fill_frame_hists`, Stage 1C).
         //  ───────────────────────────────────────────────────────────────────
-        auto drain_frame_result = [&](const FrameResult &res,
-                                      AlcorLightdata &lightdata)
+        auto append_frame = [&](const FrameResult &res,
+                                AlcorLightdataView lightdata,
+                                uint32_t frame_id)
         {
-            h_frames_per_spill->Fill(i_spill, 0.5); // total
-
-            //  Trigger-validation hist fills.
-            for (const auto &[bin, fine_t] : res.edge_fills)
-                h_edge_trigger_position->Fill(bin, fine_t);
-            for (const auto &[bin, outcome] : res.trigger_qa_fills)
-                h_trigger_qa->Fill(bin, outcome);
-            //  Time-diff hist fills — lazy create on first encounter.
+            //  Time-diff hists — lazy create on first encounter, here on
+            //  the main thread so the shards can clone them before the
+            //  parallel fill.
             for (const auto &[idx, dt] : res.time_diff_fills)
             {
-                if (!h_trigger_time_diff_w_cherenkov.count(idx))
-                    h_trigger_time_diff_w_cherenkov[idx] =
-                        RootHist<TH1F>(
-                            TString::Format("h_trigger_time_diff_w_cherenkov_%s",
-                                            registry.name_of(idx).c_str())
-                                .Data(),
-                            ";#Delta_{t} (t_{Hit} - t_{trigger}) ns;Normalised entries",
-                            kTriggerDtBins,
-                            -kTriggerDtHalfRangeNs, +kTriggerDtHalfRangeNs);
-                h_trigger_time_diff_w_cherenkov[idx]->Fill(dt);
+                if (h_trigger_time_diff_w_cherenkov.count(idx))
+                    continue;
+                h_trigger_time_diff_w_cherenkov[idx] =
+                    RootHist<TH1F>(
+                        TString::Format("h_trigger_time_diff_w_cherenkov_%s",
+                                        registry.name_of(idx).c_str())
+                            .Data(),
+                        ";#Delta_{t} (t_{Hit} - t_{trigger}) ns;Normalised entries",
+                        kTriggerDtBins,
+                        -kTriggerDtHalfRangeNs, +kTriggerDtHalfRangeNs);
+                drain_hists.h_trigger_time_diff[idx] = h_trigger_time_diff_w_cherenkov[idx].get();
             }
 
             if (res.rejected)
             {
                 n_duplicate++;
-                h_frames_per_spill->Fill(i_spill, 3.5);
                 return;
             }
             if (res.had_edge)
-            {
                 n_edge++;
-                h_frames_per_spill->Fill(i_spill, 2.5);
-            }
 
-            for (auto &[index, trigger] : res.accepted_triggers)
-            {
-                h_trigger_qa->Fill(registry.index_of(index) + 0.5, 0.5); // accepted
+            for (const auto &[index, trigger] : res.accepted_triggers)
                 recodata.add_trigger(trigger);
-            }
             if (res.frame_is_physics)
                 ++n_physics_per_spill[i_spill];
 
             //  Cherenkov hits — copy from lightdata (still in scope).
-            for (const auto &chrk : lightdata.get_cherenkov_hits_link())
+            for (const auto &chrk : lightdata.get_cherenkov_hits())
                 recodata.add_hit(chrk);
 
-            //  In-cut trigger-Cherenkov hitmap: accumulate the (x, y) of every
-            //  cherenkov hit that passed the hardware-trigger timing cut
-            //  ([recodata] hardware_ring_dt_min_ns … hardware_ring_dt_max_ns),
-            //  regardless of whether the ring finder tagged/fitted a ring — so
-            //  the map shows the full in-time occupancy, not just ring-found
-            //  frames.  `res.occupancy_xy` is gathered in process_frame_pure
-            //  independently of the (tagged) ring reconstruction.
-            for (const auto &p : res.occupancy_xy)
-                h_trigger_cherenkov_hitmap->Fill(p[0], p[1]);
-
-            //  Companion: the ring-finder-tagged hits only (first + second ring).
-            //  res.{first,second}.hit_xy carry the tagged ring members (smeared),
-            //  recorded even when the fit itself did not converge.
-            for (const auto &p : res.first.hit_xy)
-                h_ring_tagged_hitmap->Fill(p[0], p[1]);
-            for (const auto &p : res.second.hit_xy)
-                h_ring_tagged_hitmap->Fill(p[0], p[1]);
-
-            //  Radiator QA — drain the precomputed RingFitResults.  Now
-            //  gated on a successful reconstruction (hardware-trigger
-            //  time-window fit) rather than the RANSAC self-trigger.
-            if (res.first.fit_ok || res.second.fit_ok)
-            {
-                RingFillHists first_hists;
-                first_hists.h_nhits = h_nhits_first.get();
-                first_hists.h_nphotons = h_nphotons_first.get();
-                first_hists.h_fcov = h_f_coverage_first.get();
-                first_hists.h_radial = h_radial_first.get();
-                first_hists.h_R = h_R_first.get();
-                first_hists.h_sigma = h_sigma_first.get();
-                first_hists.h_R_vs_nhits = h_R_vs_nhits_first.get();
-                first_hists.h_centre_xy = h_centre_xy_first.get();
-                first_hists.h_residual_vs_n = h_residual_vs_n_first.get();
-                first_hists.h_R_vs_nhits_split = res.frame_has_second_ring
-                                                     ? h_R_vs_nhits_first_dual.get()
-                                                     : h_R_vs_nhits_first_solo.get();
-                first_hists.h_residual_vs_n_split = res.frame_has_second_ring
-                                                        ? h_residual_vs_n_first_dual.get()
-                                                        : h_residual_vs_n_first_solo.get();
-                first_hists.h_radial_split = res.frame_has_second_ring
-                                                 ? h_radial_first_dual.get()
-                                                 : h_radial_first_solo.get();
-                first_hists.h_R_split = res.frame_has_second_ring
-                                            ? h_R_first_dual.get()
-                                            : h_R_first_solo.get();
-                //  Smeared sibling targets — same dual/solo predicate.
-                first_hists.h_radial_smeared = h_radial_first_smeared.get();
-                first_hists.h_residual_vs_n_smeared = h_residual_vs_n_first_smeared.get();
-                first_hists.h_radial_split_smeared = res.frame_has_second_ring
-                                                         ? h_radial_first_dual_smeared.get()
-                                                         : h_radial_first_solo_smeared.get();
-                first_hists.h_residual_vs_n_split_smeared = res.frame_has_second_ring
-                                                                ? h_residual_vs_n_first_dual_smeared.get()
-                                                                : h_residual_vs_n_first_solo_smeared.get();
-                fill_ring_hists(res.first, first_hists,
-                                recodata_cfg.radial_eff_per_ring_centre);
-
-                RingFillHists second_hists;
-                second_hists.h_nhits = h_nhits_second.get();
-                second_hists.h_nphotons = h_nphotons_second.get();
-                second_hists.h_fcov = h_f_coverage_second.get();
-                second_hists.h_radial = h_radial_second.get();
-                second_hists.h_R = h_R_second.get();
-                second_hists.h_sigma = h_sigma_second.get();
-                second_hists.h_R_vs_nhits = h_R_vs_nhits_second.get();
-                second_hists.h_centre_xy = h_centre_xy_second.get();
-                second_hists.h_residual_vs_n = h_residual_vs_n_second.get();
-                //  Second ring has no dual/solo split (always "dual"
-                //  by definition); just plug the smeared headline hists.
-                second_hists.h_radial_smeared = h_radial_second_smeared.get();
-                second_hists.h_residual_vs_n_smeared = h_residual_vs_n_second_smeared.get();
-                fill_ring_hists(res.second, second_hists,
-                                recodata_cfg.radial_eff_per_ring_centre);
-            }
-
-            recodata_tree->Fill();
-            recodata.clear();
+            //  Frame index within the spill: recotrack rebuilds the
+            //  trigger's spill time from it to match ALTAI timestamps.
+            recodata.set_frame_id(frame_id);
+            archive_frame();
             n_accepted++;
-            h_frames_per_spill->Fill(i_spill, 1.5);
         };
 
         //  ─── Stage 2: frames-within-spill multithreading ─────────
         //
         //  Pattern mirrors `parallel_streaming_framer.cxx::next_spill`:
-        //  N workers dispatched via std::async, work distributed via
+        //  N slot tasks on the shared `util::TaskPool` (sized by
+        //  --threads), work distributed via
         //  atomic frame-index counter, results written to disjoint
         //  slots in a pre-sized vector → no contention in the parallel
-        //  phase.  Drain runs serially in frame order to preserve
-        //  recodata.root write ordering + histogram fill ordering.
+        //  phase.  Each worker raises `frame_ready[i]` when its frame is
+        //  computed; the main thread appends frames to the tree as soon
+        //  as the next one in order is ready (reorder buffer =
+        //  `frame_results` itself), overlapping the append with compute.
         //
         //  Thread safety:
         //   * `process_frame_pure` reads only `[&]`-captured shared
         //     state (registry, recodata_cfg, framer_cfg, edge_rejection_ns,
         //     index_to_hit_xy) — all read-only after init.
-        //   * It calls `compute_ring_fit_pure` → `fit_circle` (ROOT's
-        //     Minuit2 fitter) which is documented thread-safe per
-        //     instance.  Each call constructs its own local Fitter.
-        //   * NO histogram fills, NO recodata.add_*, NO tree Fill in
-        //     the parallel phase.
+        //   * Ring fits are deferred: the frame pass only flags ring
+        //     candidates, then `fit_rings_batched` gathers them into
+        //     n_threads SoA batches (closed-form Taubin on moment sums,
+        //     no per-ring allocations) with disjoint result slots.
+        //   * The tree append never touches the ring results, so it does
+        //     not wait for the batched fits.
+        //   * Histogram fills go to per-shard clones (`drain_shards`),
+        //     one fixed frame chunk per shard, merged once after the
+        //     spill loop → the output does not depend on n_threads.
         //
         //  Falls back to a serial path when n_threads <= 1.
         const size_t n_frames = frames_in_spill.size();
-        const size_t n_threads = std::max<size_t>(
-            1, std::min<size_t>(std::thread::hardware_concurrency(), n_frames));
+        const size_t n_pool = util::TaskPool::instance().concurrency();
+        const size_t n_threads = std::max<size_t>(1, std::min<size_t>(n_pool, n_frames));
         if (i_spill == 0)
             mist::logger::info(TString::Format(
-                                   "(recodata_writer) parallel dispatch: hardware_concurrency=%u  "
-                                   "n_frames_first_spill=%zu  n_threads=%zu",
-                                   std::thread::hardware_concurrency(),
-                                   n_frames, n_threads)
+                                   "(recodata_writer) parallel dispatch: task_pool=%zu  "
+                                   "n_frames_first_spill=%zu  n_threads=%zu  drain_shards=%zu",
+                                   n_pool, n_frames, n_threads, drain_shards.size())
                                    .Data());
 
         std::vector<FrameResult> frame_results(n_frames);
@@ -1254,45 +1372,89 @@ void recodata_writer(
         {
             for (size_t iframe = 0; iframe < n_frames; ++iframe)
             {
-                AlcorLightdata cur(frames_in_spill[iframe]);
-                frame_results[iframe] = process_frame_pure(cur, frame_proc_ctx);
+                frame_results[iframe] = process_frame_pure(frames_in_spill[iframe], frame_proc_ctx);
+                append_frame(frame_results[iframe], frames_in_spill[iframe], spill.frame_reference[iframe]);
                 const size_t now_done = done.fetch_add(1) + 1;
                 tick_progress(now_done);
             }
         }
         else
         {
+            std::vector<std::atomic<bool>> frame_ready(n_frames);
+            std::atomic<bool> compute_failed{false};
             std::atomic<size_t> next_frame{0};
-            std::vector<std::future<void>> thread_pool;
-            thread_pool.reserve(n_threads);
+            util::TaskGroup compute_group;
             for (size_t t = 0; t < n_threads; ++t)
             {
-                thread_pool.push_back(std::async(std::launch::async, [&]()
-                                                 {
+                compute_group.run([&]()
+                                  {
                     while (true) {
                         const size_t my = next_frame.fetch_add(1);
                         if (my >= n_frames) return;
-                        AlcorLightdata cur(frames_in_spill[my]);
-                        frame_results[my] = process_frame_pure(cur, frame_proc_ctx);
+                        try {
+                            frame_results[my] = process_frame_pure(frames_in_spill[my], frame_proc_ctx);
+                        } catch (...) {
+                            //  Release the appender before the group
+                            //  carries the exception out.
+                            compute_failed.store(true);
+                            frame_ready[my].store(true, std::memory_order_release);
+                            frame_ready[my].notify_one();
+                            throw;
+                        }
+                        frame_ready[my].store(true, std::memory_order_release);
+                        frame_ready[my].notify_one();
                         const size_t now_done = done.fetch_add(1) + 1;
                         tick_progress(now_done);
-                    } }));
+                    } });
+            }
+            //  Ordered append, overlapped with the compute above.
+            for (size_t iframe = 0; iframe < n_frames; ++iframe)
+            {
+                frame_ready[iframe].wait(false, std::memory_order_acquire);
+                if (compute_failed.load())
+                    break;
+                append_frame(frame_results[iframe], frames_in_spill[iframe], spill.frame_reference[iframe]);
             }
-            for (auto &f : thread_pool)
-                f.get();
+            compute_group.wait();
         }
+        //  The spill's entries are complete: archive them while the rings
+        //  are fitted and the hists filled below.
+        archiver.push(std::move(pending_frames));
+        pending_frames.clear();
+        //  Batched ring fits over every flagged frame of the spill.
+        ::btana::recodata::fit_rings_batched(frames_in_spill, frame_results,
+                                             frame_proc_ctx, n_threads);
         //  Snap to 100% so the bar reflects "compute finished" even
         //  when the last ticks fell between mod-64 thresholds.
         post_processing.update(n_frames, n_frames);
 
-        //  Serial drain in frame order.  All hist fills, recodata
-        //  add_*, tree Fill, per-spill counter updates happen here.
-        //  Bar is already at 100% from the compute snap above; this
-        //  loop is fast so no in-loop ticks needed.
-        for (size_t iframe = 0; iframe < n_frames; ++iframe)
+        //  Stage 1C: sharded histogram fills.  Shard k always takes frame
+        //  chunk k, whichever worker picks it up.
+        drain_shards.sync_time_diff(drain_hists);
+        std::atomic<size_t> next_shard{0};
+        auto fill_shards = [&]()
+        {
+            while (true)
+            {
+                const size_t k = next_shard.fetch_add(1);
+                if (k >= drain_shards.size())
+                    return;
+                const auto [first, last] = drain_shards.chunk(k, n_frames);
+                for (size_t iframe = first; iframe < last; ++iframe)
+                    ::btana::recodata::fill_frame_hists(frame_results[iframe], i_spill, registry,
+                                                        recodata_cfg.radial_eff_per_ring_centre,
+                                                        drain_shards.shard(k));
+            }
+        };
+        if (n_threads <= 1)
+            fill_shards();
+        else
         {
-            AlcorLightdata current_lightdata(frames_in_spill[iframe]);
-            drain_frame_result(frame_results[iframe], current_lightdata);
+            util::TaskGroup fill_group;
+            const size_t n_fill = std::min(n_threads, drain_shards.size());
+            for (size_t t = 0; t < n_fill; ++t)
+                fill_group.run(fill_shards);
+            fill_group.wait();
         }
 
         mist::logger::info(TString::Format("Spill %i done — accepted: %i  had-edge: %i  duplicate-rejected: %i  total: %zu",
@@ -1306,6 +1468,12 @@ void recodata_writer(
     post_processing.finish(/*flush=*/false);
     progress_bars.finish();
 
+    //  Every entry is in the tree (and handed downstream) past this point.
+    archiver.finish();
+
+    //  Fold the drain shards into the output hists (fixed shard order).
+    drain_shards.merge();
+
     //  --- --- --- --- --- ---
     //  QA plots
     //  ---
@@ -1415,11 +1583,24 @@ void recodata_writer(
                 "run — coverage map falls back to geometric upper bound.");
         }
 
+        //  The channel footprints depend only on geometry and binning —
+        //  served from the content-addressed cache when any previous run
+        //  of the same geometry already rasterised them; this run's
+        //  channel weights are applied on top.
+        const std::string &cache_dir_cfg = recodata_cfg.coverage_map_cache_dir;
+        util::radiator_efficiency::CoverageMapStore coverage_store(
+            cache_dir_cfg == "off"  ? std::string()
+            : cache_dir_cfg.empty() ? data_repository + "/.coverage_cache"
+                                    : cache_dir_cfg,
+            static_cast<int>(util::TaskPool::instance().concurrency()),
+            static_cast<std::uintmax_t>(std::max(recodata_cfg.coverage_map_cache_max_mb, 0)) << 20,
+            recodata_cfg.coverage_map_cache_max_age_days);
+
         //  Build the TH2F with weighted channels.  If channel_weights
         //  is empty (no physics triggers, e.g. background-only run),
         //  pass nullptr → geometric upper bound (legacy V1 behaviour).
         std::unique_ptr<TH2F> h_coverage_map_rphi(
-            util::radiator_efficiency::build_coverage_map(
+            coverage_store.build_coverage_map(
                 index_to_hit_xy,
                 recodata_cfg.n_phi_bins_coverage,
                 recodata_cfg.r_min_coverage_mm,
@@ -1438,7 +1619,7 @@ void recodata_writer(
         //  spill-activity weights, just rasterised in (c_x, c_y).  Range
         //  mirrors the lightdata hitmaps (±99 mm, 396 bins).
         std::unique_ptr<TH2F> h_coverage_map_xy(
-            util::radiator_efficiency::build_coverage_map_xy(
+            coverage_store.build_coverage_map_xy(
                 index_to_hit_xy,
                 396, -99.f, 99.f,
                 396, -99.f, 99.f,
@@ -1463,6 +1644,12 @@ void recodata_writer(
             util::radiator_efficiency::radial_efficiency(
                 h_coverage_map_rphi.get(),
                 h_radial_first->GetXaxis()));
+        if (coverage_store.enabled())
+            mist::logger::info(TString::Format(
+                                   "(recodata_writer) coverage footprints: %zu loaded, %zu stored, %zu evicted in %s",
+                                   coverage_store.n_loaded(), coverage_store.n_stored(),
+                                   coverage_store.n_evicted(), coverage_store.cache_dir().c_str())
+                                   .Data());
         if (eff_R)
         {
             eff_R->SetName("h_eff_R");
@@ -2486,7 +2673,7 @@ void recodata_writer(
         //  it summarises.  Earlier ``extData/`` literal was a stale
         //  hard-code from the legacy macro paths and failed to open
         //  whenever the dashboard launched from a different cwd.
-        AnalysisResults ar(data_repository + "/standard_results.toml");
+        AnalysisResults ar(data_repository + "/standard_results.toml", ResultsBackend::Journal);
         ResultMap rm{
             {{run_name, "all", "recodata.n_spills"},
              {static_cast<double>(all_spills), 0.0}},
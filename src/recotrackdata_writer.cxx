@@ -6,11 +6,81 @@
 #include "alcor_recotrackdata.h"
 #include "analysis_results.h"
 #include "utility/config_dump.h"
+#include "writers/cascade.h" // RecodataFrameQueue
+#include "writers/recotrackdata/track_matching.h"
+#include "utility/config_reader.h" // FramerConfReader
+#include "utility/root_hist.h"
+#include "utility/task_pool.h"
+#include "TROOT.h"
+#include "TH1.h"
+#include "TParameter.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <limits>
 #include <memory>
+#include <thread>
+#include <utility>
 // TFilePtr is available via the alcor_recodata.h → utility.h → utility/root_io.h chain.
 
+namespace
+{
+
+//  End-to-end mode: `recodata_writer` (and its lightdata cascade) on a
+//  background thread, streaming its entries into `frames()`.  The
+//  destructor closes the queue before joining, so an early return on the
+//  consumer side never leaves recodata blocked on a full queue.
+class UpstreamRecodata
+{
+public:
+    template <class Run>
+    explicit UpstreamRecodata(Run run)
+        : frames_(btana::cascade::kRecodataQueueDepth)
+    {
+        thread_ = std::thread([this, run = std::move(run)]() mutable
+                              {
+            try
+            {
+                run(frames_);
+            }
+            catch (...)
+            {
+                error_ = std::current_exception();
+            }
+            frames_.close(); });
+    }
+    ~UpstreamRecodata()
+    {
+        frames_.close();
+        if (thread_.joinable())
+            thread_.join();
+    }
+    UpstreamRecodata(const UpstreamRecodata &) = delete;
+    UpstreamRecodata &operator=(const UpstreamRecodata &) = delete;
+
+    btana::cascade::RecodataFrameQueue &frames() { return frames_; }
+
+    /// Wait for recodata to finish (the rest of the stream is dropped);
+    /// rethrows a recodata_writer exception.
+    void join()
+    {
+        frames_.close();
+        if (thread_.joinable())
+            thread_.join();
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+private:
+    btana::cascade::RecodataFrameQueue frames_;
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+} // namespace
+
 void recotrackdata_writer(
     std::string data_repository,
     std::string run_name,
@@ -18,7 +88,11 @@ void recotrackdata_writer(
     std::string track_run_name,
     int max_frames,
     bool force_rebuild,
-    bool force_upstream)
+    bool force_upstream,
+    bool end_to_end,
+    double altai_tick_ns,
+    double match_tolerance_ns,
+    std::string framer_conf)
 {
     //  Output recotrackdata file.  Skip the whole pipeline if it
     //  exists and the caller didn't ask for a rebuild — the uniform
@@ -35,62 +109,93 @@ void recotrackdata_writer(
         return;
     }
 
-    //  Input recodata file — mirror recodata_writer's auto-cascade
-    //  behaviour: if recodata.root is missing/corrupt OR force_upstream
-    //  is set, invoke recodata_writer (which itself cascades into
-    //  lightdata_writer when needed).  Emits a warning when the cascade
-    //  is triggered implicitly (missing file) so the operator notices
-    //  they're rebuilding the chain rather than silently doing nothing.
     const std::string input_filename_recodata =
         data_repository + "/" + run_name + "/recodata.root";
-    TFilePtr input_file_recodata(TFile::Open(input_filename_recodata.c_str()));
-    const bool recodata_missing = !input_file_recodata || input_file_recodata->IsZombie();
-    if (recodata_missing || force_upstream)
-    {
-        if (recodata_missing && !force_upstream)
-            mist::logger::warning(
-                "(recotrackdata_writer) " + input_filename_recodata +
-                " missing or corrupt — auto-cascading into recodata_writer.  "
-                "Pass --force-upstream explicitly to skip this implicit cascade "
-                "(or to force a rebuild even when the file is present).");
-        else
-            mist::logger::info(
-                "(recotrackdata_writer) --force-upstream set — rebuilding recodata "
-                "(which itself cascades into lightdata).");
-        //  UNIT MISMATCH — DO NOT forward max_frames here.  This writer's
-        //  --max-spill knob actually caps FRAMES (recodata is per-frame; the
-        //  CLI variable name is a hold-over from a pre-frame-pipeline era).
-        //  recodata_writer's max_spill is a SPILL cap.  Forwarding the
-        //  frame cap as a spill cap silently truncates the upstream rebuild
-        //  to the wrong unit — `--max-spill 30` rebuilt 30 spills of
-        //  recodata, then locally capped to 30 frames, hiding tracking
-        //  failures.  Pass INT_MAX so the cascade rebuilds the full run;
-        //  the local frame cap below still honours the operator's intent.
-        recodata_writer(data_repository, run_name,
-                        /*max_spill=*/std::numeric_limits<int>::max(),
-                        /*force_rebuild=*/true,
-                        /*force_upstream=*/force_upstream);
+    auto recodata = std::make_unique<AlcorRecodata>();
+    TFilePtr input_file_recodata;
+    TTree *recodata_tree = nullptr;
+    std::unique_ptr<UpstreamRecodata> upstream;
+    if (end_to_end)
+    {
+        //  End-to-end: rebuild recodata (cascading into lightdata) in this
+        //  process and take its entries from memory as they are archived;
+        //  recodata.root is still written, but never read back here.  Same
+        //  full-run spill cap as the file cascade below.
+        ROOT::EnableThreadSafety();
+        mist::logger::info(
+            "(recotrackdata_writer) --end-to-end: running recodata in-process, "
+            "frames handed over in memory.");
+        upstream = std::make_unique<UpstreamRecodata>(
+            [&](btana::cascade::RecodataFrameQueue &frames)
+            {
+                recodata_writer(data_repository, run_name,
+                                /*max_spill=*/std::numeric_limits<int>::max(),
+                                /*force_rebuild=*/true,
+                                /*force_upstream=*/force_upstream,
+                                "conf/mapping_conf.toml", "conf/trigger_conf.toml",
+                                framer_conf, "conf/streaming.toml",
+                                /*ring_shape_mode=*/"auto",
+                                /*end_to_end=*/true, &frames);
+            });
+    }
+    else
+    {
+        //  Input recodata file — mirror recodata_writer's auto-cascade
+        //  behaviour: if recodata.root is missing/corrupt OR force_upstream
+        //  is set, invoke recodata_writer (which itself cascades into
+        //  lightdata_writer when needed).  Emits a warning when the cascade
+        //  is triggered implicitly (missing file) so the operator notices
+        //  they're rebuilding the chain rather than silently doing nothing.
         input_file_recodata.reset(TFile::Open(input_filename_recodata.c_str()));
-        if (!input_file_recodata || input_file_recodata->IsZombie())
+        const bool recodata_missing = !input_file_recodata || input_file_recodata->IsZombie();
+        if (recodata_missing || force_upstream)
         {
-            mist::logger::error(
-                "(recotrackdata_writer) " + input_filename_recodata +
-                " still missing after auto-cascade — aborting.");
-            return;
+            if (recodata_missing && !force_upstream)
+                mist::logger::warning(
+                    "(recotrackdata_writer) " + input_filename_recodata +
+                    " missing or corrupt — auto-cascading into recodata_writer.  "
+                    "Pass --force-upstream explicitly to skip this implicit cascade "
+                    "(or to force a rebuild even when the file is present).");
+            else
+                mist::logger::info(
+                    "(recotrackdata_writer) --force-upstream set — rebuilding recodata "
+                    "(which itself cascades into lightdata).");
+            //  UNIT MISMATCH — DO NOT forward max_frames here.  This writer's
+            //  --max-spill knob actually caps FRAMES (recodata is per-frame; the
+            //  CLI variable name is a hold-over from a pre-frame-pipeline era).
+            //  recodata_writer's max_spill is a SPILL cap.  Forwarding the
+            //  frame cap as a spill cap silently truncates the upstream rebuild
+            //  to the wrong unit — `--max-spill 30` rebuilt 30 spills of
+            //  recodata, then locally capped to 30 frames, hiding tracking
+            //  failures.  Pass INT_MAX so the cascade rebuilds the full run;
+            //  the local frame cap below still honours the operator's intent.
+            recodata_writer(data_repository, run_name,
+                            /*max_spill=*/std::numeric_limits<int>::max(),
+                            /*force_rebuild=*/true,
+                            /*force_upstream=*/force_upstream,
+                            "conf/mapping_conf.toml", "conf/trigger_conf.toml",
+                            framer_conf);
+            input_file_recodata.reset(TFile::Open(input_filename_recodata.c_str()));
+            if (!input_file_recodata || input_file_recodata->IsZombie())
+            {
+                mist::logger::error(
+                    "(recotrackdata_writer) " + input_filename_recodata +
+                    " still missing after auto-cascade — aborting.");
+                return;
+            }
         }
-    }
 
-    //  Link recodata tree locally
-    auto *recodata_tree = input_file_recodata->Get<TTree>("recodata");
-    if (!recodata_tree)
-    {
-        mist::logger::error(TString::Format("(recotrackdata_writer) 'recodata' tree missing in %s",
-                                            input_filename_recodata.c_str())
-                                .Data());
-        return;
+        //  Link recodata tree locally
+        recodata_tree = input_file_recodata->Get<TTree>("recodata");
+        if (!recodata_tree)
+        {
+            mist::logger::error(TString::Format("(recotrackdata_writer) 'recodata' tree missing in %s",
+                                                input_filename_recodata.c_str())
+                                    .Data());
+            return;
+        }
+        recodata->link_to_tree(recodata_tree);
     }
-    auto recodata = std::make_unique<AlcorRecodata>();
-    recodata->link_to_tree(recodata_tree);
 
     //  Input recotrackdata
     std::string input_filename_recotrackdata = data_repository + "/" + run_name + "/ALTAI/tracks.txt";
@@ -132,67 +237,309 @@ void recotrackdata_writer(
     auto recotrackdata = std::make_unique<AlcorRecotrackdata>(*recodata);
     recotrackdata->write_to_tree(recotrackdata_tree);
 
-    //  Get number of frames, capped at the caller's --max-frames knob.
-    //  Note: max_frames is also forwarded to upstream recodata_writer (as
-    //  max_spill) on the cascade path above, but when recodata.root already
-    //  exists we skip the cascade — without this local cap the CLI flag
-    //  would silently do nothing on second-pass runs.
-    auto n_frames = recodata_tree->GetEntries();
-    auto all_frames = std::min<Long64_t>(n_frames, max_frames);
+    //  ---
+    //  --- Track matching
+    //
+    //  Each tracking-trigger (0) frame is paired with an ALTAI event by
+    //  timestamp, spill by spill (writers/recotrackdata/track_matching.h):
+    //  the frame's spill time is rebuilt from its `frame` index and the
+    //  trigger coarse.  Spills are matched on the task pool while the next
+    //  one is read; the tree is filled in entry order on this thread.
+    //
+    //  Recodata without the `frame` branch, a track file without
+    //  timestamps, or no stated ALTAI timestamp unit (--altai-tick-ns)
+    //  falls back to the old running counter (n-th trigger-0 frame ↔
+    //  ALTAI event n).
+    ::btana::recotrackdata::TrackMatchConfig match_cfg;
+    if (altai_tick_ns > 0.)
+        match_cfg.altai_tick_ns = altai_tick_ns;
+    if (match_tolerance_ns > 0.)
+        match_cfg.tolerance_ns = match_tolerance_ns;
+    const bool altai_tick_known = match_cfg.altai_tick_ns > 0.;
+    const auto altai_spills = altai_tick_known
+                                  ? ::btana::recotrackdata::split_altai_spills(current_tracking, match_cfg)
+                                  : std::vector<::btana::recotrackdata::AltaiSpill>{};
+    const bool altai_timed = std::any_of(altai_spills.begin(), altai_spills.end(),
+                                         [](const auto &spill)
+                                         { return spill.times_ns.front() != spill.times_ns.back(); });
+    const bool recodata_framed = upstream || recodata_tree->GetBranch("frame");
+    const bool match_by_time = altai_timed && recodata_framed;
+    if (match_by_time)
+        mist::logger::info(TString::Format("(recotrackdata_writer) timestamp matching: %zu ALTAI spills, tolerance %.0f ns, "
+                                           "ALTAI tick %g ns",
+                                           altai_spills.size(), match_cfg.tolerance_ns, match_cfg.altai_tick_ns)
+                               .Data());
+    else
+        mist::logger::warning(TString::Format("(recotrackdata_writer) %s — falling back to counter matching "
+                                              "(n-th tracking-trigger frame = ALTAI event n).",
+                                              !recodata_framed   ? "recodata has no 'frame' branch (written before frame indices were stored)"
+                                              : !altai_tick_known ? "ALTAI timestamp unit not given (pass --altai-tick-ns)"
+                                                                  : "ALTAI tracks carry no timestamps")
+                                  .Data());
+
+    //  Frame length the recodata frames were built with, for the frame
+    //  spill times below.  recodata.root records it in Config/frame_size;
+    //  --framer-conf covers files written without it, and end-to-end mode,
+    //  where the in-process recodata runs with that same conf.
+    double frame_length_cc = FramerConfReader(framer_conf).frame_size;
+    if (input_file_recodata)
+    {
+        if (const auto *frame_size = input_file_recodata->Get<TParameter<int>>("Config/frame_size"))
+            frame_length_cc = frame_size->GetVal();
+        else
+            mist::logger::warning(TString::Format("(recotrackdata_writer) %s has no Config/frame_size — using "
+                                                  "frame_size = %.0f from %s",
+                                                  input_filename_recodata.c_str(), frame_length_cc, framer_conf.c_str())
+                                      .Data());
+    }
+
+    //  One spill's tracking-trigger frames, moved out of `recodata`.
+    struct PendingSpill
+    {
+        int i_spill = -1;
+        std::vector<btana::cascade::RecodataFrame> frames;
+        std::vector<double> frame_ns;
+        ::btana::recotrackdata::SpillMatch match;
+        std::atomic<bool> ready{false};
+    };
+    std::deque<std::unique_ptr<PendingSpill>> pending_spills;
+    auto current_spill = std::make_unique<PendingSpill>();
+    util::TaskGroup match_group;
+    //  Running re-alignment of recodata ↔ ALTAI spills (pair_altai_spill).
+    int altai_spill_shift = 0;
+    int n_spills_unpaired = 0;
+
+    //  Match-quality QA, one entry per spill (index = position in the run).
+    RootHist<TH1F> h_match_residual("h_match_residual",
+                                    ";t_{ALTAI} - t_{frame} - offset (ns);Matched frames",
+                                    200, -match_cfg.tolerance_ns, match_cfg.tolerance_ns);
+    std::vector<double> spill_frames, spill_matched, spill_altai_unmatched, spill_drift_ns;
 
-    //  Loop over frames
     auto i_spill = -1;
     auto n_spils = 0;
     auto altai_events_counter = -1;
     auto recotrack_events_counter = 0;
-    std::map<int, int> per_spill_events_counter_recodata;
-    std::map<int, int> per_spill_events_counter_trackdata;
-    for (int i_frame = 0; i_frame < all_frames; ++i_frame)
+    std::size_t n_frames_with_tracks = 0;
+    std::size_t n_altai_unmatched = 0;
+
+    auto close_spill = [&]()
     {
-        //  Load data for current frame
-        recodata_tree->GetEntry(i_frame);
+        PendingSpill *spill = current_spill.get();
+        pending_spills.push_back(std::move(current_spill));
+        current_spill = std::make_unique<PendingSpill>();
+        current_spill->i_spill = i_spill;
+        if (!match_by_time)
+        {
+            spill->ready.store(true, std::memory_order_release);
+            return;
+        }
+        //  Pair on this thread, in spill order (the shift carries over);
+        //  only the match itself goes to the pool.
+        int i_altai = -1;
+        if (spill->i_spill >= 0)
+        {
+            const int shift_before = altai_spill_shift;
+            i_altai = ::btana::recotrackdata::pair_altai_spill(spill->frame_ns, spill->i_spill, altai_spills,
+                                                               altai_spill_shift, match_cfg);
+            if (altai_spill_shift != shift_before)
+                mist::logger::warning(TString::Format("(recotrackdata_writer) spill %d: ALTAI spill pairing re-aligned "
+                                                      "by %+d (now spill %d ↔ ALTAI spill %d)",
+                                                      spill->i_spill, altai_spill_shift - shift_before,
+                                                      spill->i_spill, i_altai)
+                                          .Data());
+            if (i_altai < 0 && !spill->frame_ns.empty())
+            {
+                ++n_spills_unpaired;
+                mist::logger::warning(TString::Format("(recotrackdata_writer) spill %d: no ALTAI spill with a "
+                                                      "consistent duration and event count — left unmatched",
+                                                      spill->i_spill)
+                                          .Data());
+            }
+        }
+        match_group.run([spill, i_altai, &altai_spills, &match_cfg]()
+                        {
+            static const ::btana::recotrackdata::AltaiSpill kNoEvents;
+            spill->match = ::btana::recotrackdata::match_spill(
+                spill->frame_ns, i_altai >= 0 ? altai_spills[i_altai] : kNoEvents, match_cfg);
+            spill->ready.store(true, std::memory_order_release); });
+    };
+
+    //  Fill every leading spill whose match is done, in entry order.
+    auto flush_spills = [&](bool wait)
+    {
+        while (!pending_spills.empty())
+        {
+            PendingSpill &spill = *pending_spills.front();
+            if (!spill.ready.load(std::memory_order_acquire))
+            {
+                if (!wait)
+                    return;
+                match_group.wait();
+            }
+            for (std::size_t k = 0; k < spill.frames.size(); ++k)
+            {
+                auto &frame = spill.frames[k];
+                uint32_t event_id = ::btana::recotrackdata::SpillMatch::kUnmatched;
+                if (match_by_time)
+                    event_id = spill.match.event_ids[k];
+                else
+                    event_id = static_cast<uint32_t>(++altai_events_counter);
+                std::swap(recodata->get_triggers_link(), frame.triggers);
+                std::swap(recodata->get_recodata_link(), frame.hits);
+                recotrackdata->set_frame_id(frame.frame_id);
+                recotrackdata->set_trigger_mask(frame.trigger_mask);
+                if (event_id != ::btana::recotrackdata::SpillMatch::kUnmatched)
+                {
+                    const auto tracks = current_tracking.get_event_tracks(event_id);
+                    n_frames_with_tracks += !tracks.empty();
+                    recotrackdata->import_event(tracks);
+                }
+                recotrackdata_tree->Fill();
+                recotrackdata->clear();
+                recotrack_events_counter++;
+            }
+            if (match_by_time && spill.i_spill >= 0)
+            {
+                for (const float residual : spill.match.residuals_ns)
+                    h_match_residual->Fill(residual);
+                spill_frames.push_back(static_cast<double>(spill.frames.size()));
+                spill_matched.push_back(static_cast<double>(spill.match.n_matched));
+                spill_altai_unmatched.push_back(static_cast<double>(spill.match.n_events_unmatched));
+                spill_drift_ns.push_back(spill.match.drift_ns);
+                n_altai_unmatched += spill.match.n_events_unmatched;
+            }
+            pending_spills.pop_front();
+        }
+    };
 
+    //  Per-frame body on the entry currently held by `recodata` — filled
+    //  by GetEntry (file) or swapped in from the upstream queue.
+    auto process_frame = [&]()
+    {
         //  HitmaskDeadLane signals the event is start of spill, tells which channels are available
-        // const& over get_triggers_link() to avoid copying the whole vector per frame.
-        const auto &current_trigger = recodata->get_triggers_link();
-        auto it = std::find_if(current_trigger.begin(), current_trigger.end(), [](const TriggerEvent &t)
-                               { return t.index == TriggerStartOfSpill; });
-        if (it != current_trigger.end())
+        //  Both selections test the entry's trigger mask; the vector is only
+        //  walked to fetch the sync trigger's coarse time.
+        if (recodata->is_start_of_spill())
         {
             //  Spill management
             i_spill++;
             n_spils++;
+            close_spill();
+            flush_spills(/*wait=*/false);
 
             //  This event is not of physical interest
-            continue;
+            return;
         }
 
         //  Select Luca AND trigger (0) or timing trigger (101)
-        it = std::find_if(current_trigger.begin(), current_trigger.end(), [](const TriggerEvent &t)
-                          { return t.index == 0; });
-        if (it != current_trigger.end())
+        if (recodata->check_trigger(0))
         {
-            //  Trigger found, trigger 0 is the sync trigger for tracking
-            per_spill_events_counter_recodata[i_spill]++;
-
-            //  Keep track of the actual number of frames used in the analysis
-            altai_events_counter++;
-
-            //  Recotrack events counter
-            recotrack_events_counter++;
-            recotrackdata->import_event(current_tracking.get_event_tracks(altai_events_counter));
+            // const& over get_triggers_link() to avoid copying the whole vector per frame.
+            const auto &current_trigger = recodata->get_triggers_link();
+            const auto it = std::find_if(current_trigger.begin(), current_trigger.end(), [](const TriggerEvent &t)
+                                         { return t.index == 0; });
+            //  Trigger found, trigger 0 is the sync trigger for tracking.
+            //  Spill time: frame start + trigger coarse within the frame.
+            const uint32_t frame_id = recodata->get_frame_id();
+            current_spill->frame_ns.push_back(
+                frame_id == AlcorRecodata::kNoFrame
+                    ? 0.
+                    : (frame_id * frame_length_cc + it->coarse) * BTANA_ALCOR_CC_TO_NS);
+            auto &frame = current_spill->frames.emplace_back();
+            frame.frame_id = frame_id;
+            frame.trigger_mask = recodata->get_trigger_mask();
+            std::swap(frame.triggers, recodata->get_triggers_link());
+            std::swap(frame.hits, recodata->get_recodata_link());
+        }
+    };
 
-            recotrackdata_tree->Fill();
-            recotrackdata->clear();
+    if (upstream)
+    {
+        //  Stop taking frames at the cap; join() then lets recodata finish
+        //  its archive without the hand-off.
+        int i_frame = 0;
+        btana::cascade::RecodataSpillFrames batch;
+        while (i_frame < max_frames && upstream->frames().pop(batch))
+            for (auto &frame : batch)
+            {
+                if (i_frame++ >= max_frames)
+                    break;
+                std::swap(recodata->get_triggers_link(), frame.triggers);
+                std::swap(recodata->get_recodata_link(), frame.hits);
+                recodata->set_frame_id(frame.frame_id);
+                recodata->set_trigger_mask(frame.trigger_mask);
+                process_frame();
+            }
+        upstream->join();
+        if (i_frame == 0)
+        {
+            mist::logger::error("(recotrackdata_writer) --end-to-end: recodata produced no frames — aborting.");
+            return;
+        }
+    }
+    else
+    {
+        //  Get number of frames, capped at the caller's --max-frames knob.
+        //  Note: max_frames is also forwarded to upstream recodata_writer (as
+        //  max_spill) on the cascade path above, but when recodata.root already
+        //  exists we skip the cascade — without this local cap the CLI flag
+        //  would silently do nothing on second-pass runs.
+        auto n_frames = recodata_tree->GetEntries();
+        auto all_frames = std::min<Long64_t>(n_frames, max_frames);
+        for (int i_frame = 0; i_frame < all_frames; ++i_frame)
+        {
+            //  Load data for current frame
+            recodata_tree->GetEntry(i_frame);
+            process_frame();
         }
     }
+    close_spill();
+    flush_spills(/*wait=*/true);
+    match_group.wait();
 
-    mist::logger::info(TString::Format("(recotrackdata_writer) Matched %d frames to tracking trigger", recotrack_events_counter).Data());
+    const double match_efficiency = recotrack_events_counter > 0
+                                        ? static_cast<double>(n_frames_with_tracks) / recotrack_events_counter
+                                        : 0.;
+    mist::logger::info(TString::Format("(recotrackdata_writer) %zu of %d tracking-trigger frames matched to ALTAI tracks (%.1f %%), "
+                                       "%zu ALTAI events left unmatched, %d spills without a consistent ALTAI spill",
+                                       n_frames_with_tracks, recotrack_events_counter, 100. * match_efficiency,
+                                       n_altai_unmatched, n_spills_unpaired)
+                           .Data());
     // TContext ctx (above) ensures Write lands in output_file; explicit cd
     // for redundancy in case the RAII guard's scope ever moves.
     output_file->cd();
     recotrackdata_tree->Write();
 
+    //  ---
+    //  --- Track-matching QA (timestamp mode only)
+    if (match_by_time)
+    {
+        TDirectory *matching_dir = output_file->mkdir("TrackMatching");
+        matching_dir->cd();
+        h_match_residual->Write();
+        const int n_qa_spills = static_cast<int>(spill_frames.size());
+        RootHist<TH1F> h_match_fraction("h_match_fraction",
+                                        ";Spill;Tracking-trigger frames matched / frames",
+                                        std::max(1, n_qa_spills), 0, std::max(1, n_qa_spills));
+        RootHist<TH1F> h_altai_unmatched("h_altai_unmatched",
+                                         ";Spill;ALTAI events without a frame",
+                                         std::max(1, n_qa_spills), 0, std::max(1, n_qa_spills));
+        RootHist<TH1F> h_match_drift("h_match_drift",
+                                     ";Spill;Offset drift over the spill (ns)",
+                                     std::max(1, n_qa_spills), 0, std::max(1, n_qa_spills));
+        for (int k = 0; k < n_qa_spills; ++k)
+        {
+            if (spill_frames[k] > 0)
+                h_match_fraction->SetBinContent(k + 1, spill_matched[k] / spill_frames[k]);
+            h_altai_unmatched->SetBinContent(k + 1, spill_altai_unmatched[k]);
+            h_match_drift->SetBinContent(k + 1, spill_drift_ns[k]);
+        }
+        h_match_fraction->Write();
+        h_altai_unmatched->Write();
+        h_match_drift->Write();
+        output_file->cd();
+    }
+
     //  ---
     //  --- Config — self-describing parameter dump.
     //
@@ -208,11 +555,22 @@ void recotrackdata_writer(
         dump.add("max_frames", max_frames)
             .add("force_rebuild", force_rebuild)
             .add("force_upstream", force_upstream)
+            .add("end_to_end", end_to_end)
+            .add("match_mode", match_by_time ? "timestamp" : "counter")
+            .add("altai_tick_ns", match_cfg.altai_tick_ns)
+            .add("match_tolerance_ns", match_cfg.tolerance_ns)
+            .add("match_drift_gain", match_cfg.drift_gain)
+            .add("altai_spill_gap_ns", match_cfg.spill_gap_ns)
+            .add("frame_size", frame_length_cc)
+            .add_path("framer_conf", framer_conf)
+            .add("spills_unpaired", n_spills_unpaired)
             .add_path("input_recodata_root", input_filename_recodata)
             .add_path("input_tracks_txt", input_filename_recotrackdata)
             .add_path("track_data_repository", track_data_repository)
             .add_path("track_run_name", track_run_name)
-            .add("frames_matched_to_tracks", recotrack_events_counter)
+            .add("tracking_trigger_frames", recotrack_events_counter)
+            .add("frames_matched_to_tracks", static_cast<long>(n_frames_with_tracks))
+            .add("altai_events_unmatched", static_cast<long>(n_altai_unmatched))
             .add("spills_seen", n_spils);
     }
 
@@ -228,10 +586,12 @@ void recotrackdata_writer(
         //  the git repo root) — same convention as recodata + lightdata
         //  + calibration writers.  The earlier ``extData/`` literal was
         //  a stale hard-code.
-        AnalysisResults ar(data_repository + "/standard_results.toml");
+        AnalysisResults ar(data_repository + "/standard_results.toml", ResultsBackend::Journal);
         ar.update(ResultMap{
                       {{run_name, "all", "recotrack.n_matched_tracks"},
-                       {static_cast<double>(recotrack_events_counter), 0.0}},
+                       {static_cast<double>(n_frames_with_tracks), 0.0}},
+                      {{run_name, "all", "recotrack.match_efficiency"},
+                       {match_efficiency, 0.0}},
                       {{run_name, "all", "recotrack.n_spills"},
                        {static_cast<double>(n_spils), 0.0}},
                   },
@@ -0,0 +1,240 @@
+/**
+ * @file task_pool.cxx
+ * @brief Implementation of @ref util::TaskPool / @ref util::TaskGroup —
+ *        see `utility/task_pool.h`.
+ */
+
+#include "utility/task_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace util
+{
+
+namespace
+{
+
+//  Identity of the current thread inside a pool (nullptr on non-pool
+//  threads): submissions from a worker go to its own deque.
+thread_local TaskPool *tl_pool = nullptr;
+thread_local std::size_t tl_index = 0;
+
+std::mutex g_pool_mutex;
+std::unique_ptr<TaskPool> g_pool;
+int g_requested_threads = -1;
+
+std::size_t resolve_threads(int n_threads)
+{
+    if (n_threads > 0)
+        return static_cast<std::size_t>(n_threads);
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+//  Pop from the back (owner, LIFO) or the front (injection / thief, FIFO).
+template <bool Back, class Queue, class Task>
+bool pop(Queue &queue, Task &task)
+{
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    if constexpr (Back)
+    {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+    }
+    else
+    {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+    }
+    return true;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────
+//  TaskPool
+// ─────────────────────────────────────────────────────────────────────
+
+void TaskPool::configure(int n_threads)
+{
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    g_requested_threads = n_threads;
+    if (!g_pool)
+        return; // created lazily with the new size
+    const std::size_t n = resolve_threads(n_threads);
+    if (g_pool->concurrency() == n)
+        return;
+    g_pool->stop();
+    g_pool->start(n);
+}
+
+TaskPool &TaskPool::instance()
+{
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (!g_pool)
+        g_pool.reset(new TaskPool(resolve_threads(g_requested_threads)));
+    return *g_pool;
+}
+
+TaskPool::TaskPool(std::size_t n_threads)
+{
+    start(n_threads);
+}
+
+TaskPool::~TaskPool()
+{
+    stop();
+}
+
+void TaskPool::start(std::size_t n_threads)
+{
+    //  n_workers_ and the queues are fixed before the first worker starts;
+    //  workers never look at workers_ itself.
+    n_workers_ = n_threads > 1 ? n_threads - 1 : 0;
+    queues_.clear();
+    for (std::size_t i = 0; i <= n_workers_; ++i)
+        queues_.push_back(std::make_unique<Queue>());
+    stopping_ = false;
+    workers_.reserve(n_workers_);
+    for (std::size_t i = 0; i < n_workers_; ++i)
+        workers_.emplace_back([this, i]
+                              { worker_loop(i); });
+}
+
+void TaskPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto &worker : workers_)
+        worker.join();
+    workers_.clear();
+}
+
+void TaskPool::notify(bool all)
+{
+    //  Taking the mutex orders the state change before any sleeper's
+    //  predicate check, so the wakeup cannot be lost.
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    if (all)
+        sleep_cv_.notify_all();
+    else
+        sleep_cv_.notify_one();
+}
+
+void TaskPool::submit(Task task)
+{
+    const std::size_t n_workers = n_workers_;
+    Queue &queue = (tl_pool == this) ? *queues_[tl_index] : *queues_[n_workers];
+    ++n_queued_;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    notify(/*all=*/false);
+}
+
+bool TaskPool::run_one()
+{
+    const std::size_t n_workers = n_workers_;
+    const bool is_worker = (tl_pool == this);
+    Task task;
+    bool found = is_worker && pop<true>(*queues_[tl_index], task);
+    if (!found)
+        found = pop<false>(*queues_[n_workers], task);
+    for (std::size_t k = 0; !found && k < n_workers; ++k)
+    {
+        const std::size_t victim = ((is_worker ? tl_index + 1 : 0) + k) % n_workers;
+        if (!is_worker || victim != tl_index)
+            found = pop<false>(*queues_[victim], task);
+    }
+    if (!found)
+        return false;
+    --n_queued_;
+
+    std::exception_ptr error;
+    try
+    {
+        task.fn();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    task.group->finish(error);
+    return true;
+}
+
+void TaskPool::worker_loop(std::size_t index)
+{
+    tl_pool = this;
+    tl_index = index;
+    while (true)
+    {
+        if (run_one())
+            continue;
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this]
+                       { return stopping_ || n_queued_.load() > 0; });
+        if (stopping_ && n_queued_.load() == 0)
+            return;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  TaskGroup
+// ─────────────────────────────────────────────────────────────────────
+
+TaskGroup::~TaskGroup()
+{
+    wait_quietly();
+}
+
+void TaskGroup::run(std::function<void()> fn)
+{
+    ++remaining_;
+    pool_.submit({std::move(fn), this});
+}
+
+void TaskGroup::finish(std::exception_ptr error)
+{
+    if (error)
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_)
+            error_ = error;
+    }
+    //  The group may be destroyed as soon as remaining_ hits zero — only
+    //  the pool is touched afterwards.
+    TaskPool &pool = pool_;
+    if (remaining_.fetch_sub(1) == 1)
+        pool.notify(/*all=*/true);
+}
+
+void TaskGroup::wait_quietly()
+{
+    while (remaining_.load() > 0)
+    {
+        if (pool_.run_one())
+            continue;
+        std::unique_lock<std::mutex> lock(pool_.sleep_mutex_);
+        pool_.sleep_cv_.wait(lock, [this]
+                             { return remaining_.load() == 0 || pool_.n_queued_.load() > 0; });
+    }
+}
+
+void TaskGroup::wait()
+{
+    wait_quietly();
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (error_)
+        std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+} // namespace util
@@ -1,63 +1,434 @@
 #include "tracking_altai.h"
 #include <mist/logger/logger.h>
 
-std::vector<TrackingAltaiStruct> TrackingAltai::get_event_tracks(uint32_t event_id) const
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+//  Bump when the cache layout or TrackingAltaiStruct changes meaning —
+//  old caches then stop matching and are rebuilt from the text.
+constexpr uint32_t kCacheFormatVersion = 1;
+constexpr char kCacheMagic[8] = {'B', 'T', 'A', 'L', 'T', 'A', 'I', 'T'};
+
+//  Floating-point std::from_chars is not in every standard library this
+//  builds against (older libc++); fall back to strtod there, which needs
+//  a NUL-terminated buffer — so that path reads the file into a string
+//  instead of mapping it.
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+constexpr bool kFloatFromChars = true;
+#else
+constexpr bool kFloatFromChars = false;
+#endif
+
+//  Read-only view of the whole file: mmap'd when possible, otherwise a
+//  heap copy.  Empty files map to an empty view.
+class FileView
 {
-    auto it = data_map.find(event_id);
-    if (it != data_map.end())
-        return it->second;
-    return {};
+public:
+    explicit FileView(const std::string &path)
+    {
+        if (kFloatFromChars)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+            struct stat st{};
+            if (::fstat(fd, &st) == 0)
+            {
+                size_ = static_cast<std::size_t>(st.st_size);
+                ok_ = true;
+                if (size_ > 0)
+                {
+                    void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED)
+                    {
+                        ::madvise(p, size_, MADV_SEQUENTIAL);
+                        mapped_ = p;
+                        data_ = static_cast<const char *>(p);
+                    }
+                    else
+                        ok_ = false;
+                }
+            }
+            ::close(fd);
+            if (ok_)
+                return;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return;
+        copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = copy_.c_str();
+        size_ = copy_.size();
+        ok_ = true;
+    }
+    ~FileView()
+    {
+        if (mapped_)
+            ::munmap(mapped_, size_);
+    }
+    FileView(const FileView &) = delete;
+    FileView &operator=(const FileView &) = delete;
+
+    bool ok() const noexcept { return ok_; }
+    const char *begin() const noexcept { return data_; }
+    const char *end() const noexcept { return data_ + size_; }
+
+private:
+    void *mapped_ = nullptr;
+    std::string copy_;
+    const char *data_ = "";
+    std::size_t size_ = 0;
+    bool ok_ = false;
+};
+
+void skip_blanks(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        ++p;
+}
+
+template <class T>
+bool parse_field(const char *&p, const char *end, T &out)
+{
+    skip_blanks(p, end);
+    if (p >= end)
+        return false; // field missing on this line
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if constexpr (kFloatFromChars)
+        {
+            const auto [ptr, ec] = std::from_chars(p, end, out);
+            if (ec != std::errc{})
+                return false;
+            p = ptr;
+        }
+        else
+        {
+            //  NUL-terminated copy (see FileView); strtod stops at the
+            //  separator, never past the end of the line.
+            char *ptr = nullptr;
+            out = static_cast<T>(std::strtod(p, &ptr));
+            if (ptr == p)
+                return false;
+            p = ptr;
+        }
+    }
+    else
+    {
+        const auto [ptr, ec] = std::from_chars(p, end, out);
+        if (ec != std::errc{})
+            return false;
+        p = ptr;
+    }
+    return true;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────
+//  Lookup
+// ─────────────────────────────────────────────────────────────────────
+
+std::size_t TrackingAltai::find_event(uint32_t event_id) const
+{
+    //  ALTAI numbers its events 0…N−1, so the ID is normally its own index.
+    if (event_id < event_ids.size() && event_ids[event_id] == event_id)
+        return event_id;
+    const auto it = std::lower_bound(event_ids.begin(), event_ids.end(), event_id);
+    if (it == event_ids.end() || *it != event_id)
+        return static_cast<std::size_t>(-1);
+    return static_cast<std::size_t>(it - event_ids.begin());
+}
+
+std::span<const TrackingAltaiStruct> TrackingAltai::get_event_tracks(uint32_t event_id) const
+{
+    const std::size_t i = find_event(event_id);
+    if (i == static_cast<std::size_t>(-1))
+        return {};
+    return {tracks.data() + event_offsets[i], tracks.data() + event_offsets[i + 1]};
 }
 
 int TrackingAltai::get_event_tracks_size(uint32_t event_id) const
 {
-    auto it = data_map.find(event_id);
-    if (it != data_map.end())
-        return static_cast<int>(it->second.size());
-    return 0;
+    return static_cast<int>(get_event_tracks(event_id).size());
 }
 
-void TrackingAltai::load_tracking_file(const std::string &input_file)
+const TrackingAltaiStruct &TrackingAltai::track_at(uint32_t event_id, std::size_t idx) const
 {
-    mist::logger::info(TString::Format("(TrackingAltai::load_tracking_file) Loading tracking file").Data());
-    std::ifstream infile(input_file);
-    if (!infile.is_open())
+    const auto event_tracks = get_event_tracks(event_id);
+    if (idx >= event_tracks.size())
+        throw std::out_of_range("(TrackingAltai) no track " + std::to_string(idx) +
+                                " in event " + std::to_string(event_id));
+    return event_tracks[idx];
+}
+
+std::map<uint32_t, std::vector<TrackingAltaiStruct>> TrackingAltai::get_data_map() const
+{
+    std::map<uint32_t, std::vector<TrackingAltaiStruct>> result;
+    for (std::size_t i = 0; i < event_ids.size(); ++i)
+        result.emplace(event_ids[i],
+                       std::vector<TrackingAltaiStruct>(tracks.begin() + event_offsets[i],
+                                                        tracks.begin() + event_offsets[i + 1]));
+    return result;
+}
+
+void TrackingAltai::splice_event(uint32_t event_id, std::span<const TrackingAltaiStruct> new_tracks, bool append)
+{
+    //  Copy first: @p new_tracks may view into `tracks` itself.
+    const std::vector<TrackingAltaiStruct> incoming(new_tracks.begin(), new_tracks.end());
+    const auto it = std::lower_bound(event_ids.begin(), event_ids.end(), event_id);
+    const auto pos = static_cast<std::size_t>(it - event_ids.begin());
+    if (it == event_ids.end() || *it != event_id)
     {
-        mist::logger::warning(TString::Format("Cannot open input file : %s", input_file.c_str()).Data());
-        return;
+        const uint32_t at = event_offsets[pos];
+        event_ids.insert(it, event_id);
+        event_offsets.insert(event_offsets.begin() + pos + 1, at);
     }
+    auto first = tracks.begin() + event_offsets[pos];
+    auto last = tracks.begin() + event_offsets[pos + 1];
+    const auto n_removed = append ? 0 : static_cast<int64_t>(last - first);
+    if (!append)
+        last = tracks.erase(first, last);
+    tracks.insert(last, incoming.begin(), incoming.end());
+    const int64_t delta = static_cast<int64_t>(incoming.size()) - n_removed;
+    for (std::size_t i = pos + 1; i < event_offsets.size(); ++i)
+        event_offsets[i] = static_cast<uint32_t>(event_offsets[i] + delta);
+}
 
-    std::string line;
-    bool firstLine = true;
-    while (std::getline(infile, line))
+// ─────────────────────────────────────────────────────────────────────
+//  Loading
+// ─────────────────────────────────────────────────────────────────────
+
+bool TrackingAltai::parse_text(const std::string &input_file)
+{
+    const FileView file(input_file);
+    if (!file.ok())
+        return false;
+
+    //  Tracks in file order, then grouped by a stable sort if the file is
+    //  not already ordered by event (it normally is).
+    std::vector<TrackingAltaiStruct> parsed;
+    std::vector<uint32_t> trackless; // events listed as '*'
+    std::size_t n_bad_lines = 0;
+
+    const char *p = file.begin();
+    const char *const end = file.end();
+    bool first_line = true;
+    while (p < end)
     {
-        if (firstLine)
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!eol)
+            eol = end;
+        const char *line = p;
+        p = eol + (eol < end ? 1 : 0);
+        if (first_line)
         {
-            firstLine = false;
+            first_line = false; // column header
             continue;
         }
 
-        int event_id;
-        std::stringstream ss(line);
-
-        if (line.find('*') != std::string::npos)
+        const char *q = line;
+        skip_blanks(q, eol);
+        if (q == eol)
+            continue; // blank line
+        uint32_t event_id = 0;
+        if (!parse_field(q, eol, event_id))
+        {
+            ++n_bad_lines;
+            continue;
+        }
+        if (std::memchr(q, '*', eol - q))
+        {
+            trackless.push_back(event_id); // event exists, but has no tracks
+            continue;
+        }
+        TrackingAltaiStruct track{};
+        track.event_id = event_id;
+        if (!(parse_field(q, eol, track.zero_plane_x) && parse_field(q, eol, track.zero_plane_y) &&
+              parse_field(q, eol, track.zero_plane_z) && parse_field(q, eol, track.angcoeff_dx) &&
+              parse_field(q, eol, track.angcoeff_dy) && parse_field(q, eol, track.angcoeff_dz) &&
+              parse_field(q, eol, track.chi2) && parse_field(q, eol, track.ndof) &&
+              parse_field(q, eol, track.chi2ndof) && parse_field(q, eol, track.timestamp)))
         {
-            ss >> event_id;
-            data_map.try_emplace(event_id); //  event exists, but has no tracks (line is '*')
+            ++n_bad_lines;
             continue;
         }
+        parsed.push_back(track);
+    }
+    if (n_bad_lines > 0)
+        mist::logger::warning(TString::Format("(TrackingAltai::load_tracking_file) Skipped %zu malformed lines in %s",
+                                              n_bad_lines, input_file.c_str())
+                                  .Data());
 
-        ss >> event_id;
-        // Hoist the per-line map[event_id] + .back() lookup so we do them
-        // ONCE instead of 11× (one per stream operator).  Previous version
-        // did 22 map operator[]/back() calls per input line.
-        auto &tracks_for_event = data_map[event_id];
-        auto &track = tracks_for_event.emplace_back();
+    const auto by_event = [](const TrackingAltaiStruct &a, const TrackingAltaiStruct &b)
+    { return a.event_id < b.event_id; };
+    if (!std::is_sorted(parsed.begin(), parsed.end(), by_event))
+        std::stable_sort(parsed.begin(), parsed.end(), by_event);
+    std::sort(trackless.begin(), trackless.end());
+    trackless.erase(std::unique(trackless.begin(), trackless.end()), trackless.end());
 
-        ss >> track.zero_plane_x >> track.zero_plane_y >> track.zero_plane_z >> track.angcoeff_dx >> track.angcoeff_dy >> track.angcoeff_dz >> track.chi2 >> track.ndof >> track.chi2ndof >> track.timestamp;
-        track.event_id = event_id;
+    //  Merge the track groups and the trackless IDs into the CSR index.
+    event_ids.reserve(trackless.size() + parsed.size());
+    event_offsets.reserve(trackless.size() + parsed.size() + 1);
+    std::size_t i_track = 0, i_empty = 0;
+    while (i_track < parsed.size() || i_empty < trackless.size())
+    {
+        const bool take_track = i_track < parsed.size() &&
+                                (i_empty == trackless.size() || parsed[i_track].event_id <= trackless[i_empty]);
+        const uint32_t id = take_track ? parsed[i_track].event_id : trackless[i_empty];
+        if (i_empty < trackless.size() && trackless[i_empty] == id)
+            ++i_empty;
+        while (i_track < parsed.size() && parsed[i_track].event_id == id)
+            ++i_track;
+        event_ids.push_back(id);
+        event_offsets.push_back(static_cast<uint32_t>(i_track));
+    }
+    tracks = std::move(parsed);
+    return true;
+}
+
+//  Layout: magic[8] | version u32 | sizeof(TrackingAltaiStruct) u32 |
+//  source size u64 | source mtime i64 | n_events u64 | n_tracks u64 |
+//  event_ids u32[n_events] | event_offsets u32[n_events + 1] |
+//  tracks TrackingAltaiStruct[n_tracks]   (native byte order).
+bool TrackingAltai::load_cache(const std::string &path, uint64_t source_size, int64_t source_mtime)
+{
+    std::error_code ec;
+    const uint64_t cache_size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return false;
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    char magic[sizeof(kCacheMagic)];
+    uint32_t version = 0, struct_size = 0;
+    uint64_t file_source_size = 0, n_events = 0, n_tracks = 0;
+    int64_t file_source_mtime = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&struct_size), sizeof(struct_size));
+    in.read(reinterpret_cast<char *>(&file_source_size), sizeof(file_source_size));
+    in.read(reinterpret_cast<char *>(&file_source_mtime), sizeof(file_source_mtime));
+    in.read(reinterpret_cast<char *>(&n_events), sizeof(n_events));
+    in.read(reinterpret_cast<char *>(&n_tracks), sizeof(n_tracks));
+    if (!in || std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0 ||
+        version != kCacheFormatVersion || struct_size != sizeof(TrackingAltaiStruct) ||
+        file_source_size != source_size || file_source_mtime != source_mtime)
+        return false;
+    //  The counts must describe this file exactly before anything is
+    //  allocated from them: a truncated or corrupt cache is rebuilt, not
+    //  trusted for a multi-GB allocation.  Each count is bounded by the
+    //  file size first, so the sum below cannot overflow.
+    constexpr uint64_t header_size = sizeof(kCacheMagic) + 2 * sizeof(uint32_t) + 4 * sizeof(uint64_t);
+    if (n_events > cache_size || n_tracks > cache_size ||
+        cache_size != header_size + (2 * n_events + 1) * sizeof(uint32_t) + n_tracks * sizeof(TrackingAltaiStruct))
+        return false;
+
+    std::vector<uint32_t> ids(n_events), offsets(n_events + 1);
+    std::vector<TrackingAltaiStruct> loaded(n_tracks);
+    in.read(reinterpret_cast<char *>(ids.data()), static_cast<std::streamsize>(n_events * sizeof(uint32_t)));
+    in.read(reinterpret_cast<char *>(offsets.data()), static_cast<std::streamsize>((n_events + 1) * sizeof(uint32_t)));
+    in.read(reinterpret_cast<char *>(loaded.data()), static_cast<std::streamsize>(n_tracks * sizeof(TrackingAltaiStruct)));
+    if (!in || offsets.front() != 0 || offsets.back() != n_tracks ||
+        !std::is_sorted(offsets.begin(), offsets.end()))
+        return false;
+    event_ids = std::move(ids);
+    event_offsets = std::move(offsets);
+    tracks = std::move(loaded);
+    return true;
+}
+
+bool TrackingAltai::store_cache(const std::string &path, uint64_t source_size, int64_t source_mtime) const
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    //  Unique temporary + rename: a concurrent reader never sees a
+    //  partial file.
+    const std::string tmp = path + ".tmp." + std::to_string(std::random_device{}());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        const uint32_t version = kCacheFormatVersion;
+        const uint32_t struct_size = sizeof(TrackingAltaiStruct);
+        const uint64_t n_events = event_ids.size(), n_tracks = tracks.size();
+        out.write(kCacheMagic, sizeof(kCacheMagic));
+        out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char *>(&struct_size), sizeof(struct_size));
+        out.write(reinterpret_cast<const char *>(&source_size), sizeof(source_size));
+        out.write(reinterpret_cast<const char *>(&source_mtime), sizeof(source_mtime));
+        out.write(reinterpret_cast<const char *>(&n_events), sizeof(n_events));
+        out.write(reinterpret_cast<const char *>(&n_tracks), sizeof(n_tracks));
+        out.write(reinterpret_cast<const char *>(event_ids.data()), static_cast<std::streamsize>(n_events * sizeof(uint32_t)));
+        out.write(reinterpret_cast<const char *>(event_offsets.data()), static_cast<std::streamsize>((n_events + 1) * sizeof(uint32_t)));
+        out.write(reinterpret_cast<const char *>(tracks.data()), static_cast<std::streamsize>(n_tracks * sizeof(TrackingAltaiStruct)));
+        if (!out)
+        {
+            out.close();
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec)
+    {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+void TrackingAltai::load_tracking_file(const std::string &input_file, bool use_cache)
+{
+    namespace fs = std::filesystem;
+    mist::logger::info(TString::Format("(TrackingAltai::load_tracking_file) Loading tracking file").Data());
+    event_ids.clear();
+    event_offsets.assign(1, 0);
+    tracks.clear();
+
+    std::error_code ec;
+    const uint64_t source_size = fs::file_size(input_file, ec);
+    if (ec)
+    {
+        mist::logger::warning(TString::Format("Cannot open input file : %s", input_file.c_str()).Data());
+        return;
     }
+    const int64_t source_mtime = static_cast<int64_t>(
+        fs::last_write_time(input_file, ec).time_since_epoch().count());
 
-    mist::logger::info(TString::Format("(TrackingAltai::load_tracking_file) Done! Found %zu track events", data_map.size()).Data());
-    infile.close();
+    const std::string cache = cache_path(input_file);
+    if (use_cache && !ec && load_cache(cache, source_size, source_mtime))
+    {
+        mist::logger::info(TString::Format("(TrackingAltai::load_tracking_file) Done! Found %zu track events (cache %s)",
+                                           event_ids.size(), cache.c_str())
+                               .Data());
+        return;
+    }
+    if (!parse_text(input_file))
+    {
+        mist::logger::warning(TString::Format("Cannot open input file : %s", input_file.c_str()).Data());
+        return;
+    }
+    if (use_cache && !ec && !store_cache(cache, source_size, source_mtime))
+        mist::logger::warning(TString::Format("(TrackingAltai::load_tracking_file) Could not write track cache %s",
+                                              cache.c_str())
+                                  .Data());
+    mist::logger::info(TString::Format("(TrackingAltai::load_tracking_file) Done! Found %zu track events", event_ids.size()).Data());
 }
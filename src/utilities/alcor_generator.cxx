@@ -0,0 +1,432 @@
+/**
+ * @file utilities/alcor_generator.cxx
+ * @brief Implementation of the synthetic ALCOR raw-data generator.
+ *
+ * Model and output contract — see the header.  The run is produced one
+ * spill at a time:
+ *
+ *   1. Avalanches (channel, time in cc) are drawn for the whole readout:
+ *      dark counts channel by channel, then the ring events; cross-talk
+ *      and afterpulses are attached to each avalanche as it is drawn.
+ *   2. They are split by stream, digitised into words (TDC choice, ToT
+ *      edges, fine bin) and sorted by coarse time.
+ *   3. Each stream appends its spill — start marker, words, end marker —
+ *      to its `alcor` tree; the trigger stream gets the trigger words.
+ *
+ * All output files stay open for the whole run (one per FIFO, ~260 for
+ * the full detector) and are written once at the end together with
+ * their `gRollover` graphs.
+ */
+
+#include "utilities/alcor_generator.h"
+
+#include "alcor_data.h"
+#include "mapping.h"
+#include "utility/root_io.h"
+
+#include <TFile.h>
+#include <TGraph.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace btana::utilities
+{
+
+namespace
+{
+
+constexpr uint64_t kRolloverCc = BTANA_ALCOR_ROLLOVER_TO_CC;
+constexpr double kCcToSeconds = BTANA_ALCOR_CC_TO_NS * 1e-9;
+
+//  Generator-seed domains, so the spill / channel / stream seeds never collide.
+enum SeedDomain : uint64_t
+{
+    SeedRings = 1,
+    SeedDarkCounts = 2,
+    SeedDigitisation = 3,
+    SeedRolloverLag = 4,
+};
+
+/// splitmix64 finaliser — decorrelates the structured seed inputs.
+uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+uint64_t derive_seed(uint64_t seed, SeedDomain domain, uint64_t spill, uint64_t key = 0)
+{
+    return mix(mix(mix(seed ^ (domain << 56)) ^ spill) ^ key);
+}
+
+struct SimChannel
+{
+    uint32_t stream; ///< Index into the stream list.
+    int column;
+    int pixel;
+    float x = -999.f, y = -999.f;
+    bool mapped = false;
+    std::vector<uint32_t> neighbours{}; ///< Physical-CT candidates.
+};
+
+struct Avalanche
+{
+    double t; ///< cc since the start of the spill
+    uint32_t channel;
+};
+
+struct Word
+{
+    uint64_t cc;
+    int column, pixel, tdc, fine;
+};
+
+struct Stream
+{
+    int device;
+    int fifo;
+    std::filesystem::path path{};
+    TFilePtr file{};
+    TTree *tree = nullptr;
+    std::unique_ptr<AlcorData> word{}; ///< Branch buffer; heap-held so its address is stable.
+    int counter = 0;
+    std::vector<double> rollover_per_spill{};
+};
+
+/// Channels of every configured FIFO, with positions and CT neighbours,
+/// plus a coarse grid over the mapped ones for the photon → pixel lookup.
+class Readout
+{
+public:
+    Readout(const GeneratorConfig &cfg, const Mapping &mapping, std::vector<Stream> &streams)
+        : half_pixel(cfg.pixel_size_mm / 2.f), cell(std::max(cfg.pixel_size_mm, 1.f))
+    {
+        for (int device : cfg.devices)
+            for (int fifo = 0; fifo < cfg.fifos_per_device; ++fifo)
+            {
+                const auto stream = static_cast<uint32_t>(streams.size());
+                streams.push_back({device, fifo});
+                //  A FIFO reads two columns × four pixels of chip fifo / 4.
+                const int chip = fifo / 4;
+                for (int column = 2 * (fifo % 4); column < 2 * (fifo % 4) + 2; ++column)
+                    for (int pixel = 0; pixel < 4; ++pixel)
+                    {
+                        SimChannel channel{stream, column, pixel};
+                        const int eo_channel = pixel + 4 * column + 32 * (chip % 2);
+                        if (auto position = mapping.get_position_from_device_chip_eoch(device, chip, eo_channel))
+                        {
+                            channel.x = (*position)[0];
+                            channel.y = (*position)[1];
+                            channel.mapped = true;
+                            grid[cell_key(channel.x, channel.y)].push_back(static_cast<uint32_t>(channels.size()));
+                        }
+                        channels.push_back(std::move(channel));
+                    }
+            }
+
+        for (uint32_t a = 0; a < channels.size(); ++a)
+            for (uint32_t b = 0; b < channels.size(); ++b)
+                if (a != b && channels[a].mapped && channels[b].mapped &&
+                    std::hypot(channels[a].x - channels[b].x, channels[a].y - channels[b].y) <= cfg.ct_radius_mm)
+                    channels[a].neighbours.push_back(b);
+    }
+
+    /// @return The channel whose pixel contains (@p x, @p y), or −1.
+    int64_t channel_at(float x, float y) const
+    {
+        const int64_t ix = static_cast<int64_t>(std::floor(x / cell));
+        const int64_t iy = static_cast<int64_t>(std::floor(y / cell));
+        for (int64_t dx = -1; dx <= 1; ++dx)
+            for (int64_t dy = -1; dy <= 1; ++dy)
+            {
+                auto it = grid.find(key(ix + dx, iy + dy));
+                if (it == grid.end())
+                    continue;
+                for (uint32_t c : it->second)
+                    if (std::fabs(channels[c].x - x) <= half_pixel && std::fabs(channels[c].y - y) <= half_pixel)
+                        return c;
+            }
+        return -1;
+    }
+
+    std::vector<SimChannel> channels;
+
+private:
+    static int64_t key(int64_t ix, int64_t iy) { return (ix << 32) ^ (iy & 0xffffffffll); }
+    int64_t cell_key(float x, float y) const
+    {
+        return key(static_cast<int64_t>(std::floor(x / cell)), static_cast<int64_t>(std::floor(y / cell)));
+    }
+
+    float half_pixel;
+    float cell;
+    std::unordered_map<int64_t, std::vector<uint32_t>> grid;
+};
+
+bool valid_probability(double p) { return p >= 0. && p <= 1.; }
+
+/// @return An empty string if @p cfg is usable, the reason otherwise.
+std::string check_config(const GeneratorConfig &cfg)
+{
+    if (cfg.output_repository.empty() || cfg.run_name.empty())
+        return "output repository and run name are required";
+    if (cfg.devices.empty() && cfg.trigger_device < 0)
+        return "no device to generate";
+    if (cfg.fifos_per_device < 1 || cfg.fifos_per_device > 32)
+        return "fifos_per_device must be in [1, 32]";
+    if (cfg.n_spills < 1 || cfg.spill_rollovers < 1 || cfg.frame_size < 1 || cfg.beam_delay_frames < 0)
+        return "spill structure must be positive";
+    if (!valid_probability(cfg.afterpulse_probability) || !valid_probability(cfg.cross_talk_probability) ||
+        !valid_probability(cfg.rollover_lag_probability))
+        return "probabilities must be in [0, 1]";
+    if (cfg.dcr_hz < 0. || cfg.ring.rate_hz < 0. || cfg.ring.photon_yield < 0.)
+        return "rates and photon yield must be non-negative";
+    //  fine == 0 is the ToT-saturation sentinel.
+    if (cfg.fine_lo < 1 || cfg.fine_hi < cfg.fine_lo)
+        return "fine range must satisfy 1 <= fine_lo <= fine_hi";
+    if (cfg.afterpulse_tau_cc <= 0. || cfg.tot_mean_cc <= 0. || cfg.tot_sigma_cc < 0.)
+        return "afterpulse and ToT time constants must be positive";
+    return {};
+}
+
+bool open_stream(Stream &stream, const std::filesystem::path &run_dir, const char *board)
+{
+    char file_name[32];
+    std::snprintf(file_name, sizeof(file_name), "alcdaq.fifo_%02d.root", stream.fifo);
+    const auto dir = run_dir / (std::string(board) + "-" + std::to_string(stream.device)) / "decoded";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    stream.path = dir / file_name;
+    stream.file.reset(TFile::Open(stream.path.c_str(), "RECREATE"));
+    if (!stream.file || stream.file->IsZombie())
+        return false;
+    stream.tree = new TTree("alcor", "alcor");
+    stream.word = std::make_unique<AlcorData>(AlcorDataStruct{});
+    stream.word->write_to_tree(stream.tree);
+    return true;
+}
+
+void fill_word(Stream &stream, int type, const Word &w)
+{
+    auto &word = *stream.word;
+    word.set_device(stream.device);
+    word.set_fifo(stream.fifo);
+    word.set_type(type);
+    word.set_counter(stream.counter++);
+    word.set_column(w.column);
+    word.set_pixel(w.pixel);
+    word.set_tdc(w.tdc);
+    word.set_rollover(static_cast<int>(w.cc / kRolloverCc));
+    word.set_coarse(static_cast<int>(w.cc % kRolloverCc));
+    word.set_fine(w.fine);
+    word.set_mask(0u);
+    stream.tree->Fill();
+}
+
+/// Append one spill of @p words (sorted) to @p stream between the spill markers.
+void write_spill(Stream &stream, int type, const std::vector<Word> &words, uint64_t spill_cc, bool lagging)
+{
+    const uint64_t shift = lagging ? kRolloverCc : 0;
+    fill_word(stream, start_spill, {0, 0, 0, 0, 0});
+    for (const auto &w : words)
+    {
+        if (w.cc < shift)
+            continue;
+        Word shifted = w;
+        shifted.cc -= shift;
+        fill_word(stream, type, shifted);
+    }
+    fill_word(stream, end_spill, {spill_cc - shift, 0, 0, 0, 0});
+    stream.rollover_per_spill.push_back(static_cast<double>((spill_cc - shift) / kRolloverCc));
+}
+
+} // namespace
+
+int generate_alcor_run(const GeneratorConfig &cfg, GeneratorSummary *summary)
+{
+    if (const auto reason = check_config(cfg); !reason.empty())
+    {
+        std::cerr << "alcor_generator: " << reason << "\n";
+        return 2;
+    }
+    if (!std::filesystem::exists(cfg.mapping_config_file))
+    {
+        std::cerr << "alcor_generator: mapping configuration " << cfg.mapping_config_file << " not found\n";
+        return 2;
+    }
+
+    Mapping mapping(cfg.mapping_config_file);
+    std::vector<Stream> streams;
+    Readout readout(cfg, mapping, streams);
+    const std::size_t n_data_streams = streams.size();
+    if (cfg.trigger_device >= 0)
+        streams.push_back({cfg.trigger_device, cfg.trigger_fifo});
+
+    const std::filesystem::path run_dir = std::filesystem::path(cfg.output_repository) / cfg.run_name;
+    for (std::size_t i = 0; i < streams.size(); ++i)
+        if (!open_stream(streams[i], run_dir, i < n_data_streams ? "rdo" : "kc705"))
+        {
+            std::cerr << "alcor_generator: cannot create " << streams[i].path << "\n";
+            return 1;
+        }
+
+    GeneratorSummary totals;
+    totals.streams = streams.size();
+    const uint64_t spill_cc = static_cast<uint64_t>(cfg.spill_rollovers) * kRolloverCc;
+    const double beam_start_cc = std::min<double>(static_cast<double>(cfg.beam_delay_frames) * cfg.frame_size,
+                                                  static_cast<double>(spill_cc));
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    std::exponential_distribution<double> afterpulse_delay(1. / cfg.afterpulse_tau_cc);
+    std::normal_distribution<double> tot_width(cfg.tot_mean_cc, cfg.tot_sigma_cc);
+    std::uniform_int_distribution<int> fine_bin(cfg.fine_lo, cfg.fine_hi);
+
+    std::vector<std::vector<Avalanche>> per_stream(n_data_streams);
+    std::vector<Word> trigger_words;
+    std::vector<Word> words;
+    //  Next TDC (LET) or TDC pair (ToT) of each channel; carried across spills.
+    std::vector<uint8_t> tdc_cycle(readout.channels.size(), 0);
+
+    for (int spill = 0; spill < cfg.n_spills; ++spill)
+    {
+        for (auto &avalanches : per_stream)
+            avalanches.clear();
+        trigger_words.clear();
+
+        //  An avalanche on @p channel at @p t, its cross-talk (primaries only)
+        //  and their afterpulses, drawn from @p rng.
+        auto fire = [&](uint32_t channel, double t, std::mt19937_64 &rng, auto &self, bool primary) -> void
+        {
+            if (t >= static_cast<double>(spill_cc))
+                return;
+            per_stream[readout.channels[channel].stream].push_back({t, channel});
+            const auto &neighbours = readout.channels[channel].neighbours;
+            if (primary && !neighbours.empty() && uniform(rng) < cfg.cross_talk_probability)
+            {
+                const auto pick = std::min<std::size_t>(static_cast<std::size_t>(uniform(rng) * neighbours.size()),
+                                                        neighbours.size() - 1);
+                ++totals.cross_talk;
+                self(neighbours[pick], t + uniform(rng), rng, self, false);
+            }
+            if (uniform(rng) < cfg.afterpulse_probability)
+            {
+                const double t_afterpulse = t + 1. + afterpulse_delay(rng);
+                if (t_afterpulse < static_cast<double>(spill_cc))
+                {
+                    per_stream[readout.channels[channel].stream].push_back({t_afterpulse, channel});
+                    ++totals.afterpulses;
+                }
+            }
+        };
+
+        //  Dark counts, one generator per channel.
+        const double dark_mean = cfg.dcr_hz * static_cast<double>(spill_cc) * kCcToSeconds;
+        for (uint32_t channel = 0; channel < readout.channels.size(); ++channel)
+        {
+            const auto &stream = streams[readout.channels[channel].stream];
+            const uint64_t key = (static_cast<uint64_t>(stream.device) << 16) |
+                                 (static_cast<uint64_t>(stream.fifo) << 8) | (channel & 7u);
+            std::mt19937_64 rng(derive_seed(cfg.seed, SeedDarkCounts, spill, key));
+            const auto n_dark = std::poisson_distribution<uint64_t>(dark_mean)(rng);
+            for (uint64_t k = 0; k < n_dark; ++k)
+                fire(channel, uniform(rng) * static_cast<double>(spill_cc), rng, fire, true);
+            totals.dark_counts += n_dark;
+        }
+
+        //  Ring events after the beam-free start of the spill.
+        std::mt19937_64 ring_rng(derive_seed(cfg.seed, SeedRings, spill));
+        const double beam_cc = static_cast<double>(spill_cc) - beam_start_cc;
+        const auto n_rings = std::poisson_distribution<uint64_t>(cfg.ring.rate_hz * beam_cc * kCcToSeconds)(ring_rng);
+        std::poisson_distribution<int> n_photons(cfg.ring.photon_yield);
+        std::normal_distribution<double> photon_radius(cfg.ring.radius_mm, cfg.ring.radius_sigma_mm);
+        std::normal_distribution<double> photon_jitter(0., cfg.ring.time_sigma_cc);
+        for (uint64_t k = 0; k < n_rings; ++k)
+        {
+            const double t_ring = beam_start_cc + uniform(ring_rng) * beam_cc;
+            const auto trigger_cc = static_cast<uint64_t>(t_ring) + static_cast<uint64_t>(std::max(cfg.trigger_delay, 0));
+            if (cfg.trigger_device >= 0 && trigger_cc < spill_cc)
+                trigger_words.push_back({trigger_cc, 0, 0, 0, 0});
+            for (int n = n_photons(ring_rng); n > 0; --n)
+            {
+                const double phi = 2. * M_PI * uniform(ring_rng);
+                const double r = photon_radius(ring_rng);
+                const double t = std::max(0., t_ring + photon_jitter(ring_rng));
+                const auto channel = readout.channel_at(static_cast<float>(cfg.ring.cx_mm + r * std::cos(phi)),
+                                                        static_cast<float>(cfg.ring.cy_mm + r * std::sin(phi)));
+                if (channel < 0)
+                    continue;
+                ++totals.photons;
+                fire(static_cast<uint32_t>(channel), t, ring_rng, fire, true);
+            }
+        }
+        totals.rings += n_rings;
+
+        //  Digitise and write each data stream.
+        std::mt19937_64 lag_rng(derive_seed(cfg.seed, SeedRolloverLag, spill));
+        for (std::size_t i = 0; i < n_data_streams; ++i)
+        {
+            std::mt19937_64 rng(derive_seed(cfg.seed, SeedDigitisation, spill, i));
+            tot_width.reset();
+            auto &avalanches = per_stream[i];
+            std::sort(avalanches.begin(), avalanches.end(), [](const Avalanche &a, const Avalanche &b)
+                      { return a.t < b.t; });
+            words.clear();
+            for (const auto &avalanche : avalanches)
+            {
+                const auto &channel = readout.channels[avalanche.channel];
+                const auto cc = static_cast<uint64_t>(avalanche.t);
+                if (!cfg.tot_mode)
+                {
+                    words.push_back({cc, channel.column, channel.pixel, tdc_cycle[avalanche.channel]++ & 3, fine_bin(rng)});
+                    continue;
+                }
+                //  ToT: leading edge on the even TDC of the pair, trailing on the odd one.
+                const int tdc = 2 * (tdc_cycle[avalanche.channel]++ & 1);
+                const auto width = static_cast<uint64_t>(std::max(1., std::round(tot_width(rng))));
+                words.push_back({cc, channel.column, channel.pixel, tdc, fine_bin(rng)});
+                if (cc + width < spill_cc)
+                    words.push_back({cc + width, channel.column, channel.pixel, tdc + 1, fine_bin(rng)});
+            }
+            std::stable_sort(words.begin(), words.end(), [](const Word &a, const Word &b)
+                             { return a.cc < b.cc; });
+
+            const bool lagging = uniform(lag_rng) < cfg.rollover_lag_probability && spill_cc > kRolloverCc;
+            totals.lagging_spills += lagging;
+            write_spill(streams[i], alcor_hit, words, spill_cc, lagging);
+        }
+        if (cfg.trigger_device >= 0)
+        {
+            std::sort(trigger_words.begin(), trigger_words.end(), [](const Word &a, const Word &b)
+                      { return a.cc < b.cc; });
+            write_spill(streams.back(), trigger_tag, trigger_words, spill_cc, false);
+        }
+    }
+
+    for (auto &stream : streams)
+    {
+        stream.file->cd();
+        stream.tree->Write();
+        totals.words += static_cast<uint64_t>(stream.tree->GetEntries());
+        TGraph rollover_graph;
+        rollover_graph.SetName("gRollover");
+        for (std::size_t spill = 0; spill < stream.rollover_per_spill.size(); ++spill)
+            rollover_graph.AddPoint(static_cast<double>(spill), stream.rollover_per_spill[spill]);
+        rollover_graph.Write();
+        stream.file.reset();
+    }
+
+    if (summary)
+        *summary = totals;
+    return 0;
+}
+
+} // namespace btana::utilities
@@ -13,6 +13,18 @@
  * Output is stdout-only.  No framework state is mutated (calibration
  * table stays in whatever state the caller had it) — this is a
  * READ-ONLY decoder.
+ *
+ * `--stats` (bottom of the file) replaces step 4 by a whole-tree scan:
+ * the entries are cut into cluster-aligned ranges, one worker slot per
+ * `util::TaskPool` thread opens its own TFile and pulls ranges off a
+ * shared cursor, and the per-range partial sums are merged in entry
+ * order so spills cut by a range boundary come out whole.  The entry
+ * index behind `--spill` / `--frame` / `--trigger` is built by the same
+ * scan, reading only the frame-ID and trigger branches.
+ *
+ * Every lightdata path applies the `lightdata_triggers.root` friend file
+ * (`btana::lightdata::LightdataTriggerOverlay`) when one sits next to the
+ * input, so the dump shows the trigger stages `recodata_writer` will use.
  */
 
 #include "utilities/btana_dump.h"
@@ -22,6 +34,9 @@
 #include "alcor_recotrackdata.h"
 #include "alcor_spilldata.h"
 #include "triggers/events.h"
+#include "utility/global_index.h"
+#include "utility/task_pool.h"
+#include "writers/lightdata/trigger_overlay.h"
 
 #include <TDirectory.h>
 #include <TFile.h>
@@ -30,14 +45,27 @@
 #include <TList.h>
 #include <TNamed.h>
 #include <TParameter.h>
+#include <TROOT.h>
 #include <TTree.h>
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <tuple>
 
 namespace btana::utilities
 {
@@ -110,6 +138,50 @@ void print_trigger(const TriggerEvent &t, const std::string &indent = "    ")
               << "\n";
 }
 
+//  One lightdata frame: position @p k in its spill, frame ID, hit counts
+//  per category and the trigger list.
+void print_lightdata_frame(std::size_t k, uint32_t fid, const AlcorLightdataStruct &fr)
+{
+    std::cout << "  frame[" << k << "] id=" << fid
+              << "   trig=" << fr.trigger_hits.size()
+              << "   tim=" << fr.timing_hits.size()
+              << "   trk=" << fr.tracking_hits.size()
+              << "   chr=" << fr.cherenkov_hits.size() << "\n";
+    for (const auto &tr : fr.trigger_hits)
+        print_trigger(tr, "      ");
+}
+
+void print_recodata_frame(long i, const AlcorRecodata &recodata)
+{
+    const auto &trigs = recodata.get_triggers();
+    std::cout << "frame " << i
+              << "   hits=" << recodata.get_recodata().size()
+              << "   triggers=" << trigs.size() << "\n";
+    for (const auto &tr : trigs)
+        print_trigger(tr);
+}
+
+void print_recotrackdata_frame(long i, const AlcorRecotrackdata &rtd)
+{
+    const auto &trigs = rtd.get_triggers();
+    const auto ntracks = rtd.n_recotrackdata();
+    std::cout << "frame " << i
+              << "   hits=" << rtd.get_recodata().size()
+              << "   triggers=" << trigs.size()
+              << "   tracks=" << ntracks << "\n";
+    for (const auto &tr : trigs)
+        print_trigger(tr);
+    for (std::size_t k = 0; k < ntracks; ++k)
+    {
+        std::cout << "    track[" << k << "]"
+                  << "   x=" << std::fixed << std::setprecision(2) << rtd.get_det_plane_x(k)
+                  << "   y=" << rtd.get_det_plane_y(k)
+                  << "   r=" << rtd.get_det_plane_r(k)
+                  << "   χ²/ndf=" << std::setprecision(3) << rtd.get_chi2ndof(k)
+                  << "\n";
+    }
+}
+
 //  ── Metadata walker ──────────────────────────────────────────────
 //  Walk a TDirectory (recursively into sub-TDirectories) and print
 //  every TParameter / TNamed it encounters as `name = value`.
@@ -258,11 +330,15 @@ int dump_lightdata(const std::string &file_path, long n_entries)
 
     AlcorSpilldata spilldata;
     spilldata.link_to_tree(t);
+    const std::string overlay_path = btana::lightdata::trigger_overlay_path(file_path);
+    btana::lightdata::LightdataTriggerOverlay overlay(overlay_path);
 
     const long total = t->GetEntries();
     const long n = (n_entries < 0) ? total : std::min<long>(n_entries, total);
 
     std::cout << "\nlightdata: " << total << " spill(s); printing " << n << "\n";
+    if (overlay.is_open())
+        std::cout << "trigger overlay: " << overlay_path << "\n";
     std::cout << "──────────────────────────────────────────────────────────\n";
 
     for (long i = 0; i < n; ++i)
@@ -271,6 +347,7 @@ int dump_lightdata(const std::string &file_path, long n_entries)
         spilldata.get_entry();
         auto &frames = spilldata.get_frame_list_link();
         auto &frame_ref = spilldata.get_frame_reference_list_link();
+        overlay.apply(static_cast<int>(i), frame_ref, frames);
 
         //  Spill-level totals
         std::size_t n_trig = 0, n_tim = 0, n_trk = 0, n_chr = 0;
@@ -296,17 +373,7 @@ int dump_lightdata(const std::string &file_path, long n_entries)
         {
             const std::size_t n_show = std::min<std::size_t>(3, frames.size());
             for (std::size_t k = 0; k < n_show; ++k)
-            {
-                const auto &fr = frames[k];
-                const uint32_t fid = (k < frame_ref.size()) ? frame_ref[k] : 0;
-                std::cout << "  frame[" << k << "] id=" << fid
-                          << "   trig=" << fr.trigger_hits.size()
-                          << "   tim=" << fr.timing_hits.size()
-                          << "   trk=" << fr.tracking_hits.size()
-                          << "   chr=" << fr.cherenkov_hits.size() << "\n";
-                for (const auto &tr : fr.trigger_hits)
-                    print_trigger(tr, "      ");
-            }
+                print_lightdata_frame(k, (k < frame_ref.size()) ? frame_ref[k] : 0, frames[k]);
             if (frames.size() > n_show)
                 std::cout << "  … " << (frames.size() - n_show)
                           << " more frame(s) (suppressed)\n";
@@ -349,13 +416,7 @@ int dump_recodata(const std::string &file_path, long n_entries)
     for (long i = 0; i < n; ++i)
     {
         t->GetEntry(i);
-        const auto &hits = recodata.get_recodata();
-        const auto &trigs = recodata.get_triggers();
-        std::cout << "frame " << i
-                  << "   hits=" << hits.size()
-                  << "   triggers=" << trigs.size() << "\n";
-        for (const auto &tr : trigs)
-            print_trigger(tr);
+        print_recodata_frame(i, recodata);
     }
     return 0;
 }
@@ -389,24 +450,7 @@ int dump_recotrackdata(const std::string &file_path, long n_entries)
     for (long i = 0; i < n; ++i)
     {
         t->GetEntry(i);
-        const auto &hits = rtd.get_recodata();
-        const auto &trigs = rtd.get_triggers();
-        const auto ntracks = rtd.n_recotrackdata();
-        std::cout << "frame " << i
-                  << "   hits=" << hits.size()
-                  << "   triggers=" << trigs.size()
-                  << "   tracks=" << ntracks << "\n";
-        for (const auto &tr : trigs)
-            print_trigger(tr);
-        for (std::size_t k = 0; k < ntracks; ++k)
-        {
-            std::cout << "    track[" << k << "]"
-                      << "   x=" << std::fixed << std::setprecision(2) << rtd.get_det_plane_x(k)
-                      << "   y=" << rtd.get_det_plane_y(k)
-                      << "   r=" << rtd.get_det_plane_r(k)
-                      << "   χ²/ndf=" << std::setprecision(3) << rtd.get_chi2ndof(k)
-                      << "\n";
-        }
+        print_recotrackdata_frame(i, rtd);
     }
     return 0;
 }
@@ -452,4 +496,1135 @@ int dump_file(const std::string &file_path, long n_entries)
     }
 }
 
+// ─────────────────────────────────────────────────────────────────────
+//  --stats
+// ─────────────────────────────────────────────────────────────────────
+
+DumpSpillStats &DumpSpillStats::operator+=(const DumpSpillStats &o)
+{
+    frames += o.frames;
+    hits += o.hits;
+    triggers += o.triggers;
+    first_frame = std::min(first_frame, o.first_frame);
+    last_frame = std::max(last_frame, o.last_frame);
+    return *this;
+}
+
+namespace
+{
+
+//  TTree cache per reader; one cluster of a production file is a few MB.
+constexpr Long64_t kScanCacheBytes = 64LL << 20;
+//  Entry ranges per worker slot, for load balance.
+constexpr std::size_t kScanChunksPerSlot = 4;
+
+//  The partial sums of one entry range.  `continues_spill`: spills[0]
+//  holds the entries before the range's first start-of-spill marker,
+//  i.e. the tail of the spill the previous range ended in.
+struct StatsChunk
+{
+    Long64_t first = 0, last = 0; ///< [first, last)
+    DumpStats stats;
+    bool continues_spill = false;
+};
+
+//  Whole clusters, grouped into ~n_chunks [first, last) entry ranges of
+//  similar size, so no basket is decompressed by two readers.
+std::vector<std::pair<Long64_t, Long64_t>> plan_chunks(TTree *t, std::size_t n_chunks)
+{
+    const Long64_t total = t->GetEntries();
+    const Long64_t target = std::max<Long64_t>(1, total / static_cast<Long64_t>(std::max<std::size_t>(1, n_chunks)));
+    std::vector<std::pair<Long64_t, Long64_t>> chunks;
+    auto clusters = t->GetClusterIterator(0);
+    Long64_t start = 0;
+    Long64_t cluster_start;
+    while ((cluster_start = clusters()) < total)
+    {
+        const Long64_t cluster_end = std::min(clusters.GetNextEntry(), total);
+        if (cluster_end - start >= target || cluster_end == total)
+        {
+            chunks.emplace_back(start, cluster_end);
+            start = cluster_end;
+        }
+    }
+    if (start < total)
+        chunks.emplace_back(start, total);
+    return chunks;
+}
+
+//  Single-bit HitMask words, folded once rather than per hit.
+constexpr uint32_t kRing1Bit = 1u << HitmaskRingTagFirst;
+constexpr uint32_t kRing2Bit = 1u << HitmaskRingTagSecond;
+constexpr uint32_t kRansac1Bit = 1u << HitmaskRansacRingTagFirst;
+constexpr uint32_t kRansac2Bit = 1u << HitmaskRansacRingTagSecond;
+
+void count_hits(DumpStats &s, DumpSpillStats &spill,
+                const std::vector<AlcorFinedataStruct> &hits, uint32_t &ring_bits)
+{
+    for (const auto &hit : hits)
+    {
+        ++s.channel_hits[GlobalIndex(hit.GlobalIndex).global_channel_raw()];
+        for (uint32_t mask = hit.HitMask; mask != 0; mask &= mask - 1)
+            ++s.mask_bits[__builtin_ctz(mask)];
+        const uint32_t tags = hit.HitMask & (kRing1Bit | kRing2Bit | kRansac1Bit | kRansac2Bit);
+        ring_bits |= tags;
+        s.ring_tagged_hits += tags != 0;
+        s.rollover_min = std::min(s.rollover_min, hit.rollover);
+        s.rollover_max = std::max(s.rollover_max, hit.rollover);
+    }
+    s.hits += hits.size();
+    spill.hits += hits.size();
+}
+
+//  Rings seen in a frame, from the OR of its hits' tag bits.
+int n_rings(uint32_t ring_bits, uint32_t first, uint32_t second)
+{
+    return ((ring_bits & first) != 0) + ((ring_bits & second) != 0);
+}
+
+void count_triggers(DumpStats &s, DumpSpillStats &spill, const std::vector<TriggerEvent> &triggers)
+{
+    for (const auto &t : triggers)
+    {
+        ++s.trigger_counts[t.index];
+        if (t.is_secondary)
+            ++s.secondary_trigger_counts[t.index];
+    }
+    spill.triggers += triggers.size();
+}
+
+void count_frame_id(DumpStats &s, DumpSpillStats &spill, uint32_t frame_id)
+{
+    ++s.frames;
+    ++spill.frames;
+    if (frame_id == AlcorRecodata::kNoFrame)
+        return;
+    spill.first_frame = std::min(spill.first_frame, frame_id);
+    spill.last_frame = std::max(spill.last_frame, frame_id);
+    s.frame_min = std::min(s.frame_min, frame_id);
+    s.frame_max = std::max(s.frame_max, frame_id);
+}
+
+//  Start-of-spill marker entry of a recodata / recotrackdata tree.
+bool is_spill_marker(const std::vector<TriggerEvent> &triggers)
+{
+    return std::any_of(triggers.begin(), triggers.end(), [](const TriggerEvent &tr)
+                       { return tr.index == TriggerStartOfSpill; });
+}
+
+//  Per-slot readers: each links its buffers to the slot's tree once and
+//  enables only the branches it reads, then scans the ranges it is given.
+
+//  The trigger-overlay friend of the file @p t was read from (one per slot:
+//  the overlay owns a TFile).
+std::unique_ptr<btana::lightdata::LightdataTriggerOverlay> open_overlay(TTree *t)
+{
+    return std::make_unique<btana::lightdata::LightdataTriggerOverlay>(
+        btana::lightdata::trigger_overlay_path(t->GetCurrentFile()->GetName()));
+}
+
+//  lightdata: one entry is one spill; `frame` and `lightdata` are read.
+struct StatsLightdataReader
+{
+    std::unique_ptr<AlcorSpilldata> spilldata = std::make_unique<AlcorSpilldata>();
+    std::unique_ptr<btana::lightdata::LightdataTriggerOverlay> overlay;
+
+    explicit StatsLightdataReader(TTree *t) : overlay(open_overlay(t))
+    {
+        spilldata->link_to_tree(t);
+        t->SetBranchStatus("*", false);
+        t->SetBranchStatus("frame*", true);
+        t->SetBranchStatus("lightdata*", true);
+    }
+
+    void operator()(TTree *t, StatsChunk &chunk)
+    {
+        auto &frames = spilldata->get_frame_list_link();
+        auto &frame_ref = spilldata->get_frame_reference_list_link();
+        DumpStats &s = chunk.stats;
+        for (Long64_t i = chunk.first; i < chunk.last; ++i)
+        {
+            t->GetEntry(i);
+            overlay->apply(static_cast<int>(i), frame_ref, frames);
+            ++s.entries;
+            auto &spill = s.spills.emplace_back();
+            for (std::size_t k = 0; k < frames.size(); ++k)
+            {
+                const auto &fr = frames[k];
+                count_frame_id(s, spill, k < frame_ref.size() ? frame_ref[k] : AlcorRecodata::kNoFrame);
+                count_triggers(s, spill, fr.trigger_hits);
+                uint32_t ring_bits = 0;
+                count_hits(s, spill, fr.timing_hits, ring_bits);
+                count_hits(s, spill, fr.tracking_hits, ring_bits);
+                count_hits(s, spill, fr.cherenkov_hits, ring_bits);
+                s.category_hits[0] += fr.timing_hits.size();
+                s.category_hits[1] += fr.tracking_hits.size();
+                s.category_hits[2] += fr.cherenkov_hits.size();
+                //  The streaming ring finder records its rings as scalars.
+                ++s.ring_multiplicity[(fr.ring1_radius > 0.f) + (fr.ring2_radius > 0.f)];
+                ++s.ransac_ring_multiplicity[n_rings(ring_bits, kRansac1Bit, kRansac2Bit)];
+            }
+        }
+    }
+};
+
+//  recodata and recotrackdata: one entry per frame, spills delimited by
+//  the start-of-spill marker entry.  The ALTAI track branch is not read.
+struct StatsRecodataReader
+{
+    std::unique_ptr<AlcorRecodata> recodata = std::make_unique<AlcorRecodata>();
+
+    explicit StatsRecodataReader(TTree *t)
+    {
+        recodata->link_to_tree(t);
+        t->SetBranchStatus("*", false);
+        for (const char *branch : {"recodata*", "triggers*", "frame*"})
+            t->SetBranchStatus(branch, true);
+    }
+
+    void operator()(TTree *t, StatsChunk &chunk)
+    {
+        const auto &hits = recodata->get_recodata();
+        const auto &triggers = recodata->get_triggers();
+        DumpStats &s = chunk.stats;
+        chunk.continues_spill = true;
+        s.spills.emplace_back();
+        for (Long64_t i = chunk.first; i < chunk.last; ++i)
+        {
+            t->GetEntry(i);
+            ++s.entries;
+            if (is_spill_marker(triggers))
+            {
+                //  Its hits are the synthetic dead-lane participant list.
+                count_triggers(s, s.spills.emplace_back(), triggers);
+                continue;
+            }
+            auto &spill = s.spills.back();
+            count_frame_id(s, spill, recodata->get_frame_id());
+            count_triggers(s, spill, triggers);
+            uint32_t ring_bits = 0;
+            count_hits(s, spill, hits, ring_bits);
+            ++s.ring_multiplicity[n_rings(ring_bits, kRing1Bit, kRing2Bit)];
+            ++s.ransac_ring_multiplicity[n_rings(ring_bits, kRansac1Bit, kRansac2Bit)];
+        }
+    }
+};
+
+const char *tree_name_of(DumpFormat format)
+{
+    switch (format)
+    {
+    case DumpFormat::Lightdata:
+        return "lightdata";
+    case DumpFormat::Recodata:
+        return "recodata";
+    case DumpFormat::Recotrackdata:
+        return "recotrackdata";
+    default:
+        return nullptr;
+    }
+}
+
+//  Cut the @p format tree of @p file_path into ranges for @ref scan_chunks.
+//  False if the file has no such tree.
+bool plan_file_chunks(const std::string &file_path, DumpFormat format,
+                      std::vector<std::pair<Long64_t, Long64_t>> &ranges)
+{
+    const char *tree_name = tree_name_of(format);
+    if (!tree_name)
+        return false;
+    std::unique_ptr<TFile> f(TFile::Open(file_path.c_str(), "READ"));
+    auto *t = (f && !f->IsZombie()) ? f->Get<TTree>(tree_name) : nullptr;
+    if (!t)
+        return false;
+    ranges = plan_chunks(t, util::TaskPool::instance().concurrency() * kScanChunksPerSlot);
+    return true;
+}
+
+//  Scan every chunk (`.first` / `.last` entry range) on the task pool.
+//  One slot per thread opens its own TFile, builds one `Reader(tree)`
+//  and feeds it the chunks it pulls off a shared cursor, each with the
+//  TTree cache bounded to the chunk.  @p bytes_read accumulates what the
+//  slots read from disk.  False if a slot cannot open the tree.
+template <class Reader, class Chunk>
+bool scan_chunks(const std::string &file_path, DumpFormat format,
+                 std::vector<Chunk> &chunks, uint64_t &bytes_read)
+{
+    //  Each slot owns its TFile / TTree; ROOT's globals need the lock.
+    ROOT::EnableThreadSafety();
+
+    const char *tree_name = tree_name_of(format);
+    const std::size_t n_slots = std::min(util::TaskPool::instance().concurrency(), chunks.size());
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::vector<uint64_t> slot_bytes(n_slots, 0);
+    {
+        util::TaskGroup group;
+        for (std::size_t slot = 0; slot < n_slots; ++slot)
+            group.run([&, slot]
+                      {
+                          std::unique_ptr<TFile> f(TFile::Open(file_path.c_str(), "READ"));
+                          auto *t = (f && !f->IsZombie()) ? f->Get<TTree>(tree_name) : nullptr;
+                          if (!t)
+                          {
+                              failed = true;
+                              return;
+                          }
+                          t->SetCacheSize(kScanCacheBytes);
+                          Reader read(t);
+                          for (std::size_t c; (c = next.fetch_add(1)) < chunks.size();)
+                          {
+                              t->SetCacheEntryRange(chunks[c].first, chunks[c].last);
+                              read(t, chunks[c]);
+                          }
+                          slot_bytes[slot] = static_cast<uint64_t>(f->GetBytesRead());
+                      });
+        group.wait();
+    }
+    for (const auto bytes : slot_bytes)
+        bytes_read += bytes;
+    return !failed;
+}
+
+//  Fold @p part (the next range in entry order) into @p total.
+void merge_chunk(DumpStats &total, StatsChunk &part)
+{
+    const DumpStats &p = part.stats;
+    total.entries += p.entries;
+    total.frames += p.frames;
+    total.hits += p.hits;
+    total.ring_tagged_hits += p.ring_tagged_hits;
+    for (std::size_t i = 0; i < total.category_hits.size(); ++i)
+        total.category_hits[i] += p.category_hits[i];
+    for (std::size_t i = 0; i < total.trigger_counts.size(); ++i)
+    {
+        total.trigger_counts[i] += p.trigger_counts[i];
+        total.secondary_trigger_counts[i] += p.secondary_trigger_counts[i];
+    }
+    for (std::size_t i = 0; i < total.mask_bits.size(); ++i)
+        total.mask_bits[i] += p.mask_bits[i];
+    for (std::size_t i = 0; i < total.ring_multiplicity.size(); ++i)
+    {
+        total.ring_multiplicity[i] += p.ring_multiplicity[i];
+        total.ransac_ring_multiplicity[i] += p.ransac_ring_multiplicity[i];
+    }
+    for (const auto &[channel, n] : p.channel_hits)
+        total.channel_hits[channel] += n;
+    total.frame_min = std::min(total.frame_min, p.frame_min);
+    total.frame_max = std::max(total.frame_max, p.frame_max);
+    total.rollover_min = std::min(total.rollover_min, p.rollover_min);
+    total.rollover_max = std::max(total.rollover_max, p.rollover_max);
+
+    auto first = part.stats.spills.begin();
+    if (part.continues_spill && first != part.stats.spills.end())
+    {
+        //  Frames ahead of the file's first marker form a spill of their own.
+        if (!total.spills.empty())
+            total.spills.back() += *first;
+        else if (first->frames > 0)
+            total.spills.push_back(*first);
+        ++first;
+    }
+    total.spills.insert(total.spills.end(), first, part.stats.spills.end());
+}
+
+template <class T>
+T median_of(std::vector<T> v)
+{
+    if (v.empty())
+        return T{};
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+
+const char *mask_bit_name(int bit)
+{
+    switch (bit)
+    {
+    case HitmaskStreamingRingTrigger:
+        return "StreamingRingTrigger";
+    case HitmaskRingTagFirst:
+        return "RingTagFirst";
+    case HitmaskRingTagSecond:
+        return "RingTagSecond";
+    case HitmaskRansacRingTagFirst:
+        return "RansacRingTagFirst";
+    case HitmaskRansacRingTagSecond:
+        return "RansacRingTagSecond";
+    case HitmaskSecondaryOrphan:
+        return "SecondaryOrphan";
+    case HitmaskLeadingOrphan:
+        return "LeadingOrphan";
+    case HitmaskTotSaturated:
+        return "TotSaturated";
+    case HitmaskAfterpulse:
+        return "Afterpulse";
+    case HitmaskAfterpulseNear:
+        return "AfterpulseNear";
+    case HitmaskAfterpulseFar:
+        return "AfterpulseFar";
+    case HitmaskCrossTalk:
+        return "CrossTalk";
+    case HitmaskPartLane:
+        return "PartLane";
+    case HitmaskDeadLane:
+        return "DeadLane";
+    default:
+        return "";
+    }
+}
+
+std::string channel_label(uint32_t raw)
+{
+    const GlobalIndex gi(raw);
+    std::ostringstream os;
+    os << gi.device() << "/" << gi.fifo() << "/" << gi.chip() << "/ch" << gi.channel();
+    return os.str();
+}
+
+} // namespace
+
+DumpStats collect_stats(const std::string &file_path, bool &ok)
+{
+    DumpStats total;
+    total.format = detect_format(file_path);
+    std::vector<std::pair<Long64_t, Long64_t>> ranges;
+    ok = plan_file_chunks(file_path, total.format, ranges);
+    if (!ok)
+        return total;
+
+    if (total.format == DumpFormat::Lightdata)
+    {
+        const auto overlay_path = btana::lightdata::trigger_overlay_path(file_path);
+        if (btana::lightdata::LightdataTriggerOverlay(overlay_path).is_open())
+            total.trigger_overlay = overlay_path;
+    }
+
+    std::vector<StatsChunk> chunks;
+    for (const auto &[first, last] : ranges)
+        chunks.push_back({first, last, {}, false});
+    ok = total.format == DumpFormat::Lightdata
+             ? scan_chunks<StatsLightdataReader>(file_path, total.format, chunks, total.bytes_read)
+             : scan_chunks<StatsRecodataReader>(file_path, total.format, chunks, total.bytes_read);
+    if (!ok)
+        return total;
+
+    for (auto &chunk : chunks)
+        merge_chunk(total, chunk);
+    return total;
+}
+
+void print_stats(const DumpStats &s)
+{
+    const bool light = s.format == DumpFormat::Lightdata;
+    const auto fraction = [](uint64_t n, uint64_t of)
+    { return of > 0 ? 100. * static_cast<double>(n) / static_cast<double>(of) : 0.; };
+
+    std::cout << "\n" << format_name(s.format) << ": " << s.entries << " entr"
+              << (s.entries == 1 ? "y" : "ies") << ", " << s.spills.size() << " spill(s), "
+              << s.frames << " frame(s), " << s.hits << " hit(s)\n";
+    if (!s.trigger_overlay.empty())
+        std::cout << "  trigger overlay: " << s.trigger_overlay << "\n";
+    if (light)
+        std::cout << "  timing=" << s.category_hits[0]
+                  << "   tracking=" << s.category_hits[1]
+                  << "   cherenkov=" << s.category_hits[2] << "\n";
+
+    // ── Spills ──────────────────────────────────────────────────────
+    std::cout << "\n=== spills ===\n";
+    std::vector<uint64_t> spill_frames, spill_hits;
+    for (std::size_t i = 0; i < s.spills.size(); ++i)
+    {
+        const auto &sp = s.spills[i];
+        spill_frames.push_back(sp.frames);
+        spill_hits.push_back(sp.hits);
+        std::cout << "  spill " << std::setw(5) << i
+                  << "   frames=" << std::setw(8) << sp.frames
+                  << "   hits=" << std::setw(10) << sp.hits
+                  << "   triggers=" << std::setw(8) << sp.triggers;
+        if (sp.first_frame != DumpSpillStats::kNoFrame)
+            std::cout << "   frame_id=[" << sp.first_frame << ", " << sp.last_frame << "]";
+        std::cout << (sp.frames == 0 ? "   [empty]" : "") << "\n";
+    }
+    if (!s.spills.empty())
+    {
+        const auto [fmin, fmax] = std::minmax_element(spill_frames.begin(), spill_frames.end());
+        const auto [hmin, hmax] = std::minmax_element(spill_hits.begin(), spill_hits.end());
+        std::cout << "  frames/spill  min=" << *fmin << "  median=" << median_of(spill_frames)
+                  << "  max=" << *fmax << "\n"
+                  << "  hits/spill    min=" << *hmin << "  median=" << median_of(spill_hits)
+                  << "  max=" << *hmax << "\n";
+    }
+
+    // ── Channels ────────────────────────────────────────────────────
+    std::cout << "\n=== channels ===\n";
+    std::vector<std::pair<uint64_t, uint32_t>> by_hits;
+    by_hits.reserve(s.channel_hits.size());
+    for (const auto &[channel, n] : s.channel_hits)
+        by_hits.emplace_back(n, channel);
+    std::sort(by_hits.begin(), by_hits.end(), std::greater<>());
+    std::cout << "  " << by_hits.size() << " channel(s) with hits";
+    if (!by_hits.empty())
+    {
+        std::vector<uint64_t> counts;
+        for (const auto &[n, channel] : by_hits)
+            counts.push_back(n);
+        std::cout << "   hits/channel  min=" << by_hits.back().first
+                  << "  median=" << median_of(counts)
+                  << "  max=" << by_hits.front().first;
+    }
+    std::cout << "\n";
+    const std::size_t n_list = std::min<std::size_t>(10, by_hits.size());
+    for (std::size_t k = 0; k < n_list; ++k)
+        std::cout << "  hottest  " << std::left << std::setw(18) << channel_label(by_hits[k].second)
+                  << std::right << std::setw(12) << by_hits[k].first << "\n";
+    for (std::size_t k = std::max(n_list, by_hits.size() - n_list); k < by_hits.size(); ++k)
+        std::cout << "  coldest  " << std::left << std::setw(18) << channel_label(by_hits[k].second)
+                  << std::right << std::setw(12) << by_hits[k].first << "\n";
+
+    // ── Triggers ────────────────────────────────────────────────────
+    std::cout << "\n=== triggers (per " << (light ? "spill-frame" : "frame") << ") ===\n";
+    for (std::size_t idx = 0; idx < s.trigger_counts.size(); ++idx)
+        if (s.trigger_counts[idx] > 0)
+            std::cout << "  " << std::left << std::setw(22) << trigger_label(static_cast<uint8_t>(idx))
+                      << std::right << std::setw(12) << s.trigger_counts[idx]
+                      << "   secondary=" << s.secondary_trigger_counts[idx] << "\n";
+
+    // ── Mask bits ───────────────────────────────────────────────────
+    std::cout << "\n=== hit mask bits ===\n";
+    for (int bit = 0; bit < 32; ++bit)
+        if (s.mask_bits[bit] > 0)
+            std::cout << "  bit " << std::setw(2) << bit << "  " << std::left << std::setw(22)
+                      << mask_bit_name(bit) << std::right << std::setw(12) << s.mask_bits[bit]
+                      << "   " << std::fixed << std::setprecision(3)
+                      << fraction(s.mask_bits[bit], s.hits) << " %\n";
+
+    // ── Rings ───────────────────────────────────────────────────────
+    std::cout << "\n=== ring multiplicity (frames) ===\n";
+    for (std::size_t n = 0; n < s.ring_multiplicity.size(); ++n)
+        std::cout << "  " << n << " ring(s)   streaming=" << std::setw(10) << s.ring_multiplicity[n]
+                  << "   ransac=" << std::setw(10) << s.ransac_ring_multiplicity[n] << "\n";
+    std::cout << "  ring-tagged hits " << s.ring_tagged_hits << " ("
+              << std::fixed << std::setprecision(2) << fraction(s.ring_tagged_hits, s.hits) << " %)\n";
+
+    // ── Time range ──────────────────────────────────────────────────
+    std::cout << "\n=== time range ===\n";
+    if (s.frame_min != DumpSpillStats::kNoFrame)
+        std::cout << "  frame_id   [" << s.frame_min << ", " << s.frame_max << "]\n";
+    if (s.hits > 0)
+        std::cout << "  rollover   [" << s.rollover_min << ", " << s.rollover_max << "]\n";
+}
+
+int stats_file(const std::string &file_path)
+{
+    const auto start = std::chrono::steady_clock::now();
+    bool ok = false;
+    const DumpStats stats = collect_stats(file_path, ok);
+    if (!ok)
+    {
+        std::cerr << "btana-dump: " << file_path
+                  << " — no lightdata / recodata / recotrackdata tree to scan\n";
+        return 2;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "file: " << file_path << "  format: " << format_name(stats.format)
+              << "  scanned in " << std::fixed << std::setprecision(2) << seconds << " s on "
+              << util::TaskPool::instance().concurrency() << " thread(s), "
+              << std::setprecision(1) << static_cast<double>(stats.bytes_read) / 1.e6 << " MB read ("
+              << (seconds > 0. ? static_cast<double>(stats.bytes_read) / 1.e6 / seconds : 0.)
+              << " MB/s)\n";
+    print_stats(stats);
+    return 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  Entry index (--spill / --frame / --trigger)
+// ─────────────────────────────────────────────────────────────────────
+
+namespace
+{
+
+//  The rows of one entry range.  Row spills index the chunk's `spills`
+//  and shared-trigger rows the chunk's `rows`; both are renumbered on
+//  merge.  Row masks are the frames' TriggerMask, the same in every
+//  chunk.  As in StatsChunk, spills[0] of a recodata chunk continues the
+//  previous range's spill.
+struct IndexChunk
+{
+    Long64_t first = 0, last = 0; ///< [first, last)
+    std::vector<DumpIndexRow> rows;
+    std::vector<DumpIndexSpill> spills; ///< Entry ranges only
+    std::vector<DumpIndex::SharedTrigger> shared_triggers;
+    bool continues_spill = false;
+
+    //  @p mask for the row about to be added; the triggers behind the
+    //  shared bit are listed on the side.
+    uint64_t row_mask(TriggerMask mask, const std::vector<TriggerEvent> &triggers)
+    {
+        if (mask & (TriggerMask{1} << kTriggerMaskShared))
+            for (const auto &tr : triggers)
+                if (!trigger_mask_is_exact(tr.index))
+                    shared_triggers.push_back({rows.size(), tr.index});
+        return mask;
+    }
+};
+
+//  lightdata: frame IDs and trigger vectors only.  A split frame list
+//  keeps the trigger vectors in a sub-branch of their own, so the hit
+//  vectors stay on disk; an unsplit one has to be read whole.  So does
+//  one with a trigger overlay, which checks each frame's Cherenkov hits
+//  against its friend entry (and may drop frames, shifting positions).
+struct IndexLightdataReader
+{
+    std::unique_ptr<AlcorSpilldata> spilldata = std::make_unique<AlcorSpilldata>();
+    std::unique_ptr<btana::lightdata::LightdataTriggerOverlay> overlay;
+
+    explicit IndexLightdataReader(TTree *t) : overlay(open_overlay(t))
+    {
+        spilldata->link_to_tree(t);
+        t->SetBranchStatus("*", false);
+        t->SetBranchStatus("frame*", true);
+        if (t->GetBranch("lightdata.trigger_hits") && !overlay->is_open())
+        {
+            t->SetBranchStatus("lightdata.trigger_hits*", true);
+            t->SetBranchStatus("lightdata.trigger_mask*", true);
+        }
+        else
+            t->SetBranchStatus("lightdata*", true);
+    }
+
+    void operator()(TTree *t, IndexChunk &chunk)
+    {
+        auto &frames = spilldata->get_frame_list_link();
+        auto &frame_ref = spilldata->get_frame_reference_list_link();
+        for (Long64_t i = chunk.first; i < chunk.last; ++i)
+        {
+            t->GetEntry(i);
+            overlay->apply(static_cast<int>(i), frame_ref, frames);
+            const auto spill = static_cast<uint32_t>(chunk.spills.size());
+            chunk.spills.push_back({i, i + 1, 0, 0});
+            for (std::size_t k = 0; k < frames.size(); ++k)
+                chunk.rows.push_back({i, static_cast<uint32_t>(k), spill,
+                                      k < frame_ref.size() ? frame_ref[k] : AlcorRecodata::kNoFrame,
+                                      chunk.row_mask(frames[k].get_trigger_mask(),
+                                                     frames[k].trigger_hits)});
+        }
+    }
+};
+
+//  recodata / recotrackdata: `triggers`, `trigger_mask` and `frame` only.
+struct IndexRecodataReader
+{
+    std::unique_ptr<AlcorRecodata> recodata = std::make_unique<AlcorRecodata>();
+
+    explicit IndexRecodataReader(TTree *t)
+    {
+        recodata->link_to_tree(t);
+        t->SetBranchStatus("*", false);
+        t->SetBranchStatus("triggers*", true);
+        t->SetBranchStatus("trigger_mask*", true);
+        t->SetBranchStatus("frame*", true);
+    }
+
+    void operator()(TTree *t, IndexChunk &chunk)
+    {
+        const auto &triggers = recodata->get_triggers();
+        chunk.continues_spill = true;
+        chunk.spills.push_back({chunk.first, chunk.first, 0, 0});
+        for (Long64_t i = chunk.first; i < chunk.last; ++i)
+        {
+            t->GetEntry(i);
+            if (is_spill_marker(triggers))
+            {
+                chunk.spills.push_back({i, i + 1, 0, 0});
+                continue;
+            }
+            chunk.spills.back().last_entry = i + 1;
+            chunk.rows.push_back({i, 0, static_cast<uint32_t>(chunk.spills.size() - 1),
+                                  recodata->get_frame_id(),
+                                  chunk.row_mask(recodata->get_trigger_mask(), triggers)});
+        }
+    }
+};
+
+//  Fold @p part (the next range in entry order) into @p index.
+void merge_index_chunk(DumpIndex &index, const IndexChunk &part)
+{
+    std::vector<uint32_t> spill_of(part.spills.size(), 0);
+    for (std::size_t k = 0; k < part.spills.size(); ++k)
+    {
+        if (k == 0 && part.continues_spill)
+        {
+            if (!index.spills.empty())
+            {
+                auto &back = index.spills.back();
+                back.last_entry = std::max(back.last_entry, part.spills[0].last_entry);
+                spill_of[0] = static_cast<uint32_t>(index.spills.size() - 1);
+                continue;
+            }
+            //  Frames ahead of the file's first marker form a spill of their own.
+            if (part.rows.empty() || part.rows.front().spill != 0)
+                continue;
+        }
+        spill_of[k] = static_cast<uint32_t>(index.spills.size());
+        index.spills.push_back(part.spills[k]);
+    }
+
+    const uint64_t row_offset = index.rows.size();
+    for (auto row : part.rows)
+    {
+        row.spill = spill_of[row.spill];
+        index.rows.push_back(row);
+    }
+    for (auto shared : part.shared_triggers)
+    {
+        shared.row += row_offset;
+        index.shared_triggers.push_back(shared);
+    }
+}
+
+//  ── Cache file ───────────────────────────────────────────────────
+//  Header (magic, version, format, the size and mtime of the indexed file
+//  and of its trigger-overlay friend, entry count), then the spills, the
+//  rows and the shared-bit triggers as little-endian fixed-width fields.
+//  Row masks use the fixed TriggerMask layout (version 3; version 2 held
+//  a per-file bit table).  Written to a sibling tmp file and renamed over.
+
+static_assert(std::endian::native == std::endian::little,
+              "index cache layout assumes a little-endian host");
+
+constexpr char kIndexMagic[8] = {'B', 'T', 'D', 'M', 'P', 'I', 'D', 'X'};
+constexpr uint32_t kIndexVersion = 3;
+constexpr std::size_t kSpillBytes = 4 * sizeof(int64_t);
+constexpr std::size_t kRowBytes = 2 * sizeof(int64_t) + 3 * sizeof(uint32_t);
+constexpr std::size_t kSharedBytes = sizeof(uint64_t) + sizeof(uint8_t);
+
+//  Size and mtime of the indexed file and of the trigger-overlay friend
+//  next to it (0 / 0 when absent), recorded in the cache header: writing,
+//  replacing or deleting the overlay changes the lightdata rows.  Stamped
+//  for every format — a recodata index merely rebuilds once more.
+struct FileStamp
+{
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t overlay_size = 0;
+    int64_t overlay_mtime = 0;
+
+    bool operator==(const FileStamp &) const = default;
+};
+
+bool size_and_mtime(const std::string &path, uint64_t &size, int64_t &mtime)
+{
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return false;
+    const auto time = std::filesystem::last_write_time(path, ec);
+    mtime = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    return !ec;
+}
+
+bool file_stamp(const std::string &path, FileStamp &stamp)
+{
+    if (!size_and_mtime(path, stamp.size, stamp.mtime))
+        return false;
+    if (!size_and_mtime(btana::lightdata::trigger_overlay_path(path), stamp.overlay_size, stamp.overlay_mtime))
+    {
+        stamp.overlay_size = 0;
+        stamp.overlay_mtime = 0;
+    }
+    return true;
+}
+
+template <class T>
+void put(std::string &out, const T &v)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &v, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+//  Bounds-checked sequential reader over the cache bytes.
+struct Cursor
+{
+    const std::string &bytes;
+    std::size_t pos = 0;
+
+    bool has(std::size_t n) const { return bytes.size() - pos >= n; }
+
+    template <class T>
+    T get()
+    {
+        T v;
+        std::memcpy(&v, bytes.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+};
+
+std::string encode_index(const DumpIndex &index, const FileStamp &stamp)
+{
+    std::string out(kIndexMagic, sizeof(kIndexMagic));
+    out.reserve(64 + index.spills.size() * kSpillBytes + index.rows.size() * kRowBytes +
+                index.shared_triggers.size() * kSharedBytes);
+    put(out, kIndexVersion);
+    put(out, static_cast<uint32_t>(index.format));
+    put(out, stamp.size);
+    put(out, stamp.mtime);
+    put(out, stamp.overlay_size);
+    put(out, stamp.overlay_mtime);
+    put(out, index.n_entries);
+    put(out, static_cast<uint64_t>(index.spills.size()));
+    for (const auto &sp : index.spills)
+    {
+        put(out, sp.first_entry);
+        put(out, sp.last_entry);
+        put(out, sp.first_row);
+        put(out, sp.last_row);
+    }
+    put(out, static_cast<uint64_t>(index.rows.size()));
+    for (const auto &row : index.rows)
+    {
+        put(out, row.entry);
+        put(out, row.triggers);
+        put(out, row.position);
+        put(out, row.spill);
+        put(out, row.frame_id);
+    }
+    put(out, static_cast<uint64_t>(index.shared_triggers.size()));
+    for (const auto &shared : index.shared_triggers)
+    {
+        put(out, shared.row);
+        put(out, shared.index);
+    }
+    return out;
+}
+
+//  The cached index, if @p bytes is one written for a file with @p stamp.
+std::optional<DumpIndex> decode_index(const std::string &bytes, const FileStamp &stamp)
+{
+    Cursor in{bytes};
+    constexpr std::size_t kHeaderBytes = sizeof(kIndexMagic) + 2 * sizeof(uint32_t) +
+                                         5 * sizeof(int64_t);
+    if (!in.has(kHeaderBytes) || std::memcmp(bytes.data(), kIndexMagic, sizeof(kIndexMagic)) != 0)
+        return std::nullopt;
+    in.pos = sizeof(kIndexMagic);
+    if (in.get<uint32_t>() != kIndexVersion)
+        return std::nullopt;
+    DumpIndex index;
+    index.format = static_cast<DumpFormat>(in.get<uint32_t>());
+    FileStamp cached;
+    cached.size = in.get<uint64_t>();
+    cached.mtime = in.get<int64_t>();
+    cached.overlay_size = in.get<uint64_t>();
+    cached.overlay_mtime = in.get<int64_t>();
+    if (!(cached == stamp))
+        return std::nullopt;
+    index.n_entries = in.get<int64_t>();
+
+    if (!in.has(sizeof(uint64_t)))
+        return std::nullopt;
+    const auto n_spills = in.get<uint64_t>();
+    if (n_spills > bytes.size() / kSpillBytes || !in.has(n_spills * kSpillBytes))
+        return std::nullopt;
+    index.spills.resize(n_spills);
+    for (auto &sp : index.spills)
+    {
+        sp.first_entry = in.get<int64_t>();
+        sp.last_entry = in.get<int64_t>();
+        sp.first_row = in.get<uint64_t>();
+        sp.last_row = in.get<uint64_t>();
+    }
+
+    if (!in.has(sizeof(uint64_t)))
+        return std::nullopt;
+    const auto n_rows = in.get<uint64_t>();
+    if (n_rows > bytes.size() / kRowBytes || !in.has(n_rows * kRowBytes))
+        return std::nullopt;
+    index.rows.resize(n_rows);
+    for (auto &row : index.rows)
+    {
+        row.entry = in.get<int64_t>();
+        row.triggers = in.get<uint64_t>();
+        row.position = in.get<uint32_t>();
+        row.spill = in.get<uint32_t>();
+        row.frame_id = in.get<uint32_t>();
+        if (row.spill >= n_spills)
+            return std::nullopt;
+    }
+    for (const auto &sp : index.spills)
+        if (sp.first_row > sp.last_row || sp.last_row > n_rows)
+            return std::nullopt;
+
+    if (!in.has(sizeof(uint64_t)))
+        return std::nullopt;
+    const auto n_shared = in.get<uint64_t>();
+    if (n_shared > bytes.size() / kSharedBytes || !in.has(n_shared * kSharedBytes))
+        return std::nullopt;
+    index.shared_triggers.resize(n_shared);
+    for (auto &shared : index.shared_triggers)
+    {
+        shared.row = in.get<uint64_t>();
+        shared.index = in.get<uint8_t>();
+        if (shared.row >= n_rows)
+            return std::nullopt;
+    }
+    return index;
+}
+
+std::optional<DumpIndex> read_index(const std::string &cache_path, const FileStamp &stamp)
+{
+    std::ifstream in(cache_path, std::ios::binary);
+    if (!in)
+        return std::nullopt;
+    const std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    return decode_index(bytes, stamp);
+}
+
+bool write_index(const std::string &cache_path, const DumpIndex &index, const FileStamp &stamp)
+{
+    const std::string tmp_path = cache_path + ".tmp." + std::to_string(::getpid());
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        const std::string bytes = encode_index(index, stamp);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out)
+        {
+            out.close();
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, cache_path, ec);
+    if (ec)
+        std::remove(tmp_path.c_str());
+    return !ec;
+}
+
+//  The rows of @p index matching @p sel, in entry order, at most @p limit.
+std::vector<const DumpIndexRow *> select_rows(const DumpIndex &index, const DumpSelection &sel,
+                                              std::size_t limit)
+{
+    std::vector<const DumpIndexRow *> selected;
+    uint64_t row_begin = 0, row_end = index.rows.size();
+    if (sel.spill)
+    {
+        if (*sel.spill >= index.spills.size())
+            return selected;
+        row_begin = index.spills[*sel.spill].first_row;
+        row_end = index.spills[*sel.spill].last_row;
+    }
+    //  Exactly-mapped triggers are one AND on the row mask; the others
+    //  are looked up among the rows listing them behind the shared bit.
+    TriggerMask exact_mask = 0;
+    std::vector<uint64_t> shared_rows;
+    for (const auto trigger : sel.triggers)
+        if (trigger_mask_is_exact(trigger))
+            exact_mask |= trigger_mask_bit(trigger);
+    for (const auto &shared : index.shared_triggers)
+        if (std::find(sel.triggers.begin(), sel.triggers.end(), shared.index) != sel.triggers.end())
+            shared_rows.push_back(shared.row);
+    if (!sel.triggers.empty() && exact_mask == 0 && shared_rows.empty())
+        return selected;
+
+    for (uint64_t r = row_begin; r < row_end && selected.size() < limit; ++r)
+    {
+        const auto &row = index.rows[r];
+        if (sel.frame_id && row.frame_id != *sel.frame_id)
+            continue;
+        if (!sel.triggers.empty() && (row.triggers & exact_mask) == 0 &&
+            !std::binary_search(shared_rows.begin(), shared_rows.end(), r))
+            continue;
+        selected.push_back(&row);
+    }
+    return selected;
+}
+
+} // namespace
+
+std::optional<DumpIndex> build_index(const std::string &file_path)
+{
+    DumpIndex index;
+    index.format = detect_format(file_path);
+    std::vector<std::pair<Long64_t, Long64_t>> ranges;
+    if (!plan_file_chunks(file_path, index.format, ranges))
+        return std::nullopt;
+
+    std::vector<IndexChunk> chunks(ranges.size());
+    for (std::size_t c = 0; c < ranges.size(); ++c)
+        std::tie(chunks[c].first, chunks[c].last) = ranges[c];
+    uint64_t bytes_read = 0;
+    const bool ok = index.format == DumpFormat::Lightdata
+                        ? scan_chunks<IndexLightdataReader>(file_path, index.format, chunks, bytes_read)
+                        : scan_chunks<IndexRecodataReader>(file_path, index.format, chunks, bytes_read);
+    if (!ok)
+        return std::nullopt;
+
+    for (const auto &chunk : chunks)
+    {
+        index.n_entries += chunk.last - chunk.first;
+        merge_index_chunk(index, chunk);
+    }
+    //  Rows are in entry order, so each spill's rows are contiguous.
+    uint64_t r = 0;
+    for (uint32_t k = 0; k < index.spills.size(); ++k)
+    {
+        index.spills[k].first_row = r;
+        while (r < index.rows.size() && index.rows[r].spill == k)
+            ++r;
+        index.spills[k].last_row = r;
+    }
+    return index;
+}
+
+std::string index_path(const std::string &file_path)
+{
+    return file_path + ".btidx";
+}
+
+std::optional<DumpIndex> load_or_build_index(const std::string &file_path)
+{
+    const std::string cache_path = index_path(file_path);
+    //  Stamped before the scan: a file rewritten meanwhile will not match.
+    FileStamp stamp;
+    const bool stamped = file_stamp(file_path, stamp);
+    if (stamped)
+        if (auto index = read_index(cache_path, stamp))
+            return index;
+
+    auto index = build_index(file_path);
+    if (index && stamped && !write_index(cache_path, *index, stamp))
+        std::cerr << "btana-dump: cannot write the index cache " << cache_path
+                  << "; it will be rebuilt next time\n";
+    return index;
+}
+
+bool parse_trigger(const std::string &text, uint8_t &index)
+{
+    for (int i = 0; i < n_default_triggers; ++i)
+        if (text == default_names[i])
+        {
+            index = static_cast<uint8_t>(all_default_triggers[i]);
+            return true;
+        }
+    //  Config-defined triggers (conf/trigger_conf.toml) go by number.
+    unsigned value = 0;
+    const char *end = text.data() + text.size();
+    const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (ec != std::errc{} || ptr != end || value > 255)
+        return false;
+    index = static_cast<uint8_t>(value);
+    return true;
+}
+
+int dump_selected(const std::string &file_path, const DumpSelection &sel, long n_frames)
+{
+    const auto fmt = detect_format(file_path);
+    const char *tree_name = tree_name_of(fmt);
+    if (!tree_name)
+    {
+        std::cerr << "btana-dump: " << file_path
+                  << " — --spill / --frame / --trigger need a lightdata / recodata / "
+                  << "recotrackdata tree\n";
+        return 2;
+    }
+    std::cout << "file: " << file_path << "  format: " << format_name(fmt) << "\n";
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto index = load_or_build_index(file_path);
+    if (!index)
+    {
+        std::cerr << "btana-dump: cannot index " << file_path << "\n";
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (sel.spill && *sel.spill >= index->spills.size())
+    {
+        std::cerr << "btana-dump: spill " << *sel.spill << " out of range ("
+                  << index->spills.size() << " spill(s))\n";
+        return 1;
+    }
+
+    const std::size_t limit = n_frames < 0 ? SIZE_MAX : static_cast<std::size_t>(n_frames);
+    const auto selected = select_rows(*index, sel, limit);
+
+    std::cout << "\nindex: " << index->n_entries << " entr" << (index->n_entries == 1 ? "y" : "ies")
+              << ", " << index->spills.size() << " spill(s), " << index->rows.size()
+              << " frame(s)   (" << std::fixed << std::setprecision(2) << seconds << " s)\n";
+    std::cout << "selected " << selected.size() << " frame(s)";
+    if (sel.spill)
+        std::cout << "   spill=" << *sel.spill;
+    if (sel.frame_id)
+        std::cout << "   frame_id=" << *sel.frame_id;
+    for (const auto trigger : sel.triggers)
+        std::cout << "   trigger=" << trigger_label(trigger);
+    std::cout << "\n──────────────────────────────────────────────────────────\n";
+    if (selected.empty())
+        return 0;
+
+    std::unique_ptr<TFile> f(TFile::Open(file_path.c_str(), "READ"));
+    auto *t = (f && !f->IsZombie()) ? f->Get<TTree>(tree_name) : nullptr;
+    if (!t)
+    {
+        std::cerr << "btana-dump: cannot open " << file_path << "\n";
+        return 1;
+    }
+
+    //  Each selected entry is read once; rows arrive in entry order.
+    if (fmt == DumpFormat::Lightdata)
+    {
+        auto spilldata = std::make_unique<AlcorSpilldata>();
+        spilldata->link_to_tree(t);
+        //  Same overlay as the index, so row positions line up.
+        const auto overlay = open_overlay(t);
+        Long64_t loaded = -1;
+        for (const auto *row : selected)
+        {
+            if (row->entry != loaded)
+            {
+                t->GetEntry(row->entry);
+                spilldata->get_entry();
+                overlay->apply(static_cast<int>(row->entry), spilldata->get_frame_reference_list_link(),
+                               spilldata->get_frame_list_link());
+                loaded = row->entry;
+                std::cout << "spill " << row->spill << "   entry=" << row->entry
+                          << "   frames=" << spilldata->get_frame_list_link().size() << "\n";
+            }
+            const auto &frames = spilldata->get_frame_list_link();
+            if (row->position < frames.size())
+                print_lightdata_frame(row->position, row->frame_id, frames[row->position]);
+        }
+    }
+    else if (fmt == DumpFormat::Recodata)
+    {
+        auto recodata = std::make_unique<AlcorRecodata>();
+        if (!recodata->link_to_tree(t))
+        {
+            std::cerr << "btana-dump: failed to link AlcorRecodata to 'recodata' tree\n";
+            return 1;
+        }
+        for (const auto *row : selected)
+        {
+            t->GetEntry(row->entry);
+            std::cout << "[spill " << row->spill << ", frame_id " << row->frame_id << "] ";
+            print_recodata_frame(row->entry, *recodata);
+        }
+    }
+    else
+    {
+        auto rtd = std::make_unique<AlcorRecotrackdata>();
+        rtd->link_to_tree(t);
+        for (const auto *row : selected)
+        {
+            t->GetEntry(row->entry);
+            std::cout << "[spill " << row->spill << ", frame_id " << row->frame_id << "] ";
+            print_recotrackdata_frame(row->entry, *rtd);
+        }
+    }
+    return 0;
+}
+
 } // namespace btana::utilities
@@ -0,0 +1,453 @@
+/**
+ * @file retrigger_writer.cxx
+ * @brief `lightdata_retrigger_writer` — re-run the software-trigger stages
+ *        (streaming score + RANSAC) over an existing `lightdata.root` and
+ *        write the outcome as the trigger-overlay friend tree.
+ *
+ * The per-spill flow mirrors the segment driver of `lightdata_writer()`:
+ *
+ *   1. strip the derived triggers (`_TRIGGER_STREAMING_RING_FOUND_`,
+ *      `_TRIGGER_RANSAC_RING_FOUND_`) and the trigger-stage `HitMask` bits
+ *      from every frame — what is left (hardware + TIMING) is the RANSAC
+ *      seed base;
+ *   2. noise segment (first-frames window): PASS A against the previous
+ *      spill's weight bundle, then fill the cumulative DCR profile;
+ *   3. rebuild the weight bundle (DCR + in-beam sideband);
+ *   4. data segment: PASS A against the fresh bundle;
+ *   5. serial drain in frame order into the friend tree.
+ *
+ * PASS A is the same parallel compute the writer runs — per-frame
+ * `compute_streaming_score_pure` followed by `run_streaming_ransac_compute`
+ * on frames that carry a seed.  No QA histograms beyond the n_σ score
+ * samples are produced: the point is fast trigger tuning, the full QA stays
+ * with the raw pass.
+ */
+
+#include "writers/lightdata.h"
+#include "writers/lightdata/trigger_overlay.h"
+#include "utility/task_pool.h"
+
+#include <mist/logger/logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+#include "TFile.h"
+#include "TH1.h"
+#include "TProfile.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include "alcor_spilldata.h"
+#include "mapping.h"
+#include "triggers/streaming/ransac.h"
+#include "triggers/streaming/score.h"
+#include "utility/config_dump.h"
+#include "utility/config_reader.h"
+#include "utility/global_index.h"
+#include "utility/root_hist.h"
+
+namespace
+{
+
+/// Derived (software-trigger) trigger indices — regenerated by this pass.
+bool is_trigger_stage_output(uint8_t index)
+{
+    return index == static_cast<uint8_t>(_TRIGGER_STREAMING_RING_FOUND_) ||
+           index == static_cast<uint8_t>(_TRIGGER_RANSAC_RING_FOUND_);
+}
+
+} // namespace
+
+void lightdata_retrigger_writer(
+    const std::string &data_repository,
+    const std::string &run_name,
+    int max_spill,
+    bool force_rebuild,
+    int requested_n_threads,
+    std::string mapping_config_file,
+    std::string fine_calibration_config_file,
+    std::string framer_conf_file,
+    std::string streaming_conf_file,
+    float streaming_n_sigma_threshold_override)
+{
+    using ::btana::lightdata::kTriggerOverlayFileName;
+    using ::btana::lightdata::kTriggerOverlayTreeName;
+    using ::btana::lightdata::kTriggerStageMaskBits;
+    using ::btana::lightdata::TriggerOverlayRecord;
+    namespace fs = std::filesystem;
+
+    //  PASS A workers read the shared calibration table concurrently.
+    ROOT::EnableThreadSafety();
+
+    const fs::path run_dir = fs::path(data_repository) / run_name;
+    const std::string input_filename = (run_dir / "lightdata.root").string();
+    const std::string outname = (run_dir / kTriggerOverlayFileName).string();
+    if (fs::exists(outname) && !force_rebuild)
+    {
+        mist::logger::info("(lightdata_retrigger_writer) " + outname +
+                           " exists and --force-rebuild not set — skipping.");
+        return;
+    }
+
+    //  No cascade: the whole point of this pass is to NOT touch raw data.
+    TFilePtr input_file(TFile::Open(input_filename.c_str(), "READ"));
+    if (!input_file || input_file->IsZombie())
+    {
+        mist::logger::error("(lightdata_retrigger_writer) " + input_filename +
+                            " missing or corrupt — run lightdata_writer first.");
+        return;
+    }
+    auto *lightdata_tree = input_file->Get<TTree>("lightdata");
+    if (!lightdata_tree)
+    {
+        mist::logger::error("(lightdata_retrigger_writer) 'lightdata' tree missing in " +
+                            input_filename);
+        return;
+    }
+    auto spilldata = std::make_unique<AlcorSpilldata>();
+    spilldata->link_to_tree(lightdata_tree);
+
+    //  Configuration — same readers + override semantics as lightdata_writer.
+    auto framer_cfg = FramerConfReader(framer_conf_file);
+    auto streaming_trigger_cfg = streaming_trigger_conf_reader(streaming_conf_file);
+    if (streaming_n_sigma_threshold_override > 0.f)
+    {
+        mist::logger::info(TString::Format(
+                               "(lightdata_retrigger_writer) streaming n_sigma threshold "
+                               "override: %.3f (was %.3f from %s)",
+                               streaming_n_sigma_threshold_override,
+                               streaming_trigger_cfg.n_sigma_threshold,
+                               streaming_conf_file.c_str())
+                               .Data());
+        streaming_trigger_cfg.n_sigma_threshold = streaming_n_sigma_threshold_override;
+    }
+    auto streaming_ransac_cfg = streaming_ransac_conf_reader(streaming_conf_file);
+    const float frame_length_ns = framer_cfg.frame_length_ns();
+    const float time_window_ns = streaming_trigger_cfg.time_window_ns;
+
+    //  Fine calibration: the run-local fine_calib.toml is the table the
+    //  lightdata pass finished with (written at its finalize), so hit times
+    //  match what the original score saw.  Same try/catch fallback as the
+    //  other readers.
+    if (fine_calibration_config_file.empty() && fs::exists(run_dir / "fine_calib.toml"))
+        fine_calibration_config_file = (run_dir / "fine_calib.toml").string();
+    if (!fine_calibration_config_file.empty())
+    {
+        try
+        {
+            AlcorFinedata::read_calib_from_file(fine_calibration_config_file);
+        }
+        catch (const std::exception &e)
+        {
+            mist::logger::error(
+                "(lightdata_retrigger_writer) read_calib_from_file('" +
+                fine_calibration_config_file + "') failed: " +
+                std::string(e.what()) + " — proceeding with phase = 0 for every channel.");
+        }
+    }
+    AlcorFinedata::freeze_calibration();
+
+    Mapping current_mapping(mapping_config_file);
+
+    TFilePtr output_file(TFile::Open(outname.c_str(), "RECREATE"));
+    if (!output_file || output_file->IsZombie())
+    {
+        mist::logger::error("(lightdata_retrigger_writer) Failed to open output " + outname);
+        return;
+    }
+    TDirectory::TContext ctx(output_file.get());
+
+    TriggerOverlayRecord record;
+    auto *triggers_ptr = &record.triggers;
+    auto *trigger_bits_ptr = &record.trigger_bits;
+    TTree *overlay_tree = new TTree(kTriggerOverlayTreeName, "Trigger-stage overlay for lightdata");
+    overlay_tree->Branch("spill", &record.spill);
+    overlay_tree->Branch("frame", &record.frame);
+    overlay_tree->Branch("keep", &record.keep);
+    overlay_tree->Branch("triggers", &triggers_ptr);
+    overlay_tree->Branch("trigger_bits", &trigger_bits_ptr);
+    overlay_tree->Branch("ring1_cx", &record.ring1_cx);
+    overlay_tree->Branch("ring1_cy", &record.ring1_cy);
+    overlay_tree->Branch("ring1_radius", &record.ring1_radius);
+    overlay_tree->Branch("ring2_cx", &record.ring2_cx);
+    overlay_tree->Branch("ring2_cy", &record.ring2_cy);
+    overlay_tree->Branch("ring2_radius", &record.ring2_radius);
+
+    //  Score samples — same log-binned n_σ axis as the lightdata writer so
+    //  the two can be overlaid when picking a threshold.
+    double kScoreEdges[201];
+    for (int i = 0; i <= 200; ++i)
+        kScoreEdges[i] = 0.1 * std::pow(10.0, 4.0 * i / 200.0);
+    RootHist<TH1F> h_streaming_score_noise("h_streaming_score_noise",
+                                           ";n_{#sigma};probability per bin", 200, kScoreEdges);
+    RootHist<TH1F> h_streaming_score_data("h_streaming_score_data",
+                                          ";n_{#sigma};probability per bin", 200, kScoreEdges);
+
+    //  Cumulative DCR profile, rebuilt from the first-frames frames on disk
+    //  (always kept — they carry TriggerFirstFrames).  Pre-Scale view, as
+    //  `build_streaming_trigger_weights` expects.
+    constexpr int kChansPerCherenkovDevice = gidx::kUsesSplitInTwo ? 256 : 512;
+    constexpr int kCherenkovDeviceCount = gidx::kTimingDeviceLo - gidx::kFirstDevice;
+    constexpr int kMaxCherenkovChannelOrdinal = kCherenkovDeviceCount * kChansPerCherenkovDevice;
+    RootHist<TProfile> h_dcr_per_channel("h_dcr_per_channel", ";channel;hits per frame;",
+                                         kMaxCherenkovChannelOrdinal, 0, kMaxCherenkovChannelOrdinal);
+
+    StreamingTriggerWeights streaming_weights;
+    const StreamingRansacQA no_qa; // QA stays with the raw pass.
+
+    const int all_spills = std::min<int>(static_cast<int>(lightdata_tree->GetEntries()), max_spill);
+    long long n_frames_total = 0, n_frames_kept = 0, n_streaming_fired = 0, n_ransac_rings = 0;
+
+    for (int i_spill = 0; i_spill < all_spills; ++i_spill)
+    {
+        lightdata_tree->GetEntry(i_spill);
+
+        //  Re-key the flat vectors into the working map so the score helpers
+        //  (`compute_streaming_inbeam_rates`) see the same layout as online.
+        auto &frame_link = spilldata->get_frame_link();
+        frame_link.clear();
+        {
+            auto &flat_ids = spilldata->get_frame_reference_list_link();
+            auto &flat_frames = spilldata->get_frame_list_link();
+            for (size_t i = 0; i < flat_ids.size(); ++i)
+                frame_link.emplace(flat_ids[i], std::move(flat_frames[i]));
+        }
+        const auto sorted_keys = sorted_frame_ids(frame_link);
+        const size_t n_frames = sorted_keys.size();
+
+        //  Active Cherenkov channels this spill — same construction as the
+        //  writer's `active_sensors` (channel_ordinal keys).
+        std::set<uint32_t> active_sensors;
+        for (const auto &[device, lanes] : spilldata->get_not_dead_participants())
+            if (device < ::gidx::kTimingDeviceLo)
+                for (auto lane : lanes)
+                    for (int i_channel = 0; i_channel < 8; ++i_channel)
+                    {
+                        const int chip_raw = lane / 4;
+                        const int channel_raw = 8 * (lane % 4) + i_channel;
+                        const int chip_logical = ::gidx::kUsesSplitInTwo ? chip_raw / 2 : chip_raw;
+                        const int channel_log = ::gidx::kUsesSplitInTwo
+                                                    ? channel_raw + 32 * (chip_raw % 2)
+                                                    : channel_raw;
+                        const auto gi = ::GlobalIndex::from_components(
+                            device, lane, chip_logical, channel_log, 0);
+                        active_sensors.insert(static_cast<uint32_t>(gi.channel_ordinal()));
+                    }
+
+        //  Strip the previous trigger-stage outputs; keep the seed base.
+        //  Positions are re-assigned so a --skip-stream-qa lightdata (hits
+        //  left unmapped) is a valid input too.
+        std::vector<AlcorLightdataStruct *> frames(n_frames);
+        std::vector<std::vector<TriggerEvent>> seed_base(n_frames);
+        for (size_t i = 0; i < n_frames; ++i)
+        {
+            auto &ld = frame_link[sorted_keys[i]];
+            frames[i] = &ld;
+            for (const auto &trg : ld.trigger_hits)
+                if (!is_trigger_stage_output(trg.index))
+                    seed_base[i].push_back(trg);
+            ld.trigger_hits = seed_base[i];
+            ld.seal_trigger_mask();
+            for (auto &hit : ld.cherenkov_hits)
+            {
+                hit.HitMask &= ~kTriggerStageMaskBits;
+                current_mapping.assign_position(hit);
+            }
+        }
+
+        size_t split = 0;
+        while (split < n_frames &&
+               static_cast<int>(sorted_keys[split]) < framer_cfg.first_frames_trigger)
+            ++split;
+
+        std::vector<StreamingScoreResult> score_results(n_frames);
+        std::vector<RansacMutations> ransac_results(n_frames);
+
+        //  PASS A over [lo, hi) — carry-in reconstructed from the predecessor
+        //  only when it is the adjacent frame; a gap means the frame in
+        //  between was dropped by the raw pass and its hits are gone.
+        auto compute_frame_kernels = [&](size_t lo, size_t hi, const StreamingTriggerWeights &w)
+        {
+            if (hi <= lo)
+                return;
+            auto run_one = [&](size_t i)
+            {
+                std::vector<std::tuple<int, float, float>> carry_in;
+                if (i > lo && sorted_keys[i - 1] + 1 == sorted_keys[i])
+                    carry_in = reconstruct_streaming_carry_over(
+                        frames[i - 1]->cherenkov_hits, time_window_ns, w, frame_length_ns);
+                score_results[i] = compute_streaming_score_pure(
+                    frames[i]->cherenkov_hits, time_window_ns, w,
+                    streaming_trigger_cfg.n_sigma_threshold, carry_in, frame_length_ns);
+                if (seed_base[i].empty() && !score_results[i].fired)
+                    return;
+                std::vector<TriggerEvent> seeds = seed_base[i];
+                for (const auto &trg : score_results[i].streaming_triggers)
+                    seeds.push_back(trg);
+                ransac_results[i] = run_streaming_ransac_compute(
+                    frames[i]->cherenkov_hits, seeds, score_results[i].streaming_mask_indices,
+                    i_spill, time_window_ns, streaming_ransac_cfg, no_qa, w.weight_by_channel);
+            };
+            const size_t n_pool = util::TaskPool::instance().concurrency();
+            const size_t n_threads = std::max<size_t>(
+                1, std::min<size_t>(requested_n_threads > 0
+                                        ? std::min<size_t>(requested_n_threads, n_pool)
+                                        : n_pool,
+                                    hi - lo));
+            if (n_threads <= 1)
+            {
+                for (size_t i = lo; i < hi; ++i)
+                    run_one(i);
+                return;
+            }
+            std::atomic<size_t> next{lo};
+            util::TaskGroup group;
+            for (size_t t = 0; t < n_threads; ++t)
+                group.run([&]()
+                          {
+                    for (size_t i = next.fetch_add(1); i < hi; i = next.fetch_add(1))
+                        run_one(i); });
+            group.wait();
+        };
+
+        //  Noise segment against the previous spill's bundle (empty on
+        //  spill 0), then accumulate its DCR — the fill the writer does in
+        //  `fill_dcr_afterpulse_ct_qa` on first-frames frames.
+        const StreamingTriggerWeights prev_weights = streaming_weights;
+        compute_frame_kernels(0, split, prev_weights);
+        std::unordered_map<uint32_t, uint16_t> active_sensors_count;
+        for (size_t i = 0; i < split; ++i)
+        {
+            if (!frames[i]->has_trigger(TriggerFirstFrames))
+                continue;
+            active_sensors_count.clear();
+            for (const auto key : active_sensors)
+                active_sensors_count[key] = 0;
+            for (const auto &hit : frames[i]->cherenkov_hits)
+                active_sensors_count[static_cast<uint32_t>(::GlobalIndex(hit.GlobalIndex).channel_ordinal())]++;
+            for (const auto &[channel, count] : active_sensors_count)
+                h_dcr_per_channel->Fill(channel, count);
+        }
+
+        //  Weight bundle at the noise → data boundary.  The writer samples
+        //  the in-beam sideband after the noise bodies ran, i.e. with TIMING
+        //  present on noise frames only; hide it on data frames for the call
+        //  so the anchors match.
+        if (split < n_frames)
+        {
+            for (size_t i = split; i < n_frames; ++i)
+            {
+                std::erase_if(frames[i]->trigger_hits, [](const TriggerEvent &t)
+                              { return t.index == TriggerTiming; });
+                frames[i]->seal_trigger_mask();
+            }
+            static const std::set<uint8_t> kInBeamExclude = {
+                TriggerFirstFrames,
+                TriggerStartOfSpill,
+                _TRIGGER_STREAMING_RING_FOUND_,
+                _TRIGGER_RANSAC_RING_FOUND_,
+            };
+            StreamingInBeamRates in_beam_rates = compute_streaming_inbeam_rates(
+                *spilldata, /*sideband_lo_ns=*/-300.f, /*sideband_hi_ns=*/-50.f,
+                frame_length_ns, kInBeamExclude);
+            for (size_t i = split; i < n_frames; ++i)
+            {
+                frames[i]->trigger_hits = seed_base[i];
+                frames[i]->seal_trigger_mask();
+            }
+            streaming_weights = build_streaming_trigger_weights(
+                h_dcr_per_channel.get(), time_window_ns, frame_length_ns,
+                streaming_trigger_cfg.min_noise_hits, &active_sensors,
+                in_beam_rates.empty() ? nullptr : &in_beam_rates);
+            streaming_weights.max_hits_per_window = streaming_trigger_cfg.max_hits_per_window;
+            compute_frame_kernels(split, n_frames, streaming_weights);
+        }
+
+        //  Serial drain in frame order — trigger order stays
+        //  seed base → streaming → RANSAC, as in the writer.
+        for (size_t i = 0; i < n_frames; ++i)
+        {
+            const auto &score = score_results[i];
+            const auto &ransac = ransac_results[i];
+            TH1F *h_score = (i < split) ? h_streaming_score_noise.get()
+                                        : h_streaming_score_data.get();
+            for (const float n_sigma : score.n_sigma_fills)
+                h_score->Fill(n_sigma);
+
+            record.clear();
+            record.spill = i_spill;
+            record.frame = sorted_keys[i];
+            record.triggers = seed_base[i];
+            record.triggers.insert(record.triggers.end(),
+                                   score.streaming_triggers.begin(), score.streaming_triggers.end());
+            record.keep = !record.triggers.empty();
+            if (record.keep)
+                record.triggers.insert(record.triggers.end(),
+                                       ransac.ransac_triggers.begin(), ransac.ransac_triggers.end());
+            record.trigger_bits.assign(frames[i]->cherenkov_hits.size(), 0);
+            for (const int idx : score.streaming_mask_indices)
+                record.trigger_bits[idx] |= static_cast<uint8_t>(encode_bit(HitmaskStreamingRingTrigger));
+            if (record.keep)
+            {
+                for (const auto &[idx, bit] : ransac.mask_writes)
+                    record.trigger_bits[idx] |= static_cast<uint8_t>(encode_bit(bit));
+                if (ransac.has_ring1)
+                {
+                    record.ring1_cx = ransac.r1_cx;
+                    record.ring1_cy = ransac.r1_cy;
+                    record.ring1_radius = ransac.r1_r;
+                }
+                if (ransac.has_ring2)
+                {
+                    record.ring2_cx = ransac.r2_cx;
+                    record.ring2_cy = ransac.r2_cy;
+                    record.ring2_radius = ransac.r2_r;
+                }
+                n_ransac_rings += static_cast<long long>(ransac.ransac_triggers.size());
+                ++n_frames_kept;
+            }
+            if (score.fired)
+                ++n_streaming_fired;
+            overlay_tree->Fill();
+        }
+        n_frames_total += static_cast<long long>(n_frames);
+        frame_link.clear();
+    }
+
+    //  (spill, frame) index — what `LightdataTriggerOverlay` looks up.
+    overlay_tree->BuildIndex("spill", "frame");
+    output_file->cd();
+    overlay_tree->Write();
+    TDirectory *streaming_dir = output_file->mkdir("Streaming Trigger");
+    streaming_dir->cd();
+    h_streaming_score_noise->Write();
+    h_streaming_score_data->Write();
+
+    {
+        util::ConfigDump dump(output_file.get());
+        dump.add("max_spill", max_spill)
+            .add("force_rebuild", force_rebuild)
+            .add("n_sigma_threshold", static_cast<double>(streaming_trigger_cfg.n_sigma_threshold))
+            .add_path("input_lightdata_root", input_filename)
+            .add_path("mapping_conf_file", mapping_config_file)
+            .add_path("fine_calib_conf_file", fine_calibration_config_file)
+            .add_path("framer_conf_file", framer_conf_file)
+            .add_path("streaming_conf_file", streaming_conf_file)
+            .add_toml_snapshot("streaming_conf", streaming_conf_file)
+            .add("frames_total", n_frames_total)
+            .add("frames_kept", n_frames_kept);
+    }
+
+    mist::logger::info(TString::Format(
+                           "(lightdata_retrigger_writer) %lld frames re-triggered: %lld kept, "
+                           "%lld streaming fires, %lld RANSAC rings → %s",
+                           n_frames_total, n_frames_kept, n_streaming_fired, n_ransac_rings,
+                           outname.c_str())
+                           .Data());
+}
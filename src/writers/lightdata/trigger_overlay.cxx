@@ -0,0 +1,110 @@
+/**
+ * @file trigger_overlay.cxx
+ * @brief Reader side of the trigger-stage friend tree — see
+ *        `include/writers/lightdata/trigger_overlay.h`.
+ */
+
+#include "writers/lightdata/trigger_overlay.h"
+
+#include <mist/logger/logger.h>
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "alcor_lightdata.h"
+
+#include <filesystem>
+
+namespace btana::lightdata
+{
+
+std::string trigger_overlay_path(const std::string &lightdata_path)
+{
+    return (std::filesystem::path(lightdata_path).parent_path() / kTriggerOverlayFileName).string();
+}
+
+LightdataTriggerOverlay::LightdataTriggerOverlay(const std::string &path)
+{
+    //  No friend file is the common case: stay quiet (TFile::Open would
+    //  print an error for it).
+    if (!std::filesystem::exists(path))
+        return;
+    file_.reset(TFile::Open(path.c_str(), "READ"));
+    if (!file_ || file_->IsZombie())
+    {
+        file_.reset();
+        return;
+    }
+    tree_ = file_->Get<TTree>(kTriggerOverlayTreeName);
+    if (!tree_ || !tree_->GetTreeIndex())
+    {
+        mist::logger::warning("(LightdataTriggerOverlay) " + path +
+                              " has no indexed '" + kTriggerOverlayTreeName +
+                              "' tree — overlay disabled.");
+        tree_ = nullptr;
+        return;
+    }
+    tree_->SetBranchAddress("spill", &record_.spill);
+    tree_->SetBranchAddress("frame", &record_.frame);
+    tree_->SetBranchAddress("keep", &record_.keep);
+    tree_->SetBranchAddress("triggers", &triggers_ptr_);
+    tree_->SetBranchAddress("trigger_bits", &trigger_bits_ptr_);
+    tree_->SetBranchAddress("ring1_cx", &record_.ring1_cx);
+    tree_->SetBranchAddress("ring1_cy", &record_.ring1_cy);
+    tree_->SetBranchAddress("ring1_radius", &record_.ring1_radius);
+    tree_->SetBranchAddress("ring2_cx", &record_.ring2_cx);
+    tree_->SetBranchAddress("ring2_cy", &record_.ring2_cy);
+    tree_->SetBranchAddress("ring2_radius", &record_.ring2_radius);
+}
+
+LightdataTriggerOverlay::~LightdataTriggerOverlay() = default;
+
+std::size_t LightdataTriggerOverlay::apply(int spill,
+                                           std::vector<uint32_t> &frame_reference,
+                                           std::vector<AlcorLightdataStruct> &frames)
+{
+    if (!tree_)
+        return 0;
+
+    //  Compact in place: `out` is the write cursor over both parallel
+    //  vectors, so dropped frames cost one move per survivor and no
+    //  reallocation.
+    std::size_t out = 0;
+    for (std::size_t i = 0; i < frames.size(); ++i)
+    {
+        const Long64_t entry = tree_->GetEntryNumberWithIndex(spill, frame_reference[i]);
+        bool keep = true;
+        if (entry >= 0 && tree_->GetEntry(entry) > 0 &&
+            record_.trigger_bits.size() == frames[i].cherenkov_hits.size())
+        {
+            auto &ld = frames[i];
+            ld.trigger_hits = record_.triggers;
+            ld.seal_trigger_mask();
+            for (std::size_t h = 0; h < ld.cherenkov_hits.size(); ++h)
+                ld.cherenkov_hits[h].HitMask =
+                    (ld.cherenkov_hits[h].HitMask & ~kTriggerStageMaskBits) |
+                    (static_cast<uint32_t>(record_.trigger_bits[h]) & kTriggerStageMaskBits);
+            ld.ring1_cx = record_.ring1_cx;
+            ld.ring1_cy = record_.ring1_cy;
+            ld.ring1_radius = record_.ring1_radius;
+            ld.ring2_cx = record_.ring2_cx;
+            ld.ring2_cy = record_.ring2_cy;
+            ld.ring2_radius = record_.ring2_radius;
+            keep = record_.keep;
+        }
+        if (!keep)
+            continue;
+        if (out != i)
+        {
+            frame_reference[out] = frame_reference[i];
+            frames[out] = std::move(frames[i]);
+        }
+        ++out;
+    }
+    const std::size_t n_dropped = frames.size() - out;
+    frame_reference.resize(out);
+    frames.resize(out);
+    return n_dropped;
+}
+
+} // namespace btana::lightdata
@@ -0,0 +1,818 @@
+/**
+ * @file writers/pulser_calib/channel_fit.cxx
+ * @brief Implementation of the per-channel pulser fit — see
+ *        `writers/pulser_calib/channel_fit.h`.
+ */
+
+#include "writers/pulser_calib/channel_fit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace btana::pulser_calib
+{
+
+namespace
+{
+
+// ---------------------------------------------------------------------------
+//  Per-channel fit — CLOSED-FORM linear least squares.
+//
+//  For each consecutive same-spill hit pair (p → h) the residual is
+//
+//      r = (c_h − c_p) − (θ_{t_h} − θ_{t_p}) − (f_h · a_{t_h} − f_p · a_{t_p}) − T
+//
+//  which is LINEAR in every unknown (4 offsets θ, 4 slopes a, period T).
+//  Per-spill phase cancels in the difference — no mod-T trick, no
+//  cross-spill stitching, no rollover correction beyond what
+//  `get_coarse_global_time()` already does.
+//
+//  Stacking one row per pair gives  A · x = y  with
+//
+//      x = [θ_0, θ_1, θ_2, θ_3, a_0, a_1, a_2, a_3, T]
+//      y_k = c_h − c_p             (T column absorbs the constant; or
+//                                   y_k = c_h − c_p − T_fixed when T
+//                                   is fixed by the operator and the
+//                                   T column is dropped)
+//
+//      A_k[t]    = +1 if t = t_h, −1 if t = t_p     (offsets)
+//      A_k[t+4]  = +f_h if t = t_h, −f_p if t = t_p (slopes)
+//      A_k[8]    = −1                               (period, when free)
+//
+//  Solution comes from the normal equations  Aᵀ A x = Aᵀ y, an
+//  N×N (N=8 or 9) symmetric positive-definite system in-place
+//  Cholesky-solved per channel.  No iteration, no convergence
+//  concept, ~µs per channel.  No shared global state → trivially
+//  parallel across channels.
+//
+//  Gauge fix on θ_0 = 0 implemented by zeroing row/col 0 and pinning
+//  the diagonal to 1 (constraint x_0 = 0).  Per-TDC slope guard
+//  (insufficient fine-bin span) implemented the same way: pin
+//  a_t = default_slope, eliminate from the system, re-solve.
+//
+//  Safety filter on coarse pair gap (only |c_h − c_p − T_nominal| <
+//  tolerance contributes) catches missed-pulse jumps, spill-boundary
+//  slip-throughs, DAQ glitches.
+// ---------------------------------------------------------------------------
+
+//  ── Tiny symmetric positive-definite solver ─────────────────────
+//  Cholesky factorisation of the N×N normal-equations matrix
+//  (row-major), then forward + back substitution to solve
+//  `normal_matrix · solution = rhs`.  Returns false if the matrix
+//  is not positive-definite (degenerate / rank-deficient).
+//
+//  N is a compile-time constant (only NUM_FIT_PARAMS = 9 is ever
+//  instantiated), so every loop below is expanded by `static_for`
+//  into straight-line code: all indices are constants, the factor
+//  lives in registers / a fixed stack frame, and the compiler is
+//  free to schedule across what used to be loop boundaries.  That
+//  beats calling out to ROOT/Eigen/BLAS in both runtime and link
+//  surface — and the lack of shared global state is what lets the
+//  per-channel outer loop go parallel.
+
+//  Call `body(std::integral_constant<int, I>{})` for I in [Begin, End),
+//  expanded at compile time.  Inside `body`, `decltype(i)::value` is a
+//  constant expression, usable as a bound of a nested `static_for`.
+template <int Begin, int End, typename Body>
+[[gnu::always_inline]] inline void static_for(Body &&body)
+{
+    if constexpr (Begin < End)
+    {
+        body(std::integral_constant<int, Begin>{});
+        static_for<Begin + 1, End>(body);
+    }
+}
+
+template <int N>
+inline bool solve_spd(const double normal_matrix[N * N],
+                      const double rhs[N],
+                      double solution[N])
+{
+    static_assert(N > 0 && N <= 16,
+                  "solve_spd is fully unrolled; meant for small fixed systems");
+
+    //  Step 1 — Cholesky factorisation: normal_matrix = L · Lᵀ
+    //  with L lower-triangular, stored in `cholesky_lower`.  The
+    //  reciprocal of each diagonal is kept so the substitutions below
+    //  multiply instead of divide.
+    double cholesky_lower[N * N] = {};
+    double inv_diagonal[N];
+    bool positive_definite = true;
+    static_for<0, N>([&](auto row_c)
+    {
+        constexpr int row = decltype(row_c)::value;
+        static_for<0, row + 1>([&](auto col_c)
+        {
+            constexpr int col = decltype(col_c)::value;
+            double partial_sum = normal_matrix[row * N + col];
+            static_for<0, col>([&](auto inner_c)
+            {
+                constexpr int inner = decltype(inner_c)::value;
+                partial_sum -= cholesky_lower[row * N + inner] *
+                               cholesky_lower[col * N + inner];
+            });
+            if constexpr (row == col)
+            {
+                //  Diagonal must be strictly positive — failure
+                //  signals non-positive-definite input (degenerate
+                //  / rank-deficient channel).  Checked once at the
+                //  end so the unrolled body stays branch-free; a
+                //  NaN from sqrt of a negative cannot hide a failure.
+                positive_definite &= partial_sum > 0.0;
+                cholesky_lower[row * N + row] = std::sqrt(partial_sum);
+                inv_diagonal[row] = 1.0 / cholesky_lower[row * N + row];
+            }
+            else
+                cholesky_lower[row * N + col] = partial_sum * inv_diagonal[col];
+        });
+    });
+    if (!positive_definite)
+        return false;
+
+    //  Step 2 — forward substitution: L · forward_subst_result = rhs.
+    double forward_subst_result[N];
+    static_for<0, N>([&](auto row_c)
+    {
+        constexpr int row = decltype(row_c)::value;
+        double partial_sum = rhs[row];
+        static_for<0, row>([&](auto inner_c)
+        {
+            constexpr int inner = decltype(inner_c)::value;
+            partial_sum -= cholesky_lower[row * N + inner] *
+                           forward_subst_result[inner];
+        });
+        forward_subst_result[row] = partial_sum * inv_diagonal[row];
+    });
+
+    //  Step 3 — back substitution: Lᵀ · solution = forward_subst_result.
+    //  Walked as `row = N − 1 − step` so the expansion stays ascending.
+    static_for<0, N>([&](auto step_c)
+    {
+        constexpr int row = N - 1 - decltype(step_c)::value;
+        double partial_sum = forward_subst_result[row];
+        static_for<row + 1, N>([&](auto inner_c)
+        {
+            constexpr int inner = decltype(inner_c)::value;
+            partial_sum -= cholesky_lower[inner * N + row] * solution[inner];
+        });
+        solution[row] = partial_sum * inv_diagonal[row];
+    });
+    return true;
+}
+
+//  Pin the `param_idx`-th unknown at `pinned_value` in a
+//  symmetric-positive-definite system `normal_matrix · x = rhs`,
+//  preserving SPD after the substitution.  Used for the gauge fix
+//  (θ_0 = 0), the slope guard, and the fixed-period case.
+//
+//  Algorithm: move the pinned column's contribution to the RHS,
+//  zero the pinned row and column, set the pinned diagonal to 1,
+//  and set rhs[param_idx] = pinned_value.  The solver then returns
+//  `solution[param_idx] = pinned_value` and the remaining unknowns
+//  consistent with the pin.  `param_idx` stays a runtime value (the
+//  slope guard picks it per TDC); the sweeps over N are unrolled.
+template <int N>
+inline void pin_parameter(double normal_matrix[N * N], double rhs[N],
+                          int param_idx, double pinned_value)
+{
+    //  1. Move the pinned column's contribution to the RHS, and zero
+    //     the pinned column...
+    static_for<0, N>([&](auto row_c)
+    {
+        constexpr int row = decltype(row_c)::value;
+        rhs[row] -= normal_matrix[row * N + param_idx] * pinned_value;
+        normal_matrix[row * N + param_idx] = 0.0;
+    });
+    //  2. ...and the pinned row.
+    static_for<0, N>([&](auto col_c)
+    { normal_matrix[param_idx * N + decltype(col_c)::value] = 0.0; });
+    //  3. Pin the diagonal so the solver returns `pinned_value`.
+    normal_matrix[param_idx * N + param_idx] = 1.0;
+    rhs[param_idx] = pinned_value;
+}
+
+//  Slope-guard mask: a TDC that saw fewer than
+//  `slope_fit_min_fine_span` distinct fine bins has no lever arm for
+//  its slope fit and is pinned to the default.  Computed from raw hit
+//  coverage and stable across the slip correction step (slip only
+//  shifts coarse, never fine).
+inline void slope_guard_mask(const int fine_min_per_tdc[4],
+                             const int fine_max_per_tdc[4],
+                             const CalibConfigStruct &cfg,
+                             bool slope_guard_fired[4])
+{
+    for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+    {
+        const int fine_span = (fine_max_per_tdc[tdc_idx] >= fine_min_per_tdc[tdc_idx])
+                                  ? (fine_max_per_tdc[tdc_idx] - fine_min_per_tdc[tdc_idx] + 1)
+                                  : 0;
+        slope_guard_fired[tdc_idx] = fine_span < cfg.slope_fit_min_fine_span;
+    }
+}
+
+//  Value a guarded slope is pinned to: the prior's published slope
+//  when there is one (incremental mode — the narrow fine span this run
+//  cannot resolve was typically resolved by an earlier one), otherwise
+//  the configured default.
+inline void pinned_slopes(const ChannelPrior *prior,
+                          const CalibConfigStruct &cfg,
+                          double pinned_slope[4])
+{
+    for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+        pinned_slope[tdc_idx] = (prior && prior->present[tdc_idx])
+                                    ? prior->a[tdc_idx]
+                                    : cfg.default_slope_cc_per_bin;
+}
+
+//  Pin the parameters that the data cannot determine on its own,
+//  then Cholesky-solve.  `system` is modified in place.
+inline bool solve_constrained(NormalEquations &system,
+                              const bool slope_guard_fired[4],
+                              const double pinned_slope[4],
+                              const CalibConfigStruct &cfg,
+                              double fitted_params[NUM_FIT_PARAMS])
+{
+    //  Gauge fix: pin θ_0 = 0.  The other θ values become
+    //  intra-channel TDC offsets relative to TDC 0.  Without
+    //  this the system has a one-parameter family of global
+    //  time shifts.
+    pin_parameter<NUM_FIT_PARAMS>(
+        system.matrix, system.rhs, OFFSET_PARAM_BASE + 0, 0.0);
+    //  Slope guards: pin slopes for TDCs with too-narrow fine
+    //  coverage (see `pinned_slopes`).
+    for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+        if (slope_guard_fired[tdc_idx])
+            pin_parameter<NUM_FIT_PARAMS>(
+                system.matrix, system.rhs,
+                SLOPE_PARAM_BASE + tdc_idx,
+                pinned_slope[tdc_idx]);
+    //  Period: when fixed by the operator we pin parameter 8 at
+    //  nominal_period_cc.  Required for SPD — otherwise row 8 of
+    //  Aᵀ·A is all zero and Cholesky fails.
+    if (!fit_period_from_data(cfg))
+        pin_parameter<NUM_FIT_PARAMS>(
+            system.matrix, system.rhs,
+            PERIOD_PARAM_IDX, nominal_period_cc(cfg));
+    std::fill_n(fitted_params, NUM_FIT_PARAMS, 0.0);
+    return solve_spd<NUM_FIT_PARAMS>(system.matrix, system.rhs, fitted_params);
+}
+
+//  A TDC is published only if it saw at least `min_hits_per_tdc`
+//  hits.  Below-threshold TDCs are left unfitted and end up in
+//  the run-summary skipped list.
+inline void publish_tdc_params(ChannelResult &result,
+                               const double fitted_params[NUM_FIT_PARAMS],
+                               const bool slope_guard_fired[4],
+                               const double pinned_slope[4],
+                               const CalibConfigStruct &cfg)
+{
+    for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+    {
+        if (result.tdc[tdc_idx].n_hits < cfg.min_hits_per_tdc)
+            continue;
+        result.tdc[tdc_idx].fitted = true;
+        result.tdc[tdc_idx].b =
+            fitted_params[OFFSET_PARAM_BASE + tdc_idx];
+        result.tdc[tdc_idx].a = slope_guard_fired[tdc_idx]
+                                    ? pinned_slope[tdc_idx]
+                                    : fitted_params[SLOPE_PARAM_BASE + tdc_idx];
+        //  Per-TDC residual sigma is not propagated yet — the v2
+        //  consumers don't need it.  Computing it would require the
+        //  per-parameter variance from the Aᵀ·A inverse diagonal,
+        //  feasible but not done here.
+        result.tdc[tdc_idx].sigma_a = 0.0;
+        result.tdc[tdc_idx].sigma_b = 0.0;
+        result.ok = true;
+    }
+}
+
+} // namespace
+
+bool decide_slips(const std::vector<double> &phases,
+                  std::vector<double> &sorted_scratch,
+                  const CalibConfigStruct &cfg,
+                  std::vector<int> &slips)
+{
+    constexpr std::size_t MIN_HITS_PER_TDC_FOR_MEDIAN = 4;
+    slips.assign(phases.size(), 0);
+    if (phases.size() < MIN_HITS_PER_TDC_FOR_MEDIAN)
+        return false;
+
+    sorted_scratch = phases;
+    const auto median_iter =
+        sorted_scratch.begin() +
+        static_cast<std::ptrdiff_t>(sorted_scratch.size() / 2);
+    std::nth_element(sorted_scratch.begin(), median_iter, sorted_scratch.end());
+    const double phase_median_cc = *median_iter;
+
+    long num_snap_candidates = 0;
+    for (std::size_t idx = 0; idx < phases.size(); ++idx)
+    {
+        const double phase_deviation_cc = phases[idx] - phase_median_cc;
+        const int slip_cc_count = static_cast<int>(std::round(phase_deviation_cc));
+        if (slip_cc_count != 0 &&
+            std::abs(phase_deviation_cc - static_cast<double>(slip_cc_count)) <
+                cfg.slip_confidence_cc)
+        {
+            slips[idx] = slip_cc_count;
+            ++num_snap_candidates;
+        }
+    }
+    const double snap_candidate_fraction =
+        static_cast<double>(num_snap_candidates) /
+        static_cast<double>(phases.size());
+    if (snap_candidate_fraction > cfg.slip_max_snap_fraction)
+    {
+        std::fill(slips.begin(), slips.end(), 0);
+        return false; // distribution too wide — leave hits alone
+    }
+    return num_snap_candidates > 0;
+}
+
+ChannelResult fit_channel(const ChannelKey &channel_key, ChannelBucket bucket,
+                          const CalibConfigStruct &cfg,
+                          const ChannelPrior *prior)
+{
+    ChannelResult result;
+    result.key = channel_key;
+
+    //  ── Step 1: hit accounting + slope-guard inputs ────────────────
+    //  Count total hits, per-TDC hits, and the per-TDC fine-bin span.
+    //  The fine span feeds the slope guard later: a TDC that saw too
+    //  few distinct fine bins has no lever arm for its slope fit and
+    //  is pinned to the default.
+    long hits_per_tdc[4] = {0, 0, 0, 0};
+    int fine_min_per_tdc[4] = {256, 256, 256, 256};
+    int fine_max_per_tdc[4] = {-1, -1, -1, -1};
+    for (auto &spill_bucket : bucket.per_spill)
+        for (const auto &hit : spill_bucket.hits)
+        {
+            ++result.total_hits;
+            if (hit.tdc < 4)
+            {
+                ++hits_per_tdc[hit.tdc];
+                const int fine_bin = static_cast<int>(hit.fine);
+                if (fine_bin < fine_min_per_tdc[hit.tdc])
+                    fine_min_per_tdc[hit.tdc] = fine_bin;
+                if (fine_bin > fine_max_per_tdc[hit.tdc])
+                    fine_max_per_tdc[hit.tdc] = fine_bin;
+            }
+        }
+    for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+        result.tdc[tdc_idx].n_hits = hits_per_tdc[tdc_idx];
+
+    if (result.total_hits < cfg.min_hits_per_tdc * 4)
+        return result;
+
+    //  ── Step 2: pulser-period setup ────────────────────────────────
+    //  TOML knob > 0 ⇒ operator pins the period (e.g. 320000 cc for a
+    //  1 kHz pulser at 320 MHz).  Otherwise leave the period as a
+    //  free 9th fit parameter for a blind detector-level estimate.
+    const bool fit_period = fit_period_from_data(cfg);
+    const double nominal_period = nominal_period_cc(cfg);
+
+    //  ── Step 3: build the normal-equations system ──────────────────
+    NormalEquations system;
+
+    //  build_normal_equations — assemble `system` from the current
+    //  state of bucket.per_spill[*].hits[*].abs_coarse_cc.  Called
+    //  twice in the slip-aware path: once on the raw coarse counts
+    //  (first pass) and once on the slip-corrected counts (second
+    //  pass).  `fill_diag_hists` is true only on the first pass so
+    //  the as-observed pair-coarse-difference diagnostic histograms
+    //  reflect what the data looked like before any correction.
+    auto build_normal_equations = [&](bool fill_diag_hists)
+    {
+        system = NormalEquations{};
+        for (const auto &spill_bucket : bucket.per_spill)
+        {
+            const auto &hits = spill_bucket.hits;
+            if (hits.size() < 2)
+                continue;
+            for (std::size_t hit_idx = 1; hit_idx < hits.size(); ++hit_idx)
+            {
+                const auto &prev_hit = hits[hit_idx - 1];
+                const auto &curr_hit = hits[hit_idx];
+                if (prev_hit.tdc > 3 || curr_hit.tdc > 3)
+                    continue;
+                const double pair_coarse_diff_cc =
+                    static_cast<double>(curr_hit.abs_coarse_cc) -
+                    static_cast<double>(prev_hit.abs_coarse_cc);
+
+                if (fill_diag_hists)
+                    fill_cdiff_hists(result, pair_coarse_diff_cc, nominal_period);
+
+                //  Safety filter: pair must look like one pulser
+                //  period.  Multi-T missed-pulse jumps, spill-boundary
+                //  leaks, glitches are rejected here.
+                if (std::abs(pair_coarse_diff_cc - nominal_period) >
+                    cfg.consecutive_pair_tolerance_cc)
+                    continue;
+
+                //  Target y.  When T is free, the period column
+                //  absorbs the constant; when fixed, we move T to the
+                //  target.
+                const double pair_target_cc = fit_period
+                                                  ? pair_coarse_diff_cc
+                                                  : (pair_coarse_diff_cc - nominal_period);
+                system.add_pair(prev_hit, curr_hit, pair_target_cc, fit_period);
+            }
+        }
+    };
+
+    //  ── Step 4: slope-guard mask ────────────────────────────────
+    bool slope_guard_fired[4];
+    slope_guard_mask(fine_min_per_tdc, fine_max_per_tdc, cfg, slope_guard_fired);
+    double pinned_slope[4];
+    pinned_slopes(prior, cfg, pinned_slope);
+
+    //  ── Step 5: first-pass solve ────────────────────────────────
+    build_normal_equations(/*fill_diag_hists=*/true);
+    long pair_count_used = system.n_pairs;
+    result.n_pairs_used = pair_count_used;
+    if (pair_count_used == 0)
+        return result;
+    double fitted_params[NUM_FIT_PARAMS] = {};
+    result.converged = solve_constrained(system, slope_guard_fired, pinned_slope, cfg, fitted_params);
+    if (!result.converged)
+        return result;
+
+    //  ── Step 6: intermittent slip correction (regime 2) ─────────
+    //  Known ALCOR quirk: some hits arrive with the coarse counter
+    //  shifted by an integer number of clock cycles.  Two regimes:
+    //
+    //    Regime 1 (whole-TDC permanent slip): every hit on a given
+    //    TDC is shifted by the same integer.  The fit's natural θ_t
+    //    absorbs this — the published calibration is correct without
+    //    any extra correction.  No code path needed here.
+    //
+    //    Regime 2 (intermittent slip mid-run): a fraction of one
+    //    TDC's hits are shifted, the rest aren't.  The single-θ fit
+    //    averages over both populations and is wrong for both.
+    //    Handled here per-hit, per (spill, TDC).
+    //
+    //  Algorithm per (spill, TDC):
+    //    1. For every hit on this TDC in this spill, compute
+    //       calib_time_cc = c − (θ_t + fine · a_t), then reduce
+    //       modulo the pulser period → within_pulse_phase_cc is the
+    //       hit's phase inside one pulser cycle.
+    //    2. Median across THIS TDC's hits in THIS spill is the
+    //       TDC's "true" phase for this spill.  Per-(spill,TDC)
+    //       medianising is essential: pooling across TDCs would
+    //       conflate the intrinsic inter-TDC offsets (cable, ALCOR
+    //       sampling phase) with real slip events.
+    //    3. Per hit, the phase deviation from this median rounds to
+    //       an integer cc → the slip in coarse counter units.
+    //    4. Snap only if the rounded slip is non-zero and the
+    //       deviation sits within `slip_confidence_cc` of that
+    //       integer.  Looser confidence ⇒ over-snaps under the
+    //       natural ~0.5 cc scatter from sub-optimal slope fits.
+    //
+    //  Safety cap (`slip_max_snap_fraction`): if more than this
+    //  fraction of hits in one (spill, TDC) would snap, the
+    //  distribution is too noisy / wide to trust — abort that
+    //  (spill, TDC) and leave its hits untouched.
+    long slipped_hits_per_tdc[4] = {0, 0, 0, 0};
+    {
+        const double period_used_cc = fit_period
+                                          ? fitted_params[PERIOD_PARAM_IDX]
+                                          : nominal_period;
+
+        //  Reusable scratch buffers — allocated once, reused per
+        //  (spill, TDC).  Outer index is the TDC slot (0..3).
+        std::vector<int> hit_indices_per_tdc[4];
+        std::vector<double> phase_residuals_per_tdc[4];
+        std::vector<double> sorted_phase_residuals;
+        std::vector<int> slips;
+        bool any_hits_were_snapped = false;
+
+        for (auto &spill_bucket : bucket.per_spill)
+        {
+            if (spill_bucket.hits.empty())
+                continue;
+            for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+            {
+                hit_indices_per_tdc[tdc_idx].clear();
+                phase_residuals_per_tdc[tdc_idx].clear();
+            }
+            //  Pass 1 — bucket hits into 4 per-TDC lists, compute
+            //  each hit's within-pulse phase.
+            for (std::size_t spill_hit_idx = 0;
+                 spill_hit_idx < spill_bucket.hits.size();
+                 ++spill_hit_idx)
+            {
+                const auto &hit = spill_bucket.hits[spill_hit_idx];
+                if (hit.tdc > 3)
+                    continue;
+                const double calib_time_cc =
+                    static_cast<double>(hit.abs_coarse_cc) -
+                    (fitted_params[OFFSET_PARAM_BASE + hit.tdc] +
+                     static_cast<double>(hit.fine) *
+                         fitted_params[SLOPE_PARAM_BASE + hit.tdc]);
+                const double pulse_number =
+                    std::round(calib_time_cc / period_used_cc);
+                const double within_pulse_phase_cc =
+                    calib_time_cc - pulse_number * period_used_cc;
+                hit_indices_per_tdc[hit.tdc].push_back(
+                    static_cast<int>(spill_hit_idx));
+                phase_residuals_per_tdc[hit.tdc].push_back(
+                    within_pulse_phase_cc);
+            }
+            //  Pass 2 — per TDC, take the spill's median phase and
+            //  snap, with the safety check on snap fraction.
+            for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+            {
+                if (!decide_slips(phase_residuals_per_tdc[tdc_idx],
+                                  sorted_phase_residuals, cfg, slips))
+                    continue;
+                for (std::size_t tdc_local_idx = 0; tdc_local_idx < slips.size();
+                     ++tdc_local_idx)
+                {
+                    if (slips[tdc_local_idx] == 0)
+                        continue;
+                    const int spill_hit_idx =
+                        hit_indices_per_tdc[tdc_idx][tdc_local_idx];
+                    spill_bucket.hits[spill_hit_idx].abs_coarse_cc -=
+                        static_cast<int64_t>(slips[tdc_local_idx]);
+                    ++slipped_hits_per_tdc[tdc_idx];
+                    any_hits_were_snapped = true;
+                }
+            }
+        }
+
+        //  ── Step 7: second-pass solve (only if anything snapped) ──
+        //  Diagnostic histograms NOT refilled — they reflect the
+        //  as-observed (pre-correction) pair distribution.
+        if (any_hits_were_snapped)
+        {
+            build_normal_equations(/*fill_diag_hists=*/false);
+            pair_count_used = system.n_pairs;
+            result.n_pairs_used = pair_count_used;
+            if (pair_count_used == 0)
+                return result;
+            result.converged = solve_constrained(system, slope_guard_fired, pinned_slope,
+                                                 cfg, fitted_params);
+            if (!result.converged)
+                return result;
+        }
+
+        //  Permanent slip (regime 1) needs no special pass — the
+        //  fit's natural θ_t absorbs it.  An earlier implementation
+        //  subtracted the integer-rounded θ from every hit on a
+        //  given TDC and re-fit, producing a "clean" θ ≈ 0 — but the
+        //  published calibration then had no slip information, so
+        //  downstream apply at production time (where the slip is
+        //  still in the hardware) silently went off by the slip
+        //  magnitude.  Removed.
+
+        for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+            result.tdc[tdc_idx].n_slipped_hits = slipped_hits_per_tdc[tdc_idx];
+    }
+
+    //  ── Step 8: chi² recovery for the residual-sigma report ──────
+    //  In principle chi² = ‖y − A·x‖² = ‖y‖² − xᵀ·Aᵀ·y =
+    //  pair_target_sum_squared − xᵀ·rhs_vector_original.
+    //  Reconstructing the original rhs_vector (before pin_parameter
+    //  modified it) is fiddly; cheaper to walk the pairs once more
+    //  and accumulate the residual directly using the solved
+    //  fitted_params.  Same O(pair_count_used) cost as the build,
+    //  one pass.
+    double total_chi2 = 0.0;
+    const double period_used_cc = fit_period
+                                      ? fitted_params[PERIOD_PARAM_IDX]
+                                      : nominal_period;
+    for (const auto &spill_bucket : bucket.per_spill)
+    {
+        const auto &hits = spill_bucket.hits;
+        if (hits.size() < 2)
+            continue;
+        for (std::size_t hit_idx = 1; hit_idx < hits.size(); ++hit_idx)
+        {
+            const auto &prev_hit = hits[hit_idx - 1];
+            const auto &curr_hit = hits[hit_idx];
+            if (prev_hit.tdc > 3 || curr_hit.tdc > 3)
+                continue;
+            const double pair_coarse_diff_cc =
+                static_cast<double>(curr_hit.abs_coarse_cc) -
+                static_cast<double>(prev_hit.abs_coarse_cc);
+            if (std::abs(pair_coarse_diff_cc - nominal_period) >
+                cfg.consecutive_pair_tolerance_cc)
+                continue;
+            const double prev_calib_time_cc =
+                static_cast<double>(prev_hit.abs_coarse_cc) -
+                (fitted_params[OFFSET_PARAM_BASE + prev_hit.tdc] +
+                 static_cast<double>(prev_hit.fine) *
+                     fitted_params[SLOPE_PARAM_BASE + prev_hit.tdc]);
+            const double curr_calib_time_cc =
+                static_cast<double>(curr_hit.abs_coarse_cc) -
+                (fitted_params[OFFSET_PARAM_BASE + curr_hit.tdc] +
+                 static_cast<double>(curr_hit.fine) *
+                     fitted_params[SLOPE_PARAM_BASE + curr_hit.tdc]);
+            const double pair_residual_cc =
+                curr_calib_time_cc - prev_calib_time_cc - period_used_cc;
+            total_chi2 += pair_residual_cc * pair_residual_cc;
+        }
+    }
+    result.chi2_per_pair =
+        total_chi2 / static_cast<double>(pair_count_used);
+    result.T_cc = period_used_cc;
+
+    //  ── Step 9: publish per-TDC parameters ────────────────────────
+    publish_tdc_params(result, fitted_params, slope_guard_fired, pinned_slope, cfg);
+    return result;
+}
+
+void StreamingChannel::decide_tdc(int tdc, const CalibConfigStruct &cfg)
+{
+    const double period = phase_period(cfg);
+    const double slope = (prior && prior->present[tdc])
+                             ? prior->a[tdc]
+                             : cfg.default_slope_cc_per_bin;
+    const ChannelHit &reference = window.front();
+    tdc_positions.clear();
+    tdc_phases.clear();
+    for (std::size_t idx = 0; idx < window.size(); ++idx)
+    {
+        const auto &hit = window[idx];
+        if (hit.tdc != tdc)
+            continue;
+        const double calib_time_cc =
+            static_cast<double>(hit.abs_coarse_cc - reference.abs_coarse_cc) -
+            static_cast<double>(hit.fine) * slope;
+        tdc_positions.push_back(idx);
+        tdc_phases.push_back(calib_time_cc -
+                             std::round(calib_time_cc / period) * period);
+    }
+    decide_slips(tdc_phases, sorted_phases, cfg, tdc_slips);
+}
+
+void StreamingChannel::commit(ChannelHit hit, int slip_cc, const CalibConfigStruct &cfg)
+{
+    //  A hit on no TDC breaks the pair chain, as it does in the buffered
+    //  pair walk.
+    if (hit.tdc > 3)
+    {
+        has_last_committed = false;
+        return;
+    }
+    if (slip_cc != 0)
+    {
+        hit.abs_coarse_cc -= static_cast<int64_t>(slip_cc);
+        ++acc.tdc[hit.tdc].n_slipped_hits;
+    }
+    if (has_last_committed)
+    {
+        const double pair_coarse_diff_cc =
+            static_cast<double>(hit.abs_coarse_cc) -
+            static_cast<double>(last_committed.abs_coarse_cc);
+        const double nominal_period = nominal_period_cc(cfg);
+        if (std::abs(pair_coarse_diff_cc - nominal_period) <=
+            cfg.consecutive_pair_tolerance_cc)
+        {
+            const bool fit_period = fit_period_from_data(cfg);
+            system.add_pair(last_committed, hit,
+                            fit_period ? pair_coarse_diff_cc
+                                       : pair_coarse_diff_cc - nominal_period,
+                            fit_period);
+            if (cfg.incremental && n_committed_pairs++ % check_stride == 0)
+            {
+                check_pairs.emplace_back(last_committed, hit);
+                if (check_pairs.size() >=
+                    2 * static_cast<std::size_t>(std::max(1, cfg.incremental_check_pairs)))
+                {
+                    for (std::size_t k = 0; 2 * k < check_pairs.size(); ++k)
+                        check_pairs[k] = check_pairs[2 * k];
+                    check_pairs.resize((check_pairs.size() + 1) / 2);
+                    check_stride *= 2;
+                }
+            }
+        }
+    }
+    last_committed = hit;
+    has_last_committed = true;
+}
+
+void StreamingChannel::flush(const CalibConfigStruct &cfg)
+{
+    if (!window.empty())
+    {
+        std::vector<int> slips(window.size(), 0);
+        for (int tdc = 0; tdc < 4; ++tdc)
+        {
+            decide_tdc(tdc, cfg);
+            for (std::size_t k = 0; k < tdc_positions.size(); ++k)
+                slips[tdc_positions[k]] = tdc_slips[k];
+        }
+        for (std::size_t idx = 0; idx < window.size(); ++idx)
+            commit(window[idx], slips[idx], cfg);
+        window.clear();
+    }
+    has_last_committed = false;
+}
+
+void StreamingChannel::add(const ChannelHit &hit, int spill, const CalibConfigStruct &cfg)
+{
+    //  Pairs never straddle a spill boundary.
+    if (spill != spill_idx)
+    {
+        flush(cfg);
+        spill_idx = spill;
+        has_last_raw = false;
+    }
+
+    ++acc.total_hits;
+    const bool valid_tdc = hit.tdc < 4;
+    if (valid_tdc)
+    {
+        ++acc.tdc[hit.tdc].n_hits;
+        fine_min_per_tdc[hit.tdc] = std::min<int>(fine_min_per_tdc[hit.tdc], hit.fine);
+        fine_max_per_tdc[hit.tdc] = std::max<int>(fine_max_per_tdc[hit.tdc], hit.fine);
+    }
+    if (valid_tdc && has_last_raw)
+    {
+        const double pair_coarse_diff_cc =
+            static_cast<double>(hit.abs_coarse_cc) -
+            static_cast<double>(last_raw.abs_coarse_cc);
+        const double nominal_period = nominal_period_cc(cfg);
+        fill_cdiff_hists(acc, pair_coarse_diff_cc, nominal_period);
+        if (std::abs(pair_coarse_diff_cc - nominal_period) <=
+            cfg.consecutive_pair_tolerance_cc)
+        {
+            accepted_diff_sum_cc += pair_coarse_diff_cc;
+            ++accepted_diff_count;
+        }
+    }
+    last_raw = hit;
+    has_last_raw = valid_tdc;
+
+    const std::size_t max_window = window_size(cfg);
+    if (max_window == 0)
+    {
+        commit(hit, 0, cfg);
+        return;
+    }
+    window.push_back(hit);
+    if (window.size() <= max_window)
+        return;
+    //  The oldest hit leaves: decide it against the hits of its
+    //  TDC that followed it.  It is the first of its TDC in the
+    //  window, so its slip is tdc_slips[0].  A hit on no TDC only
+    //  breaks the pair chain (see `commit`).
+    int slip_cc = 0;
+    if (window.front().tdc < 4)
+    {
+        decide_tdc(window.front().tdc, cfg);
+        slip_cc = tdc_slips.empty() ? 0 : tdc_slips.front();
+    }
+    commit(window.front(), slip_cc, cfg);
+    window.pop_front();
+}
+
+ChannelResult StreamingChannel::solve(const ChannelKey &channel_key, const CalibConfigStruct &cfg)
+{
+    flush(cfg);
+    ChannelResult result = std::move(acc);
+    result.key = channel_key;
+    if (result.total_hits < cfg.min_hits_per_tdc * 4)
+        return result;
+
+    bool slope_guard_fired[4];
+    slope_guard_mask(fine_min_per_tdc, fine_max_per_tdc, cfg, slope_guard_fired);
+    double pinned_slope[4];
+    pinned_slopes(prior, cfg, pinned_slope);
+    result.n_pairs_used = system.n_pairs;
+    if (system.n_pairs == 0)
+        return result;
+    NormalEquations constrained = system;
+    double fitted_params[NUM_FIT_PARAMS] = {};
+    result.converged = solve_constrained(constrained, slope_guard_fired, pinned_slope,
+                                         cfg, fitted_params);
+    if (!result.converged)
+        return result;
+
+    //  chi² from the unconstrained sums.  Pinned parameters enter
+    //  at their pinned value; with a fixed period the T column is
+    //  empty and drops out.
+    double x_dot_rhs = 0.0;
+    double x_matrix_x = 0.0;
+    for (int row = 0; row < NUM_FIT_PARAMS; ++row)
+    {
+        x_dot_rhs += fitted_params[row] * system.rhs[row];
+        for (int col = 0; col < NUM_FIT_PARAMS; ++col)
+            x_matrix_x += fitted_params[row] *
+                          system.matrix[row * NUM_FIT_PARAMS + col] *
+                          fitted_params[col];
+    }
+    const double total_chi2 =
+        std::max(0.0, system.target_sum_squared - 2.0 * x_dot_rhs + x_matrix_x);
+    result.chi2_per_pair = total_chi2 / static_cast<double>(system.n_pairs);
+    result.T_cc = fit_period_from_data(cfg) ? fitted_params[PERIOD_PARAM_IDX]
+                                            : nominal_period_cc(cfg);
+    publish_tdc_params(result, fitted_params, slope_guard_fired, pinned_slope, cfg);
+    return result;
+}
+
+} // namespace btana::pulser_calib
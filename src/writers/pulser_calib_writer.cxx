@@ -25,9 +25,10 @@
  *    TDC's fine span is below the guard, pin T at the operator's
  *    fixed period (or leave free), then Cholesky-solve the symmetric
  *    positive-definite normal equations.  No iteration, no
- *    convergence concept, ~µs per channel, ~10-thread parallel via
- *    `std::async` batching.  See `solve_spd<N>` and `pin_parameter<N>`
- *    at the top of this file.
+ *    convergence concept, ~µs per channel, parallel via one worker
+ *    slot per pool thread pulling channels off an atomic cursor.  The
+ *    fit itself (`fit_channel`, `StreamingChannel`) lives in
+ *    `writers/pulser_calib/channel_fit.h`.
  *
  *  - **Slip correction (regime 2).**  After the first solve, hits
  *    whose within-pulse phase deviates from the per-(spill, TDC)
@@ -41,6 +42,19 @@
  *    include/writers/DISCUSSION.md for the open questions on the slip
  *    detector and the half-integer satellite mystery.
  *
+ *  - **Streaming accumulation (opt-in).**  With
+ *    `cfg.streaming_accumulation` no hit is buffered: StreamingChannel
+ *    folds each pair into the channel's normal equations on arrival and
+ *    holds only a rolling window of hits for the slip decision.  The
+ *    anchor FIFO is read first so the pair filter's period and the
+ *    anchor-Δ store are settled before the channel FIFOs stream in.
+ *
+ *  - **Incremental update (opt-in).**  With `cfg.incremental` the
+ *    previous calibration is read back as per-channel priors; a cheap
+ *    χ² check on a pair subsample decides which channels are refitted,
+ *    the rest keep their prior and are merged into the output.  Only
+ *    the fit is saved: every FIFO is still read in full.
+ *
  *  - **No rollover correction.**  Each channel's hits all come from
  *    one stream; `get_coarse_global_time() = coarse + rollover ·
  *    rollover_period` is exact intrinsically.  The framer's
@@ -48,12 +62,14 @@
  *    not used here.
  *
  * Output `fine_calib.toml` is the TOML v3 schema (`[[entry]]` table
- * with `key / method / a / minus_b / sigma`); downstream consumers
+ * with `key / method / a / minus_b / sigma`, plus `provenance / origin`
+ * for the record); downstream consumers
  * read via `AlcorFinedata::read_calib_from_file`.  The legacy `.txt`
  * format was retired in task #172.
  */
 
 #include "writers/pulser_calib.h"
+#include "writers/pulser_calib/channel_fit.h"
 #include "writers/anchor_dt_canvas.h"
 #include "mapping.h"
 #include "utility/conf_path.h"
@@ -66,6 +82,8 @@
 #include "utility/config_reader.h"
 #include "utility/global_index.h"
 #include "utility/qa_publish.h"
+#include "utility/task_pool.h"
+#include "utility/toml_utils.h"
 
 #include <TCanvas.h>
 #include <TF1.h>
@@ -86,11 +104,12 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
-#include <future>
 #include <map>
 #include <memory>
 #include <numeric>
@@ -105,55 +124,24 @@ namespace btana
 namespace
 {
 
+using ::btana::pulser_calib::CDIFF_WIDE_BINS;
+using ::btana::pulser_calib::CDIFF_ZOOM_BINS;
+using ::btana::pulser_calib::ChannelBucket;
+using ::btana::pulser_calib::ChannelHit;
+using ::btana::pulser_calib::ChannelKey;
+using ::btana::pulser_calib::ChannelPrior;
+using ::btana::pulser_calib::ChannelResult;
+using ::btana::pulser_calib::fill_cdiff_hists;
+using ::btana::pulser_calib::fit_channel;
+using ::btana::pulser_calib::fit_period_from_data;
+using ::btana::pulser_calib::nominal_period_cc;
+using ::btana::pulser_calib::SpillBucket;
+using ::btana::pulser_calib::StreamingChannel;
+
 constexpr double CC_TO_NS = 3.125; ///< 320 MHz → 3.125 ns/cc.  Matches BTANA_ALCOR_CC_TO_NS upstream.
 //  Slope-fit guard threshold and fallback slope come from
 //  CalibConfigStruct (configurable via conf/calib/calibration_conf.toml).
 
-// ---------------------------------------------------------------------------
-//  Channel addressing.  A physical channel is (device, chip, eo_channel).
-//  Per channel, the 4 TDCs are distinguished by `tdc ∈ {0,1,2,3}`.
-// ---------------------------------------------------------------------------
-
-struct ChannelKey
-{
-    int device;
-    int chip;
-    int eo_channel;
-
-    bool operator<(const ChannelKey &o) const noexcept
-    {
-        return std::tie(device, chip, eo_channel) <
-               std::tie(o.device, o.chip, o.eo_channel);
-    }
-    bool operator==(const ChannelKey &o) const noexcept
-    {
-        return device == o.device && chip == o.chip && eo_channel == o.eo_channel;
-    }
-};
-
-struct ChannelHit
-{
-    int64_t abs_coarse_cc; ///< get_coarse_global_time(), int64 to be safe
-    uint8_t fine;          ///< raw fine bin
-    uint8_t tdc;           ///< 0..3
-};
-
-//  Per-channel data is bucketed by spill: `get_coarse_global_time()`
-//  is monotonic within a spill (rollover counter increments cleanly)
-//  but jumps unpredictably across spills (different starting rollover
-//  reference per stream / spill).  Per-spill fits + cross-spill
-//  aggregation handle this without needing cross-spill rollover
-//  resolution.
-struct SpillBucket
-{
-    std::vector<ChannelHit> hits;
-};
-struct ChannelBucket
-{
-    //  Sparse — only spills where the channel saw at least one hit.
-    std::vector<SpillBucket> per_spill;
-};
-
 //  Anchor reference signal (e.g. the KC705 testpulse) read out by ALCOR on a
 //  dedicated FIFO.  It carries only a coarse counter — `tdc/fine/pixel/column`
 //  are all sentinel (-1), so it has NO valid channel ordinal and cannot live
@@ -168,675 +156,277 @@ struct AnchorBucket
 };
 
 // ---------------------------------------------------------------------------
-//  Per-channel fit — CLOSED-FORM linear least squares.
-//
-//  For each consecutive same-spill hit pair (p → h) the residual is
-//
-//      r = (c_h − c_p) − (θ_{t_h} − θ_{t_p}) − (f_h · a_{t_h} − f_p · a_{t_p}) − T
-//
-//  which is LINEAR in every unknown (4 offsets θ, 4 slopes a, period T).
-//  Per-spill phase cancels in the difference — no mod-T trick, no
-//  cross-spill stitching, no rollover correction beyond what
-//  `get_coarse_global_time()` already does.
-//
-//  Stacking one row per pair gives  A · x = y  with
-//
-//      x = [θ_0, θ_1, θ_2, θ_3, a_0, a_1, a_2, a_3, T]
-//      y_k = c_h − c_p             (T column absorbs the constant; or
-//                                   y_k = c_h − c_p − T_fixed when T
-//                                   is fixed by the operator and the
-//                                   T column is dropped)
-//
-//      A_k[t]    = +1 if t = t_h, −1 if t = t_p     (offsets)
-//      A_k[t+4]  = +f_h if t = t_h, −f_p if t = t_p (slopes)
-//      A_k[8]    = −1                               (period, when free)
+//  Store of the FIFO-salvage anchor-Δ diagnostic.
 //
-//  Solution comes from the normal equations  Aᵀ A x = Aᵀ y, an
-//  N×N (N=8 or 9) symmetric positive-definite system in-place
-//  Cholesky-solved per channel.  No iteration, no convergence
-//  concept, ~µs per channel.  No shared global state → trivially
-//  parallel across channels.
-//
-//  Gauge fix on θ_0 = 0 implemented by zeroing row/col 0 and pinning
-//  the diagonal to 1 (constraint x_0 = 0).  Per-TDC slope guard
-//  (insufficient fine-bin span) implemented the same way: pin
-//  a_t = default_slope, eliminate from the system, re-solve.
-//
-//  Safety filter on coarse pair gap (only |c_h − c_p − T_nominal| <
-//  tolerance contributes) catches missed-pulse jumps, spill-boundary
-//  slip-throughs, DAQ glitches.
+//  Each channel hit is referenced to the NEAREST anchor pulse of its
+//  spill: Δt = channel_coarse − nearest_anchor_coarse.  Δt is kept as
+//  1-cc count histograms over the nearest-pulse range ±dt_win (per
+//  pixel, and per (spill, Δt) for the Δt-vs-spill 2D), so the
+//  footprint follows the channel count and the pulser period, not the
+//  number of hits.  Filled from the channel buckets in buffered mode
+//  and on arrival in streaming mode.
 // ---------------------------------------------------------------------------
-
-//  ── c_h − c_p diagnostic histogram bins ────────────────────────
-//  Per-channel arrays of counts populated by fit_channel before the
-//  safety filter is applied.  Summed across channels at writer time
-//  into ROOT TH1Fs.  Done with raw fixed-size arrays (instead of
-//  TH1F per channel) so the per-channel work is allocation-free and
-//  the parallel fit loop has no ROOT-object-construction contention.
-//
-//  ZOOM hist: ±1000 cc around T_nominal, 1 cc bins → shows the
-//      tightness of the 1T peak.  Bin index 0 corresponds to
-//      T_nominal − 1000.
-//  WIDE hist: [0, 5T_nominal], T_nominal/64 ≈ 5000 cc bins → shows
-//      multi-T leakage (2T, 3T peaks).
-constexpr int CDIFF_ZOOM_BINS = 2001; // [T-1000, T+1000], 1 cc/bin
-constexpr int CDIFF_WIDE_BINS = 320;  // [0, 5T], T/64 cc/bin
-
-struct ChannelResult
+struct AnchorDtStore
 {
-    ChannelKey key;
-    double T_cc = 0.0;          ///< fitted pulser period (or fixed value)
-    double chi2_per_pair = 0.0; ///< final chi²/N for QA
-    long total_hits = 0;
-    long n_pairs_used = 0;
-    long n_pairs_seen = 0;  ///< pairs visited BEFORE the safety filter
-    bool ok = false;        ///< solver succeeded AND ≥1 TDC met threshold
-    bool converged = false; ///< Cholesky succeeded (matrix SPD)
-    struct PerTdcOut
+    struct Pixel
     {
-        bool fitted = false;
-        double a = 0.0;       ///< slope cc/bin
-        double b = 0.0;       ///< offset cc (b[0] fixed to gauge value)
-        double sigma_a = 0.0; ///< placeholder (not yet propagated)
-        double sigma_b = 0.0;
-        long n_hits = 0;         ///< total hits on this TDC across all spills
-        long n_slipped_hits = 0; ///< hits re-snapped by the slip-correction pass
+        std::vector<uint32_t> counts; ///< index Δt + dt_win
+        long n_in_window = 0;
+        int spill_idx = -1;    ///< afterpulse-veto state: spill of last_kept
+        int64_t last_kept = 0; ///< coarse of the last kept hit
     };
-    PerTdcOut tdc[4]{};
-    //  Diagnostic histograms — see comment above.
-    std::array<long, CDIFF_ZOOM_BINS> cdiff_zoom{};
-    std::array<long, CDIFF_WIDE_BINS> cdiff_wide{};
+    int dt_win = 250;
+    std::map<ChannelKey, Pixel> per_pixel;
+    std::map<std::pair<int, int>, long> per_spill_dt; ///< (spill, Δt) → hits
+    long n_pairs = 0;      ///< (hit, nearest pulse) pairs after the veto
+    long n_ap_vetoed = 0;  ///< hits vetoed as afterpulses
+    long n_ap_primary = 0; ///< hits kept (first in their 100 ns window)
+
+    //  `anchors` = the spill's anchor-pulse coarse times.  The list is
+    //  strictly monotonic (rollover increments cleanly →
+    //  get_coarse_global_time() never decreases; verified), so it is
+    //  already sorted and a binary search finds the nearest.
+    void add(const ChannelKey &key, int spill, int64_t tc,
+             const std::vector<int64_t> &anchors)
+    {
+        auto &pixel = per_pixel[key];
+        //  Afterpulse veto: keep the FIRST hit of each 100 ns window,
+        //  drop any later same-channel hit within 100 ns of it (it is
+        //  an afterpulse).  Hits are in FIFO/time order.
+        constexpr int64_t kVetoCc = 32; // 100 ns / 3.125 ns-per-cc
+        if (pixel.spill_idx != spill)
+        {
+            pixel.spill_idx = spill;
+            pixel.last_kept = -1000000000; // first hit always kept
+        }
+        if (tc - pixel.last_kept < kVetoCc)
+        {
+            ++n_ap_vetoed; // afterpulse — excluded from all plots
+            return;
+        }
+        pixel.last_kept = tc;
+        ++n_ap_primary;
+        const auto it = std::lower_bound(anchors.begin(), anchors.end(), tc);
+        int64_t nearest;
+        if (it == anchors.begin())
+            nearest = anchors.front();
+        else if (it == anchors.end())
+            nearest = anchors.back();
+        else
+        {
+            const int64_t hi = *it, lo = *(it - 1);
+            nearest = (tc - lo <= hi - tc) ? lo : hi;
+        }
+        const int64_t dt = tc - nearest;
+        //  Both the 2D (Δt vs spill) and the 1D are filled post-loop
+        //  AFTER the delay is known, so the peak is recentred into the
+        //  window in both.
+        if (dt >= -dt_win && dt <= dt_win)
+        {
+            if (pixel.counts.empty())
+                pixel.counts.assign(2 * dt_win + 1, 0);
+            ++pixel.counts[dt + dt_win];
+            ++pixel.n_in_window;
+            ++per_spill_dt[{spill, static_cast<int>(dt)}];
+        }
+        ++n_pairs;
+    }
 };
 
-//  ── Tiny symmetric positive-definite solver ─────────────────────
-//  Cholesky factorisation of the N×N normal-equations matrix
-//  (row-major), then forward + back substitution to solve
-//  `normal_matrix · solution = rhs`.  Returns false if the matrix
-//  is not positive-definite (degenerate / rank-deficient).
+// ---------------------------------------------------------------------------
+//  Incremental calibration (`cfg.incremental`).
 //
-//  N is small (≤9 here), so the cache-friendly hand-rolled triple
-//  loop beats calling out to ROOT/Eigen/BLAS in both runtime and
-//  link surface — and the lack of shared global state is what
-//  lets the per-channel outer loop go parallel.
-template <int N>
-inline bool solve_spd(const double normal_matrix[N * N],
-                      const double rhs[N],
-                      double solution[N])
+//  The previous fine_calib.toml is read back as one ChannelPrior per
+//  channel.  Before a channel is fitted, its prior is tested on an
+//  evenly spread sample of the channel's new consecutive pairs: the
+//  per-pair residual r of the fit model above, evaluated at the
+//  prior's (a, b), with T the fixed period or — when T is free — the
+//  sample mean.  Pairs whose residual sits on a non-zero integer cc
+//  (slip candidates, same rule as `decide_slips`) are left out.  The
+//  channel keeps its prior unless
+//    - a TDC above `min_hits_per_tdc` has no prior entry, or
+//    - χ²/pair on the sample exceeds `incremental_chi2_ratio` × the
+//      published σ² (floored, so a near-perfect prior fit does not make
+//      every channel "diverge").
+//  A channel with too few sampled pairs to test keeps its prior: the
+//  new data has nothing to say about it.  Kept channels skip the fit
+//  entirely.  The FIFOs are still read in full — the check needs the
+//  new pairs of every channel — so the saving is in the fit, not in
+//  the I/O.
+// ---------------------------------------------------------------------------
+using HitPair = std::pair<ChannelHit, ChannelHit>;
+
+//  Read the prior calibration.  Entries without an `origin` key (files
+//  written before provenance was recorded) are attributed to
+//  `fallback_origin`.  Returns an empty map when the file cannot be read;
+//  the caller then falls back to a full calibration.
+std::map<ChannelKey, ChannelPrior> load_priors(const std::string &path,
+                                               const std::string &fallback_origin)
 {
-    //  Step 1 — Cholesky factorisation: normal_matrix = L · Lᵀ
-    //  with L lower-triangular, stored in `cholesky_lower`.
-    double cholesky_lower[N * N] = {};
-    for (int row = 0; row < N; ++row)
+    std::map<ChannelKey, ChannelPrior> priors;
+    toml::table parsed;
+    try
     {
-        for (int col = 0; col <= row; ++col)
-        {
-            double partial_sum = normal_matrix[row * N + col];
-            for (int inner = 0; inner < col; ++inner)
-                partial_sum -= cholesky_lower[row * N + inner] *
-                               cholesky_lower[col * N + inner];
-            if (row == col)
-            {
-                //  Diagonal must be strictly positive — failure
-                //  signals non-positive-definite input (degenerate
-                //  / rank-deficient channel).
-                if (partial_sum <= 0.0)
-                    return false;
-                cholesky_lower[row * N + row] = std::sqrt(partial_sum);
-            }
-            else
-                cholesky_lower[row * N + col] =
-                    partial_sum / cholesky_lower[col * N + col];
-        }
+        parsed = toml_parse_with_cutoff(path);
     }
-
-    //  Step 2 — forward substitution: L · forward_subst_result = rhs.
-    double forward_subst_result[N];
-    for (int row = 0; row < N; ++row)
+    catch (const std::exception &err)
     {
-        double partial_sum = rhs[row];
-        for (int inner = 0; inner < row; ++inner)
-            partial_sum -= cholesky_lower[row * N + inner] *
-                           forward_subst_result[inner];
-        forward_subst_result[row] =
-            partial_sum / cholesky_lower[row * N + row];
+        mist::logger::warning("(pulser_calib_writer) cannot read prior calibration '" +
+                              path + "': " + err.what());
+        return priors;
     }
-
-    //  Step 3 — back substitution: Lᵀ · solution = forward_subst_result.
-    for (int row = N - 1; row >= 0; --row)
+    const auto *entries = parsed["entry"].as_array();
+    if (!entries)
+        return priors;
+    for (const auto &node : *entries)
     {
-        double partial_sum = forward_subst_result[row];
-        for (int inner = row + 1; inner < N; ++inner)
-            partial_sum -= cholesky_lower[inner * N + row] * solution[inner];
-        solution[row] = partial_sum / cholesky_lower[row * N + row];
+        const auto *entry = node.as_table();
+        if (!entry)
+            continue;
+        const auto key = (*entry)["key"].value<int64_t>();
+        const auto a = (*entry)["a"].value<double>();
+        const auto minus_b = (*entry)["minus_b"].value<double>();
+        const auto sigma = (*entry)["sigma"].value<double>();
+        if (!key || !a || !minus_b || !sigma)
+            continue;
+        const ::GlobalIndex gi(static_cast<uint32_t>(*key));
+        auto &prior = priors[ChannelKey{gi.device(), gi.chip(), gi.channel()}];
+        prior.present[gi.tdc()] = true;
+        prior.a[gi.tdc()] = *a;
+        prior.b[gi.tdc()] = -*minus_b;
+        prior.sigma = *sigma;
+        prior.origin = (*entry)["origin"].value_or(fallback_origin);
     }
-    return true;
+    return priors;
 }
 
-//  Pin the `param_idx`-th unknown at `pinned_value` in a
-//  symmetric-positive-definite system `normal_matrix · x = rhs`,
-//  preserving SPD after the substitution.  Used for the gauge fix
-//  (θ_0 = 0), the slope guard, and the fixed-period case.
-//
-//  Algorithm: move the pinned column's contribution to the RHS,
-//  zero the pinned row and column, set the pinned diagonal to 1,
-//  and set rhs[param_idx] = pinned_value.  The solver then returns
-//  `solution[param_idx] = pinned_value` and the remaining unknowns
-//  consistent with the pin.
-template <int N>
-inline void pin_parameter(double normal_matrix[N * N], double rhs[N],
-                          int param_idx, double pinned_value)
-{
-    //  1. Move the pinned column's contribution to the RHS.
-    for (int row = 0; row < N; ++row)
-        rhs[row] -= normal_matrix[row * N + param_idx] * pinned_value;
-    //  2. Zero the pinned row...
-    for (int col = 0; col < N; ++col)
-        normal_matrix[param_idx * N + col] = 0.0;
-    //  3. ...and the pinned column.
-    for (int row = 0; row < N; ++row)
-        normal_matrix[row * N + param_idx] = 0.0;
-    //  4. Pin the diagonal so the solver returns `pinned_value`.
-    normal_matrix[param_idx * N + param_idx] = 1.0;
-    rhs[param_idx] = pinned_value;
-}
-
-ChannelResult fit_channel(const ChannelKey &channel_key, ChannelBucket bucket,
-                          const CalibConfigStruct &cfg)
+//  Every k-th raw consecutive pair passing the safety filter, k chosen
+//  so about `incremental_check_pairs` come out spread over the run.
+void sample_pairs(const ChannelBucket &bucket, long total_hits,
+                  const CalibConfigStruct &cfg, std::vector<HitPair> &sample)
 {
-    ChannelResult result;
-    result.key = channel_key;
-
-    //  ── Step 1: hit accounting + slope-guard inputs ────────────────
-    //  Count total hits, per-TDC hits, and the per-TDC fine-bin span.
-    //  The fine span feeds the slope guard later: a TDC that saw too
-    //  few distinct fine bins has no lever arm for its slope fit and
-    //  is pinned to the default.
-    long hits_per_tdc[4] = {0, 0, 0, 0};
-    int fine_min_per_tdc[4] = {256, 256, 256, 256};
-    int fine_max_per_tdc[4] = {-1, -1, -1, -1};
-    for (auto &spill_bucket : bucket.per_spill)
-        for (const auto &hit : spill_bucket.hits)
-        {
-            ++result.total_hits;
-            if (hit.tdc < 4)
-            {
-                ++hits_per_tdc[hit.tdc];
-                const int fine_bin = static_cast<int>(hit.fine);
-                if (fine_bin < fine_min_per_tdc[hit.tdc])
-                    fine_min_per_tdc[hit.tdc] = fine_bin;
-                if (fine_bin > fine_max_per_tdc[hit.tdc])
-                    fine_max_per_tdc[hit.tdc] = fine_bin;
-            }
-        }
-    for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
-        result.tdc[tdc_idx].n_hits = hits_per_tdc[tdc_idx];
-
-    if (result.total_hits < cfg.min_hits_per_tdc * 4)
-        return result;
-
-    //  ── Step 2: pulser-period setup ────────────────────────────────
-    //  TOML knob > 0 ⇒ operator pins the period (e.g. 320000 cc for a
-    //  1 kHz pulser at 320 MHz).  Otherwise leave the period as a
-    //  free 9th fit parameter for a blind detector-level estimate.
-    const bool fit_period_from_data = !(cfg.pulser_period_cc > 0.0);
-    const double nominal_period_cc =
-        cfg.pulser_period_cc > 0.0 ? cfg.pulser_period_cc : 320000.0;
-
-    //  ── Step 3: build the normal-equations system ──────────────────
-    //  Parameters (unknowns) of the per-channel fit, in fixed order:
-    //      index 0..3   per-TDC offsets    θ_t   (cc)
-    //      index 4..7   per-TDC slopes     a_t   (cc per fine bin)
-    //      index 8      pulser period      T     (cc)
-    //  Total of 9 unknowns — fixed by the architecture.
-    constexpr int NUM_FIT_PARAMS = 9;
-    static constexpr int OFFSET_PARAM_BASE = 0; // θ_t lives at index t
-    static constexpr int SLOPE_PARAM_BASE = 4;  // a_t lives at index t + 4
-    static constexpr int PERIOD_PARAM_IDX = 8;
-    //  At most 5 unknowns per pair row contribute (2 offsets + 2
-    //  slopes + 1 period).  We accumulate Aᵀ·A and Aᵀ·y as a sparse
-    //  rank-1 update per pair — O(25) flops per pair, no inner-loop
-    //  allocation.
-    static constexpr int MAX_NONZEROS_PER_PAIR_ROW = 5;
-
-    double normal_matrix[NUM_FIT_PARAMS * NUM_FIT_PARAMS] = {};
-    double rhs_vector[NUM_FIT_PARAMS] = {};
-    long pair_count_used = 0;             // pairs that pass the safety filter
-    double pair_target_sum_squared = 0.0; // accumulated Σ y² for chi² recovery
-
-    //  build_normal_equations — assemble (normal_matrix, rhs_vector,
-    //  pair_count_used, pair_target_sum_squared) from the current
-    //  state of bucket.per_spill[*].hits[*].abs_coarse_cc.  Called
-    //  twice in the slip-aware path: once on the raw coarse counts
-    //  (first pass) and once on the slip-corrected counts (second
-    //  pass).  `fill_diag_hists` is true only on the first pass so
-    //  the as-observed pair-coarse-difference diagnostic histograms
-    //  reflect what the data looked like before any correction.
-    auto build_normal_equations = [&](bool fill_diag_hists)
+    sample.clear();
+    const long stride =
+        std::max<long>(1, total_hits / std::max(1, cfg.incremental_check_pairs));
+    const double nominal_period = nominal_period_cc(cfg);
+    long n_candidates = 0;
+    for (const auto &spill_bucket : bucket.per_spill)
     {
-        std::fill_n(normal_matrix, NUM_FIT_PARAMS * NUM_FIT_PARAMS, 0.0);
-        std::fill_n(rhs_vector, NUM_FIT_PARAMS, 0.0);
-        pair_count_used = 0;
-        pair_target_sum_squared = 0.0;
-        for (const auto &spill_bucket : bucket.per_spill)
+        const auto &hits = spill_bucket.hits;
+        for (std::size_t hit_idx = 1; hit_idx < hits.size(); ++hit_idx)
         {
-            const auto &hits = spill_bucket.hits;
-            if (hits.size() < 2)
+            if (n_candidates++ % stride != 0)
                 continue;
-            for (std::size_t hit_idx = 1; hit_idx < hits.size(); ++hit_idx)
-            {
-                const auto &prev_hit = hits[hit_idx - 1];
-                const auto &curr_hit = hits[hit_idx];
-                if (prev_hit.tdc > 3 || curr_hit.tdc > 3)
-                    continue;
-                const double pair_coarse_diff_cc =
-                    static_cast<double>(curr_hit.abs_coarse_cc) -
-                    static_cast<double>(prev_hit.abs_coarse_cc);
-
-                //  Diagnostic histograms — filled BEFORE the safety
-                //  filter so they show what's being rejected too.
-                if (fill_diag_hists)
-                {
-                    ++result.n_pairs_seen;
-                    const double cdiff_relative_to_zoom_lo =
-                        pair_coarse_diff_cc - (nominal_period_cc - 1000.0);
-                    const int zoom_bin = static_cast<int>(
-                        std::floor(cdiff_relative_to_zoom_lo));
-                    if (zoom_bin >= 0 && zoom_bin < CDIFF_ZOOM_BINS)
-                        ++result.cdiff_zoom[zoom_bin];
-                    const double wide_bin_width_cc = nominal_period_cc / 64.0;
-                    const int wide_bin = static_cast<int>(
-                        std::floor(pair_coarse_diff_cc / wide_bin_width_cc));
-                    if (wide_bin >= 0 && wide_bin < CDIFF_WIDE_BINS)
-                        ++result.cdiff_wide[wide_bin];
-                }
-
-                //  Safety filter: pair must look like one pulser
-                //  period.  Multi-T missed-pulse jumps, spill-boundary
-                //  leaks, glitches are rejected here.
-                if (std::abs(pair_coarse_diff_cc - nominal_period_cc) >
-                    cfg.consecutive_pair_tolerance_cc)
-                    continue;
-
-                //  Build the sparse A-row for this pair.  The model
-                //  says:  pair_coarse_diff_cc =
-                //         T + (θ_curr − θ_prev)
-                //           + (fine_curr · a_curr − fine_prev · a_prev)
-                //  Each contribution is one nonzero column entry.
-                int sparse_col_indices[MAX_NONZEROS_PER_PAIR_ROW];
-                double sparse_col_values[MAX_NONZEROS_PER_PAIR_ROW];
-                int num_nonzeros = 0;
-
-                //  Offsets: contribute only when the two hits are on
-                //  different TDCs (otherwise θ_curr − θ_prev = 0).
-                if (curr_hit.tdc != prev_hit.tdc)
-                {
-                    sparse_col_indices[num_nonzeros] =
-                        OFFSET_PARAM_BASE + curr_hit.tdc;
-                    sparse_col_values[num_nonzeros] = +1.0;
-                    ++num_nonzeros;
-                    sparse_col_indices[num_nonzeros] =
-                        OFFSET_PARAM_BASE + prev_hit.tdc;
-                    sparse_col_values[num_nonzeros] = -1.0;
-                    ++num_nonzeros;
-                }
-                //  Slopes: always two entries (+f_curr, -f_prev).
-                //  For same-TDC pairs they both fall on the same
-                //  slope column and the rank-1 update collapses them
-                //  automatically.
-                sparse_col_indices[num_nonzeros] =
-                    SLOPE_PARAM_BASE + curr_hit.tdc;
-                sparse_col_values[num_nonzeros] =
-                    +static_cast<double>(curr_hit.fine);
-                ++num_nonzeros;
-                sparse_col_indices[num_nonzeros] =
-                    SLOPE_PARAM_BASE + prev_hit.tdc;
-                sparse_col_values[num_nonzeros] =
-                    -static_cast<double>(prev_hit.fine);
-                ++num_nonzeros;
-                //  Period: only when T is a free parameter.  Row
-                //  entry −1 because the model has +T on the RHS that
-                //  we move to the LHS.
-                if (fit_period_from_data)
-                {
-                    sparse_col_indices[num_nonzeros] = PERIOD_PARAM_IDX;
-                    sparse_col_values[num_nonzeros] = -1.0;
-                    ++num_nonzeros;
-                }
-
-                //  Target y.  When T is free, the period column
-                //  absorbs the constant; when fixed, we move T to the
-                //  target.
-                const double pair_target_cc = fit_period_from_data
-                                                  ? pair_coarse_diff_cc
-                                                  : (pair_coarse_diff_cc - nominal_period_cc);
-
-                //  Rank-1 update of Aᵀ·A and Aᵀ·y.
-                for (int outer = 0; outer < num_nonzeros; ++outer)
-                {
-                    rhs_vector[sparse_col_indices[outer]] +=
-                        sparse_col_values[outer] * pair_target_cc;
-                    for (int inner = 0; inner < num_nonzeros; ++inner)
-                        normal_matrix[sparse_col_indices[outer] * NUM_FIT_PARAMS +
-                                      sparse_col_indices[inner]] +=
-                            sparse_col_values[outer] *
-                            sparse_col_values[inner];
-                }
-                pair_target_sum_squared += pair_target_cc * pair_target_cc;
-                ++pair_count_used;
-            }
+            const auto &prev_hit = hits[hit_idx - 1];
+            const auto &curr_hit = hits[hit_idx];
+            if (prev_hit.tdc > 3 || curr_hit.tdc > 3)
+                continue;
+            const double pair_coarse_diff_cc =
+                static_cast<double>(curr_hit.abs_coarse_cc) -
+                static_cast<double>(prev_hit.abs_coarse_cc);
+            if (std::abs(pair_coarse_diff_cc - nominal_period) <=
+                cfg.consecutive_pair_tolerance_cc)
+                sample.emplace_back(prev_hit, curr_hit);
         }
-    };
+    }
+}
 
-    //  ── Step 4: slope-guard mask ────────────────────────────────
-    //  Computed from raw hit coverage and stable across the slip
-    //  correction step (slip only shifts coarse, never fine).
-    bool slope_guard_fired[4] = {false, false, false, false};
+//  True when the prior still describes the channel (see the banner).
+//  `counts` carries the per-TDC hit totals of the new data.
+bool prior_holds(const ChannelResult &counts, const ChannelPrior &prior,
+                 const std::vector<HitPair> &sample, const CalibConfigStruct &cfg)
+{
+    constexpr std::size_t MIN_CHECK_PAIRS = 16;
+    constexpr double SIGMA_SQUARED_FLOOR_CC2 = 0.0025;
     for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
+        if (counts.tdc[tdc_idx].n_hits >= cfg.min_hits_per_tdc && !prior.present[tdc_idx])
+            return false;
+
+    //  Residual without T, for every pair both of whose TDCs the prior
+    //  covers.
+    std::vector<double> residuals;
+    residuals.reserve(sample.size());
+    for (const auto &[prev_hit, curr_hit] : sample)
     {
-        const int fine_span = (fine_max_per_tdc[tdc_idx] >= fine_min_per_tdc[tdc_idx])
-                                  ? (fine_max_per_tdc[tdc_idx] - fine_min_per_tdc[tdc_idx] + 1)
-                                  : 0;
-        if (fine_span < cfg.slope_fit_min_fine_span)
-            slope_guard_fired[tdc_idx] = true;
+        if (!prior.present[prev_hit.tdc] || !prior.present[curr_hit.tdc])
+            continue;
+        residuals.push_back(
+            static_cast<double>(curr_hit.abs_coarse_cc - prev_hit.abs_coarse_cc) -
+            (prior.b[curr_hit.tdc] - prior.b[prev_hit.tdc]) -
+            (static_cast<double>(curr_hit.fine) * prior.a[curr_hit.tdc] -
+             static_cast<double>(prev_hit.fine) * prior.a[prev_hit.tdc]));
     }
-
-    //  apply_constraints — pin parameters that the data cannot
-    //  determine on its own.  Called after every
-    //  build_normal_equations() invocation.
-    auto apply_constraints = [&]()
-    {
-        //  Gauge fix: pin θ_0 = 0.  The other θ values become
-        //  intra-channel TDC offsets relative to TDC 0.  Without
-        //  this the system has a one-parameter family of global
-        //  time shifts.
-        pin_parameter<NUM_FIT_PARAMS>(
-            normal_matrix, rhs_vector, OFFSET_PARAM_BASE + 0, 0.0);
-        //  Slope guards: pin slopes for TDCs with too-narrow fine
-        //  coverage to the default.
-        for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
-            if (slope_guard_fired[tdc_idx])
-                pin_parameter<NUM_FIT_PARAMS>(
-                    normal_matrix, rhs_vector,
-                    SLOPE_PARAM_BASE + tdc_idx,
-                    cfg.default_slope_cc_per_bin);
-        //  Period: when fixed by the operator we pin parameter 8 at
-        //  nominal_period_cc.  Required for SPD — otherwise row 8 of
-        //  Aᵀ·A is all zero and Cholesky fails.
-        if (!fit_period_from_data)
-            pin_parameter<NUM_FIT_PARAMS>(
-                normal_matrix, rhs_vector,
-                PERIOD_PARAM_IDX, nominal_period_cc);
-    };
-
-    //  ── Step 5: first-pass solve ────────────────────────────────
-    build_normal_equations(/*fill_diag_hists=*/true);
-    result.n_pairs_used = pair_count_used;
-    if (pair_count_used == 0)
-        return result;
-    apply_constraints();
-    double fitted_params[NUM_FIT_PARAMS] = {};
-    result.converged = solve_spd<NUM_FIT_PARAMS>(
-        normal_matrix, rhs_vector, fitted_params);
-    if (!result.converged)
-        return result;
-
-    //  ── Step 6: intermittent slip correction (regime 2) ─────────
-    //  Known ALCOR quirk: some hits arrive with the coarse counter
-    //  shifted by an integer number of clock cycles.  Two regimes:
-    //
-    //    Regime 1 (whole-TDC permanent slip): every hit on a given
-    //    TDC is shifted by the same integer.  The fit's natural θ_t
-    //    absorbs this — the published calibration is correct without
-    //    any extra correction.  No code path needed here.
-    //
-    //    Regime 2 (intermittent slip mid-run): a fraction of one
-    //    TDC's hits are shifted, the rest aren't.  The single-θ fit
-    //    averages over both populations and is wrong for both.
-    //    Handled here per-hit, per (spill, TDC).
-    //
-    //  Algorithm per (spill, TDC):
-    //    1. For every hit on this TDC in this spill, compute
-    //       calib_time_cc = c − (θ_t + fine · a_t), then reduce
-    //       modulo the pulser period → within_pulse_phase_cc is the
-    //       hit's phase inside one pulser cycle.
-    //    2. Median across THIS TDC's hits in THIS spill is the
-    //       TDC's "true" phase for this spill.  Per-(spill,TDC)
-    //       medianising is essential: pooling across TDCs would
-    //       conflate the intrinsic inter-TDC offsets (cable, ALCOR
-    //       sampling phase) with real slip events.
-    //    3. Per hit, the phase deviation from this median rounds to
-    //       an integer cc → the slip in coarse counter units.
-    //    4. Snap only if the rounded slip is non-zero and the
-    //       deviation sits within `slip_confidence_cc` of that
-    //       integer.  Looser confidence ⇒ over-snaps under the
-    //       natural ~0.5 cc scatter from sub-optimal slope fits.
-    //
-    //  Safety cap (`slip_max_snap_fraction`): if more than this
-    //  fraction of hits in one (spill, TDC) would snap, the
-    //  distribution is too noisy / wide to trust — abort that
-    //  (spill, TDC) and leave its hits untouched.
-    long slipped_hits_per_tdc[4] = {0, 0, 0, 0};
+    if (residuals.size() < MIN_CHECK_PAIRS)
+        return true;
+
+    const double period =
+        fit_period_from_data(cfg)
+            ? std::accumulate(residuals.begin(), residuals.end(), 0.0) /
+                  static_cast<double>(residuals.size())
+            : nominal_period_cc(cfg);
+    double total_chi2 = 0.0;
+    long n_used = 0;
+    for (const double residual_with_period : residuals)
     {
-        const double period_used_cc = fit_period_from_data
-                                          ? fitted_params[PERIOD_PARAM_IDX]
-                                          : nominal_period_cc;
-        const double slip_confidence_thr_cc = cfg.slip_confidence_cc;
-        const double max_snap_fraction = cfg.slip_max_snap_fraction;
-        constexpr std::size_t MIN_HITS_PER_TDC_FOR_MEDIAN = 4;
-
-        //  Reusable scratch buffers — allocated once, reused per
-        //  (spill, TDC).  Outer index is the TDC slot (0..3).
-        std::vector<int> hit_indices_per_tdc[4];
-        std::vector<double> phase_residuals_per_tdc[4];
-        std::vector<double> sorted_phase_residuals_per_tdc[4];
-        bool any_hits_were_snapped = false;
-
-        for (auto &spill_bucket : bucket.per_spill)
-        {
-            if (spill_bucket.hits.empty())
-                continue;
-            for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
-            {
-                hit_indices_per_tdc[tdc_idx].clear();
-                phase_residuals_per_tdc[tdc_idx].clear();
-            }
-            //  Pass 1 — bucket hits into 4 per-TDC lists, compute
-            //  each hit's within-pulse phase.
-            for (std::size_t spill_hit_idx = 0;
-                 spill_hit_idx < spill_bucket.hits.size();
-                 ++spill_hit_idx)
-            {
-                const auto &hit = spill_bucket.hits[spill_hit_idx];
-                if (hit.tdc > 3)
-                    continue;
-                const double calib_time_cc =
-                    static_cast<double>(hit.abs_coarse_cc) -
-                    (fitted_params[OFFSET_PARAM_BASE + hit.tdc] +
-                     static_cast<double>(hit.fine) *
-                         fitted_params[SLOPE_PARAM_BASE + hit.tdc]);
-                const double pulse_number =
-                    std::round(calib_time_cc / period_used_cc);
-                const double within_pulse_phase_cc =
-                    calib_time_cc - pulse_number * period_used_cc;
-                hit_indices_per_tdc[hit.tdc].push_back(
-                    static_cast<int>(spill_hit_idx));
-                phase_residuals_per_tdc[hit.tdc].push_back(
-                    within_pulse_phase_cc);
-            }
-            //  Pass 2 — per TDC, compute the spill's median phase
-            //  and snap, with the safety check on snap fraction.
-            for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
-            {
-                if (phase_residuals_per_tdc[tdc_idx].size() < MIN_HITS_PER_TDC_FOR_MEDIAN)
-                    continue;
-
-                sorted_phase_residuals_per_tdc[tdc_idx] =
-                    phase_residuals_per_tdc[tdc_idx];
-                const auto median_iter =
-                    sorted_phase_residuals_per_tdc[tdc_idx].begin() +
-                    static_cast<std::ptrdiff_t>(
-                        sorted_phase_residuals_per_tdc[tdc_idx].size() / 2);
-                std::nth_element(
-                    sorted_phase_residuals_per_tdc[tdc_idx].begin(),
-                    median_iter,
-                    sorted_phase_residuals_per_tdc[tdc_idx].end());
-                const double phase_median_cc = *median_iter;
-
-                //  First scan — count how many hits would snap
-                //  WITHOUT modifying anything.  If the candidate
-                //  fraction is over the safety cap, abort this
-                //  (spill, TDC) entirely.  Cheap because per-(spill,
-                //  TDC) hit counts are small.
-                long num_snap_candidates = 0;
-                for (std::size_t tdc_local_idx = 0;
-                     tdc_local_idx < phase_residuals_per_tdc[tdc_idx].size();
-                     ++tdc_local_idx)
-                {
-                    const double phase_deviation_cc =
-                        phase_residuals_per_tdc[tdc_idx][tdc_local_idx] -
-                        phase_median_cc;
-                    const int slip_cc_count = static_cast<int>(
-                        std::round(phase_deviation_cc));
-                    if (slip_cc_count != 0 &&
-                        std::abs(phase_deviation_cc -
-                                 static_cast<double>(slip_cc_count)) <
-                            slip_confidence_thr_cc)
-                        ++num_snap_candidates;
-                }
-                const double snap_candidate_fraction =
-                    static_cast<double>(num_snap_candidates) /
-                    static_cast<double>(phase_residuals_per_tdc[tdc_idx].size());
-                if (snap_candidate_fraction > max_snap_fraction)
-                    continue; // distribution too wide — leave hits alone
-
-                //  Safe to apply.
-                for (std::size_t tdc_local_idx = 0;
-                     tdc_local_idx < phase_residuals_per_tdc[tdc_idx].size();
-                     ++tdc_local_idx)
-                {
-                    const double phase_deviation_cc =
-                        phase_residuals_per_tdc[tdc_idx][tdc_local_idx] -
-                        phase_median_cc;
-                    const int slip_cc_count = static_cast<int>(
-                        std::round(phase_deviation_cc));
-                    if (slip_cc_count != 0 &&
-                        std::abs(phase_deviation_cc -
-                                 static_cast<double>(slip_cc_count)) <
-                            slip_confidence_thr_cc)
-                    {
-                        const int spill_hit_idx =
-                            hit_indices_per_tdc[tdc_idx][tdc_local_idx];
-                        spill_bucket.hits[spill_hit_idx].abs_coarse_cc -=
-                            static_cast<int64_t>(slip_cc_count);
-                        ++slipped_hits_per_tdc[tdc_idx];
-                        any_hits_were_snapped = true;
-                    }
-                }
-            }
-        }
-
-        //  ── Step 7: second-pass solve (only if anything snapped) ──
-        //  Diagnostic histograms NOT refilled — they reflect the
-        //  as-observed (pre-correction) pair distribution.
-        if (any_hits_were_snapped)
-        {
-            build_normal_equations(/*fill_diag_hists=*/false);
-            result.n_pairs_used = pair_count_used;
-            if (pair_count_used == 0)
-                return result;
-            apply_constraints();
-            for (int param_idx = 0; param_idx < NUM_FIT_PARAMS; ++param_idx)
-                fitted_params[param_idx] = 0.0;
-            result.converged = solve_spd<NUM_FIT_PARAMS>(
-                normal_matrix, rhs_vector, fitted_params);
-            if (!result.converged)
-                return result;
-        }
-
-        //  Permanent slip (regime 1) needs no special pass — the
-        //  fit's natural θ_t absorbs it.  An earlier implementation
-        //  subtracted the integer-rounded θ from every hit on a
-        //  given TDC and re-fit, producing a "clean" θ ≈ 0 — but the
-        //  published calibration then had no slip information, so
-        //  downstream apply at production time (where the slip is
-        //  still in the hardware) silently went off by the slip
-        //  magnitude.  Removed.
-
-        for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
-            result.tdc[tdc_idx].n_slipped_hits = slipped_hits_per_tdc[tdc_idx];
+        const double residual_cc = residual_with_period - period;
+        const double slip_cc = std::round(residual_cc);
+        if (slip_cc != 0.0 && std::abs(residual_cc - slip_cc) < cfg.slip_confidence_cc)
+            continue;
+        total_chi2 += residual_cc * residual_cc;
+        ++n_used;
     }
+    if (n_used < static_cast<long>(MIN_CHECK_PAIRS))
+        return false; // mostly slip-like residuals — not the prior's channel any more
+    const double sigma_squared = std::max(prior.sigma * prior.sigma, SIGMA_SQUARED_FLOOR_CC2);
+    return total_chi2 / static_cast<double>(n_used) <=
+           cfg.incremental_chi2_ratio * sigma_squared;
+}
 
-    //  ── Step 8: chi² recovery for the residual-sigma report ──────
-    //  In principle chi² = ‖y − A·x‖² = ‖y‖² − xᵀ·Aᵀ·y =
-    //  pair_target_sum_squared − xᵀ·rhs_vector_original.
-    //  Reconstructing the original rhs_vector (before pin_parameter
-    //  modified it) is fiddly; cheaper to walk the pairs once more
-    //  and accumulate the residual directly using the solved
-    //  fitted_params.  Same O(pair_count_used) cost as the build,
-    //  one pass.
-    double total_chi2 = 0.0;
-    const double period_used_cc = fit_period_from_data
-                                      ? fitted_params[PERIOD_PARAM_IDX]
-                                      : nominal_period_cc;
+//  Step-1 accounting and the c_h − c_p histograms of `fit_channel`,
+//  without the fit — for a buffered channel that keeps its prior.
+ChannelResult count_channel(const ChannelKey &channel_key, const ChannelBucket &bucket,
+                            const CalibConfigStruct &cfg)
+{
+    ChannelResult result;
+    result.key = channel_key;
+    const double nominal_period = nominal_period_cc(cfg);
     for (const auto &spill_bucket : bucket.per_spill)
     {
         const auto &hits = spill_bucket.hits;
-        if (hits.size() < 2)
-            continue;
-        for (std::size_t hit_idx = 1; hit_idx < hits.size(); ++hit_idx)
+        for (std::size_t hit_idx = 0; hit_idx < hits.size(); ++hit_idx)
         {
-            const auto &prev_hit = hits[hit_idx - 1];
-            const auto &curr_hit = hits[hit_idx];
-            if (prev_hit.tdc > 3 || curr_hit.tdc > 3)
-                continue;
-            const double pair_coarse_diff_cc =
-                static_cast<double>(curr_hit.abs_coarse_cc) -
-                static_cast<double>(prev_hit.abs_coarse_cc);
-            if (std::abs(pair_coarse_diff_cc - nominal_period_cc) >
-                cfg.consecutive_pair_tolerance_cc)
+            ++result.total_hits;
+            if (hits[hit_idx].tdc < 4)
+                ++result.tdc[hits[hit_idx].tdc].n_hits;
+            if (hit_idx == 0 || hits[hit_idx - 1].tdc > 3 || hits[hit_idx].tdc > 3)
                 continue;
-            const double prev_calib_time_cc =
-                static_cast<double>(prev_hit.abs_coarse_cc) -
-                (fitted_params[OFFSET_PARAM_BASE + prev_hit.tdc] +
-                 static_cast<double>(prev_hit.fine) *
-                     fitted_params[SLOPE_PARAM_BASE + prev_hit.tdc]);
-            const double curr_calib_time_cc =
-                static_cast<double>(curr_hit.abs_coarse_cc) -
-                (fitted_params[OFFSET_PARAM_BASE + curr_hit.tdc] +
-                 static_cast<double>(curr_hit.fine) *
-                     fitted_params[SLOPE_PARAM_BASE + curr_hit.tdc]);
-            const double pair_residual_cc =
-                curr_calib_time_cc - prev_calib_time_cc - period_used_cc;
-            total_chi2 += pair_residual_cc * pair_residual_cc;
+            fill_cdiff_hists(result,
+                             static_cast<double>(hits[hit_idx].abs_coarse_cc) -
+                                 static_cast<double>(hits[hit_idx - 1].abs_coarse_cc),
+                             nominal_period);
         }
     }
-    result.chi2_per_pair =
-        total_chi2 / static_cast<double>(pair_count_used);
-    result.T_cc = period_used_cc;
-
-    //  ── Step 9: publish per-TDC parameters ────────────────────────
-    //  A TDC is published only if it saw at least `min_hits_per_tdc`
-    //  hits.  Below-threshold TDCs are left unfitted and end up in
-    //  the run-summary skipped list.
+    return result;
+}
+
+//  Publish the prior's entries in place of a fit.
+void carry_prior(ChannelResult &result, const ChannelPrior &prior,
+                 const CalibConfigStruct &cfg)
+{
+    result.carried = true;
+    result.converged = true;
+    result.n_pairs_used = 0;
+    result.chi2_per_pair = prior.sigma * prior.sigma;
+    result.T_cc = 0.0; // no period estimate — kept out of the T QA
     for (int tdc_idx = 0; tdc_idx < 4; ++tdc_idx)
     {
-        if (hits_per_tdc[tdc_idx] < cfg.min_hits_per_tdc)
+        if (!prior.present[tdc_idx])
             continue;
         result.tdc[tdc_idx].fitted = true;
-        result.tdc[tdc_idx].b =
-            fitted_params[OFFSET_PARAM_BASE + tdc_idx];
-        result.tdc[tdc_idx].a = slope_guard_fired[tdc_idx]
-                                    ? cfg.default_slope_cc_per_bin
-                                    : fitted_params[SLOPE_PARAM_BASE + tdc_idx];
-        //  Per-TDC residual sigma is not propagated yet — the v2
-        //  consumers don't need it.  Computing it would require the
-        //  per-parameter variance from the Aᵀ·A inverse diagonal,
-        //  feasible but not done here.
-        result.tdc[tdc_idx].sigma_a = 0.0;
-        result.tdc[tdc_idx].sigma_b = 0.0;
+        result.tdc[tdc_idx].a = prior.a[tdc_idx];
+        result.tdc[tdc_idx].b = prior.b[tdc_idx];
         result.ok = true;
     }
-    return result;
 }
 
 // ---------------------------------------------------------------------------
@@ -890,7 +480,10 @@ void pulser_calib_writer(
     int anchor_chip_override,
     int anchor_eo_channel_override,
     int anchor_fifo_override,
-    double pulser_period_cc_override)
+    double pulser_period_cc_override,
+    bool streaming_accumulation,
+    bool incremental,
+    const std::string &incremental_from)
 {
     namespace fs = std::filesystem;
 
@@ -904,6 +497,12 @@ void pulser_calib_writer(
     auto cfg = calib_conf_reader(calib_config_file);
     if (force_rebuild)
         cfg.force_rebuild = true;
+    if (streaming_accumulation)
+        cfg.streaming_accumulation = true;
+    if (incremental)
+        cfg.incremental = true;
+    if (!incremental_from.empty())
+        cfg.incremental_from = incremental_from;
 
     //  CLI-level anchor overrides (≥0 wins over TOML).  Plumbed for the
     //  Run Manager card so an operator can flip the anchor channel
@@ -968,6 +567,14 @@ void pulser_calib_writer(
                               "either clear override_path or pass --force-rebuild.");
         return;
     case CalibPathResolution::Default:
+        //  An incremental update is meant to replace the existing file
+        //  with the merged calibration.
+        if (cfg.incremental)
+        {
+            mist::logger::info("(pulser_calib_writer) --incremental — updating '" +
+                               resolved.path + "' in place.");
+            break;
+        }
         mist::logger::warning("(pulser_calib_writer) default path '" + resolved.path +
                               "' already exists.  Pass --force-rebuild to overwrite.  Bailing.");
         return;
@@ -980,8 +587,34 @@ void pulser_calib_writer(
     }
     const std::string fine_calib_path = resolved.path;
 
+    //  ── Incremental: previous calibration as per-channel priors ───
+    //  Read before the ingest so streaming channels get their seed
+    //  slope on creation.  Missing or unreadable ⇒ full calibration.
+    std::map<ChannelKey, ChannelPrior> priors;
+    if (cfg.incremental)
+    {
+        const std::string prior_path =
+            !cfg.incremental_from.empty() ? cfg.incremental_from : fine_calib_path;
+        if (fs::exists(prior_path))
+            priors = load_priors(prior_path,
+                                 fs::path(prior_path).parent_path().filename().string());
+        if (priors.empty())
+            mist::logger::warning("(pulser_calib_writer) --incremental: no usable prior "
+                                  "calibration at '" +
+                                  prior_path + "' — fitting every channel.");
+        else
+            mist::logger::info(TString::Format(
+                                   "(pulser_calib_writer) --incremental: %zu prior channels from '%s'",
+                                   priors.size(), prior_path.c_str())
+                                   .Data());
+    }
+
     //  ── Phase 1a: serial FIFO read, bucket per channel ────────────
-    const auto fifo_paths = enumerate_fifos(run_dir);
+    //  Buffered (default): every hit is kept per (channel, spill) until
+    //  the fits below.  Streaming (`streaming_accumulation`): hits are
+    //  folded into a StreamingChannel per channel as they are read and
+    //  dropped.
+    auto fifo_paths = enumerate_fifos(run_dir);
     if (fifo_paths.empty())
     {
         mist::logger::error("(pulser_calib_writer) no FIFO files found under " + run_dir);
@@ -990,7 +623,9 @@ void pulser_calib_writer(
     mist::logger::info("(pulser_calib_writer) found " + std::to_string(fifo_paths.size()) +
                        " FIFO files; reading + bucketing per channel");
 
+    const bool streaming = cfg.streaming_accumulation;
     std::map<ChannelKey, ChannelBucket> channels;
+    std::map<ChannelKey, StreamingChannel> streaming_channels;
     AnchorBucket anchor;        //  salvaged (device, anchor_fifo) reference pulses
     long total_anchor_hits = 0; //  count of salvaged anchor pulses
     long total_hits_read = 0;
@@ -999,13 +634,45 @@ void pulser_calib_writer(
     const int fine_lo = cfg.fine_min_valid;
     const int fine_hi = cfg.fine_max_valid;
 
-    for (const auto &path : fifo_paths)
+    //  Streaming folds hits in as they arrive, so everything the pair
+    //  filter and the anchor-Δ store need must be settled first: read
+    //  the anchor FIFO before the channel FIFOs, derive the cadence,
+    //  then stream the rest.  Buffered reads everything up front.
+    std::size_t n_leading_fifos = fifo_paths.size();
+    if (streaming)
+    {
+        n_leading_fifos = 0;
+        if (cfg.anchor_fifo >= 0)
+        {
+            const auto first_channel_fifo = std::stable_partition(
+                fifo_paths.begin(), fifo_paths.end(),
+                [&cfg](const std::string &path)
+                {
+                    const AlcorDataStreamer probe(path);
+                    return probe.get_device_id() == cfg.anchor_device &&
+                           probe.get_fifo_id() == cfg.anchor_fifo;
+                });
+            n_leading_fifos = static_cast<std::size_t>(
+                first_channel_fifo - fifo_paths.begin());
+        }
+        mist::logger::info(TString::Format(
+                               "(pulser_calib_writer) streaming accumulation: %zu anchor FIFO(s) "
+                               "first, slip window %d hits per channel",
+                               n_leading_fifos, cfg.slip_window_hits)
+                               .Data());
+    }
+    //  Anchor-Δ store; streaming fills it on arrival once dt_win is
+    //  known (after the cadence below).
+    AnchorDtStore anchor_dt;
+    bool anchor_dt_on_arrival = false;
+
+    auto ingest_fifo = [&](const std::string &path)
     {
         AlcorDataStreamer alcor_stream(path);
         if (!alcor_stream.is_valid())
         {
             mist::logger::warning("(pulser_calib_writer) cannot open FIFO " + path + " — skipping");
-            continue;
+            return;
         }
         int spill_idx = -1; //  bumped to 0 on the first is_start_spill()
         while (alcor_stream.read_next())
@@ -1078,17 +745,159 @@ void pulser_calib_writer(
             channel_hit.fine = static_cast<uint8_t>(fine_value);
             channel_hit.tdc = static_cast<uint8_t>(tdc_idx);
 
+            ++total_hits_read;
+            if (streaming)
+            {
+                auto [channel_it, created] = streaming_channels.try_emplace(channel_key);
+                if (created)
+                {
+                    const auto prior_it = priors.find(channel_key);
+                    if (prior_it != priors.end())
+                        channel_it->second.prior = &prior_it->second;
+                }
+                channel_it->second.add(channel_hit, spill_idx, cfg);
+                if (anchor_dt_on_arrival &&
+                    spill_idx < static_cast<int>(anchor.per_spill_coarse.size()) &&
+                    !anchor.per_spill_coarse[spill_idx].empty())
+                    anchor_dt.add(channel_key, spill_idx, channel_hit.abs_coarse_cc,
+                                  anchor.per_spill_coarse[spill_idx]);
+                continue;
+            }
             auto &bucket = channels[channel_key];
             //  Grow per-spill vector lazily — sparsity is okay
             //  (empty SpillBuckets cost almost nothing).
             if (static_cast<int>(bucket.per_spill.size()) <= spill_idx)
                 bucket.per_spill.resize(spill_idx + 1);
             bucket.per_spill[spill_idx].hits.push_back(channel_hit);
-            ++total_hits_read;
+        }
+    };
+    for (std::size_t i = 0; i < n_leading_fifos; ++i)
+        ingest_fifo(fifo_paths[i]);
+
+    //  ── Consecutive anchor-pulse Δt (the pulse cadence) ───────────────
+    //  The anchor's OWN cadence: the time between consecutive salvaged
+    //  pulses (coarse[i] − coarse[i-1]).  For a healthy pulser this is a
+    //  tight GAUSSIAN at the pulse period; its mean is the average pulse
+    //  RATE (= 320 MHz clock / period_cc) and its width is the cadence
+    //  jitter.  Missed pulses produce 2×/3× satellite peaks, which we
+    //  exclude by windowing the fit to ±30 % of the (robust) median
+    //  period.  Only meaningful in FIFO-salvage mode (the pulse train).
+    std::unique_ptr<TH1F> h_anchor_consecutive_dt;
+    double anchor_period_cc = 0.0;
+    double anchor_jitter_cc = 0.0;
+    double anchor_rate_hz = 0.0;
+    long n_anchor_consecutive_filled = 0;
+    if (cfg.anchor_fifo >= 0)
+    {
+        std::vector<double> diffs;
+        for (const auto &pulses : anchor.per_spill_coarse)
+            for (size_t i = 1; i < pulses.size(); ++i)
+                diffs.push_back(
+                    static_cast<double>(pulses[i] - pulses[i - 1]));
+        if (!diffs.empty())
+        {
+            //  Robust period seed = median (immune to the missed-pulse
+            //  2×/3× tail that would drag a plain mean upward).
+            auto mid = diffs.begin() +
+                       static_cast<std::ptrdiff_t>(diffs.size() / 2);
+            std::nth_element(diffs.begin(), mid, diffs.end());
+            const double med = *mid;
+            const double lo = 0.7 * med, hi = 1.3 * med;
+            h_anchor_consecutive_dt = std::make_unique<TH1F>(
+                "h_anchor_consecutive_dt",
+                "consecutive anchor-pulse #Deltat;"
+                "#Deltat (cc)  = c_{i} #minus c_{i-1};pulses",
+                200, lo, hi);
+            h_anchor_consecutive_dt->SetDirectory(nullptr);
+            for (double d : diffs)
+                if (d >= lo && d < hi)
+                {
+                    h_anchor_consecutive_dt->Fill(d);
+                    ++n_anchor_consecutive_filled;
+                }
+            //  Period = the robust MEDIAN (immune to missed-pulse
+            //  sub-populations that can pull a Gaussian fit to a wrong
+            //  sub-peak — observed on multi-rate runs).  The Gaussian only
+            //  refines the JITTER (σ), and only when it lands on the median
+            //  (else keep the histogram RMS).
+            anchor_period_cc = med;
+            anchor_jitter_cc = h_anchor_consecutive_dt->GetRMS();
+            if (h_anchor_consecutive_dt->GetEntries() > 0)
+            {
+                h_anchor_consecutive_dt->Fit("gaus", "Q0");
+                if (auto *fn = h_anchor_consecutive_dt->GetFunction("gaus"))
+                {
+                    if (std::abs(fn->GetParameter(1) - med) < 0.05 * med)
+                        anchor_jitter_cc = std::abs(fn->GetParameter(2));
+                    else
+                        //  Fit landed off the median (missed-pulse sub-peak);
+                        //  drop it so the 06 plot doesn't draw a misleading line.
+                        h_anchor_consecutive_dt->GetListOfFunctions()->Remove(fn);
+                }
+            }
+            //  Average rate: convert the coarse-count period to NS first
+            //  (period_ns = period_cc · CC_TO_NS), then rate = 1 / period.
+            const double anchor_period_ns = anchor_period_cc * CC_TO_NS;
+            anchor_rate_hz =
+                (anchor_period_ns > 0.0) ? 1.0e9 / anchor_period_ns : 0.0;
+            mist::logger::info(
+                TString::Format(
+                    "(pulser_calib_writer) anchor cadence: period = %.2f cc "
+                    "(%.1f ns), jitter #sigma = %.2f cc, average rate = "
+                    "%.4g Hz (%.4f MHz) from %ld in-window diffs",
+                    anchor_period_cc, anchor_period_cc * CC_TO_NS,
+                    anchor_jitter_cc, anchor_rate_hz, anchor_rate_hz / 1e6,
+                    n_anchor_consecutive_filled)
+                    .Data());
+
+            //  Auto-derive the pulser period from the MEASURED anchor
+            //  cadence.  The external pulser drives both the FIFO anchor
+            //  and the laser, so the anchor's consecutive-Δt period IS the
+            //  channel pulse period.  Without this the fit keeps the 1 kHz
+            //  (320000 cc) TOML default, and the consecutive-pair selector
+            //  (|Δc − pulser_period_cc| < tol, line ~453) rejects every
+            //  real 1 MHz (320 cc) pair → no coincident pairs → empty fit.
+            //  An explicit --pulser-frequency-hz (override ≥ 0) still wins.
+            if (pulser_period_cc_override < 0.0 && anchor_period_cc > 0.0)
+            {
+                const double measured = std::round(anchor_period_cc);
+                if (measured != cfg.pulser_period_cc)
+                {
+                    mist::logger::info(TString::Format(
+                                           "(pulser_calib_writer) pulser_period_cc auto-set from "
+                                           "anchor cadence: %.0f -> %.0f cc (%.4f MHz); was the "
+                                           "TOML/default value",
+                                           cfg.pulser_period_cc, measured,
+                                           (measured > 0 ? 320.0e6 / measured / 1e6 : 0.0))
+                                           .Data());
+                    cfg.pulser_period_cc = measured;
+                }
+            }
         }
     }
+
+    //  Δt STORAGE range = ±period/2 (the full nearest-pulse range) so the
+    //  peak/delay can be measured wherever it sits.  The DISPLAY histogram
+    //  stays the fixed ±250 cc created below; the peak is shifted into it by
+    //  the delay.  Capped at 32000 cc to bound the per-pixel store.
+    int dt_win = 250; // full nearest-pulse half-range (cc)
+    if (cfg.anchor_fifo >= 0 && anchor_period_cc > 1.0)
+        dt_win = std::min(32000,
+                          std::max(250,
+                                   static_cast<int>(
+                                       std::round(anchor_period_cc / 2.0))));
+    anchor_dt.dt_win = dt_win;
+    anchor_dt_on_arrival = streaming && cfg.anchor_fifo >= 0;
+
+    //  Streaming: the channel FIFOs, now that the period and dt_win are
+    //  settled.  (Buffered read them all above.)
+    for (std::size_t i = n_leading_fifos; i < fifo_paths.size(); ++i)
+        ingest_fifo(fifo_paths[i]);
+
     mist::logger::info("(pulser_calib_writer) ingested " + std::to_string(total_hits_read) +
-                       " hits across " + std::to_string(channels.size()) + " channels");
+                       " hits across " +
+                       std::to_string(streaming ? streaming_channels.size() : channels.size()) +
+                       " channels");
     if (cfg.anchor_fifo >= 0)
         mist::logger::info(TString::Format(
                                "(pulser_calib_writer) salvaged %ld anchor pulses from "
@@ -1108,7 +917,7 @@ void pulser_calib_writer(
                                .Data());
     }
 
-    if (channels.empty())
+    if (channels.empty() && streaming_channels.empty())
     {
         mist::logger::error("(pulser_calib_writer) no hits read — bailing");
         return;
@@ -1124,7 +933,8 @@ void pulser_calib_writer(
     //  exactly the population the operator wants to spot.
     //
     //  Filled *before* the parallel fit moves the per-channel buckets
-    //  out of `channels` (line ~1009 below).  All channels go onto a
+    //  out of `channels` (streaming mode: from AnchorDtStore, filled on
+    //  arrival).  All channels go onto a
     //  single histogram so a one-shot read of the plot tells the
     //  operator "every channel is happy" or "channel X drifted".
     //
@@ -1193,7 +1003,6 @@ void pulser_calib_writer(
         "#Deltat (cc)  = c_{ch} #minus c_{anchor} #minus delay;hits",
         201, -100.5, 100.5);
     h_anchor_dt_1d->SetDirectory(nullptr);
-    int dt_win = 250; // full nearest-pulse half-range (cc); set from period below
 
     //  Coincidence hitmap (FIFO/laser mode): per-pixel count of hits inside
     //  the per-pixel coincidence window → lights up the laser spot.  Rendered
@@ -1203,122 +1012,11 @@ void pulser_calib_writer(
     double anchor_delay_used = 0.0; // delay actually subtracted (cc)
     //  Afterpulse veto: a channel hit within 100 ns (= 32 cc) of the previous
     //  KEPT hit on the same channel is an afterpulse — vetoed from every plot
-    //  (05/07/08).  Counters drive the reported afterpulse probability.
+    //  (05/07/08).  Counters (from AnchorDtStore) drive the reported
+    //  afterpulse probability.
     long n_ap_vetoed = 0;  // hits vetoed as afterpulses
     long n_ap_primary = 0; // hits kept (first in their 100 ns window)
 
-    //  ── Consecutive anchor-pulse Δt (the pulse cadence) ───────────────
-    //  The anchor's OWN cadence: the time between consecutive salvaged
-    //  pulses (coarse[i] − coarse[i-1]).  For a healthy pulser this is a
-    //  tight GAUSSIAN at the pulse period; its mean is the average pulse
-    //  RATE (= 320 MHz clock / period_cc) and its width is the cadence
-    //  jitter.  Missed pulses produce 2×/3× satellite peaks, which we
-    //  exclude by windowing the fit to ±30 % of the (robust) median
-    //  period.  Only meaningful in FIFO-salvage mode (the pulse train).
-    std::unique_ptr<TH1F> h_anchor_consecutive_dt;
-    double anchor_period_cc = 0.0;
-    double anchor_jitter_cc = 0.0;
-    double anchor_rate_hz = 0.0;
-    long n_anchor_consecutive_filled = 0;
-    if (cfg.anchor_fifo >= 0)
-    {
-        std::vector<double> diffs;
-        for (const auto &pulses : anchor.per_spill_coarse)
-            for (size_t i = 1; i < pulses.size(); ++i)
-                diffs.push_back(
-                    static_cast<double>(pulses[i] - pulses[i - 1]));
-        if (!diffs.empty())
-        {
-            //  Robust period seed = median (immune to the missed-pulse
-            //  2×/3× tail that would drag a plain mean upward).
-            auto mid = diffs.begin() +
-                       static_cast<std::ptrdiff_t>(diffs.size() / 2);
-            std::nth_element(diffs.begin(), mid, diffs.end());
-            const double med = *mid;
-            const double lo = 0.7 * med, hi = 1.3 * med;
-            h_anchor_consecutive_dt = std::make_unique<TH1F>(
-                "h_anchor_consecutive_dt",
-                "consecutive anchor-pulse #Deltat;"
-                "#Deltat (cc)  = c_{i} #minus c_{i-1};pulses",
-                200, lo, hi);
-            h_anchor_consecutive_dt->SetDirectory(nullptr);
-            for (double d : diffs)
-                if (d >= lo && d < hi)
-                {
-                    h_anchor_consecutive_dt->Fill(d);
-                    ++n_anchor_consecutive_filled;
-                }
-            //  Period = the robust MEDIAN (immune to missed-pulse
-            //  sub-populations that can pull a Gaussian fit to a wrong
-            //  sub-peak — observed on multi-rate runs).  The Gaussian only
-            //  refines the JITTER (σ), and only when it lands on the median
-            //  (else keep the histogram RMS).
-            anchor_period_cc = med;
-            anchor_jitter_cc = h_anchor_consecutive_dt->GetRMS();
-            if (h_anchor_consecutive_dt->GetEntries() > 0)
-            {
-                h_anchor_consecutive_dt->Fit("gaus", "Q0");
-                if (auto *fn = h_anchor_consecutive_dt->GetFunction("gaus"))
-                {
-                    if (std::abs(fn->GetParameter(1) - med) < 0.05 * med)
-                        anchor_jitter_cc = std::abs(fn->GetParameter(2));
-                    else
-                        //  Fit landed off the median (missed-pulse sub-peak);
-                        //  drop it so the 06 plot doesn't draw a misleading line.
-                        h_anchor_consecutive_dt->GetListOfFunctions()->Remove(fn);
-                }
-            }
-            //  Average rate: convert the coarse-count period to NS first
-            //  (period_ns = period_cc · CC_TO_NS), then rate = 1 / period.
-            const double anchor_period_ns = anchor_period_cc * CC_TO_NS;
-            anchor_rate_hz =
-                (anchor_period_ns > 0.0) ? 1.0e9 / anchor_period_ns : 0.0;
-            mist::logger::info(
-                TString::Format(
-                    "(pulser_calib_writer) anchor cadence: period = %.2f cc "
-                    "(%.1f ns), jitter #sigma = %.2f cc, average rate = "
-                    "%.4g Hz (%.4f MHz) from %ld in-window diffs",
-                    anchor_period_cc, anchor_period_cc * CC_TO_NS,
-                    anchor_jitter_cc, anchor_rate_hz, anchor_rate_hz / 1e6,
-                    n_anchor_consecutive_filled)
-                    .Data());
-
-            //  Auto-derive the pulser period from the MEASURED anchor
-            //  cadence.  The external pulser drives both the FIFO anchor
-            //  and the laser, so the anchor's consecutive-Δt period IS the
-            //  channel pulse period.  Without this the fit keeps the 1 kHz
-            //  (320000 cc) TOML default, and the consecutive-pair selector
-            //  (|Δc − pulser_period_cc| < tol, line ~453) rejects every
-            //  real 1 MHz (320 cc) pair → no coincident pairs → empty fit.
-            //  An explicit --pulser-frequency-hz (override ≥ 0) still wins.
-            if (pulser_period_cc_override < 0.0 && anchor_period_cc > 0.0)
-            {
-                const double measured = std::round(anchor_period_cc);
-                if (measured != cfg.pulser_period_cc)
-                {
-                    mist::logger::info(TString::Format(
-                                           "(pulser_calib_writer) pulser_period_cc auto-set from "
-                                           "anchor cadence: %.0f -> %.0f cc (%.4f MHz); was the "
-                                           "TOML/default value",
-                                           cfg.pulser_period_cc, measured,
-                                           (measured > 0 ? 320.0e6 / measured / 1e6 : 0.0))
-                                           .Data());
-                    cfg.pulser_period_cc = measured;
-                }
-            }
-        }
-    }
-
-    //  Δt STORAGE range = ±period/2 (the full nearest-pulse range) so the
-    //  peak/delay can be measured wherever it sits.  The DISPLAY histogram
-    //  stays the fixed ±250 cc created above; the peak is shifted into it by
-    //  the delay.  Capped at int16 for the per-pixel store.
-    if (cfg.anchor_fifo >= 0 && anchor_period_cc > 1.0)
-        dt_win = std::min(32000,
-                          std::max(250,
-                                   static_cast<int>(
-                                       std::round(anchor_period_cc / 2.0))));
-
     long n_anchor_pairs_filled = 0;
     if (cfg.anchor_fifo >= 0 && !anchor.per_spill_coarse.empty())
     {
@@ -1326,68 +1024,26 @@ void pulser_calib_writer(
         //  The reference is the salvaged (device, anchor_fifo) pulse train
         //  (e.g. KC705 testpulse), not an addressable channel.  Reference
         //  EACH channel hit to the NEAREST anchor pulse in the same spill:
-        //  Δt = channel_coarse − nearest_anchor_coarse.  The per-spill
-        //  anchor coarse list is strictly monotonic (rollover increments
-        //  cleanly → get_coarse_global_time() never decreases; verified),
-        //  so it is already sorted and a binary search finds the nearest.
-        //  Per-pixel Δt store (chip, eo_channel) → in-window Δt values, used
-        //  after the loop to build the coincidence hitmap (laser spot).
-        std::map<ChannelKey, std::vector<int16_t>> ch_dt_for_map;
-        //  Flat (spill, Δt) store for the Δt-vs-spill 2D — filled post-loop
-        //  with the delay subtracted (same recentring as the 1D).
-        std::vector<std::pair<int16_t, int16_t>> dt2d;
-        for (const auto &[ch_key, ch_bucket] : channels)
-        {
-            const int n_spills = static_cast<int>(std::min(
-                anchor.per_spill_coarse.size(), ch_bucket.per_spill.size()));
-            for (int s = 0; s < n_spills; ++s)
+        //  Δt = channel_coarse − nearest_anchor_coarse.
+        //  Stored per pixel (chip, eo_channel) for the coincidence hitmap
+        //  (laser spot) and per (spill, Δt) for the 2D; see AnchorDtStore.
+        if (!streaming)
+            for (const auto &[ch_key, ch_bucket] : channels)
             {
-                const auto &anchors = anchor.per_spill_coarse[s];
-                if (anchors.empty())
-                    continue;
-                auto &dt_store = ch_dt_for_map[ch_key];
-                //  Afterpulse veto: keep the FIRST hit of each 100 ns window,
-                //  drop any later same-channel hit within 100 ns of it (it is
-                //  an afterpulse).  Hits are in FIFO/time order.
-                constexpr int64_t kVetoCc = 32;  // 100 ns / 3.125 ns-per-cc
-                int64_t last_kept = -1000000000; // first hit always kept
-                for (const auto &ch_hit : ch_bucket.per_spill[s].hits)
+                const int n_spills = static_cast<int>(std::min(
+                    anchor.per_spill_coarse.size(), ch_bucket.per_spill.size()));
+                for (int s = 0; s < n_spills; ++s)
                 {
-                    const int64_t tc = ch_hit.abs_coarse_cc;
-                    if (tc - last_kept < kVetoCc)
-                    {
-                        ++n_ap_vetoed; // afterpulse — excluded from all plots
+                    const auto &anchors = anchor.per_spill_coarse[s];
+                    if (anchors.empty())
                         continue;
-                    }
-                    last_kept = tc;
-                    ++n_ap_primary;
-                    const auto it =
-                        std::lower_bound(anchors.begin(), anchors.end(), tc);
-                    int64_t nearest;
-                    if (it == anchors.begin())
-                        nearest = anchors.front();
-                    else if (it == anchors.end())
-                        nearest = anchors.back();
-                    else
-                    {
-                        const int64_t hi = *it, lo = *(it - 1);
-                        nearest = (tc - lo <= hi - tc) ? lo : hi;
-                    }
-                    const int64_t dt = tc - nearest;
-                    //  Both the 2D (Δt vs spill) and the 1D are filled
-                    //  post-loop AFTER the delay is known, so the peak is
-                    //  recentred into the window in both.  Stash full-range
-                    //  Δt here (per-pixel for the map, flat for the 2D).
-                    if (dt >= -dt_win && dt <= dt_win)
-                    {
-                        dt_store.push_back(static_cast<int16_t>(dt));
-                        dt2d.emplace_back(static_cast<int16_t>(s),
-                                          static_cast<int16_t>(dt));
-                    }
-                    ++n_anchor_pairs_filled;
+                    for (const auto &ch_hit : ch_bucket.per_spill[s].hits)
+                        anchor_dt.add(ch_key, s, ch_hit.abs_coarse_cc, anchors);
                 }
             }
-        }
+        n_anchor_pairs_filled = anchor_dt.n_pairs;
+        n_ap_vetoed = anchor_dt.n_ap_vetoed;
+        n_ap_primary = anchor_dt.n_ap_primary;
         mist::logger::info(TString::Format(
                                "(pulser_calib_writer) anchor-Δ diagnostic filled with %ld "
                                "(channel hit, nearest FIFO-%d anchor pulse) pairs across %d spills",
@@ -1404,7 +1060,7 @@ void pulser_calib_writer(
         //  significant excess); a DCR-only pixel is flat (≈ 0).  The map
         //  therefore reveals the illuminated spot independent of any global
         //  alignment.
-        if (!ch_dt_for_map.empty())
+        if (!anchor_dt.per_pixel.empty())
         {
             //  ±20 ns window around each channel's own peak (3.125 ns/cc).
             const int kHalf = static_cast<int>(std::lround(20.0 / CC_TO_NS));
@@ -1425,14 +1081,11 @@ void pulser_calib_writer(
 
             long n_lit = 0, n_unmapped = 0;
             std::vector<double> lit_shifts;
-            for (const auto &[key, dts] : ch_dt_for_map)
+            for (const auto &[key, pixel] : anchor_dt.per_pixel)
             {
-                if (dts.size() < 50)
+                if (pixel.n_in_window < 50)
                     continue;
-                std::vector<int> cnt(kNb, 0);
-                for (int16_t d : dts)
-                    if (d >= -kRange && d <= kRange)
-                        ++cnt[d + kRange];
+                const auto &cnt = pixel.counts; // kNb bins, index Δt + kRange
                 const int peak = static_cast<int>(
                     std::max_element(cnt.begin(), cnt.end()) - cnt.begin());
                 //  RAW hit count in ±20 ns of this channel's peak — NO DCR
@@ -1495,19 +1148,22 @@ void pulser_calib_writer(
                                 : peak_ok    ? coinc_shift_cc
                                              : 0.0;
             //  1D integrated Δt — recentred by the delay (±100 cc window).
-            for (const auto &[key, dts] : ch_dt_for_map)
-                for (int16_t d : dts)
+            //  One Fill per stored hit keeps the unweighted statistics.
+            for (const auto &[key, pixel] : anchor_dt.per_pixel)
+                for (int b = 0; b < static_cast<int>(pixel.counts.size()); ++b)
                 {
-                    const double shifted = d - anchor_delay_used;
+                    const double shifted = (b - kRange) - anchor_delay_used;
                     if (shifted >= -100.5 && shifted <= 100.5)
-                        h_anchor_dt_1d->Fill(shifted);
+                        for (uint32_t k = 0; k < pixel.counts[b]; ++k)
+                            h_anchor_dt_1d->Fill(shifted);
                 }
             //  2D Δt vs spill — recentred by the same delay so the peak
             //  lands in the canvas main pad.
-            for (const auto &[s16, d16] : dt2d)
-                h_anchor_dt_vs_spill->Fill(
-                    static_cast<double>(s16),
-                    static_cast<double>(d16) - anchor_delay_used);
+            for (const auto &[spill_dt, n_hits] : anchor_dt.per_spill_dt)
+                for (long k = 0; k < n_hits; ++k)
+                    h_anchor_dt_vs_spill->Fill(
+                        static_cast<double>(spill_dt.first),
+                        static_cast<double>(spill_dt.second) - anchor_delay_used);
             mist::logger::info(TString::Format(
                                    "(pulser_calib_writer) coincidence: %ld lit pixels, measured "
                                    "average peak = %.0f cc (%.1f ns); delay subtracted = %.0f cc "
@@ -1530,7 +1186,15 @@ void pulser_calib_writer(
             static_cast<uint16_t>(cfg.anchor_chip),
             static_cast<uint16_t>(cfg.anchor_eo_channel)};
         auto anchor_it = channels.find(anchor_key);
-        if (anchor_it == channels.end())
+        if (streaming)
+        {
+            //  Index pairing needs both channels' hit lists of a spill;
+            //  nothing is kept in streaming mode.
+            mist::logger::warning("(pulser_calib_writer) streaming accumulation keeps no hit lists — "
+                                  "the channel-anchor Δ diagnostic is skipped (use a FIFO-salvage "
+                                  "anchor, anchor_fifo >= 0, to keep it).");
+        }
+        else if (anchor_it == channels.end())
         {
             mist::logger::warning(TString::Format(
                                       "(pulser_calib_writer) anchor channel %d/%d/ch%d not present in "
@@ -1576,59 +1240,148 @@ void pulser_calib_writer(
     //  The chi² is quadratic in every unknown → linear least squares
     //  with a closed-form Cholesky solve per channel (~µs).  No
     //  shared global state — fit_channel touches only its local stack,
-    //  so we dispatch in chunks via std::async to use all cores.
+    //  so channels fan out across the shared task pool.
 
     //  Move the map into a positional vector so workers can index
-    //  without iterator-stability worries.
+    //  without iterator-stability worries.  Streaming channels stay in
+    //  their map (the nodes are stable) and are indexed by pointer; their
+    //  solve is the same closed form on the pre-accumulated system.
     std::vector<std::pair<ChannelKey, ChannelBucket>> work;
     work.reserve(channels.size());
     for (auto &kv : channels)
         work.emplace_back(kv.first, std::move(kv.second));
     channels.clear();
+    std::vector<std::pair<ChannelKey, StreamingChannel *>> streaming_work;
+    streaming_work.reserve(streaming_channels.size());
+    for (auto &kv : streaming_channels)
+        streaming_work.emplace_back(kv.first, &kv.second);
+    const std::size_t n_work = streaming ? streaming_work.size() : work.size();
 
     const unsigned n_threads =
-        std::max(1u, std::thread::hardware_concurrency());
+        static_cast<unsigned>(util::TaskPool::instance().concurrency());
     mist::logger::info("(pulser_calib_writer) Stage 1: fitting " +
-                       std::to_string(work.size()) +
+                       std::to_string(n_work) +
                        " channels (closed-form, " +
                        std::to_string(n_threads) + " threads)");
+    const auto fit_t0 = std::chrono::steady_clock::now();
 
-    std::vector<ChannelResult> results(work.size());
+    std::vector<ChannelResult> results(n_work);
     const long progress_stride =
-        std::max<long>(1, static_cast<long>(work.size()) / 10);
-
-    //  Chunked dispatch: at most ~4·n_threads channels in flight so
-    //  the std::future queue stays bounded on huge runs.
-    const std::size_t batch_size = static_cast<std::size_t>(n_threads) * 4;
-    std::size_t next = 0;
-    long n_fit = 0;
-    while (next < work.size())
+        std::max<long>(1, static_cast<long>(n_work) / 10);
+
+    //  One channel: in incremental mode a channel whose prior passes
+    //  the check keeps it and skips the fit (`sample` is the slot's
+    //  scratch).  Returns true when the channel was fitted.
+    auto solve_one = [&](std::size_t i, std::vector<HitPair> &sample) -> bool
     {
-        const std::size_t end = std::min(next + batch_size, work.size());
-        std::vector<std::future<ChannelResult>> batch;
-        batch.reserve(end - next);
-        for (std::size_t i = next; i < end; ++i)
+        const ChannelKey &key = streaming ? streaming_work[i].first : work[i].first;
+        const auto prior_it = priors.find(key);
+        const ChannelPrior *prior = prior_it != priors.end() ? &prior_it->second : nullptr;
+        if (streaming)
         {
-            batch.push_back(std::async(
-                std::launch::async,
-                [&work, i, &cfg]()
+            StreamingChannel &channel = *streaming_work[i].second;
+            if (prior)
+            {
+                channel.flush(cfg);
+                if (prior_holds(channel.acc, *prior, channel.check_pairs, cfg))
                 {
-                    return fit_channel(work[i].first,
-                                       std::move(work[i].second), cfg);
-                }));
+                    results[i] = std::move(channel.acc);
+                    results[i].key = key;
+                    carry_prior(results[i], *prior, cfg);
+                    return false;
+                }
+            }
+            results[i] = channel.solve(key, cfg);
+            return true;
         }
-        for (std::size_t i = next; i < end; ++i)
+        if (prior)
         {
-            results[i] = batch[i - next].get();
-            ++n_fit;
-            if (n_fit % progress_stride == 0 ||
-                n_fit == static_cast<long>(work.size()))
-                mist::logger::info("(pulser_calib_writer)   ... fitted " +
-                                   std::to_string(n_fit) + "/" +
-                                   std::to_string(work.size()) + " channels");
+            ChannelResult counted = count_channel(key, work[i].second, cfg);
+            sample_pairs(work[i].second, counted.total_hits, cfg, sample);
+            if (prior_holds(counted, *prior, sample, cfg))
+            {
+                carry_prior(counted, *prior, cfg);
+                results[i] = std::move(counted);
+                work[i].second = ChannelBucket{};
+                return false;
+            }
         }
-        next = end;
+        results[i] = fit_channel(key, std::move(work[i].second), cfg, prior);
+        return true;
+    };
+
+    //  One worker slot per pool thread, each pulling channel indices
+    //  off a shared atomic cursor until the list runs dry — no
+    //  per-batch barrier, so one slow channel (a 10⁶-hit anchor) no
+    //  longer idles the rest of the pool.  Every channel writes only
+    //  its own `results[i]`; the per-slot fit / keep counts are the
+    //  only other per-thread state and are summed after the join.
+    const std::size_t n_slots =
+        std::min<std::size_t>(n_threads, std::max<std::size_t>(n_work, 1));
+    std::vector<long> slot_n_fit(n_slots, 0);
+    std::vector<long> slot_n_kept(n_slots, 0);
+    std::atomic<std::size_t> next{0};
+    std::atomic<long> n_fit{0};
+    util::TaskGroup group;
+    for (std::size_t slot = 0; slot < n_slots; ++slot)
+        group.run([&, slot]()
+                  {
+                      std::vector<HitPair> sample;
+                      for (std::size_t i = next.fetch_add(1); i < n_work;
+                           i = next.fetch_add(1))
+                      {
+                          if (solve_one(i, sample))
+                              ++slot_n_fit[slot];
+                          else
+                              ++slot_n_kept[slot];
+                          const long done = ++n_fit;
+                          if (done % progress_stride == 0 ||
+                              done == static_cast<long>(n_work))
+                              mist::logger::info("(pulser_calib_writer)   ... fitted " +
+                                                 std::to_string(done) + "/" +
+                                                 std::to_string(n_work) + " channels");
+                      } });
+    group.wait();
+    const auto fit_t1 = std::chrono::steady_clock::now();
+    mist::logger::info(TString::Format(
+                           "(pulser_calib_writer) Stage 1 done: %ld channels in %.2f s "
+                           "(%zu slots, busiest %ld)",
+                           static_cast<long>(n_work),
+                           std::chrono::duration<double>(fit_t1 - fit_t0).count(),
+                           n_slots,
+                           *std::max_element(slot_n_fit.begin(), slot_n_fit.end()))
+                           .Data());
+    const long n_refit = std::accumulate(slot_n_fit.begin(), slot_n_fit.end(), 0L);
+    const long n_kept = std::accumulate(slot_n_kept.begin(), slot_n_kept.end(), 0L);
+
+    //  Incremental: prior channels with no data in this run are carried
+    //  over as-is, so the output stays a complete (merged) calibration.
+    //  Kept out of `results` — the QA below describes this run's data.
+    std::vector<ChannelResult> prior_only;
+    if (!priors.empty())
+    {
+        std::vector<ChannelKey> seen;
+        seen.reserve(results.size());
+        for (const auto &r : results)
+            seen.push_back(r.key);
+        std::sort(seen.begin(), seen.end());
+        for (const auto &[key, prior] : priors)
+        {
+            if (std::binary_search(seen.begin(), seen.end(), key))
+                continue;
+            ChannelResult carried;
+            carried.key = key;
+            carry_prior(carried, prior, cfg);
+            prior_only.push_back(std::move(carried));
+        }
+        mist::logger::info(TString::Format(
+                               "(pulser_calib_writer) --incremental: %ld channels refitted, "
+                               "%ld kept their prior, %zu prior channels without new data carried over",
+                               n_refit, n_kept, prior_only.size())
+                               .Data());
     }
+    streaming_work.clear();
+    streaming_channels.clear();
     work.clear();
     work.shrink_to_fit();
 
@@ -1660,13 +1413,16 @@ void pulser_calib_writer(
         double sigma;
         bool a_clamped;
         bool b_clamped;
+        bool carried;       ///< incremental: prior entry kept
+        std::string origin; ///< run whose data produced the entry
     };
     std::vector<PublishedTdc> published;
     long n_solve_failed = 0;
-    for (const auto &r : results)
+    auto publish_result = [&](const ChannelResult &r)
     {
         if (!r.converged)
             ++n_solve_failed;
+        const auto prior_it = r.carried ? priors.find(r.key) : priors.end();
         for (int it = 0; it < 4; ++it)
         {
             const auto &t = r.tdc[it];
@@ -1676,6 +1432,8 @@ void pulser_calib_writer(
             pt.ok = t.fitted;
             pt.a_clamped = false;
             pt.b_clamped = false;
+            pt.carried = r.carried;
+            pt.origin = prior_it != priors.end() ? prior_it->second.origin : run_name;
             if (t.fitted)
             {
                 //  Slope clamp.  Outside the physical band, the
@@ -1712,9 +1470,13 @@ void pulser_calib_writer(
                 //  they share the same residual sigma.
                 pt.sigma = std::sqrt(r.chi2_per_pair);
             }
-            published.push_back(pt);
+            published.push_back(std::move(pt));
         }
-    }
+    };
+    for (const auto &r : results)
+        publish_result(r);
+    for (const auto &r : prior_only)
+        publish_result(r);
     mist::logger::info(TString::Format(
                            "(pulser_calib_writer) %ld of %lu channel solves failed (Cholesky)",
                            n_solve_failed,
@@ -1816,7 +1578,9 @@ void pulser_calib_writer(
                     << "method  = " << method_id << "\n"
                     << "a       = " << pt.a << "\n"
                     << "minus_b = " << -pt.b << "\n"
-                    << "sigma   = " << pt.sigma << "\n\n";
+                    << "sigma   = " << pt.sigma << "\n"
+                    << "provenance = \"" << (pt.carried ? "carried" : "fit") << "\"\n"
+                    << "origin  = \"" << pt.origin << "\"\n\n";
             }
             else
             {
@@ -1867,6 +1631,18 @@ void pulser_calib_writer(
         p_spills.Write();
         p_skipped.Write();
 
+        //  Incremental update: how the published channels came about.
+        if (cfg.incremental)
+        {
+            TParameter<int> p_refit("incremental_channels_refit", static_cast<int>(n_refit));
+            TParameter<int> p_kept("incremental_channels_kept", static_cast<int>(n_kept));
+            TParameter<int> p_prior_only("incremental_channels_prior_only",
+                                         static_cast<int>(prior_only.size()));
+            p_refit.Write();
+            p_kept.Write();
+            p_prior_only.Write();
+        }
+
         //  Slip-correction stats (see fit_channel slip detection).
         TParameter<Long64_t> p_slip_total("slip_total_hits_resnapped", n_slipped_total);
         TParameter<Long64_t> p_slip_chans("slip_channels_with_at_least_one_slip", n_channels_with_slips);
@@ -2651,11 +2427,17 @@ void pulser_calib_writer(
             .add("pulser_period_cc", cfg.pulser_period_cc)
             .add("consecutive_pair_tolerance_cc", cfg.consecutive_pair_tolerance_cc)
             .add("slip_confidence_cc", cfg.slip_confidence_cc)
-            .add("slip_max_snap_fraction", cfg.slip_max_snap_fraction);
+            .add("slip_max_snap_fraction", cfg.slip_max_snap_fraction)
+            .add("streaming_accumulation", cfg.streaming_accumulation)
+            .add("slip_window_hits", cfg.slip_window_hits)
+            .add("incremental", cfg.incremental)
+            .add("incremental_check_pairs", cfg.incremental_check_pairs)
+            .add("incremental_chi2_ratio", cfg.incremental_chi2_ratio);
         //  Runtime flags + the conf-file paths used at load time.
         dump.add("force_rebuild", cfg.force_rebuild)
             .add_path("override_path", cfg.override_path)
-            .add_path("default_path", cfg.default_path);
+            .add_path("default_path", cfg.default_path)
+            .add_path("incremental_from", cfg.incremental_from);
         //  Verbatim TOML body of whichever calibration conf was picked
         //  up (override takes precedence over the default).  Was
         //  missing in v1 — the dashboard now has the same "[toml
@@ -2684,7 +2466,7 @@ void pulser_calib_writer(
         //  ``extData/`` hard-code was failing because the dashboard
         //  launches with cwd at the git repo root; the store lives
         //  under data_repository (``Data/``), NOT the repo root.
-        AnalysisResults ar(data_repository + "/standard_results.toml");
+        AnalysisResults ar(data_repository + "/standard_results.toml", ResultsBackend::Journal);
         ar.update(ResultMap{
                       {{run_name, "all", "calibration.total_hits_read"},
                        {static_cast<double>(total_hits_read), 0.0}},
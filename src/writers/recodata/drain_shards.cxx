@@ -0,0 +1,177 @@
+/**
+ * @file drain_shards.cxx
+ * @brief Implementation of @ref btana::recodata::fill_frame_hists and
+ *        @ref btana::recodata::DrainHistShards — see
+ *        `writers/recodata/drain_shards.h`.
+ */
+
+#include "writers/recodata/drain_shards.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "TH1.h"
+#include "TH2.h"
+
+#include "triggers/registry.h"             // TriggerRegistry::index_of
+#include "writers/recodata/ring_compute.h" // fill_ring_hists
+
+namespace btana::recodata
+{
+
+namespace
+{
+
+//  Visit every histogram slot of a RingFillHists (TH1F*& / TH2F*&).
+template <class F>
+void for_each_slot(RingFillHists &h, F &&f)
+{
+    f(h.h_nhits);
+    f(h.h_nphotons);
+    f(h.h_fcov);
+    f(h.h_radial);
+    f(h.h_R);
+    f(h.h_sigma);
+    f(h.h_R_vs_nhits);
+    f(h.h_centre_xy);
+    f(h.h_residual_vs_n);
+    f(h.h_R_vs_nhits_split);
+    f(h.h_residual_vs_n_split);
+    f(h.h_radial_split);
+    f(h.h_R_split);
+    f(h.h_radial_smeared);
+    f(h.h_radial_split_smeared);
+    f(h.h_residual_vs_n_smeared);
+    f(h.h_residual_vs_n_split_smeared);
+}
+
+//  Fixed-slot part of DrainHists (the Δt map is handled separately).
+template <class F>
+void for_each_slot(DrainHists &h, F &&f)
+{
+    f(h.h_frames_per_spill);
+    f(h.h_edge_trigger_position);
+    f(h.h_trigger_qa);
+    f(h.h_trigger_cherenkov_hitmap);
+    f(h.h_ring_tagged_hitmap);
+    for_each_slot(h.first_dual, f);
+    for_each_slot(h.first_solo, f);
+    for_each_slot(h.second, f);
+}
+
+} // namespace
+
+void fill_frame_hists(const FrameResult &res, int i_spill,
+                      const TriggerRegistry &registry,
+                      bool eff_weight_per_ring, const DrainHists &h)
+{
+    h.h_frames_per_spill->Fill(i_spill, 0.5); // total
+
+    //  Trigger-validation hist fills.
+    for (const auto &[bin, fine_t] : res.edge_fills)
+        h.h_edge_trigger_position->Fill(bin, fine_t);
+    for (const auto &[bin, outcome] : res.trigger_qa_fills)
+        h.h_trigger_qa->Fill(bin, outcome);
+    for (const auto &[idx, dt] : res.time_diff_fills)
+        h.h_trigger_time_diff.at(idx)->Fill(dt);
+
+    if (res.rejected)
+    {
+        h.h_frames_per_spill->Fill(i_spill, 3.5);
+        return;
+    }
+    if (res.had_edge)
+        h.h_frames_per_spill->Fill(i_spill, 2.5);
+
+    for (const auto &[index, trigger] : res.accepted_triggers)
+        h.h_trigger_qa->Fill(registry.index_of(index) + 0.5, 0.5); // accepted
+
+    //  In-cut trigger-Cherenkov hitmap: every cherenkov hit inside the
+    //  hardware-trigger timing cut, regardless of whether a ring was
+    //  tagged/fitted — the full in-time occupancy.
+    for (const auto &p : res.occupancy_xy)
+        h.h_trigger_cherenkov_hitmap->Fill(p[0], p[1]);
+
+    //  Companion: the ring-finder-tagged hits only (first + second ring),
+    //  recorded even when the fit itself did not converge.
+    for (const auto &p : res.first.hit_xy)
+        h.h_ring_tagged_hitmap->Fill(p[0], p[1]);
+    for (const auto &p : res.second.hit_xy)
+        h.h_ring_tagged_hitmap->Fill(p[0], p[1]);
+
+    //  Radiator QA, gated on a successful reconstruction.  The first
+    //  ring's split slots go to the _dual or _solo twins.
+    if (res.first.fit_ok || res.second.fit_ok)
+    {
+        fill_ring_hists(res.first,
+                        res.frame_has_second_ring ? h.first_dual : h.first_solo,
+                        eff_weight_per_ring);
+        fill_ring_hists(res.second, h.second, eff_weight_per_ring);
+    }
+
+    h.h_frames_per_spill->Fill(i_spill, 1.5); // accepted
+}
+
+DrainHistShards::DrainHistShards(const DrainHists &main, std::size_t n_shards)
+    : shards_(std::max<std::size_t>(1, n_shards), main)
+{
+    for (std::size_t k = 0; k < shards_.size(); ++k)
+    {
+        for_each_slot(shards_[k], [&](auto *&slot)
+                      { slot = static_cast<std::remove_reference_t<decltype(slot)>>(
+                            clone_for(k, slot)); });
+        for (auto &[idx, slot] : shards_[k].h_trigger_time_diff)
+            slot = static_cast<TH1F *>(clone_for(k, slot));
+    }
+}
+
+DrainHistShards::~DrainHistShards() = default;
+
+TH1 *DrainHistShards::clone_for(std::size_t k, TH1 *main)
+{
+    if (!main)
+        return nullptr;
+    auto [it, inserted] = clones_.try_emplace(main);
+    if (inserted)
+    {
+        order_.push_back(main);
+        it->second.reserve(shards_.size());
+        for (std::size_t s = 0; s < shards_.size(); ++s)
+        {
+            //  Detached, empty copy with the same binning / labels / Sumw2.
+            auto *clone = static_cast<TH1 *>(main->Clone());
+            clone->SetDirectory(nullptr);
+            clone->Reset();
+            it->second.emplace_back(clone);
+        }
+    }
+    return it->second[k].get();
+}
+
+void DrainHistShards::sync_time_diff(const DrainHists &main)
+{
+    for (const auto &[idx, main_hist] : main.h_trigger_time_diff)
+        for (std::size_t k = 0; k < shards_.size(); ++k)
+            if (!shards_[k].h_trigger_time_diff.count(idx))
+                shards_[k].h_trigger_time_diff[idx] =
+                    static_cast<TH1F *>(clone_for(k, main_hist));
+}
+
+void DrainHistShards::merge()
+{
+    for (TH1 *main : order_)
+        for (auto &clone : clones_.at(main))
+        {
+            main->Add(clone.get());
+            clone->Reset();
+        }
+}
+
+std::pair<std::size_t, std::size_t> DrainHistShards::chunk(std::size_t k,
+                                                           std::size_t n_frames) const
+{
+    const std::size_t n = shards_.size();
+    return {k * n_frames / n, (k + 1) * n_frames / n};
+}
+
+} // namespace btana::recodata
@@ -0,0 +1,44 @@
+/**
+ * @file fine_offsets.cxx
+ * @brief Implementation of @ref btana::recodata::FineOffsetEstimator — see
+ *        `writers/recodata/fine_offsets.h`.
+ */
+
+#include "writers/recodata/fine_offsets.h"
+
+#include "alcor_data.h"     // BTANA_ALCOR_CC_TO_NS
+#include "alcor_finedata.h" // AlcorFinedata::set_param2
+
+namespace btana::recodata
+{
+
+bool FineOffsetEstimator::offset_ns(uint32_t global_index, float &offset) const
+{
+    const auto it = channels_.find(global_index);
+    if (it == channels_.end())
+        return false;
+    const auto &acc = it->second;
+    //  Both counts must clear the threshold independently: the in-cut
+    //  one guards the division (all samples rejected as outliers) and
+    //  the low-statistics tail.
+    if (acc.n_total < min_samples_ || acc.n_in_cut < min_samples_)
+        return false;
+    offset = static_cast<float>(acc.sum_in_cut / static_cast<double>(acc.n_in_cut));
+    return true;
+}
+
+std::size_t FineOffsetEstimator::commit() const
+{
+    std::size_t n_committed = 0;
+    for (const auto &[index, acc] : channels_)
+    {
+        float offset_value = 0.f;
+        if (!offset_ns(index, offset_value))
+            continue;
+        AlcorFinedata::set_param2(index, -offset_value / BTANA_ALCOR_CC_TO_NS);
+        ++n_committed;
+    }
+    return n_committed;
+}
+
+} // namespace btana::recodata
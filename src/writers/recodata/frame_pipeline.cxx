@@ -12,17 +12,19 @@
 #include "writers/recodata/frame_pipeline.h"
 #include "alcor_data.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "alcor_finedata.h"  // AlcorFinedata
-#include "alcor_lightdata.h" // AlcorLightdata
+#include "alcor_lightdata.h" // AlcorLightdataView
 #include "triggers/registry.h"
+#include "utility/task_pool.h" // TaskGroup
 #include "writers/recodata.h" // BTANA_TRIGGER_MIN_SEPARATION
 
 namespace btana::recodata
 {
 
-FrameResult process_frame_pure(AlcorLightdata &lightdata,
+FrameResult process_frame_pure(AlcorLightdataView lightdata,
                                const FrameProcessContext &ctx)
 {
     FrameResult res;
@@ -59,7 +61,8 @@ FrameResult process_frame_pure(AlcorLightdata &lightdata,
 
         // First time seeing this trigger — accept.
         res.accepted_triggers[current_trigger.index] = current_trigger;
-        for (const auto &chrk : lightdata.get_cherenkov_hits_link())
+        res.accepted_mask |= trigger_mask_bit(current_trigger.index);
+        for (const auto &chrk : lightdata.get_cherenkov_hits())
         {
             const float dt = AlcorFinedata(chrk).get_time_ns() - current_trigger.fine_time;
             res.time_diff_fills.emplace_back(current_trigger.index, dt);
@@ -70,20 +73,13 @@ FrameResult process_frame_pure(AlcorLightdata &lightdata,
     if (res.rejected)
         return res;
 
-    //  Per-spill physics check
-    for (const auto &[idx, trig] : res.accepted_triggers)
-    {
-        if (idx == TriggerFirstFrames)
-            continue;
-        if (idx == _TRIGGER_STREAMING_RING_FOUND_)
-            continue;
-        if (idx == TriggerStartOfSpill)
-            continue;
-        if (idx == _TRIGGER_UNKNOWN_)
-            continue;
-        res.frame_is_physics = true;
-        break;
-    }
+    //  Per-spill physics check: any accepted trigger outside the
+    //  bookkeeping set.  All four have exact mask bits, so one AND.
+    constexpr TriggerMask kNonPhysics = trigger_mask_bit(TriggerFirstFrames) |
+                                        trigger_mask_bit(_TRIGGER_STREAMING_RING_FOUND_) |
+                                        trigger_mask_bit(TriggerStartOfSpill) |
+                                        trigger_mask_bit(_TRIGGER_UNKNOWN_);
+    res.frame_is_physics = (res.accepted_mask & ~kNonPhysics) != 0;
 
     //  Trigger-time Cherenkov occupancy (for h_trigger_cherenkov_hitmap) —
     //  gathered INDEPENDENTLY of the ring finder so the map shows where every
@@ -99,7 +95,7 @@ FrameResult process_frame_pure(AlcorLightdata &lightdata,
             continue;
         const float dt_lo = ctx.ring_ctx.cfg.hardware_ring_dt_min_ns;
         const float dt_hi = ctx.ring_ctx.cfg.hardware_ring_dt_max_ns;
-        for (const auto &chrk : lightdata.get_cherenkov_hits_link())
+        for (const auto &chrk : lightdata.get_cherenkov_hits())
         {
             AlcorFinedata fh(chrk);
             if (fh.is_afterpulse())
@@ -132,7 +128,7 @@ FrameResult process_frame_pure(AlcorLightdata &lightdata,
         const bool do_loo = !ctx.ring_ctx.cfg.skip_loo_residuals;
 
         bool have_tagged = false;
-        for (const auto &chrk : lightdata.get_cherenkov_hits_link())
+        for (const auto &chrk : lightdata.get_cherenkov_hits())
         {
             AlcorFinedata fh(chrk);
             if (fh.has_mask_bit(HitmaskRansacRingTagFirst) ||
@@ -149,7 +145,9 @@ FrameResult process_frame_pure(AlcorLightdata &lightdata,
         //  near-origin centroid "ring" per frame, which swamped the centre
         //  distribution.  RANSAC now seeds on hardware triggers too, so a real
         //  ring is always tagged when present.
-        if (have_tagged)
+        if (have_tagged && ctx.defer_ring_fits)
+            res.ring_fit_pending = true;
+        else if (have_tagged)
         {
             res.first = compute_ring_fit_tagged(
                 HitmaskRansacRingTagFirst, lightdata, do_loo, ctx.ring_ctx);
@@ -163,4 +161,53 @@ FrameResult process_frame_pure(AlcorLightdata &lightdata,
     return res;
 }
 
+void fit_rings_batched(const std::vector<AlcorLightdataStruct> &frames,
+                       std::vector<FrameResult> &results,
+                       const FrameProcessContext &ctx,
+                       std::size_t n_batches)
+{
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < results.size(); ++i)
+        if (results[i].ring_fit_pending)
+            pending.push_back(i);
+    if (pending.empty())
+        return;
+    n_batches = std::clamp<std::size_t>(n_batches, 1, pending.size());
+    const bool do_loo = !ctx.ring_ctx.cfg.skip_loo_residuals;
+
+    //  Batch k owns pending[lo_k, hi_k) — contiguous frame ranges, two ring
+    //  slots (First, Second) per frame, written back to disjoint results.
+    auto run_batch = [&](std::size_t k)
+    {
+        const std::size_t lo = pending.size() * k / n_batches;
+        const std::size_t hi = pending.size() * (k + 1) / n_batches;
+        RingFitBatch batch;
+        for (std::size_t p = lo; p < hi; ++p)
+        {
+            collect_ring_hits_tagged(HitmaskRansacRingTagFirst, frames[pending[p]], batch);
+            collect_ring_hits_tagged(HitmaskRansacRingTagSecond, frames[pending[p]], batch);
+        }
+        auto rings = batch.fit(do_loo, ctx.ring_ctx);
+        for (std::size_t p = lo; p < hi; ++p)
+        {
+            FrameResult &res = results[pending[p]];
+            res.first = std::move(rings[2 * (p - lo)]);
+            res.second = std::move(rings[2 * (p - lo) + 1]);
+            res.frame_has_second_ring = res.second.n_hits > 0;
+            res.ring_fit_pending = false;
+        }
+    };
+
+    if (n_batches == 1)
+    {
+        run_batch(0);
+        return;
+    }
+    util::TaskGroup group;
+    for (std::size_t k = 0; k < n_batches; ++k)
+        group.run([&run_batch, k]
+                  { run_batch(k); });
+    group.wait();
+}
+
 } // namespace btana::recodata
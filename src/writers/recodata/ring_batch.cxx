@@ -0,0 +1,292 @@
+/**
+ * @file ring_batch.cxx
+ * @brief Implementation of @ref btana::recodata::RingFitBatch — see
+ *        `writers/recodata/ring_batch.h`.
+ *
+ * The per-ring decision logic (seeded long-arc refinement vs fixed finder
+ * centre, short-arc rejection on the seedless path, σ_r, coverage, LOO)
+ * is the one formerly in `fit_collected_ring_hits` (ring_compute.cxx);
+ * only the data layout and the moment evaluation changed.
+ */
+
+#include "writers/recodata/ring_batch.h"
+#include "writers/recodata/ring_compute.h" // RingComputeContext
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+#include "utility/circle_fit.h" // CircleMoments, solve_moments
+#include "utility/radiator_efficiency.h"
+
+namespace btana::recodata
+{
+
+namespace
+{
+
+using util::circle_fit::CircleMethod;
+using util::circle_fit::CircleMoments;
+constexpr std::size_t kLanes = RingFitBatch::kLanes;
+
+//  Moment sums of one ring's contiguous hit range, referenced at its
+//  centroid.  Two sweeps (centroid, then moments), each accumulated into
+//  kLanes independent partial sums folded in a fixed order at the end.
+CircleMoments lane_moments(const float *x, const float *y, std::size_t n)
+{
+    const std::size_t n_main = n - n % kLanes;
+
+    double lx[kLanes] = {}, ly[kLanes] = {};
+    for (std::size_t i = 0; i < n_main; i += kLanes)
+        for (std::size_t l = 0; l < kLanes; ++l)
+        {
+            lx[l] += x[i + l];
+            ly[l] += y[i + l];
+        }
+    double mx = 0.0, my = 0.0;
+    for (std::size_t l = 0; l < kLanes; ++l)
+    {
+        mx += lx[l];
+        my += ly[l];
+    }
+    for (std::size_t i = n_main; i < n; ++i)
+    {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= static_cast<double>(n);
+    my /= static_cast<double>(n);
+
+    double sx[kLanes] = {}, sy[kLanes] = {}, sxx[kLanes] = {}, sxy[kLanes] = {},
+           syy[kLanes] = {}, sz[kLanes] = {}, sxz[kLanes] = {}, syz[kLanes] = {},
+           szz[kLanes] = {};
+    for (std::size_t i = 0; i < n_main; i += kLanes)
+        for (std::size_t l = 0; l < kLanes; ++l)
+        {
+            const double dx = x[i + l] - mx;
+            const double dy = y[i + l] - my;
+            const double z = dx * dx + dy * dy;
+            sx[l] += dx;
+            sy[l] += dy;
+            sxx[l] += dx * dx;
+            sxy[l] += dx * dy;
+            syy[l] += dy * dy;
+            sz[l] += z;
+            sxz[l] += dx * z;
+            syz[l] += dy * z;
+            szz[l] += z * z;
+        }
+    CircleMoments m(mx, my);
+    for (std::size_t l = 0; l < kLanes; ++l)
+    {
+        m.sx += sx[l];
+        m.sy += sy[l];
+        m.sxx += sxx[l];
+        m.sxy += sxy[l];
+        m.syy += syy[l];
+        m.sz += sz[l];
+        m.sxz += sxz[l];
+        m.syz += syz[l];
+        m.szz += szz[l];
+    }
+    m.n = static_cast<double>(n_main);
+    for (std::size_t i = n_main; i < n; ++i)
+        m.add(x[i], y[i]);
+    return m;
+}
+
+//  Azimuthal span [rad] subtended by the hits about a given centre = 2π minus
+//  the largest angular gap between consecutive hit bearings.
+float azimuthal_span_about(const float *x, const float *y, std::size_t n,
+                           float cx, float cy, std::vector<float> &ang)
+{
+    constexpr float two_pi = 6.28318530717958647692f;
+    if (n < 2)
+        return 0.f;
+    ang.clear();
+    for (std::size_t i = 0; i < n; ++i)
+        ang.push_back(std::atan2(y[i] - cy, x[i] - cx));
+    std::sort(ang.begin(), ang.end());
+    float max_gap = two_pi + ang.front() - ang.back();
+    for (std::size_t i = 1; i < ang.size(); ++i)
+        max_gap = std::max(max_gap, ang[i] - ang[i - 1]);
+    return two_pi - max_gap;
+}
+
+} // namespace
+
+void RingFitBatch::clear()
+{
+    x_.clear();
+    y_.clear();
+    xs_.clear();
+    ys_.clear();
+    begin_.clear();
+    seed_cx_.clear();
+    seed_cy_.clear();
+    seed_R_.clear();
+}
+
+std::size_t RingFitBatch::begin_ring(float seed_cx, float seed_cy, float seed_R)
+{
+    begin_.push_back(static_cast<uint32_t>(x_.size()));
+    seed_cx_.push_back(seed_cx);
+    seed_cy_.push_back(seed_cy);
+    seed_R_.push_back(seed_R);
+    return seed_R_.size() - 1;
+}
+
+std::vector<RingFitResult> RingFitBatch::fit(bool do_loo, const RingComputeContext &ctx) const
+{
+    const std::size_t n_rings = this->n_rings();
+    std::vector<RingFitResult> results(n_rings);
+    const int min_hits = ctx.cfg.min_hits_per_ring;
+
+    //  Sweep 1: moments for every ring that clears the min-hits gate.
+    std::vector<CircleMoments> moments(n_rings);
+    for (std::size_t r = 0; r < n_rings; ++r)
+    {
+        const std::size_t b = begin_[r], n = ring_end(r) - b;
+        if (static_cast<int>(n) >= min_hits && n > 0)
+            moments[r] = lane_moments(x_.data() + b, y_.data() + b, n);
+    }
+
+    //  Sweep 2: per-ring finish.  Coverage goes through the grid index +
+    //  a batch-local memo when the caller built one.
+    std::vector<float> ang_scratch;
+    std::optional<util::radiator_efficiency::CoverageCache> coverage;
+    if (ctx.coverage_index)
+        coverage.emplace(*ctx.coverage_index, ctx.cfg.delta_r_for_coverage_mm,
+                         ctx.cfg.channel_half_width_mm, ctx.cfg.coverage_cache_quantum_mm);
+    for (std::size_t r = 0; r < n_rings; ++r)
+    {
+        RingFitResult &out = results[r];
+        const std::size_t b = begin_[r], e = ring_end(r);
+        const float *x = x_.data() + b, *y = y_.data() + b;
+        const float *xs = xs_.data() + b, *ys = ys_.data() + b;
+        out.n_hits = static_cast<int>(e - b);
+        //  Carry the in-cut hit positions back for the trigger-Cherenkov
+        //  hitmap — smeared, recorded BEFORE the min-hits gate so the hitmap
+        //  shows every in-cut hit, even on frames with too few hits to fit.
+        out.hit_xy.reserve(out.n_hits);
+        for (int i = 0; i < out.n_hits; ++i)
+            out.hit_xy.push_back({xs[i], ys[i]});
+        if (out.n_hits < min_hits || out.n_hits == 0)
+            continue; // fit_ok stays false
+
+        const float seed_cx = seed_cx_[r], seed_cy = seed_cy_[r], seed_R = seed_R_[r];
+        const bool has_seed = seed_R > 0.f;
+
+        //  Closed-form Taubin from the moments — unbiased on partial arcs,
+        //  no seed, no iteration.  Pixel-centre inputs throughout.
+        const auto fit = util::circle_fit::solve_moments(moments[r], CircleMethod::taubin);
+        const bool taubin_ok = fit.ok && std::isfinite(fit.radius) && fit.radius > 0.0;
+
+        //  `taubin_refined` records whether the chosen (cx,cy,R) came from
+        //  the seedless Taubin refit (true) or the finder seed with radius
+        //  from the hits (false) — it selects the LOO treatment.
+        bool taubin_refined;
+        if (has_seed)
+        {
+            //  Trust the free refit only when the arc (spanned about the
+            //  ROBUST finder centre) is long enough to constrain it AND the
+            //  refit stays near the seed; otherwise keep the finder centre
+            //  and re-estimate R only.  Never reject when seeded.
+            const float span = azimuthal_span_about(x, y, out.n_hits, seed_cx, seed_cy,
+                                                    ang_scratch);
+            const bool long_arc = span >= ctx.cfg.arc_span_min_rad;
+            const float dcx = static_cast<float>(fit.x0) - seed_cx;
+            const float dcy = static_cast<float>(fit.y0) - seed_cy;
+            const bool near_seed =
+                taubin_ok && std::hypot(dcx, dcy) < 0.5f * seed_R &&
+                std::fabs(static_cast<float>(fit.radius) - seed_R) < 0.5f * seed_R;
+            if (long_arc && near_seed)
+            {
+                out.cx = static_cast<float>(fit.x0);
+                out.cy = static_cast<float>(fit.y0);
+                out.R = static_cast<float>(fit.radius);
+                taubin_refined = true;
+            }
+            else
+            {
+                out.cx = seed_cx;
+                out.cy = seed_cy;
+                double rsum = 0.0;
+                for (int i = 0; i < out.n_hits; ++i)
+                    rsum += std::hypot(x[i] - out.cx, y[i] - out.cy);
+                out.R = static_cast<float>(rsum / out.n_hits);
+                taubin_refined = false;
+            }
+        }
+        else
+        {
+            //  Seedless path with the wide-arc quality guard.
+            if (!taubin_ok)
+                continue; // degenerate / (near-)collinear → fit_ok stays false
+            out.cx = static_cast<float>(fit.x0);
+            out.cy = static_cast<float>(fit.y0);
+            out.R = static_cast<float>(fit.radius);
+            taubin_refined = true;
+            if (ctx.cfg.radial_eff_per_ring_centre &&
+                azimuthal_span_about(x, y, out.n_hits, out.cx, out.cy, ang_scratch) <
+                    ctx.cfg.arc_span_min_rad)
+                continue; // arc too short to constrain the centre
+        }
+
+        //  Per-ring σ_r = RMS radial residual about the chosen ring; the
+        //  per-hit radial arrays feed the radial(R) hists (pixel-centre +
+        //  smeared sibling sharing one hit set).
+        out.radial_per_hit.reserve(out.n_hits);
+        out.radial_per_hit_smeared.reserve(out.n_hits);
+        double resid_sq = 0.0;
+        for (int i = 0; i < out.n_hits; ++i)
+        {
+            const float r_pix = std::hypot(x[i] - out.cx, y[i] - out.cy);
+            out.radial_per_hit.push_back(r_pix);
+            const float d = r_pix - out.R;
+            resid_sq += static_cast<double>(d) * d;
+            out.radial_per_hit_smeared.push_back(std::hypot(xs[i] - out.cx, ys[i] - out.cy));
+        }
+        out.sigma_r = static_cast<float>(std::sqrt(resid_sq / out.n_hits));
+
+        out.f_coverage = coverage
+                             ? (*coverage)(out.cx, out.cy, out.R)
+                             : util::radiator_efficiency::azimuthal_coverage_fraction(
+                                   ctx.index_to_hit_xy, out.cx, out.cy, out.R,
+                                   ctx.cfg.delta_r_for_coverage_mm,
+                                   ctx.cfg.channel_half_width_mm);
+
+        if (do_loo)
+        {
+            out.loo_residuals.reserve(out.n_hits);
+            out.loo_residuals_smeared.reserve(out.n_hits);
+            for (int i_excl = 0; i_excl < out.n_hits; ++i_excl)
+            {
+                float cx_loo = out.cx, cy_loo = out.cy, R_loo = out.R;
+                if (taubin_refined)
+                {
+                    //  Leave-one-out Taubin: one rank-one downdate of the
+                    //  ring's moments, O(1) per hit.
+                    CircleMoments loo = moments[r];
+                    loo.remove(x[i_excl], y[i_excl]);
+                    const auto loo_fit = util::circle_fit::solve_moments(loo, CircleMethod::taubin);
+                    if (!loo_fit.ok || !std::isfinite(loo_fit.radius) || loo_fit.radius <= 0.0)
+                        continue;
+                    cx_loo = static_cast<float>(loo_fit.x0);
+                    cy_loo = static_cast<float>(loo_fit.y0);
+                    R_loo = static_cast<float>(loo_fit.radius);
+                }
+                //  Seed-fixed ring: the geometry does not depend on the hits,
+                //  so the LOO residual is the residual to the fixed ring.
+                out.loo_residuals.push_back(std::hypot(x[i_excl] - cx_loo, y[i_excl] - cy_loo) - R_loo);
+                out.loo_residuals_smeared.push_back(
+                    std::hypot(xs[i_excl] - cx_loo, ys[i_excl] - cy_loo) - R_loo);
+            }
+        }
+
+        out.fit_ok = true;
+    }
+    return results;
+}
+
+} // namespace btana::recodata
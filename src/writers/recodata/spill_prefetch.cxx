@@ -0,0 +1,89 @@
+/**
+ * @file spill_prefetch.cxx
+ * @brief Implementation of @ref btana::recodata::SpillPrefetcher — see
+ *        `writers/recodata/spill_prefetch.h`.
+ */
+
+#include "writers/recodata/spill_prefetch.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace btana::recodata
+{
+
+SpillPrefetcher::SpillPrefetcher(int n_spills, Loader loader, std::size_t depth)
+    : n_spills_(std::max(0, n_spills)), loader_(std::move(loader)),
+      slots_(std::max<std::size_t>(1, depth))
+{
+    reader_ = std::thread([this]
+                          { run(); });
+}
+
+SpillPrefetcher::~SpillPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (reader_.joinable())
+        reader_.join();
+}
+
+void SpillPrefetcher::run()
+{
+    for (int i_spill = 0; i_spill < n_spills_; ++i_spill)
+    {
+        std::size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]
+                     { return stop_ || n_ready_ < slots_.size(); });
+            if (stop_)
+                return;
+            slot = (head_ + n_ready_) % slots_.size();
+        }
+        //  The slot is invisible to the consumer until n_ready_ covers it,
+        //  so the load runs unlocked.
+        try
+        {
+            loader_(i_spill, slots_[slot]);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            n_loaded_ = n_spills_;
+            cv_.notify_all();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++n_ready_;
+            ++n_loaded_;
+        }
+        cv_.notify_all();
+    }
+}
+
+bool SpillPrefetcher::next(PrefetchedSpill &spill)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]
+             { return n_ready_ > 0 || n_loaded_ >= n_spills_; });
+    if (n_ready_ == 0)
+    {
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        return false;
+    }
+    std::swap(spill, slots_[head_]);
+    head_ = (head_ + 1) % slots_.size();
+    --n_ready_;
+    lock.unlock();
+    cv_.notify_all();
+    return true;
+}
+
+} // namespace btana::recodata
@@ -0,0 +1,182 @@
+/**
+ * @file track_matching.cxx
+ * @brief Implementation of the per-spill timestamp matcher — see
+ *        `writers/recotrackdata/track_matching.h`.
+ */
+
+#include "writers/recotrackdata/track_matching.h"
+
+#include "tracking_altai.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace btana::recotrackdata
+{
+
+namespace
+{
+
+//  The sorted merge of the header.  `order` holds the frame indices in time
+//  order.  Only counts when `out` is null (anchor scoring).
+std::size_t merge(std::span<const double> frame_ns,
+                  std::span<const std::size_t> order,
+                  const AltaiSpill &altai,
+                  double offset_ns,
+                  const TrackMatchConfig &cfg,
+                  SpillMatch *out)
+{
+    const double anchor_ns = offset_ns;
+    std::size_t n_matched = 0;
+    std::size_t i = 0, j = 0;
+    while (i < order.size() && j < altai.times_ns.size())
+    {
+        const double residual = altai.times_ns[j] - (frame_ns[order[i]] + offset_ns);
+        if (std::fabs(residual) <= cfg.tolerance_ns)
+        {
+            if (out)
+            {
+                out->event_ids[order[i]] = altai.event_ids[j];
+                out->residuals_ns.push_back(static_cast<float>(residual));
+            }
+            offset_ns += cfg.drift_gain * residual;
+            ++n_matched;
+            ++i;
+            ++j;
+        }
+        else if (residual < 0.)
+            ++j; // ALTAI event with no frame
+        else
+            ++i; // frame with no ALTAI event
+    }
+    if (out)
+    {
+        out->offset_ns = offset_ns;
+        out->drift_ns = offset_ns - anchor_ns;
+    }
+    return n_matched;
+}
+
+//  Spill-level consistency of a candidate pairing: the tracking triggers
+//  and the telescope events of one spill span the same beam time and
+//  roughly the same number of particles.
+bool spills_consistent(std::span<const double> frame_ns,
+                       const AltaiSpill &altai,
+                       const TrackMatchConfig &cfg)
+{
+    if (altai.times_ns.size() < 2)
+        return false;
+    const double n_frames = static_cast<double>(frame_ns.size());
+    const double n_events = static_cast<double>(altai.times_ns.size());
+    if (std::min(n_frames, n_events) < cfg.spill_count_ratio * std::max(n_frames, n_events))
+        return false;
+    const auto [first, last] = std::minmax_element(frame_ns.begin(), frame_ns.end());
+    const double frame_span = *last - *first;
+    const double altai_span = altai.times_ns.back() - altai.times_ns.front();
+    return std::fabs(frame_span - altai_span) <=
+           cfg.spill_duration_tolerance * std::max(frame_span, altai_span) + 2. * cfg.tolerance_ns;
+}
+
+} // namespace
+
+std::vector<AltaiSpill> split_altai_spills(const TrackingAltai &tracking,
+                                           const TrackMatchConfig &cfg)
+{
+    struct Stamp
+    {
+        double time_ns;
+        uint32_t event_id;
+    };
+    std::vector<Stamp> stamps;
+    stamps.reserve(tracking.get_number_of_events());
+    for (const auto event_id : tracking.get_event_ids())
+    {
+        const auto tracks = tracking.get_event_tracks(event_id);
+        if (!tracks.empty())
+            stamps.push_back({tracks.front().timestamp * cfg.altai_tick_ns, event_id});
+    }
+    //  Event IDs are assigned in time order by the telescope; the sort is
+    //  a no-op pass unless the file says otherwise.
+    if (!std::is_sorted(stamps.begin(), stamps.end(),
+                        [](const Stamp &a, const Stamp &b)
+                        { return a.time_ns < b.time_ns; }))
+        std::stable_sort(stamps.begin(), stamps.end(),
+                         [](const Stamp &a, const Stamp &b)
+                         { return a.time_ns < b.time_ns; });
+
+    std::vector<AltaiSpill> spills;
+    for (std::size_t k = 0; k < stamps.size(); ++k)
+    {
+        if (k == 0 || stamps[k].time_ns - stamps[k - 1].time_ns > cfg.spill_gap_ns)
+            spills.emplace_back();
+        spills.back().event_ids.push_back(stamps[k].event_id);
+        spills.back().times_ns.push_back(stamps[k].time_ns);
+    }
+    return spills;
+}
+
+int pair_altai_spill(std::span<const double> frame_ns,
+                     int i_spill,
+                     std::span<const AltaiSpill> altai_spills,
+                     int &shift,
+                     const TrackMatchConfig &cfg)
+{
+    const int n_altai = static_cast<int>(altai_spills.size());
+    if (frame_ns.size() < 2)
+    {
+        const int i_altai = i_spill + shift;
+        return i_altai >= 0 && i_altai < n_altai ? i_altai : -1;
+    }
+    //  Nearest shift first: 0, -1, +1, -2, +2, ...
+    for (int step = 0; step <= 2 * cfg.max_spill_shift; ++step)
+    {
+        const int delta = step % 2 ? -(step + 1) / 2 : step / 2;
+        const int i_altai = i_spill + shift + delta;
+        if (i_altai < 0 || i_altai >= n_altai || !spills_consistent(frame_ns, altai_spills[i_altai], cfg))
+            continue;
+        shift += delta;
+        return i_altai;
+    }
+    return -1;
+}
+
+SpillMatch match_spill(std::span<const double> frame_ns,
+                       const AltaiSpill &altai,
+                       const TrackMatchConfig &cfg)
+{
+    SpillMatch result;
+    result.event_ids.assign(frame_ns.size(), SpillMatch::kUnmatched);
+
+    std::vector<std::size_t> order(frame_ns.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b)
+                     { return frame_ns[a] < frame_ns[b]; });
+
+    //  Anchor: best of the candidate offsets; ties go to the earliest pair,
+    //  i.e. to the assumption that nothing was dropped at spill start.
+    const std::size_t n_anchor_frames = std::min(cfg.anchor_window, order.size());
+    const std::size_t n_anchor_events = std::min(cfg.anchor_window, altai.times_ns.size());
+    std::size_t best_matched = 0;
+    double best_offset = 0.;
+    for (std::size_t i = 0; i < n_anchor_frames; ++i)
+        for (std::size_t j = 0; j < n_anchor_events; ++j)
+        {
+            const double offset = altai.times_ns[j] - frame_ns[order[i]];
+            const std::size_t n = merge(frame_ns, order, altai, offset, cfg, nullptr);
+            if (n > best_matched)
+            {
+                best_matched = n;
+                best_offset = offset;
+            }
+        }
+
+    if (best_matched > 0)
+        result.n_matched = merge(frame_ns, order, altai, best_offset, cfg, &result);
+    result.n_frames_unmatched = frame_ns.size() - result.n_matched;
+    result.n_events_unmatched = altai.times_ns.size() - result.n_matched;
+    return result;
+}
+
+} // namespace btana::recotrackdata
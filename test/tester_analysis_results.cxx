@@ -0,0 +1,296 @@
+/**
+ * @file test/tester_analysis_results.cxx
+ * @brief Unit tests for the AnalysisResults journal backend
+ *        (`analysis_results.h`).
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. Journal updates append without creating / rewriting the TOML, and
+ *      a fresh handle reads them back.
+ *   2. The journal replays on top of the TOML (last record wins); a Toml
+ *      backend update folds it back in.
+ *   3. A torn tail is ignored on read and cut off by the next append.
+ *   4. A record with a bad checksum ends the replay.
+ *   5. Compaction resets the journal; handles that indexed the old
+ *      generation rebuild, handles behind on the same one catch up.
+ *   6. query_run / make_graph on the handle.
+ *   7. The column store: runs sorted, rebuilt after an update, several
+ *      graphs in one pass.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "analysis_results.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+namespace fs = std::filesystem;
+
+//  A fresh, empty store path per test.
+static std::string store_path(const std::string &name)
+{
+    const fs::path dir = fs::temp_directory_path() / "btana_analysis_results_test" / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return (dir / "standard_results.toml").string();
+}
+
+static double value_of(const AnalysisResults &ar, const ResultKey &key)
+{
+    const auto entry = ar.find(key);
+    return entry ? entry->value : -1.;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  1. append
+// ─────────────────────────────────────────────────────────────────────
+static void test_append()
+{
+    const auto path = store_path("append");
+    AnalysisResults writer(path, ResultsBackend::Journal);
+    writer.update({"r1", "all", "n_spills"}, 42.);
+    writer.update(ResultMap{{{"r1", "all", "rate"}, {1.5, 0.1}},
+                            {{"r2", "all", "rate"}, {2.5, 0.2}}});
+    CHECK(!fs::exists(path));
+    CHECK(fs::exists(writer.journal_path()));
+
+    const AnalysisResults reader(path);
+    const auto all = reader.load();
+    CHECK(all.size() == 3);
+    CHECK(value_of(reader, {"r1", "all", "n_spills"}) == 42.);
+    const auto rate = reader.find({"r2", "all", "rate"});
+    CHECK(rate && rate->value == 2.5 && rate->error == 0.2);
+    CHECK(!reader.find({"r3", "all", "rate"}));
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  2. journal over TOML
+// ─────────────────────────────────────────────────────────────────────
+static void test_overlay()
+{
+    const auto path = store_path("overlay");
+    AnalysisResults toml(path);
+    toml.update(ResultMap{{{"r1", "all", "rate"}, {1., 0.}},
+                          {{"r1", "all", "gain"}, {7., 0.}}});
+    const auto toml_size = fs::file_size(path);
+
+    AnalysisResults journal(path, ResultsBackend::Journal);
+    journal.update({"r1", "all", "rate"}, 2.);
+    journal.update({"r1", "all", "rate"}, 3.);
+    CHECK(fs::file_size(path) == toml_size);
+    CHECK(value_of(AnalysisResults(path), {"r1", "all", "rate"}) == 3.);
+    CHECK(value_of(AnalysisResults(path), {"r1", "all", "gain"}) == 7.);
+
+    //  A Toml-backend update rewrites the TOML with everything and
+    //  empties the journal.
+    toml.update({"r1", "all", "gain"}, 8.);
+    CHECK(fs::file_size(journal.journal_path()) == 16);
+    fs::remove(journal.journal_path());
+    const AnalysisResults toml_only(path);
+    CHECK(value_of(toml_only, {"r1", "all", "rate"}) == 3.);
+    CHECK(value_of(toml_only, {"r1", "all", "gain"}) == 8.);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  3. torn tail
+// ─────────────────────────────────────────────────────────────────────
+static void test_torn_tail()
+{
+    const auto path = store_path("torn");
+    AnalysisResults writer(path, ResultsBackend::Journal);
+    writer.update({"r1", "all", "a"}, 1.);
+    const auto intact = fs::file_size(writer.journal_path());
+    //  Half a record: a plausible length, then the writer died.
+    std::ofstream(writer.journal_path(), std::ios::binary | std::ios::app)
+        .write("\x30\x00\x00\x00\x11\x22\x33", 7);
+
+    CHECK(AnalysisResults(path).load().size() == 1);
+
+    AnalysisResults other(path, ResultsBackend::Journal);
+    other.update({"r1", "all", "b"}, 2.);
+    const AnalysisResults reader(path);
+    CHECK(reader.load().size() == 2);
+    CHECK(value_of(reader, {"r1", "all", "b"}) == 2.);
+    CHECK(fs::file_size(writer.journal_path()) > intact);
+    //  The handle that wrote before the tear sees the later record too.
+    CHECK(value_of(writer, {"r1", "all", "b"}) == 2.);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  4. corrupt record
+// ─────────────────────────────────────────────────────────────────────
+static void test_corrupt()
+{
+    const auto path = store_path("corrupt");
+    AnalysisResults writer(path, ResultsBackend::Journal);
+    writer.update({"r1", "all", "a"}, 1.);
+    writer.update({"r1", "all", "b"}, 2.);
+    writer.update({"r1", "all", "c"}, 3.);
+
+    //  Flip one byte of the last record's value.
+    const auto size = fs::file_size(writer.journal_path());
+    std::fstream f(writer.journal_path(), std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(static_cast<std::streamoff>(size) - 12);
+    f.put('\x7f');
+    f.close();
+
+    const AnalysisResults reader(path);
+    CHECK(reader.load().size() == 2);
+    CHECK(!reader.find({"r1", "all", "c"}));
+    CHECK(value_of(reader, {"r1", "all", "b"}) == 2.);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  5. compaction
+// ─────────────────────────────────────────────────────────────────────
+static void test_compaction()
+{
+    const auto path = store_path("compact");
+    AnalysisResults writer(path, ResultsBackend::Journal);
+    writer.set_compaction_threshold(256);
+    const AnalysisResults stale(path);
+    const AnalysisResults behind(path);
+
+    writer.update({"r0", "all", "q"}, 0.);
+    CHECK(value_of(stale, {"r0", "all", "q"}) == 0.);
+
+    for (int i = 1; i <= 10; ++i)
+        writer.update({"r" + std::to_string(i), "all", "q"}, i);
+    CHECK(fs::exists(path));
+    CHECK(fs::file_size(writer.journal_path()) < 256);
+    CHECK(stale.load().size() == 11);
+    CHECK(value_of(stale, {"r10", "all", "q"}) == 10.);
+    CHECK(value_of(behind, {"r10", "all", "q"}) == 10.);
+
+    writer.update({"r11", "all", "q"}, 11.);
+    CHECK(value_of(behind, {"r11", "all", "q"}) == 11.);
+
+    writer.compact();
+    CHECK(fs::file_size(writer.journal_path()) == 16);
+    CHECK(value_of(stale, {"r11", "all", "q"}) == 11.);
+    CHECK(AnalysisResults(path).load().size() == 12);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  6. queries
+// ─────────────────────────────────────────────────────────────────────
+static void test_queries()
+{
+    const auto path = store_path("queries");
+    AnalysisResults writer(path, ResultsBackend::Journal);
+    writer.update(ResultMap{{{"r1", "1350", "n_gamma"}, {10., 1.}},
+                            {{"r1", "1350", "dcr"}, {0.5, 0.}},
+                            {{"r2", "1350", "n_gamma"}, {12., 1.}},
+                            {{"r1", "1375", "n_gamma"}, {99., 0.}}});
+    writer.update({"r2", "1350", "dcr"}, 0.7);
+
+    const AnalysisResults reader(path);
+    const auto run = query_run(reader, "r1", "1350");
+    CHECK(run.size() == 2);
+    CHECK(run.count("n_gamma") && run.at("n_gamma").value == 10.);
+    CHECK(query_run(reader, "r3", "1350").empty());
+    CHECK(query_run(reader, "r2", "1350").size() == query_run(reader.load(), "r2", "1350").size());
+
+    auto *g = make_graph(reader, {"r1", "r3", "r2"}, {1., 2., 3.}, "1350", "n_gamma", "dcr");
+    CHECK(g->GetN() == 2);
+    CHECK(g->GetN() == 2 && g->GetY()[1] == 12. && g->GetX()[1] == 3. &&
+          g->GetEX()[1] == 0.7 && g->GetEY()[0] == 1.);
+    delete g;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  7. column store
+// ─────────────────────────────────────────────────────────────────────
+static void test_columns()
+{
+    const auto path = store_path("columns");
+    AnalysisResults ar(path, ResultsBackend::Journal);
+    ar.update(ResultMap{{{"r3", "1350", "n_gamma"}, {13., 1.}},
+                        {{"r1", "1350", "n_gamma"}, {11., 1.}},
+                        {{"r2", "1350", "n_gamma"}, {12., 1.}},
+                        {{"r2", "1375", "n_gamma"}, {22., 1.}},
+                        {{"r1", "1350", "dcr"}, {0.1, 0.}},
+                        {{"r3", "1350", "dcr"}, {0.3, 0.}}});
+
+    const auto column = ar.column("1350", "n_gamma");
+    CHECK(column.runs == std::vector<std::string>({"r1", "r2", "r3"}));
+    CHECK(column.values == std::vector<double>({11., 12., 13.}));
+    CHECK(column.find("r2") && column.find("r2")->value == 12.);
+    CHECK(!column.find("r0") && !column.find("r4"));
+    CHECK(ar.column("1400", "n_gamma").runs.empty());
+
+    //  A later update is visible to the next query.
+    ar.update({"r0", "1350", "n_gamma"}, 10.);
+    CHECK(ar.column("1350", "n_gamma").runs.size() == 4);
+
+    //  Runs out of order, with one missing from each column.
+    const std::vector<std::string> runs = {"r3", "r9", "r1", "r2"};
+    const std::vector<double> x = {3., 9., 1., 2.};
+    auto graphs = make_graphs(ar, runs, x, "1350", {"n_gamma", "dcr"});
+    CHECK(graphs.size() == 2);
+    CHECK(graphs[0]->GetN() == 3 && graphs[1]->GetN() == 2);
+    CHECK(graphs[0]->GetN() == 3 && graphs[0]->GetX()[0] == 3. && graphs[0]->GetY()[2] == 12.);
+    CHECK(graphs[1]->GetN() == 2 && graphs[1]->GetY()[0] == 0.3 && graphs[1]->GetY()[1] == 0.1);
+    for (auto *g : graphs)
+        delete g;
+
+    //  The ResultMap overloads agree.
+    const auto m = ar.load();
+    auto *from_map = make_graph(m, runs, x, "1350", "n_gamma", "dcr");
+    auto *from_handle = make_graph(ar, runs, x, "1350", "n_gamma", "dcr");
+    bool same = from_map->GetN() == from_handle->GetN();
+    for (int i = 0; same && i < from_map->GetN(); ++i)
+        same = from_map->GetY()[i] == from_handle->GetY()[i] &&
+               from_map->GetEX()[i] == from_handle->GetEX()[i];
+    CHECK(same);
+    delete from_map;
+    delete from_handle;
+    CHECK(query_run(m, "r2", "1350").size() == 1);
+    CHECK(query_run(m, "r1", "1350").size() == 2);
+    CHECK(query_run(m, "r1", "1375").empty());
+}
+
+int main()
+{
+    std::cout << "Running analysis results tests...\n";
+
+    test_append();
+    test_overlay();
+    test_torn_tail();
+    test_corrupt();
+    test_compaction();
+    test_queries();
+    test_columns();
+
+    fs::remove_all(fs::temp_directory_path() / "btana_analysis_results_test");
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All analysis results tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file test/tester_circle_fit.cxx
+ * @brief Unit tests for the closed-form circle fits in utility/circle_fit.h.
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. Kåsa / Taubin / Pratt recover a noise-free far-off-centre arc.
+ *   2. Collinear points are rejected (ok == false).
+ *   3. `leave_one_out` (moment downdates) matches n explicit refits.
+ *   4. `refine_geometric` reaches the radial-residual minimum (gradient
+ *      ~ 0) and its σ shrink with more points.
+ *   5. `fit_circle` keeps its contract: fixed-centre R = mean distance,
+ *      `exclude_points` honoured, NaN sentinel on failure.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "utility/circle_fit.h"
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+#define CHECK_NEAR(actual, expected, tol)                                 \
+    do                                                                    \
+    {                                                                     \
+        ++s_tests_run;                                                    \
+        const double _a = (actual);                                       \
+        const double _e = (expected);                                     \
+        if (std::fabs(_a - _e) > (tol))                                   \
+        {                                                                 \
+            ++s_tests_failed;                                             \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__        \
+                      << "  " << #actual << " ~= " << #expected           \
+                      << "  (got " << _a << ", expected " << _e           \
+                      << " ± " << (tol) << ")\n";                         \
+        }                                                                 \
+    } while (false)
+
+using util::circle_fit::CircleMethod;
+using Points = std::vector<std::array<float, 2>>;
+
+static constexpr double kPi = 3.14159265358979323846;
+
+//  Sample an arc of a circle (cx, cy, R) over [phi0, phi0 + span], with a
+//  deterministic ±jitter comb (no RNG) when @p jitter > 0.
+static Points make_arc(double cx, double cy, double R, double phi0, double span, int n,
+                       double jitter = 0.0)
+{
+    Points pts;
+    pts.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        const double phi = phi0 + span * (n > 1 ? double(i) / double(n - 1) : 0.0);
+        const double dr = jitter * ((i % 3) - 1);
+        pts.push_back({static_cast<float>(cx + (R + dr) * std::cos(phi)),
+                       static_cast<float>(cy + (R + dr) * std::sin(phi))});
+    }
+    return pts;
+}
+
+// 1. Noise-free 60° arc, centre 250 mm away — all three methods are exact.
+void test_algebraic_far_arc()
+{
+    const auto pts = make_arc(200, -30, 250, kPi - 0.5, 1.05, 40);
+    for (const auto method : {CircleMethod::kasa, CircleMethod::taubin, CircleMethod::pratt})
+    {
+        const auto fit = util::circle_fit::fit_algebraic(pts, method);
+        CHECK(fit.ok);
+        CHECK_NEAR(fit.x0, 200.0, 5e-2);
+        CHECK_NEAR(fit.y0, -30.0, 5e-2);
+        CHECK_NEAR(fit.radius, 250.0, 5e-2);
+    }
+}
+
+// 2. Collinear points → degenerate → ok == false.
+void test_algebraic_collinear_rejected()
+{
+    Points pts;
+    for (int i = 0; i < 10; ++i)
+        pts.push_back({float(i) * 3.f, 5.f});
+    CHECK(!util::circle_fit::fit_algebraic(pts).ok);
+}
+
+// 3. Downdated leave-one-out == explicit refit of the n − 1 points.
+void test_leave_one_out_matches_refit()
+{
+    const auto pts = make_arc(12, -7, 80, 0.3, 2.0, 25, 0.8);
+    const auto loo = util::circle_fit::leave_one_out(pts);
+    CHECK(loo.size() == pts.size());
+    for (std::size_t i = 0; i < pts.size(); ++i)
+    {
+        Points subset = pts;
+        subset.erase(subset.begin() + static_cast<long>(i));
+        const auto ref = util::circle_fit::fit_algebraic(subset);
+        CHECK(loo[i].ok == ref.ok);
+        CHECK_NEAR(loo[i].x0, ref.x0, 1e-6);
+        CHECK_NEAR(loo[i].y0, ref.y0, 1e-6);
+        CHECK_NEAR(loo[i].radius, ref.radius, 1e-6);
+    }
+}
+
+// 4. Geometric refinement lands on the Σ(d − R)² minimum; σ ∝ 1/√n.
+void test_refine_geometric_minimum()
+{
+    const auto pts = make_arc(5, 3, 60, 0.0, 2.5, 30, 0.6);
+    const auto seed = util::circle_fit::fit_algebraic(pts);
+    const auto fit = util::circle_fit::refine_geometric(pts, seed);
+    CHECK(fit.ok);
+    //  Gradient of Σ(d − R)² vanishes at the minimum.
+    double gx = 0.0, gy = 0.0, gr = 0.0;
+    for (const auto &p : pts)
+    {
+        const double dx = p[0] - fit.x0, dy = p[1] - fit.y0;
+        const double d = std::hypot(dx, dy);
+        const double r = d - fit.radius;
+        gx += -r * dx / d;
+        gy += -r * dy / d;
+        gr += -r;
+    }
+    CHECK_NEAR(gx, 0.0, 1e-6);
+    CHECK_NEAR(gy, 0.0, 1e-6);
+    CHECK_NEAR(gr, 0.0, 1e-6);
+    CHECK(fit.sigma_radius > 0.0);
+
+    const auto dense = make_arc(5, 3, 60, 0.0, 2.5, 120, 0.6);
+    const auto fit_dense = util::circle_fit::refine_geometric(
+        dense, util::circle_fit::fit_algebraic(dense));
+    CHECK(fit_dense.ok);
+    CHECK(fit_dense.sigma_radius < fit.sigma_radius);
+}
+
+// 5. fit_circle contract (fixed centre, exclusion, failure sentinel).
+void test_fit_circle_contract()
+{
+    auto pts = make_arc(0, 0, 50, 0.0, 2 * kPi, 36);
+    pts.push_back({500.f, 500.f}); // outlier, index 36
+
+    const auto fixed = fit_circle(pts, {0.f, 0.f, 40.f}, true, {36});
+    CHECK_NEAR(fixed[0][0], 0.0, 1e-6);
+    CHECK_NEAR(fixed[1][0], 0.0, 1e-6);
+    CHECK_NEAR(fixed[2][0], 50.0, 1e-3);
+
+    const auto free_fit = fit_circle(pts, {1.f, 1.f, 40.f}, false, {36});
+    CHECK_NEAR(free_fit[0][0], 0.0, 1e-3);
+    CHECK_NEAR(free_fit[1][0], 0.0, 1e-3);
+    CHECK_NEAR(free_fit[2][0], 50.0, 1e-3);
+
+    const auto failed = fit_circle(Points{{1.f, 1.f}}, {0.f, 0.f, 1.f}, false);
+    CHECK(std::isnan(failed[2][0]));
+}
+
+int main()
+{
+    std::cout << "Running circle-fit tests...\n";
+
+    test_algebraic_far_arc();
+    test_algebraic_collinear_rejected();
+    test_leave_one_out_matches_refit();
+    test_refine_geometric_minimum();
+    test_fit_circle_contract();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All circle-fit tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file test/tester_cross_talk_pairs.cxx
+ * @brief Unit tests for the cross-talk pair finder
+ *        (`util::cross_talk` in `utility/cross_talk_pairs.h`).
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. Adjacency: physical radius, same device + FIFO, unmapped channels,
+ *      self entry, symmetry.
+ *   2. for_each_neighbour / for_each_in_window visit exactly the pairs of
+ *      the brute-force O(N²) loop, on random frames reusing one finder.
+ *   3. Window edges: dt_lo inclusive, dt_hi exclusive, equal times.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "utility/cross_talk_pairs.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+using namespace util::cross_talk;
+
+//  16×16 grid, 3 mm pitch; 8 channels per FIFO, 256 per device; the last
+//  row is unmapped.
+static Channel grid_channel(uint32_t ordinal)
+{
+    const int column = ordinal % 16, row = (ordinal / 16) % 16;
+    const bool mapped = row != 15;
+    return {ordinal, 192 + static_cast<int>(ordinal / 256), static_cast<int>((ordinal % 256) / 8),
+            mapped ? 3.f * column : -999.f, mapped ? 3.f * row : -999.f};
+}
+
+static uint8_t brute_relation(const Channel &a, const Channel &b, float radius)
+{
+    uint8_t relation = 0;
+    if (a.device == b.device && a.fifo == b.fifo)
+        relation |= RelationElectrical;
+    if (a.x > -990.f && b.x > -990.f && std::hypot(a.x - b.x, a.y - b.y) <= radius)
+        relation |= RelationPhysical;
+    if (a.ordinal == b.ordinal)
+        relation |= RelationSameChannel;
+    return relation;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  1. adjacency
+// ─────────────────────────────────────────────────────────────────────
+static void test_adjacency()
+{
+    ChannelAdjacency adjacency(3.2f);
+    for (uint32_t ordinal = 0; ordinal < 512; ordinal += 3)
+        adjacency.add(grid_channel(ordinal));
+    adjacency.add(grid_channel(0)); // repeat: no-op
+    CHECK(adjacency.size() == 171);
+    CHECK(adjacency.contains(3));
+    CHECK(!adjacency.contains(4));
+    CHECK(!adjacency.contains(100000));
+    CHECK(adjacency.relation(4, 3) == 0);
+
+    bool all_match = true, symmetric = true;
+    for (uint32_t a = 0; a < 512; a += 3)
+        for (uint32_t b = 0; b < 512; b += 3)
+        {
+            all_match &= adjacency.relation(a, b) == brute_relation(grid_channel(a), grid_channel(b), 3.2f);
+            symmetric &= adjacency.relation(a, b) == adjacency.relation(b, a);
+        }
+    CHECK(all_match);
+    CHECK(symmetric);
+
+    //  Diagonal (4.24 mm) is outside 3.2 mm; unmapped channels are never physical.
+    ChannelAdjacency grid(3.2f);
+    for (uint32_t ordinal = 0; ordinal < 256; ++ordinal)
+        grid.add(grid_channel(ordinal));
+    CHECK(grid.relation(23, 24) == RelationPhysical);
+    CHECK(grid.relation(17, 34) == 0);
+    CHECK(grid.relation(16, 17) == (RelationPhysical | RelationElectrical));
+    CHECK(grid.relation(240, 241) == RelationElectrical);
+    CHECK(grid.relation(240, 240) == (RelationSameChannel | RelationElectrical));
+    CHECK(grid.relation(17, 17) == (RelationSameChannel | RelationElectrical | RelationPhysical));
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  2. pair search vs brute force
+// ─────────────────────────────────────────────────────────────────────
+static void test_against_brute_force()
+{
+    std::mt19937 rng(12345);
+    PairFinder finder(3.2f);
+    bool neighbours_match = true, window_match = true;
+    for (int frame = 0; frame < 50; ++frame)
+    {
+        //  Integer times (cc-like) → plenty of ties.
+        std::uniform_int_distribution<uint32_t> pick_channel(0, 511);
+        std::uniform_int_distribution<int> pick_time(0, 1023);
+        std::vector<std::pair<double, Channel>> hits(std::uniform_int_distribution<int>(0, 300)(rng));
+        for (auto &[t, channel] : hits)
+        {
+            channel = grid_channel(pick_channel(rng));
+            t = pick_time(rng);
+        }
+
+        finder.clear();
+        for (const auto &[t, channel] : hits)
+            finder.add(t, channel);
+        finder.prepare();
+        CHECK(finder.size() == hits.size());
+
+        for (std::size_t i = 0; i < hits.size(); ++i)
+        {
+            std::set<std::tuple<std::size_t, double, uint8_t>> expected_neighbours, found_neighbours;
+            std::set<std::pair<std::size_t, double>> expected_window, found_window;
+            for (std::size_t j = 0; j < hits.size(); ++j)
+            {
+                const double dt = hits[j].first - hits[i].first;
+                if (j == i)
+                    continue;
+                if (dt >= -5 && dt < 1024)
+                    if (const uint8_t relation = brute_relation(hits[i].second, hits[j].second, 3.2f))
+                        expected_neighbours.insert({j, dt, relation});
+                if (dt >= -5 && dt < 20)
+                    expected_window.insert({j, dt});
+            }
+            finder.for_each_neighbour(i, -5, 1024, [&](std::size_t j, double dt, uint8_t relation)
+                                      { found_neighbours.insert({j, dt, relation}); });
+            finder.for_each_in_window(i, -5, 20, [&](std::size_t j, double dt)
+                                      { found_window.insert({j, dt}); });
+            neighbours_match &= expected_neighbours == found_neighbours;
+            window_match &= expected_window == found_window;
+        }
+    }
+    CHECK(neighbours_match);
+    CHECK(window_match);
+    CHECK(finder.adjacency().size() <= 512);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  3. window edges
+// ─────────────────────────────────────────────────────────────────────
+static void test_window_edges()
+{
+    PairFinder finder(3.2f);
+    const Channel a = grid_channel(17), b = grid_channel(18);
+    finder.add(100, a); // 0
+    finder.add(95, b);  // 1: dt = −5   (inclusive lower edge)
+    finder.add(100, b); // 2: dt = 0
+    finder.add(110, b); // 3: dt = +10  (exclusive upper edge)
+    finder.add(100, a); // 4: same channel, same time
+    finder.prepare();
+
+    std::multiset<std::size_t> visited;
+    finder.for_each_neighbour(0, -5, 10, [&](std::size_t j, double, uint8_t)
+                              { visited.insert(j); });
+    CHECK((visited == std::multiset<std::size_t>{1, 2, 4}));
+
+    visited.clear();
+    finder.for_each_in_window(0, -5, 10, [&](std::size_t j, double)
+                              { visited.insert(j); });
+    CHECK((visited == std::multiset<std::size_t>{1, 2, 4}));
+
+    //  Same-channel partner carries the self bit.
+    uint8_t relation_4 = 0;
+    finder.for_each_neighbour(0, 0, 1, [&](std::size_t j, double, uint8_t relation)
+                              { if (j == 4) relation_4 = relation; });
+    CHECK((relation_4 & RelationSameChannel) != 0);
+
+    //  Next frame: stale ranges gone.
+    finder.clear();
+    finder.add(0, a);
+    finder.prepare();
+    int n = 0;
+    finder.for_each_neighbour(0, -1000, 1000, [&](std::size_t, double, uint8_t)
+                              { ++n; });
+    CHECK(n == 0);
+}
+
+int main()
+{
+    std::cout << "Running cross-talk pair finder tests...\n";
+
+    test_adjacency();
+    test_against_brute_force();
+    test_window_edges();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All cross-talk pair finder tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
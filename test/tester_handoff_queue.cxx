@@ -0,0 +1,152 @@
+/**
+ * @file test/tester_handoff_queue.cxx
+ * @brief Unit tests for utility/handoff_queue.h (the end-to-end cascade
+ *        hand-off and the writers' archiving thread).
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. Items cross threads in order through a capacity-1 queue.
+ *   2. `close` by the consumer releases a producer blocked on a full
+ *      queue; later pushes are dropped.
+ *   3. `BackgroundConsumer` runs the callback on every item, in order,
+ *      before `finish` returns.
+ *   4. A consumer exception is rethrown by `finish`; pushes after it do
+ *      not block.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "utility/handoff_queue.h"
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+using util::BackgroundConsumer;
+using util::HandoffQueue;
+
+// ─────────────────────────────────────────────────────────────────────
+//  1. ordered hand-off
+// ─────────────────────────────────────────────────────────────────────
+static void test_ordered_handoff()
+{
+    constexpr int kItems = 10000;
+    HandoffQueue<int> queue(1);
+    std::thread producer([&]
+                         {
+        for (int i = 0; i < kItems; ++i)
+            queue.push(i);
+        queue.close(); });
+    std::vector<int> seen;
+    int item;
+    while (queue.pop(item))
+        seen.push_back(item);
+    producer.join();
+    bool in_order = seen.size() == kItems;
+    for (int i = 0; in_order && i < kItems; ++i)
+        in_order = seen[i] == i;
+    CHECK(in_order);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  2. consumer-side close
+// ─────────────────────────────────────────────────────────────────────
+static void test_consumer_close()
+{
+    HandoffQueue<int> queue(2);
+    std::atomic<int> n_accepted{0};
+    std::thread producer([&]
+                         {
+        for (int i = 0; i < 100; ++i)
+            if (queue.push(i))
+                ++n_accepted; });
+    int item = -1;
+    CHECK(queue.pop(item) && item == 0);
+    queue.close(); // would deadlock the producer without the close path
+    producer.join();
+    CHECK(n_accepted.load() < 100);
+    CHECK(!queue.push(7));
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  3. background consumer
+// ─────────────────────────────────────────────────────────────────────
+static void test_background_consumer()
+{
+    std::vector<int> seen;
+    BackgroundConsumer<std::vector<int>> consumer(
+        [&seen](std::vector<int> &batch)
+        { seen.insert(seen.end(), batch.begin(), batch.end()); });
+    for (int i = 0; i < 50; ++i)
+        consumer.push({2 * i, 2 * i + 1});
+    consumer.finish();
+    bool in_order = seen.size() == 100;
+    for (int i = 0; in_order && i < 100; ++i)
+        in_order = seen[i] == i;
+    CHECK(in_order);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  4. consumer exception
+// ─────────────────────────────────────────────────────────────────────
+static void test_consumer_exception()
+{
+    BackgroundConsumer<int> consumer(
+        [](int &item)
+        {
+            if (item == 3)
+                throw std::runtime_error("item 3");
+        },
+        /*depth=*/1);
+    for (int i = 0; i < 100; ++i)
+        consumer.push(i);
+    bool thrown = false;
+    try
+    {
+        consumer.finish();
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+int main()
+{
+    std::cout << "Running hand-off queue tests...\n";
+
+    test_ordered_handoff();
+    test_consumer_close();
+    test_background_consumer();
+    test_consumer_exception();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All hand-off queue tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file test/tester_pulser_calib.cxx
+ * @brief Unit tests for the per-channel pulser fit
+ *        (`writers/pulser_calib/channel_fit.h`): buffered
+ *        `fit_channel` against streaming `StreamingChannel`.
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. On clean synthetic pulser hits both paths publish the same per-TDC
+ *      (a, b) and period, close to the generated ones.
+ *   2. Intermittent one-cc slips on one TDC are snapped by both paths,
+ *      hit for hit, and the published parameters still agree.
+ *   3. A hit on no TDC (tdc > 3) is counted but breaks the pair chain the
+ *      same way in both paths, and never indexes a TDC slot.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "writers/pulser_calib/channel_fit.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+using btana::pulser_calib::ChannelBucket;
+using btana::pulser_calib::ChannelHit;
+using btana::pulser_calib::ChannelKey;
+using btana::pulser_calib::ChannelResult;
+using btana::pulser_calib::fit_channel;
+using btana::pulser_calib::StreamingChannel;
+
+//  Generated calibration: hit time = c − (θ_t + f · a_t).
+//  The pulser period is not a whole number of clock cycles, so the
+//  pulse phase walks through every fine bin.
+constexpr double kPeriodCc = 320000.37;
+constexpr double kTheta[4] = {0., 1.3, -0.7, 2.1};
+constexpr double kSlope[4] = {0.0150, 0.0146, 0.0154, 0.0150};
+
+//  `n_spills` spills of `n_pulses` pulses, TDCs round-robin.
+//  Every `slip_every`-th hit on TDC 2 has its coarse counter one cc late
+//  (0 = no slips); `n_slipped` counts them.
+static ChannelBucket make_bucket(int n_spills, int n_pulses, int slip_every,
+                                 long &n_slipped)
+{
+    ChannelBucket bucket;
+    n_slipped = 0;
+    for (int spill = 0; spill < n_spills; ++spill)
+    {
+        auto &hits = bucket.per_spill.emplace_back().hits;
+        const double spill_start_cc = 1.e9 * (spill + 1) + 12345.6;
+        int n_on_tdc2 = 0;
+        for (int pulse = 0; pulse < n_pulses; ++pulse)
+        {
+            const int tdc = pulse % 4;
+            const double time_cc = spill_start_cc + pulse * kPeriodCc;
+            //  Smallest coarse with a fine of at least 40, then the fine
+            //  that reproduces the time.
+            const double shifted_cc = time_cc + kTheta[tdc];
+            const double coarse_cc = std::ceil(shifted_cc + 40. * kSlope[tdc]);
+            ChannelHit hit;
+            hit.abs_coarse_cc = static_cast<int64_t>(coarse_cc);
+            hit.fine = static_cast<uint8_t>(std::lround((coarse_cc - shifted_cc) / kSlope[tdc]));
+            hit.tdc = static_cast<uint8_t>(tdc);
+            if (tdc == 2 && slip_every > 0 && ++n_on_tdc2 % slip_every == 0)
+            {
+                ++hit.abs_coarse_cc;
+                ++n_slipped;
+            }
+            hits.push_back(hit);
+        }
+    }
+    return bucket;
+}
+
+static CalibConfigStruct test_config()
+{
+    CalibConfigStruct cfg;
+    cfg.pulser_period_cc = kPeriodCc;
+    cfg.slip_window_hits = 64;
+    return cfg;
+}
+
+static ChannelResult run_streaming(const ChannelKey &key, const ChannelBucket &bucket,
+                                   const CalibConfigStruct &cfg)
+{
+    StreamingChannel channel;
+    for (std::size_t spill = 0; spill < bucket.per_spill.size(); ++spill)
+        for (const auto &hit : bucket.per_spill[spill].hits)
+            channel.add(hit, static_cast<int>(spill), cfg);
+    return channel.solve(key, cfg);
+}
+
+//  Both paths publish the same thing.  The slip decisions and hit counts
+//  must match exactly; the parameters only up to the summation order.
+static void check_same(const ChannelResult &buffered, const ChannelResult &streaming)
+{
+    CHECK(buffered.converged && streaming.converged);
+    CHECK(buffered.ok && streaming.ok);
+    CHECK(buffered.total_hits == streaming.total_hits);
+    CHECK(buffered.n_pairs_seen == streaming.n_pairs_seen);
+    CHECK(buffered.n_pairs_used == streaming.n_pairs_used);
+    CHECK(std::abs(buffered.T_cc - streaming.T_cc) < 1.e-6);
+    CHECK(std::abs(buffered.chi2_per_pair - streaming.chi2_per_pair) < 1.e-6);
+    for (int tdc = 0; tdc < 4; ++tdc)
+    {
+        CHECK(buffered.tdc[tdc].fitted && streaming.tdc[tdc].fitted);
+        CHECK(buffered.tdc[tdc].n_hits == streaming.tdc[tdc].n_hits);
+        CHECK(buffered.tdc[tdc].n_slipped_hits == streaming.tdc[tdc].n_slipped_hits);
+        CHECK(std::abs(buffered.tdc[tdc].a - streaming.tdc[tdc].a) < 1.e-6);
+        CHECK(std::abs(buffered.tdc[tdc].b - streaming.tdc[tdc].b) < 1.e-6);
+    }
+}
+
+//  The published parameters are the generated ones.
+static void check_truth(const ChannelResult &result)
+{
+    CHECK(std::abs(result.T_cc - kPeriodCc) < 1.e-3);
+    for (int tdc = 0; tdc < 4; ++tdc)
+    {
+        CHECK(std::abs(result.tdc[tdc].a - kSlope[tdc]) < 5.e-4);
+        CHECK(std::abs(result.tdc[tdc].b - kTheta[tdc]) < 0.05);
+    }
+}
+
+static void test_clean()
+{
+    long n_slipped = 0;
+    const auto bucket = make_bucket(3, 1200, 0, n_slipped);
+    const auto cfg = test_config();
+    const ChannelKey key{192, 0, 5};
+    const auto buffered = fit_channel(key, bucket, cfg);
+    const auto streaming = run_streaming(key, bucket, cfg);
+    check_same(buffered, streaming);
+    check_truth(buffered);
+    for (int tdc = 0; tdc < 4; ++tdc)
+        CHECK(streaming.tdc[tdc].n_slipped_hits == 0);
+}
+
+static void test_slips()
+{
+    long n_slipped = 0;
+    const auto bucket = make_bucket(3, 1200, 37, n_slipped);
+    const auto cfg = test_config();
+    const ChannelKey key{192, 0, 5};
+    const auto buffered = fit_channel(key, bucket, cfg);
+    const auto streaming = run_streaming(key, bucket, cfg);
+    check_same(buffered, streaming);
+    check_truth(streaming);
+    CHECK(n_slipped > 0);
+    CHECK(streaming.tdc[2].n_slipped_hits == n_slipped);
+    CHECK(streaming.tdc[0].n_slipped_hits + streaming.tdc[1].n_slipped_hits +
+              streaming.tdc[3].n_slipped_hits ==
+          0);
+}
+
+static void test_bad_tdc()
+{
+    long n_slipped = 0;
+    auto bucket = make_bucket(3, 1200, 37, n_slipped);
+    //  Two stray hits in the middle of spill 1.
+    auto &hits = bucket.per_spill[1].hits;
+    ChannelHit stray = hits[500];
+    stray.tdc = 7;
+    hits.insert(hits.begin() + 501, stray);
+    stray.tdc = 255;
+    hits.insert(hits.begin() + 800, stray);
+
+    const auto cfg = test_config();
+    const ChannelKey key{192, 0, 5};
+    const auto buffered = fit_channel(key, bucket, cfg);
+    const auto streaming = run_streaming(key, bucket, cfg);
+    check_same(buffered, streaming);
+    CHECK(streaming.total_hits == 3 * 1200 + 2);
+    CHECK(streaming.tdc[0].n_hits + streaming.tdc[1].n_hits +
+              streaming.tdc[2].n_hits + streaming.tdc[3].n_hits ==
+          3 * 1200);
+}
+
+int main()
+{
+    std::cout << "Running pulser calibration tests...\n";
+
+    test_clean();
+    test_slips();
+    test_bad_tdc();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All pulser calibration tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
@@ -18,6 +18,9 @@
  *   5. `azimuthal_coverage_fraction` and the N_γ = n_hits / f_coverage
  *      estimator are invariant under a rigid translation of a full ring +
  *      its channel map (centre-agnostic, as the wide-arc path relies on).
+ *   6. The grid-indexed `azimuthal_coverage_fraction` matches the full
+ *      channel scan exactly, on- and off-axis, and `CoverageCache` with a
+ *      zero quantum reproduces it bit for bit.
  *
  * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
  */
@@ -166,6 +169,45 @@ void test_coverage_centre_invariance()
     CHECK_NEAR(n_hits / f0, n_hits / f1, 1e-3);
 }
 
+// 6. Indexed coverage == full scan; quantum-0 cache == indexed.
+void test_coverage_index_matches_scan()
+{
+    //  3 mm-pitch square grid of channels, ±90 mm, with a hole punched in
+    //  the middle so partial arcs actually lose coverage.
+    std::map<int, std::array<float, 2>> chan;
+    int id = 0;
+    for (int ix = -30; ix <= 30; ++ix)
+        for (int iy = -30; iy <= 30; ++iy)
+            if (std::abs(ix) > 5 || std::abs(iy) > 5)
+                chan[id++] = {3.f * ix, 3.f * iy};
+    const util::radiator_efficiency::ChannelGridIndex index(chan);
+    CHECK(index.size() == chan.size());
+
+    util::radiator_efficiency::CoverageCache exact(index, 3.f, 1.5f, 0.f);
+    const float rings[][3] = {{0.f, 0.f, 70.f}, {1.3f, -0.7f, 40.f},
+                              {200.f, 0.f, 250.f}, {-35.f, 60.f, 20.f},
+                              {500.f, 500.f, 30.f}};
+    for (const auto &r : rings)
+    {
+        const float f_scan = util::radiator_efficiency::azimuthal_coverage_fraction(
+            chan, r[0], r[1], r[2], 3.f, 1.5f);
+        const float f_index = util::radiator_efficiency::azimuthal_coverage_fraction(
+            index, r[0], r[1], r[2], 3.f, 1.5f);
+        CHECK(f_scan == f_index);
+        CHECK(exact(r[0], r[1], r[2]) == f_index);
+    }
+    CHECK_NEAR(util::radiator_efficiency::azimuthal_coverage_fraction(
+                   index, 500.f, 500.f, 30.f, 3.f, 1.5f),
+               0.0, 1e-6); // ring entirely off the plane
+
+    //  Memoised: two rings in the same quantum cell share one evaluation.
+    util::radiator_efficiency::CoverageCache cached(index, 3.f, 1.5f, 0.1f);
+    const float fa = cached(1.30f, -0.70f, 40.f);
+    const float fb = cached(1.31f, -0.71f, 40.01f);
+    CHECK(fa == fb);
+    CHECK(cached.n_misses() == 1 && cached.n_hits() == 1);
+}
+
 int main()
 {
     std::cout << "Running ring-arc tests...\n";
@@ -175,6 +217,7 @@ int main()
     test_taubin_collinear_rejected();
     test_taubin_noisy_far_arc();
     test_coverage_centre_invariance();
+    test_coverage_index_matches_scan();
 
     std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
     if (s_tests_failed == 0)
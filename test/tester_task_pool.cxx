@@ -0,0 +1,168 @@
+/**
+ * @file test/tester_task_pool.cxx
+ * @brief Unit tests for the shared work-stealing pool in utility/task_pool.h.
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. `configure` sets the pool size (workers + caller).
+ *   2. Every task of a group runs exactly once before `wait` returns.
+ *   3. Nested groups (tasks waiting on their own sub-groups) complete on
+ *      a small pool — the waiting task runs queued work instead of
+ *      blocking a worker.
+ *   4. The first task exception is rethrown by `wait`; the other tasks
+ *      still run.
+ *   5. A pool of size 1 runs everything serially on the waiting thread.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "utility/task_pool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+using util::TaskGroup;
+using util::TaskPool;
+
+// ─────────────────────────────────────────────────────────────────────
+//  1. configure
+// ─────────────────────────────────────────────────────────────────────
+static void test_configure()
+{
+    TaskPool::configure(3);
+    CHECK(TaskPool::instance().concurrency() == 3);
+    TaskPool::configure(4);
+    CHECK(TaskPool::instance().concurrency() == 4);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  2. every task runs once
+// ─────────────────────────────────────────────────────────────────────
+static void test_all_tasks_run()
+{
+    TaskPool::configure(4);
+    constexpr int kTasks = 1000;
+    std::vector<std::atomic<int>> hits(kTasks);
+    {
+        TaskGroup group;
+        for (int i = 0; i < kTasks; ++i)
+            group.run([&hits, i]
+                      { ++hits[i]; });
+        group.wait();
+    }
+    bool all_once = true;
+    for (const auto &h : hits)
+        all_once = all_once && h.load() == 1;
+    CHECK(all_once);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  3. nested groups
+// ─────────────────────────────────────────────────────────────────────
+static void test_nested_groups()
+{
+    //  Two threads, eight outer tasks each waiting on eight inner ones:
+    //  would deadlock if a waiting task parked its worker.
+    TaskPool::configure(2);
+    std::atomic<int> n_inner{0};
+    TaskGroup outer;
+    for (int i = 0; i < 8; ++i)
+        outer.run([&n_inner]
+                  {
+            TaskGroup inner;
+            for (int j = 0; j < 8; ++j)
+                inner.run([&n_inner] { ++n_inner; });
+            inner.wait(); });
+    outer.wait();
+    CHECK(n_inner.load() == 64);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  4. exception propagation
+// ─────────────────────────────────────────────────────────────────────
+static void test_exception_rethrown()
+{
+    TaskPool::configure(4);
+    std::atomic<int> n_ok{0};
+    TaskGroup group;
+    for (int i = 0; i < 16; ++i)
+        group.run([&n_ok, i]
+                  {
+            if (i == 5)
+                throw std::runtime_error("task 5");
+            ++n_ok; });
+    bool thrown = false;
+    try
+    {
+        group.wait();
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(n_ok.load() == 15);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  5. serial pool
+// ─────────────────────────────────────────────────────────────────────
+static void test_serial_pool()
+{
+    TaskPool::configure(1);
+    CHECK(TaskPool::instance().concurrency() == 1);
+    const auto caller = std::this_thread::get_id();
+    std::vector<int> order;
+    bool on_caller = true;
+    TaskGroup group;
+    for (int i = 0; i < 5; ++i)
+        group.run([&, i]
+                  {
+            on_caller = on_caller && std::this_thread::get_id() == caller;
+            order.push_back(i); });
+    group.wait();
+    CHECK(on_caller);
+    CHECK(order.size() == 5);
+}
+
+int main()
+{
+    std::cout << "Running task-pool tests...\n";
+
+    test_configure();
+    test_all_tasks_run();
+    test_nested_groups();
+    test_exception_rethrown();
+    test_serial_pool();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All task-pool tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
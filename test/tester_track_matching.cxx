@@ -0,0 +1,241 @@
+/**
+ * @file test/tester_track_matching.cxx
+ * @brief Unit tests for the recotrack timestamp matcher
+ *        (`writers/recotrackdata/track_matching.h`).
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. Identical sequences under an unknown clock offset match one to one.
+ *   2. A trigger dropped on either side (including the first one) costs
+ *      exactly that entry; every other pair stays correct.
+ *   3. A linear clock drift far larger than the tolerance over the spill
+ *      is followed.
+ *   4. Frames given out of time order come back in input order.
+ *   5. ALTAI events are cut into spills at timestamp gaps; trackless
+ *      events are skipped.
+ *   6. Spill pairing re-aligns after an extra ALTAI cut, and refuses the
+ *      spills of a missed gap without shifting the later ones.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "writers/recotrackdata/track_matching.h"
+
+#include "tracking_altai.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+using btana::recotrackdata::AltaiSpill;
+using btana::recotrackdata::match_spill;
+using btana::recotrackdata::pair_altai_spill;
+using btana::recotrackdata::SpillMatch;
+using btana::recotrackdata::split_altai_spills;
+using btana::recotrackdata::TrackMatchConfig;
+
+//  A spill of `n` triggers at random 2–50 µs spacing, with a little jitter.
+//  ALTAI event k carries ID 1000 + k.
+struct Spill
+{
+    std::vector<double> frame_ns;
+    AltaiSpill altai;
+};
+
+static Spill make_spill(std::size_t n, double offset_ns, double drift_per_ns, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> gap(2.e3, 5.e4);
+    std::normal_distribution<double> jitter(0., 20.);
+    Spill spill;
+    double t = 0.;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        t += gap(rng);
+        spill.frame_ns.push_back(t);
+        spill.altai.event_ids.push_back(static_cast<uint32_t>(1000 + k));
+        spill.altai.times_ns.push_back(t * (1. + drift_per_ns) + offset_ns + jitter(rng));
+    }
+    return spill;
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  1. offset only
+// ─────────────────────────────────────────────────────────────────────
+static void test_offset()
+{
+    const auto spill = make_spill(500, 3.7e9, 0., 1);
+    const auto match = match_spill(spill.frame_ns, spill.altai, TrackMatchConfig{});
+    CHECK(match.n_matched == 500);
+    CHECK(match.n_frames_unmatched == 0 && match.n_events_unmatched == 0);
+    bool all_right = true;
+    for (std::size_t k = 0; k < 500; ++k)
+        all_right &= match.event_ids[k] == 1000 + k;
+    CHECK(all_right);
+    CHECK(match.residuals_ns.size() == 500);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  2. dropped triggers
+// ─────────────────────────────────────────────────────────────────────
+static void test_dropped()
+{
+    auto spill = make_spill(300, -1.2e6, 0., 2);
+    //  Frame side loses its first trigger and trigger 100; the telescope
+    //  loses event 200.
+    auto frames = spill.frame_ns;
+    frames.erase(frames.begin() + 100);
+    frames.erase(frames.begin());
+    spill.altai.event_ids.erase(spill.altai.event_ids.begin() + 200);
+    spill.altai.times_ns.erase(spill.altai.times_ns.begin() + 200);
+
+    const auto match = match_spill(frames, spill.altai, TrackMatchConfig{});
+    CHECK(match.n_matched == 297);
+    CHECK(match.n_frames_unmatched == 1);
+    CHECK(match.n_events_unmatched == 2);
+    //  frames[k] is original trigger k + 1 below 99, k + 2 above.
+    bool all_right = true;
+    for (std::size_t k = 0; k < frames.size(); ++k)
+    {
+        const std::size_t original = k < 99 ? k + 1 : k + 2;
+        const uint32_t expected = original == 200 ? SpillMatch::kUnmatched
+                                                  : static_cast<uint32_t>(1000 + original);
+        all_right &= match.event_ids[k] == expected;
+    }
+    CHECK(all_right);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  3. clock drift
+// ─────────────────────────────────────────────────────────────────────
+static void test_drift()
+{
+    //  50 ppm over a ~13 ms spill: ~650 ns end to end, beyond the 500 ns
+    //  tolerance without drift tracking.
+    const auto spill = make_spill(500, 5.e5, 5.e-5, 3);
+    const auto match = match_spill(spill.frame_ns, spill.altai, TrackMatchConfig{});
+    CHECK(match.n_matched == 500);
+    CHECK(match.drift_ns > 400.);
+
+    TrackMatchConfig frozen;
+    frozen.drift_gain = 0.;
+    CHECK(match_spill(spill.frame_ns, spill.altai, frozen).n_matched < 500);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  4. input order
+// ─────────────────────────────────────────────────────────────────────
+static void test_input_order()
+{
+    const auto spill = make_spill(50, 0., 0., 4);
+    std::vector<double> reversed(spill.frame_ns.rbegin(), spill.frame_ns.rend());
+    const auto match = match_spill(reversed, spill.altai, TrackMatchConfig{});
+    CHECK(match.n_matched == 50);
+    CHECK(match.event_ids.front() == 1049 && match.event_ids.back() == 1000);
+
+    const auto empty = match_spill(spill.frame_ns, AltaiSpill{}, TrackMatchConfig{});
+    CHECK(empty.n_matched == 0 && empty.n_frames_unmatched == 50);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  5. spill split
+// ─────────────────────────────────────────────────────────────────────
+static void test_split()
+{
+    TrackingAltai tracking;
+    TrackingAltaiStruct track{};
+    const double ticks[] = {0., 1.e6, 2.e6, 2.e9, 2.1e9, 9.e9};
+    for (uint32_t id = 0; id < 6; ++id)
+    {
+        track.timestamp = ticks[id];
+        tracking.add_event_track(id, track);
+    }
+    tracking.set_event_tracks(6, {}); // trackless
+    TrackMatchConfig cfg;
+    cfg.altai_tick_ns = 1.;
+    const auto spills = split_altai_spills(tracking, cfg);
+    CHECK(spills.size() == 3);
+    CHECK(spills.size() == 3 && spills[0].event_ids.size() == 3 &&
+          spills[1].event_ids.size() == 2 && spills[2].event_ids.size() == 1);
+    CHECK(!spills.empty() && spills[0].times_ns[1] == 1.e6);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  6. spill pairing
+// ─────────────────────────────────────────────────────────────────────
+static void test_pairing()
+{
+    //  Six spills of distinct length (100 … 600 triggers).
+    std::vector<Spill> spills;
+    for (unsigned k = 0; k < 6; ++k)
+        spills.push_back(make_spill(100 * (k + 1), 1.e6, 0., 10 + k));
+    auto pair_all = [&](const std::vector<AltaiSpill> &altai)
+    {
+        std::vector<int> paired;
+        int shift = 0;
+        for (int i = 0; i < static_cast<int>(spills.size()); ++i)
+            paired.push_back(pair_altai_spill(spills[i].frame_ns, i, altai, shift, TrackMatchConfig{}));
+        return paired;
+    };
+
+    std::vector<AltaiSpill> aligned;
+    for (const auto &spill : spills)
+        aligned.push_back(spill.altai);
+    CHECK((pair_all(aligned) == std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+    //  A burst of telescope noise cut as its own spill before spill 2.
+    auto extra = aligned;
+    extra.insert(extra.begin() + 2, make_spill(40, 0., 0., 20).altai);
+    CHECK((pair_all(extra) == std::vector<int>{0, 1, 3, 4, 5, 6}));
+
+    //  Spills 2 and 3 merged into one cut (the gap between them missed):
+    //  both are refused, the rest keep their own partner.
+    auto merged = aligned;
+    const double join_ns = merged[2].times_ns.back() + 1.e5;
+    for (std::size_t k = 0; k < merged[3].times_ns.size(); ++k)
+    {
+        merged[2].event_ids.push_back(merged[3].event_ids[k]);
+        merged[2].times_ns.push_back(join_ns + merged[3].times_ns[k]);
+    }
+    merged.erase(merged.begin() + 3);
+    CHECK((pair_all(merged) == std::vector<int>{0, 1, -1, -1, 3, 4}));
+}
+
+int main()
+{
+    std::cout << "Running track matching tests...\n";
+
+    test_offset();
+    test_dropped();
+    test_drift();
+    test_input_order();
+    test_split();
+    test_pairing();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All track matching tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file test/tester_tracking_altai.cxx
+ * @brief Unit tests for the ALTAI track loader (`tracking_altai.h`).
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. Text parse: header skipped, multi-track events grouped, `*`
+ *      events present with no tracks, every field in column order.
+ *   2. Out-of-order input is grouped by event; unknown events give an
+ *      empty span; malformed lines are skipped.
+ *   3. The binary cache is written next to the text and reproduces the
+ *      parse exactly; touching the text invalidates it; a header whose
+ *      counts disagree with the file size is rejected before allocating.
+ *   4. The setters keep the flat layout consistent.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "tracking_altai.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+namespace fs = std::filesystem;
+
+static std::string write_tracks(const std::string &name, const std::string &body)
+{
+    const fs::path path = fs::temp_directory_path() / name;
+    std::ofstream(path) << body;
+    fs::remove(TrackingAltai::cache_path(path.string()));
+    return path.string();
+}
+
+static const char *kHeader = "event x y z dx dy dz chi2 ndof chi2ndof timestamp\n";
+
+// ─────────────────────────────────────────────────────────────────────
+//  1. text parse
+// ─────────────────────────────────────────────────────────────────────
+static void test_parse()
+{
+    const auto path = write_tracks("btana_tracks_parse.txt",
+                                   std::string(kHeader) +
+                                       "0 1.5 -2.5 0 0.01 -0.02 1 3.5 4 0.875 1000.25\n"
+                                       "0 3 4 0 0 0 1 1 2 0.5 1000.5\n"
+                                       "1 *\n"
+                                       "2 -7 8 0 0.1 0.2 1 6 3 2 2000\n");
+    TrackingAltai tracking;
+    tracking.load_tracking_file(path, /*use_cache=*/false);
+    CHECK(tracking.get_number_of_events() == 3);
+    CHECK(tracking.get_number_of_tracks() == 3);
+    CHECK(tracking.get_event_tracks_size(0) == 2);
+    CHECK(tracking.get_event_tracks_size(1) == 0);
+    CHECK(!tracking.event_has_at_least_one_track(1));
+    CHECK(tracking.event_has_one_track(2));
+
+    const auto first = tracking.get_event_tracks(0)[0];
+    CHECK(first.event_id == 0);
+    CHECK(first.zero_plane_x == 1.5f && first.zero_plane_y == -2.5f);
+    CHECK(first.angcoeff_dx == 0.01f && first.angcoeff_dy == -0.02f && first.angcoeff_dz == 1.f);
+    CHECK(first.chi2 == 3.5f && first.ndof == 4 && first.chi2ndof == 0.875f);
+    CHECK(first.timestamp == 1000.25);
+    CHECK(tracking.get_zero_plane_x(0, 1) == 3.f);
+    CHECK(tracking.get_timestamp(2, 0) == 2000.);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  2. unordered / malformed input
+// ─────────────────────────────────────────────────────────────────────
+static void test_unordered_and_malformed()
+{
+    const auto path = write_tracks("btana_tracks_unordered.txt",
+                                   std::string(kHeader) +
+                                       "5 1 0 0 0 0 1 1 1 1 5\n"
+                                       "3 2 0 0 0 0 1 1 1 1 3\n"
+                                       "5 3 0 0 0 0 1 1 1 1 5\n"
+                                       "4 not a track line\n"
+                                       "\n"
+                                       "6 4 0 0\n");
+    TrackingAltai tracking;
+    tracking.load_tracking_file(path, /*use_cache=*/false);
+    CHECK(tracking.get_number_of_events() == 2);
+    CHECK(tracking.get_event_tracks_size(5) == 2);
+    //  Stable grouping keeps the file order within an event.
+    CHECK(tracking.get_zero_plane_x(5, 0) == 1.f && tracking.get_zero_plane_x(5, 1) == 3.f);
+    CHECK(tracking.get_event_tracks(3).size() == 1);
+    CHECK(tracking.get_event_tracks(4).empty());
+    CHECK(tracking.get_event_tracks(99).empty());
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  3. binary cache
+// ─────────────────────────────────────────────────────────────────────
+static void test_cache()
+{
+    std::string body(kHeader);
+    for (int i = 0; i < 1000; ++i)
+        body += std::to_string(i) + (i % 7 == 0 ? " *\n" : " 1.25 2.5 0 0.5 0.25 1 3 4 0.75 " + std::to_string(i) + ".5\n");
+    const auto path = write_tracks("btana_tracks_cache.txt", body);
+    const auto cache = TrackingAltai::cache_path(path);
+
+    TrackingAltai parsed;
+    parsed.load_tracking_file(path);
+    CHECK(fs::exists(cache));
+    TrackingAltai cached;
+    cached.load_tracking_file(path);
+    bool identical = cached.get_number_of_tracks() == parsed.get_number_of_tracks();
+    for (uint32_t event = 0; identical && event < 1000; ++event)
+    {
+        const auto a = cached.get_event_tracks(event), b = parsed.get_event_tracks(event);
+        identical = a.size() == b.size() &&
+                    (a.empty() || std::memcmp(a.data(), b.data(), a.size_bytes()) == 0);
+    }
+    CHECK(identical);
+    CHECK(cached.get_number_of_events() == 1000);
+    CHECK(cached.get_timestamp(999, 0) == 999.5);
+
+    //  A changed text file must not be served from the stale cache.
+    std::ofstream(path, std::ios::app) << "1000 9 9 0 0 0 1 1 1 1 1000\n";
+    fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(2));
+    TrackingAltai reparsed;
+    reparsed.load_tracking_file(path);
+    CHECK(reparsed.get_number_of_events() == 1001);
+    CHECK(reparsed.get_zero_plane_x(1000, 0) == 9.f);
+
+    //  A cache whose counts disagree with its size is rebuilt from the
+    //  text, not trusted for the allocation: claim 2^40 tracks in the
+    //  header (n_tracks sits after magic, version, struct size, source
+    //  size, source mtime and n_events).
+    {
+        std::fstream patch(cache, std::ios::in | std::ios::out | std::ios::binary);
+        const uint64_t huge = uint64_t{1} << 40;
+        patch.seekp(8 + 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t));
+        patch.write(reinterpret_cast<const char *>(&huge), sizeof(huge));
+    }
+    TrackingAltai corrupt;
+    corrupt.load_tracking_file(path);
+    CHECK(corrupt.get_number_of_events() == 1001);
+    CHECK(corrupt.get_zero_plane_x(1000, 0) == 9.f);
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  4. setters
+// ─────────────────────────────────────────────────────────────────────
+static void test_setters()
+{
+    TrackingAltai tracking;
+    TrackingAltaiStruct a{}, b{}, c{};
+    a.zero_plane_x = 1.f;
+    b.zero_plane_x = 2.f;
+    c.zero_plane_x = 3.f;
+    tracking.add_event_track(10, a);
+    tracking.add_event_track(5, b);
+    tracking.add_event_track(10, c);
+    CHECK(tracking.get_number_of_events() == 2);
+    CHECK(tracking.get_event_tracks_size(10) == 2);
+    CHECK(tracking.get_zero_plane_x(10, 1) == 3.f);
+    tracking.set_event_tracks(5, {a, c});
+    CHECK(tracking.get_event_tracks_size(5) == 2);
+    CHECK(tracking.get_zero_plane_x(5, 1) == 3.f);
+    CHECK(tracking.get_zero_plane_x(10, 0) == 1.f);
+    tracking.set_event_tracks(10, {});
+    CHECK(tracking.get_event_tracks(10).empty());
+    CHECK(tracking.get_number_of_tracks() == 2);
+}
+
+int main()
+{
+    std::cout << "Running ALTAI track loader tests...\n";
+
+    test_parse();
+    test_unordered_and_malformed();
+    test_cache();
+    test_setters();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All ALTAI track loader tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
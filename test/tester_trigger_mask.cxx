@@ -0,0 +1,118 @@
+/**
+ * @file test/tester_trigger_mask.cxx
+ * @brief Unit tests for the per-frame trigger-presence mask
+ *        (`TriggerMask` in `triggers/events.h`).
+ *
+ * Build with:
+ *   cmake -B build -DBTANA_BUILD_TESTS=ON && cmake --build build
+ * Run with:
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Coverage:
+ *   1. Every built-in trigger and config indices 0–54 own distinct bits;
+ *      config indices 55–99 and unmapped values share one.
+ *   2. trigger_mask_of ORs the bits of a trigger list.
+ *   3. frame_has_trigger answers from the mask for exact bits and scans
+ *      the list only behind the shared bit.
+ *
+ * Harness: the minimal CHECK macro shared with tester_global_index.cxx.
+ */
+
+#include "triggers/events.h"
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+static int s_tests_run = 0;
+static int s_tests_failed = 0;
+
+#define CHECK(expr)                                                \
+    do                                                             \
+    {                                                              \
+        ++s_tests_run;                                             \
+        if (!(expr))                                               \
+        {                                                          \
+            ++s_tests_failed;                                      \
+            std::cerr << "  FAIL  " << __FILE__ << ":" << __LINE__ \
+                      << "  " << #expr << "\n";                    \
+        }                                                          \
+    } while (false)
+
+static constexpr TriggerMask kShared = TriggerMask{1} << kTriggerMaskShared;
+
+// ─────────────────────────────────────────────────────────────────────
+//  1. bit layout
+// ─────────────────────────────────────────────────────────────────────
+static void test_layout()
+{
+    std::set<TriggerMask> exact_bits;
+    bool all_single = true;
+    for (int v = 0; v < 256; ++v)
+    {
+        const TriggerMask bit = trigger_mask_bit(static_cast<uint8_t>(v));
+        all_single &= bit != 0 && (bit & (bit - 1)) == 0;
+        if (trigger_mask_is_exact(static_cast<uint8_t>(v)))
+            exact_bits.insert(bit);
+    }
+    CHECK(all_single);
+    CHECK(exact_bits.size() == static_cast<size_t>(kTriggerMaskExactConfig + n_default_triggers));
+    CHECK(exact_bits.count(kShared) == 0);
+
+    CHECK(trigger_mask_bit(0) == 1);
+    CHECK(trigger_mask_bit(54) == TriggerMask{1} << 54);
+    CHECK(trigger_mask_bit(55) == kShared);
+    CHECK(trigger_mask_bit(99) == kShared);
+    CHECK(trigger_mask_bit(150) == kShared);
+    CHECK(trigger_mask_bit(TriggerFirstFrames) == TriggerMask{1} << kTriggerMaskDefaults);
+    CHECK(trigger_mask_bit(_TRIGGER_UNKNOWN_) == TriggerMask{1} << 63);
+    CHECK(trigger_mask_is_exact(TriggerStartOfSpill));
+    CHECK(!trigger_mask_is_exact(77));
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  2. mask of a trigger list
+// ─────────────────────────────────────────────────────────────────────
+static void test_mask_of()
+{
+    CHECK(trigger_mask_of(std::vector<TriggerEvent>{}) == 0);
+    const std::vector<TriggerEvent> triggers = {{0, 10}, {TriggerTiming, 20}, {0, 30}, {TriggerStartOfSpill}};
+    CHECK(trigger_mask_of(triggers) ==
+          (trigger_mask_bit(0) | trigger_mask_bit(TriggerTiming) | trigger_mask_bit(TriggerStartOfSpill)));
+}
+
+// ─────────────────────────────────────────────────────────────────────
+//  3. presence queries
+// ─────────────────────────────────────────────────────────────────────
+static void test_has_trigger()
+{
+    const std::vector<TriggerEvent> triggers = {{3, 10}, {_TRIGGER_STREAMING_RING_FOUND_, 20}, {60, 30}};
+    const TriggerMask mask = trigger_mask_of(triggers);
+    CHECK(frame_has_trigger(mask, triggers, 3));
+    CHECK(frame_has_trigger(mask, triggers, _TRIGGER_STREAMING_RING_FOUND_));
+    CHECK(!frame_has_trigger(mask, triggers, 4));
+    CHECK(!frame_has_trigger(mask, triggers, TriggerTiming));
+    //  Shared bit: 60 present, 61 shares its bit but is absent.
+    CHECK(frame_has_trigger(mask, triggers, 60));
+    CHECK(!frame_has_trigger(mask, triggers, 61));
+    //  Exact bits answer from the mask alone, whatever the list holds.
+    CHECK(frame_has_trigger(trigger_mask_bit(0), std::vector<TriggerEvent>{}, 0));
+    CHECK(!frame_has_trigger(0, triggers, 3));
+}
+
+int main()
+{
+    std::cout << "Running trigger mask tests...\n";
+
+    test_layout();
+    test_mask_of();
+    test_has_trigger();
+
+    std::cout << s_tests_run << " tests run, " << s_tests_failed << " failed.\n";
+    if (s_tests_failed == 0)
+    {
+        std::cout << "All trigger mask tests passed.\n";
+        return 0;
+    }
+    return 1;
+}
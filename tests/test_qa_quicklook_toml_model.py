@@ -248,3 +248,41 @@ class ResultsLoadTests(unittest.TestCase):
         p = self._tmp / "bad.toml"
         p.write_text("this is { not valid toml")
         self.assertEqual(rundb.results_load(p), {})
+
+    @staticmethod
+    def _journal_record(run: str, sensor: str, quantity: str,
+                        value: float, error: float = 0.0) -> bytes:
+        import struct
+        from qa_quicklook import rundb
+        payload = bytes([1])
+        for field in (run, sensor, quantity):
+            raw = field.encode()
+            payload += struct.pack("<H", len(raw)) + raw
+        payload += struct.pack("<dd", value, error)
+        return struct.pack("<IQ", len(payload), rundb._fnv1a64(payload)) + payload
+
+    def test_replays_journal_over_toml(self) -> None:
+        import struct
+        from qa_quicklook import rundb
+        p = self._tmp / "j.toml"
+        p.write_text(
+            '[results."r1"."all"]\n'
+            '"rate" = { value = 1.0 }\n'
+            '"gain" = { value = 7.0 }\n'
+        )
+        journal = (
+            b"BTRESJNL" + struct.pack("<Q", 1)
+            + self._journal_record("r1", "all", "rate", 3.0, 0.5)
+            + self._journal_record("r2", "1350", "n_gamma", 12.0)
+        )
+        corrupt = bytearray(self._journal_record("r3", "all", "rate", 9.0))
+        corrupt[-1] ^= 0xFF
+        Path(str(p) + ".journal").write_bytes(journal + bytes(corrupt))
+        out = rundb.results_load(p)
+        # Last record wins over the TOML; untouched TOML entries survive.
+        self.assertEqual(out["r1"]["all"]["rate"].value, 3.0)
+        self.assertEqual(out["r1"]["all"]["rate"].error, 0.5)
+        self.assertEqual(out["r1"]["all"]["gain"].value, 7.0)
+        self.assertEqual(out["r2"]["1350"]["n_gamma"].value, 12.0)
+        # The record with a bad checksum ends the replay.
+        self.assertNotIn("r3", out)
@@ -0,0 +1,334 @@
+#!/usr/bin/env python3
+"""
+End-to-end throughput regression check for lightdata_writer / recodata_writer.
+
+Generates a fixed synthetic run with `alcor_generator` (once; reused while
+the generator arguments are unchanged), then runs
+
+    lightdata_writer <workdir> <run> --threads N --force-rebuild
+    recodata_writer  <workdir> <run> --threads N --force-rebuild
+
+for every thread count of the baseline, each `repeat` times, and records
+per stage and thread count:
+
+    wall_s        best (lowest) wall time over the repeats: the whole
+                  writer process, from launch to exit, so file opening,
+                  configuration, output writing and teardown are included
+    peak_rss_mb   highest peak resident set size over the repeats
+                  (ru_maxrss of the child, from wait4)
+    hits, frames  content of the stage's output file (`btana-dump --stats`)
+    hits_per_s, frames_per_s   hits / wall_s, frames / wall_s (rates of the
+                  whole process, not of the decoding loop alone)
+
+and compares them with the committed baseline
+(bench/throughput_baseline.json by default):
+
+  REGRESSION  — hits/s or frames/s fell, or peak RSS grew, by more than the
+                baseline's relative tolerance
+  CHANGED     — the output hit / frame count differs from the baseline: the
+                dataset is fixed, so the writers' output changed and the
+                rates are not comparable one-to-one
+  FASTER      — a rate improved beyond tolerance (consider --update-baseline)
+  NEW         — no baseline entry for this stage / thread count; fails the
+                check (exit 4) unless --update-baseline records it
+  OK          — within tolerance
+
+Timings are machine-dependent: record the baseline on the machine that
+runs the check (`--update-baseline`), and compare Release builds only.
+Needs only the built executables — no network, no PyROOT; Linux (wait4).
+
+Usage:
+    tools/throughput_regression.py                              # build/bin, baseline thread counts
+    tools/throughput_regression.py --bin-dir /opt/btana/bin --threads 1 8
+    tools/throughput_regression.py --update-baseline            # record this machine's numbers
+    tools/throughput_regression.py --tolerance peak_rss_mb=0.3 --strict
+
+Exit codes:
+    0  — no regression
+    1  — at least one REGRESSION
+    2  — at least one CHANGED and --strict was passed
+    3  — setup error (missing executable, a stage failed, unreadable baseline)
+    4  — at least one NEW (a measured stage has no baseline entry) and
+         --update-baseline was not passed
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from dataclasses import asdict, dataclass
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parent.parent
+DEFAULT_BASELINE = REPO_ROOT / "bench" / "throughput_baseline.json"
+STAGES = ("lightdata_writer", "recodata_writer")
+OUTPUT_FILE = {"lightdata_writer": "lightdata.root", "recodata_writer": "recodata.root"}
+# Gated metrics and the direction that counts as worse.
+HIGHER_IS_BETTER = {"hits_per_s": True, "frames_per_s": True, "peak_rss_mb": False}
+
+# First line of `btana-dump --stats`:
+#   "lightdata: 12 entries, 2 spill(s), 9876 frame(s), 123456 hit(s)"
+_STATS_RE = re.compile(r"^\w+: \d+ entr(?:y|ies), \d+ spill\(s\), (\d+) frame\(s\), (\d+) hit\(s\)",
+                       re.MULTILINE)
+
+
+class SetupError(RuntimeError):
+    """Anything that prevents a measurement (exit code 3)."""
+
+
+@dataclass
+class Measurement:
+    """One stage at one thread count."""
+    wall_s: float
+    peak_rss_mb: float
+    hits: int
+    frames: int
+    hits_per_s: float
+    frames_per_s: float
+
+
+def _key(stage: str, threads: int) -> str:
+    return f"{stage}@{threads}"
+
+
+def _find_binary(name: str, bin_dir: Path) -> Path:
+    candidate = bin_dir / name
+    if candidate.is_file() and os.access(candidate, os.X_OK):
+        return candidate
+    found = shutil.which(name)
+    if found:
+        return Path(found)
+    raise SetupError(f"executable '{name}' not found in {bin_dir} or on PATH "
+                     f"(build with cmake, or pass --bin-dir)")
+
+
+def _run(cmd: list[str], log_path: Path) -> tuple[float, float]:
+    """Run @p cmd from the repository root (for conf/), output to @p log_path.
+
+    Returns (wall seconds, peak RSS in MiB) of the child.
+    """
+    log_path.parent.mkdir(parents=True, exist_ok=True)
+    with open(log_path, "w") as log:
+        start = time.perf_counter()
+        proc = subprocess.Popen(cmd, cwd=REPO_ROOT, stdout=log, stderr=subprocess.STDOUT)
+        _, status, usage = os.wait4(proc.pid, 0)
+        wall = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    if proc.returncode != 0:
+        tail = log_path.read_text(errors="replace").splitlines()[-20:]
+        raise SetupError(f"'{' '.join(cmd)}' exited with {proc.returncode}; "
+                         f"last lines of {log_path}:\n    " + "\n    ".join(tail))
+    return wall, usage.ru_maxrss / 1024.0  # ru_maxrss is in KiB on Linux
+
+
+def _count(dump: Path, root_file: Path) -> tuple[int, int]:
+    """(frames, hits) of @p root_file via `btana-dump --stats`."""
+    out = subprocess.run([str(dump), str(root_file), "--stats"], cwd=REPO_ROOT,
+                         capture_output=True, text=True)
+    match = _STATS_RE.search(out.stdout)
+    if out.returncode != 0 or not match:
+        raise SetupError(f"cannot read the frame / hit counts of {root_file} "
+                         f"(btana-dump exited with {out.returncode})")
+    return int(match.group(1)), int(match.group(2))
+
+
+def _prepare_dataset(generator: Path, workdir: Path, dataset: dict, force: bool) -> None:
+    """Generate the run unless a run with the same arguments is already there."""
+    run_dir = workdir / dataset["run_name"]
+    stamp = run_dir / ".generator_args.json"
+    args = [str(a) for a in dataset.get("generator_args", [])]
+    if not force and stamp.is_file() and json.loads(stamp.read_text()) == args:
+        print(f"dataset: reusing {run_dir}")
+        return
+    if run_dir.exists():
+        shutil.rmtree(run_dir)
+    print(f"dataset: generating {run_dir} ({' '.join(args) or 'generator defaults'})")
+    wall, _ = _run([str(generator), str(workdir), dataset["run_name"], *args],
+                   workdir / "logs" / "alcor_generator.log")
+    stamp.write_text(json.dumps(args))
+    print(f"dataset: generated in {wall:.1f} s")
+
+
+def _measure(binaries: dict, workdir: Path, run_name: str, stage: str,
+             threads: int, repeat: int) -> Measurement:
+    walls, rss = [], []
+    for r in range(repeat):
+        cmd = [str(binaries[stage]), str(workdir), run_name,
+               "--threads", str(threads), "--force-rebuild"]
+        wall, peak = _run(cmd, workdir / "logs" / f"{stage}_t{threads}_r{r}.log")
+        walls.append(wall)
+        rss.append(peak)
+    frames, hits = _count(binaries["btana-dump"], workdir / run_name / OUTPUT_FILE[stage])
+    wall = min(walls)
+    return Measurement(wall_s=wall, peak_rss_mb=max(rss), hits=hits, frames=frames,
+                       hits_per_s=hits / wall, frames_per_s=frames / wall)
+
+
+def _compare(now: Measurement, base: dict | None,
+             tolerance: dict) -> tuple[str, list[str]]:
+    """Status of @p now against its baseline entry, plus explanatory notes."""
+    if not base:
+        return "NEW", []
+    notes, status = [], "OK"
+    for metric, higher_is_better in HIGHER_IS_BETTER.items():
+        ref, value = base.get(metric), getattr(now, metric)
+        tol = tolerance.get(metric)
+        if not ref or tol is None:
+            continue
+        change = value / ref - 1.0
+        worse = -change if higher_is_better else change
+        if worse > tol:
+            status = "REGRESSION"
+            notes.append(f"{metric} {change:+.1%} (tolerance {tol:.0%})")
+        elif -worse > tol and status == "OK":
+            status = "FASTER"
+            notes.append(f"{metric} {change:+.1%}")
+    if (now.hits, now.frames) != (base.get("hits"), base.get("frames")):
+        notes.append(f"output {now.frames} frames / {now.hits} hits, "
+                     f"baseline {base.get('frames')} / {base.get('hits')}")
+        if status != "REGRESSION":
+            status = "CHANGED"
+    return status, notes
+
+
+def _host() -> dict:
+    model = ""
+    try:
+        for line in Path("/proc/cpuinfo").read_text().splitlines():
+            if line.startswith("model name"):
+                model = line.split(":", 1)[1].strip()
+                break
+    except OSError:
+        pass
+    commit = subprocess.run(["git", "describe", "--always", "--dirty"], cwd=REPO_ROOT,
+                            capture_output=True, text=True).stdout.strip()
+    return {"cpu": model, "cpus": os.cpu_count(), "platform": platform.platform(),
+            "commit": commit}
+
+
+def main(argv: list[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description="End-to-end throughput regression check for the lightdata / recodata writers.")
+    parser.add_argument("--bin-dir", type=Path, default=REPO_ROOT / "build" / "bin",
+                        help="Directory with the built executables (falls back to PATH).  "
+                             "Default: build/bin.")
+    parser.add_argument("--baseline", type=Path, default=DEFAULT_BASELINE,
+                        help="Baseline JSON (dataset, thread counts, tolerances, results).")
+    parser.add_argument("--workdir", type=Path,
+                        default=Path(tempfile.gettempdir()) / "btana_throughput",
+                        help="Data repository for the synthetic run and the logs.")
+    parser.add_argument("--threads", type=int, nargs="+",
+                        help="Thread counts to run.  Default: the baseline's.")
+    parser.add_argument("--repeat", type=int,
+                        help="Runs per stage and thread count.  Default: the baseline's.")
+    parser.add_argument("--tolerance", action="append", default=[], metavar="METRIC=FRAC",
+                        help="Override one relative tolerance, e.g. peak_rss_mb=0.3.  Repeatable.")
+    parser.add_argument("-o", "--output", type=Path,
+                        help="Write this run's measurements as JSON.  Default: <workdir>/throughput.json.")
+    parser.add_argument("--regenerate", action="store_true",
+                        help="Regenerate the synthetic run even if it is up to date.")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="Store this run's measurements (and host) in the baseline file.")
+    parser.add_argument("--strict", action="store_true",
+                        help="Also fail (exit 2) when the output hit / frame counts changed.")
+    args = parser.parse_args(argv)
+
+    try:
+        baseline = json.loads(args.baseline.read_text())
+    except (OSError, json.JSONDecodeError) as e:
+        print(f"ERROR: cannot read baseline {args.baseline}: {e}", file=sys.stderr)
+        return 3
+    tolerance = dict(baseline.get("tolerance", {}))
+    for item in args.tolerance:
+        metric, _, value = item.partition("=")
+        if metric not in HIGHER_IS_BETTER:
+            parser.error(f"--tolerance: unknown metric '{metric}' "
+                         f"(one of {', '.join(HIGHER_IS_BETTER)})")
+        tolerance[metric] = float(value)
+    threads = args.threads or baseline.get("threads", [1])
+    repeat = args.repeat or baseline.get("repeat", 1)
+    dataset = baseline["dataset"]
+    n_cpus = os.cpu_count() or 1
+
+    host = _host()
+    base_host = baseline.get("host") or {}
+    if base_host and (base_host.get("cpu"), base_host.get("cpus")) != (host["cpu"], host["cpus"]):
+        print(f"WARNING: baseline recorded on '{base_host.get('cpu')}' ({base_host.get('cpus')} cpus), "
+              f"this is '{host['cpu']}' ({host['cpus']} cpus): timings may not be comparable",
+              file=sys.stderr)
+
+    args.workdir.mkdir(parents=True, exist_ok=True)
+    results: dict[str, Measurement] = {}
+    rows = []
+    try:
+        binaries = {name: _find_binary(name, args.bin_dir)
+                    for name in ("alcor_generator", "btana-dump", *STAGES)}
+        _prepare_dataset(binaries["alcor_generator"], args.workdir, dataset, args.regenerate)
+        for n in threads:
+            if n > n_cpus:
+                print(f"threads={n}: skipped, only {n_cpus} cpus")
+                continue
+            for stage in STAGES:
+                print(f"{stage} --threads {n} (x{repeat}) ...", flush=True)
+                m = _measure(binaries, args.workdir, dataset["run_name"], stage, n, repeat)
+                key = _key(stage, n)
+                results[key] = m
+                status, notes = _compare(m, baseline.get("results", {}).get(key), tolerance)
+                rows.append((status, key, f"{m.wall_s:.2f}", f"{m.hits_per_s:.4g}",
+                             f"{m.frames_per_s:.4g}", f"{m.peak_rss_mb:.0f}", "; ".join(notes)))
+    except SetupError as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 3
+
+    # ── Report ─────────────────────────────────────────────────────────────
+    headers = ("status", "stage@threads", "wall [s]", "hits/s", "frames/s", "peak RSS [MiB]", "note")
+    widths = [max(len(headers[i]), max((len(r[i]) for r in rows), default=0))
+              for i in range(len(headers))]
+    print()
+    print(" | ".join(h.ljust(w) for h, w in zip(headers, widths)))
+    print("-+-".join("-" * w for w in widths))
+    for r in rows:
+        print(" | ".join(c.ljust(w) for c, w in zip(r, widths)))
+
+    report = {"host": host, "dataset": dataset, "repeat": repeat,
+              "results": {k: asdict(m) for k, m in results.items()}}
+    output = args.output or args.workdir / "throughput.json"
+    output.write_text(json.dumps(report, indent=2) + "\n")
+    print(f"\nmeasurements written to {output}")
+
+    if args.update_baseline:
+        baseline["host"] = host
+        baseline.setdefault("results", {}).update(report["results"])
+        args.baseline.write_text(json.dumps(baseline, indent=2) + "\n")
+        print(f"baseline {args.baseline} updated ({len(results)} entries)")
+        return 0
+
+    n_regression = sum(1 for r in rows if r[0] == "REGRESSION")
+    n_changed = sum(1 for r in rows if r[0] == "CHANGED")
+    n_new = sum(1 for r in rows if r[0] == "NEW")
+    if n_regression:
+        print(f"\n*** THROUGHPUT REGRESSION: {n_regression} of {len(rows)} stage(s) "
+              f"outside tolerance ***", file=sys.stderr)
+        return 1
+    if n_new:
+        # An unbaselined stage was measured but not checked: that is not a pass.
+        print(f"\nERROR: {n_new} of {len(rows)} stage(s) have no baseline entry; "
+              f"record them with --update-baseline", file=sys.stderr)
+        return 4
+    if n_changed:
+        print(f"\nWARNING: output of {n_changed} stage(s) differs from the baseline dataset counts",
+              file=sys.stderr)
+        if args.strict:
+            return 2
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())